@@ -0,0 +1,156 @@
+//************************************************************************************
+//
+// Title:               AD9834 Register Map
+// Author:              Jacob Putz
+// Filename:            AD9834.h
+//
+// Description:     Register addresses, control bits and 16-bit SPI frame packing
+//                      for the AD9834 DDS.  Every write to the part is a single 16-bit
+//                      word; the top bits of the word select the register.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Take the phase in the step record packer, as the AD9952 does.
+//
+// 0.1.1    -       Add the step record packer and frame constants.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef AD9834_H_
+#define AD9834_H_
+
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  D15 D14         Register
+//   0   0          Control
+//   0   1          FREQ0   (14 bits per write)
+//   1   0          FREQ1   (14 bits per write)
+//   1   1   0      PHASE0  (12 bits, D13 = 0)
+//   1   1   1      PHASE1  (12 bits, D13 = 1)
+//
+//  With B28 set, a frequency register takes two consecutive writes, LSBs first.
+//  With B28 clear, HLB selects whether a single write lands in the LSBs or MSBs.
+//
+//************************************************************************************
+
+// Defines
+//
+// Register select bits
+#define     AD9834_REG_CTRL         0x0000
+#define     AD9834_REG_FREQ0        0x4000
+#define     AD9834_REG_FREQ1        0x8000
+#define     AD9834_REG_PHASE0       0xC000
+#define     AD9834_REG_PHASE1       0xE000
+
+// Control register bits
+#define     AD9834_CTRL_B28         0x2000
+#define     AD9834_CTRL_HLB         0x1000
+#define     AD9834_CTRL_FSEL        0x0800
+#define     AD9834_CTRL_PSEL        0x0400
+#define     AD9834_CTRL_PIN_SW      0x0200
+#define     AD9834_CTRL_RESET       0x0100
+#define     AD9834_CTRL_SLEEP1      0x0080
+#define     AD9834_CTRL_SLEEP12     0x0040
+#define     AD9834_CTRL_OPBITEN     0x0020
+#define     AD9834_CTRL_SIGN_PIB    0x0010
+#define     AD9834_CTRL_DIV2        0x0008
+#define     AD9834_CTRL_MODE        0x0002
+
+// Field masks
+#define     AD9834_FREQ_HALF_MASK   0x3FFF
+#define     AD9834_PHASE_MASK       0x0FFF
+
+// Frames needed for a full 28-bit frequency write (control + LSB + MSB)
+#define     AD9834_FREQ_FRAMES      3
+
+// Serial frame width, and elements in one sweep/hop step record (FREQ0 LSB + MSB)
+#define     AD9834_FRAME_BITS       16
+#define     AD9834_STEP_ELEMS       2
+
+//************************************************************************************
+//
+// Frame packing.  reg is AD9834_REG_FREQ0/1 or AD9834_REG_PHASE0/1.
+//
+//************************************************************************************
+static inline uint16_t AD9834FrameCtrl(uint16_t ctrl) {
+
+    return (uint16_t)(AD9834_REG_CTRL | (ctrl & 0x3FFF));
+
+}
+
+static inline uint16_t AD9834FrameFreqLSB(uint16_t reg, uint32_t word) {
+
+    return (uint16_t)(reg | (word & AD9834_FREQ_HALF_MASK));
+
+}
+
+static inline uint16_t AD9834FrameFreqMSB(uint16_t reg, uint32_t word) {
+
+    return (uint16_t)(reg | ((word >> 14) & AD9834_FREQ_HALF_MASK));
+
+}
+
+static inline uint16_t AD9834FramePhase(uint16_t reg, uint32_t word) {
+
+    return (uint16_t)(reg | (word & AD9834_PHASE_MASK));
+
+}
+
+//************************************************************************************
+//
+// Pack a complete B28 frequency write into frames[0..2].  ctrl is the caller's
+// current control register image; B28 is forced on and HLB is don't-care.
+//
+//************************************************************************************
+static inline void AD9834PackFreq28(uint16_t *frames, uint16_t ctrl, uint16_t reg,
+                                    uint32_t word) {
+
+    frames[0] = AD9834FrameCtrl((uint16_t)(ctrl | AD9834_CTRL_B28));
+    frames[1] = AD9834FrameFreqLSB(reg, word);
+    frames[2] = AD9834FrameFreqMSB(reg, word);
+
+}
+
+//************************************************************************************
+//
+// One step record: both halves of FREQ0, sent with B28 already set.  The phase
+// registers are not in the record, so phase is unused.
+//
+//************************************************************************************
+static inline void AD9834PackStep(uint16_t *record, uint32_t word, uint32_t phase) {
+
+    (void)phase;
+    record[0] = AD9834FrameFreqLSB(AD9834_REG_FREQ0, word);
+    record[1] = AD9834FrameFreqMSB(AD9834_REG_FREQ0, word);
+
+}
+
+#endif /* AD9834_H_ */
@@ -0,0 +1,155 @@
+//************************************************************************************
+//
+// Title:               AD9952 Register Map
+// Author:              Jacob Putz
+// Filename:            AD9952.h
+//
+// Description:     Register addresses and serial frame packing for the AD9952 DDS.
+//                      A write is an instruction byte followed by 1 to 4 data bytes,
+//                      MSB first; an FTW0 write is therefore a 40-bit frame.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Carry the phase in the step record instead of a zero POW0.
+//
+// 0.1.1    -       Add fixed-register packers, the step record packer and frame
+//                  constants.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef AD9952_H_
+#define AD9952_H_
+
+#include <stdint.h>
+
+// Defines
+//
+// Register addresses
+#define     AD9952_REG_CFR1         0x00        // 4 bytes
+#define     AD9952_REG_CFR2         0x01        // 3 bytes
+#define     AD9952_REG_ASF          0x02        // 2 bytes
+#define     AD9952_REG_ARR          0x03        // 1 byte
+#define     AD9952_REG_FTW0         0x04        // 4 bytes
+#define     AD9952_REG_POW0         0x05        // 2 bytes
+
+// Instruction byte
+#define     AD9952_INSTR_READ       0x80
+#define     AD9952_INSTR_ADDR_MASK  0x1F
+
+// Largest frame (instruction + 4 data bytes)
+#define     AD9952_FRAME_MAX        5
+
+// Serial frame width, and elements in one sweep/hop step record (FTW0 + POW0)
+#define     AD9952_FRAME_BITS       8
+#define     AD9952_STEP_ELEMS       8
+
+// Field masks
+#define     AD9952_POW_MASK         0x3FFF
+
+//************************************************************************************
+//
+// Width of each register in bytes, indexed by address.
+//
+//************************************************************************************
+static inline uint32_t AD9952RegBytes(uint8_t reg) {
+
+    static const uint8_t regBytes[6] = { 4, 3, 2, 1, 4, 2 };
+
+    return (reg < 6) ? regBytes[reg] : 0;
+
+}
+
+//************************************************************************************
+//
+// Pack a register write into frames[].  Each element carries one byte so the same
+// 16-bit DMA element type serves both parts; the SSI only shifts out the low 8 bits
+// when configured for 8-bit frames.  Returns the number of elements written.
+//
+//************************************************************************************
+static inline uint32_t AD9952PackWrite(uint16_t *frames, uint8_t reg, uint32_t value) {
+
+    uint32_t bytes = AD9952RegBytes(reg);
+    uint32_t i;
+
+    frames[0] = (uint16_t)(reg & AD9952_INSTR_ADDR_MASK);
+
+    for (i = 0; i < bytes; i++) {
+
+        frames[1 + i] = (uint16_t)((value >> (8 * (bytes - 1 - i))) & 0xFF);
+
+    }
+
+    return bytes + 1;
+
+}
+
+//************************************************************************************
+//
+// Fixed-register packers.  AD9952_PACK_REG() stamps out one function per register
+// with its width as a literal, so the byte loop unrolls to straight stores and no
+// width lookup is left; AD9952PackFTW0() is five stores.  Use these wherever the
+// register is known at compile time and AD9952PackWrite() where it is not.
+//
+//************************************************************************************
+#define     AD9952_PACK_REG(name, reg, bytes)                                       \
+static inline uint32_t AD9952Pack##name(uint16_t *frames, uint32_t value) {         \
+                                                                                    \
+    uint32_t i;                                                                     \
+                                                                                    \
+    frames[0] = (uint16_t)(reg);                                                    \
+                                                                                    \
+    for (i = 0; i < (bytes); i++) {                                                 \
+                                                                                    \
+        frames[1 + i] = (uint16_t)((value >> (8 * ((bytes) - 1 - i))) & 0xFF);      \
+                                                                                    \
+    }                                                                               \
+                                                                                    \
+    return (bytes) + 1;                                                             \
+                                                                                    \
+}
+
+AD9952_PACK_REG(CFR1, AD9952_REG_CFR1, 4)
+AD9952_PACK_REG(CFR2, AD9952_REG_CFR2, 3)
+AD9952_PACK_REG(ASF, AD9952_REG_ASF, 2)
+AD9952_PACK_REG(ARR, AD9952_REG_ARR, 1)
+AD9952_PACK_REG(FTW0, AD9952_REG_FTW0, 4)
+AD9952_PACK_REG(POW0, AD9952_REG_POW0, 2)
+
+//************************************************************************************
+//
+// One step record: FTW0 followed by POW0, both latched by the next IO_UPDATE.
+// phase is the POW0 word in force, so the step leaves the phase where it was.
+//
+//************************************************************************************
+static inline void AD9952PackStep(uint16_t *record, uint32_t word, uint32_t phase) {
+
+    AD9952PackFTW0(&record[0], word);
+    AD9952PackPOW0(&record[5], phase & AD9952_POW_MASK);
+
+}
+
+#endif /* AD9952_H_ */
@@ -0,0 +1,459 @@
+//************************************************************************************
+//
+// Title:               Boot Sequencer
+// Author:              Jacob Putz
+// Filename:            Boot.c
+//
+// Description:     Runs the firmware's start-up stages in dependency order, the
+//                      waveform first, and times each one.  See Boot.h.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       The restore stage needs port L for IO_UPDATE.
+//
+// 0.1.1    -       Build the mask of every stage without a full-width shift.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Boot.h"
+#include "Calib.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "Fault.h"
+#include "Hal.h"
+#include "Mem.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Preset.h"
+#include "Profile.h"
+#include "Record.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SoftDDS.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "Sync.h"
+#include "TimeBase.h"
+
+// Defines
+//
+// Only the parts selected by DDS_CHIP get their SSI, pins and uDMA channels, and
+// only the AD9834 has select lines to modulate.
+//
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+#define     BOOT_AD9834_PERIPHS     SSISTREAM_PERIPHS(SSISTREAM_AD9834)
+#define     BOOT_MOD_PERIPHS        MOD_PERIPHS
+#else
+#define     BOOT_AD9834_PERIPHS     0
+#define     BOOT_MOD_PERIPHS        0
+#endif
+
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+#define     BOOT_AD9952_PERIPHS     SSISTREAM_PERIPHS(SSISTREAM_AD9952)
+#else
+#define     BOOT_AD9952_PERIPHS     0
+#endif
+
+// Global Variables
+tBoot g_boot;
+
+//************************************************************************************
+//
+// Stages.  Each is what main() used to do for that part of the firmware, in the
+// same order within the stage.
+//
+//************************************************************************************
+static void BootFault(void) {
+
+    g_boot.restart = FaultInit(&g_faultSnapshot);
+
+}
+
+//
+// The power manager decides how deeply the scheduler sleeps between events
+//
+static void BootTime(void) {
+
+    TimeBaseInit(g_boot.sysClkHz, BOOT_TICK_HZ);
+    SchedulerPortInit(g_boot.sysClkHz);
+    SchedulerInit();
+    PowerInit();
+
+}
+
+static void BootMem(void) {
+
+    MemInit();
+
+}
+
+//
+// The ring comes from the arena; the port decides whether recording starts now (it
+// does on the target, in wrap mode)
+//
+static void BootRecord(void) {
+
+    RecordInit(&g_record);
+    RecordPortInit(&g_record);
+
+}
+
+//
+// Only the state: the tuning contexts the restore and the presets tune through
+//
+static void BootRemote(void) {
+
+    RemoteInit(&g_remote);
+
+}
+
+static void BootStreams(void) {
+
+    SSIStreamInit(&g_ssiStreams[SSISTREAM_AD9834], SSISTREAM_AD9834);
+    SSIStreamInit(&g_ssiStreams[SSISTREAM_AD9952], SSISTREAM_AD9952);
+    DDSShadowAD9834Init(&g_ad9834Shadow);
+    DDSShadowAD9952Init(&g_ad9952Shadow);
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+    SSIStreamPortInit(&g_ssiStreams[SSISTREAM_AD9834], g_boot.sysClkHz, BOOT_SSI_BIT_RATE);
+#endif
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+    SSIStreamPortInit(&g_ssiStreams[SSISTREAM_AD9952], g_boot.sysClkHz, BOOT_SSI_BIT_RATE);
+#endif
+
+}
+
+//
+// Select lines first, before the modulator claims them.  The AD9952 registers are
+// latched with IO_UPDATE on PL4.
+//
+static void BootRestore(void) {
+
+    if (g_boot.restart) {
+
+        FaultRestore(&g_faultSnapshot);
+
+    }
+
+}
+
+static void BootSweep(void) {
+
+    SweepPortInit(g_boot.sysClkHz);
+
+}
+
+static void BootMod(void) {
+
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+    ModulationPortInit(g_boot.sysClkHz);
+#endif
+
+}
+
+//
+// After a fault restart the preset that was playing, if any, is resumed instead of
+// the boot preset
+//
+static void BootPresets(void) {
+
+    if (!PresetInit()) {
+
+        return;
+
+    }
+
+    if (g_boot.restart) {
+
+        FaultResume(&g_faultSnapshot);
+
+    }
+
+    else if (PresetFind(g_presetImage, PRESET_BOOT_ID) != 0) {
+
+        PresetPlay(g_presetImage, PresetFind(g_presetImage, PRESET_BOOT_ID));
+
+    }
+
+}
+
+static void BootSoftDDS(void) {
+
+    SoftDDSInit();
+
+}
+
+//
+// The edge counter is idle until a CALIB_START arrives on the remote link
+//
+static void BootCalib(void) {
+
+    CalibInit(&g_calib, g_boot.sysClkHz);
+    CalibPortInit();
+
+}
+
+//
+// Channels are added over the remote link to match the board
+//
+static void BootSync(void) {
+
+    SyncInit(&g_sync);
+
+}
+
+//
+// Profiling compiles away outside Debug builds; its trace drains on the link
+//
+static void BootLink(void) {
+
+    RemotePortInit(&g_remote, g_boot.sysClkHz, BOOT_REMOTE_BAUD);
+    ProfileInit();
+    ProfilePortInit();
+
+}
+
+// Global Constants
+const tBootStage g_bootStages[BOOT_STAGE_COUNT] = {
+
+    //
+    // Critical: up to the parts holding a waveform
+    //
+    { "fault", BootFault,
+      0,
+      0, 0 },
+    { "time", BootTime,
+      0,
+      SCHED_PERIPHS, 0 },
+    { "mem", BootMem,
+      0,
+      0, 0 },
+    { "record", BootRecord,
+      BOOT_STAGE(BOOT_MEM) | BOOT_STAGE(BOOT_TIME),
+      0, 0 },
+    { "remote", BootRemote,
+      BOOT_STAGE(BOOT_TIME),
+      0, 0 },
+    { "streams", BootStreams,
+      BOOT_STAGE(BOOT_RECORD),
+      BOOT_AD9834_PERIPHS | BOOT_AD9952_PERIPHS, 0 },
+    { "restore", BootRestore,
+      BOOT_STAGE(BOOT_FAULT) | BOOT_STAGE(BOOT_STREAMS) | BOOT_STAGE(BOOT_REMOTE),
+      HAL_PERIPH_GPIO(HAL_PORT_K) | HAL_PERIPH_GPIO(HAL_PORT_L), 0 },
+    { "sweep", BootSweep,
+      BOOT_STAGE(BOOT_STREAMS),
+      SWEEP_PERIPHS, 0 },
+    { "modulation", BootMod,
+      BOOT_STAGE(BOOT_RESTORE),
+      BOOT_MOD_PERIPHS, 0 },
+
+    //
+    // Deferred
+    //
+    { "presets", BootPresets,
+      BOOT_STAGE(BOOT_FAULT) | BOOT_STAGE(BOOT_SWEEP) | BOOT_STAGE(BOOT_MOD),
+      0, BOOT_FLAG_DEFERRED },
+    { "softdds", BootSoftDDS,
+      0,
+      0, BOOT_FLAG_DEFERRED },
+    { "calib", BootCalib,
+      BOOT_STAGE(BOOT_TIME) | BOOT_STAGE(BOOT_REMOTE),
+      CALIB_PERIPHS, BOOT_FLAG_DEFERRED },
+    { "sync", BootSync,
+      BOOT_STAGE(BOOT_STREAMS),
+      0, BOOT_FLAG_DEFERRED },
+    { "link", BootLink,
+      BOOT_STAGE(BOOT_REMOTE) | BOOT_STAGE(BOOT_PRESETS) | BOOT_STAGE(BOOT_SOFTDDS) |
+      BOOT_STAGE(BOOT_CALIB) | BOOT_STAGE(BOOT_SYNC),
+      REMOTE_PERIPHS, BOOT_FLAG_DEFERRED }
+
+};
+
+//************************************************************************************
+//
+// The next stage of a phase whose dependencies have all run, or -1.  With
+// checked false, dependencies are ignored and the next stage in table order runs.
+//
+//************************************************************************************
+static int32_t BootNext(const tBoot *boot, uint32_t done, bool deferred, bool checked) {
+
+    const tBootStage *stage;
+    uint32_t i;
+
+    for (i = 0; i < boot->count; i++) {
+
+        stage = &boot->stages[i];
+
+        if (((done & BOOT_STAGE(i)) != 0) ||
+            (((stage->flags & BOOT_FLAG_DEFERRED) != 0) != deferred)) {
+
+            continue;
+
+        }
+
+        if (!checked || ((stage->after & ~done) == 0)) {
+
+            return (int32_t)i;
+
+        }
+
+    }
+
+    return -1;
+
+}
+
+//************************************************************************************
+//
+// Check the table by running it dry, then open every clock gate it needs.  Called
+// before BootClock(), so the peripherals come out of reset while the PLL locks.
+//
+//************************************************************************************
+bool BootInit(tBoot *boot, const tBootStage *stages, uint32_t count) {
+
+    uint32_t all, done, phase, i;
+    int32_t next;
+
+    boot->stages = stages;
+    boot->count = (count <= BOOT_MAX_STAGES) ? count : BOOT_MAX_STAGES;
+    boot->valid = (count <= BOOT_MAX_STAGES);
+    boot->periphs = 0;
+    boot->restart = false;
+    boot->done = 0;
+    boot->ran = 0;
+    boot->waveformCycles = 0;
+    boot->readyCycles = 0;
+
+    all = BOOT_STAGE_MASK(boot->count);
+
+    for (i = 0; i < boot->count; i++) {
+
+        boot->times[i].start = 0;
+        boot->times[i].wait = 0;
+        boot->times[i].run = 0;
+        boot->periphs |= stages[i].periphs;
+
+        if ((stages[i].after & ~all) != 0) {
+
+            boot->valid = false;
+
+        }
+
+    }
+
+    //
+    // Every critical stage must run in the critical phase, every deferred stage by
+    // the end of the deferred one
+    //
+    done = 0;
+
+    for (phase = 0; phase < 2; phase++) {
+
+        while ((next = BootNext(boot, done, phase != 0, true)) >= 0) {
+
+            done |= BOOT_STAGE(next);
+
+        }
+
+        if (BootNext(boot, done, phase != 0, false) >= 0) {
+
+            boot->valid = false;
+
+        }
+
+    }
+
+    HalPeriphEnable(boot->periphs);
+
+    return boot->valid;
+
+}
+
+//************************************************************************************
+//
+// Bring up the system clock.  Stage times count from here.
+//
+//************************************************************************************
+uint32_t BootClock(tBoot *boot, uint32_t requestHz) {
+
+    boot->sysClkHz = HalClockInit(requestHz);
+    boot->clockCycles = HalCycles32();
+
+    return boot->sysClkHz;
+
+}
+
+uint32_t BootCycles(const tBoot *boot) {
+
+    return HalCycles32() - boot->clockCycles;
+
+}
+
+//************************************************************************************
+//
+// Run every stage of one phase.  An invalid table runs in table order.
+//
+//************************************************************************************
+void BootRun(tBoot *boot, bool deferred) {
+
+    const tBootStage *stage;
+    tBootTime *time;
+    uint32_t begin;
+    int32_t next;
+
+    while ((next = BootNext(boot, boot->done, deferred, boot->valid)) >= 0) {
+
+        stage = &boot->stages[next];
+        time = &boot->times[next];
+
+        time->start = BootCycles(boot);
+        time->wait = HalPeriphReady(stage->periphs);
+
+        begin = HalCycles32();
+        stage->run();
+        time->run = HalCycles32() - begin;
+
+        boot->done |= BOOT_STAGE(next);
+        boot->order[boot->ran++] = (uint8_t)next;
+
+    }
+
+    if (deferred) {
+
+        boot->readyCycles = BootCycles(boot);
+
+    }
+
+    else {
+
+        boot->waveformCycles = BootCycles(boot);
+
+    }
+
+}
@@ -0,0 +1,184 @@
+//************************************************************************************
+//
+// Title:               Boot Sequencer
+// Author:              Jacob Putz
+// Filename:            Boot.h
+//
+// Description:     The firmware's start-up as a table of stages with their
+//                      dependencies and peripherals.  Every peripheral clock is
+//                      enabled at once before the PLL comes up, each stage waits
+//                      only for its own peripherals, the stages that put a waveform
+//                      on the DDS parts run first and the rest are deferred.  Every
+//                      stage is timed in cycles.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Add BOOT_SYS_CLK_HZ, the clock main() requests.
+//
+// 0.1.1    -       Add BOOT_STAGE_MASK(), defined up to 32 stages, and refuse a
+//                  BOOT_MAX_STAGES above 32.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  main() runs:
+//
+//      BootInit(&g_boot, g_bootStages, BOOT_STAGE_COUNT);
+//      SYS_CLK_ACT = BootClock(&g_boot, SYS_CLK_REQ);
+//      BootRun(&g_boot, false);            // critical stages: first waveform
+//      BootRun(&g_boot, true);             // deferred stages
+//
+//  BootInit() checks the table and opens the clock gate of every peripheral any
+//  stage uses, without waiting.  The gates open on the PIOSC, so the peripherals
+//  come out of reset while BootClock() waits for the crystal and the PLL, and
+//  each stage's HalPeriphReady() normally finds them ready.
+//
+//  BootRun() runs the stages of one phase, each as soon as the stages in its
+//  after mask have run, in table order otherwise.  A stage waits for its periphs
+//  to be ready, then runs; both parts are timed with HalCycles32().  The critical
+//  phase ends with the DDS parts driven: the waveform a fault restart restores
+//  (Fault.h), with the sweep and modulation engines ready for it.  Deferred stages
+//  follow in the same call sequence, before the scheduler loop: the preset store
+//  (a CRC over the whole image) and the boot preset first, then the software DDS
+//  table, calibration, the synchronized channel table and, last, the UART link and
+//  profiling, so no command can arrive before what it drives is set up.
+//
+//  A stage may only depend on stages of its own phase or the critical phase.
+//  BootInit() returns false for a table that breaks this or has a dependency that
+//  can never be met; BootRun() then runs the stages in table order regardless, so
+//  the board still starts.
+//
+//  Times are in system clock cycles from the end of BootClock(); start is when the
+//  stage was picked, wait the part of it spent in HalPeriphReady().  After a
+//  fault restart the cycle counter has kept running and the times still count
+//  from the end of BootClock().  waveformCycles is the end of the critical phase,
+//  readyCycles of the deferred one.  Host/Tools/BootTool.c prints the timeline on
+//  the host simulator and compares it with the serial start-up.
+//
+//************************************************************************************
+
+// Defines
+#define     BOOT_MAX_STAGES         16
+#define     BOOT_STAGE(id)          (1UL << (id))
+
+// The first count stages, 0 to 32, without shifting a 32-bit value by 32
+#define     BOOT_STAGE_MASK(count)  (((count) == 0) ? 0 :                            \
+                                     (0xFFFFFFFFUL >> (32 - (count))))
+
+#if (BOOT_MAX_STAGES > 32)
+#error "BOOT_MAX_STAGES must be at most 32, the bits in a stage mask"
+#endif
+
+// The clock, SSI, time base and remote link set-up the firmware expects; the host
+// tools take them from here
+#define     BOOT_SYS_CLK_HZ         120000000   // SYS_CLK_REQ in DDSExperiment.c
+#define     BOOT_SSI_BIT_RATE       20000000    // 20 MHz SCLK for both DDS parts
+#define     BOOT_TICK_HZ            10          // Only extends the DWT counter to 64 bits
+#define     BOOT_REMOTE_BAUD        921600      // Protocol link on the ICDI virtual COM port
+
+// Stage flags
+#define     BOOT_FLAG_DEFERRED      0x01        // Runs after the first waveform
+
+// The firmware's stages (g_bootStages[] indices)
+#define     BOOT_FAULT              0           // Check the fault snapshot
+#define     BOOT_TIME               1           // Time base, scheduler, power manager
+#define     BOOT_MEM                2           // Runtime memory arena
+#define     BOOT_RECORD             3           // Command trace
+#define     BOOT_REMOTE             4           // Remote state and tuning contexts
+#define     BOOT_STREAMS            5           // SSI streams and register shadows
+#define     BOOT_RESTORE            6           // Waveform after a fault restart
+#define     BOOT_SWEEP              7           // Sweep timer
+#define     BOOT_MOD                8           // FSELECT/PSELECT modulator
+#define     BOOT_PRESETS            9           // Preset store and boot preset
+#define     BOOT_SOFTDDS            10          // Software DDS sine table
+#define     BOOT_CALIB              11          // Reference clock calibration
+#define     BOOT_SYNC               12          // Synchronized channel table
+#define     BOOT_LINK               13          // UART link and profiling
+#define     BOOT_STAGE_COUNT        14
+
+// Type Definitions
+typedef void (*tBootFn)(void);
+
+typedef struct {
+
+    const char *name;
+    tBootFn run;
+    uint32_t after;                 // BOOT_STAGE() of the stages that must run first
+    uint32_t periphs;               // HAL_PERIPH_* the stage uses
+    uint32_t flags;                 // BOOT_FLAG_*
+
+} tBootStage;
+
+typedef struct {
+
+    uint32_t start;                 // Cycles from the clock to the stage starting
+    uint32_t wait;                  // Cycles waiting for its peripherals
+    uint32_t run;                   // Cycles running it
+
+} tBootTime;
+
+typedef struct {
+
+    const tBootStage *stages;
+    uint32_t count;
+    bool valid;                     // The table passed BootInit()'s checks
+    uint32_t periphs;               // Enabled by BootInit()
+    uint32_t sysClkHz;              // From BootClock()
+    uint32_t clockCycles;           // HalCycles32() at the end of BootClock()
+    bool restart;                   // Coming back from a fault (BOOT_FAULT)
+
+    uint32_t done;                  // BOOT_STAGE() of the stages that have run
+    uint32_t ran;                   // Entries in order[]
+    uint8_t order[BOOT_MAX_STAGES]; // Stages in the order they ran
+    tBootTime times[BOOT_MAX_STAGES];
+    uint32_t waveformCycles;        // Critical phase done
+    uint32_t readyCycles;           // Deferred phase done
+
+} tBoot;
+
+// Global Constants
+extern const tBootStage g_bootStages[BOOT_STAGE_COUNT];
+
+// Global Variables
+extern tBoot g_boot;
+
+// Function Prototypes
+extern bool BootInit(tBoot *boot, const tBootStage *stages, uint32_t count);
+extern uint32_t BootClock(tBoot *boot, uint32_t requestHz);
+extern void BootRun(tBoot *boot, bool deferred);
+extern uint32_t BootCycles(const tBoot *boot);
+
+#endif /* BOOT_H_ */
@@ -0,0 +1,402 @@
+//************************************************************************************
+//
+// Title:               Reference Clock Calibration
+// Author:              Jacob Putz
+// Filename:            Calib.c
+//
+// Description:     Sample task, online least-squares fit and feedback into tuning.
+//                      Portable; the edge counter is read through CalibPortCount().
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Not steady while a reference clock retune waits.
+//
+// 0.1.1    -       Attribute corrections in the command trace.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Calib.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "Hop.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Record.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     CALIB_QUANT_SIGMA       0.28867513  // Edges, uniform over one (1 / sqrt(12))
+
+// Global Variables
+tCalib g_calib;
+
+//************************************************************************************
+//
+// The word driving the output of instance, if it is known and steady: no engine
+// running, no retune waiting, nothing waiting in the shadow or the stream (AD9952
+// writes count until IO_UPDATE has latched them), and the part not held in reset.
+//
+//************************************************************************************
+bool CalibOutputWord(uint32_t instance, uint32_t *word) {
+
+    const tAD9834Shadow *shadow = &g_ad9834Shadow;
+    uint16_t sel;
+    uint32_t index;
+
+    if (!DDSChipBuilt(instance) || g_sweep.running || g_modulator.running ||
+        g_remote.shadowDirty[instance] || g_remote.retunePending[instance] ||
+        !SSIStreamIdle(&g_ssiStreams[instance])) {
+
+        return false;
+
+    }
+
+    if (instance == SSISTREAM_AD9952) {
+
+        if ((g_ad9952Shadow.known & DDSSHADOW_AD9952_REG(AD9952_REG_FTW0)) == 0) {
+
+            return false;
+
+        }
+
+        *word = g_ad9952Shadow.devReg[AD9952_REG_FTW0];
+
+        return *word != 0;
+
+    }
+
+    if (((shadow->known & DDSSHADOW_AD9834_CTRL) == 0) ||
+        ((shadow->devCtrl & AD9834_CTRL_RESET) != 0)) {
+
+        return false;
+
+    }
+
+    sel = ((shadow->devCtrl & AD9834_CTRL_PIN_SW) != 0) ? shadow->pins : shadow->devCtrl;
+    index = ((sel & AD9834_CTRL_FSEL) != 0) ? 1 : 0;
+
+    if ((shadow->known & (DDSSHADOW_AD9834_FREQ0 << index)) == 0) {
+
+        return false;
+
+    }
+
+    *word = shadow->devFreq[index];
+
+    return *word != 0;
+
+}
+
+//************************************************************************************
+//
+// Start a fit at this sample.
+//
+//************************************************************************************
+static void CalibBegin(tCalib *calib, uint32_t word, uint32_t count, uint64_t cycles) {
+
+    calib->word = word;
+    calib->lastCount = count;
+    calib->edges = 0;
+    calib->startCycles = cycles;
+    calib->samples = 1;
+    calib->meanX = 0.0;
+    calib->meanY = 0.0;
+    calib->sumXX = 0.0;
+    calib->sumXY = 0.0;
+
+}
+
+//************************************************************************************
+//
+// Turn the finished fit into an output frequency and reference clock, and install
+// the clock if asked to and it has moved by more than the deadband.  The slope's
+// standard error is the quantization error over the spread of the sample times.
+//
+//************************************************************************************
+static void CalibFinish(tCalib *calib) {
+
+    tDDSTuning *tuning = &g_remote.tuning[calib->instance];
+    tDDSTuning nominal;
+    double slope = calib->sumXY / calib->sumXX;
+    double ppm;
+    uint32_t refClkHz;
+    uint32_t origin;
+
+    calib->outputHz = slope * (double)calib->sysClkHz;
+    calib->sigmaPpm = 1e6 * CALIB_QUANT_SIGMA / (sqrt(calib->sumXX) * slope);
+    calib->refClkHz = calib->outputHz * (double)(1ULL << tuning->freqBits) /
+                      (double)calib->word;
+    calib->fits++;
+
+    DDSChipTuningInit(calib->instance, &nominal);
+    ppm = (calib->refClkHz / (double)nominal.refClkHz - 1.0) * 1e6;
+
+    if (fabs(ppm) > CALIB_LIMIT_PPM) {
+
+        calib->rejected++;
+
+    }
+
+    else if ((calib->flags & CALIB_FLAG_APPLY) != 0) {
+
+        refClkHz = (uint32_t)(calib->refClkHz + 0.5);
+        ppm = (calib->refClkHz / (double)tuning->refClkHz - 1.0) * 1e6;
+
+        origin = RecordOrigin(&g_record, RECORD_ORIGIN_CALIB);
+
+        if ((fabs(ppm) > (CALIB_DEADBAND_SIGMA * calib->sigmaPpm)) &&
+            RemoteSetRefClk(&g_remote, calib->instance, refClkHz)) {
+
+            calib->applied++;
+
+        }
+
+        RecordOrigin(&g_record, origin);
+
+    }
+
+    CalibPortFit(calib);
+
+}
+
+//************************************************************************************
+//
+// Add one (count, cycles) pair.  x is cycles since the fit began and y the
+// unwrapped edge count; the means and centred sums are updated in Welford's form,
+// which keeps full precision however far x grows from zero.
+//
+//************************************************************************************
+void CalibSample(tCalib *calib, uint32_t count, uint64_t cycles) {
+
+    uint32_t word;
+    double x, y, dx;
+
+    if (!calib->running) {
+
+        return;
+
+    }
+
+    if (!CalibOutputWord(calib->instance, &word)) {
+
+        if (calib->samples != 0) {
+
+            calib->restarts++;
+            calib->samples = 0;
+
+        }
+
+        return;
+
+    }
+
+    if ((calib->samples == 0) || (word != calib->word)) {
+
+        if (calib->samples > 1) {
+
+            calib->restarts++;
+
+        }
+
+        CalibBegin(calib, word, count, cycles);
+        return;
+
+    }
+
+    calib->edges += (count - calib->lastCount) & CALIB_COUNT_MASK;
+    calib->lastCount = count;
+
+    x = (double)(cycles - calib->startCycles);
+    y = (double)calib->edges;
+
+    calib->samples++;
+    dx = x - calib->meanX;
+    calib->meanX += dx / (double)calib->samples;
+    calib->meanY += (y - calib->meanY) / (double)calib->samples;
+    calib->sumXX += dx * (x - calib->meanX);
+    calib->sumXY += dx * (y - calib->meanY);
+
+    if (calib->samples >= calib->fitSamples) {
+
+        CalibFinish(calib);
+        CalibBegin(calib, word, count, cycles);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Latch a sample.  The timer interrupt shares SysTick's priority, so the count
+// and the cycle counter are read with nothing in between.
+//
+//************************************************************************************
+static void CalibTimerHandler(void) {
+
+    tCalib *calib = &g_calib;
+
+    calib->latchCount = CalibPortCount(calib);
+    calib->latchCycles = TimeBaseCycles();
+    calib->latched = true;
+
+}
+
+//************************************************************************************
+//
+// Fit the sample latched since the last run, unless the output moved while it
+// was being taken, and arm the timer for the next one.
+//
+//************************************************************************************
+static void CalibSampleTask(tSchedTask *task, uint64_t now) {
+
+    tCalib *calib = (tCalib *)task->arg;
+    uint32_t word;
+
+    (void)now;
+
+    if (!CalibOutputWord(calib->instance, &word)) {
+
+        word = 0;
+
+    }
+
+    if (calib->latched) {
+
+        calib->latched = false;
+
+        if ((word != 0) && (word == calib->armWord)) {
+
+            CalibSample(calib, calib->latchCount, calib->latchCycles);
+
+        }
+
+        else if (calib->samples != 0) {
+
+            calib->restarts++;
+            calib->samples = 0;
+
+        }
+
+    }
+
+    calib->armWord = word;
+    HalTimerStart(CALIB_TIMER, 1 + HopRandomBelow(&calib->dither, calib->ditherCycles),
+                  false);
+    SchedulerDefer(task, CALIB_SAMPLE_US);
+
+}
+
+void CalibInit(tCalib *calib, uint32_t sysClkHz) {
+
+    calib->sysClkHz = sysClkHz;
+    calib->running = false;
+    calib->instance = 0;
+    calib->flags = 0;
+    calib->fitSamples = CALIB_FIT_SAMPLES;
+    calib->dither = CALIB_DITHER_SEED;
+    calib->ditherCycles = (sysClkHz / 1000000) * CALIB_DITHER_US;
+    calib->latched = false;
+    calib->samples = 0;
+    calib->outputHz = 0.0;
+    calib->refClkHz = 0.0;
+    calib->sigmaPpm = 0.0;
+    calib->fits = 0;
+    calib->applied = 0;
+    calib->restarts = 0;
+    calib->rejected = 0;
+
+    SchedulerTaskInit(&calib->task, CalibSampleTask, calib);
+    HalTimerInit(CALIB_TIMER, CalibTimerHandler);
+
+}
+
+//************************************************************************************
+//
+// Measure instance's output, fitting over fitSamples samples (zero for the
+// default).  A running measurement is restarted with the new settings.
+//
+//************************************************************************************
+bool CalibStart(tCalib *calib, uint32_t instance, uint32_t flags, uint32_t fitSamples) {
+
+    if (fitSamples == 0) {
+
+        fitSamples = CALIB_FIT_SAMPLES;
+
+    }
+
+    if (!DDSChipBuilt(instance) || (fitSamples < CALIB_FIT_SAMPLES_MIN)) {
+
+        return false;
+
+    }
+
+    CalibStop(calib);
+
+    calib->instance = instance;
+    calib->flags = flags;
+    calib->fitSamples = fitSamples;
+    calib->samples = 0;
+    calib->running = true;
+
+    PowerHold(POWER_HOLD_CALIB);
+    CalibPortStart(calib);
+    calib->latched = false;
+    SchedulerAdd(&calib->task, TimeBaseMicros() + CALIB_SAMPLE_US);
+
+    return true;
+
+}
+
+void CalibStop(tCalib *calib) {
+
+    if (!calib->running) {
+
+        return;
+
+    }
+
+    SchedulerRemove(&calib->task);
+    HalTimerStop(CALIB_TIMER);
+    CalibPortStop(calib);
+    PowerRelease(POWER_HOLD_CALIB);
+
+    calib->running = false;
+    calib->samples = 0;
+
+}
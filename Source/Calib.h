@@ -0,0 +1,186 @@
+//************************************************************************************
+//
+// Title:               Reference Clock Calibration
+// Author:              Jacob Putz
+// Filename:            Calib.h
+//
+// Description:     Closed-loop measurement of a DDS output against the 25 MHz MOSC.
+//                      A free-running GPTM edge counter on the output is sampled
+//                      against the cycle counter, a least-squares fit gives the output
+//                      frequency, and from the programmed tuning word the part's actual
+//                      reference clock.  The estimate is fed back into the remote
+//                      link's tuning contexts while the output keeps running.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Add CALIB_PERIPHS.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef CALIB_H_
+#define CALIB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Scheduler.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  The part's comparator or SIGN BIT OUT square wave drives T2CCP0 (PM0); Timer2A
+//  counts its rising edges, free running with the prescaler as a 24-bit
+//  extension.  Every CALIB_SAMPLE_US the sample task arms a one-shot timer
+//  (CALIB_TIMER) for a random delay of up to CALIB_DITHER_US, in cycles; its
+//  interrupt reads the count and the 64-bit cycle count back to back, and the
+//  next run of the task adds the pair to the fit.  The system clock is the PLL
+//  locked to the MOSC, so cycles are MOSC time, and the pairing makes this a
+//  reciprocal counter with no gate to time.  The dither is what lets the one-edge
+//  quantization average out: sampled on a fixed grid, an output close to a
+//  multiple of the grid rate shows the same fraction of an edge every time and
+//  the fit inherits it as a bias of up to one edge per fit.
+//
+//  Each fit is an online least-squares line through fitSamples points of
+//  (cycles, edges) since the fit began.  The count quantization (one edge) does
+//  not accumulate, so the slope error falls as 1 / (f * T * sqrt(n)): about
+//  0.1 ppm for a 1 MHz output over the default one-second fit, but 100 ppm at
+//  1 kHz, where a longer fit is needed.  The sums are kept in double, which the
+//  M4F does in software; single precision would lose the slope, and at one sample
+//  per CALIB_SAMPLE_US the cost does not show.  Then
+//
+//      fOut   = slope * sysClkHz
+//      refClk = fOut * 2^N / word
+//
+//  independent of the reference clock the word was computed with, and sigmaPpm
+//  is its standard error from the quantization alone.  An estimate more than
+//  CALIB_LIMIT_PPM from the part's nominal clock is counted as rejected and not
+//  used (no signal on the pin, or the wrong part).  With CALIB_FLAG_APPLY set, an
+//  estimate more than CALIB_DEADBAND_SIGMA standard errors from the clock in use
+//  is rounded to a whole Hertz and installed with RemoteSetRefClk(), which
+//  re-sends the frequencies in effect; the deadband keeps fit noise from walking
+//  the output around.  A ppm-sized change only touches the LSBs of the word,
+//  which the shadow writes as one frame, so the output never stops or jumps
+//  phase.  The word change also restarts the fit.
+//
+//  Samples are dropped, and the fit restarted, while a sweep, hop or modulation
+//  is running, while register writes are in flight, or when the output word is
+//  not known.  Deep sleep is held off while measuring.  The edge counter needs
+//  pulses of at least two system clocks, so outputs are limited to about 30 MHz.
+//
+//************************************************************************************
+
+// Defines
+#define     CALIB_SAMPLE_US         10000
+#define     CALIB_DITHER_US         1000        // Spans an edge down to 1 kHz outputs
+#define     CALIB_DITHER_SEED       0x2545F491
+#define     CALIB_TIMER             HAL_TIMER_3
+#define     CALIB_FIT_SAMPLES       100         // Default fit length (one second)
+#define     CALIB_FIT_SAMPLES_MIN   8
+#define     CALIB_COUNT_MASK        0x00FFFFFF  // 24-bit edge counter
+#define     CALIB_LIMIT_PPM         1000        // Plausible reference clock error
+#define     CALIB_DEADBAND_SIGMA    2
+
+// Peripherals CalibInit() and CalibPortInit() bring up: the sample timer, and the
+// Timer 2 edge counter with its input on PM0
+#define     CALIB_PERIPHS           (HAL_PERIPH_TIMER(CALIB_TIMER) |                      \
+                                     HAL_PERIPH_TIMER(HAL_TIMER_2) |                      \
+                                     HAL_PERIPH_GPIO(HAL_PORT_M))
+
+// CalibStart() flags
+#define     CALIB_FLAG_APPLY        0x01        // Feed estimates into tuning
+
+// Type Definitions
+typedef struct {
+
+    uint32_t sysClkHz;
+    tSchedTask task;
+    bool running;
+    uint32_t instance;
+    uint32_t flags;
+    uint32_t fitSamples;
+    uint32_t dither;                // HopRandom() state
+    uint32_t ditherCycles;
+
+    //
+    // Sample latched by the CALIB_TIMER interrupt
+    //
+    volatile bool latched;
+    volatile uint32_t latchCount;
+    volatile uint64_t latchCycles;
+    uint32_t armWord;               // Output word when the timer was armed
+
+    //
+    // Current fit
+    //
+    uint32_t word;                  // Output word the fit is measuring
+    uint32_t lastCount;
+    uint64_t edges;                 // Unwrapped edges since the fit began
+    uint64_t startCycles;
+    uint32_t samples;
+    double meanX;                   // Running means and sums of the fit
+    double meanY;
+    double sumXX;
+    double sumXY;
+
+    //
+    // Results
+    //
+    double outputHz;                // Last fitted output frequency
+    double refClkHz;                // Last reference clock estimate
+    double sigmaPpm;                // Its standard error
+    uint32_t fits;
+    uint32_t applied;               // Estimates installed in the tuning contexts
+    uint32_t restarts;              // Fits abandoned (output not steady)
+    uint32_t rejected;              // Estimates beyond CALIB_LIMIT_PPM
+
+} tCalib;
+
+// Global Variables
+extern tCalib g_calib;
+
+// Function Prototypes
+//
+// Portable core (Calib.c)
+//
+extern void CalibInit(tCalib *calib, uint32_t sysClkHz);
+extern bool CalibStart(tCalib *calib, uint32_t instance, uint32_t flags,
+                       uint32_t fitSamples);
+extern void CalibStop(tCalib *calib);
+extern bool CalibOutputWord(uint32_t instance, uint32_t *word);
+extern void CalibSample(tCalib *calib, uint32_t count, uint64_t cycles);
+
+//
+// Port layer (CalibTiva.c on target, Host/CalibHost.c on a host build)
+//
+extern void CalibPortInit(void);
+extern void CalibPortStart(tCalib *calib);
+extern void CalibPortStop(tCalib *calib);
+extern uint32_t CalibPortCount(const tCalib *calib);
+extern void CalibPortFit(const tCalib *calib);
+
+#endif /* CALIB_H_ */
@@ -0,0 +1,139 @@
+//************************************************************************************
+//
+// Title:               Reference Clock Calibration - TM4C1294 Port
+// Author:              Jacob Putz
+// Filename:            CalibTiva.c
+//
+// Description:     Timer 2A input edge counter on T2CCP0 (PM0) for Calib.c.  The
+//                      prescaler extends the count to 24 bits; a match interrupt at
+//                      the top re-arms the timer, which stops there in edge-count
+//                      mode.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Wait only for the peripherals to be ready; their clocks are
+//                  enabled at boot.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "Calib.h"
+#include "Hal.h"
+
+// Defines
+#define     CALIB_PORT_BASE         GPIO_PORTM_BASE
+#define     CALIB_PIN               GPIO_PIN_0
+#define     CALIB_TIMER_BASE        TIMER2_BASE
+#define     CALIB_TIMER_INT         INT_TIMER2A
+
+//************************************************************************************
+//
+// The count has reached CALIB_COUNT_MASK and gone back to zero.  The edge that
+// arrives while the timer is stopped is lost, one edge in 2^24.
+//
+//************************************************************************************
+static void CalibTimerHandler(void) {
+
+    TimerIntClear(CALIB_TIMER_BASE, TIMER_CAPA_MATCH);
+    TimerEnable(CALIB_TIMER_BASE, TIMER_A);
+
+}
+
+void CalibPortInit(void) {
+
+    //
+    // Enabled at boot (Boot.h); wait until they can be accessed
+    //
+    HalPeriphReady(CALIB_PERIPHS);
+
+    //
+    // The DDS square wave comes in on PM0
+    //
+    GPIOPinConfigure(GPIO_PM0_T2CCP0);
+    GPIOPinTypeTimer(CALIB_PORT_BASE, CALIB_PIN);
+
+    //
+    // Timer 2A counting rising edges up from zero, prescaler as bits 23:16
+    //
+    TimerConfigure(CALIB_TIMER_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_CAP_COUNT_UP);
+    TimerControlEvent(CALIB_TIMER_BASE, TIMER_A, TIMER_EVENT_POS_EDGE);
+    TimerLoadSet(CALIB_TIMER_BASE, TIMER_A, 0);
+    TimerPrescaleSet(CALIB_TIMER_BASE, TIMER_A, 0);
+    TimerMatchSet(CALIB_TIMER_BASE, TIMER_A, CALIB_COUNT_MASK & 0xFFFF);
+    TimerPrescaleMatchSet(CALIB_TIMER_BASE, TIMER_A, CALIB_COUNT_MASK >> 16);
+    TimerIntRegister(CALIB_TIMER_BASE, TIMER_A, CalibTimerHandler);
+    IntEnable(CALIB_TIMER_INT);
+
+}
+
+void CalibPortStart(tCalib *calib) {
+
+    (void)calib;
+
+    TimerIntClear(CALIB_TIMER_BASE, TIMER_CAPA_MATCH);
+    TimerIntEnable(CALIB_TIMER_BASE, TIMER_CAPA_MATCH);
+    TimerEnable(CALIB_TIMER_BASE, TIMER_A);
+
+}
+
+void CalibPortStop(tCalib *calib) {
+
+    (void)calib;
+
+    TimerDisable(CALIB_TIMER_BASE, TIMER_A);
+    TimerIntDisable(CALIB_TIMER_BASE, TIMER_CAPA_MATCH);
+
+}
+
+uint32_t CalibPortCount(const tCalib *calib) {
+
+    (void)calib;
+
+    return TimerValueGet(CALIB_TIMER_BASE, TIMER_A) & CALIB_COUNT_MASK;
+
+}
+
+//************************************************************************************
+//
+// Results are read back with CALIB_STATUS on the remote link.
+//
+//************************************************************************************
+void CalibPortFit(const tCalib *calib) {
+
+    (void)calib;
+
+}
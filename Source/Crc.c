@@ -0,0 +1,67 @@
+//************************************************************************************
+//
+// Title:               CRC Routines
+// Author:              Jacob Putz
+// Filename:            Crc.c
+//
+// Description:     CRC-32 with a nibble table, two lookups per byte.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdint.h>
+#include "Crc.h"
+
+// Global Constants
+static const uint32_t g_crc32Nibble[16] = {
+
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+
+};
+
+uint32_t Crc32(uint32_t crc, const void *data, uint32_t length) {
+
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    crc = ~crc;
+
+    while (length--) {
+
+        crc ^= *bytes++;
+        crc = (crc >> 4) ^ g_crc32Nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ g_crc32Nibble[crc & 0x0F];
+
+    }
+
+    return ~crc;
+
+}
@@ -0,0 +1,54 @@
+//************************************************************************************
+//
+// Title:               CRC Routines
+// Author:              Jacob Putz
+// Filename:            Crc.h
+//
+// Description:     Table-driven CRC-32 (IEEE 802.3, reflected) for preset images
+//                      and other stored or transmitted blocks.  Portable; uses a
+//                      16-entry nibble table so it costs 64 bytes of flash.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include <stdint.h>
+
+// Defines
+#define     CRC32_INIT              0x00000000
+
+// Function Prototypes
+//
+// Running CRC: pass CRC32_INIT (or the previous result) as crc to continue over
+// several buffers.  Matches zlib's crc32().
+//
+extern uint32_t Crc32(uint32_t crc, const void *data, uint32_t length);
+
+#endif /* CRC_H_ */
@@ -0,0 +1,207 @@
+//************************************************************************************
+//
+// Title:               DDS Chip Front End
+// Author:              Jacob Putz
+// Filename:            DDSChip.h
+//
+// Description:     Compile-time chip selection and the common front end over the
+//                      AD9834 and AD9952 drivers.  Each part's register encoding,
+//                      frame length and clock constants are folded into per-part
+//                      functions generated from its descriptor; the front end only
+//                      chooses between them, and not even that when a single part
+//                      is built.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Pass the phase word through to the step record packers.
+//
+// 0.1.3    -       Point to the host check.
+//
+// 0.1.2    -       Rewrap to the column width.
+//
+// 0.1.1    -       Add DDSChipStepBits().
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef DDSCHIP_H_
+#define DDSCHIP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "DDSTuning.h"
+#include "SSIStream.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  DDS_CHIP is a mask of the parts the firmware drives, one bit per SSIStream
+//  instance.  The build configurations set it (--define=DDS_CHIP=3 builds both);
+//  without a definition both parts are built.
+//
+//      DDS_CHIP=1      AD9834 only
+//      DDS_CHIP=2      AD9952 only
+//      DDS_CHIP=3      both
+//
+//  A part is described by <part>_REF_CLK_HZ, _FREQ_BITS, _PHASE_BITS, _FRAME_BITS,
+//  _STEP_ELEMS and <part>PackStep(record, word, phase).  DDS_CHIP_SPECIALIZE(part)
+//  generates the DDSChip<part>*() functions from those, so every constant is a
+//  literal in the generated body.  The front end DDSChip*(instance, ...) picks one
+//  through DDS_CHIP_SELECT(): with a single part built the preprocessor makes the
+//  choice and instance is never compared; with both it is one compare per call,
+//  made outside any per-word loop.  Instances that are not built fail
+//  DDSChipBuilt(), which is what every command and preset check uses to reject
+//  them.
+//
+//  Host/Tools/DDSChipTool.c checks the records and constants of both paths
+//  against a generic driver that picks the part on every write, and its bench
+//  gives the cost per write of each.
+//
+//************************************************************************************
+
+// Defines
+//
+// Parts, as DDS_CHIP bits
+#define     DDS_CHIP_AD9834         (1UL << SSISTREAM_AD9834)
+#define     DDS_CHIP_AD9952         (1UL << SSISTREAM_AD9952)
+
+#ifndef DDS_CHIP
+#define     DDS_CHIP                (DDS_CHIP_AD9834 | DDS_CHIP_AD9952)
+#endif
+
+// Reference clocks under the descriptor names
+#define     AD9834_REF_CLK_HZ       AD9834_MCLK_HZ
+#define     AD9952_REF_CLK_HZ       AD9952_SYSCLK_HZ
+
+#if (DDS_CHIP == DDS_CHIP_AD9834)
+#define     DDS_CHIP_SELECT(instance, ad9834, ad9952)   ((void)(instance), (ad9834))
+#elif (DDS_CHIP == DDS_CHIP_AD9952)
+#define     DDS_CHIP_SELECT(instance, ad9834, ad9952)   ((void)(instance), (ad9952))
+#elif (DDS_CHIP == (DDS_CHIP_AD9834 | DDS_CHIP_AD9952))
+#define     DDS_CHIP_SELECT(instance, ad9834, ad9952)                               \
+                (((instance) == SSISTREAM_AD9834) ? (ad9834) : (ad9952))
+#else
+#error "DDS_CHIP must be 1 (AD9834), 2 (AD9952) or 3 (both)"
+#endif
+
+#define     DDSChipBuilt(instance)                                                  \
+                (((instance) < SSISTREAM_COUNT) &&                                  \
+                 ((DDS_CHIP & (1UL << (instance))) != 0))
+
+//************************************************************************************
+//
+// Per-part functions.
+//
+//************************************************************************************
+#define     DDS_CHIP_SPECIALIZE(part)                                               \
+static inline void DDSChip##part##PackRecords(const uint32_t *words,                \
+                                              uint16_t *record, uint32_t count,     \
+                                              uint32_t phase) {                     \
+                                                                                    \
+    uint32_t i;                                                                     \
+                                                                                    \
+    for (i = 0; i < count; i++) {                                                   \
+                                                                                    \
+        part##PackStep(record, words[i], phase);                                    \
+        record += part##_STEP_ELEMS;                                                \
+                                                                                    \
+    }                                                                               \
+                                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline uint32_t DDSChip##part##StepBits(void) {                              \
+                                                                                    \
+    return part##_STEP_ELEMS * (part##_FRAME_BITS + 1);                             \
+                                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline uint32_t DDSChip##part##MaxStepRate(uint32_t bitRate) {               \
+                                                                                    \
+    return bitRate / DDSChip##part##StepBits();                                     \
+                                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline bool DDSChip##part##TuningInit(tDDSTuning *tuning) {                  \
+                                                                                    \
+    return DDSTuningInit(tuning, part##_REF_CLK_HZ, part##_FREQ_BITS,               \
+                         part##_PHASE_BITS);                                        \
+                                                                                    \
+}
+
+DDS_CHIP_SPECIALIZE(AD9834)
+DDS_CHIP_SPECIALIZE(AD9952)
+
+//************************************************************************************
+//
+// Front end.  instance must pass DDSChipBuilt().
+//
+//************************************************************************************
+static inline uint32_t DDSChipStepElems(uint32_t instance) {
+
+    return DDS_CHIP_SELECT(instance, AD9834_STEP_ELEMS, AD9952_STEP_ELEMS);
+
+}
+
+static inline void DDSChipPackRecords(uint32_t instance, const uint32_t *words,
+                                      uint16_t *record, uint32_t count,
+                                      uint32_t phase) {
+
+    DDS_CHIP_SELECT(instance, DDSChipAD9834PackRecords(words, record, count, phase),
+                              DDSChipAD9952PackRecords(words, record, count, phase));
+
+}
+
+//************************************************************************************
+//
+// SSI clocks per step record, and the highest step rate the SSI can sustain at
+// bitRate.  Each element costs its data bits plus one clock of frame gap.
+//
+//************************************************************************************
+static inline uint32_t DDSChipStepBits(uint32_t instance) {
+
+    return DDS_CHIP_SELECT(instance, DDSChipAD9834StepBits(),
+                           DDSChipAD9952StepBits());
+
+}
+
+static inline uint32_t DDSChipMaxStepRate(uint32_t instance, uint32_t bitRate) {
+
+    return DDS_CHIP_SELECT(instance, DDSChipAD9834MaxStepRate(bitRate),
+                                     DDSChipAD9952MaxStepRate(bitRate));
+
+}
+
+static inline bool DDSChipTuningInit(uint32_t instance, tDDSTuning *tuning) {
+
+    return DDS_CHIP_SELECT(instance, DDSChipAD9834TuningInit(tuning),
+                                     DDSChipAD9952TuningInit(tuning));
+
+}
+
+#endif /* DDSCHIP_H_ */
@@ -7,7 +7,7 @@
 // Description:     This program is to be used to incrementally compile/test/run
 //                      each stage of the master DDSExperiment.c
 //
-// Current Revision:    0.1.1
+// Current Revision:    0.1.22
 //
 // TivaWare:            2.1.4.178
 //
@@ -33,6 +33,50 @@
 //
 // Revision History:
 //
+// 0.1.22   -       Request the clock from Boot.h.
+//
+// 0.1.21   -       Rewrap the start-up clock comment.
+//
+// 0.1.20   -       Start up through the boot sequencer: clocks enabled at once,
+//                  the waveform first, the rest deferred, every stage timed.
+//
+// 0.1.19   -       Restore the last waveform after a fault restart.
+//
+// 0.1.18   -       Start with an empty synchronized channel table.
+//
+// 0.1.17   -       Record DDS commands from start-up.
+//
+// 0.1.16   -       Bring up the reference clock calibration edge counter.
+//
+// 0.1.15   -       Bring up only the parts selected by DDS_CHIP.
+//
+// 0.1.14   -       Set up the runtime memory arena.
+//
+// 0.1.13   -       Select sleep depth through the power manager.
+//
+// 0.1.12   -       Build the software DDS sine table.
+//
+// 0.1.11   -       Bring up the remote control link on UART0 ahead of the profiler.
+//
+// 0.1.10   -       Initialise the DDS register shadows.
+//
+// 0.1.9    -       Validate the flash preset store and start the boot preset.
+//
+// 0.1.8    -       Bring up the clock and LEDs through the HAL.
+//
+// 0.1.7    -       Add DWT profiling and the UART0 trace drain (Debug only).
+//
+// 0.1.6    -       Bring up the FSELECT/PSELECT modulator.
+//
+// 0.1.5    -       Bring up the hardware-timed sweep engine.
+//
+// 0.1.4    -       Port the LED state machine to scheduled tasks and sleep between
+//                  events.
+//
+// 0.1.3    -       Replace COUNT/millis() with the sequence-locked TimeBase.
+//
+// 0.1.2    -       Add uDMA-backed SSI frame streams for the AD9834 and AD9952.
+//
 // 0.1.1    -       Implement SysTick timer, interrupt and millis() function.
 //
 // 0.1.0    -       Example project “blinky” with minor modifications.
@@ -42,27 +86,22 @@
 // Includes
 #include <stdbool.h>
 #include <stdint.h>
-#include "inc/tm4c1294ncpdt.h"
-#include "inc/hw_sysctl.h"
-#include "inc/hw_types.h"
-#include "inc/hw_memmap.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/gpio.h"
-#include "driverlib/pin_map.h"
-#include "driverlib/interrupt.h"
-#include "driverlib/systick.h"
+#include "Boot.h"
+#include "Hal.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
 
 // Defines
 //
 // GPIO Base Defines
-#define     PORTF               GPIO_PORTF_BASE
-#define     PORTN               GPIO_PORTN_BASE
+#define     PORTF               HAL_PORT_F
+#define     PORTN               HAL_PORT_N
 
 // GPIO Defines
-#define     LED1                GPIO_PIN_1  //Port N Pin 1
-#define     LED2                GPIO_PIN_0  //Port N Pin 0
-#define     LED3                GPIO_PIN_4  //Port F Pin 4
-#define     LED4                GPIO_PIN_0  //Port F Pin 0
+#define     LED1                HAL_PIN_1   //Port N Pin 1
+#define     LED2                HAL_PIN_0   //Port N Pin 0
+#define     LED3                HAL_PIN_4   //Port F Pin 4
+#define     LED4                HAL_PIN_0   //Port F Pin 0
 
 // Miscellaneous Defines
 #define     LHALF               0x0F
@@ -72,14 +111,32 @@
 #define     HIGH                0x1
 #define     LOW                 0x0
 
+// Type Definitions
+//
+// Blink pattern.  steps[] holds the number of milliseconds spent in each state,
+// starting with the LED off; the task toggles the LED at the end of each step.
+//
+typedef struct {
+
+    uint32_t port;
+    uint8_t pin;
+    const uint32_t *steps;
+    uint32_t count;
+    uint32_t index;
+    bool on;
+
+} tLedPattern;
+
 // Global Constants
-const uint32_t SYS_CLK_REQ = 0x07270E00;    // 120 MHz
+const uint32_t SYS_CLK_REQ = BOOT_SYS_CLK_HZ;    // 120 MHz
+
+const uint32_t LED1_STEPS[] = { 750, 750 };             // Off, On
+const uint32_t LED2_STEPS[] = { 700, 100, 100, 100 };   // Long Off, On, Short Off, On
+const uint32_t LED3_STEPS[] = { 750, 250 };             // Off, On
 
 // Global Variables
 uint32_t SYS_CLK_ACT = 0;           // Actual clock frequency obtained by PLL
 
-volatile uint64_t COUNT = 0;        // Stores how many times Interrupt handler called
-
 //************************************************************************************
 //
 // Notes
@@ -106,22 +163,17 @@ volatile uint64_t COUNT = 0;        // Stores how many times Interrupt handler c
 //
 //************************************************************************************
 
-void SysTickHandler() {
+void LedPatternTask(tSchedTask *task, uint64_t now) {
 
-    //
-    // The SysTick Timer is configured as a millisecond timer.  An unsigned 64 bit
-    // number will have a maximum value of 18,446,744,073,709,551,615.  It will take
-    // just over 584,542,046 years (2^64/(1000*60*60*24*365.25)) of constant running to
-    // fill this variable and nearly 50 days of constant running to fill a 32 bit
-    // number.
-    //
-    COUNT++;
+    tLedPattern *led = (tLedPattern *)task->arg;
 
-};
+    (void)now;
 
-uint64_t millis () {
+    led->on = !led->on;
+    HalGpioWrite(led->port, led->pin, led->on ? led->pin : 0x0);
 
-    return COUNT;
+    led->index = (led->index + 1) % led->count;
+    SchedulerDefer(task, led->steps[led->index] * 1000);
 
 };
 
@@ -130,139 +182,58 @@ void main() {
     //
     // Local Variables
     //
-    uint64_t led1OnTime = 750, led1OffTime = 750, led2OnTime = 100, led2ShortOff = 100;
-    uint64_t led2LongOff = 700, led3OnTime = 250, led3OffTime = 750;
+    tLedPattern led1 = { PORTN, LED1, LED1_STEPS, 2, 0, false };
+    tLedPattern led2 = { PORTN, LED2, LED2_STEPS, 4, 0, false };
+    tLedPattern led3 = { PORTF, LED3, LED3_STEPS, 2, 0, false };
 
-    volatile uint32_t pulse = 0;
+    tSchedTask led1Task, led2Task, led3Task;
 
-    volatile uint64_t led1PreviousMillis = 0, led2PreviousMillis = 0;
-    volatile uint64_t led3PreviousMillis = 0;
-
-    volatile bool led1On = false, led2On = false, led3On = false;
+    uint64_t start;
 
     //
-    // Use external 25MHz Precision Oscillator to Generate an 120MHz System
-    // Clock using the PLL
+    // Open every peripheral clock gate the start-up and the LEDs need, then use
+    // external 25MHz Precision Oscillator to Generate an 120MHz System Clock using
+    // the PLL.  The peripherals come out of reset while the PLL locks.  After a
+    // fault restart the PLL is still locked and the clock comes back at once.
     //
-    SysCtlMOSCConfigSet(SYSCTL_MOSC_HIGHFREQ);
-    SYS_CLK_ACT = SysCtlClockFreqSet(SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN |
-                        SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480, SYS_CLK_REQ);
+    HalPeriphEnable(HAL_PERIPH_GPIO(PORTF) | HAL_PERIPH_GPIO(PORTN));
+    BootInit(&g_boot, g_bootStages, BOOT_STAGE_COUNT);
+    SYS_CLK_ACT = BootClock(&g_boot, SYS_CLK_REQ);
 
     //
-    // Enable Peripherals
+    // Everything up to the DDS parts holding a waveform (restored after a fault),
+    // then the preset store and boot preset, calibration, the remote link and the
+    // rest.  g_boot.times[] holds each stage's cycles.
     //
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPION);
+    BootRun(&g_boot, false);
+    BootRun(&g_boot, true);
 
     //
-    // Configure the SysTick Timer.
+    // Configure the LEDs as 4 mA push-pull outputs
     //
-    SysTickPeriodSet(SYS_CLK_ACT / 1000);
-    SysTickIntRegister(SysTickHandler);
-    SysTickEnable();
-    SysTickIntEnable();
-
-    if(!SysCtlPeripheralReady(SYSCTL_PERIPH_GPION)) {
-
-        while(!SysCtlPeripheralReady(SYSCTL_PERIPH_GPION)) {
-
-            // Wait for the peripheral to become ready.
-
-        }
-
-    }
+    HalGpioOutputInit(PORTF, LED3 | LED4, 4);
+    HalGpioOutputInit(PORTN, LED1 | LED2, 4);
 
     //
-    // Configure GPIO Type
+    // Schedule the LED patterns
     //
-    GPIOPinTypeGPIOOutput(PORTF, LED3 | LED4);
-    GPIOPinTypeGPIOOutput(PORTN, LED1 | LED2);
+    start = TimeBaseMicros();
 
-    //
-    // Set GPIO Direction
-    //
-    GPIODirModeSet(PORTF, LED3 | LED4, GPIO_DIR_MODE_OUT);
-    GPIODirModeSet(PORTN, LED1 | LED2, GPIO_DIR_MODE_OUT);
+    SchedulerTaskInit(&led1Task, LedPatternTask, &led1);
+    SchedulerTaskInit(&led2Task, LedPatternTask, &led2);
+    SchedulerTaskInit(&led3Task, LedPatternTask, &led3);
 
-    //
-    // Configure GPIO Pad Properties
-    //
-    GPIOPadConfigSet(PORTF, LED3 | LED4, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD);
-    GPIOPadConfigSet(PORTN, LED1 | LED2, GPIO_STRENGTH_4MA, GPIO_PIN_TYPE_STD);
+    SchedulerAdd(&led1Task, start + LED1_STEPS[0] * 1000);
+    SchedulerAdd(&led2Task, start + LED2_STEPS[0] * 1000);
+    SchedulerAdd(&led3Task, start + LED3_STEPS[0] * 1000);
 
     //
-    // Enter forever loop
+    // Enter forever loop.  SchedulerPoll() runs whatever is due and sleeps until
+    // the next deadline.
     //
     while(1) {
 
-        uint64_t currentMillis = millis();
-
-        if (led1On && (currentMillis - led1PreviousMillis >= led1OnTime)) {
-
-            led1On = false;
-            led1PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTN, LED1, 0x0);
-
-        }
-
-        else if (!led1On && (currentMillis - led1PreviousMillis >= led1OffTime)) {
-
-            led1On = true;
-            led1PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTN, LED1, LED1);
-
-        }
-
-        if (led3On && (currentMillis - led3PreviousMillis >= led3OnTime)) {
-
-            led3On = false;
-            led3PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTF, LED3, 0x0);
-
-        }
-
-        else if (!led3On && (currentMillis - led3PreviousMillis >= led3OffTime)) {
-
-            led3On = true;
-            led3PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTF, LED3, LED3);
-
-        }
-
-        if (led2On && (pulse == 1) && (currentMillis - led2PreviousMillis >= led2OnTime)) {
-
-            led2On = false;
-            led2PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTN, LED2, 0x0);
-
-        }
-
-        else if (led2On && (pulse == 2) && (currentMillis - led2PreviousMillis >= led2OnTime)) {
-
-            led2On = false;
-            pulse = 0;
-            led2PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTN, LED2, 0x0);
-
-        }
-
-        else if (!led2On && (pulse == 0) && (currentMillis - led2PreviousMillis >= led2LongOff)) {
-
-            led2On = true;
-            pulse = 1;
-            led2PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTN, LED2, LED2);
-
-        }
-
-        else if (!led2On && (pulse == 1) && (currentMillis - led2PreviousMillis >= led2ShortOff)) {
-
-            led2On = true;
-            pulse = 2;
-            led2PreviousMillis = currentMillis;
-            GPIOPinWrite(PORTN, LED2, LED2);
-
-        }
+        SchedulerPoll();
 
     }
 
@@ -0,0 +1,619 @@
+//************************************************************************************
+//
+// Title:               DDS Shadow Registers
+// Author:              Jacob Putz
+// Filename:            DDSShadow.c
+//
+// Description:     Register shadows and the flush coalescer for the AD9834 and
+//                      AD9952.  Portable; frames go out through SSIStream.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       DDSShadowAD9834Retune() returns the register it loaded.
+//
+// 0.1.1    -       Add DDSShadowAD9834RequireB28() for callers that stream B28
+//                  frames.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "SSIStream.h"
+
+// Defines
+#define     DDSSHADOW_MODE_MASK     (AD9834_CTRL_B28 | AD9834_CTRL_HLB)
+#define     DDSSHADOW_SEL_MASK      (AD9834_CTRL_FSEL | AD9834_CTRL_PSEL)
+#define     DDSSHADOW_MODE_LSB      0
+#define     DDSSHADOW_MODE_MSB      AD9834_CTRL_HLB
+#define     DDSSHADOW_MODE_B28      AD9834_CTRL_B28
+#define     DDSSHADOW_MODE_NONE     0xFFFF      // Phase writes work in any mode
+#define     DDSSHADOW_MODE_UNKNOWN  0xFFFE
+
+// Type Definitions
+//
+// One planned register write.
+//
+typedef struct {
+
+    uint16_t mode;                  // Mode it needs, or DDSSHADOW_MODE_NONE
+    uint16_t count;
+    uint16_t frames[2];
+    uint32_t reg;                   // DDSSHADOW_AD9834_*
+    uint32_t pass;                  // 1 if it must wait for the select switch
+    bool sent;
+
+} tDDSShadowWrite;
+
+// Global Variables
+tAD9834Shadow g_ad9834Shadow;
+tAD9952Shadow g_ad9952Shadow;
+
+//************************************************************************************
+//
+// Start with nothing known about the part, so the first flush writes every
+// register that has been set.  Registers never set are never written.
+//
+//************************************************************************************
+void DDSShadowAD9834Init(tAD9834Shadow *shadow) {
+
+    uint32_t i;
+
+    shadow->ctrl = 0;
+    shadow->set = 0;
+    shadow->devCtrl = 0;
+    shadow->pins = 0;
+    shadow->known = 0;
+    shadow->pinSwitch = false;
+    shadow->requireB28 = false;
+    shadow->naiveFrames = 0;
+    shadow->sentFrames = 0;
+
+    for (i = 0; i < 2; i++) {
+
+        shadow->freq[i] = 0;
+        shadow->phase[i] = 0;
+        shadow->devFreq[i] = 0;
+        shadow->devPhase[i] = 0;
+
+    }
+
+}
+
+void DDSShadowAD9834SetCtrl(tAD9834Shadow *shadow, uint16_t bits, uint16_t mask) {
+
+    mask &= (uint16_t)~DDSSHADOW_MODE_MASK;
+    shadow->ctrl = (uint16_t)((shadow->ctrl & ~mask) | (bits & mask));
+    shadow->naiveFrames++;
+
+}
+
+void DDSShadowAD9834SetFreq(tAD9834Shadow *shadow, uint32_t index, uint32_t word) {
+
+    shadow->freq[index & 1] = word & ((1UL << AD9834_FREQ_BITS) - 1);
+    shadow->set |= DDSSHADOW_AD9834_FREQ0 << (index & 1);
+    shadow->naiveFrames += AD9834_FREQ_FRAMES;
+
+}
+
+void DDSShadowAD9834SetPhase(tAD9834Shadow *shadow, uint32_t index, uint32_t word) {
+
+    shadow->phase[index & 1] = (uint16_t)(word & AD9834_PHASE_MASK);
+    shadow->set |= DDSSHADOW_AD9834_PHASE0 << (index & 1);
+    shadow->naiveFrames++;
+
+}
+
+//************************************************************************************
+//
+// FSEL/PSEL as the part currently sees them.
+//
+//************************************************************************************
+static uint16_t DDSShadowAD9834Selected(const tAD9834Shadow *shadow) {
+
+    if ((shadow->ctrl & AD9834_CTRL_PIN_SW) != 0) {
+
+        return shadow->pins;
+
+    }
+
+    return shadow->devCtrl & DDSSHADOW_SEL_MASK;
+
+}
+
+//************************************************************************************
+//
+// Glitch-free retune: load the frequency register that is not on the output and
+// select it.  Calling this again before a flush overwrites the same idle register.
+// Returns the index of the register loaded.
+//
+//************************************************************************************
+uint32_t DDSShadowAD9834Retune(tAD9834Shadow *shadow, uint32_t word) {
+
+    uint32_t idle = ((DDSShadowAD9834Selected(shadow) & AD9834_CTRL_FSEL) != 0) ? 0 : 1;
+
+    DDSShadowAD9834SetFreq(shadow, idle, word);
+    DDSShadowAD9834SetCtrl(shadow, (idle != 0) ? AD9834_CTRL_FSEL : 0, AD9834_CTRL_FSEL);
+
+    return idle;
+
+}
+
+void DDSShadowAD9834Rephase(tAD9834Shadow *shadow, uint32_t word) {
+
+    uint32_t idle = ((DDSShadowAD9834Selected(shadow) & AD9834_CTRL_PSEL) != 0) ? 0 : 1;
+
+    DDSShadowAD9834SetPhase(shadow, idle, word);
+    DDSShadowAD9834SetCtrl(shadow, (idle != 0) ? AD9834_CTRL_PSEL : 0, AD9834_CTRL_PSEL);
+
+}
+
+void DDSShadowAD9834RequireB28(tAD9834Shadow *shadow) {
+
+    shadow->requireB28 = true;
+
+}
+
+//************************************************************************************
+//
+// A register has to wait for the select switch if it is on the output now and
+// will not be afterwards; writing it earlier would change the output before the
+// switch.
+//
+//************************************************************************************
+static uint32_t DDSShadowAD9834Pass(uint16_t selBefore, uint16_t selAfter,
+                                    uint16_t selBit, uint32_t index) {
+
+    bool before = ((selBefore & selBit) != 0) == (index != 0);
+    bool after = ((selAfter & selBit) != 0) == (index != 0);
+
+    return (before && !after) ? 1 : 0;
+
+}
+
+//************************************************************************************
+//
+// List the register writes needed to bring the part to the requested state.
+//
+//************************************************************************************
+static uint32_t DDSShadowAD9834Plan(const tAD9834Shadow *shadow, tDDSShadowWrite *writes,
+                                    uint16_t selBefore, uint16_t selAfter) {
+
+    static const uint16_t freqRegs[2] = { AD9834_REG_FREQ0, AD9834_REG_FREQ1 };
+    static const uint16_t phaseRegs[2] = { AD9834_REG_PHASE0, AD9834_REG_PHASE1 };
+    tDDSShadowWrite *write = writes;
+    uint32_t i;
+
+    for (i = 0; i < 2; i++) {
+
+        uint32_t bit = DDSSHADOW_AD9834_FREQ0 << i;
+        uint32_t diff = shadow->freq[i] ^ shadow->devFreq[i];
+        bool lsb = ((shadow->known & bit) == 0) || ((diff & AD9834_FREQ_HALF_MASK) != 0);
+        bool msb = ((shadow->known & bit) == 0) ||
+                   (((diff >> 14) & AD9834_FREQ_HALF_MASK) != 0);
+
+        if (((shadow->set & bit) == 0) || (!lsb && !msb)) {
+
+            continue;
+
+        }
+
+        write->reg = bit;
+        write->pass = DDSShadowAD9834Pass(selBefore, selAfter, AD9834_CTRL_FSEL, i);
+        write->sent = false;
+        write->count = 0;
+
+        if (lsb) {
+
+            write->frames[write->count++] = AD9834FrameFreqLSB(freqRegs[i],
+                                                               shadow->freq[i]);
+
+        }
+
+        if (msb) {
+
+            write->frames[write->count++] = AD9834FrameFreqMSB(freqRegs[i],
+                                                               shadow->freq[i]);
+
+        }
+
+        write->mode = (lsb && msb) ? DDSSHADOW_MODE_B28 :
+                      lsb ? DDSSHADOW_MODE_LSB : DDSSHADOW_MODE_MSB;
+        write++;
+
+    }
+
+    for (i = 0; i < 2; i++) {
+
+        uint32_t bit = DDSSHADOW_AD9834_PHASE0 << i;
+
+        if (((shadow->set & bit) == 0) || (((shadow->known & bit) != 0) &&
+                                           (shadow->phase[i] == shadow->devPhase[i]))) {
+
+            continue;
+
+        }
+
+        write->reg = bit;
+        write->pass = DDSShadowAD9834Pass(selBefore, selAfter, AD9834_CTRL_PSEL, i);
+        write->sent = false;
+        write->count = 1;
+        write->frames[0] = AD9834FramePhase(phaseRegs[i], shadow->phase[i]);
+        write->mode = DDSSHADOW_MODE_NONE;
+        write++;
+
+    }
+
+    return (uint32_t)(write - writes);
+
+}
+
+static void DDSShadowAD9834Sent(tAD9834Shadow *shadow, uint32_t reg) {
+
+    switch (reg) {
+
+        case DDSSHADOW_AD9834_FREQ0:    shadow->devFreq[0] = shadow->freq[0];   break;
+        case DDSSHADOW_AD9834_FREQ1:    shadow->devFreq[1] = shadow->freq[1];   break;
+        case DDSSHADOW_AD9834_PHASE0:   shadow->devPhase[0] = shadow->phase[0]; break;
+        default:                        shadow->devPhase[1] = shadow->phase[1]; break;
+
+    }
+
+    shadow->known |= reg;
+
+}
+
+//************************************************************************************
+//
+// Coalesce everything set since the last flush into frames[] (at least
+// DDSSHADOW_AD9834_FRAMES_MAX elements) and update the device copy to match.
+// Returns the number of frames, 0 if the part is already in the requested state.
+//
+// Writes are sent in two passes around the FSEL/PSEL switch.  Within a pass the
+// order is chosen so that a control frame which has to be sent anyway also sets
+// the mode for the first frequency write, writes that work in any mode go where
+// no control frame is needed, and each mode is entered once.
+//
+//************************************************************************************
+uint32_t DDSShadowAD9834Flush(tAD9834Shadow *shadow, uint16_t *frames) {
+
+    tDDSShadowWrite writes[4];
+    uint16_t order[5];
+    bool pins = (shadow->ctrl & AD9834_CTRL_PIN_SW) != 0;
+    bool ctrlKnown = (shadow->known & DDSSHADOW_AD9834_CTRL) != 0;
+    uint16_t base = shadow->ctrl & (uint16_t)~(DDSSHADOW_MODE_MASK | DDSSHADOW_SEL_MASK);
+    uint16_t selAfter = shadow->ctrl & DDSSHADOW_SEL_MASK;
+    uint16_t selBefore, sel, mode;
+    bool ctrlDue;
+    bool ctrlSent = false;
+    uint32_t writeCount, groups, count, pass, g, i;
+
+    if (shadow->pinSwitch) {
+
+        return 0;
+
+    }
+
+    //
+    // With the control word unknown the output register is unknown too, so there
+    // is nothing to order around; the first control frame selects directly.
+    //
+    selBefore = pins ? shadow->pins : ctrlKnown ? (shadow->devCtrl & DDSSHADOW_SEL_MASK) :
+                                                  selAfter;
+    sel = pins ? selAfter : selBefore;
+    mode = ctrlKnown ? (shadow->devCtrl & DDSSHADOW_MODE_MASK) : DDSSHADOW_MODE_UNKNOWN;
+    ctrlDue = !ctrlKnown ||
+              ((shadow->devCtrl & ~(DDSSHADOW_MODE_MASK | DDSSHADOW_SEL_MASK)) != base);
+
+    writeCount = DDSShadowAD9834Plan(shadow, writes, selBefore, selAfter);
+    count = 0;
+
+    for (pass = 0; pass < 2; pass++) {
+
+        if ((pass == 1) && (selBefore != selAfter)) {
+
+            if (pins) {
+
+                shadow->pinSwitch = true;
+                break;
+
+            }
+
+            sel = selAfter;
+            ctrlDue = true;
+
+        }
+
+        //
+        // Group order for this pass.  The current mode comes first among the
+        // frequency groups; phase writes lead unless a control frame is due.
+        //
+        g = 0;
+
+        if (!ctrlDue) {
+
+            order[g++] = DDSSHADOW_MODE_NONE;
+
+        }
+
+        if (mode != DDSSHADOW_MODE_UNKNOWN) {
+
+            order[g++] = mode;
+
+        }
+
+        if (mode != DDSSHADOW_MODE_B28) {
+
+            order[g++] = DDSSHADOW_MODE_B28;
+
+        }
+
+        if (mode != DDSSHADOW_MODE_LSB) {
+
+            order[g++] = DDSSHADOW_MODE_LSB;
+
+        }
+
+        if (mode != DDSSHADOW_MODE_MSB) {
+
+            order[g++] = DDSSHADOW_MODE_MSB;
+
+        }
+
+        if (ctrlDue) {
+
+            order[g++] = DDSSHADOW_MODE_NONE;
+
+        }
+
+        groups = g;
+
+        for (g = 0; g < groups; g++) {
+
+            for (i = 0; i < writeCount; i++) {
+
+                tDDSShadowWrite *write = &writes[i];
+
+                if (write->sent || (write->pass != pass) || (write->mode != order[g])) {
+
+                    continue;
+
+                }
+
+                if (ctrlDue ||
+                    ((write->mode != DDSSHADOW_MODE_NONE) && (write->mode != mode))) {
+
+                    if (write->mode != DDSSHADOW_MODE_NONE) {
+
+                        mode = write->mode;
+
+                    }
+
+                    else if (mode == DDSSHADOW_MODE_UNKNOWN) {
+
+                        mode = DDSSHADOW_MODE_B28;
+
+                    }
+
+                    frames[count++] = AD9834FrameCtrl(base | sel | mode);
+                    ctrlDue = false;
+                    ctrlSent = true;
+
+                }
+
+                frames[count++] = write->frames[0];
+
+                if (write->count > 1) {
+
+                    frames[count++] = write->frames[1];
+
+                }
+
+                write->sent = true;
+                DDSShadowAD9834Sent(shadow, write->reg);
+
+            }
+
+        }
+
+    }
+
+    if (shadow->requireB28 && !shadow->pinSwitch) {
+
+        ctrlDue = ctrlDue || (mode != DDSSHADOW_MODE_B28);
+        mode = DDSSHADOW_MODE_B28;
+        shadow->requireB28 = false;
+
+    }
+
+    if (ctrlDue) {
+
+        if (mode == DDSSHADOW_MODE_UNKNOWN) {
+
+            mode = DDSSHADOW_MODE_B28;
+
+        }
+
+        frames[count++] = AD9834FrameCtrl(base | sel | mode);
+        ctrlSent = true;
+
+    }
+
+    if (ctrlSent) {
+
+        shadow->devCtrl = base | sel | mode;
+        shadow->known |= DDSSHADOW_AD9834_CTRL;
+
+    }
+
+    shadow->sentFrames += count;
+
+    return count;
+
+}
+
+//************************************************************************************
+//
+// Flush straight into an SSI stream.  If the stream cannot take the frames the
+// shadow is left as it was, so the next call retries the same changes.
+//
+//************************************************************************************
+bool DDSShadowAD9834Queue(tAD9834Shadow *shadow, tSSIStream *stream) {
+
+    uint16_t frames[DDSSHADOW_AD9834_FRAMES_MAX];
+    tAD9834Shadow saved = *shadow;
+    uint32_t count = DDSShadowAD9834Flush(shadow, frames);
+
+    if ((count != 0) && !SSIStreamQueue(stream, frames, count)) {
+
+        *shadow = saved;
+        return false;
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// The caller has driven FSELECT/PSELECT to the requested selection after a flush
+// stopped with pinSwitch set.
+//
+//************************************************************************************
+void DDSShadowAD9834PinsSwitched(tAD9834Shadow *shadow) {
+
+    shadow->pins = shadow->ctrl & DDSSHADOW_SEL_MASK;
+    shadow->pinSwitch = false;
+
+}
+
+//************************************************************************************
+//
+// Something other than the shadow has written these registers (a sweep, a preset's
+// setup frames), so the next flush must not assume their contents.
+//
+//************************************************************************************
+void DDSShadowAD9834Forget(tAD9834Shadow *shadow, uint32_t regs) {
+
+    shadow->known &= ~regs;
+
+}
+
+void DDSShadowAD9952Init(tAD9952Shadow *shadow) {
+
+    uint32_t i;
+
+    for (i = 0; i < DDSSHADOW_AD9952_REGS; i++) {
+
+        shadow->reg[i] = 0;
+        shadow->devReg[i] = 0;
+
+    }
+
+    shadow->set = 0;
+    shadow->known = 0;
+    shadow->naiveFrames = 0;
+    shadow->sentFrames = 0;
+
+}
+
+void DDSShadowAD9952Set(tAD9952Shadow *shadow, uint8_t reg, uint32_t value) {
+
+    uint32_t bytes = AD9952RegBytes(reg);
+
+    if (bytes == 0) {
+
+        return;
+
+    }
+
+    shadow->reg[reg] = (bytes == 4) ? value : (value & ((1UL << (8 * bytes)) - 1));
+    shadow->set |= DDSSHADOW_AD9952_REG(reg);
+    shadow->naiveFrames += bytes + 1;
+
+}
+
+//************************************************************************************
+//
+// Write every register that has been set and differs from the part (or is not
+// known), in address order.  frames[] must hold DDSSHADOW_AD9952_FRAMES_MAX elements.
+//
+//************************************************************************************
+uint32_t DDSShadowAD9952Flush(tAD9952Shadow *shadow, uint16_t *frames) {
+
+    uint32_t count = 0;
+    uint8_t reg;
+
+    for (reg = 0; reg < DDSSHADOW_AD9952_REGS; reg++) {
+
+        if (((shadow->set & DDSSHADOW_AD9952_REG(reg)) == 0) ||
+            (((shadow->known & DDSSHADOW_AD9952_REG(reg)) != 0) &&
+             (shadow->reg[reg] == shadow->devReg[reg]))) {
+
+            continue;
+
+        }
+
+        count += AD9952PackWrite(&frames[count], reg, shadow->reg[reg]);
+        shadow->devReg[reg] = shadow->reg[reg];
+        shadow->known |= DDSSHADOW_AD9952_REG(reg);
+
+    }
+
+    shadow->sentFrames += count;
+
+    return count;
+
+}
+
+bool DDSShadowAD9952Queue(tAD9952Shadow *shadow, tSSIStream *stream) {
+
+    uint16_t frames[DDSSHADOW_AD9952_FRAMES_MAX];
+    tAD9952Shadow saved = *shadow;
+    uint32_t count = DDSShadowAD9952Flush(shadow, frames);
+
+    if ((count != 0) && !SSIStreamQueue(stream, frames, count)) {
+
+        *shadow = saved;
+        return false;
+
+    }
+
+    return true;
+
+}
+
+void DDSShadowAD9952Forget(tAD9952Shadow *shadow, uint32_t regs) {
+
+    shadow->known &= ~regs;
+
+}
@@ -0,0 +1,186 @@
+//************************************************************************************
+//
+// Title:               DDS Shadow Registers
+// Author:              Jacob Putz
+// Filename:            DDSShadow.h
+//
+// Description:     Shadow copies of the AD9834 and AD9952 register files.  Callers
+//                      set registers freely; a flush compares the requested state with
+//                      what the part already holds and emits the fewest SSI frames that
+//                      get it there.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Note who raises the AD9952 IO_UPDATE.
+//
+// 0.1.3    -       Notes pointer to the shadow tool.
+//
+// 0.1.2    -       DDSShadowAD9834Retune() returns the register it loaded.
+//
+// 0.1.1    -       Add DDSShadowAD9834RequireB28() for callers that stream B28
+//                  frames.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef DDSSHADOW_H_
+#define DDSSHADOW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "SSIStream.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Each shadow keeps two copies of the register file: the requested state and the
+//  state the part was last sent.  Nothing goes on the bus until a flush.
+//
+//  AD9834 frequency writes pick their own mode per register:
+//
+//      both 14-bit halves changed      B28 set, LSB then MSB (atomic)
+//      only the LSBs changed           B28 clear, HLB clear, one frame
+//      only the MSBs changed           B28 clear, HLB set, one frame
+//
+//  A control frame is only sent when the mode or the caller's control bits have
+//  to change, and writes are grouped by mode so each mode is entered at most once
+//  per flush.  B28 and HLB belong to the shadow; callers' values are ignored.
+//
+//  DDSShadowAD9834Retune()/Rephase() are the glitch-free path: the new value goes
+//  into the register that is not driving the output, and FSEL/PSEL then switch
+//  to it; Retune() returns the index of that register.  A flush orders writes
+//  around that switch so the register on the output never changes while it is
+//  selected.  With PIN_SW set the switch is made on the FSELECT/PSELECT pins
+//  instead; the flush then stops at the switch and reports it through pinSwitch,
+//  the caller drives the pins and calls DDSShadowAD9834PinsSwitched(), and the
+//  next flush sends the rest.
+//
+//  DDSShadowAD9834RequireB28() makes the next flush finish in B28 mode, for sweep
+//  step records that write both halves of FREQ0 without a control frame.
+//
+//  The AD9952 latches its I/O buffer on IO_UPDATE, so every register sent in one
+//  flush takes effect together and ordering does not matter; its shadow only
+//  drops writes that would not change anything.  The shadow does not raise
+//  IO_UPDATE: devReg[] describes the I/O buffer, and the caller pulses the line
+//  once the frames have left the SSI (Remote.c uses SweepPortIOUpdate()).
+//
+//  naiveFrames counts what the individual calls would have cost written straight
+//  to the stream, and sentFrames what the flushes actually sent.
+//
+//  Host/Tools/ShadowTool.c decodes flushes as the parts would and checks the
+//  state, the output and these counts over seeded workloads.
+//
+//************************************************************************************
+
+// Defines
+//
+// Register bits for known/Forget()
+#define     DDSSHADOW_AD9834_CTRL       0x01
+#define     DDSSHADOW_AD9834_FREQ0      0x02
+#define     DDSSHADOW_AD9834_FREQ1      0x04
+#define     DDSSHADOW_AD9834_PHASE0     0x08
+#define     DDSSHADOW_AD9834_PHASE1     0x10
+#define     DDSSHADOW_AD9834_ALL        0x1F
+
+#define     DDSSHADOW_AD9952_REGS       6               // CFR1 .. POW0
+#define     DDSSHADOW_AD9952_REG(reg)   (1UL << (reg))
+#define     DDSSHADOW_AD9952_ALL        0x3F
+
+// Worst-case flush sizes in 16-bit elements
+#define     DDSSHADOW_AD9834_FRAMES_MAX 12
+#define     DDSSHADOW_AD9952_FRAMES_MAX 22
+
+// Type Definitions
+typedef struct {
+
+    //
+    // Requested state
+    //
+    uint16_t ctrl;                  // Control bits; B28/HLB are ignored
+    uint32_t freq[2];
+    uint16_t phase[2];
+    uint32_t set;                   // DDSSHADOW_AD9834_* ever set; others are left alone
+
+    //
+    // Device state
+    //
+    uint16_t devCtrl;               // Last control word sent
+    uint32_t devFreq[2];
+    uint16_t devPhase[2];
+    uint16_t pins;                  // FSEL/PSEL equivalent of the select pins
+    uint32_t known;                 // DDSSHADOW_AD9834_* the device copy is valid for
+    bool pinSwitch;                 // Flush stopped for a select pin switch
+    bool requireB28;                // Leave B28 set after the next flush
+
+    //
+    // Statistics
+    //
+    uint32_t naiveFrames;
+    uint32_t sentFrames;
+
+} tAD9834Shadow;
+
+typedef struct {
+
+    uint32_t reg[DDSSHADOW_AD9952_REGS];
+    uint32_t set;                   // DDSSHADOW_AD9952_REG() bits ever set
+    uint32_t devReg[DDSSHADOW_AD9952_REGS];
+    uint32_t known;                 // DDSSHADOW_AD9952_REG() bits
+
+    uint32_t naiveFrames;
+    uint32_t sentFrames;
+
+} tAD9952Shadow;
+
+// Global Variables
+//
+// One shadow per part, matching g_ssiStreams[].
+//
+extern tAD9834Shadow g_ad9834Shadow;
+extern tAD9952Shadow g_ad9952Shadow;
+
+// Function Prototypes
+extern void DDSShadowAD9834Init(tAD9834Shadow *shadow);
+extern void DDSShadowAD9834SetCtrl(tAD9834Shadow *shadow, uint16_t bits, uint16_t mask);
+extern void DDSShadowAD9834SetFreq(tAD9834Shadow *shadow, uint32_t index, uint32_t word);
+extern void DDSShadowAD9834SetPhase(tAD9834Shadow *shadow, uint32_t index,
+                                    uint32_t word);
+extern uint32_t DDSShadowAD9834Retune(tAD9834Shadow *shadow, uint32_t word);
+extern void DDSShadowAD9834Rephase(tAD9834Shadow *shadow, uint32_t word);
+extern void DDSShadowAD9834RequireB28(tAD9834Shadow *shadow);
+extern uint32_t DDSShadowAD9834Flush(tAD9834Shadow *shadow, uint16_t *frames);
+extern bool DDSShadowAD9834Queue(tAD9834Shadow *shadow, tSSIStream *stream);
+extern void DDSShadowAD9834PinsSwitched(tAD9834Shadow *shadow);
+extern void DDSShadowAD9834Forget(tAD9834Shadow *shadow, uint32_t regs);
+
+extern void DDSShadowAD9952Init(tAD9952Shadow *shadow);
+extern void DDSShadowAD9952Set(tAD9952Shadow *shadow, uint8_t reg, uint32_t value);
+extern uint32_t DDSShadowAD9952Flush(tAD9952Shadow *shadow, uint16_t *frames);
+extern bool DDSShadowAD9952Queue(tAD9952Shadow *shadow, tSSIStream *stream);
+extern void DDSShadowAD9952Forget(tAD9952Shadow *shadow, uint32_t regs);
+
+#endif /* DDSSHADOW_H_ */
@@ -0,0 +1,171 @@
+//************************************************************************************
+//
+// Title:               DDS Tuning Word Engine
+// Author:              Jacob Putz
+// Filename:            DDSTuning.c
+//
+// Description:     Runtime half of the fixed-point tuning word engine.  The
+//                      reciprocal is computed once per reference clock in
+//                      DDSTuningInit(); every later conversion is a multiply and a
+//                      shift.  The file has no TivaWare dependencies so it also
+//                      builds as a host library.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Round to the nearest word (DDSTuneWord()).
+//
+// 0.1.0    -       Initial fixed-point tuning word engine.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "DDSTuning.h"
+
+//************************************************************************************
+//
+// Set up a tuning context for refClkHz.  The 64-bit divide here is the only one in
+// the module and only runs when the reference clock changes.  Returns false when
+// the combination of clock and accumulator width cannot be represented with a
+// 32-bit reciprocal and a shift of at most 63.
+//
+//************************************************************************************
+bool DDSTuningInit(tDDSTuning *tuning, uint32_t refClkHz, uint32_t freqBits,
+                   uint32_t phaseBits) {
+
+    uint32_t log2Ceil = 0;
+    uint32_t shift;
+
+    if ((refClkHz == 0) || (freqBits == 0) || (freqBits > 32) ||
+        (phaseBits == 0) || (phaseBits > 16)) {
+
+        return false;
+
+    }
+
+    while ((log2Ceil < 32) && ((1ULL << log2Ceil) < refClkHz)) {
+
+        log2Ceil++;
+
+    }
+
+    shift = 31 + log2Ceil;
+
+    if ((shift + 32 - freqBits) > 63) {
+
+        return false;
+
+    }
+
+    tuning->refClkHz = refClkHz;
+    tuning->recip = (uint32_t)(((1ULL << shift) + (refClkHz / 2)) / refClkHz);
+    tuning->shift = shift + 32 - freqBits;
+    tuning->freqBits = freqBits;
+    tuning->freqMask = (freqBits == 32) ? 0xFFFFFFFFUL : ((1UL << freqBits) - 1);
+    tuning->phaseBits = phaseBits;
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Convert a Q32.32 frequency to a tuning word.  Frequencies at or above the
+// reference clock alias, exactly as they would in the accumulator.
+//
+//************************************************************************************
+uint32_t DDSTuningFreqWord(const tDDSTuning *tuning, uint64_t freqQ32) {
+
+    return DDSTuneWord(freqQ32, tuning->recip, tuning->shift,
+                       DDS_UNIT(tuning->refClkHz, tuning->freqBits)) & tuning->freqMask;
+
+}
+
+//************************************************************************************
+//
+// Exact inverse of DDSTuningFreqWord(): the Q32.32 frequency a given word produces.
+//
+//************************************************************************************
+uint64_t DDSTuningWordToFreq(const tDDSTuning *tuning, uint32_t word) {
+
+    return ((uint64_t)word * tuning->refClkHz) << (32 - tuning->freqBits);
+
+}
+
+//************************************************************************************
+//
+// Phase as a fraction of a full turn (0x10000 == 360 degrees), rounded to the
+// register width and wrapped.
+//
+//************************************************************************************
+uint32_t DDSTuningPhaseWord(const tDDSTuning *tuning, uint16_t phaseTurns) {
+
+    uint32_t drop = 16 - tuning->phaseBits;
+    uint32_t word = ((uint32_t)phaseTurns + ((1UL << drop) >> 1)) >> drop;
+
+    return word & ((1UL << tuning->phaseBits) - 1);
+
+}
+
+//************************************************************************************
+//
+// Phase in hundredths of a degree.  35999 << 16 still fits in 32 bits, so this stays
+// a 32-bit divide by a constant, which the compiler turns into a multiply.
+//
+//************************************************************************************
+uint32_t DDSTuningPhaseWordCentiDeg(const tDDSTuning *tuning, uint32_t centiDegrees) {
+
+    uint32_t word;
+
+    centiDegrees %= 36000;
+    word = ((centiDegrees << tuning->phaseBits) + 18000) / 36000;
+
+    return word & ((1UL << tuning->phaseBits) - 1);
+
+}
+
+//************************************************************************************
+//
+// Batch conversion for sweep and hop tables.  Kept as a tight loop over the inline
+// word computation so the compiler can keep recip, shift and unit in registers.
+//
+//************************************************************************************
+void DDSTuningFreqWords(const tDDSTuning *tuning, const uint64_t *freqQ32,
+                        uint32_t *words, uint32_t count) {
+
+    uint32_t recip = tuning->recip;
+    uint32_t shift = tuning->shift;
+    uint64_t unit = DDS_UNIT(tuning->refClkHz, tuning->freqBits);
+    uint32_t mask = tuning->freqMask;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+
+        words[i] = DDSTuneWord(freqQ32[i], recip, shift, unit) & mask;
+
+    }
+
+}
@@ -0,0 +1,220 @@
+//************************************************************************************
+//
+// Title:               DDS Tuning Word Engine
+// Author:              Jacob Putz
+// Filename:            DDSTuning.h
+//
+// Description:     Fixed-point frequency and phase tuning word computation for the
+//                      AD9834 (28-bit FREQ registers, 75 MHz MCLK) and the AD9952
+//                      (32-bit FTW, 400 MHz SYSCLK).  Only integer math is used so
+//                      the M4F never has to issue a divide on the update path.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Correct the reciprocal estimate to the nearest word.
+//
+// 0.1.0    -       Initial fixed-point tuning word engine.
+//
+//************************************************************************************
+
+#ifndef DDSTUNING_H_
+#define DDSTUNING_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  Frequencies are passed around as unsigned Q32.32 Hertz (upper 32 bits are whole
+//  Hertz, lower 32 bits are the fraction).  The tuning word for an N-bit phase
+//  accumulator clocked at fClk is
+//
+//      word = fOut * 2^N / fClk = fQ32 * 2^(N - 32) / fClk
+//
+//  The divide is replaced by a multiply with a 32-bit reciprocal
+//
+//      recip = round(2^shift' / fClk)          recip in [2^31, 2^32)
+//
+//  and a right shift, so the estimate is two 32x32->64 multiplies.  The
+//  reciprocal is only good to 2^-32 of itself, which near the top of a 32-bit word
+//  leaves the estimate up to 1.5 LSB out (1.22 LSB measured at 400 MHz).  It is
+//  then checked against the frequency it would produce, word * unit, where
+//
+//      unit = fClk * 2^(32 - N)                Q32.32 Hertz per word LSB
+//
+//  and moved by one LSB if that is more than half a unit from fQ32.  The result
+//  is the exact rational value rounded to the nearest word, halves up.
+//  Host/Tools/TuningTool.c checks this against 128-bit arithmetic and measures
+//  the rate.
+//
+//************************************************************************************
+
+// Defines
+//
+// Reference clocks
+#define     AD9834_MCLK_HZ          75000000UL      // 75 MHz MCLK
+#define     AD9952_SYSCLK_HZ        400000000UL     // 400 MHz SYSCLK
+
+// Accumulator and phase register widths
+#define     AD9834_FREQ_BITS        28
+#define     AD9834_PHASE_BITS       12
+#define     AD9952_FREQ_BITS        32
+#define     AD9952_PHASE_BITS       14
+
+// Q32.32 frequency helpers
+#define     DDS_HZ(hz)              ((uint64_t)(hz) << 32)
+#define     DDS_HZ_FRAC(hz, frac)   (((uint64_t)(hz) << 32) | (uint32_t)(frac))
+
+//
+// Compile-time reciprocal for a fixed reference clock.  DDS_RECIP_SHIFT() picks the
+// shift that places the reciprocal in [2^31, 2^32) for clocks up to 2^32 Hz;
+// DDS_RECIP() is the rounded reciprocal itself.  Both fold to constants when clk
+// is a literal, so DDSTuneFreqConst() compiles to straight multiply/shift code.
+//
+#define     DDS_CLK_LOG2_CEIL(clk)                                                  \
+                ((clk) <= (1UL << 24) ? 24 : (clk) <= (1UL << 25) ? 25 :            \
+                 (clk) <= (1UL << 26) ? 26 : (clk) <= (1UL << 27) ? 27 :            \
+                 (clk) <= (1UL << 28) ? 28 : (clk) <= (1UL << 29) ? 29 :            \
+                 (clk) <= (1UL << 30) ? 30 : (clk) <= (1UL << 31) ? 31 : 32)
+#define     DDS_RECIP_SHIFT(clk)    (31 + DDS_CLK_LOG2_CEIL(clk))
+#define     DDS_RECIP(clk)                                                          \
+                ((uint32_t)(((1ULL << DDS_RECIP_SHIFT(clk)) + ((clk) / 2)) / (clk)))
+
+//
+// Precomputed reciprocals and units for the two supported parts.
+//
+#define     DDS_UNIT(clk, bits)     ((uint64_t)(clk) << (32 - (bits)))
+
+#define     AD9834_RECIP            DDS_RECIP(AD9834_MCLK_HZ)
+#define     AD9834_RECIP_SHIFT      (DDS_RECIP_SHIFT(AD9834_MCLK_HZ) + 32 -          \
+                                     AD9834_FREQ_BITS)
+#define     AD9834_UNIT             DDS_UNIT(AD9834_MCLK_HZ, AD9834_FREQ_BITS)
+#define     AD9952_RECIP            DDS_RECIP(AD9952_SYSCLK_HZ)
+#define     AD9952_RECIP_SHIFT      (DDS_RECIP_SHIFT(AD9952_SYSCLK_HZ) + 32 -        \
+                                     AD9952_FREQ_BITS)
+#define     AD9952_UNIT             DDS_UNIT(AD9952_SYSCLK_HZ, AD9952_FREQ_BITS)
+
+// Type Definitions
+//
+// Runtime tuning context for a reference clock that is only known after start-up
+// (for example after calibration against the 25 MHz MOSC).
+//
+typedef struct {
+
+    uint32_t refClkHz;      // Reference clock in Hertz
+    uint32_t recip;         // round(2^(shift + N - 32) / refClkHz)
+    uint32_t shift;         // Total right shift applied to fQ32 * recip
+    uint32_t freqBits;      // Accumulator width N
+    uint32_t freqMask;      // (2^N) - 1
+    uint32_t phaseBits;     // Phase register width
+
+} tDDSTuning;
+
+//************************************************************************************
+//
+// Multiply an unsigned Q32.32 frequency by a 32-bit reciprocal and shift the 96-bit
+// product right by shift (shift must be in [32, 63]), rounding to nearest.  Built
+// from two 32x32->64 multiplies, which the M4 does in a single UMULL each.  The
+// estimate is not masked to the word width, so DDSTuneWord() can check it.
+//
+//************************************************************************************
+static inline uint64_t DDSTuneMulShift(uint64_t freqQ32, uint32_t recip,
+                                       uint32_t shift) {
+
+    uint64_t lo = (uint64_t)(uint32_t)freqQ32 * recip;
+    uint64_t hi = (uint64_t)(uint32_t)(freqQ32 >> 32) * recip;
+
+    //
+    // Fold the rounding constant into the low product.  Only the carry out of the
+    // bottom 32 bits survives the shift, so the low half of lo can be dropped.
+    //
+    lo += (1ULL << (shift - 1)) & 0xFFFFFFFFULL;
+    hi += (lo >> 32) + ((1ULL << (shift - 1)) >> 32);
+
+    return hi >> (shift - 32);
+
+}
+
+//************************************************************************************
+//
+// The nearest word: the estimate, moved by one LSB when the frequency it gives is
+// more than half a unit from freqQ32.  The residual is at most 1.5 units, so it
+// fits a signed 64-bit value and one step is enough.  Words are not masked.
+//
+//************************************************************************************
+static inline uint32_t DDSTuneWord(uint64_t freqQ32, uint32_t recip, uint32_t shift,
+                                   uint64_t unit) {
+
+    uint64_t word = DDSTuneMulShift(freqQ32, recip, shift);
+    int64_t residual = (int64_t)(freqQ32 - (word * unit));
+
+    if ((2 * residual) >= (int64_t)unit) {
+
+        word++;
+
+    }
+
+    else if ((2 * residual) < -(int64_t)unit) {
+
+        word--;
+
+    }
+
+    return (uint32_t)word;
+
+}
+
+//************************************************************************************
+//
+// Compile-time constant path.  With constant recip/shift/unit (AD9834_RECIP etc.)
+// this inlines to the estimate's two multiplies, two adds and a shift, and the
+// correction's multiply and compares.
+//
+//************************************************************************************
+#define     DDSTuneFreqConst(freqQ32, recip, shift, unit)                           \
+                DDSTuneWord((freqQ32), (recip), (shift), (unit))
+
+#define     AD9834FreqWord(freqQ32)                                                 \
+                (DDSTuneFreqConst((freqQ32), AD9834_RECIP, AD9834_RECIP_SHIFT,      \
+                                  AD9834_UNIT) &                                    \
+                 ((1UL << AD9834_FREQ_BITS) - 1))
+#define     AD9952FreqWord(freqQ32)                                                 \
+                DDSTuneFreqConst((freqQ32), AD9952_RECIP, AD9952_RECIP_SHIFT,       \
+                                 AD9952_UNIT)
+
+// Function Prototypes
+extern bool DDSTuningInit(tDDSTuning *tuning, uint32_t refClkHz, uint32_t freqBits,
+                          uint32_t phaseBits);
+extern uint32_t DDSTuningFreqWord(const tDDSTuning *tuning, uint64_t freqQ32);
+extern uint64_t DDSTuningWordToFreq(const tDDSTuning *tuning, uint32_t word);
+extern uint32_t DDSTuningPhaseWord(const tDDSTuning *tuning, uint16_t phaseTurns);
+extern uint32_t DDSTuningPhaseWordCentiDeg(const tDDSTuning *tuning,
+                                           uint32_t centiDegrees);
+extern void DDSTuningFreqWords(const tDDSTuning *tuning, const uint64_t *freqQ32,
+                               uint32_t *words, uint32_t count);
+
+#endif /* DDSTUNING_H_ */
@@ -0,0 +1,82 @@
+//************************************************************************************
+//
+// Title:               uDMA Control Table
+// Author:              Jacob Putz
+// Filename:            DMAControl.c
+//
+// Description:     Owns the 1024-byte aligned uDMA channel control table shared by
+//                      every module that streams data with the uDMA.  DMAControlInit()
+//                      may be called by each user; only the first call touches the
+//                      hardware.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Wait for the uDMA through HalPeriphReady().
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+#include "DMAControl.h"
+#include "Hal.h"
+
+// Global Variables
+//
+// The control table must be aligned to its own size.  All 32 channels have a
+// primary and alternate structure, so the full 1 KB is reserved.
+//
+#pragma DATA_ALIGN(g_dmaControlTable, 1024)
+uint8_t g_dmaControlTable[1024];
+
+static bool g_dmaReady = false;
+
+//************************************************************************************
+//
+// Enable the uDMA controller and point it at the control table.
+//
+//************************************************************************************
+void DMAControlInit(void) {
+
+    if (g_dmaReady) {
+
+        return;
+
+    }
+
+    HalPeriphReady(HAL_PERIPH_UDMA);
+
+    uDMAEnable();
+    uDMAControlBaseSet(g_dmaControlTable);
+
+    g_dmaReady = true;
+
+}
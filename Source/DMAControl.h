@@ -0,0 +1,46 @@
+//************************************************************************************
+//
+// Title:               uDMA Control Table
+// Author:              Jacob Putz
+// Filename:            DMAControl.h
+//
+// Description:     Owns the 1024-byte aligned uDMA channel control table shared by
+//                      every module that streams data with the uDMA.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef DMACONTROL_H_
+#define DMACONTROL_H_
+
+#include <stdint.h>
+
+// Function Prototypes
+extern void DMAControlInit(void);
+
+#endif /* DMACONTROL_H_ */
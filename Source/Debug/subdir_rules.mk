@@ -5,17 +5,269 @@
 SHELL = cmd.exe
 
 # Each subdirectory must supply rules for building sources it contributes
+Boot.obj: ../Boot.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Boot.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Calib.obj: ../Calib.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Calib.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+CalibTiva.obj: ../CalibTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="CalibTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Crc.obj: ../Crc.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Crc.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
 DDSExperiment.obj: ../DDSExperiment.c $(GEN_OPTS) | $(GEN_HDRS)
 	@echo 'Building file: $<'
 	@echo 'Invoking: ARM Compiler'
-	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="DDSExperiment.d" $(GEN_OPTS__FLAG) "$<"
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="DDSExperiment.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+DDSShadow.obj: ../DDSShadow.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="DDSShadow.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+DDSTuning.obj: ../DDSTuning.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="DDSTuning.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+DMAControl.obj: ../DMAControl.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="DMAControl.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Fault.obj: ../Fault.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Fault.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+FaultTiva.obj: ../FaultTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="FaultTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+FaultVectors.obj: ../FaultVectors.asm $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="FaultVectors.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+HalTiva.obj: ../HalTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="HalTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Hop.obj: ../Hop.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Hop.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Mem.obj: ../Mem.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Mem.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+MemTiva.obj: ../MemTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="MemTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Modulation.obj: ../Modulation.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Modulation.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+ModulationTiva.obj: ../ModulationTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="ModulationTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Power.obj: ../Power.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Power.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Preset.obj: ../Preset.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Preset.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+PresetTiva.obj: ../PresetTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="PresetTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Profile.obj: ../Profile.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Profile.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+ProfilePort.obj: ../ProfilePort.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="ProfilePort.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Record.obj: ../Record.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Record.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+RecordTiva.obj: ../RecordTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="RecordTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Remote.obj: ../Remote.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Remote.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+RemoteTiva.obj: ../RemoteTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="RemoteTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+SSIStream.obj: ../SSIStream.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SSIStream.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+SSIStreamTiva.obj: ../SSIStreamTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SSIStreamTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Scheduler.obj: ../Scheduler.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Scheduler.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+SchedulerPort.obj: ../SchedulerPort.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SchedulerPort.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+SoftDDS.obj: ../SoftDDS.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SoftDDS.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+SoftDDSTiva.obj: ../SoftDDSTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SoftDDSTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Sweep.obj: ../Sweep.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Sweep.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+SweepTiva.obj: ../SweepTiva.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="SweepTiva.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+Sync.obj: ../Sync.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="Sync.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+TimeBase.obj: ../TimeBase.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="TimeBase.d" $(GEN_OPTS__FLAG) "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+TimeBasePort.obj: ../TimeBasePort.c $(GEN_OPTS) | $(GEN_HDRS)
+	@echo 'Building file: $<'
+	@echo 'Invoking: ARM Compiler'
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="TimeBasePort.d" $(GEN_OPTS__FLAG) "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
 tm4c1294ncpdt_startup_ccs.obj: ../tm4c1294ncpdt_startup_ccs.c $(GEN_OPTS) | $(GEN_HDRS)
 	@echo 'Building file: $<'
 	@echo 'Invoking: ARM Compiler'
-	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="tm4c1294ncpdt_startup_ccs.d" $(GEN_OPTS__FLAG) "$<"
+	"D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/bin/armcl" -mv7M4 --code_state=16 --float_support=FPv4SPD16 -me --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/TivaWare_C_Series-2.1.4.178" --include_path="D:/Users/Jacob/workspace_v7/DDS_Experiment" --include_path="D:/TI/ccsv7/tools/compiler/ti-cgt-arm_16.9.2.LTS/include" --define=ccs="ccs" --define=PART_TM4C1294NCPDT --define=DDS_CHIP=3 --define=PROFILE_ENABLE -g --gcc --diag_warning=225 --diag_wrap=off --display_error_number --abi=eabi --preproc_with_compile --preproc_dependency="tm4c1294ncpdt_startup_ccs.d" $(GEN_OPTS__FLAG) "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -0,0 +1,542 @@
+//************************************************************************************
+//
+// Title:               Fault Snapshot and Warm Restart
+// Author:              Jacob Putz
+// Filename:            Fault.c
+//
+// Description:     Snapshot capture, sealing and the waveform restore run after a
+//                      restart.  Portable; FaultTiva.c takes the exception and
+//                      restarts the target.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Latch the restored AD9952 registers with IO_UPDATE.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "Fault.h"
+#include "Hal.h"
+#include "Modulation.h"
+#include "Preset.h"
+#include "Record.h"
+#include "Remote.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+//************************************************************************************
+//
+// Empty snapshot with a valid header.  Byte by byte, so nothing the fault may have
+// broken (the C library included) is needed.
+//
+//************************************************************************************
+static void FaultClear(tFaultSnapshot *snap) {
+
+    uint8_t *bytes = (uint8_t *)snap;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(tFaultSnapshot); i++) {
+
+        bytes[i] = 0;
+
+    }
+
+    snap->magic = FAULT_MAGIC;
+    snap->version = FAULT_VERSION;
+    snap->size = (uint16_t)sizeof(tFaultSnapshot);
+    snap->preset = FAULT_NO_PRESET;
+
+}
+
+void FaultSeal(tFaultSnapshot *snap) {
+
+    snap->crc = Crc32(CRC32_INIT, snap, offsetof(tFaultSnapshot, crc));
+
+}
+
+bool FaultValid(const tFaultSnapshot *snap) {
+
+    return (snap->magic == FAULT_MAGIC) && (snap->version == FAULT_VERSION) &&
+           (snap->size == sizeof(tFaultSnapshot)) &&
+           (snap->crc == Crc32(CRC32_INIT, snap, offsetof(tFaultSnapshot, crc)));
+
+}
+
+//************************************************************************************
+//
+// Registers and the stack above the frame, if the stack pointer can be read.
+//
+//************************************************************************************
+static void FaultCaptureFrame(tFaultSnapshot *snap, const tFaultContext *context) {
+
+    uintptr_t frame = (uintptr_t)context->frame;
+    uintptr_t above;
+    uint32_t frameWords = ((context->excReturn & FAULT_EXC_NO_FPU) != 0) ?
+                          FAULT_FRAME_WORDS : FAULT_FRAME_FPU_WORDS;
+    uint32_t i;
+
+    if (((frame & 3) != 0) || (frame < context->ramStart) ||
+        (frame > (context->ramEnd - (frameWords * sizeof(uint32_t))))) {
+
+        snap->flags |= FAULT_FLAG_BAD_SP;
+        return;
+
+    }
+
+    for (i = 0; i < FAULT_FRAME_WORDS; i++) {
+
+        snap->frame[i] = context->frame[i];
+
+    }
+
+    above = frame + (frameWords * sizeof(uint32_t)) +
+            (((snap->frame[FAULT_XPSR] & FAULT_XPSR_ALIGN) != 0) ? sizeof(uint32_t) : 0);
+    snap->sp = (uint32_t)above;
+
+    for (i = 0; (i < FAULT_STACK_WORDS) &&
+                ((above + ((i + 1) * sizeof(uint32_t))) <= context->ramEnd); i++) {
+
+        snap->stack[i] = ((const uint32_t *)above)[i];
+
+    }
+
+    snap->stackWords = i;
+
+}
+
+//************************************************************************************
+//
+// The shadows' requested state, the tuning contexts and the preset playing, if one
+// is.  A preset is recognised by its data being what the sweep engine or the
+// modulator is reading.
+//
+//************************************************************************************
+static void FaultCaptureWaveform(tFaultSnapshot *snap) {
+
+    const tPresetImage *image = g_presetImage;
+    const tPreset *preset;
+    const void *data;
+    uint32_t i;
+
+    snap->chips = DDS_CHIP;
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        snap->tuning[i] = g_remote.tuning[i];
+
+    }
+
+    snap->ad9834Ctrl = g_ad9834Shadow.ctrl;
+    snap->ad9834Pins = g_ad9834Shadow.pins;
+    snap->ad9834Set = g_ad9834Shadow.set;
+    snap->ad9834Known = g_ad9834Shadow.known;
+
+    for (i = 0; i < 2; i++) {
+
+        snap->ad9834Freq[i] = g_ad9834Shadow.freq[i];
+        snap->ad9834Phase[i] = g_ad9834Shadow.phase[i];
+
+    }
+
+    for (i = 0; i < DDSSHADOW_AD9952_REGS; i++) {
+
+        snap->ad9952Reg[i] = g_ad9952Shadow.reg[i];
+
+    }
+
+    snap->ad9952Set = g_ad9952Shadow.set;
+    snap->ad9952Known = g_ad9952Shadow.known;
+
+    if ((image == 0) || (!g_sweep.running && !g_modulator.running)) {
+
+        return;
+
+    }
+
+    for (i = 0; i < image->count; i++) {
+
+        preset = PresetAt(image, i);
+        data = PresetPayload(image, preset->dataOffset);
+
+        if ((preset->type == PRESET_TYPE_MOD) ?
+                (g_modulator.running && ((const void *)g_modulator.bits == data)) :
+                (g_sweep.running && ((const void *)g_sweep.xipRecords == data))) {
+
+            snap->preset = i;
+            snap->presetInstance = preset->instance;
+            snap->presetCrc = image->crc;
+            return;
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The newest whole entries of the command trace that fit.  The ring indices are
+// checked first, since a fault may have been caused by corrupting them.
+//
+//************************************************************************************
+static void FaultCaptureTrace(tFaultSnapshot *snap, const tRecord *record) {
+
+    uint32_t head = record->head;
+    uint32_t start = record->tail;
+    uint32_t words;
+
+    if ((record->ring == 0) || ((head - start) > RECORD_WORDS)) {
+
+        return;
+
+    }
+
+    while ((head - start) > FAULT_TRACE_WORDS) {
+
+        words = RECORD_ENTRY_WORDS(record->ring[start & RECORD_MASK]);
+
+        if (words > (head - start)) {
+
+            return;
+
+        }
+
+        start += words;
+
+    }
+
+    for (words = 0; start != head; start++, words++) {
+
+        snap->trace[words] = record->ring[start & RECORD_MASK];
+
+    }
+
+    snap->traceWords = words;
+
+}
+
+//************************************************************************************
+//
+// Called from the port's fault handler with interrupts masked.  The fault count
+// carries over from a snapshot that is still valid; if that one was still pending,
+// the fault came before its restore finished and the waveform is left out.
+//
+//************************************************************************************
+void FaultCapture(tFaultSnapshot *snap, const tFaultContext *context) {
+
+    bool valid = FaultValid(snap);
+    bool boot = valid && ((snap->flags & FAULT_FLAG_PENDING) != 0);
+    uint32_t faults = valid ? snap->faults : 0;
+    uint32_t restarts = valid ? snap->restarts : 0;
+
+    FaultClear(snap);
+
+    snap->faults = faults + 1;
+    snap->restarts = restarts;
+    snap->flags = FAULT_FLAG_PENDING |
+                  (((context->excReturn & FAULT_EXC_THREAD) != 0) ? FAULT_FLAG_THREAD : 0) |
+                  (((context->excReturn & FAULT_EXC_PSP) != 0) ? FAULT_FLAG_PSP : 0) |
+                  (((context->excReturn & FAULT_EXC_NO_FPU) == 0) ? FAULT_FLAG_FPU : 0) |
+                  (boot ? FAULT_FLAG_BOOT : 0);
+
+    snap->vector = context->vector;
+    snap->excReturn = context->excReturn;
+    snap->cfsr = context->cfsr;
+    snap->hfsr = context->hfsr;
+    snap->mmfar = context->mmfar;
+    snap->bfar = context->bfar;
+    snap->faultCycles = context->cycles;
+
+    FaultCaptureFrame(snap, context);
+    FaultCaptureTrace(snap, &g_record);
+
+    if (!boot) {
+
+        FaultCaptureWaveform(snap);
+
+    }
+
+    FaultSeal(snap);
+
+}
+
+//************************************************************************************
+//
+// Called right after HalClockInit().  Returns true if a snapshot is waiting to be
+// restored; one that fails its seal (power-up contents) is cleared.
+//
+//************************************************************************************
+bool FaultInit(tFaultSnapshot *snap) {
+
+    if (!FaultValid(snap)) {
+
+        FaultClear(snap);
+        FaultSeal(snap);
+
+        return false;
+
+    }
+
+    return (snap->flags & FAULT_FLAG_PENDING) != 0;
+
+}
+
+//************************************************************************************
+//
+// Time from the fault to now.
+//
+//************************************************************************************
+static void FaultStamp(tFaultSnapshot *snap) {
+
+    if (HalClockWarm()) {
+
+        snap->restartCycles = HalCycles32() - snap->faultCycles;
+        snap->flags &= ~FAULT_FLAG_RESET_TIME;
+
+    }
+
+    else {
+
+        snap->restartCycles = HalCycles32();
+        snap->flags |= FAULT_FLAG_RESET_TIME;
+
+    }
+
+    FaultSeal(snap);
+
+}
+
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+//************************************************************************************
+//
+// Put the AD9834 shadow back and re-send what it knew, with the select lines
+// driven first so the control word finds them where the output already is.
+//
+//************************************************************************************
+static void FaultRestoreAD9834(tFaultSnapshot *snap) {
+
+    tAD9834Shadow *shadow = &g_ad9834Shadow;
+    uint16_t sel = AD9834_CTRL_FSEL | AD9834_CTRL_PSEL;
+    uint32_t sent = shadow->sentFrames;
+    uint32_t i;
+
+    if ((snap->ad9834Known & DDSSHADOW_AD9834_CTRL) == 0) {
+
+        return;
+
+    }
+
+    shadow->ctrl = snap->ad9834Ctrl;
+    shadow->pins = snap->ad9834Pins & sel;
+    shadow->set = snap->ad9834Set & snap->ad9834Known;
+
+    if ((shadow->ctrl & AD9834_CTRL_PIN_SW) != 0) {
+
+        shadow->ctrl = (uint16_t)((shadow->ctrl & ~sel) | shadow->pins);
+
+    }
+
+    for (i = 0; i < 2; i++) {
+
+        shadow->freq[i] = snap->ad9834Freq[i];
+        shadow->phase[i] = snap->ad9834Phase[i];
+
+    }
+
+    HalGpioOutputInit(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT, 8);
+    HalGpioWrite(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT,
+                 (((shadow->pins & AD9834_CTRL_FSEL) != 0) ? MOD_FSELECT : 0) |
+                 (((shadow->pins & AD9834_CTRL_PSEL) != 0) ? MOD_PSELECT : 0));
+
+    DDSShadowAD9834Queue(shadow, &g_ssiStreams[SSISTREAM_AD9834]);
+    snap->restoreFrames += shadow->sentFrames - sent;
+
+}
+#endif
+
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+//************************************************************************************
+//
+// Put the AD9952 shadow back and re-send what it knew.  The registers sit in the
+// I/O buffer until FaultRestore() pulses IO_UPDATE.
+//
+//************************************************************************************
+static void FaultRestoreAD9952(tFaultSnapshot *snap) {
+
+    tAD9952Shadow *shadow = &g_ad9952Shadow;
+    uint32_t sent = shadow->sentFrames;
+    uint32_t i;
+
+    for (i = 0; i < DDSSHADOW_AD9952_REGS; i++) {
+
+        shadow->reg[i] = snap->ad9952Reg[i];
+
+    }
+
+    shadow->set = snap->ad9952Set & snap->ad9952Known;
+
+    DDSShadowAD9952Queue(shadow, &g_ssiStreams[SSISTREAM_AD9952]);
+    snap->restoreFrames += shadow->sentFrames - sent;
+
+}
+#endif
+
+//************************************************************************************
+//
+// Called once the remote link, SSI streams and shadows are initialised and before
+// anything else writes the parts.  Returns true if it ran.  The snapshot is kept,
+// marked FAULT_FLAG_RESTORED, for FAULT_READ.
+//
+//************************************************************************************
+bool FaultRestore(tFaultSnapshot *snap) {
+
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+    uint32_t sent = g_ad9952Shadow.sentFrames;
+#endif
+    uint32_t origin;
+    uint32_t i;
+
+    if ((snap->flags & FAULT_FLAG_PENDING) == 0) {
+
+        return false;
+
+    }
+
+    snap->restarts++;
+    snap->restoreFrames = 0;
+
+    //
+    // A snapshot from a build for other parts describes other wiring, and one
+    // taken during start-up has no waveform.
+    //
+    if ((snap->chips != DDS_CHIP) || ((snap->flags & FAULT_FLAG_BOOT) != 0)) {
+
+        snap->flags = (snap->flags & ~FAULT_FLAG_PENDING) | FAULT_FLAG_RESTORED;
+        FaultSeal(snap);
+
+        return true;
+
+    }
+
+    origin = RecordOrigin(&g_record, RECORD_ORIGIN_RESTORE);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i) && (snap->tuning[i].refClkHz != 0)) {
+
+            g_remote.tuning[i] = snap->tuning[i];
+
+        }
+
+    }
+
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+    if ((snap->preset == FAULT_NO_PRESET) || (snap->presetInstance != SSISTREAM_AD9834)) {
+
+        FaultRestoreAD9834(snap);
+
+    }
+#endif
+
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+    if ((snap->preset == FAULT_NO_PRESET) || (snap->presetInstance != SSISTREAM_AD9952)) {
+
+        FaultRestoreAD9952(snap);
+
+    }
+#endif
+
+    RecordOrigin(&g_record, origin);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        while (!SSIStreamIdle(&g_ssiStreams[i])) {
+
+            // Wait for the restore frames to go out.
+
+        }
+
+    }
+
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+    if (g_ad9952Shadow.sentFrames != sent) {
+
+        while (HalSsiBusy(HAL_SSI_3)) {
+
+            // The last frame is still shifting.
+
+        }
+
+        SweepPortIOUpdate();
+        g_remote.latchedFrames = g_ad9952Shadow.sentFrames;
+
+    }
+#endif
+
+    //
+    // Pending until here, so a fault during the restore is taken as a start-up one.
+    //
+    snap->flags = (snap->flags & ~FAULT_FLAG_PENDING) | FAULT_FLAG_RESTORED;
+    FaultStamp(snap);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Called after PresetInit(), in place of the boot preset, once FaultRestore() has
+// run.  Plays the preset that was playing at the fault if the same image is still
+// in flash.
+//
+//************************************************************************************
+void FaultResume(tFaultSnapshot *snap) {
+
+    const tPresetImage *image = g_presetImage;
+
+    if (((snap->flags & FAULT_FLAG_RESTORED) == 0) || (snap->preset == FAULT_NO_PRESET) ||
+        (snap->chips != DDS_CHIP) || (image == 0) || (image->crc != snap->presetCrc) ||
+        (snap->preset >= image->count)) {
+
+        return;
+
+    }
+
+    if (PresetPlay(image, PresetAt(image, snap->preset))) {
+
+        FaultStamp(snap);
+
+    }
+
+}
@@ -0,0 +1,260 @@
+//************************************************************************************
+//
+// Title:               Fault Snapshot and Warm Restart
+// Author:              Jacob Putz
+// Filename:            Fault.h
+//
+// Description:     Crash snapshots kept in SRAM that start-up does not initialise,
+//                      and the restore that puts the last waveform back on the DDS
+//                      parts after the firmware restarts.  Capture, validation,
+//                      decoding and restore are portable; the port layer supplies
+//                      the exception entry and decides how to restart.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       The restore is run by the boot sequencer.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef FAULT_H_
+#define FAULT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "SSIStream.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  The hard fault, MPU, bus and usage fault vectors and every unexpected interrupt
+//  enter the port's fault handler with the stacked exception frame.  FaultCapture()
+//  writes a tFaultSnapshot into the .noinit section (tm4c1294ncpdt.cmd), which the
+//  C start-up neither zeroes nor copies into, so it survives both a restart and a
+//  system reset.  It holds:
+//
+//      - the exception: vector, EXC_RETURN, the eight stacked registers, the fault
+//        status and address registers, and up to FAULT_STACK_WORDS of the stack
+//        above the frame
+//      - the waveform: the requested state of both DDS shadows, the tuning
+//        contexts (so a calibrated reference clock survives) and the preset that
+//        was playing, if any
+//      - the last FAULT_TRACE_WORDS of the command trace (Record.h), whole entries
+//        only, in the ring's own format
+//
+//  and is sealed with a Crc32() of everything before the crc field.  Only the
+//  frame and stack reads can fault again, so they are skipped, with
+//  FAULT_FLAG_BAD_SP, unless the stack pointer is inside RAM.
+//
+//  The port then restarts.  A fault taken from thread mode preempted nothing, so
+//  the handler quiesces the interrupt controller, the uDMA and the peripherals the
+//  firmware drives, and returns from the exception into the C start-up on a fresh
+//  stack (FAULT_FLAG_WARM).  The GPIO ports are not touched, so the DDS select,
+//  latch and chip-select lines hold their levels and the parts keep running the
+//  last waveform throughout; HalClockInit() finds the PLL already locked and skips
+//  the oscillator and PLL bring-up.  A fault inside a handler falls back to a
+//  system reset, with the same snapshot.
+//
+//  On the way back up, FaultInit() right after the clock checks the seal, and a
+//  snapshot still marked FAULT_FLAG_PENDING makes the start-up (Boot.h) call
+//  FaultRestore() once the SSI streams are up, before anything else touches the
+//  parts.  It loads the
+//  tuning contexts and shadows and re-sends every register the shadow knew the
+//  part to hold, with the FSELECT/PSELECT lines driven to the selection the shadow
+//  had, which on a warm restart is the selection they still hold.  The values are
+//  the ones the parts already have, so the output does not move.  A select pin
+//  switch that was waiting for its pins is dropped: the output stays on the bank
+//  it was on.  If a preset was playing, its part is left alone and FaultResume()
+//  plays it again from the start once the preset store is validated.  Registers
+//  a sweep, hop or preset had written behind the shadow's back are not known, so
+//  they are left as the part has them; an AD9834 whose control word is not known
+//  is left alone entirely, since its frequency writes depend on it.
+//
+//  restartCycles is the time from the fault to the waveform being back under
+//  firmware control: the last restore frame out, or the preset started.  After a
+//  warm restart the cycle counter has kept running and this covers the whole
+//  restart; after a system reset it only counts from HalClockInit()
+//  (FAULT_FLAG_RESET_TIME).
+//
+//  A fault while the previous snapshot is still pending happened during start-up or
+//  the restore itself.  The new snapshot is taken without the waveform
+//  (FAULT_FLAG_BOOT), so the next start leaves the parts alone instead of
+//  repeating whatever faulted.
+//
+//  What is not restored: the remote link's state, recording, calibration in
+//  progress (the corrected reference clock is kept) and the synchronized channel
+//  table, which the host re-adds.  A sweep, hop or modulation started over the
+//  remote link is not resumed (its tables were in RAM); the part holds the last
+//  step.
+//
+//  FAULT_READ on the remote link returns the raw snapshot, which is the same byte
+//  layout on the host, so Host/Tools/FaultTool.c decodes it.
+//
+//************************************************************************************
+
+// Defines
+#define     FAULT_MAGIC             0x46534444  // "DDSF"
+#define     FAULT_VERSION           1
+#define     FAULT_STACK_WORDS       16
+#define     FAULT_TRACE_WORDS       128
+#define     FAULT_NO_PRESET         0xFFFFFFFF
+
+// Snapshot flags
+#define     FAULT_FLAG_PENDING      0x0001      // Captured, restore not yet run
+#define     FAULT_FLAG_WARM         0x0002      // Restarted without a system reset
+#define     FAULT_FLAG_RESTORED     0x0004      // FaultRestore() has run
+#define     FAULT_FLAG_PSP          0x0008      // Frame was on the process stack
+#define     FAULT_FLAG_FPU          0x0010      // Extended frame with FPU state
+#define     FAULT_FLAG_THREAD       0x0020      // Fault was taken from thread mode
+#define     FAULT_FLAG_BAD_SP       0x0040      // Stack pointer outside RAM, no frame
+#define     FAULT_FLAG_RESET_TIME   0x0080      // restartCycles counts from the clock
+#define     FAULT_FLAG_BOOT         0x0100      // Fault before the last restore finished
+
+// Stacked frame words
+#define     FAULT_R0                0
+#define     FAULT_R1                1
+#define     FAULT_R2                2
+#define     FAULT_R3                3
+#define     FAULT_R12               4
+#define     FAULT_LR                5
+#define     FAULT_PC                6
+#define     FAULT_XPSR              7
+#define     FAULT_FRAME_WORDS       8
+#define     FAULT_FRAME_FPU_WORDS   26          // With S0-S15, FPSCR and a reserved word
+
+// EXC_RETURN bits
+#define     FAULT_EXC_THREAD        0x00000008
+#define     FAULT_EXC_PSP           0x00000004
+#define     FAULT_EXC_NO_FPU        0x00000010
+
+// Stacked xPSR bit set when the frame was padded to 8-byte alignment
+#define     FAULT_XPSR_ALIGN        0x00000200
+
+// Type Definitions
+//
+// What the port's exception entry hands to FaultCapture().
+//
+typedef struct {
+
+    const uint32_t *frame;          // Stacked exception frame
+    uint32_t excReturn;             // EXC_RETURN (LR on entry)
+    uint32_t vector;                // Active exception number
+    uint32_t cfsr;                  // Fault status and address registers
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uintptr_t ramStart;             // Where a stack pointer may point
+    uintptr_t ramEnd;
+    uint32_t cycles;                // HalCycles32() at the fault
+
+} tFaultContext;
+
+typedef struct {
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;                  // sizeof(tFaultSnapshot)
+    uint32_t faults;                // Since the snapshot was last invalid
+    uint32_t restarts;              // Restores run
+    uint32_t flags;                 // FAULT_FLAG_*
+
+    //
+    // Exception
+    //
+    uint32_t vector;
+    uint32_t excReturn;
+    uint32_t sp;                    // Stack pointer before the exception
+    uint32_t frame[FAULT_FRAME_WORDS];
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t stack[FAULT_STACK_WORDS];
+    uint32_t stackWords;
+    uint32_t faultCycles;
+
+    //
+    // Waveform
+    //
+    uint32_t chips;                 // DDS_CHIP of the build
+    tDDSTuning tuning[SSISTREAM_COUNT];
+    uint16_t ad9834Ctrl;
+    uint16_t ad9834Pins;
+    uint32_t ad9834Freq[2];
+    uint16_t ad9834Phase[2];
+    uint32_t ad9834Set;
+    uint32_t ad9834Known;
+    uint32_t ad9952Reg[DDSSHADOW_AD9952_REGS];
+    uint32_t ad9952Set;
+    uint32_t ad9952Known;
+    uint32_t preset;                // Index in the image, or FAULT_NO_PRESET
+    uint32_t presetInstance;
+    uint32_t presetCrc;             // The image's crc, to find the same one again
+
+    //
+    // Command trace
+    //
+    uint32_t traceWords;
+    uint16_t trace[FAULT_TRACE_WORDS];
+
+    //
+    // Restart
+    //
+    uint32_t restoreFrames;         // Register frames re-sent
+    uint32_t restartCycles;         // Fault to waveform restored
+
+    uint32_t crc;                   // Crc32() of everything above
+
+} tFaultSnapshot;
+
+// Global Variables
+//
+// In .noinit on the target.  Defined by the port.
+//
+extern tFaultSnapshot g_faultSnapshot;
+
+// Function Prototypes
+//
+// Portable core (Fault.c)
+//
+extern void FaultSeal(tFaultSnapshot *snap);
+extern bool FaultValid(const tFaultSnapshot *snap);
+extern void FaultCapture(tFaultSnapshot *snap, const tFaultContext *context);
+extern bool FaultInit(tFaultSnapshot *snap);
+extern bool FaultRestore(tFaultSnapshot *snap);
+extern void FaultResume(tFaultSnapshot *snap);
+
+//
+// Port layer (FaultTiva.c on target, Host/FaultHost.c on a host build).
+// FaultPortRestart() does not return; FaultEntry() is the target's exception entry.
+//
+extern void FaultPortRestart(tFaultSnapshot *snap);
+extern void FaultEntry(uint32_t *frame, uint32_t excReturn);
+
+#endif /* FAULT_H_ */
@@ -0,0 +1,198 @@
+//************************************************************************************
+//
+// Title:               Fault Snapshot and Warm Restart - TM4C1294 Port
+// Author:              Jacob Putz
+// Filename:            FaultTiva.c
+//
+// Description:     Fault entry for Fault.c on the target.  Reads the Cortex-M4
+//                      fault registers, keeps the snapshot in .noinit and restarts
+//                      through the C start-up, with a system reset as the fallback.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       FaultTivaReturn() moved to FaultVectors.asm.
+//
+// 0.1.1    -       Entered from the assembly stubs in FaultVectors.asm.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "Fault.h"
+#include "TimeBase.h"
+
+// Defines
+//
+// RAM a stack pointer may point into (SRAM and ARENA in tm4c1294ncpdt.cmd)
+#define     FAULT_RAM_START         0x20000000
+#define     FAULT_RAM_END           0x20040000
+
+// Peripherals reset before a warm restart.  Everything the firmware drives except
+// the GPIO ports, which hold the DDS lines.
+#define     FAULT_RESET_COUNT       10
+
+// Fresh thread-mode frame: Thumb state, nothing else set
+#define     FAULT_XPSR_THUMB        0x01000000
+
+// Global Constants
+static const uint32_t g_faultResetPeriphs[FAULT_RESET_COUNT] = {
+
+    SYSCTL_PERIPH_UDMA, SYSCTL_PERIPH_SSI0, SYSCTL_PERIPH_SSI3, SYSCTL_PERIPH_UART0,
+    SYSCTL_PERIPH_TIMER0, SYSCTL_PERIPH_TIMER1, SYSCTL_PERIPH_TIMER2,
+    SYSCTL_PERIPH_TIMER3, SYSCTL_PERIPH_TIMER4, SYSCTL_PERIPH_TIMER5
+
+};
+
+// Global Variables
+//
+// Neither zeroed nor initialised by the C start-up, so it outlives the restart.
+//
+#pragma DATA_SECTION(g_faultSnapshot, ".noinit")
+tFaultSnapshot g_faultSnapshot;
+
+//
+// Top of the main stack and the C start-up (tm4c1294ncpdt.cmd, the RTS library)
+//
+extern uint32_t __STACK_TOP;
+extern void _c_int00(void);
+
+//
+// Exception return into the thread-mode frame at frame (FaultVectors.asm)
+//
+extern void FaultTivaReturn(uint32_t *frame);
+
+//************************************************************************************
+//
+// Entered from FaultISR and IntDefaultHandler (FaultVectors.asm) with the stack
+// the frame was pushed to and the EXC_RETURN value.
+//
+//************************************************************************************
+void FaultEntry(uint32_t *frame, uint32_t excReturn) {
+
+    tFaultContext context;
+
+    IntMasterDisable();
+
+    context.frame = frame;
+    context.excReturn = excReturn;
+    context.vector = HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M;
+    context.cfsr = HWREG(NVIC_FAULT_STAT);
+    context.hfsr = HWREG(NVIC_HFAULT_STAT);
+    context.mmfar = HWREG(NVIC_MM_ADDR);
+    context.bfar = HWREG(NVIC_FAULT_ADDR);
+    context.ramStart = FAULT_RAM_START;
+    context.ramEnd = FAULT_RAM_END;
+    context.cycles = HWREG(DWT_CYCCNT);
+
+    FaultCapture(&g_faultSnapshot, &context);
+
+    //
+    // The status bits are sticky; clear them for the next decode
+    //
+    HWREG(NVIC_FAULT_STAT) = context.cfsr;
+    HWREG(NVIC_HFAULT_STAT) = context.hfsr;
+
+    FaultPortRestart(&g_faultSnapshot);
+
+}
+
+//************************************************************************************
+//
+// Leave the interrupt controller and peripherals as a reset would, apart from the
+// GPIO ports and the clock.
+//
+//************************************************************************************
+static void FaultTivaQuiesce(void) {
+
+    uint32_t i;
+
+    HWREG(NVIC_ST_CTRL) = 0;
+
+    for (i = 0; i < 4; i++) {
+
+        HWREG(NVIC_DIS0 + (4 * i)) = 0xFFFFFFFF;
+        HWREG(NVIC_UNPEND0 + (4 * i)) = 0xFFFFFFFF;
+
+    }
+
+    HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PENDSTCLR | NVIC_INT_CTRL_UNPEND_SV;
+
+    for (i = 0; i < FAULT_RESET_COUNT; i++) {
+
+        SysCtlPeripheralReset(g_faultResetPeriphs[i]);
+
+    }
+
+    //
+    // Start from the flash vector table; IntRegister() copies it to SRAM again.
+    // A lazily stacked FPU context belongs to the code being abandoned.
+    //
+    HWREG(NVIC_VTABLE) = 0;
+    HWREG(NVIC_FPCC) &= ~NVIC_FPCC_LSPACT;
+
+}
+
+//************************************************************************************
+//
+// A fault from thread mode preempted nothing, so returning from it into the C
+// start-up restarts the firmware with the clock and GPIO untouched.  Anything
+// else (a fault in a handler, escalated or nested) needs the system reset.
+//
+//************************************************************************************
+void FaultPortRestart(tFaultSnapshot *snap) {
+
+    uint32_t *frame;
+
+    if ((snap->flags & FAULT_FLAG_THREAD) == 0) {
+
+        SysCtlReset();
+
+    }
+
+    FaultTivaQuiesce();
+
+    snap->flags |= FAULT_FLAG_WARM;
+    FaultSeal(snap);
+
+    frame = (uint32_t *)((uint32_t)&__STACK_TOP - (FAULT_FRAME_WORDS * sizeof(uint32_t)));
+    frame[FAULT_R0] = 0;
+    frame[FAULT_R1] = 0;
+    frame[FAULT_R2] = 0;
+    frame[FAULT_R3] = 0;
+    frame[FAULT_R12] = 0;
+    frame[FAULT_LR] = 0xFFFFFFFF;
+    frame[FAULT_PC] = (uint32_t)_c_int00 & ~1UL;
+    frame[FAULT_XPSR] = FAULT_XPSR_THUMB;
+
+    FaultTivaReturn(frame);
+
+}
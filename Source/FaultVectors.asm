@@ -0,0 +1,118 @@
+;************************************************************************************
+;
+; Title:               Fault Vectors - TM4C1294 Port
+; Author:              Jacob Putz
+; Filename:            FaultVectors.asm
+;
+; Description:     FaultISR and IntDefaultHandler, the vector table's fault and
+;                      unexpected interrupt handlers.  Both hand the stack the
+;                      exception frame was pushed to and the EXC_RETURN value to
+;                      FaultEntry() (FaultTiva.c).  FaultTivaReturn() is the
+;                      exception return a warm restart leaves through.
+;
+; Current Revision:    0.1.1
+;
+; MIT License
+; Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy of
+; this software and associated documentation files (the "Software"), to deal in the
+; Software without restriction, including without limitation the rights to use, copy,
+; modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+; and to permit persons to whom the Software is furnished to do so, subject to the
+; following conditions:
+;
+; The above copyright notice and this permission notice shall be included in all
+; copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+; INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+; PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+; HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+; OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+; SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+;
+; Revision History:
+;
+; 0.1.1    -       Add FaultTivaReturn().
+;
+; 0.1.0    -       Initial implementation.
+;
+;************************************************************************************
+
+;************************************************************************************
+;
+; Notes
+;
+;  The handlers are not C functions: a compiler prologue (at -O0, or as stack use
+;  changes) could push registers and move sp before the reads below, and
+;  FaultEntry() would be handed the wrong frame.  Here nothing runs between the
+;  exception entry and the reads of sp and lr.
+;
+;  FaultTivaReturn() is here for the same reason: as a C function its asm could
+;  not count on the frame argument still being in r0.  Called from C, the AAPCS
+;  puts it there.
+;
+;************************************************************************************
+
+        .thumb
+        .sect   ".text"
+
+        .global FaultISR
+        .global IntDefaultHandler
+        .global FaultTivaReturn
+        .ref    FaultEntry
+
+;************************************************************************************
+;
+; Hard fault.  r0 is the stack the frame was pushed to (EXC_RETURN bit 2 picks
+; MSP or PSP) and r1 EXC_RETURN; FaultEntry() does not return.
+;
+;************************************************************************************
+        .thumbfunc FaultISR
+FaultISR: .asmfunc
+
+        tst     lr, #4
+        ite     eq
+        mrseq   r0, msp
+        mrsne   r0, psp
+        mov     r1, lr
+        b.w     FaultEntry
+
+        .endasmfunc
+
+;************************************************************************************
+;
+; An unexpected interrupt, or one of the configurable faults.  It is handled as a
+; fault, with the same entry as FaultISR.
+;
+;************************************************************************************
+        .thumbfunc IntDefaultHandler
+IntDefaultHandler: .asmfunc
+
+        tst     lr, #4
+        ite     eq
+        mrseq   r0, msp
+        mrsne   r0, psp
+        mov     r1, lr
+        b.w     FaultEntry
+
+        .endasmfunc
+
+;************************************************************************************
+;
+; Exception return into the thread-mode frame at r0 on the main stack, with
+; interrupts unmasked as after a reset.  Does not return.
+;
+;************************************************************************************
+        .thumbfunc FaultTivaReturn
+FaultTivaReturn: .asmfunc
+
+        msr     msp, r0
+        cpsie   i
+        mvn     lr, #6                  ; EXC_RETURN 0xFFFFFFF9: thread, MSP
+        bx      lr
+
+        .endasmfunc
+
+        .end
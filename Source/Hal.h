@@ -0,0 +1,209 @@
+//************************************************************************************
+//
+// Title:               Hardware Abstraction Layer
+// Author:              Jacob Putz
+// Filename:            Hal.h
+//
+// Description:     Thin layer over the clock, GPIO, timers, SSI and interrupt
+//                      registration.  HalTiva.c implements it with TivaWare for the
+//                      TM4C1294NCPDT; Host/HalHost.c implements it on Linux with a
+//                      simulated clock, so the scheduler, time base and DDS logic run
+//                      as a simulator.  uDMA paths are not covered; those stay in the
+//                      *Tiva.c ports with host equivalents under Host/.
+//                      Host/Makefile builds the simulator, tools and checks.
+//
+// Current Revision:    0.1.5
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.5    -       Point at the host build (Host/Makefile).
+//
+// 0.1.4    -       Add HalPeriphEnable() and HalPeriphReady().
+//
+// 0.1.3    -       Add HalClockWarm().
+//
+// 0.1.2    -       Add HalDelayCycles().
+//
+// 0.1.1    -       Add HalDeepSleep().
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Defines
+//
+// GPIO ports, in TM4C1294 order (there is no Port I or O)
+#define     HAL_PORT_A              0
+#define     HAL_PORT_B              1
+#define     HAL_PORT_C              2
+#define     HAL_PORT_D              3
+#define     HAL_PORT_E              4
+#define     HAL_PORT_F              5
+#define     HAL_PORT_G              6
+#define     HAL_PORT_H              7
+#define     HAL_PORT_J              8
+#define     HAL_PORT_K              9
+#define     HAL_PORT_L              10
+#define     HAL_PORT_M              11
+#define     HAL_PORT_N              12
+#define     HAL_PORT_P              13
+#define     HAL_PORT_Q              14
+#define     HAL_PORT_COUNT          15
+
+// GPIO pins (same values as GPIO_PIN_n)
+#define     HAL_PIN_0               0x01
+#define     HAL_PIN_1               0x02
+#define     HAL_PIN_2               0x04
+#define     HAL_PIN_3               0x08
+#define     HAL_PIN_4               0x10
+#define     HAL_PIN_5               0x20
+#define     HAL_PIN_6               0x40
+#define     HAL_PIN_7               0x80
+
+// General-purpose timers, used as 32-bit A halves
+#define     HAL_TIMER_0             0
+#define     HAL_TIMER_1             1
+#define     HAL_TIMER_2             2
+#define     HAL_TIMER_3             3
+#define     HAL_TIMER_4             4
+#define     HAL_TIMER_5             5
+#define     HAL_TIMER_COUNT         6
+
+// SSI modules and Freescale SPI modes
+#define     HAL_SSI_0               0
+#define     HAL_SSI_3               3
+#define     HAL_SSI_COUNT           4
+#define     HAL_SSI_MODE_0          0
+#define     HAL_SSI_MODE_1          1
+#define     HAL_SSI_MODE_2          2
+#define     HAL_SSI_MODE_3          3
+
+// Interrupt sources
+#define     HAL_INT_SYSTICK         0
+#define     HAL_INT_TIMER0          1
+#define     HAL_INT_TIMER1          2
+#define     HAL_INT_TIMER2          3
+#define     HAL_INT_TIMER3          4
+#define     HAL_INT_TIMER4          5
+#define     HAL_INT_TIMER5          6
+#define     HAL_INT_SSI0            7
+#define     HAL_INT_SSI3            8
+#define     HAL_INT_UART0           9
+#define     HAL_INT_COUNT           10
+
+#define     HAL_INT_TIMER(timer)    (HAL_INT_TIMER0 + (timer))
+
+// Peripheral clock gates, as a mask
+#define     HAL_PERIPH_GPIO(port)   (1UL << (port))
+#define     HAL_PERIPH_TIMER(timer) (1UL << (16 + (timer)))
+#define     HAL_PERIPH_SSI(ssi)     (1UL << (24 + (ssi)))
+#define     HAL_PERIPH_UART0        (1UL << 28)
+#define     HAL_PERIPH_UDMA         (1UL << 29)
+#define     HAL_PERIPH_COUNT        30
+
+// Type Definitions
+typedef void (*tHalHandler)(void);
+
+// Function Prototypes
+//
+// Clock.  HalClockInit() runs the PLL from the 25 MHz MOSC, starts the cycle counter
+// and returns the frequency actually obtained.  HalClockWarm() is true when it found
+// the PLL already running at the same frequency (a restart without a reset, Fault.h)
+// and left the cycle counter counting.  HalDelayCycles() busy-waits for at least
+// cycles system clock cycles, for pulse widths too short to schedule.
+//
+extern uint32_t HalClockInit(uint32_t requestHz);
+extern bool HalClockWarm(void);
+extern uint32_t HalCycles32(void);
+extern void HalDelayCycles(uint32_t cycles);
+
+//
+// Peripheral clocks.  HalPeriphEnable() opens the clock gates and returns without
+// waiting, so several peripherals (and the PLL, if called before HalClockInit())
+// come up at once.  HalPeriphReady() enables whatever is not yet enabled and waits
+// until all of periphs can be accessed; it returns the cycles spent waiting.  The
+// HAL's own init functions call it for the peripherals they configure.
+//
+extern void HalPeriphEnable(uint32_t periphs);
+extern uint32_t HalPeriphReady(uint32_t periphs);
+
+//
+// Interrupts.  HalIntMasterDisable() returns true if interrupts were already
+// disabled, like IntMasterDisable().  HalSleep() waits for the next interrupt; it
+// may be called with interrupts masked, in which case the wake-up stays pending
+// until HalIntMasterEnable().
+//
+extern void HalIntRegister(uint32_t source, tHalHandler handler);
+extern void HalIntEnable(uint32_t source);
+extern void HalIntPend(uint32_t source);
+extern bool HalIntMasterDisable(void);
+extern void HalIntMasterEnable(void);
+extern void HalSleep(void);
+
+//
+// Deep sleep.  HalDeepSleep() is called with interrupts masked, like HalSleep().  It
+// powers the PLL down, gates every peripheral not kept for deep sleep, and sleeps
+// on timer until cycles - relockCycles system clock cycles have passed or another
+// enabled interrupt arrives, then relocks the PLL.  The cycle counter and the
+// SysTick phase are moved on by the time spent, so callers only have to replay
+// the ticks that were missed (TimeBaseCatchUp()).  Returns the system clock
+// cycles that passed, relock included, or zero if cycles is too short to sleep.
+//
+extern uint32_t HalDeepSleep(uint32_t timer, uint32_t cycles, uint32_t relockCycles);
+
+//
+// SysTick.  HalTickElapsed() is the number of cycles since the last reload.
+//
+extern void HalTickInit(uint32_t periodCycles, tHalHandler handler);
+extern uint32_t HalTickElapsed(void);
+
+//
+// Timers.  The handler registered with HalTimerInit() is called after the timeout
+// flag has been cleared.
+//
+extern void HalTimerInit(uint32_t timer, tHalHandler handler);
+extern void HalTimerStart(uint32_t timer, uint32_t cycles, bool periodic);
+extern void HalTimerStop(uint32_t timer);
+
+//
+// GPIO
+//
+extern void HalGpioOutputInit(uint32_t port, uint8_t pins, uint32_t driveMA);
+extern void HalGpioWrite(uint32_t port, uint8_t pins, uint8_t value);
+extern uint8_t HalGpioRead(uint32_t port, uint8_t pins);
+
+//
+// SSI master, pins included.  HalSsiPut() blocks while the TX FIFO is full.
+//
+extern void HalSsiInit(uint32_t ssi, uint32_t sysClkHz, uint32_t bitRate,
+                       uint32_t mode, uint32_t dataWidth);
+extern void HalSsiPut(uint32_t ssi, uint16_t frame);
+extern bool HalSsiBusy(uint32_t ssi);
+
+#endif /* HAL_H_ */
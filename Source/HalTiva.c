@@ -0,0 +1,588 @@
+//************************************************************************************
+//
+// Title:               Hardware Abstraction Layer - TM4C1294 Back End
+// Author:              Jacob Putz
+// Filename:            HalTiva.c
+//
+// Description:     TivaWare implementation of Hal.h for the TM4C1294NCPDT.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Add HalPeriphEnable() and HalPeriphReady(); the init functions
+//                  wait only for their peripherals to be ready.
+//
+// 0.1.3    -       Skip the oscillator and PLL bring-up when restarting with the
+//                  PLL still locked.
+//
+// 0.1.2    -       Add HalDelayCycles().
+//
+// 0.1.1    -       Add HalDeepSleep(); run deep sleep from the PIOSC with clock
+//                  gating.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/ssi.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+#include "Hal.h"
+#include "TimeBase.h"
+
+// Defines
+#define     HAL_CLOCK_CONFIG        (SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN | SYSCTL_USE_PLL |   \
+                                     SYSCTL_CFG_VCO_480)
+
+// Deep-sleep clock (PIOSC).  Wake timers switch to it while the PLL is down.
+#define     HAL_PIOSC_HZ            16000000
+
+// Marks g_halClockKeep as written by an earlier HalClockInit()
+#define     HAL_CLOCK_KEEP_MAGIC    0x4B4C4348  // "HCLK"
+
+// Type Definitions
+typedef struct {
+
+    uint32_t periph;
+    uint32_t base;
+
+} tHalPortHW;
+
+typedef struct {
+
+    uint32_t periph;
+    uint32_t base;
+    uint32_t intNum;
+
+} tHalTimerHW;
+
+typedef struct {
+
+    uint32_t ssiPeriph;
+    uint32_t ssiBase;
+    uint32_t gpioPort;
+    uint32_t gpioBase;
+    uint32_t pinClk;
+    uint32_t pinFss;
+    uint32_t pinTx;
+    uint8_t pins;
+
+} tHalSsiHW;
+
+//
+// The clock HalClockInit() last set up.  In .noinit, so a restart without a reset
+// (Fault.h) finds it.
+//
+typedef struct {
+
+    uint32_t magic;
+    uint32_t requestHz;
+    uint32_t hz;
+
+} tHalClockKeep;
+
+// Global Constants
+static const tHalPortHW g_halPortHW[HAL_PORT_COUNT] = {
+
+    { SYSCTL_PERIPH_GPIOA, GPIO_PORTA_BASE },
+    { SYSCTL_PERIPH_GPIOB, GPIO_PORTB_BASE },
+    { SYSCTL_PERIPH_GPIOC, GPIO_PORTC_BASE },
+    { SYSCTL_PERIPH_GPIOD, GPIO_PORTD_BASE },
+    { SYSCTL_PERIPH_GPIOE, GPIO_PORTE_BASE },
+    { SYSCTL_PERIPH_GPIOF, GPIO_PORTF_BASE },
+    { SYSCTL_PERIPH_GPIOG, GPIO_PORTG_BASE },
+    { SYSCTL_PERIPH_GPIOH, GPIO_PORTH_BASE },
+    { SYSCTL_PERIPH_GPIOJ, GPIO_PORTJ_BASE },
+    { SYSCTL_PERIPH_GPIOK, GPIO_PORTK_BASE },
+    { SYSCTL_PERIPH_GPIOL, GPIO_PORTL_BASE },
+    { SYSCTL_PERIPH_GPIOM, GPIO_PORTM_BASE },
+    { SYSCTL_PERIPH_GPION, GPIO_PORTN_BASE },
+    { SYSCTL_PERIPH_GPIOP, GPIO_PORTP_BASE },
+    { SYSCTL_PERIPH_GPIOQ, GPIO_PORTQ_BASE }
+
+};
+
+static const tHalTimerHW g_halTimerHW[HAL_TIMER_COUNT] = {
+
+    { SYSCTL_PERIPH_TIMER0, TIMER0_BASE, INT_TIMER0A },
+    { SYSCTL_PERIPH_TIMER1, TIMER1_BASE, INT_TIMER1A },
+    { SYSCTL_PERIPH_TIMER2, TIMER2_BASE, INT_TIMER2A },
+    { SYSCTL_PERIPH_TIMER3, TIMER3_BASE, INT_TIMER3A },
+    { SYSCTL_PERIPH_TIMER4, TIMER4_BASE, INT_TIMER4A },
+    { SYSCTL_PERIPH_TIMER5, TIMER5_BASE, INT_TIMER5A }
+
+};
+
+//
+// Only the SSI modules wired to the DDS parts are populated.
+//
+static const tHalSsiHW g_halSsiHW[HAL_SSI_COUNT] = {
+
+    { SYSCTL_PERIPH_SSI0, SSI0_BASE, HAL_PORT_A, GPIO_PORTA_BASE,
+      GPIO_PA2_SSI0CLK, GPIO_PA3_SSI0FSS, GPIO_PA4_SSI0XDAT0,
+      GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 },
+    { 0 },
+    { 0 },
+    { SYSCTL_PERIPH_SSI3, SSI3_BASE, HAL_PORT_Q, GPIO_PORTQ_BASE,
+      GPIO_PQ0_SSI3CLK, GPIO_PQ1_SSI3FSS, GPIO_PQ2_SSI3XDAT0,
+      GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 }
+
+};
+
+static const uint32_t g_halIntNum[HAL_INT_COUNT] = {
+
+    FAULT_SYSTICK, INT_TIMER0A, INT_TIMER1A, INT_TIMER2A, INT_TIMER3A, INT_TIMER4A,
+    INT_TIMER5A, INT_SSI0, INT_SSI3, INT_UART0
+
+};
+
+//
+// HAL_PERIPH_* bit to peripheral.  Unused bits are zero.
+//
+static const uint32_t g_halPeriphs[HAL_PERIPH_COUNT] = {
+
+    SYSCTL_PERIPH_GPIOA, SYSCTL_PERIPH_GPIOB, SYSCTL_PERIPH_GPIOC, SYSCTL_PERIPH_GPIOD,
+    SYSCTL_PERIPH_GPIOE, SYSCTL_PERIPH_GPIOF, SYSCTL_PERIPH_GPIOG, SYSCTL_PERIPH_GPIOH,
+    SYSCTL_PERIPH_GPIOJ, SYSCTL_PERIPH_GPIOK, SYSCTL_PERIPH_GPIOL, SYSCTL_PERIPH_GPIOM,
+    SYSCTL_PERIPH_GPION, SYSCTL_PERIPH_GPIOP, SYSCTL_PERIPH_GPIOQ, 0,
+    SYSCTL_PERIPH_TIMER0, SYSCTL_PERIPH_TIMER1, SYSCTL_PERIPH_TIMER2, SYSCTL_PERIPH_TIMER3,
+    SYSCTL_PERIPH_TIMER4, SYSCTL_PERIPH_TIMER5, 0, 0,
+    SYSCTL_PERIPH_SSI0, SYSCTL_PERIPH_SSI1, SYSCTL_PERIPH_SSI2, SYSCTL_PERIPH_SSI3,
+    SYSCTL_PERIPH_UART0, SYSCTL_PERIPH_UDMA
+
+};
+
+static const uint32_t g_halSsiMode[4] = {
+
+    SSI_FRF_MOTO_MODE_0, SSI_FRF_MOTO_MODE_1, SSI_FRF_MOTO_MODE_2, SSI_FRF_MOTO_MODE_3
+
+};
+
+// Global Variables
+static tHalHandler g_halTimerHandlers[HAL_TIMER_COUNT];
+static uint32_t g_halClockRequestHz;
+static uint32_t g_halClockHz;
+static bool g_halClockWarm;
+
+#pragma DATA_SECTION(g_halClockKeep, ".noinit")
+static tHalClockKeep g_halClockKeep;
+
+//************************************************************************************
+//
+// Timer trampolines.  TimerIntRegister() takes a plain function, so each timer gets
+// one that clears its flag and forwards to the registered handler.
+//
+//************************************************************************************
+#define     HAL_TIMER_TRAMPOLINE(n)                                                 \
+                static void HalTimer##n##Handler(void) {                            \
+                    TimerIntClear(TIMER##n##_BASE, TIMER_TIMA_TIMEOUT);             \
+                    g_halTimerHandlers[n]();                                        \
+                }
+
+HAL_TIMER_TRAMPOLINE(0)
+HAL_TIMER_TRAMPOLINE(1)
+HAL_TIMER_TRAMPOLINE(2)
+HAL_TIMER_TRAMPOLINE(3)
+HAL_TIMER_TRAMPOLINE(4)
+HAL_TIMER_TRAMPOLINE(5)
+
+static const tHalHandler g_halTimerTrampolines[HAL_TIMER_COUNT] = {
+
+    HalTimer0Handler, HalTimer1Handler, HalTimer2Handler,
+    HalTimer3Handler, HalTimer4Handler, HalTimer5Handler
+
+};
+
+//************************************************************************************
+//
+// Use external 25MHz Precision Oscillator to generate the system clock using the
+// PLL, then start the DWT cycle counter.  Deep sleep runs from the PIOSC with the
+// MOSC left running, so the PLL relocks without waiting for the crystal; flash
+// and SRAM drop to their low-power states and only peripherals enabled for deep
+// sleep keep a clock.
+//
+// Only a reset puts the system clock back on the PIOSC, so finding it still on a
+// locked PLL, at the frequency this function last set up, means the firmware was
+// restarted without one.  The MOSC and PLL bring-up (most of the time spent here)
+// is skipped and the cycle counter keeps counting, so the restart can be timed.
+//
+//************************************************************************************
+uint32_t HalClockInit(uint32_t requestHz) {
+
+    g_halClockRequestHz = requestHz;
+    g_halClockWarm = (g_halClockKeep.magic == HAL_CLOCK_KEEP_MAGIC) &&
+                     (g_halClockKeep.requestHz == requestHz) &&
+                     ((HWREG(SYSCTL_RSCLKCFG) & SYSCTL_RSCLKCFG_USEPLL) != 0) &&
+                     ((HWREG(SYSCTL_PLLSTAT) & SYSCTL_PLLSTAT_LOCK) != 0);
+
+    if (g_halClockWarm) {
+
+        g_halClockHz = g_halClockKeep.hz;
+
+    }
+
+    else {
+
+        SysCtlMOSCConfigSet(SYSCTL_MOSC_HIGHFREQ);
+        g_halClockHz = SysCtlClockFreqSet(HAL_CLOCK_CONFIG, requestHz);
+
+        g_halClockKeep.magic = HAL_CLOCK_KEEP_MAGIC;
+        g_halClockKeep.requestHz = requestHz;
+        g_halClockKeep.hz = g_halClockHz;
+
+    }
+
+    SysCtlDeepSleepClockConfigSet(1, SYSCTL_DSLP_OSC_INT);
+    SysCtlDeepSleepPowerSet(SYSCTL_FLASH_LOW_POWER | SYSCTL_SRAM_LOW_POWER);
+    SysCtlPeripheralClockGating(true);
+
+    HWREG(DWT_DEMCR) |= DWT_DEMCR_TRCENA;
+
+    if (!g_halClockWarm) {
+
+        HWREG(DWT_CYCCNT) = 0;
+
+    }
+
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+
+    return g_halClockHz;
+
+}
+
+bool HalClockWarm(void) {
+
+    return g_halClockWarm;
+
+}
+
+uint32_t HalCycles32(void) {
+
+    return HWREG(DWT_CYCCNT);
+
+}
+
+void HalDelayCycles(uint32_t cycles) {
+
+    uint32_t start = HWREG(DWT_CYCCNT);
+
+    while ((HWREG(DWT_CYCCNT) - start) < cycles) {
+
+        // Spin on the cycle counter.
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The enable is a read-modify-write of the peripheral's RCGC register and does not
+// wait.  A peripheral is ready a few of its own clocks after the gate opens, or
+// once its reset ends, so enabling everything first and waiting just before each
+// first access keeps those delays from adding up.
+//
+//************************************************************************************
+void HalPeriphEnable(uint32_t periphs) {
+
+    uint32_t i;
+
+    for (i = 0; i < HAL_PERIPH_COUNT; i++) {
+
+        if (((periphs & (1UL << i)) != 0) && (g_halPeriphs[i] != 0)) {
+
+            SysCtlPeripheralEnable(g_halPeriphs[i]);
+
+        }
+
+    }
+
+}
+
+uint32_t HalPeriphReady(uint32_t periphs) {
+
+    uint32_t start = HWREG(DWT_CYCCNT);
+    uint32_t i;
+
+    for (i = 0; i < HAL_PERIPH_COUNT; i++) {
+
+        if (((periphs & (1UL << i)) == 0) || (g_halPeriphs[i] == 0)) {
+
+            continue;
+
+        }
+
+        if (!SysCtlPeripheralReady(g_halPeriphs[i])) {
+
+            SysCtlPeripheralEnable(g_halPeriphs[i]);
+
+            while(!SysCtlPeripheralReady(g_halPeriphs[i])) {
+
+                // Wait for the peripheral to become ready.
+
+            }
+
+        }
+
+    }
+
+    return HWREG(DWT_CYCCNT) - start;
+
+}
+
+void HalIntRegister(uint32_t source, tHalHandler handler) {
+
+    IntRegister(g_halIntNum[source], handler);
+
+}
+
+void HalIntEnable(uint32_t source) {
+
+    IntEnable(g_halIntNum[source]);
+
+}
+
+void HalIntPend(uint32_t source) {
+
+    IntPendSet(g_halIntNum[source]);
+
+}
+
+bool HalIntMasterDisable(void) {
+
+    return IntMasterDisable();
+
+}
+
+void HalIntMasterEnable(void) {
+
+    IntMasterEnable();
+
+}
+
+void HalSleep(void) {
+
+    SysCtlSleep();
+
+}
+
+//************************************************************************************
+//
+// The wake timer runs from the PIOSC for the duration, first as a one-shot for
+// the sleep itself and then free-running to time the relock, so the time spent
+// is measured rather than assumed.  SysTick is stopped while the system clock is
+// away and restarted at the phase it would have reached: the reload register is
+// briefly shortened so the first wrap lands on the original tick grid.  Any tick
+// left pending from before the sleep is dropped because the caller replays every
+// boundary up to now.
+//
+//************************************************************************************
+uint32_t HalDeepSleep(uint32_t timer, uint32_t cycles, uint32_t relockCycles) {
+
+    const tHalTimerHW *hw = &g_halTimerHW[timer];
+    uint32_t cycleStart = HWREG(DWT_CYCCNT);
+    uint32_t sinceTick = HalTickElapsed();
+    uint32_t period = SysTickPeriodGet();
+    uint32_t ticks, slept, relock, elapsed;
+
+    if (cycles <= relockCycles) {
+
+        return 0;
+
+    }
+
+    ticks = (uint32_t)(((uint64_t)(cycles - relockCycles) * HAL_PIOSC_HZ) / g_halClockHz);
+
+    if (ticks == 0) {
+
+        return 0;
+
+    }
+
+    SysTickDisable();
+    HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PENDSTCLR;
+
+    TimerDisable(hw->base, TIMER_A);
+    TimerClockSourceSet(hw->base, TIMER_CLOCK_PIOSC);
+    TimerConfigure(hw->base, TIMER_CFG_ONE_SHOT);
+    TimerLoadSet(hw->base, TIMER_A, ticks);
+    SysCtlPeripheralDeepSleepEnable(hw->periph);
+    TimerEnable(hw->base, TIMER_A);
+
+    SysCtlDeepSleep();
+
+    //
+    // Awake on the PIOSC.  Note how far the one-shot got, then time the relock.
+    //
+    slept = (TimerIntStatus(hw->base, false) & TIMER_TIMA_TIMEOUT) ? ticks :
+            (ticks - TimerValueGet(hw->base, TIMER_A));
+    TimerDisable(hw->base, TIMER_A);
+    TimerIntClear(hw->base, TIMER_TIMA_TIMEOUT);
+    TimerConfigure(hw->base, TIMER_CFG_PERIODIC);
+    TimerLoadSet(hw->base, TIMER_A, 0xFFFFFFFF);
+    TimerEnable(hw->base, TIMER_A);
+
+    SysCtlClockFreqSet(HAL_CLOCK_CONFIG, g_halClockRequestHz);
+
+    relock = 0xFFFFFFFF - TimerValueGet(hw->base, TIMER_A);
+    TimerDisable(hw->base, TIMER_A);
+    TimerClockSourceSet(hw->base, TIMER_CLOCK_SYSTEM);
+    TimerConfigure(hw->base, TIMER_CFG_ONE_SHOT);
+    SysCtlPeripheralDeepSleepDisable(hw->periph);
+
+    elapsed = (uint32_t)(((uint64_t)(slept + relock) * g_halClockHz) / HAL_PIOSC_HZ);
+    HWREG(DWT_CYCCNT) = cycleStart + elapsed;
+
+    sinceTick = (uint32_t)(((uint64_t)sinceTick + elapsed) % period);
+    HWREG(NVIC_ST_RELOAD) = (period - 1) - sinceTick;
+    HWREG(NVIC_ST_CURRENT) = 0;
+    SysTickEnable();
+    HWREG(NVIC_ST_RELOAD) = period - 1;
+
+    return elapsed;
+
+}
+
+void HalTickInit(uint32_t periodCycles, tHalHandler handler) {
+
+    SysTickDisable();
+    SysTickPeriodSet(periodCycles);
+    SysTickIntRegister(handler);
+    SysTickEnable();
+    SysTickIntEnable();
+
+}
+
+uint32_t HalTickElapsed(void) {
+
+    return (SysTickPeriodGet() - 1) - SysTickValueGet();
+
+}
+
+void HalTimerInit(uint32_t timer, tHalHandler handler) {
+
+    const tHalTimerHW *hw = &g_halTimerHW[timer];
+
+    HalPeriphReady(HAL_PERIPH_TIMER(timer));
+
+    g_halTimerHandlers[timer] = handler;
+
+    TimerConfigure(hw->base, TIMER_CFG_ONE_SHOT);
+    TimerIntRegister(hw->base, TIMER_A, g_halTimerTrampolines[timer]);
+    TimerIntEnable(hw->base, TIMER_TIMA_TIMEOUT);
+    IntEnable(hw->intNum);
+
+}
+
+void HalTimerStart(uint32_t timer, uint32_t cycles, bool periodic) {
+
+    const tHalTimerHW *hw = &g_halTimerHW[timer];
+
+    TimerDisable(hw->base, TIMER_A);
+    TimerConfigure(hw->base, periodic ? TIMER_CFG_PERIODIC : TIMER_CFG_ONE_SHOT);
+    TimerLoadSet(hw->base, TIMER_A, cycles);
+    TimerEnable(hw->base, TIMER_A);
+
+}
+
+void HalTimerStop(uint32_t timer) {
+
+    TimerDisable(g_halTimerHW[timer].base, TIMER_A);
+
+}
+
+void HalGpioOutputInit(uint32_t port, uint8_t pins, uint32_t driveMA) {
+
+    const tHalPortHW *hw = &g_halPortHW[port];
+    uint32_t drive = (driveMA >= 8) ? GPIO_STRENGTH_8MA :
+                     (driveMA >= 4) ? GPIO_STRENGTH_4MA : GPIO_STRENGTH_2MA;
+
+    HalPeriphReady(HAL_PERIPH_GPIO(port));
+
+    GPIOPinTypeGPIOOutput(hw->base, pins);
+    GPIODirModeSet(hw->base, pins, GPIO_DIR_MODE_OUT);
+    GPIOPadConfigSet(hw->base, pins, drive, GPIO_PIN_TYPE_STD);
+
+}
+
+void HalGpioWrite(uint32_t port, uint8_t pins, uint8_t value) {
+
+    GPIOPinWrite(g_halPortHW[port].base, pins, value);
+
+}
+
+uint8_t HalGpioRead(uint32_t port, uint8_t pins) {
+
+    return (uint8_t)GPIOPinRead(g_halPortHW[port].base, pins);
+
+}
+
+void HalSsiInit(uint32_t ssi, uint32_t sysClkHz, uint32_t bitRate,
+                uint32_t mode, uint32_t dataWidth) {
+
+    const tHalSsiHW *hw = &g_halSsiHW[ssi];
+
+    if (hw->ssiPeriph == 0) {
+
+        return;
+
+    }
+
+    HalPeriphReady(HAL_PERIPH_SSI(ssi) | HAL_PERIPH_GPIO(hw->gpioPort));
+
+    GPIOPinConfigure(hw->pinClk);
+    GPIOPinConfigure(hw->pinFss);
+    GPIOPinConfigure(hw->pinTx);
+    GPIOPinTypeSSI(hw->gpioBase, hw->pins);
+    GPIOPadConfigSet(hw->gpioBase, hw->pins, GPIO_STRENGTH_8MA, GPIO_PIN_TYPE_STD);
+
+    SSIDisable(hw->ssiBase);
+    SSIConfigSetExpClk(hw->ssiBase, sysClkHz, g_halSsiMode[mode & 0x3],
+                       SSI_MODE_MASTER, bitRate, dataWidth);
+    SSIEnable(hw->ssiBase);
+
+}
+
+void HalSsiPut(uint32_t ssi, uint16_t frame) {
+
+    SSIDataPut(g_halSsiHW[ssi].ssiBase, frame);
+
+}
+
+bool HalSsiBusy(uint32_t ssi) {
+
+    return SSIBusy(g_halSsiHW[ssi].ssiBase);
+
+}
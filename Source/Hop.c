@@ -0,0 +1,313 @@
+//************************************************************************************
+//
+// Title:               Frequency Hopping Engine
+// Author:              Jacob Putz
+// Filename:            Hop.c
+//
+// Description:     Channel list conversion, play-order expansion and playback for
+//                      the hop engine.  Everything that depends on the list contents
+//                      runs at load time.
+//
+// Current Revision:    0.1.3
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.3    -       Pack AD9952 hops with the shadow's phase rather than zero.
+//
+// 0.1.2    -       Pack SWEEP_PACK_STEPS words at a time.
+//
+// 0.1.1    -       Size records through the DDSChip front end and reject parts not
+//                  built.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9952.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hop.h"
+#include "Profile.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Global Variables
+tHop g_hop;
+
+//************************************************************************************
+//
+// Convert a list of Q32.32 channel frequencies to tuning words.  Any sequence
+// built from the previous list is discarded.
+//
+//************************************************************************************
+bool HopLoadList(tHop *hop, uint32_t instance, const tDDSTuning *tuning,
+                 const uint64_t *freqQ32, uint32_t channels) {
+
+    if (!DDSChipBuilt(instance) || (channels == 0) ||
+        (channels > HOP_CHANNELS_MAX) || g_sweep.running) {
+
+        return false;
+
+    }
+
+    hop->instance = instance;
+    hop->channels = channels;
+    hop->hops = 0;
+    DDSTuningFreqWords(tuning, freqQ32, hop->words, channels);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Evenly spaced channels: baseQ32 + n * spacingQ32 for n in [0, channels).
+//
+//************************************************************************************
+bool HopLoadGrid(tHop *hop, uint32_t instance, const tDDSTuning *tuning,
+                 uint64_t baseQ32, uint64_t spacingQ32, uint32_t channels) {
+
+    uint32_t i;
+
+    if (!DDSChipBuilt(instance) || (channels == 0) ||
+        (channels > HOP_CHANNELS_MAX) || g_sweep.running) {
+
+        return false;
+
+    }
+
+    hop->instance = instance;
+    hop->channels = channels;
+    hop->hops = 0;
+
+    for (i = 0; i < channels; i++) {
+
+        hop->words[i] = DDSTuningFreqWord(tuning, baseQ32);
+        baseQ32 += spacingQ32;
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Most hops the record table holds for the loaded part.
+//
+//************************************************************************************
+uint32_t HopStepsMax(const tHop *hop) {
+
+    return HOP_RECORD_ELEMS / DDSChipStepElems(hop->instance);
+
+}
+
+//************************************************************************************
+//
+// Round a requested hop count up to whole blocks.  Zero asks for one pass of
+// length hops.  Returns zero if the result does not fit the record table.
+//
+//************************************************************************************
+static uint32_t HopSteps(const tHop *hop, uint32_t hops, uint32_t length) {
+
+    if (hops == 0) {
+
+        hops = length;
+
+    }
+
+    hops = ((hops + SWEEP_BLOCK_STEPS - 1) / SWEEP_BLOCK_STEPS) * SWEEP_BLOCK_STEPS;
+
+    return (hops <= HopStepsMax(hop)) ? hops : 0;
+
+}
+
+//************************************************************************************
+//
+// Play the channels in a caller-supplied order of length indices, repeated from
+// the top until hops records exist.  Indices may repeat; each must name a loaded
+// channel.
+//
+//************************************************************************************
+bool HopSequenceOrder(tHop *hop, const uint16_t *order, uint32_t length,
+                      uint32_t hops) {
+
+    uint32_t words[SWEEP_PACK_STEPS];
+    uint16_t *record = hop->records;
+    uint32_t elems = DDSChipStepElems(hop->instance);
+    uint32_t phase = g_ad9952Shadow.reg[AD9952_REG_POW0];
+    uint32_t steps, next, i, j;
+    uint64_t start;
+    PROFILE_BEGIN(PROFILE_ID_HOP_LOAD);
+
+    steps = HopSteps(hop, hops, length);
+
+    if ((hop->channels == 0) || (length == 0) || (steps == 0) || g_sweep.running) {
+
+        return false;
+
+    }
+
+    for (i = 0; i < length; i++) {
+
+        if (order[i] >= hop->channels) {
+
+            return false;
+
+        }
+
+    }
+
+    start = TimeBaseCycles();
+    next = 0;
+
+    for (i = 0; i < steps; i += SWEEP_PACK_STEPS) {
+
+        for (j = 0; j < SWEEP_PACK_STEPS; j++) {
+
+            words[j] = hop->words[order[next]];
+            next = (next + 1 == length) ? 0 : next + 1;
+
+        }
+
+        SweepPackRecords(hop->instance, words, record, SWEEP_PACK_STEPS, phase);
+        record += SWEEP_PACK_STEPS * elems;
+
+    }
+
+    hop->hops = steps;
+    hop->loadCycles = (uint32_t)(TimeBaseCycles() - start);
+    PROFILE_END(PROFILE_ID_HOP_LOAD);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Play successive seeded shuffles of the whole channel list, each channel once
+// per pass, until hops records exist.  Every call starts from the loaded order,
+// so a seed always reproduces the same sequence.
+//
+//************************************************************************************
+bool HopSequenceShuffle(tHop *hop, uint32_t seed, uint32_t hops) {
+
+    uint32_t words[SWEEP_PACK_STEPS];
+    uint16_t *record = hop->records;
+    uint32_t elems = DDSChipStepElems(hop->instance);
+    uint32_t phase = g_ad9952Shadow.reg[AD9952_REG_POW0];
+    uint32_t state = (seed != 0) ? seed : HOP_SEED_DEFAULT;
+    uint32_t steps, next, swap, i, j;
+    uint16_t held;
+    uint64_t start;
+    PROFILE_BEGIN(PROFILE_ID_HOP_LOAD);
+
+    steps = HopSteps(hop, hops, hop->channels);
+
+    if ((hop->channels == 0) || (steps == 0) || g_sweep.running) {
+
+        return false;
+
+    }
+
+    start = TimeBaseCycles();
+
+    for (i = 0; i < hop->channels; i++) {
+
+        hop->order[i] = (uint16_t)i;
+
+    }
+
+    next = hop->channels;
+
+    for (i = 0; i < steps; i += SWEEP_PACK_STEPS) {
+
+        for (j = 0; j < SWEEP_PACK_STEPS; j++) {
+
+            //
+            // Start of a pass: shuffle the previous pass's order in place.
+            //
+            if (next == hop->channels) {
+
+                for (next = hop->channels - 1; next > 0; next--) {
+
+                    swap = HopRandomBelow(&state, next + 1);
+                    held = hop->order[next];
+                    hop->order[next] = hop->order[swap];
+                    hop->order[swap] = held;
+
+                }
+
+            }
+
+            words[j] = hop->words[hop->order[next++]];
+
+        }
+
+        SweepPackRecords(hop->instance, words, record, SWEEP_PACK_STEPS, phase);
+        record += SWEEP_PACK_STEPS * elems;
+
+    }
+
+    hop->hops = steps;
+    hop->loadCycles = (uint32_t)(TimeBaseCycles() - start);
+    PROFILE_END(PROFILE_ID_HOP_LOAD);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Start hopping at dwellCycles per hop.  As with SweepStart(), the AD9834 must
+// already be in B28 mode and the SSI stream for the part must be idle.  A
+// one-shot sequence holds its last block once finished.
+//
+//************************************************************************************
+bool HopStart(tHop *hop, uint32_t dwellCycles, bool repeat) {
+
+    if (hop->hops == 0) {
+
+        return false;
+
+    }
+
+    return SweepStartXip(&g_sweep, hop->instance, hop->records,
+                         hop->hops / SWEEP_BLOCK_STEPS, dwellCycles, repeat);
+
+}
+
+void HopStop(tHop *hop) {
+
+    if (g_sweep.xipRecords == hop->records) {
+
+        SweepStop(&g_sweep);
+
+    }
+
+}
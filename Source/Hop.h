@@ -0,0 +1,166 @@
+//************************************************************************************
+//
+// Title:               Frequency Hopping Engine
+// Author:              Jacob Putz
+// Filename:            Hop.h
+//
+// Description:     Hops across a channel list at a fixed dwell.  The list is
+//                      converted to tuning words when it is loaded, and the play order
+//                      (user supplied or a seeded shuffle) is expanded into step
+//                      records up front, so each hop at run time is one timer-triggered
+//                      uDMA burst with no decisions left to make.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Point at the host check.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef HOP_H_
+#define HOP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "DDSTuning.h"
+#include "Sweep.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Loading happens in two stages:
+//
+//      HopLoadList() / HopLoadGrid()           channel frequencies -> tuning words
+//      HopSequenceOrder() / HopSequenceShuffle()   words -> step records in play order
+//
+//  The records have the same layout as sweep step records and are played with
+//  SweepStartXip(), so the hop engine shares Timer 0A, the uDMA channel and the
+//  PL4 IO_UPDATE output with the sweep, and only one of the two runs at a time.
+//  Every hop moves the same number of SSI elements in the same burst, and the
+//  latch edge (IO_UPDATE on the AD9952, the end of the MSB frame on the AD9834)
+//  is timed from the timer, so the dwell does not depend on which channel is
+//  next or on interrupt latency.  The block interrupt that re-arms the uDMA
+//  runs once per SWEEP_BLOCK_STEPS hops, while the other control structure is
+//  still playing.
+//
+//  The table always holds whole blocks.  Rather than holding the last hop the
+//  way the preset builder pads a table, the sequence carries on into the
+//  padding (the next shuffled pass, or the user order from the top), so a
+//  repeating table keeps the same dwell on every hop.
+//
+//  The shuffle is a Fisher-Yates pass over the whole list per pass, drawing from
+//  a 32-bit xorshift generator.  The same seed gives the same sequence on the
+//  target, on the host and in the preset builder.
+//
+//  Host/Tools/HopTool.c checks the sequences against its own copy of the
+//  shuffle, that a seed reproduces its sequence, and that every hop lands on its
+//  dwell to the cycle.
+//
+//************************************************************************************
+
+// Defines
+#define     HOP_CHANNELS_MAX        4096
+#define     HOP_STEPS_MAX           4096        // AD9952 hops (4x this on the AD9834)
+#define     HOP_RECORD_ELEMS        (HOP_STEPS_MAX * SWEEP_ELEMS_AD9952)
+
+// Substituted for a zero seed, which would lock xorshift at zero
+#define     HOP_SEED_DEFAULT        0x2545F491UL
+
+// Type Definitions
+typedef struct {
+
+    //
+    // Channel list
+    //
+    uint32_t instance;              // SSISTREAM_AD9834 or SSISTREAM_AD9952
+    uint32_t channels;
+    uint32_t words[HOP_CHANNELS_MAX];
+
+    //
+    // Sequence
+    //
+    uint32_t hops;                  // Hops in records, a multiple of SWEEP_BLOCK_STEPS
+    uint16_t order[HOP_CHANNELS_MAX];   // Shuffle scratch
+    uint16_t records[HOP_RECORD_ELEMS];
+
+    //
+    // Statistics
+    //
+    uint32_t loadCycles;            // Cycles spent building the last sequence
+
+} tHop;
+
+// Global Variables
+//
+// The hop engine plays through g_sweep, so there is a single engine.
+//
+extern tHop g_hop;
+
+//************************************************************************************
+//
+// 32-bit xorshift (13, 17, 5).  state must not be zero.
+//
+//************************************************************************************
+static inline uint32_t HopRandom(uint32_t *state) {
+
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// Uniform draw from [0, n) by multiply and shift.  The bias is below n / 2^32,
+// which is far under anything a channel list can show, and it keeps the draw
+// free of divides and retries.
+//
+//************************************************************************************
+static inline uint32_t HopRandomBelow(uint32_t *state, uint32_t n) {
+
+    return (uint32_t)(((uint64_t)HopRandom(state) * n) >> 32);
+
+}
+
+// Function Prototypes
+extern bool HopLoadList(tHop *hop, uint32_t instance, const tDDSTuning *tuning,
+                        const uint64_t *freqQ32, uint32_t channels);
+extern bool HopLoadGrid(tHop *hop, uint32_t instance, const tDDSTuning *tuning,
+                        uint64_t baseQ32, uint64_t spacingQ32, uint32_t channels);
+extern uint32_t HopStepsMax(const tHop *hop);
+extern bool HopSequenceOrder(tHop *hop, const uint16_t *order, uint32_t length,
+                             uint32_t hops);
+extern bool HopSequenceShuffle(tHop *hop, uint32_t seed, uint32_t hops);
+extern bool HopStart(tHop *hop, uint32_t dwellCycles, bool repeat);
+extern void HopStop(tHop *hop);
+
+#endif /* HOP_H_ */
@@ -0,0 +1,67 @@
+//************************************************************************************
+//
+// Title:               Boot Sequencer - Host Fixture
+// Author:              Jacob Putz
+// Filename:            BootHost.c
+//
+// Description:     Runs the boot stages of Boot.c for the host tools, so each tool
+//                      starts the firmware the way main() does instead of keeping
+//                      its own copy of the start-up.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "HalHost.h"
+
+//************************************************************************************
+//
+// Bring the firmware up at BOOT_SYS_CLK_HZ, through the deferred stages if asked.
+// Returns the system clock.
+//
+//************************************************************************************
+uint32_t BootHostRun(bool deferred) {
+
+    BootInit(&g_boot, g_bootStages, BOOT_STAGE_COUNT);
+    BootClock(&g_boot, BOOT_SYS_CLK_HZ);
+    HalHostSetLimit(UINT64_MAX);
+    BootRun(&g_boot, false);
+
+    if (deferred) {
+
+        BootRun(&g_boot, true);
+
+    }
+
+    return g_boot.sysClkHz;
+
+}
@@ -0,0 +1,63 @@
+//************************************************************************************
+//
+// Title:               Boot Sequencer - Host Fixture
+// Author:              Jacob Putz
+// Filename:            BootHost.h
+//
+// Description:     Brings the firmware up for the host tools through the boot
+//                      stages of Boot.c, the way main() does, on the simulated HAL.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef BOOTHOST_H_
+#define BOOTHOST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  BootHostRun(false) runs the critical stages: time base, scheduler and power
+//  manager, memory arena, command trace, remote state, SSI streams and shadows for
+//  the parts DDS_CHIP builds, and the sweep and modulation ports.  With deferred
+//  set it goes on to the preset store, software DDS, calibration, the channel
+//  table and the remote link port, as main() does before its loop.  The simulated
+//  clock runs without a limit, and the tool decides how long to run.
+//
+//  A tool sets up whatever it needs beyond the firmware's own start-up (tuning
+//  contexts of its own, a watch on the GPIOs) after this returns.
+//
+//************************************************************************************
+
+// Function Prototypes
+extern uint32_t BootHostRun(bool deferred);
+
+#endif /* BOOTHOST_H_ */
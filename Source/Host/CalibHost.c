@@ -0,0 +1,254 @@
+//************************************************************************************
+//
+// Title:               Reference Clock Calibration - Host Port
+// Author:              Jacob Putz
+// Filename:            CalibHost.c
+//
+// Description:     Synthetic edge counter for Calib.c.  The DDS output is modelled
+//                      from the word on the part and a reference clock that is off
+//                      nominal by DDS_SIM_CALIB_PPM, and counted against the
+//                      simulated cycle counter.
+//
+// Current Revision:    0.1.1
+//
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Wait for the peripherals the target port brings up.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Calib.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "HalHost.h"
+#include "Remote.h"
+#include "SSIStream.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  The part's true reference clock is nominal * (1 + DDS_SIM_CALIB_PPM / 1e6).
+//  DDS_SIM_CALIB=<chip>,<hz> sets chip (0 AD9834, 1 AD9952) to a steady hz at
+//  start-up, as SET_FREQ would, and starts calibration with CALIB_FLAG_APPLY;
+//  otherwise calibration is started from the remote link.  Every fit prints the
+//  estimate's error against the true clock and, with DDS_SIM_CALIB, the output's
+//  error against the requested frequency, and the run reports when the clock in use
+//  first comes within DDS_SIM_CALIB_TOL_PPB (default CALIB_HOST_TOL_PPB) of the
+//  truth.
+//
+//  Edges are counted exactly (the floor of the accumulated output phase), so the
+//  only measurement error is the one-edge quantization the fit has to average out.
+//
+//************************************************************************************
+
+// Defines
+#define     CALIB_HOST_PHASE0       0.37        // Output phase at the first count
+#define     CALIB_HOST_TOL_PPB      200
+
+// Global Variables
+static double g_calibHostRequestHz = 0.0;   // Zero without DDS_SIM_CALIB
+static double g_calibHostPpm = 0.0;
+static double g_calibHostRefHz = 0.0;       // True reference clock
+static double g_calibHostPhase = CALIB_HOST_PHASE0;
+static uint64_t g_calibHostLast = 0;
+static uint32_t g_calibHostLastWord = 0;
+static double g_calibHostTolPpm = CALIB_HOST_TOL_PPB * 1e-3;
+static bool g_calibHostConverged = false;
+
+//************************************************************************************
+//
+// The word driving the output as the part has it, steady or not.
+//
+//************************************************************************************
+static uint32_t CalibHostWord(uint32_t instance) {
+
+    const tAD9834Shadow *shadow = &g_ad9834Shadow;
+    uint16_t sel;
+
+    if (instance == SSISTREAM_AD9952) {
+
+        return g_ad9952Shadow.devReg[AD9952_REG_FTW0];
+
+    }
+
+    sel = ((shadow->devCtrl & AD9834_CTRL_PIN_SW) != 0) ? shadow->pins : shadow->devCtrl;
+
+    return shadow->devFreq[((sel & AD9834_CTRL_FSEL) != 0) ? 1 : 0];
+
+}
+
+static double CalibHostSeconds(void) {
+
+    return (double)HalHostCycles() / (double)g_calib.sysClkHz;
+
+}
+
+void CalibPortInit(void) {
+
+    const char *scenario = getenv("DDS_SIM_CALIB");
+    const char *ppm = getenv("DDS_SIM_CALIB_PPM");
+    const char *tol = getenv("DDS_SIM_CALIB_TOL_PPB");
+    tDDSTuning *tuning;
+    uint32_t instance;
+    uint32_t word;
+    char *end;
+
+    HalPeriphReady(CALIB_PERIPHS);
+
+    if (ppm != 0) {
+
+        g_calibHostPpm = strtod(ppm, 0);
+
+    }
+
+    if (tol != 0) {
+
+        g_calibHostTolPpm = strtod(tol, 0) * 1e-3;
+
+    }
+
+    if (scenario == 0) {
+
+        return;
+
+    }
+
+    instance = (uint32_t)strtoul(scenario, &end, 10);
+
+    if ((*end != ',') || !DDSChipBuilt(instance)) {
+
+        fprintf(stderr, "calib: DDS_SIM_CALIB must be <chip>,<hz>\n");
+        return;
+
+    }
+
+    tuning = &g_remote.tuning[instance];
+    g_calibHostRequestHz = strtod(end + 1, 0);
+    word = DDSTuningFreqWord(tuning, (uint64_t)(g_calibHostRequestHz * 4294967296.0));
+
+    if (instance == SSISTREAM_AD9952) {
+
+        DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_FTW0, word);
+
+    }
+
+    else {
+
+        DDSShadowAD9834SetFreq(&g_ad9834Shadow, 0, word);
+
+    }
+
+    g_remote.shadowDirty[instance] = true;
+
+    printf("calib: chip %u, %.3f Hz requested, reference off by %+.3f ppm\n",
+           instance, g_calibHostRequestHz, g_calibHostPpm);
+
+    CalibStart(&g_calib, instance, CALIB_FLAG_APPLY, 0);
+
+}
+
+//************************************************************************************
+//
+// The true clock of the part being measured.  The output phase carries on from
+// the previous run.
+//
+//************************************************************************************
+void CalibPortStart(tCalib *calib) {
+
+    tDDSTuning nominal;
+
+    DDSChipTuningInit(calib->instance, &nominal);
+
+    g_calibHostRefHz = (double)nominal.refClkHz * (1.0 + g_calibHostPpm * 1e-6);
+    g_calibHostLast = HalHostCycles();
+    g_calibHostLastWord = CalibHostWord(calib->instance);
+
+}
+
+void CalibPortStop(tCalib *calib) {
+
+    (void)calib;
+
+}
+
+//************************************************************************************
+//
+// Advance the output phase to now at the word in effect since the last count.
+//
+//************************************************************************************
+uint32_t CalibPortCount(const tCalib *calib) {
+
+    const tDDSTuning *tuning = &g_remote.tuning[calib->instance];
+    uint64_t now = HalHostCycles();
+    double outputHz = (double)g_calibHostLastWord * g_calibHostRefHz /
+                      (double)(1ULL << tuning->freqBits);
+
+    g_calibHostPhase += outputHz * (double)(now - g_calibHostLast) /
+                        (double)calib->sysClkHz;
+    g_calibHostLast = now;
+    g_calibHostLastWord = CalibHostWord(calib->instance);
+
+    return (uint32_t)(uint64_t)g_calibHostPhase & CALIB_COUNT_MASK;
+
+}
+
+void CalibPortFit(const tCalib *calib) {
+
+    const tDDSTuning *tuning = &g_remote.tuning[calib->instance];
+    double outputHz = (double)CalibHostWord(calib->instance) * g_calibHostRefHz /
+                      (double)(1ULL << tuning->freqBits);
+    double error;
+
+    printf("calib: %8.3f s  fit %3u  ref %.3f Hz (%+.4f ppm, sigma %.4f)  using %u",
+           CalibHostSeconds(), calib->fits, calib->refClkHz,
+           (calib->refClkHz / g_calibHostRefHz - 1.0) * 1e6, calib->sigmaPpm,
+           tuning->refClkHz);
+
+    if (g_calibHostRequestHz != 0.0) {
+
+        printf("  output %+.4f ppm", (outputHz / g_calibHostRequestHz - 1.0) * 1e6);
+
+    }
+
+    printf("\n");
+
+    error = ((double)tuning->refClkHz / g_calibHostRefHz - 1.0) * 1e6;
+
+    if (!g_calibHostConverged && (error < g_calibHostTolPpm) &&
+        (error > -g_calibHostTolPpm)) {
+
+        g_calibHostConverged = true;
+        printf("calib: converged after %.3f s\n", CalibHostSeconds());
+
+    }
+
+}
@@ -0,0 +1,82 @@
+//************************************************************************************
+//
+// Title:               Fault Snapshot and Warm Restart - Host Port
+// Author:              Jacob Putz
+// Filename:            FaultHost.c
+//
+// Description:     Fault.c on a host build.  There are no exceptions to take, so
+//                      the snapshot is only written by code that calls
+//                      FaultCapture() itself (Host/Tools/FaultTool.c), and a restart
+//                      ends the simulation.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Fault.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  DDS_SIM_FAULT=<path> writes the snapshot there when the simulation stops for a
+//  fault, in the FAULT_READ byte layout, for FaultTool decode.
+//
+//************************************************************************************
+
+// Global Variables
+tFaultSnapshot g_faultSnapshot;
+
+void FaultPortRestart(tFaultSnapshot *snap) {
+
+    const char *path = getenv("DDS_SIM_FAULT");
+    FILE *file;
+
+    printf("dds_sim: fault, vector %u, pc 0x%08X\n", snap->vector,
+           snap->frame[FAULT_PC]);
+
+    if (path != 0) {
+
+        file = fopen(path, "wb");
+
+        if (file != 0) {
+
+            fwrite(snap, sizeof(*snap), 1, file);
+            fclose(file);
+
+        }
+
+    }
+
+    exit(3);
+
+}
@@ -0,0 +1,768 @@
+//************************************************************************************
+//
+// Title:               Hardware Abstraction Layer - Host Back End
+// Author:              Jacob Putz
+// Filename:            HalHost.c
+//
+// Description:     Linux implementation of Hal.h.  Time is a simulated 64-bit cycle
+//                      counter that only moves when the firmware sleeps (or a test
+//                      calls HalHostAdvance()), jumping straight to the next SysTick or
+//                      timer event, so a run goes as fast as the host can execute the
+//                      firmware logic.  Interrupts are dispatched synchronously with
+//                      the same masking rules as the NVIC.
+//
+// Current Revision:    0.1.6
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.6    -       Let tools read and restart the power accounting.
+//
+// 0.1.5    -       Build with Host/Makefile.
+//
+// 0.1.4    -       Model peripheral clock enables and their ready delay.
+//
+// 0.1.3    -       Add HalClockWarm(); HalGpioOutputInit() leaves the output level
+//                  alone, as the data register does on the target.
+//
+// 0.1.2    -       Add HalDelayCycles() and the GPIO watch hook.
+//
+// 0.1.1    -       Add HalDeepSleep() and the DDS_SIM_POWER report.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Hal.h"
+#include "HalHost.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds the simulator as build/dds_sim, with the host tools, and
+//  runs their checks (make test) and benchmarks (make bench).  Add
+//  DEFS=-DPROFILE_ENABLE to include the profiling hooks.
+//
+//  DDS_SIM_SECONDS sets how much simulated time to run before exiting (default
+//  10 s); DDS_SIM_TRACE=1 prints every GPIO change and SSI frame to stdout.
+//
+//  DDS_SIM_POWER=1 prints a power report at the end of the run: time in each
+//  state, the estimated current and energy per hour, and how the deep-sleep
+//  wakes fared against their deadlines.  The relock takes DDS_SIM_RELOCK_US
+//  (default HAL_HOST_RELOCK_US).  The currents are rough typical figures for a
+//  TM4C1294 at 3.3 V with the DDS parts excluded; they rank workloads, they do
+//  not replace a measurement.
+//
+//************************************************************************************
+
+// Defines
+#define     HAL_HOST_NEVER          0xFFFFFFFFFFFFFFFFULL
+#define     HAL_HOST_SECONDS        10
+#define     HAL_HOST_CAPTURE_MASK   (HAL_HOST_SSI_CAPTURE - 1)
+
+// Power model
+#define     HAL_HOST_RELOCK_US      300
+#define     HAL_HOST_VDD            3.3
+#define     HAL_HOST_RUN_MA         45.0        // 120 MHz from the PLL, relock included
+#define     HAL_HOST_SLEEP_MA       20.0        // WFI, peripherals clocked
+#define     HAL_HOST_DEEP_MA        2.5         // PIOSC, PLL down, clocks gated
+
+// Peripheral model: cycles from the clock gate opening to the peripheral being
+// ready.  A rough figure; it only has to make serial waits visible.
+#define     HAL_HOST_PERIPH_READY   16
+
+// Type Definitions
+typedef struct {
+
+    uint64_t deadline;              // HAL_HOST_NEVER when stopped
+    uint32_t period;                // Zero for one-shot
+    tHalHandler handler;
+
+} tHalHostTimer;
+
+typedef struct {
+
+    tHalHostFrame frames[HAL_HOST_SSI_CAPTURE];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+
+} tHalHostSsi;
+
+// Global Variables
+static uint64_t g_halHostCycles = 0;
+static uint64_t g_halHostLimit = HAL_HOST_NEVER;
+static uint32_t g_halHostClockHz = 0;
+static bool g_halHostWarm = false;
+static bool g_halHostTrace = false;
+
+static tHalHandler g_halHostHandlers[HAL_INT_COUNT];
+static bool g_halHostEnabled[HAL_INT_COUNT];
+static uint32_t g_halHostPending = 0;
+static bool g_halHostMasked = false;
+static bool g_halHostDispatching = false;
+
+static tHalHostTimer g_halHostTick = { HAL_HOST_NEVER, 0, 0 };
+static uint64_t g_halHostLastTick = 0;
+static tHalHostTimer g_halHostTimers[HAL_TIMER_COUNT];
+
+static uint32_t g_halHostRelockCycles = 0;
+static bool g_halHostPowerReport = false;
+static uint64_t g_halHostPowerStart = 0;
+static uint64_t g_halHostSleepCycles = 0;
+static uint64_t g_halHostDeepCycles = 0;
+static uint64_t g_halHostRelockTotal = 0;
+static uint32_t g_halHostDeepSleeps = 0;
+static uint32_t g_halHostDeepLate = 0;
+static int64_t g_halHostDeepMarginMin = 0x7FFFFFFFFFFFFFFFLL;
+
+static uint32_t g_halHostPeriphs = 0;
+static uint64_t g_halHostPeriphReady[HAL_PERIPH_COUNT];
+
+static uint8_t g_halHostGpio[HAL_PORT_COUNT];
+static tHalHostGpioWatch g_halHostGpioWatch = 0;
+static tHalHostSsi g_halHostSsi[HAL_SSI_COUNT];
+
+//************************************************************************************
+//
+// Run pending handlers, lowest source number first.  Handlers that pend further
+// interrupts (or themselves) are picked up by the same loop rather than recursing,
+// which matches a single NVIC priority level.
+//
+//************************************************************************************
+static void HalHostDispatch(void) {
+
+    uint32_t source;
+
+    if (g_halHostMasked || g_halHostDispatching) {
+
+        return;
+
+    }
+
+    g_halHostDispatching = true;
+
+    while (g_halHostPending != 0) {
+
+        for (source = 0; (g_halHostPending & (1UL << source)) == 0; source++) {
+
+        }
+
+        g_halHostPending &= ~(1UL << source);
+
+        if (g_halHostEnabled[source] && (g_halHostHandlers[source] != 0)) {
+
+            g_halHostHandlers[source]();
+
+        }
+
+    }
+
+    g_halHostDispatching = false;
+
+}
+
+static uint64_t HalHostNextEvent(void) {
+
+    uint64_t next = g_halHostTick.deadline;
+    uint32_t i;
+
+    for (i = 0; i < HAL_TIMER_COUNT; i++) {
+
+        if (g_halHostTimers[i].deadline < next) {
+
+            next = g_halHostTimers[i].deadline;
+
+        }
+
+    }
+
+    return next;
+
+}
+
+//************************************************************************************
+//
+// Power report for DDS_SIM_POWER=1.
+//
+//************************************************************************************
+static void HalHostPowerReport(void) {
+
+    tHalHostPower power;
+    double total, hz, run;
+
+    HalHostPower(&power);
+
+    if (!g_halHostPowerReport || (power.cycles == 0)) {
+
+        return;
+
+    }
+
+    total = (double)power.cycles;
+    hz = (double)g_halHostClockHz;
+    run = total - (double)power.sleepCycles - (double)power.deepCycles;
+
+    printf("power: run %.2f%%  sleep %.2f%%  deep %.2f%%  (relock %.3f%%)\n",
+           100.0 * run / total, 100.0 * (double)power.sleepCycles / total,
+           100.0 * (double)power.deepCycles / total,
+           100.0 * (double)power.relockCycles / total);
+    printf("power: average %.2f mA, %.1f J (%.1f mWh) per hour\n", power.averageMa,
+           power.averageMa * HAL_HOST_VDD * 3.6, power.averageMa * HAL_HOST_VDD);
+
+    if (power.deepSleeps != 0) {
+
+        printf("power: %u deep sleeps, relock %.0f us, %u late, worst margin %.1f us\n",
+               power.deepSleeps, (double)g_halHostRelockCycles * 1e6 / hz,
+               power.deepLate, (double)power.deepMarginMin * 1e6 / hz);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Move the clock to cycle and pend every event that has come due on the way.
+//
+//************************************************************************************
+static void HalHostRunTo(uint64_t cycle) {
+
+    uint32_t i;
+
+    if (cycle > g_halHostLimit) {
+
+        g_halHostCycles = g_halHostLimit;
+        HalHostPowerReport();
+        printf("dds_sim: stopped after %llu cycles\n",
+               (unsigned long long)g_halHostLimit);
+        exit(0);
+
+    }
+
+    g_halHostCycles = cycle;
+
+    while (g_halHostTick.deadline <= cycle) {
+
+        g_halHostLastTick = g_halHostTick.deadline;
+        g_halHostTick.deadline += g_halHostTick.period;
+        g_halHostPending |= 1UL << HAL_INT_SYSTICK;
+
+    }
+
+    for (i = 0; i < HAL_TIMER_COUNT; i++) {
+
+        tHalHostTimer *timer = &g_halHostTimers[i];
+
+        if (timer->deadline <= cycle) {
+
+            timer->deadline = (timer->period != 0) ? (timer->deadline + timer->period) :
+                                                     HAL_HOST_NEVER;
+            g_halHostPending |= 1UL << HAL_INT_TIMER(i);
+
+        }
+
+    }
+
+}
+
+uint32_t HalClockInit(uint32_t requestHz) {
+
+    const char *seconds = getenv("DDS_SIM_SECONDS");
+    const char *trace = getenv("DDS_SIM_TRACE");
+    const char *power = getenv("DDS_SIM_POWER");
+    const char *relock = getenv("DDS_SIM_RELOCK_US");
+    uint32_t i;
+
+    //
+    // A second call in the same process is a restart without a reset (Fault.h): the
+    // PLL is still locked and the cycle counter keeps counting.
+    //
+    g_halHostWarm = (g_halHostClockHz == requestHz);
+    g_halHostClockHz = requestHz;
+
+    //
+    // On a cold start the oscillator and PLL take far longer than any peripheral, so
+    // whatever was enabled before this call is ready by the time it returns.
+    //
+    if (!g_halHostWarm) {
+
+        g_halHostCycles = 0;
+
+        for (i = 0; i < HAL_PERIPH_COUNT; i++) {
+
+            g_halHostPeriphReady[i] = 0;
+
+        }
+
+    }
+
+    g_halHostPending = 0;
+
+    g_halHostLimit = g_halHostCycles + (uint64_t)requestHz *
+                     ((seconds != 0) ? strtoull(seconds, 0, 10) : HAL_HOST_SECONDS);
+    g_halHostTrace = (trace != 0) && (trace[0] == '1');
+    g_halHostPowerReport = (power != 0) && (power[0] == '1');
+    g_halHostRelockCycles = (requestHz / 1000000) *
+                            ((relock != 0) ? (uint32_t)strtoul(relock, 0, 10) :
+                                             HAL_HOST_RELOCK_US);
+
+    for (i = 0; i < HAL_TIMER_COUNT; i++) {
+
+        g_halHostTimers[i].deadline = HAL_HOST_NEVER;
+
+    }
+
+    return requestHz;
+
+}
+
+bool HalClockWarm(void) {
+
+    return g_halHostWarm;
+
+}
+
+uint32_t HalCycles32(void) {
+
+    return (uint32_t)g_halHostCycles;
+
+}
+
+void HalDelayCycles(uint32_t cycles) {
+
+    HalHostAdvance(cycles);
+
+}
+
+void HalPeriphEnable(uint32_t periphs) {
+
+    uint32_t i;
+
+    for (i = 0; i < HAL_PERIPH_COUNT; i++) {
+
+        if (((periphs & ~g_halHostPeriphs) & (1UL << i)) != 0) {
+
+            g_halHostPeriphReady[i] = g_halHostCycles + HAL_HOST_PERIPH_READY;
+
+        }
+
+    }
+
+    g_halHostPeriphs |= periphs;
+
+}
+
+uint32_t HalPeriphReady(uint32_t periphs) {
+
+    uint64_t start = g_halHostCycles;
+    uint64_t ready = start;
+    uint32_t i;
+
+    HalPeriphEnable(periphs);
+
+    for (i = 0; i < HAL_PERIPH_COUNT; i++) {
+
+        if (((periphs & (1UL << i)) != 0) && (g_halHostPeriphReady[i] > ready)) {
+
+            ready = g_halHostPeriphReady[i];
+
+        }
+
+    }
+
+    if (ready > start) {
+
+        HalHostAdvance(ready - start);
+
+    }
+
+    return (uint32_t)(g_halHostCycles - start);
+
+}
+
+void HalIntRegister(uint32_t source, tHalHandler handler) {
+
+    g_halHostHandlers[source] = handler;
+
+}
+
+void HalIntEnable(uint32_t source) {
+
+    g_halHostEnabled[source] = true;
+
+}
+
+void HalIntPend(uint32_t source) {
+
+    g_halHostPending |= 1UL << source;
+    HalHostDispatch();
+
+}
+
+bool HalIntMasterDisable(void) {
+
+    bool wasMasked = g_halHostMasked;
+
+    g_halHostMasked = true;
+
+    return wasMasked;
+
+}
+
+void HalIntMasterEnable(void) {
+
+    g_halHostMasked = false;
+    HalHostDispatch();
+
+}
+
+//************************************************************************************
+//
+// WFI: return at once if something is pending, otherwise jump to the next event.
+// With nothing scheduled at all the core would sleep forever, which on a host is
+// the end of the run.
+//
+//************************************************************************************
+void HalSleep(void) {
+
+    uint64_t start = g_halHostCycles;
+
+    if (g_halHostPending == 0) {
+
+        HalHostRunTo(HalHostNextEvent());
+
+    }
+
+    g_halHostSleepCycles += g_halHostCycles - start;
+    HalHostDispatch();
+
+}
+
+//************************************************************************************
+//
+// Deep sleep.  Time stays continuous on the host, so SysTick keeps pending while
+// asleep but does not end the sleep, and like the part the pending tick is
+// dropped at the end because TimeBaseCatchUp() replays the boundaries.  The
+// relock is modelled as a fixed DDS_SIM_RELOCK_US of run time.
+//
+//************************************************************************************
+uint32_t HalDeepSleep(uint32_t timer, uint32_t cycles, uint32_t relockCycles) {
+
+    uint64_t start = g_halHostCycles;
+    uint64_t woke;
+    int64_t margin;
+
+    if (cycles <= relockCycles) {
+
+        return 0;
+
+    }
+
+    HalTimerStart(timer, cycles - relockCycles, false);
+
+    while ((g_halHostPending & ~(1UL << HAL_INT_SYSTICK)) == 0) {
+
+        HalHostRunTo(HalHostNextEvent());
+
+    }
+
+    woke = g_halHostCycles;
+    HalHostRunTo(woke + g_halHostRelockCycles);
+    HalTimerStop(timer);
+    g_halHostPending &= ~(1UL << HAL_INT_SYSTICK);
+
+    margin = (int64_t)(start + cycles) - (int64_t)g_halHostCycles;
+    g_halHostDeepCycles += woke - start;
+    g_halHostRelockTotal += g_halHostRelockCycles;
+    g_halHostDeepSleeps++;
+
+    if (margin < 0) {
+
+        g_halHostDeepLate++;
+
+    }
+
+    if (margin < g_halHostDeepMarginMin) {
+
+        g_halHostDeepMarginMin = margin;
+
+    }
+
+    return (uint32_t)(g_halHostCycles - start);
+
+}
+
+void HalTickInit(uint32_t periodCycles, tHalHandler handler) {
+
+    g_halHostHandlers[HAL_INT_SYSTICK] = handler;
+    g_halHostEnabled[HAL_INT_SYSTICK] = true;
+    g_halHostTick.period = periodCycles;
+    g_halHostTick.deadline = g_halHostCycles + periodCycles;
+    g_halHostLastTick = g_halHostCycles;
+
+}
+
+uint32_t HalTickElapsed(void) {
+
+    return (uint32_t)(g_halHostCycles - g_halHostLastTick);
+
+}
+
+void HalTimerInit(uint32_t timer, tHalHandler handler) {
+
+    HalPeriphReady(HAL_PERIPH_TIMER(timer));
+
+    g_halHostHandlers[HAL_INT_TIMER(timer)] = handler;
+    g_halHostEnabled[HAL_INT_TIMER(timer)] = true;
+    g_halHostTimers[timer].deadline = HAL_HOST_NEVER;
+
+}
+
+void HalTimerStart(uint32_t timer, uint32_t cycles, bool periodic) {
+
+    g_halHostTimers[timer].deadline = g_halHostCycles + (cycles ? cycles : 1);
+    g_halHostTimers[timer].period = periodic ? cycles : 0;
+
+}
+
+void HalTimerStop(uint32_t timer) {
+
+    g_halHostTimers[timer].deadline = HAL_HOST_NEVER;
+
+}
+
+//************************************************************************************
+//
+// Configuring a pin as an output does not change its data bit, so lines re-driven
+// after a restart without a reset hold their level.  After a reset they start low.
+//
+//************************************************************************************
+void HalGpioOutputInit(uint32_t port, uint8_t pins, uint32_t driveMA) {
+
+    (void)pins;
+    (void)driveMA;
+
+    HalPeriphReady(HAL_PERIPH_GPIO(port));
+
+}
+
+void HalGpioWrite(uint32_t port, uint8_t pins, uint8_t value) {
+
+    uint8_t before = g_halHostGpio[port];
+    uint8_t state = (before & ~pins) | (value & pins);
+
+    if (g_halHostTrace && (state != before)) {
+
+        printf("%12llu gpio %c %02X\n", (unsigned long long)g_halHostCycles,
+               "ABCDEFGHJKLMNPQ"[port], state);
+
+    }
+
+    g_halHostGpio[port] = state;
+
+    if ((g_halHostGpioWatch != 0) && (state != before)) {
+
+        g_halHostGpioWatch(port, before, state);
+
+    }
+
+}
+
+uint8_t HalGpioRead(uint32_t port, uint8_t pins) {
+
+    return g_halHostGpio[port] & pins;
+
+}
+
+void HalSsiInit(uint32_t ssi, uint32_t sysClkHz, uint32_t bitRate,
+                uint32_t mode, uint32_t dataWidth) {
+
+    (void)sysClkHz;
+    (void)bitRate;
+    (void)mode;
+    (void)dataWidth;
+
+    HalPeriphReady(HAL_PERIPH_SSI(ssi) |
+                   HAL_PERIPH_GPIO((ssi == HAL_SSI_0) ? HAL_PORT_A : HAL_PORT_Q));
+
+    g_halHostSsi[ssi].head = 0;
+    g_halHostSsi[ssi].tail = 0;
+    g_halHostSsi[ssi].dropped = 0;
+
+}
+
+//************************************************************************************
+//
+// Capture a frame.  When the capture ring is full the oldest frame is discarded.
+//
+//************************************************************************************
+void HalSsiPut(uint32_t ssi, uint16_t frame) {
+
+    tHalHostSsi *port = &g_halHostSsi[ssi];
+    tHalHostFrame *slot;
+
+    if ((port->head - port->tail) == HAL_HOST_SSI_CAPTURE) {
+
+        port->tail++;
+        port->dropped++;
+
+    }
+
+    slot = &port->frames[port->head & HAL_HOST_CAPTURE_MASK];
+    slot->cycle = g_halHostCycles;
+    slot->frame = frame;
+    port->head++;
+
+    if (g_halHostTrace) {
+
+        printf("%12llu ssi%u %04X\n", (unsigned long long)g_halHostCycles, ssi, frame);
+
+    }
+
+}
+
+bool HalSsiBusy(uint32_t ssi) {
+
+    (void)ssi;
+
+    return false;
+
+}
+
+uint64_t HalHostCycles(void) {
+
+    return g_halHostCycles;
+
+}
+
+void HalHostPower(tHalHostPower *power) {
+
+    double run;
+
+    power->cycles = g_halHostCycles - g_halHostPowerStart;
+    power->sleepCycles = g_halHostSleepCycles;
+    power->deepCycles = g_halHostDeepCycles;
+    power->relockCycles = g_halHostRelockTotal;
+    power->deepSleeps = g_halHostDeepSleeps;
+    power->deepLate = g_halHostDeepLate;
+    power->deepMarginMin = g_halHostDeepMarginMin;
+    power->averageMa = 0.0;
+
+    if (power->cycles != 0) {
+
+        run = (double)(power->cycles - power->sleepCycles - power->deepCycles);
+        power->averageMa = ((run * HAL_HOST_RUN_MA) +
+                            ((double)power->sleepCycles * HAL_HOST_SLEEP_MA) +
+                            ((double)power->deepCycles * HAL_HOST_DEEP_MA)) /
+                           (double)power->cycles;
+
+    }
+
+}
+
+void HalHostPowerReset(void) {
+
+    g_halHostPowerStart = g_halHostCycles;
+    g_halHostSleepCycles = 0;
+    g_halHostDeepCycles = 0;
+    g_halHostRelockTotal = 0;
+    g_halHostDeepSleeps = 0;
+    g_halHostDeepLate = 0;
+    g_halHostDeepMarginMin = 0x7FFFFFFFFFFFFFFFLL;
+
+}
+
+//************************************************************************************
+//
+// Let cycles of simulated time pass, servicing every event on the way as the
+// hardware would.
+//
+//************************************************************************************
+void HalHostAdvance(uint64_t cycles) {
+
+    uint64_t end = g_halHostCycles + cycles;
+    uint64_t next;
+
+    while ((next = HalHostNextEvent()) <= end) {
+
+        HalHostRunTo(next);
+        HalHostDispatch();
+
+    }
+
+    HalHostRunTo(end);
+    HalHostDispatch();
+
+}
+
+void HalHostSetLimit(uint64_t cycles) {
+
+    g_halHostLimit = cycles;
+
+}
+
+bool HalHostSsiRead(uint32_t ssi, tHalHostFrame *frame) {
+
+    tHalHostSsi *port = &g_halHostSsi[ssi];
+
+    if (port->head == port->tail) {
+
+        return false;
+
+    }
+
+    *frame = port->frames[port->tail & HAL_HOST_CAPTURE_MASK];
+    port->tail++;
+
+    return true;
+
+}
+
+uint32_t HalHostSsiDropped(uint32_t ssi) {
+
+    return g_halHostSsi[ssi].dropped;
+
+}
+
+uint8_t HalHostGpioState(uint32_t port) {
+
+    return g_halHostGpio[port];
+
+}
+
+//************************************************************************************
+//
+// Call watch on every GPIO write that changes a port, after the new state is in
+// place, so a model of the parts can sample the lines edge by edge.
+//
+//************************************************************************************
+void HalHostGpioWatch(tHalHostGpioWatch watch) {
+
+    g_halHostGpioWatch = watch;
+
+}
@@ -0,0 +1,91 @@
+//************************************************************************************
+//
+// Title:               Hardware Abstraction Layer - Host Back End
+// Author:              Jacob Putz
+// Filename:            HalHost.h
+//
+// Description:     Host-only additions to Hal.h: access to the simulated clock and
+//                      to the SSI frames and GPIO states the firmware produced, for
+//                      simulator runs and off-target tests.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Add HalHostPower() and HalHostPowerReset().
+//
+// 0.1.1    -       Add HalHostGpioWatch().
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef HALHOST_H_
+#define HALHOST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+
+// Defines
+#define     HAL_HOST_SSI_CAPTURE    4096        // Frames kept per SSI (power of two)
+
+// Type Definitions
+typedef struct {
+
+    uint64_t cycle;                 // Simulated cycle the frame was written at
+    uint16_t frame;
+
+} tHalHostFrame;
+
+//
+// Power accounting since HalHostPowerReset() (or the start).  Cycles not spent
+// asleep are run time, the relock included.
+//
+typedef struct {
+
+    uint64_t cycles;
+    uint64_t sleepCycles;           // WFI
+    uint64_t deepCycles;            // Deep sleep, up to the wake
+    uint64_t relockCycles;
+    uint32_t deepSleeps;
+    uint32_t deepLate;              // Deep wakes relocked after the deadline
+    int64_t deepMarginMin;          // Cycles; INT64_MAX before any deep sleep
+    double averageMa;               // From the currents in HalHost.c
+
+} tHalHostPower;
+
+typedef void (*tHalHostGpioWatch)(uint32_t port, uint8_t before, uint8_t after);
+
+// Function Prototypes
+extern uint64_t HalHostCycles(void);
+extern void HalHostAdvance(uint64_t cycles);
+extern void HalHostSetLimit(uint64_t cycles);
+extern bool HalHostSsiRead(uint32_t ssi, tHalHostFrame *frame);
+extern uint32_t HalHostSsiDropped(uint32_t ssi);
+extern uint8_t HalHostGpioState(uint32_t port);
+extern void HalHostGpioWatch(tHalHostGpioWatch watch);
+extern void HalHostPower(tHalHostPower *power);
+extern void HalHostPowerReset(void);
+
+#endif /* HALHOST_H_ */
@@ -0,0 +1,62 @@
+//************************************************************************************
+//
+// Title:               Static Memory Arena and Block Pools - Host Port
+// Author:              Jacob Putz
+// Filename:            MemHost.c
+//
+// Description:     Static arena the size of the target's ARENA region and a
+//                      compare-and-swap on the compiler's atomic builtins, so the pools
+//                      can be exercised from several host threads.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Mem.h"
+
+// Defines
+#define     MEM_HOST_ARENA_BYTES    0x00010000  // ARENA in tm4c1294ncpdt.cmd
+
+// Global Variables
+static uint8_t g_memHostArena[MEM_HOST_ARENA_BYTES] __attribute__((aligned(MEM_ALIGN)));
+
+void MemPortArena(uint8_t **base, uint32_t *size) {
+
+    *base = g_memHostArena;
+    *size = MEM_HOST_ARENA_BYTES;
+
+}
+
+bool MemPortCas(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+
+    return __atomic_compare_exchange_n(word, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+
+}
@@ -0,0 +1,97 @@
+//************************************************************************************
+//
+// Title:               FSELECT/PSELECT Modulator - Host Port
+// Author:              Jacob Putz
+// Filename:            ModulationHost.c
+//
+// Description:     Host port for Modulation.c.  A periodic HAL timer stands in for
+//                      the Timer 1A uDMA trigger and writes one symbol per expiry to
+//                      the Port K pins.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Wait for the peripherals the target port brings up.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Modulation.h"
+
+// Defines
+#define     MOD_TIMER               HAL_TIMER_1
+
+// Global Variables
+static uint32_t g_modSlot = 0;
+static uint32_t g_modSymbol = 0;
+
+static void ModulationTimerHandler(void) {
+
+    tModulator *mod = &g_modulator;
+
+    HalGpioWrite(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT,
+                 mod->table[g_modSlot][g_modSymbol]);
+
+    if (++g_modSymbol == MOD_BLOCK_SYMBOLS) {
+
+        g_modSymbol = 0;
+        g_modSlot ^= 1;
+        ModulationBlockDone(mod);
+
+    }
+
+}
+
+void ModulationPortInit(uint32_t sysClkHz) {
+
+    (void)sysClkHz;
+
+    HalPeriphReady(MOD_PERIPHS);
+    HalGpioOutputInit(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT, 8);
+    HalTimerInit(MOD_TIMER, ModulationTimerHandler);
+
+}
+
+void ModulationPortStart(tModulator *mod) {
+
+    g_modSlot = 0;
+    g_modSymbol = 0;
+
+    HalTimerStart(MOD_TIMER, mod->symbolCycles, true);
+
+}
+
+void ModulationPortStop(tModulator *mod) {
+
+    (void)mod;
+
+    HalTimerStop(MOD_TIMER);
+    HalGpioWrite(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT, 0x0);
+
+}
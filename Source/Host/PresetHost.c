@@ -0,0 +1,77 @@
+//************************************************************************************
+//
+// Title:               Flash Preset Store - Host Port
+// Author:              Jacob Putz
+// Filename:            PresetHost.c
+//
+// Description:     Loads a preset image file named by DDS_SIM_PRESETS in place of
+//                      the PRESETS flash region.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Preset.h"
+
+// Global Variables
+//
+// Word array so the image has the same alignment it would have in flash.
+//
+static uint32_t g_presetHostFlash[PRESET_FLASH_SIZE / sizeof(uint32_t)];
+
+const tPresetImage *PresetPortImage(void) {
+
+    const char *path = getenv("DDS_SIM_PRESETS");
+    FILE *file;
+    size_t length;
+
+    if (path == 0) {
+
+        return 0;
+
+    }
+
+    file = fopen(path, "rb");
+
+    if (file == 0) {
+
+        fprintf(stderr, "presets: cannot open %s\n", path);
+        return 0;
+
+    }
+
+    length = fread(g_presetHostFlash, 1, sizeof(g_presetHostFlash), file);
+    fclose(file);
+
+    return (length >= sizeof(tPresetImage)) ? (const tPresetImage *)g_presetHostFlash : 0;
+
+}
@@ -0,0 +1,151 @@
+//************************************************************************************
+//
+// Title:               DDS Command Recorder - Host Port
+// Author:              Jacob Putz
+// Filename:            RecordHost.c
+//
+// Description:     Writes the trace to a file for Host/Tools/ReplayTool.c.  The ring
+//                      is drained to the file as the simulation runs, so a capture
+//                      is not limited to what fits in RECORD_WORDS.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "DDSChip.h"
+#include "Record.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  DDS_SIM_RECORD=<path> records from start-up and writes the trace file there.
+//  The ring is drained every RECORD_HOST_DRAIN_US of simulated time, which keeps
+//  up with a saturated remote link, and once more at exit, when the header is
+//  completed.  Without DDS_SIM_RECORD nothing is recorded and no task is added.
+//
+//************************************************************************************
+
+// Defines
+#define     RECORD_HOST_DRAIN_US    10000
+#define     RECORD_HOST_CHUNK       512
+
+// Global Variables
+static FILE *g_recordHostFile = 0;
+static tRecord *g_recordHostRecord = 0;
+static uint32_t g_recordHostWords = 0;
+static tSchedTask g_recordHostTask;
+
+static void RecordHostDrain(tRecord *record) {
+
+    uint16_t words[RECORD_HOST_CHUNK];
+    uint32_t count;
+
+    while ((count = RecordRead(record, 0, words, RECORD_HOST_CHUNK)) != 0) {
+
+        fwrite(words, sizeof(uint16_t), count, g_recordHostFile);
+        g_recordHostWords += count;
+        RecordConsume(record, count);
+
+    }
+
+}
+
+static void RecordHostWriteHeader(const tRecord *record) {
+
+    tRecordFileHeader header;
+
+    header.magic = RECORD_FILE_MAGIC;
+    header.version = RECORD_FILE_VERSION;
+    header.chips = DDS_CHIP;
+    header.words = g_recordHostWords;
+    header.flags = ((record->overwritten != 0) || record->full) ? RECORD_FILE_LOST : 0;
+
+    fseek(g_recordHostFile, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, g_recordHostFile);
+    fseek(g_recordHostFile, 0, SEEK_END);
+
+}
+
+static void RecordHostTask(tSchedTask *task, uint64_t now) {
+
+    (void)now;
+
+    RecordHostDrain((tRecord *)task->arg);
+    SchedulerDefer(task, RECORD_HOST_DRAIN_US);
+
+}
+
+static void RecordHostExit(void) {
+
+    tRecord *record = g_recordHostRecord;
+
+    RecordHostDrain(record);
+    RecordHostWriteHeader(record);
+    fclose(g_recordHostFile);
+
+    printf("record: %u words, %u entries%s\n", g_recordHostWords, record->entries,
+           record->full ? " (stopped when the ring filled)" : "");
+
+}
+
+void RecordPortInit(tRecord *record) {
+
+    const char *path = getenv("DDS_SIM_RECORD");
+
+    if (path == 0) {
+
+        return;
+
+    }
+
+    g_recordHostFile = fopen(path, "wb");
+
+    if (g_recordHostFile == 0) {
+
+        fprintf(stderr, "record: cannot create %s\n", path);
+        return;
+
+    }
+
+    g_recordHostRecord = record;
+    RecordHostWriteHeader(record);
+    RecordStart(record, 0);
+
+    SchedulerTaskInit(&g_recordHostTask, RecordHostTask, record);
+    SchedulerAdd(&g_recordHostTask, TimeBaseMicros() + RECORD_HOST_DRAIN_US);
+
+    atexit(RecordHostExit);
+
+}
@@ -0,0 +1,402 @@
+//************************************************************************************
+//
+// Title:               Remote Control Protocol - Host Port
+// Author:              Jacob Putz
+// Filename:            RemoteHost.c
+//
+// Description:     Runs the protocol over a file descriptor in place of UART0: a
+//                      pty or FIFO named by DDS_SIM_REMOTE, or an inherited descriptor
+//                      (a socketpair end) given as a number, or a scripted session
+//                      named by DDS_SIM_SESSION.  Without either the link is absent
+//                      and replies are discarded.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Add scripted sessions (DDS_SIM_SESSION).
+//
+// 0.1.1    -       Wait for the peripherals the target port brings up.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  DDS_SIM_SESSION=<path> takes the place of DDS_SIM_REMOTE with a text file of
+//  commands, one per line:
+//
+//      <ms> <cmd> [payload ...]        # comment
+//
+//  ms is the simulated time in milliseconds (decimal) at which the command arrives,
+//  and cmd and the payload are hex bytes, multi-byte fields least significant byte
+//  first as on the wire.  The port frames each command with the next sequence
+//  number and its CRC, and hands it over whole once its time has passed; replies
+//  are discarded.  A malformed file stops the simulator with exit status 2.
+//
+//************************************************************************************
+
+// Includes
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Crc.h"
+#include "Remote.h"
+#include "TimeBase.h"
+
+// Defines
+#define     REMOTE_HOST_IDLE_MS     1           // Longest wait for input per poll
+#define     REMOTE_HOST_LINE_MAX    256
+
+// Type Definitions
+typedef struct {
+
+    uint64_t timeUs;
+    uint8_t frame[REMOTE_FRAME_MAX];
+    uint32_t bytes;
+
+} tRemoteHostCommand;
+
+// Global Variables
+static int g_remoteHostFd = -1;
+static uint32_t g_remoteHostRxHead;
+
+static tRemoteHostCommand *g_remoteHostSession;
+static uint32_t g_remoteHostSessionCount;
+static uint32_t g_remoteHostSessionNext;
+
+//************************************************************************************
+//
+// Parse one session line into a framed command.  Returns false if it is malformed;
+// blank and comment lines leave command->bytes zero.
+//
+//************************************************************************************
+static bool RemoteHostParse(char *line, uint8_t seq, tRemoteHostCommand *command) {
+
+    uint8_t bytes[1 + REMOTE_PAYLOAD_MAX];
+    uint32_t count = 0;
+    unsigned long value;
+    char *next, *end;
+    uint32_t crc, i;
+
+    command->bytes = 0;
+    line[strcspn(line, "#")] = '\0';
+    value = strtoul(line, &end, 10);
+
+    if (end == line) {
+
+        return line[strspn(line, " \t\r\n")] == '\0';
+
+    }
+
+    command->timeUs = (uint64_t)value * 1000;
+
+    for (next = end; ; next = end) {
+
+        value = strtoul(next, &end, 16);
+
+        if (end == next) {
+
+            break;
+
+        }
+
+        if ((value > 0xFF) || (count == sizeof(bytes))) {
+
+            return false;
+
+        }
+
+        bytes[count++] = (uint8_t)value;
+
+    }
+
+    if ((count == 0) || (next[strspn(next, " \t\r\n")] != '\0')) {
+
+        return false;
+
+    }
+
+    command->frame[0] = REMOTE_SYNC0;
+    command->frame[1] = REMOTE_SYNC1;
+    command->frame[2] = seq;
+    command->frame[3] = bytes[0];
+    command->frame[4] = (uint8_t)(count - 1);
+    memcpy(&command->frame[REMOTE_HEADER_BYTES], &bytes[1], count - 1);
+    command->bytes = REMOTE_HEADER_BYTES + count - 1;
+
+    crc = Crc32(CRC32_INIT, &command->frame[2], command->bytes - 2);
+
+    for (i = 0; i < REMOTE_CRC_BYTES; i++) {
+
+        command->frame[command->bytes++] = (uint8_t)(crc >> (8 * i));
+
+    }
+
+    return true;
+
+}
+
+static void RemoteHostLoad(const char *path) {
+
+    char line[REMOTE_HOST_LINE_MAX];
+    tRemoteHostCommand command;
+    uint32_t number = 0;
+    FILE *file = fopen(path, "r");
+
+    if (file == 0) {
+
+        fprintf(stderr, "remote: cannot open %s\n", path);
+        exit(2);
+
+    }
+
+    while (fgets(line, sizeof(line), file) != 0) {
+
+        number++;
+
+        if (!RemoteHostParse(line, (uint8_t)g_remoteHostSessionCount, &command)) {
+
+            fprintf(stderr, "remote: %s:%u: malformed command\n", path, number);
+            exit(2);
+
+        }
+
+        if (command.bytes != 0) {
+
+            g_remoteHostSession = realloc(g_remoteHostSession,
+                                          (g_remoteHostSessionCount + 1) *
+                                          sizeof(tRemoteHostCommand));
+            g_remoteHostSession[g_remoteHostSessionCount++] = command;
+
+        }
+
+    }
+
+    fclose(file);
+
+}
+
+void RemotePortInit(tRemote *remote, uint32_t sysClkHz, uint32_t baud) {
+
+    const char *link = getenv("DDS_SIM_REMOTE");
+    const char *session = getenv("DDS_SIM_SESSION");
+
+    (void)remote;
+    (void)sysClkHz;
+    (void)baud;
+
+    HalPeriphReady(REMOTE_PERIPHS);
+
+    g_remoteHostRxHead = 0;
+
+    if (session != 0) {
+
+        RemoteHostLoad(session);
+        return;
+
+    }
+
+    if (link == 0) {
+
+        return;
+
+    }
+
+    g_remoteHostFd = isdigit((unsigned char)link[0]) ? atoi(link) :
+                                                       open(link, O_RDWR | O_NOCTTY);
+
+    if (g_remoteHostFd < 0) {
+
+        fprintf(stderr, "remote: cannot open %s\n", link);
+        return;
+
+    }
+
+    fcntl(g_remoteHostFd, F_SETFL, fcntl(g_remoteHostFd, F_GETFL) | O_NONBLOCK);
+
+}
+
+//************************************************************************************
+//
+// Hand over the session's commands that are due and fit in the ring.
+//
+//************************************************************************************
+static void RemoteHostSession(tRemote *remote) {
+
+    const tRemoteHostCommand *command;
+    uint64_t now = TimeBaseMicros();
+    uint32_t i;
+
+    while (g_remoteHostSessionNext < g_remoteHostSessionCount) {
+
+        command = &g_remoteHostSession[g_remoteHostSessionNext];
+
+        if ((command->timeUs > now) ||
+            ((REMOTE_RX_SIZE - (g_remoteHostRxHead - remote->rxTail)) < command->bytes)) {
+
+            break;
+
+        }
+
+        for (i = 0; i < command->bytes; i++) {
+
+            remote->rx[(g_remoteHostRxHead + i) & REMOTE_RX_MASK] = command->frame[i];
+
+        }
+
+        g_remoteHostRxHead += command->bytes;
+        g_remoteHostSessionNext++;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Read whatever is waiting, limited to the free space in the ring; the kernel
+// buffer stands in for the UART FIFO, so nothing is lost.  Simulated time only
+// moves when the firmware sleeps, so when the link is quiet this waits briefly for
+// input to keep the simulation from racing ahead of the other end.
+//
+//************************************************************************************
+uint32_t RemotePortRxHead(tRemote *remote) {
+
+    struct pollfd fds;
+    uint32_t space, offset;
+    ssize_t got;
+
+    if (g_remoteHostSession != 0) {
+
+        RemoteHostSession(remote);
+        return g_remoteHostRxHead;
+
+    }
+
+    if (g_remoteHostFd < 0) {
+
+        return g_remoteHostRxHead;
+
+    }
+
+    fds.fd = g_remoteHostFd;
+    fds.events = POLLIN;
+
+    if ((remote->txHead == remote->txTail) &&
+        (g_remoteHostRxHead == remote->rxTail)) {
+
+        poll(&fds, 1, REMOTE_HOST_IDLE_MS);
+
+    }
+
+    for (;;) {
+
+        space = REMOTE_RX_SIZE - (g_remoteHostRxHead - remote->rxTail);
+        offset = g_remoteHostRxHead & REMOTE_RX_MASK;
+
+        if (space > (REMOTE_RX_SIZE - offset)) {
+
+            space = REMOTE_RX_SIZE - offset;
+
+        }
+
+        if (space == 0) {
+
+            break;
+
+        }
+
+        got = read(g_remoteHostFd, &remote->rx[offset], space);
+
+        if (got <= 0) {
+
+            break;
+
+        }
+
+        g_remoteHostRxHead += (uint32_t)got;
+
+    }
+
+    return g_remoteHostRxHead;
+
+}
+
+void RemotePortTxKick(tRemote *remote) {
+
+    uint32_t tail = remote->txTail;
+    uint32_t offset, count;
+    ssize_t put;
+
+    while (tail != remote->txHead) {
+
+        offset = tail & REMOTE_TX_MASK;
+        count = remote->txHead - tail;
+
+        if (count > (REMOTE_TX_SIZE - offset)) {
+
+            count = REMOTE_TX_SIZE - offset;
+
+        }
+
+        if (g_remoteHostFd < 0) {
+
+            put = (ssize_t)count;
+
+        }
+
+        else {
+
+            put = write(g_remoteHostFd, &remote->tx[offset], count);
+
+            if ((put < 0) && (errno == EAGAIN)) {
+
+                break;
+
+            }
+
+            if (put < 0) {
+
+                put = (ssize_t)count;
+
+            }
+
+        }
+
+        tail += (uint32_t)put;
+
+    }
+
+    remote->txTail = tail;
+
+}
@@ -0,0 +1,128 @@
+//************************************************************************************
+//
+// Title:               uDMA SSI Frame Stream - Host Port
+// Author:              Jacob Putz
+// Filename:            SSIStreamHost.c
+//
+// Description:     Host port for SSIStream.c.  An armed slot is written to the HAL
+//                      capture at once and the completion interrupt is pended, so the
+//                      portable ring logic runs exactly as it does against the uDMA.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Record the SSI bit period as the target port does.
+//
+// 0.1.1    -       Wait for the peripherals the target port brings up.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "SSIStream.h"
+
+// Global Constants
+static const uint32_t g_ssiStreamHostSsi[SSISTREAM_COUNT] = { HAL_SSI_0, HAL_SSI_3 };
+static const uint32_t g_ssiStreamHostInt[SSISTREAM_COUNT] = {
+
+    HAL_INT_SSI0, HAL_INT_SSI3
+
+};
+
+static void SSIStreamAD9834Handler(void) {
+
+    SSIStreamService(&g_ssiStreams[SSISTREAM_AD9834]);
+
+}
+
+static void SSIStreamAD9952Handler(void) {
+
+    SSIStreamService(&g_ssiStreams[SSISTREAM_AD9952]);
+
+}
+
+void SSIStreamPortInit(tSSIStream *stream, uint32_t sysClkHz, uint32_t bitRate) {
+
+    uint32_t instance = stream->instance;
+
+    HalPeriphReady(SSISTREAM_PERIPHS(instance));
+
+    if (instance == SSISTREAM_AD9834) {
+
+        HalSsiInit(HAL_SSI_0, sysClkHz, bitRate, HAL_SSI_MODE_2, 16);
+        HalIntRegister(HAL_INT_SSI0, SSIStreamAD9834Handler);
+
+    }
+
+    else {
+
+        HalSsiInit(HAL_SSI_3, sysClkHz, bitRate, HAL_SSI_MODE_0, 8);
+        HalIntRegister(HAL_INT_SSI3, SSIStreamAD9952Handler);
+
+    }
+
+    HalIntEnable(g_ssiStreamHostInt[instance]);
+    stream->bitCycles = (sysClkHz + bitRate - 1) / bitRate;
+
+}
+
+void SSIStreamPortArm(tSSIStream *stream, uint32_t slot, const uint16_t *src,
+                      uint32_t count) {
+
+    uint32_t i;
+
+    (void)slot;
+
+    for (i = 0; i < count; i++) {
+
+        HalSsiPut(g_ssiStreamHostSsi[stream->instance], src[i]);
+
+    }
+
+    HalIntPend(g_ssiStreamHostInt[stream->instance]);
+
+}
+
+//************************************************************************************
+//
+// Transfers finish inside SSIStreamPortArm(), so both slots always read as stopped.
+//
+//************************************************************************************
+uint32_t SSIStreamPortStoppedSlots(tSSIStream *stream) {
+
+    (void)stream;
+
+    return (1 << SSISTREAM_SLOT_PRI) | (1 << SSISTREAM_SLOT_ALT);
+
+}
+
+void SSIStreamPortKick(tSSIStream *stream) {
+
+    HalIntPend(g_ssiStreamHostInt[stream->instance]);
+
+}
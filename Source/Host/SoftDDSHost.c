@@ -0,0 +1,108 @@
+//************************************************************************************
+//
+// Title:               Software DDS Model - Host Port
+// Author:              Jacob Putz
+// Filename:            SoftDDSHost.c
+//
+// Description:     SSE2 renderer for the software DDS.  PMADDWD is the x86
+//                      counterpart of SMLAD, so eight samples per iteration take two
+//                      table gathers of four words, two PMADDWDs and one saturating
+//                      pack.  Builds without SSE2 fall back to the reference.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdint.h>
+#include "SoftDDS.h"
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+//************************************************************************************
+//
+// Four samples from four consecutive accumulator values held in phases.  The
+// table reads are scalar (SSE2 has no gather), everything else is vector.
+//
+//************************************************************************************
+static inline __m128i SoftDDSHostFour(__m128i phases) {
+
+    uint32_t index[4];
+    __m128i pairs, frac, weights;
+
+    _mm_storeu_si128((__m128i *)index, _mm_srli_epi32(phases, SOFTDDS_INDEX_SHIFT));
+    pairs = _mm_set_epi32((int)g_softDDSPairs[index[3]], (int)g_softDDSPairs[index[2]],
+                          (int)g_softDDSPairs[index[1]], (int)g_softDDSPairs[index[0]]);
+
+    frac = _mm_and_si128(_mm_srli_epi32(phases, SOFTDDS_FRAC_SHIFT),
+                         _mm_set1_epi32(SOFTDDS_FRAC_MASK));
+    weights = _mm_or_si128(_mm_slli_epi32(frac, 16),
+                           _mm_sub_epi32(_mm_set1_epi32(SOFTDDS_ONE), frac));
+
+    return _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(pairs, weights),
+                                        _mm_set1_epi32(SOFTDDS_ONE / 2)),
+                          SOFTDDS_FRAC_BITS);
+
+}
+
+void SoftDDSRender(tSoftDDS *dds, int16_t *samples, uint32_t count) {
+
+    uint32_t step = dds->step;
+    __m128i phases;
+    __m128i step4 = _mm_set1_epi32((int)(step * 4));
+    __m128i lo, hi;
+    uint32_t i;
+
+    phases = _mm_set_epi32((int)(dds->phase + 3 * step), (int)(dds->phase + 2 * step),
+                           (int)(dds->phase + step), (int)dds->phase);
+
+    for (i = 0; (i + 8) <= count; i += 8) {
+
+        lo = SoftDDSHostFour(phases);
+        phases = _mm_add_epi32(phases, step4);
+        hi = SoftDDSHostFour(phases);
+        phases = _mm_add_epi32(phases, step4);
+        _mm_storeu_si128((__m128i *)&samples[i], _mm_packs_epi32(lo, hi));
+
+    }
+
+    dds->phase += i * step;
+    SoftDDSRenderRef(dds, &samples[i], count - i);
+
+}
+
+#else
+
+void SoftDDSRender(tSoftDDS *dds, int16_t *samples, uint32_t count) {
+
+    SoftDDSRenderRef(dds, samples, count);
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+//************************************************************************************
+//
+// Title:               Hardware-Timed Sweep Engine - Host Port
+// Author:              Jacob Putz
+// Filename:            SweepHost.c
+//
+// Description:     Host port for Sweep.c.  A periodic HAL timer stands in for the
+//                      Timer 0A uDMA trigger: each expiry writes one step record to the
+//                      SSI capture, and every SWEEP_BLOCK_STEPS steps the block is
+//                      handed back to SweepBlockDone().
+//
+// Current Revision:    0.1.3
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.3    -       Drive IO_UPDATE on PL4 at the start of each step, as the target
+//                  timer output does, and add SweepPortIOUpdate().
+//
+// 0.1.2    -       Wait for the peripherals the target port brings up.
+//
+// 0.1.1    -       Play step records in place from flash (execute-in-place presets).
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+// Defines
+#define     SWEEP_TIMER             HAL_TIMER_0
+#define     SWEEP_IOUPDATE_CYCLES   16
+
+// Global Variables
+static tSweep *g_sweepActive = 0;
+static const uint16_t *g_sweepArmed[2];
+static uint32_t g_sweepSlot = 0;
+static uint32_t g_sweepStep = 0;
+
+static void SweepTimerHandler(void) {
+
+    tSweep *sweep = g_sweepActive;
+    const uint16_t *record;
+    uint32_t ssi;
+    uint32_t i;
+
+    if (sweep == 0) {
+
+        return;
+
+    }
+
+    //
+    // IO_UPDATE rises at the start of each step and latches the record shifted
+    // during the previous one.  Time does not move inside a timer handler, so the
+    // pulse has no width here.
+    //
+    HalGpioWrite(HAL_PORT_L, HAL_PIN_4, HAL_PIN_4);
+    HalGpioWrite(HAL_PORT_L, HAL_PIN_4, 0);
+
+    ssi = (sweep->instance == SSISTREAM_AD9834) ? HAL_SSI_0 : HAL_SSI_3;
+    record = &g_sweepArmed[g_sweepSlot][g_sweepStep * sweep->elemsPerStep];
+
+    for (i = 0; i < sweep->elemsPerStep; i++) {
+
+        HalSsiPut(ssi, record[i]);
+
+    }
+
+    if (++g_sweepStep == SWEEP_BLOCK_STEPS) {
+
+        g_sweepStep = 0;
+        g_sweepArmed[g_sweepSlot] = SweepBlockSource(sweep, sweep->blocksDone + 2);
+        g_sweepSlot ^= 1;
+        SweepBlockDone(sweep);
+
+    }
+
+}
+
+void SweepPortInit(uint32_t sysClkHz) {
+
+    (void)sysClkHz;
+
+    HalPeriphReady(SWEEP_PERIPHS);
+    HalTimerInit(SWEEP_TIMER, SweepTimerHandler);
+
+}
+
+void SweepPortStart(tSweep *sweep) {
+
+    g_sweepActive = sweep;
+    g_sweepArmed[0] = SweepBlockSource(sweep, 0);
+    g_sweepArmed[1] = SweepBlockSource(sweep, 1);
+    g_sweepSlot = 0;
+    g_sweepStep = 0;
+
+    HalTimerStart(SWEEP_TIMER, sweep->stepCycles, true);
+
+}
+
+void SweepPortStop(tSweep *sweep) {
+
+    (void)sweep;
+
+    HalTimerStop(SWEEP_TIMER);
+    g_sweepActive = 0;
+
+}
+
+void SweepPortIOUpdate(void) {
+
+    HalGpioWrite(HAL_PORT_L, HAL_PIN_4, HAL_PIN_4);
+    HalDelayCycles(SWEEP_IOUPDATE_CYCLES);
+    HalGpioWrite(HAL_PORT_L, HAL_PIN_4, 0);
+
+}
@@ -0,0 +1,808 @@
+//************************************************************************************
+//
+// Title:               Boot Timeline and Check
+// Author:              Jacob Putz
+// Filename:            BootTool.c
+//
+// Description:     Runs the firmware's start-up on the host simulator, stage by
+//                      stage, either through the boot sequencer (Boot.h) or in the
+//                      serial order main() used before it, and reports when the
+//                      first DDS frame went out, when the critical stages were done
+//                      and when the board was ready.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Pack preset step records with phase 0.
+//
+// 0.1.3    -       Take the clock from Boot.h.
+//
+// 0.1.2    -       Boot an AD9952 sweep preset on builds without the AD9834.
+//
+// 0.1.1    -       Built by Host/Makefile.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/boot_tool.
+//
+//  Usage:
+//
+//      boot_tool timeline [serial]     stage by stage, sequenced or serial
+//      boot_tool bench [boots]         milestones averaged over several boots
+//      boot_tool check                 ordering, waits, boot preset, bad tables
+//
+//  Every boot runs in a child process, so each one starts from a power-up: fresh
+//  simulator, zeroed globals, an invalid fault snapshot.  The preset store is a
+//  generated image (DDS_SIM_PRESETS) with a boot preset, whose setup frames are
+//  the first frames on its part's SSI, and a filler preset that makes the image
+//  BOOT_TOOL_FILLER bytes long so the store's CRC costs what a full one would.
+//  The boot preset is FSK on the AD9834, or a repeating sweep on the AD9952 when
+//  the AD9834 is not built (DDS_CHIP).
+//
+//  Each stage's run function is wrapped.  The simulator charges no cycles for the
+//  firmware's own work, only for waiting on the clock and the peripherals, so a
+//  stage's time here is its host CPU time plus its peripheral wait at the system
+//  clock.  The serial boot is the stage run functions called in main()'s old
+//  order straight after HalClockInit(), with no clock gates opened early: each
+//  port then enables and waits for its own peripherals.  The LED set-up main()
+//  still does itself is left out of both.
+//
+//  Times are from the end of the clock set-up.  "first frame" is the end of the
+//  stage during which the first frame was sent, "critical" the end of the last
+//  critical stage, "ready" the end of the last stage.  Host times are only good
+//  for comparing the two orders on this machine; on the target g_boot.times holds
+//  the DWT cycles of each stage.
+//
+//  check passes if the firmware's table is valid, every critical stage runs
+//  before every deferred one, the sequenced boot never waits for a peripheral
+//  while the serial one does, both end with the boot preset playing, and tables
+//  with a critical stage depending on a deferred one, a dependency cycle or a
+//  dependency outside the table are rejected and still run every stage, in table
+//  order.  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Boot.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Modulation.h"
+#include "Preset.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+// Defines
+#define     BOOT_TOOL_BOOTS         20
+#define     BOOT_TOOL_FILLER        0x20000     // Bytes of filler preset data
+#define     BOOT_TOOL_BITS          64          // Boot preset symbols
+#define     BOOT_TOOL_SYMBOL        1200        // Cycles per symbol (100 kBd)
+#define     BOOT_TOOL_SETUP         5
+#define     BOOT_TOOL_FREQ0         0x0222222   // FSK tuning words
+#define     BOOT_TOOL_FREQ1         0x0444444
+#define     BOOT_TOOL_STEP          12000       // Cycles per sweep step (AD9952)
+#define     BOOT_TOOL_NONE          0xFF
+
+// Type Definitions
+typedef struct {
+
+    tPresetImage header;
+    tPresetIndex index[2];
+    tPreset boot;
+    tPreset filler;
+    uint16_t setup[BOOT_TOOL_SETUP + 1];            // Keeps bits 4-aligned
+    uint8_t bits[BOOT_TOOL_BITS / 8];
+    uint16_t records[SWEEP_BLOCK_STEPS * AD9952_STEP_ELEMS];
+    uint8_t fill[BOOT_TOOL_FILLER];
+
+} tBootToolImage;
+
+typedef struct {
+
+    uint64_t start;                 // Nanoseconds from the clock
+    uint64_t host;                  // Host CPU time running the stage
+    uint32_t wait;                  // Cycles waiting for peripherals
+
+} tBootToolTime;
+
+//
+// What a child sends back.
+//
+typedef struct {
+
+    bool valid;                     // BootInit()'s verdict (sequenced boots)
+    bool playing;                   // The boot preset is running
+    uint32_t ran;
+    uint8_t order[BOOT_MAX_STAGES];
+    tBootToolTime times[BOOT_MAX_STAGES];
+    uint8_t firstStage;             // Stage the first frame went out in
+    uint64_t firstFrame;            // Nanoseconds, or 0 if none
+    uint64_t critical;
+    uint64_t ready;
+    uint32_t waits;                 // Peripheral wait cycles over all stages
+
+} tBootToolRun;
+
+// Global Constants
+//
+// The order main() ran the stages in before the sequencer
+//
+static const uint8_t g_bootToolSerial[BOOT_STAGE_COUNT] = {
+
+    BOOT_FAULT, BOOT_TIME, BOOT_MEM, BOOT_RECORD, BOOT_REMOTE, BOOT_LINK, BOOT_STREAMS,
+    BOOT_RESTORE, BOOT_SOFTDDS, BOOT_SWEEP, BOOT_MOD, BOOT_CALIB, BOOT_SYNC,
+    BOOT_PRESETS
+
+};
+
+// Global Variables
+static tBootToolImage g_bootToolImageData;
+static char g_bootToolImagePath[] = "/tmp/boot_toolXXXXXX";
+
+static tBootStage g_bootToolStages[BOOT_MAX_STAGES];    // Run functions wrapped
+static tBootFn g_bootToolRunFns[BOOT_MAX_STAGES];        // The wrapped ones
+static bool g_bootToolSequenced;
+static uint64_t g_bootToolNow;                           // Nanoseconds from the clock
+static tBootToolRun g_bootToolRun;
+
+//************************************************************************************
+//
+// Host CPU time in nanoseconds.
+//
+//************************************************************************************
+static uint64_t BootToolHostNs(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+
+}
+
+static uint64_t BootToolCyclesNs(uint64_t cycles) {
+
+    return (cycles * 1000000000ULL) / BOOT_SYS_CLK_HZ;
+
+}
+
+//************************************************************************************
+//
+// Run one stage and account for it.  In a sequenced boot BootRun() has already
+// waited for the stage's peripherals; anything the stage waits for itself shows
+// up as simulated cycles passing while it runs.
+//
+//************************************************************************************
+static void BootToolStage(uint32_t index) {
+
+    tBootToolRun *run = &g_bootToolRun;
+    tBootToolTime *time = &run->times[index];
+    tHalHostFrame frame;
+    uint64_t cycles, begin;
+    bool sent = false;
+
+    time->wait = g_bootToolSequenced ? g_boot.times[index].wait : 0;
+    g_bootToolNow += BootToolCyclesNs(time->wait);
+    time->start = g_bootToolNow;
+
+    cycles = HalHostCycles();
+    begin = BootToolHostNs();
+    g_bootToolRunFns[index]();
+    time->host = BootToolHostNs() - begin;
+    cycles = HalHostCycles() - cycles;
+
+    time->wait += (uint32_t)cycles;
+    g_bootToolNow += time->host + BootToolCyclesNs(cycles);
+    run->waits += time->wait;
+    run->order[run->ran++] = (uint8_t)index;
+
+    while (HalHostSsiRead(HAL_SSI_0, &frame) || HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+        sent = true;
+
+    }
+
+    if (sent && (run->firstStage == BOOT_TOOL_NONE)) {
+
+        run->firstStage = (uint8_t)index;
+        run->firstFrame = g_bootToolNow;
+
+    }
+
+    if ((g_bootStages[index].flags & BOOT_FLAG_DEFERRED) == 0) {
+
+        run->critical = g_bootToolNow;
+
+    }
+
+}
+
+#define BOOT_TOOL_WRAP(n)   static void BootToolStage##n(void) { BootToolStage(n); }
+
+BOOT_TOOL_WRAP(0)
+BOOT_TOOL_WRAP(1)
+BOOT_TOOL_WRAP(2)
+BOOT_TOOL_WRAP(3)
+BOOT_TOOL_WRAP(4)
+BOOT_TOOL_WRAP(5)
+BOOT_TOOL_WRAP(6)
+BOOT_TOOL_WRAP(7)
+BOOT_TOOL_WRAP(8)
+BOOT_TOOL_WRAP(9)
+BOOT_TOOL_WRAP(10)
+BOOT_TOOL_WRAP(11)
+BOOT_TOOL_WRAP(12)
+BOOT_TOOL_WRAP(13)
+BOOT_TOOL_WRAP(14)
+BOOT_TOOL_WRAP(15)
+
+static const tBootFn g_bootToolWraps[BOOT_MAX_STAGES] = {
+
+    BootToolStage0, BootToolStage1, BootToolStage2, BootToolStage3,
+    BootToolStage4, BootToolStage5, BootToolStage6, BootToolStage7,
+    BootToolStage8, BootToolStage9, BootToolStage10, BootToolStage11,
+    BootToolStage12, BootToolStage13, BootToolStage14, BootToolStage15
+
+};
+
+//************************************************************************************
+//
+// The preset image: a boot preset with its setup frames, and the filler.
+//
+//************************************************************************************
+static void BootToolBuildImage(void) {
+
+    tBootToolImage *image = &g_bootToolImageData;
+    uint32_t words[SWEEP_BLOCK_STEPS];
+    FILE *file;
+    int fd;
+    uint32_t i;
+
+    memset(image, 0, sizeof(*image));
+
+    image->header.magic = PRESET_MAGIC;
+    image->header.versionMajor = PRESET_VERSION_MAJOR;
+    image->header.versionMinor = PRESET_VERSION_MINOR;
+    image->header.count = 2;
+    image->header.imageSize = sizeof(*image);
+
+    image->index[0].id = PRESET_BOOT_ID;
+    image->index[0].offset = offsetof(tBootToolImage, boot);
+    image->index[1].id = PRESET_BOOT_ID + 1;
+    image->index[1].offset = offsetof(tBootToolImage, filler);
+
+    image->boot.flags = PRESET_FLAG_REPEAT;
+    image->boot.setupOffset = offsetof(tBootToolImage, setup);
+    image->boot.setupCount = BOOT_TOOL_SETUP;
+
+    if (DDSChipBuilt(SSISTREAM_AD9834)) {
+
+        image->setup[0] = AD9834_REG_CTRL | AD9834_CTRL_B28 | AD9834_CTRL_PIN_SW;
+        image->setup[1] = AD9834_REG_FREQ0 | (BOOT_TOOL_FREQ0 & AD9834_FREQ_HALF_MASK);
+        image->setup[2] = AD9834_REG_FREQ0 | (BOOT_TOOL_FREQ0 >> 14);
+        image->setup[3] = AD9834_REG_FREQ1 | (BOOT_TOOL_FREQ1 & AD9834_FREQ_HALF_MASK);
+        image->setup[4] = AD9834_REG_FREQ1 | (BOOT_TOOL_FREQ1 >> 14);
+
+        image->boot.type = PRESET_TYPE_MOD;
+        image->boot.instance = SSISTREAM_AD9834;
+        image->boot.mode = MOD_MODE_FSK;
+        image->boot.stepCycles = BOOT_TOOL_SYMBOL;
+        image->boot.dataOffset = offsetof(tBootToolImage, bits);
+        image->boot.dataCount = BOOT_TOOL_BITS;
+        strncpy(image->boot.name, "boot-fsk", PRESET_NAME_LEN);
+
+    }
+
+    else {
+
+        AD9952PackCFR1(image->setup, 0);
+
+        for (i = 0; i < SWEEP_BLOCK_STEPS; i++) {
+
+            words[i] = BOOT_TOOL_FREQ0 + (i * (BOOT_TOOL_FREQ1 - BOOT_TOOL_FREQ0) /
+                                          SWEEP_BLOCK_STEPS);
+
+        }
+
+        DDSChipPackRecords(SSISTREAM_AD9952, words, image->records, SWEEP_BLOCK_STEPS,
+                           0);
+
+        image->boot.type = PRESET_TYPE_SWEEP;
+        image->boot.instance = SSISTREAM_AD9952;
+        image->boot.stepCycles = BOOT_TOOL_STEP;
+        image->boot.dataOffset = offsetof(tBootToolImage, records);
+        image->boot.dataCount = SWEEP_BLOCK_STEPS * AD9952_STEP_ELEMS;
+        strncpy(image->boot.name, "boot-sweep", PRESET_NAME_LEN);
+
+    }
+
+    image->filler = image->boot;
+    image->filler.flags = 0;
+    image->filler.setupCount = 0;
+    image->filler.dataOffset = offsetof(tBootToolImage, fill);
+    image->filler.dataCount = (image->boot.type == PRESET_TYPE_MOD) ?
+                              (BOOT_TOOL_FILLER * 8) : (BOOT_TOOL_FILLER / 2);
+    strncpy(image->filler.name, "filler", PRESET_NAME_LEN);
+
+    for (i = 0; i < sizeof(image->bits); i++) {
+
+        image->bits[i] = 0xA5;
+
+    }
+
+    for (i = 0; i < sizeof(image->fill); i++) {
+
+        image->fill[i] = (uint8_t)(i * 7);
+
+    }
+
+    image->header.crc = Crc32(CRC32_INIT, (const uint8_t *)image + sizeof(tPresetImage),
+                              sizeof(*image) - sizeof(tPresetImage));
+
+    fd = mkstemp(g_bootToolImagePath);
+    file = (fd >= 0) ? fdopen(fd, "wb") : 0;
+
+    if ((file == 0) || (fwrite(image, sizeof(*image), 1, file) != 1)) {
+
+        fprintf(stderr, "boot_tool: cannot write %s\n", g_bootToolImagePath);
+        exit(2);
+
+    }
+
+    fclose(file);
+    setenv("DDS_SIM_PRESETS", g_bootToolImagePath, 1);
+
+}
+
+//************************************************************************************
+//
+// One boot in a child process.  With a table, the sequencer runs it; without, the
+// stages run in the serial order.
+//
+//************************************************************************************
+static void BootToolChild(const tBootStage *table, uint32_t count) {
+
+    tBootToolRun *run = &g_bootToolRun;
+    uint32_t i;
+
+    memset(run, 0, sizeof(*run));
+    run->firstStage = BOOT_TOOL_NONE;
+    g_bootToolNow = 0;
+    g_bootToolSequenced = (table != 0);
+
+    for (i = 0; i < BOOT_STAGE_COUNT; i++) {
+
+        g_bootToolRunFns[i] = g_bootStages[i].run;
+
+    }
+
+    if (table != 0) {
+
+        for (i = 0; i < count; i++) {
+
+            g_bootToolStages[i] = table[i];
+            g_bootToolStages[i].run = g_bootToolWraps[i];
+
+        }
+
+        run->valid = BootInit(&g_boot, g_bootToolStages, count);
+        BootClock(&g_boot, BOOT_SYS_CLK_HZ);
+        BootRun(&g_boot, false);
+        BootRun(&g_boot, true);
+
+    }
+
+    else {
+
+        BootClock(&g_boot, BOOT_SYS_CLK_HZ);
+
+        for (i = 0; i < BOOT_STAGE_COUNT; i++) {
+
+            g_bootToolWraps[g_bootToolSerial[i]]();
+
+        }
+
+    }
+
+    run->ready = g_bootToolNow;
+    run->playing = g_modulator.running || g_sweep.running;
+
+}
+
+static bool BootToolBoot(const tBootStage *table, uint32_t count, tBootToolRun *run) {
+
+    int pipes[2];
+    int status;
+    pid_t pid;
+    ssize_t got;
+
+    if (pipe(pipes) != 0) {
+
+        return false;
+
+    }
+
+    fflush(stdout);
+    pid = fork();
+
+    if (pid == 0) {
+
+        close(pipes[0]);
+        BootToolChild(table, count);
+        got = write(pipes[1], &g_bootToolRun, sizeof(g_bootToolRun));
+        _exit((got == (ssize_t)sizeof(g_bootToolRun)) ? 0 : 1);
+
+    }
+
+    close(pipes[1]);
+    got = (pid > 0) ? read(pipes[0], run, sizeof(*run)) : 0;
+    close(pipes[0]);
+
+    if (pid > 0) {
+
+        waitpid(pid, &status, 0);
+
+    }
+
+    return (got == (ssize_t)sizeof(*run));
+
+}
+
+//************************************************************************************
+//
+// timeline
+//
+//************************************************************************************
+static int BootToolTimeline(bool serial) {
+
+    tBootToolRun run;
+    const tBootToolTime *time;
+    uint32_t i, stage;
+
+    if (!BootToolBoot(serial ? 0 : g_bootStages, BOOT_STAGE_COUNT, &run)) {
+
+        fprintf(stderr, "boot_tool: boot failed\n");
+        return 1;
+
+    }
+
+    printf("%s boot, times in us from the clock\n\n", serial ? "serial" : "sequenced");
+    printf("  %-12s %-9s %10s %10s %12s\n", "stage", "phase", "start", "run", "wait cycles");
+
+    for (i = 0; i < run.ran; i++) {
+
+        stage = run.order[i];
+        time = &run.times[stage];
+
+        printf("  %-12s %-9s %10.2f %10.2f %12u%s\n", g_bootStages[stage].name,
+               ((g_bootStages[stage].flags & BOOT_FLAG_DEFERRED) != 0) ? "deferred" :
+                                                                         "critical",
+               time->start / 1000.0, time->host / 1000.0, time->wait,
+               (stage == run.firstStage) ? "   first frame" : "");
+
+    }
+
+    printf("\n");
+    printf("  first frame %10.2f us\n", run.firstFrame / 1000.0);
+    printf("  critical    %10.2f us\n", run.critical / 1000.0);
+    printf("  ready       %10.2f us\n", run.ready / 1000.0);
+    printf("  waits       %10u cycles\n", run.waits);
+    printf("  boot preset %s\n", run.playing ? "playing" : "NOT playing");
+
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static int BootToolBench(uint32_t boots) {
+
+    tBootToolRun run;
+    double first[2] = { 0 }, critical[2] = { 0 }, ready[2] = { 0 }, waits[2] = { 0 };
+    uint32_t mode, i;
+
+    for (i = 0; i < boots; i++) {
+
+        for (mode = 0; mode < 2; mode++) {
+
+            if (!BootToolBoot((mode == 0) ? 0 : g_bootStages, BOOT_STAGE_COUNT, &run)) {
+
+                fprintf(stderr, "boot_tool: boot failed\n");
+                return 1;
+
+            }
+
+            first[mode] += run.firstFrame / 1000.0;
+            critical[mode] += run.critical / 1000.0;
+            ready[mode] += run.ready / 1000.0;
+            waits[mode] += run.waits;
+
+        }
+
+    }
+
+    printf("%u boots each, mean us from the clock\n\n", boots);
+    printf("  %-10s %12s %12s %12s %12s\n", "", "first frame", "critical", "ready",
+           "wait cycles");
+
+    for (mode = 0; mode < 2; mode++) {
+
+        printf("  %-10s %12.2f %12.2f %12.2f %12.1f\n",
+               (mode == 0) ? "serial" : "sequenced", first[mode] / boots,
+               critical[mode] / boots, ready[mode] / boots, waits[mode] / boots);
+
+    }
+
+    printf("\n  sequenced: first frame %.2fx, critical %.2fx sooner\n",
+           (first[1] > 0) ? first[0] / first[1] : 0.0,
+           (critical[1] > 0) ? critical[0] / critical[1] : 0.0);
+
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static bool BootToolInOrder(const tBootToolRun *run, uint32_t count) {
+
+    uint32_t i;
+
+    if (run->ran != count) {
+
+        return false;
+
+    }
+
+    for (i = 0; i < count; i++) {
+
+        if (run->order[i] != i) {
+
+            return false;
+
+        }
+
+    }
+
+    return true;
+
+}
+
+static const char *BootToolBroken(uint32_t stage, uint32_t after) {
+
+    tBootStage table[BOOT_STAGE_COUNT];
+    tBootToolRun run;
+
+    memcpy(table, g_bootStages, sizeof(table));
+    table[stage].after |= after;
+
+    if (!BootToolBoot(table, BOOT_STAGE_COUNT, &run)) {
+
+        return "boot failed";
+
+    }
+
+    if (run.valid) {
+
+        return "accepted";
+
+    }
+
+    if (!BootToolInOrder(&run, BOOT_STAGE_COUNT)) {
+
+        return "stages not run in table order";
+
+    }
+
+    return 0;
+
+}
+
+static int BootToolCheck(void) {
+
+    tBootToolRun run;
+    const char *failure;
+    bool deferredSeen;
+    uint32_t failed = 0, i;
+
+    //
+    // Sequenced
+    //
+    failure = 0;
+
+    if (!BootToolBoot(g_bootStages, BOOT_STAGE_COUNT, &run)) {
+
+        failure = "boot failed";
+
+    }
+
+    else if (!run.valid) {
+
+        failure = "table rejected";
+
+    }
+
+    else if (run.ran != BOOT_STAGE_COUNT) {
+
+        failure = "stages missing";
+
+    }
+
+    else if (run.waits != 0) {
+
+        failure = "waited for a peripheral";
+
+    }
+
+    else if (!run.playing || (run.firstStage != BOOT_PRESETS)) {
+
+        failure = "boot preset not playing";
+
+    }
+
+    else {
+
+        deferredSeen = false;
+
+        for (i = 0; i < run.ran; i++) {
+
+            if ((g_bootStages[run.order[i]].flags & BOOT_FLAG_DEFERRED) != 0) {
+
+                deferredSeen = true;
+
+            }
+
+            else if (deferredSeen) {
+
+                failure = "critical stage after a deferred one";
+
+            }
+
+        }
+
+    }
+
+    printf("  %-28s %s%s\n", "sequenced", failure ? "FAIL: " : "ok", failure ? failure : "");
+    failed += (failure != 0);
+
+    //
+    // Serial, for comparison
+    //
+    failure = 0;
+
+    if (!BootToolBoot(0, BOOT_STAGE_COUNT, &run)) {
+
+        failure = "boot failed";
+
+    }
+
+    else if (run.waits == 0) {
+
+        failure = "no peripheral waits to save";
+
+    }
+
+    else if (!run.playing) {
+
+        failure = "boot preset not playing";
+
+    }
+
+    printf("  %-28s %s%s\n", "serial", failure ? "FAIL: " : "ok", failure ? failure : "");
+    failed += (failure != 0);
+
+    //
+    // Tables BootInit() must reject
+    //
+    failure = BootToolBroken(BOOT_STREAMS, BOOT_STAGE(BOOT_CALIB));
+    printf("  %-28s %s%s\n", "critical after deferred", failure ? "FAIL: " : "ok",
+           failure ? failure : "");
+    failed += (failure != 0);
+
+    failure = BootToolBroken(BOOT_MEM, BOOT_STAGE(BOOT_RECORD));
+    printf("  %-28s %s%s\n", "dependency cycle", failure ? "FAIL: " : "ok",
+           failure ? failure : "");
+    failed += (failure != 0);
+
+    failure = BootToolBroken(BOOT_SYNC, BOOT_STAGE(BOOT_STAGE_COUNT));
+    printf("  %-28s %s%s\n", "dependency outside table", failure ? "FAIL: " : "ok",
+           failure ? failure : "");
+    failed += (failure != 0);
+
+    printf("\n%s\n", (failed == 0) ? "PASS" : "FAIL");
+
+    return (failed == 0) ? 0 : 1;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t boots = BOOT_TOOL_BOOTS;
+    int result;
+
+    if (argc >= 3) {
+
+        boots = (uint32_t)strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) ||
+        ((strcmp(argv[1], "timeline") != 0) && (strcmp(argv[1], "check") != 0) &&
+         ((strcmp(argv[1], "bench") != 0) || (boots == 0)))) {
+
+        fprintf(stderr, "usage: %s timeline [serial] | bench [boots] | check\n", argv[0]);
+        return 2;
+
+    }
+
+    unsetenv("DDS_SIM_REMOTE");
+    unsetenv("DDS_SIM_TRACE");
+    BootToolBuildImage();
+
+    if (strcmp(argv[1], "timeline") == 0) {
+
+        result = BootToolTimeline((argc >= 3) && (strcmp(argv[2], "serial") == 0));
+
+    }
+
+    else if (strcmp(argv[1], "bench") == 0) {
+
+        result = BootToolBench(boots);
+
+    }
+
+    else {
+
+        result = BootToolCheck();
+
+    }
+
+    unlink(g_bootToolImagePath);
+
+    return result;
+
+}
@@ -0,0 +1,606 @@
+//************************************************************************************
+//
+// Title:               DDS Chip Front End Check and Bench
+// Author:              Jacob Putz
+// Filename:            DDSChipTool.c
+//
+// Description:     Checks the specialized per-part functions and the DDSChip front
+//                      end against a generic driver that looks up the part at run
+//                      time on every write, and measures the cost per write of each.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Pack and decode the phase word the step records now carry.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/chip_tool, with both parts unless DEFS
+//  sets DDS_CHIP (make DEFS=-DDDS_CHIP=1 build/chip_tool).
+//
+//  Usage:
+//
+//      chip_tool check                 every case below
+//      chip_tool bench [writes]        nanoseconds per step record write
+//
+//  The generic driver is one out-of-line write per step record that tests the
+//  part, takes its record length from a descriptor table and, on the AD9952,
+//  looks up each register's width through AD9952PackWrite().  That is the
+//  runtime choice DDSChip.h folds away.
+//
+//  records     random and edge words, in every count from 0 to a sweep block,
+//              are packed by the generic driver, by DDSChip<part>PackRecords()
+//              and, for each part built, by DDSChipPackRecords().  The records
+//              must be identical, decode back to the word (AD9834 FREQ0 halves,
+//              AD9952 FTW0 big-endian with POW0 holding the round's phase word,
+//              zero in the edge round), and leave the elements after the last
+//              record untouched.
+//  constants   DDSChipStepElems(), DDSChipStepBits(), DDSChipMaxStepRate() and
+//              DDSChipTuningInit() agree with the descriptor table for each part
+//              built.
+//  built       DDSChipBuilt() accepts exactly the instances in DDS_CHIP.
+//
+//  A negative control packs one word with its bit 14 flipped, the low bit of
+//  the AD9834's MSB half; the comparison must find the difference.  Exits 1 on
+//  any failure.
+//
+//  The bench times single writes, as a hop or a remote command makes them, and
+//  sweep blocks, for the generic driver, the front end with both parts built
+//  (one compare per call) and the per-part function a single-part build calls.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "DDSChip.h"
+#include "DDSTuning.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+// Defines
+#define     DDSCHIP_TOOL_SEED       0x5EED1234
+#define     DDSCHIP_TOOL_ROUNDS     64
+#define     DDSCHIP_TOOL_EDGES      8
+#define     DDSCHIP_TOOL_SENTINEL   0xA5A5
+#define     DDSCHIP_TOOL_BENCH      50000000
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint32_t refClkHz;
+    uint32_t freqBits;
+    uint32_t phaseBits;
+    uint32_t frameBits;
+    uint32_t stepElems;
+
+} tDDSChipToolPart;
+
+typedef void (*tDDSChipToolPacker)(uint32_t instance, const uint32_t *words,
+                                   uint16_t *record, uint32_t count,
+                                   uint32_t phase);
+
+// Global Constants
+static const tDDSChipToolPart g_ddsChipToolParts[SSISTREAM_COUNT] = {
+
+    { "AD9834", AD9834_MCLK_HZ, AD9834_FREQ_BITS, AD9834_PHASE_BITS, 16, 2 },
+    { "AD9952", AD9952_SYSCLK_HZ, AD9952_FREQ_BITS, AD9952_PHASE_BITS, 8, 8 }
+
+};
+
+// Global Variables
+static uint32_t g_ddsChipToolRandom = DDSCHIP_TOOL_SEED;
+static uint32_t g_ddsChipToolWords[SWEEP_BLOCK_STEPS];
+static uint32_t g_ddsChipToolPhase;
+static uint16_t g_ddsChipToolRef[(SWEEP_BLOCK_STEPS + 1) * SWEEP_ELEMS_MAX];
+static uint16_t g_ddsChipToolOut[(SWEEP_BLOCK_STEPS + 1) * SWEEP_ELEMS_MAX];
+
+//
+// Read through a volatile so no path is specialized by the compiler instead
+//
+static volatile uint32_t g_ddsChipToolInstance;
+
+//************************************************************************************
+//
+// Xorshift32, so every run checks the same words.
+//
+//************************************************************************************
+static uint32_t DDSChipToolRandom(void) {
+
+    uint32_t x = g_ddsChipToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_ddsChipToolRandom = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// The generic driver: one step record write, with the part chosen at run time.
+//
+//************************************************************************************
+static __attribute__((noinline)) void DDSChipToolGenericWrite(uint32_t instance,
+                                                              uint16_t *record,
+                                                              uint32_t word,
+                                                              uint32_t phase) {
+
+    if (instance == SSISTREAM_AD9834) {
+
+        record[0] = AD9834FrameFreqLSB(AD9834_REG_FREQ0, word);
+        record[1] = AD9834FrameFreqMSB(AD9834_REG_FREQ0, word);
+
+    }
+
+    else {
+
+        AD9952PackWrite(&record[0], AD9952_REG_FTW0, word);
+        AD9952PackWrite(&record[5], AD9952_REG_POW0, phase & AD9952_POW_MASK);
+
+    }
+
+}
+
+static void DDSChipToolGenericRecords(uint32_t instance, const uint32_t *words,
+                                      uint16_t *record, uint32_t count,
+                                      uint32_t phase) {
+
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+
+        DDSChipToolGenericWrite(instance, record, words[i], phase);
+        record += g_ddsChipToolParts[instance].stepElems;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The per-part specialized packers, as a single-part build calls them.
+//
+//************************************************************************************
+static void DDSChipToolAD9834Records(uint32_t instance, const uint32_t *words,
+                                     uint16_t *record, uint32_t count,
+                                     uint32_t phase) {
+
+    (void)instance;
+    DDSChipAD9834PackRecords(words, record, count, phase);
+
+}
+
+static void DDSChipToolAD9952Records(uint32_t instance, const uint32_t *words,
+                                     uint16_t *record, uint32_t count,
+                                     uint32_t phase) {
+
+    (void)instance;
+    DDSChipAD9952PackRecords(words, record, count, phase);
+
+}
+
+static const tDDSChipToolPacker g_ddsChipToolPartRecords[SSISTREAM_COUNT] = {
+
+    DDSChipToolAD9834Records,
+    DDSChipToolAD9952Records
+
+};
+
+//************************************************************************************
+//
+// Fill the word list: the edge words first, then random words of the part's width.
+// The phase word is zero with the edges and random in the other rounds.
+//
+//************************************************************************************
+static void DDSChipToolFillWords(uint32_t instance, uint32_t round) {
+
+    static const uint32_t edges[DDSCHIP_TOOL_EDGES] = {
+
+        0x00000000, 0x00000001, 0x00003FFF, 0x00004000,
+        0x0FFFFFFF, 0x10000000, 0x7FFFFFFF, 0xFFFFFFFF
+
+    };
+
+    uint32_t bits = g_ddsChipToolParts[instance].freqBits;
+    uint32_t mask = (bits >= 32) ? 0xFFFFFFFF : ((1UL << bits) - 1);
+    uint32_t i;
+
+    for (i = 0; i < SWEEP_BLOCK_STEPS; i++) {
+
+        g_ddsChipToolWords[i] = ((round == 0) && (i < DDSCHIP_TOOL_EDGES)) ?
+                                edges[i] : (DDSChipToolRandom() & mask);
+
+    }
+
+    g_ddsChipToolPhase = (round == 0) ? 0 : (DDSChipToolRandom() & AD9952_POW_MASK);
+
+}
+
+//************************************************************************************
+//
+// Number of count records in record that do not decode back to their words.
+//
+//************************************************************************************
+static uint32_t DDSChipToolDecode(uint32_t instance, const uint16_t *record,
+                                  uint32_t count) {
+
+    uint32_t bad = 0;
+    uint32_t word, i;
+
+    for (i = 0; i < count; i++) {
+
+        word = g_ddsChipToolWords[i];
+
+        if (instance == SSISTREAM_AD9834) {
+
+            bad += (((record[0] & 0xC000) != AD9834_REG_FREQ0) ||
+                    ((record[1] & 0xC000) != AD9834_REG_FREQ0) ||
+                    ((((uint32_t)(record[1] & 0x3FFF) << 14) |
+                      (record[0] & 0x3FFF)) != (word & 0x0FFFFFFF))) ? 1 : 0;
+
+        }
+
+        else {
+
+            bad += ((record[0] != AD9952_REG_FTW0) ||
+                    ((((uint32_t)record[1] << 24) | ((uint32_t)record[2] << 16) |
+                      ((uint32_t)record[3] << 8) | record[4]) != word) ||
+                    (record[5] != AD9952_REG_POW0) ||
+                    (record[6] != (g_ddsChipToolPhase >> 8)) ||
+                    (record[7] != (g_ddsChipToolPhase & 0xFF))) ? 1 : 0;
+
+        }
+
+        record += g_ddsChipToolParts[instance].stepElems;
+
+    }
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// Pack count records with packer into g_ddsChipToolOut over a sentinel fill, and
+// return the elements that differ from g_ddsChipToolRef or ran past the end.
+//
+//************************************************************************************
+static uint32_t DDSChipToolCompare(tDDSChipToolPacker packer, uint32_t instance,
+                                   uint32_t count) {
+
+    uint32_t elems = g_ddsChipToolParts[instance].stepElems;
+    uint32_t bad = 0;
+    uint32_t i;
+
+    for (i = 0; i < (sizeof(g_ddsChipToolOut) / sizeof(g_ddsChipToolOut[0])); i++) {
+
+        g_ddsChipToolOut[i] = DDSCHIP_TOOL_SENTINEL;
+
+    }
+
+    packer(instance, g_ddsChipToolWords, g_ddsChipToolOut, count,
+           g_ddsChipToolPhase);
+
+    for (i = 0; i < (count * elems); i++) {
+
+        bad += (g_ddsChipToolOut[i] != g_ddsChipToolRef[i]) ? 1 : 0;
+
+    }
+
+    for (i = count * elems; i < ((count + 1) * elems); i++) {
+
+        bad += (g_ddsChipToolOut[i] != DDSCHIP_TOOL_SENTINEL) ? 1 : 0;
+
+    }
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// records
+//
+//************************************************************************************
+static uint32_t DDSChipToolRecords(uint32_t instance) {
+
+    bool built = DDSChipBuilt(instance);
+    uint32_t writes = 0;
+    uint32_t bad = 0;
+    uint32_t round, count;
+
+    for (round = 0; round < DDSCHIP_TOOL_ROUNDS; round++) {
+
+        DDSChipToolFillWords(instance, round);
+
+        for (count = 0; count <= SWEEP_BLOCK_STEPS; count++) {
+
+            DDSChipToolGenericRecords(instance, g_ddsChipToolWords, g_ddsChipToolRef,
+                                      count, g_ddsChipToolPhase);
+            bad += DDSChipToolDecode(instance, g_ddsChipToolRef, count);
+            bad += DDSChipToolCompare(g_ddsChipToolPartRecords[instance], instance,
+                                      count);
+
+            if (built) {
+
+                bad += DDSChipToolCompare(DDSChipPackRecords, instance, count);
+
+            }
+
+            writes += count;
+
+        }
+
+    }
+
+    printf("  records        %s  %u writes%s  %u bad  %s\n",
+           g_ddsChipToolParts[instance].name, writes,
+           built ? ", front end too" : "", bad, (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// constants
+//
+//************************************************************************************
+static uint32_t DDSChipToolConstants(uint32_t instance) {
+
+    static const uint32_t bitRates[] = { 7, 1000000, 20000000, 60000000 };
+    static const uint64_t freqs[] = { 0, 1ULL << 32, 1234567ULL << 32,
+                                      (uint64_t)AD9834_MCLK_HZ << 31 };
+    const tDDSChipToolPart *part = &g_ddsChipToolParts[instance];
+    uint32_t stepBits = part->stepElems * (part->frameBits + 1);
+    tDDSTuning ref, tuning;
+    uint32_t bad = 0;
+    uint32_t i;
+
+    if (!DDSChipBuilt(instance)) {
+
+        printf("  constants      %s  not built\n", part->name);
+        return 0;
+
+    }
+
+    bad += (DDSChipStepElems(instance) != part->stepElems) ? 1 : 0;
+    bad += (DDSChipStepBits(instance) != stepBits) ? 1 : 0;
+
+    for (i = 0; i < (sizeof(bitRates) / sizeof(bitRates[0])); i++) {
+
+        bad += (DDSChipMaxStepRate(instance, bitRates[i]) !=
+                (bitRates[i] / stepBits)) ? 1 : 0;
+
+    }
+
+    bad += (DDSTuningInit(&ref, part->refClkHz, part->freqBits, part->phaseBits) !=
+            DDSChipTuningInit(instance, &tuning)) ? 1 : 0;
+    bad += ((tuning.freqBits != part->freqBits) ||
+            (tuning.phaseBits != part->phaseBits)) ? 1 : 0;
+
+    for (i = 0; i < (sizeof(freqs) / sizeof(freqs[0])); i++) {
+
+        bad += (DDSTuningFreqWord(&tuning, freqs[i]) !=
+                DDSTuningFreqWord(&ref, freqs[i])) ? 1 : 0;
+
+    }
+
+    printf("  constants      %s  %u elements, %u clocks a step  %u bad  %s\n",
+           part->name, DDSChipStepElems(instance), DDSChipStepBits(instance), bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// built
+//
+//************************************************************************************
+static uint32_t DDSChipToolBuilt(void) {
+
+    static const uint32_t instances[] = { 0, 1, 2, 3, 31, 32, 0xFFFFFFFF };
+    uint32_t bad = 0;
+    uint32_t i;
+    bool expect;
+
+    for (i = 0; i < (sizeof(instances) / sizeof(instances[0])); i++) {
+
+        expect = (instances[i] < SSISTREAM_COUNT) &&
+                 (((uint32_t)DDS_CHIP >> instances[i]) & 1);
+        bad += (DDSChipBuilt(instances[i]) != expect) ? 1 : 0;
+
+    }
+
+    printf("  built          DDS_CHIP %u  %u bad  %s\n", (uint32_t)DDS_CHIP, bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int DDSChipToolCheck(void) {
+
+    uint32_t bad = 0;
+    uint32_t differ, instance;
+    bool caught, pass;
+
+    DDSChipToolFillWords(SSISTREAM_AD9834, 1);
+    DDSChipToolGenericRecords(SSISTREAM_AD9834, g_ddsChipToolWords, g_ddsChipToolRef,
+                              SWEEP_BLOCK_STEPS, g_ddsChipToolPhase);
+    g_ddsChipToolWords[SWEEP_BLOCK_STEPS / 2] ^= 1UL << 14;
+    differ = DDSChipToolCompare(DDSChipToolAD9834Records, SSISTREAM_AD9834,
+                                SWEEP_BLOCK_STEPS);
+    caught = (differ != 0);
+    printf("  control        one word's bit 14 flipped, %u elements differ  %s\n\n",
+           differ, caught ? "caught" : "FAIL: missed");
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        bad += DDSChipToolRecords(instance);
+        bad += DDSChipToolConstants(instance);
+
+    }
+
+    bad += DDSChipToolBuilt();
+
+    pass = (bad == 0) && caught;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static double DDSChipToolTime(tDDSChipToolPacker packer, uint32_t count,
+                              uint32_t writes) {
+
+    struct timespec t0, t1;
+    uint32_t done;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (done = 0; done < writes; done += count) {
+
+        packer(g_ddsChipToolInstance, g_ddsChipToolWords, g_ddsChipToolOut, count,
+               g_ddsChipToolPhase);
+
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    //
+    // Keep the writes from being optimized away
+    //
+    if (g_ddsChipToolOut[0] == DDSCHIP_TOOL_SENTINEL) {
+
+        printf(" ");
+
+    }
+
+    return ((double)(t1.tv_sec - t0.tv_sec) * 1e9 +
+            (double)(t1.tv_nsec - t0.tv_nsec)) / done;
+
+}
+
+static int DDSChipToolBench(uint32_t writes) {
+
+    static const uint32_t counts[] = { 1, SWEEP_BLOCK_STEPS };
+    double generic, front, part;
+    uint32_t instance, i;
+
+    printf("  ns per step record write, DDS_CHIP %u\n", (uint32_t)DDS_CHIP);
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        DDSChipToolFillWords(instance, 1);
+        g_ddsChipToolInstance = instance;
+
+        for (i = 0; i < (sizeof(counts) / sizeof(counts[0])); i++) {
+
+            generic = DDSChipToolTime(DDSChipToolGenericRecords, counts[i], writes);
+            part = DDSChipToolTime(g_ddsChipToolPartRecords[instance], counts[i],
+                                   writes);
+
+            if (DDSChipBuilt(instance)) {
+
+                front = DDSChipToolTime(DDSChipPackRecords, counts[i], writes);
+                printf("  %s %3u a call  generic %6.2f  front end %6.2f  "
+                       "specialized %6.2f  %.1fx\n",
+                       g_ddsChipToolParts[instance].name, counts[i], generic, front,
+                       part, generic / part);
+
+            }
+
+            else {
+
+                printf("  %s %3u a call  generic %6.2f  front end   ----  "
+                       "specialized %6.2f  %.1fx\n",
+                       g_ddsChipToolParts[instance].name, counts[i], generic, part,
+                       generic / part);
+
+            }
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t writes = 0;
+
+    if (argc >= 3) {
+
+        writes = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (writes == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [writes]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return DDSChipToolCheck();
+
+    }
+
+    return DDSChipToolBench((writes != 0) ? writes : DDSCHIP_TOOL_BENCH);
+
+}
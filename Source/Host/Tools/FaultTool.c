@@ -0,0 +1,1434 @@
+//************************************************************************************
+//
+// Title:               Fault Snapshot and Warm Restart - Check and Decode Tool
+// Author:              Jacob Putz
+// Filename:            FaultTool.c
+//
+// Description:     Host command line tool that injects faults into the firmware
+//                      running on the simulated HAL, restarts it the way the target
+//                      does and checks against register models that the waveform
+//                      comes back without the outputs moving.  Also decodes crash
+//                      snapshots read back from a target.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Take the clock and rates from Boot.h.
+//
+// 0.1.3    -       Report with the common PASS/FAIL lines.
+//
+// 0.1.2    -       Model the AD9952 I/O buffer and its IO_UPDATE latch, and check
+//                  only the parts that are built.
+//
+// 0.1.1    -       Built by Host/Makefile.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/fault_tool, without Host/FaultHost.c, since
+//  the tool supplies the fault port.
+//
+//  Usage:
+//
+//      fault_tool check [file]         restart scenarios; file gets the first
+//                                      scenario's snapshot
+//      fault_tool bench [restarts]     host time and modelled bus time per restart
+//      fault_tool decode <file>        print a snapshot (FAULT_READ bytes, or the
+//                                      file DDS_SIM_FAULT or check wrote)
+//
+//  A fault is injected by handing FaultCapture() a made-up exception frame on a
+//  stack of the tool's own, as FaultEntry() does on the target.  The tool's
+//  FaultPortRestart() then stands in for the exception return into the C start-
+//  up: it jumps back out, the module state a .bss clear would zero is zeroed, and
+//  the start-up sequence of DDSExperiment.c runs again with the snapshot and the
+//  GPIO levels left as they were.  HalClockInit() sees the same clock requested
+//  again and, like the target finding the PLL locked, keeps the cycle counter.
+//
+//  The parts are modelled from their datasheets as in SyncTool: the AD9834's
+//  registers take effect at once and FSELECT/PSELECT pick the bank when PIN_SW is
+//  set; AD9952 writes fill its I/O buffer, which a rising edge on IO_UPDATE (PL4)
+//  moves to the output.  Every GPIO write and every checkpoint delivers the frames
+//  sent so far and recomputes the outputs, counting the changes.
+//
+//  Scenarios (check exits 1 if any fails):
+//
+//      steady      both parts set up, the AD9834 on bank 1 by pin switch, a
+//                  calibrated reference clock; a fault in thread code
+//      pending     as steady with a pin switch still waiting for its pins
+//      boot        a second fault during the restore; the next start must leave
+//                  the parts alone
+//      preset      a modulation preset playing on the AD9834; it must be
+//                  resumed and the AD9952 restored (AD9834 builds only)
+//      corrupt     a snapshot that fails its seal must be discarded
+//
+//  For every scenario but preset, the outputs must not change at all from the
+//  fault to the end of the restart, and the parts' registers must end where they
+//  were.  Wherever the AD9952 is restored, nothing may be left in its I/O buffer
+//  unlatched.  The restart time is reported two ways: the host time the firmware's
+//  restart path takes on this machine, and the bus time of the restore frames
+//  modelled at the SSI bit rate (the simulated SSI is instant).  On the target the
+//  snapshot's restartCycles, read back with FAULT_READ, is the real figure.
+//
+//************************************************************************************
+
+// Includes
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Boot.h"
+#include "Calib.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Fault.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Mem.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Preset.h"
+#include "Record.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SoftDDS.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "Sync.h"
+#include "TimeBase.h"
+
+// Defines
+#define     FAULT_TOOL_RESTARTS     10000
+#define     FAULT_TOOL_STACK_WORDS  64
+
+// Made-up fault: a precise bus fault escalated to hard fault in thread code
+#define     FAULT_TOOL_PC           0x00004F2A
+#define     FAULT_TOOL_LR           0x00003C15
+#define     FAULT_TOOL_BFAR         0x4000800C
+#define     FAULT_TOOL_CFSR         0x00008200  // BFARVALID | PRECISERR
+#define     FAULT_TOOL_HFSR         0x40000000  // FORCED
+#define     FAULT_TOOL_EXC_THREAD   0xFFFFFFF9
+
+// Modulation preset
+#define     FAULT_TOOL_PRESET_ID    7
+#define     FAULT_TOOL_PRESET_BITS  64
+#define     FAULT_TOOL_SYMBOL       1200        // Cycles per symbol (10 us)
+
+// AD9834 control bits that do not change the output: the write mode, and the
+// bank selects while PIN_SW hands them to the pins
+#define     FAULT_TOOL_CTRL_IGNORED (AD9834_CTRL_B28 | AD9834_CTRL_HLB | \
+                                     AD9834_CTRL_FSEL | AD9834_CTRL_PSEL)
+
+// Type Definitions
+typedef struct {
+
+    //
+    // AD9834
+    //
+    uint16_t ctrl;
+    uint32_t freq[2];
+    uint16_t phase[2];
+    uint16_t lsb;
+    bool msbNext;
+
+    //
+    // AD9952
+    //
+    uint32_t buffer[DDSSHADOW_AD9952_REGS];     // I/O buffer
+    uint32_t reg[DDSSHADOW_AD9952_REGS];        // Latched, driving the output
+    uint32_t unlatched;                         // Writes since the last IO_UPDATE
+    uint8_t addr;
+    uint32_t remain;
+    uint32_t value;
+
+    //
+    // Output
+    //
+    uint32_t outFreq;
+    uint32_t outPhase;
+    uint32_t changes;
+    uint32_t frames;
+
+} tFaultToolPart;
+
+typedef struct {
+
+    tPresetImage header;
+    tPresetIndex index[1];
+    tPreset preset;
+    uint8_t bits[FAULT_TOOL_PRESET_BITS / 8];
+
+} tFaultToolImage;
+
+// Global Variables
+//
+// Stands in for the .noinit snapshot; the start-up never touches it.
+//
+tFaultSnapshot g_faultSnapshot;
+
+static tFaultToolPart g_faultToolParts[SSISTREAM_COUNT];
+static jmp_buf g_faultToolJump;
+static bool g_faultToolBootFault;   // Fault again inside the next restore
+static const tPresetImage *g_faultToolImage;
+static tFaultToolImage g_faultToolImageData;
+
+static const char *const g_faultToolVectors[16] = {
+
+    "thread", "reset", "NMI", "HardFault", "MemManage", "BusFault", "UsageFault",
+    "reserved", "reserved", "reserved", "reserved", "SVCall", "DebugMon", "reserved",
+    "PendSV", "SysTick"
+
+};
+
+static const char *const g_faultToolCfsr[32] = {
+
+    "IACCVIOL", "DACCVIOL", 0, "MUNSTKERR", "MSTKERR", "MLSPERR", 0, "MMARVALID",
+    "IBUSERR", "PRECISERR", "IMPRECISERR", "UNSTKERR", "STKERR", "LSPERR", 0,
+    "BFARVALID", "UNDEFINSTR", "INVSTATE", "INVPC", "NOCP", 0, 0, 0, 0, "UNALIGNED",
+    "DIVBYZERO", 0, 0, 0, 0, 0, 0
+
+};
+
+static const char *const g_faultToolFlags[9] = {
+
+    "PENDING", "WARM", "RESTORED", "PSP", "FPU", "THREAD", "BAD_SP", "RESET_TIME",
+    "BOOT"
+
+};
+
+static const char *const g_faultToolOrigins[8] = {
+
+    "local", "remote", "preset", "mod", "calib", "sync", "restore", "?"
+
+};
+
+//************************************************************************************
+//
+// Register models.
+//
+//************************************************************************************
+static void FaultToolFrame(tFaultToolPart *part, uint32_t instance, uint16_t frame) {
+
+    uint32_t index, data;
+
+    part->frames++;
+
+    if (instance == SSISTREAM_AD9952) {
+
+        if (part->remain == 0) {
+
+            part->addr = (uint8_t)(frame & AD9952_INSTR_ADDR_MASK);
+            part->remain = ((frame & AD9952_INSTR_READ) != 0) ? 0 :
+                           AD9952RegBytes(part->addr);
+            part->value = 0;
+
+        }
+
+        else {
+
+            part->value = (part->value << 8) | (frame & 0xFF);
+
+            if (--part->remain == 0) {
+
+                part->buffer[part->addr] = part->value;
+                part->unlatched++;
+
+            }
+
+        }
+
+        return;
+
+    }
+
+    switch (frame & 0xC000) {
+
+        case AD9834_REG_CTRL:
+
+            part->ctrl = frame;
+            break;
+
+        case AD9834_REG_FREQ0:
+        case AD9834_REG_FREQ1:
+
+            index = ((frame & 0xC000) == AD9834_REG_FREQ1) ? 1 : 0;
+            data = frame & AD9834_FREQ_HALF_MASK;
+
+            if ((part->ctrl & AD9834_CTRL_B28) != 0) {
+
+                if (part->msbNext) {
+
+                    part->freq[index] = part->lsb | (data << 14);
+
+                }
+
+                else {
+
+                    part->lsb = (uint16_t)data;
+
+                }
+
+                part->msbNext = !part->msbNext;
+
+            }
+
+            else if ((part->ctrl & AD9834_CTRL_HLB) != 0) {
+
+                part->freq[index] = (part->freq[index] & AD9834_FREQ_HALF_MASK) |
+                                    (data << 14);
+
+            }
+
+            else {
+
+                part->freq[index] = (part->freq[index] & ~AD9834_FREQ_HALF_MASK) | data;
+
+            }
+
+            break;
+
+        default:
+
+            part->phase[((frame & 0xE000) == AD9834_REG_PHASE1) ? 1 : 0] =
+                frame & AD9834_PHASE_MASK;
+            break;
+
+    }
+
+}
+
+static void FaultToolOutput(uint32_t instance) {
+
+    tFaultToolPart *part = &g_faultToolParts[instance];
+    uint8_t lines = HalHostGpioState(HAL_PORT_K);
+    uint32_t freq, phase, fsel, psel;
+
+    if (instance == SSISTREAM_AD9952) {
+
+        freq = part->reg[AD9952_REG_FTW0];
+        phase = part->reg[AD9952_REG_POW0];
+
+    }
+
+    else {
+
+        if ((part->ctrl & AD9834_CTRL_PIN_SW) != 0) {
+
+            fsel = ((lines & MOD_FSELECT) != 0) ? 1 : 0;
+            psel = ((lines & MOD_PSELECT) != 0) ? 1 : 0;
+
+        }
+
+        else {
+
+            fsel = ((part->ctrl & AD9834_CTRL_FSEL) != 0) ? 1 : 0;
+            psel = ((part->ctrl & AD9834_CTRL_PSEL) != 0) ? 1 : 0;
+
+        }
+
+        freq = part->freq[fsel];
+        phase = part->phase[psel];
+
+    }
+
+    if ((freq != part->outFreq) || (phase != part->outPhase)) {
+
+        part->outFreq = freq;
+        part->outPhase = phase;
+        part->changes++;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Deliver the frames sent so far and recompute both outputs.
+//
+//************************************************************************************
+static void FaultToolSettle(void) {
+
+    static const uint32_t ssi[SSISTREAM_COUNT] = { HAL_SSI_0, HAL_SSI_3 };
+    tHalHostFrame frame;
+    uint32_t bus;
+
+    for (bus = 0; bus < SSISTREAM_COUNT; bus++) {
+
+        while (HalHostSsiRead(ssi[bus], &frame)) {
+
+            FaultToolFrame(&g_faultToolParts[bus], bus, frame.frame);
+
+        }
+
+        FaultToolOutput(bus);
+
+    }
+
+}
+
+static void FaultToolGpioWatch(uint32_t port, uint8_t before, uint8_t after) {
+
+    tFaultToolPart *part = &g_faultToolParts[SSISTREAM_AD9952];
+
+    FaultToolSettle();
+
+    if ((port == HAL_PORT_L) && ((before & HAL_PIN_4) == 0) &&
+        ((after & HAL_PIN_4) != 0)) {
+
+        memcpy(part->reg, part->buffer, sizeof(part->reg));
+        part->unlatched = 0;
+        FaultToolOutput(SSISTREAM_AD9952);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Fault port.  Marks the restart warm for a fault from thread mode, as the target
+// does, and leaves through the jump instead of the exception return.
+//
+//************************************************************************************
+void FaultPortRestart(tFaultSnapshot *snap) {
+
+    if ((snap->flags & FAULT_FLAG_THREAD) != 0) {
+
+        snap->flags |= FAULT_FLAG_WARM;
+
+    }
+
+    FaultSeal(snap);
+    longjmp(g_faultToolJump, 1);
+
+}
+
+//************************************************************************************
+//
+// A fault at FAULT_TOOL_PC with the frame on a stack of recognisable words.
+//
+//************************************************************************************
+static void FaultToolInject(uint32_t excReturn) {
+
+    static uint32_t stack[FAULT_TOOL_STACK_WORDS];
+    tFaultContext context;
+    uint32_t *frame = &stack[FAULT_TOOL_STACK_WORDS / 2];
+    uint32_t i;
+
+    for (i = 0; i < FAULT_TOOL_STACK_WORDS; i++) {
+
+        stack[i] = 0x5A000000 | i;
+
+    }
+
+    for (i = 0; i < FAULT_R12; i++) {
+
+        frame[i] = 0x10 * (i + 1);
+
+    }
+
+    frame[FAULT_R12] = 0xCC;
+    frame[FAULT_LR] = FAULT_TOOL_LR;
+    frame[FAULT_PC] = FAULT_TOOL_PC;
+    frame[FAULT_XPSR] = 0x01000000;
+
+    context.frame = frame;
+    context.excReturn = excReturn;
+    context.vector = 3;
+    context.cfsr = FAULT_TOOL_CFSR;
+    context.hfsr = FAULT_TOOL_HFSR;
+    context.mmfar = 0;
+    context.bfar = FAULT_TOOL_BFAR;
+    context.ramStart = (uintptr_t)stack;
+    context.ramEnd = (uintptr_t)&stack[FAULT_TOOL_STACK_WORDS];
+    context.cycles = HalCycles32();
+
+    FaultCapture(&g_faultSnapshot, &context);
+    FaultPortRestart(&g_faultSnapshot);
+
+}
+
+//************************************************************************************
+//
+// What the C start-up's .bss clear does to the modules the restart depends on.
+// The snapshot, the HAL's GPIO levels and the parts are left alone.
+//
+//************************************************************************************
+static void FaultToolZero(void) {
+
+    memset(&g_sweep, 0, sizeof(g_sweep));
+    memset(&g_modulator, 0, sizeof(g_modulator));
+    memset(&g_calib, 0, sizeof(g_calib));
+    memset(&g_sync, 0, sizeof(g_sync));
+    memset(&g_remote, 0, sizeof(g_remote));
+    memset(&g_record, 0, sizeof(g_record));
+    memset(g_ssiStreams, 0, sizeof(g_ssiStreams));
+    memset(&g_ad9834Shadow, 0, sizeof(g_ad9834Shadow));
+    memset(&g_ad9952Shadow, 0, sizeof(g_ad9952Shadow));
+    g_presetImage = 0;
+
+}
+
+//************************************************************************************
+//
+// The start-up of DDSExperiment.c.  The tool's image stands in for the flash
+// preset store, and recording starts in wrap mode as it does on the target.
+//
+//************************************************************************************
+static bool FaultToolBoot(void) {
+
+    uint32_t sysClkHz = HalClockInit(BOOT_SYS_CLK_HZ);
+    bool restart;
+
+    HalHostSetLimit(UINT64_MAX);
+
+    restart = FaultInit(&g_faultSnapshot);
+
+    TimeBaseInit(sysClkHz, BOOT_TICK_HZ);
+    SchedulerPortInit(sysClkHz);
+    SchedulerInit();
+    PowerInit();
+    MemInit();
+
+    RecordInit(&g_record);
+    RecordStart(&g_record, RECORD_FLAG_WRAP);
+
+    RemoteInit(&g_remote);
+
+    SSIStreamInit(&g_ssiStreams[SSISTREAM_AD9834], SSISTREAM_AD9834);
+    SSIStreamInit(&g_ssiStreams[SSISTREAM_AD9952], SSISTREAM_AD9952);
+    DDSShadowAD9834Init(&g_ad9834Shadow);
+    DDSShadowAD9952Init(&g_ad9952Shadow);
+    SSIStreamPortInit(&g_ssiStreams[SSISTREAM_AD9834], sysClkHz, BOOT_SSI_BIT_RATE);
+    SSIStreamPortInit(&g_ssiStreams[SSISTREAM_AD9952], sysClkHz, BOOT_SSI_BIT_RATE);
+
+    if (restart) {
+
+        if (g_faultToolBootFault) {
+
+            g_faultToolBootFault = false;
+
+            if (setjmp(g_faultToolJump) == 0) {
+
+                FaultToolInject(FAULT_TOOL_EXC_THREAD);
+
+            }
+
+            FaultToolZero();
+
+            return FaultToolBoot();
+
+        }
+
+        FaultRestore(&g_faultSnapshot);
+
+    }
+
+    SoftDDSInit();
+    SweepPortInit(sysClkHz);
+    ModulationPortInit(sysClkHz);
+    CalibInit(&g_calib, sysClkHz);
+    SyncInit(&g_sync);
+
+    g_presetImage = ((g_faultToolImage != 0) &&
+                     PresetValidate(g_faultToolImage, PRESET_FLASH_SIZE)) ?
+                    g_faultToolImage : 0;
+
+    if (g_presetImage != 0) {
+
+        if (restart) {
+
+            FaultResume(&g_faultSnapshot);
+
+        }
+
+        else if (PresetFind(g_presetImage, PRESET_BOOT_ID) != 0) {
+
+            PresetPlay(g_presetImage, PresetFind(g_presetImage, PRESET_BOOT_ID));
+
+        }
+
+    }
+
+    return restart;
+
+}
+
+//************************************************************************************
+//
+// A one-preset image: FSK on the AD9834 over an alternating bit pattern.
+//
+//************************************************************************************
+static const tPresetImage *FaultToolBuildImage(void) {
+
+    tFaultToolImage *image = &g_faultToolImageData;
+    uint32_t i;
+
+    memset(image, 0, sizeof(*image));
+
+    image->header.magic = PRESET_MAGIC;
+    image->header.versionMajor = PRESET_VERSION_MAJOR;
+    image->header.versionMinor = PRESET_VERSION_MINOR;
+    image->header.count = 1;
+    image->header.imageSize = sizeof(*image);
+
+    image->index[0].id = FAULT_TOOL_PRESET_ID;
+    image->index[0].offset = offsetof(tFaultToolImage, preset);
+
+    image->preset.type = PRESET_TYPE_MOD;
+    image->preset.instance = SSISTREAM_AD9834;
+    image->preset.flags = PRESET_FLAG_REPEAT;
+    image->preset.mode = MOD_MODE_FSK;
+    image->preset.stepCycles = FAULT_TOOL_SYMBOL;
+    image->preset.dataOffset = offsetof(tFaultToolImage, bits);
+    image->preset.dataCount = FAULT_TOOL_PRESET_BITS;
+    strncpy(image->preset.name, "fault-fsk", PRESET_NAME_LEN);
+
+    for (i = 0; i < sizeof(image->bits); i++) {
+
+        image->bits[i] = 0xA5;
+
+    }
+
+    image->header.crc = Crc32(CRC32_INIT, (const uint8_t *)image + sizeof(tPresetImage),
+                              sizeof(*image) - sizeof(tPresetImage));
+
+    return &image->header;
+
+}
+
+//************************************************************************************
+//
+// Power-up: an invalid snapshot, lines low, fresh part models.
+//
+//************************************************************************************
+static void FaultToolPowerUp(bool withPreset) {
+
+    tHalHostFrame frame;
+    uint32_t port;
+
+    HalHostGpioWatch(0);
+
+    for (port = 0; port < HAL_PORT_COUNT; port++) {
+
+        HalGpioWrite(port, 0xFF, 0);
+
+    }
+
+    while (HalHostSsiRead(HAL_SSI_0, &frame) || HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+        // Drop what earlier scenarios left.
+
+    }
+
+    memset(&g_faultSnapshot, 0xEE, sizeof(g_faultSnapshot));
+    memset(g_faultToolParts, 0, sizeof(g_faultToolParts));
+    g_faultToolImage = withPreset ? FaultToolBuildImage() : 0;
+    g_faultToolBootFault = false;
+
+    FaultToolZero();
+    HalHostGpioWatch(FaultToolGpioWatch);
+    FaultToolBoot();
+
+}
+
+//************************************************************************************
+//
+// The waveform the scenarios fault under.  The AD9834 ends on bank 1, reached by a
+// pin switch; its reference clock is a calibrated one.
+//
+//************************************************************************************
+static void FaultToolSwitchPins(void) {
+
+    tAD9834Shadow *shadow = &g_ad9834Shadow;
+
+    HalGpioWrite(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT,
+                 (((shadow->ctrl & AD9834_CTRL_FSEL) != 0) ? MOD_FSELECT : 0) |
+                 (((shadow->ctrl & AD9834_CTRL_PSEL) != 0) ? MOD_PSELECT : 0));
+    DDSShadowAD9834PinsSwitched(shadow);
+
+}
+
+static void FaultToolWaveform(bool ad9834) {
+
+    tAD9834Shadow *shadow = &g_ad9834Shadow;
+    const tDDSTuning *tuning = &g_remote.tuning[SSISTREAM_AD9834];
+    const tDDSTuning *tuning52 = &g_remote.tuning[SSISTREAM_AD9952];
+    static const uint8_t command[] = { 0x01, REMOTE_CMD_SET_FREQ, 10, 0, 0xFF };
+
+    RecordCommand(&g_record, command, sizeof(command));
+
+    if (ad9834) {
+
+        RemoteSetRefClk(&g_remote, SSISTREAM_AD9834, tuning->refClkHz + 1234);
+
+        DDSShadowAD9834SetCtrl(shadow, AD9834_CTRL_PIN_SW, AD9834_CTRL_PIN_SW);
+        DDSShadowAD9834SetFreq(shadow, 0, DDSTuningFreqWord(tuning, 1000000ULL << 32));
+        DDSShadowAD9834SetFreq(shadow, 1, DDSTuningFreqWord(tuning, 1250000ULL << 32));
+        DDSShadowAD9834SetPhase(shadow, 0, 0);
+        DDSShadowAD9834SetPhase(shadow, 1, DDSTuningPhaseWordCentiDeg(tuning, 9000));
+        DDSShadowAD9834Queue(shadow, &g_ssiStreams[SSISTREAM_AD9834]);
+        HalHostAdvance(1200);
+
+        DDSShadowAD9834Retune(shadow, DDSTuningFreqWord(tuning, 1500000ULL << 32));
+        DDSShadowAD9834Queue(shadow, &g_ssiStreams[SSISTREAM_AD9834]);
+        FaultToolSwitchPins();
+        HalHostAdvance(1200);
+
+    }
+
+    DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_CFR1, 0x00000200);
+    DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_CFR2, 0x000018);
+    DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_FTW0,
+                       DDSTuningFreqWord(tuning52, 21400000ULL << 32));
+    DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_POW0,
+                       DDSTuningPhaseWordCentiDeg(tuning52, 4500));
+    DDSShadowAD9952Queue(&g_ad9952Shadow, &g_ssiStreams[SSISTREAM_AD9952]);
+    HalHostAdvance(1200);
+    SweepPortIOUpdate();
+
+    FaultToolSettle();
+
+}
+
+//************************************************************************************
+//
+// Fault, restart and check.  Returns the failure, or 0.
+//
+//************************************************************************************
+typedef struct {
+
+    uint32_t restoreFrames;
+    uint32_t busFrames[SSISTREAM_COUNT];
+    uint32_t restartCycles;
+    uint32_t flags;
+    uint32_t outputChanges;
+
+} tFaultToolResult;
+
+static void FaultToolRestart(tFaultToolResult *result, bool bootFault) {
+
+    uint32_t frames[SSISTREAM_COUNT];
+    uint32_t changes[SSISTREAM_COUNT];
+    uint32_t i;
+
+    FaultToolSettle();
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        frames[i] = g_faultToolParts[i].frames;
+        changes[i] = g_faultToolParts[i].changes;
+
+    }
+
+    g_faultToolBootFault = bootFault;
+
+    if (setjmp(g_faultToolJump) == 0) {
+
+        FaultToolInject(FAULT_TOOL_EXC_THREAD);
+
+    }
+
+    FaultToolZero();
+    FaultToolBoot();
+    FaultToolSettle();
+
+    result->restoreFrames = g_faultSnapshot.restoreFrames;
+    result->restartCycles = g_faultSnapshot.restartCycles;
+    result->flags = g_faultSnapshot.flags;
+    result->outputChanges = 0;
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        result->busFrames[i] = g_faultToolParts[i].frames - frames[i];
+        result->outputChanges += g_faultToolParts[i].changes - changes[i];
+
+    }
+
+}
+
+static double FaultToolBusUs(const tFaultToolResult *result) {
+
+    double ad9834 = result->busFrames[SSISTREAM_AD9834] * 17.0;    // 16 bits + gap
+    double ad9952 = result->busFrames[SSISTREAM_AD9952] * 9.0;     // 8 bits + gap
+
+    return ((ad9834 > ad9952) ? ad9834 : ad9952) * 1e6 / BOOT_SSI_BIT_RATE;
+
+}
+
+static const char *FaultToolSnapshotCheck(void) {
+
+    const tFaultSnapshot *snap = &g_faultSnapshot;
+
+    if (!FaultValid(snap)) {
+
+        return "snapshot seal broken";
+
+    }
+
+    if ((snap->frame[FAULT_PC] != FAULT_TOOL_PC) || (snap->frame[FAULT_LR] != FAULT_TOOL_LR) ||
+        (snap->bfar != FAULT_TOOL_BFAR) || (snap->cfsr != FAULT_TOOL_CFSR) ||
+        (snap->stackWords != FAULT_STACK_WORDS) ||
+        (snap->stack[0] != (0x5A000000 | ((FAULT_TOOL_STACK_WORDS / 2) + FAULT_FRAME_WORDS)))) {
+
+        return "exception frame not captured";
+
+    }
+
+    if (snap->traceWords == 0) {
+
+        return "no trace captured";
+
+    }
+
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// The AD9952 restore has to end with IO_UPDATE: registers it re-sent but left in
+// the I/O buffer would take effect at some later, unrelated pulse.
+//
+//************************************************************************************
+static const char *FaultToolLatched(void) {
+
+    if (DDSChipBuilt(SSISTREAM_AD9952) &&
+        (g_faultToolParts[SSISTREAM_AD9952].unlatched != 0)) {
+
+        return "AD9952 restore not latched";
+
+    }
+
+    return 0;
+
+}
+
+static const char *FaultToolSteady(tFaultToolResult *result, bool pending) {
+
+    tAD9834Shadow before34 = g_ad9834Shadow;
+    tAD9952Shadow before52;
+    tDDSTuning tuning[SSISTREAM_COUNT];
+    tFaultToolPart parts[SSISTREAM_COUNT];
+    const char *failure;
+
+    FaultToolPowerUp(false);
+    FaultToolWaveform(true);
+
+    if (pending) {
+
+        DDSShadowAD9834Retune(&g_ad9834Shadow,
+                              DDSTuningFreqWord(&g_remote.tuning[SSISTREAM_AD9834],
+                                                1750000ULL << 32));
+        DDSShadowAD9834Queue(&g_ad9834Shadow, &g_ssiStreams[SSISTREAM_AD9834]);
+        FaultToolSettle();
+
+        if (!g_ad9834Shadow.pinSwitch) {
+
+            return "no pin switch pending";
+
+        }
+
+    }
+
+    before34 = g_ad9834Shadow;
+    before52 = g_ad9952Shadow;
+    memcpy(tuning, g_remote.tuning, sizeof(tuning));
+    memcpy(parts, g_faultToolParts, sizeof(parts));
+
+    FaultToolRestart(result, false);
+
+    if ((failure = FaultToolSnapshotCheck()) != 0) {
+
+        return failure;
+
+    }
+
+    if ((result->flags & (FAULT_FLAG_WARM | FAULT_FLAG_RESTORED | FAULT_FLAG_PENDING)) !=
+        (FAULT_FLAG_WARM | FAULT_FLAG_RESTORED)) {
+
+        return "not a warm, completed restore";
+
+    }
+
+    if (result->outputChanges != 0) {
+
+        return "an output changed during the restart";
+
+    }
+
+    if ((result->restoreFrames == 0) ||
+        (result->restoreFrames != (result->busFrames[0] + result->busFrames[1]))) {
+
+        return "restore frames do not match the bus";
+
+    }
+
+    if ((memcmp(parts[0].freq, g_faultToolParts[0].freq, sizeof(parts[0].freq)) != 0) ||
+        (memcmp(parts[0].phase, g_faultToolParts[0].phase, sizeof(parts[0].phase)) != 0) ||
+        (memcmp(parts[1].reg, g_faultToolParts[1].reg, sizeof(parts[1].reg)) != 0) ||
+        ((parts[0].ctrl & ~FAULT_TOOL_CTRL_IGNORED) !=
+         (g_faultToolParts[0].ctrl & ~FAULT_TOOL_CTRL_IGNORED))) {
+
+        return "part registers differ after the restart";
+
+    }
+
+    if (memcmp(tuning, g_remote.tuning, sizeof(tuning)) != 0) {
+
+        return "tuning contexts not restored";
+
+    }
+
+    if (DDSChipBuilt(SSISTREAM_AD9834) &&
+        ((memcmp(before34.freq, g_ad9834Shadow.freq, sizeof(before34.freq)) != 0) ||
+         (memcmp(before34.phase, g_ad9834Shadow.phase, sizeof(before34.phase)) != 0) ||
+         (before34.pins != g_ad9834Shadow.pins) ||
+         (g_ad9834Shadow.pinSwitch) ||
+         ((g_ad9834Shadow.ctrl & (AD9834_CTRL_FSEL | AD9834_CTRL_PSEL)) !=
+          g_ad9834Shadow.pins))) {
+
+        return "shadows not restored";
+
+    }
+
+    if (DDSChipBuilt(SSISTREAM_AD9952) &&
+        (memcmp(before52.reg, g_ad9952Shadow.reg, sizeof(before52.reg)) != 0)) {
+
+        return "shadows not restored";
+
+    }
+
+    return FaultToolLatched();
+
+}
+
+static const char *FaultToolBootCase(tFaultToolResult *result) {
+
+    tFaultToolPart parts[SSISTREAM_COUNT];
+
+    FaultToolPowerUp(false);
+    FaultToolWaveform(true);
+    memcpy(parts, g_faultToolParts, sizeof(parts));
+
+    FaultToolRestart(result, true);
+
+    if ((result->flags & (FAULT_FLAG_BOOT | FAULT_FLAG_RESTORED)) !=
+        (FAULT_FLAG_BOOT | FAULT_FLAG_RESTORED)) {
+
+        return "start-up fault not recognised";
+
+    }
+
+    if ((result->restoreFrames != 0) || (result->busFrames[0] != 0) ||
+        (result->busFrames[1] != 0)) {
+
+        return "parts written after a start-up fault";
+
+    }
+
+    if ((result->outputChanges != 0) ||
+        (memcmp(parts[1].reg, g_faultToolParts[1].reg, sizeof(parts[1].reg)) != 0)) {
+
+        return "an output changed during the restart";
+
+    }
+
+    return 0;
+
+}
+
+static const char *FaultToolPresetCase(tFaultToolResult *result) {
+
+    const tPreset *preset;
+    tFaultToolPart before;
+
+    FaultToolPowerUp(true);
+    FaultToolWaveform(false);
+
+    preset = PresetFind(g_presetImage, FAULT_TOOL_PRESET_ID);
+
+    if ((preset == 0) || !PresetPlay(g_presetImage, preset)) {
+
+        return "preset did not start";
+
+    }
+
+    HalHostAdvance(20 * FAULT_TOOL_SYMBOL);
+    before = g_faultToolParts[SSISTREAM_AD9952];
+
+    FaultToolRestart(result, false);
+
+    if ((g_faultSnapshot.preset != 0) || (g_faultSnapshot.presetInstance != SSISTREAM_AD9834)) {
+
+        return "playing preset not captured";
+
+    }
+
+    if (!g_modulator.running ||
+        (g_modulator.bits != (const uint8_t *)PresetPayload(g_presetImage,
+                                                            preset->dataOffset))) {
+
+        return "preset not resumed";
+
+    }
+
+    if ((result->busFrames[SSISTREAM_AD9834] != 0) ||
+        (result->restoreFrames != result->busFrames[SSISTREAM_AD9952]) ||
+        (memcmp(before.reg, g_faultToolParts[SSISTREAM_AD9952].reg, sizeof(before.reg)) != 0)) {
+
+        return "AD9952 not restored alone";
+
+    }
+
+    ModulationStop(&g_modulator);
+
+    return FaultToolLatched();
+
+}
+
+static const char *FaultToolCorrupt(tFaultToolResult *result) {
+
+    memset(result, 0, sizeof(*result));
+
+    FaultToolPowerUp(false);
+    FaultToolWaveform(true);
+
+    if (setjmp(g_faultToolJump) == 0) {
+
+        FaultToolInject(FAULT_TOOL_EXC_THREAD);
+
+    }
+
+    g_faultSnapshot.trace[3] ^= 0x0100;
+    FaultToolZero();
+
+    if (FaultToolBoot()) {
+
+        return "corrupt snapshot accepted";
+
+    }
+
+    if (!FaultValid(&g_faultSnapshot) || (g_faultSnapshot.faults != 0)) {
+
+        return "corrupt snapshot not cleared";
+
+    }
+
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// Decode.
+//
+//************************************************************************************
+static void FaultToolTrace(const tFaultSnapshot *snap) {
+
+    uint32_t index = 0;
+    uint32_t header, words, length, i;
+
+    printf("trace: %u words\n", snap->traceWords);
+
+    while (index < snap->traceWords) {
+
+        header = snap->trace[index];
+        words = RECORD_ENTRY_WORDS(header);
+        length = RECORD_LENGTH(header);
+
+        if ((index + words) > snap->traceWords) {
+
+            printf("  (truncated entry)\n");
+            return;
+
+        }
+
+        printf("  %10u us  %-7s ", snap->trace[index + 1] |
+                                   ((uint32_t)snap->trace[index + 2] << 16),
+               g_faultToolOrigins[RECORD_ORIGIN(header)]);
+
+        if (RECORD_KIND(header) == RECORD_KIND_FRAMES) {
+
+            printf("%s frames", (RECORD_INSTANCE(header) == SSISTREAM_AD9834) ?
+                               "AD9834" : "AD9952");
+
+            for (i = 0; (i < length) && (i < 8); i++) {
+
+                printf(" %04X", snap->trace[index + RECORD_HEADER_WORDS + i]);
+
+            }
+
+            printf("%s\n", (length > 8) ? " ..." : "");
+
+        }
+
+        else {
+
+            printf("command seq %u cmd 0x%02X len %u\n",
+                   snap->trace[index + RECORD_HEADER_WORDS] & 0xFF,
+                   snap->trace[index + RECORD_HEADER_WORDS] >> 8,
+                   (length > 2) ? (snap->trace[index + RECORD_HEADER_WORDS + 1] & 0xFF) :
+                                  0);
+
+        }
+
+        index += words;
+
+    }
+
+}
+
+static void FaultToolPrint(const tFaultSnapshot *snap) {
+
+    static const char *const regs[FAULT_FRAME_WORDS] = {
+
+        "r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr"
+
+    };
+    uint32_t i;
+
+    printf("snapshot: %s, version %u, %u bytes, %u faults, %u restarts\n",
+           FaultValid(snap) ? "valid" : "SEAL BROKEN", snap->version, snap->size,
+           snap->faults, snap->restarts);
+    printf("flags:");
+
+    for (i = 0; i < 9; i++) {
+
+        if ((snap->flags & (1UL << i)) != 0) {
+
+            printf(" %s", g_faultToolFlags[i]);
+
+        }
+
+    }
+
+    printf("\nvector %u (", snap->vector);
+
+    if (snap->vector < 16) {
+
+        printf("%s)\n", g_faultToolVectors[snap->vector]);
+
+    }
+
+    else {
+
+        printf("IRQ %u)\n", snap->vector - 16);
+
+    }
+
+    printf("exc_return 0x%08X (%s mode, %s, %s frame)\n", snap->excReturn,
+           ((snap->excReturn & FAULT_EXC_THREAD) != 0) ? "thread" : "handler",
+           ((snap->excReturn & FAULT_EXC_PSP) != 0) ? "PSP" : "MSP",
+           ((snap->excReturn & FAULT_EXC_NO_FPU) != 0) ? "basic" : "FPU");
+
+    if ((snap->flags & FAULT_FLAG_BAD_SP) != 0) {
+
+        printf("registers: not captured, stack pointer outside RAM\n");
+
+    }
+
+    else {
+
+        for (i = 0; i < FAULT_FRAME_WORDS; i++) {
+
+            printf("%s%-4s 0x%08X", ((i % 4) == 0) ? "" : "  ", regs[i], snap->frame[i]);
+
+            if ((i % 4) == 3) {
+
+                printf("\n");
+
+            }
+
+        }
+
+    }
+
+    printf("cfsr 0x%08X:", snap->cfsr);
+
+    for (i = 0; i < 32; i++) {
+
+        if (((snap->cfsr & (1UL << i)) != 0) && (g_faultToolCfsr[i] != 0)) {
+
+            printf(" %s", g_faultToolCfsr[i]);
+
+        }
+
+    }
+
+    printf("\nhfsr 0x%08X:%s%s%s\n", snap->hfsr,
+           ((snap->hfsr & 0x00000002) != 0) ? " VECTTBL" : "",
+           ((snap->hfsr & 0x40000000) != 0) ? " FORCED" : "",
+           ((snap->hfsr & 0x80000000) != 0) ? " DEBUGEVT" : "");
+
+    if ((snap->cfsr & 0x00000080) != 0) {
+
+        printf("mmfar 0x%08X\n", snap->mmfar);
+
+    }
+
+    if ((snap->cfsr & 0x00008000) != 0) {
+
+        printf("bfar 0x%08X\n", snap->bfar);
+
+    }
+
+    printf("sp 0x%08X, %u stack words:", snap->sp, snap->stackWords);
+
+    for (i = 0; i < snap->stackWords; i++) {
+
+        printf("%s%08X", ((i % 8) == 0) ? "\n  " : " ", snap->stack[i]);
+
+    }
+
+    printf("\nwaveform (DDS_CHIP %u):\n", snap->chips);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        printf("  %s reference clock %u Hz\n", (i == SSISTREAM_AD9834) ? "AD9834" : "AD9952",
+               snap->tuning[i].refClkHz);
+
+    }
+
+    printf("  AD9834 ctrl 0x%04X pins 0x%04X set 0x%02X known 0x%02X "
+           "freq 0x%07X 0x%07X phase 0x%03X 0x%03X\n",
+           snap->ad9834Ctrl, snap->ad9834Pins, snap->ad9834Set, snap->ad9834Known,
+           snap->ad9834Freq[0], snap->ad9834Freq[1], snap->ad9834Phase[0],
+           snap->ad9834Phase[1]);
+    printf("  AD9952 set 0x%02X known 0x%02X", snap->ad9952Set, snap->ad9952Known);
+
+    for (i = 0; i < DDSSHADOW_AD9952_REGS; i++) {
+
+        printf(" %X:%08X", i, snap->ad9952Reg[i]);
+
+    }
+
+    printf("\n");
+
+    if (snap->preset != FAULT_NO_PRESET) {
+
+        printf("  preset index %u on %s (image crc 0x%08X)\n", snap->preset,
+               (snap->presetInstance == SSISTREAM_AD9834) ? "AD9834" : "AD9952",
+               snap->presetCrc);
+
+    }
+
+    if ((snap->flags & FAULT_FLAG_RESTORED) != 0) {
+
+        printf("restart: %u frames re-sent, %u cycles (%.1f us at %u MHz)%s\n",
+               snap->restoreFrames, snap->restartCycles,
+               snap->restartCycles / (BOOT_SYS_CLK_HZ / 1e6), BOOT_SYS_CLK_HZ / 1000000,
+               ((snap->flags & FAULT_FLAG_RESET_TIME) != 0) ? " from the clock coming up" :
+                                                              " from the fault");
+
+    }
+
+    FaultToolTrace(snap);
+
+}
+
+static int FaultToolDecode(const char *path) {
+
+    tFaultSnapshot snap;
+    FILE *file = fopen(path, "rb");
+    size_t length;
+
+    if (file == 0) {
+
+        fprintf(stderr, "fault_tool: cannot open %s\n", path);
+        return 1;
+
+    }
+
+    memset(&snap, 0, sizeof(snap));
+    length = fread(&snap, 1, sizeof(snap), file);
+    fclose(file);
+
+    if (length != sizeof(snap)) {
+
+        fprintf(stderr, "fault_tool: %s is %u bytes, a snapshot is %u\n", path,
+                (uint32_t)length, (uint32_t)sizeof(snap));
+        return 1;
+
+    }
+
+    FaultToolPrint(&snap);
+
+    return FaultValid(&snap) ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// Commands.
+//
+//************************************************************************************
+static int FaultToolCheck(const char *path) {
+
+    tFaultToolResult result;
+    const char *failure;
+    int failures = 0;
+    FILE *file;
+    uint32_t i;
+
+    static const char *const names[5] = {
+
+        "steady", "pending", "boot", "preset", "corrupt"
+
+    };
+
+    for (i = 0; i < 5; i++) {
+
+        memset(&result, 0, sizeof(result));
+
+        //
+        // The preset is a modulation preset on the AD9834
+        //
+        if ((i == 3) && !DDSChipBuilt(SSISTREAM_AD9834)) {
+
+            printf("  %-8s not built\n", names[i]);
+            continue;
+
+        }
+
+        switch (i) {
+
+            case 0:     failure = FaultToolSteady(&result, false);  break;
+            case 1:     failure = FaultToolSteady(&result, true);   break;
+            case 2:     failure = FaultToolBootCase(&result);       break;
+            case 3:     failure = FaultToolPresetCase(&result);     break;
+            default:    failure = FaultToolCorrupt(&result);        break;
+
+        }
+
+        if (failure != 0) {
+
+            printf("  %-8s FAIL: %s\n", names[i], failure);
+            failures++;
+            continue;
+
+        }
+
+        printf("  %-8s ", names[i]);
+
+        if (i < 4) {
+
+            printf("%u frames re-sent (%.1f us on the bus), %u output changes  ",
+                   result.restoreFrames, FaultToolBusUs(&result), result.outputChanges);
+
+        }
+
+        printf("ok\n");
+
+        if ((i == 0) && (path != 0)) {
+
+            file = fopen(path, "wb");
+
+            if (file != 0) {
+
+                fwrite(&g_faultSnapshot, sizeof(g_faultSnapshot), 1, file);
+                fclose(file);
+
+            }
+
+        }
+
+    }
+
+    printf("\n%s\n", (failures == 0) ? "PASS" : "FAIL");
+
+    return (failures == 0) ? 0 : 1;
+
+}
+
+static int FaultToolBench(uint32_t restarts) {
+
+    tFaultToolResult result;
+    struct timespec start, end;
+    double seconds;
+    uint32_t i;
+
+    FaultToolPowerUp(false);
+    FaultToolWaveform(true);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < restarts; i++) {
+
+        FaultToolRestart(&result, false);
+
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) * 1e-9);
+
+    printf("restarts: %u, %u faults recorded, %u output changes\n", restarts,
+           g_faultSnapshot.faults, result.outputChanges);
+    printf("restore: %u frames (AD9834 %u, AD9952 %u), %.1f us on the bus at %u MHz\n",
+           result.restoreFrames, result.busFrames[SSISTREAM_AD9834],
+           result.busFrames[SSISTREAM_AD9952], FaultToolBusUs(&result),
+           BOOT_SSI_BIT_RATE / 1000000);
+    printf("host: %.2f us per capture and restart\n", (seconds * 1e6) / restarts);
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    if ((argc >= 2) && (strcmp(argv[1], "check") == 0)) {
+
+        return FaultToolCheck((argc > 2) ? argv[2] : 0);
+
+    }
+
+    if ((argc >= 2) && (strcmp(argv[1], "bench") == 0)) {
+
+        return FaultToolBench((argc > 2) ? (uint32_t)strtoul(argv[2], 0, 10) :
+                                           FAULT_TOOL_RESTARTS);
+
+    }
+
+    if ((argc >= 3) && (strcmp(argv[1], "decode") == 0)) {
+
+        return FaultToolDecode(argv[2]);
+
+    }
+
+    fprintf(stderr, "usage: fault_tool check [file] | bench [restarts] | decode <file>\n");
+
+    return 2;
+
+}
@@ -0,0 +1,543 @@
+//************************************************************************************
+//
+// Title:               Frequency Hop Check
+// Author:              Jacob Putz
+// Filename:            HopTool.c
+//
+// Description:     Builds hop sequences with the hop engine and checks them
+//                      against a separate implementation of the documented shuffle,
+//                      checks that a seed reproduces its sequence, then plays each
+//                      sequence on the simulated HAL and checks every hop's frames
+//                      and the cycle it lands on.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Expect the shadow's phase in AD9952 hop records.
+//
+// 0.1.1    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/hop_tool.
+//
+//  Usage:
+//
+//      hop_tool check                  every case below
+//      hop_tool bench                  host cost of building a sequence, per hop
+//
+//  For each case the channel grid is loaded and the sequence built, then:
+//
+//  sequence    the step records match ones packed here from the expected channel
+//              order: the user order repeated, or for a shuffle successive
+//              Fisher-Yates passes drawing from xorshift32 by multiply and shift,
+//              written out again from the description in Hop.h.  Every shuffled
+//              pass holds each channel once.
+//  reproduce   after a build with another seed, the case's seed builds the same
+//              records again.
+//  timing      the sequence is played, repeating, for two passes of the table
+//              and a few hops more.  Hop k must put the frames of record
+//              k mod hops on the part's SSI at first + k * dwell cycles exactly.
+//              The spread of the hop-to-hop intervals is reported; anything but
+//              zero fails.
+//
+//  A negative control runs first: the records of one seed compared with the
+//  expected order for the next seed have to differ.  Exits 1 on any failure.
+//
+//  bench times HopSequenceShuffle() per hop for a few list sizes on each built
+//  part, over several seeds, and reports the spread between seeds.  Nothing in
+//  the build depends on the channel values, so the spread is only host noise.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Hop.h"
+#include "Power.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     HOP_TOOL_EXTRA          100         // Hops played past two passes
+#define     HOP_TOOL_BENCH_SEEDS    16
+#define     HOP_TOOL_BASE           ((uint64_t)1000000 << 32)   // 1 MHz, Q32.32
+#define     HOP_TOOL_SPACING        ((uint64_t)25000 << 32)     // 25 kHz
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint32_t instance;
+    uint32_t channels;
+    uint32_t seed;                  // Shuffle seed, or 0 with order set
+    uint32_t length;                // User order length, 0 for a shuffle
+    uint32_t hops;
+    uint32_t dwellCycles;
+
+} tHopToolCase;
+
+// Global Constants
+static const tHopToolCase g_hopToolCases[] = {
+
+    { "ad9952 4096",    SSISTREAM_AD9952,   4096,   1,          0,      4096,   1200 },
+    { "ad9952 1000",    SSISTREAM_AD9952,   1000,   0x1234ABCD, 0,      0,      600 },
+    { "ad9952 order",   SSISTREAM_AD9952,   300,    0,          77,     500,    2400 },
+    { "ad9834 4096",    SSISTREAM_AD9834,   4096,   0xDEADBEEF, 0,      16384,  600 },
+    { "ad9834 order",   SSISTREAM_AD9834,   37,     0,          100,    300,    12000 },
+
+};
+
+#define     HOP_TOOL_CASES          (sizeof(g_hopToolCases) / sizeof(g_hopToolCases[0]))
+
+// Global Variables
+static tDDSTuning g_hopToolTuning[SSISTREAM_COUNT];
+static uint16_t g_hopToolOrder[HOP_CHANNELS_MAX];
+static uint16_t g_hopToolFirst[HOP_RECORD_ELEMS];
+static uint16_t g_hopToolExpected[HOP_RECORD_ELEMS];
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c), and a tuning context per part.
+//
+//************************************************************************************
+static void HopToolBoot(void) {
+
+    uint32_t i;
+
+    BootHostRun(false);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i)) {
+
+            DDSChipTuningInit(i, &g_hopToolTuning[i]);
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Load the case's grid and build its sequence with seed (shuffles) or the case's
+// order.
+//
+//************************************************************************************
+static bool HopToolBuild(const tHopToolCase *tc, uint32_t seed) {
+
+    uint32_t i;
+
+    if (!HopLoadGrid(&g_hop, tc->instance, &g_hopToolTuning[tc->instance],
+                     HOP_TOOL_BASE, HOP_TOOL_SPACING, tc->channels)) {
+
+        return false;
+
+    }
+
+    if (tc->length == 0) {
+
+        return HopSequenceShuffle(&g_hop, seed, tc->hops);
+
+    }
+
+    for (i = 0; i < tc->length; i++) {
+
+        g_hopToolOrder[i] = (uint16_t)((i * 7 + 3) % tc->channels);
+
+    }
+
+    return HopSequenceOrder(&g_hop, g_hopToolOrder, tc->length, tc->hops);
+
+}
+
+//************************************************************************************
+//
+// Pack the records the case should produce into g_hopToolExpected, from the
+// channel order worked out here.  Returns the number of shuffled passes that were
+// not permutations of the channel list.
+//
+//************************************************************************************
+static uint32_t HopToolExpect(const tHopToolCase *tc, uint32_t seed, uint32_t steps) {
+
+    static uint16_t pass[HOP_CHANNELS_MAX];
+    static uint8_t seen[HOP_CHANNELS_MAX];
+    uint32_t words[SWEEP_BLOCK_STEPS];
+    uint32_t elems = DDSChipStepElems(tc->instance);
+    uint32_t state = (seed != 0) ? seed : HOP_SEED_DEFAULT;
+    uint32_t next = tc->channels;
+    uint32_t notPermutations = 0;
+    uint32_t channel, swap, i, j, k;
+    uint16_t held;
+
+    for (i = 0; i < tc->channels; i++) {
+
+        pass[i] = (uint16_t)i;
+
+    }
+
+    for (i = 0; i < steps; i += SWEEP_BLOCK_STEPS) {
+
+        for (j = 0; j < SWEEP_BLOCK_STEPS; j++) {
+
+            if (tc->length != 0) {
+
+                channel = g_hopToolOrder[(i + j) % tc->length];
+
+            }
+
+            else {
+
+                if (next == tc->channels) {
+
+                    for (k = tc->channels - 1; k > 0; k--) {
+
+                        swap = (uint32_t)(((uint64_t)HopRandom(&state) * (k + 1)) >> 32);
+                        held = pass[k];
+                        pass[k] = pass[swap];
+                        pass[swap] = held;
+
+                    }
+
+                    memset(seen, 0, tc->channels);
+
+                    for (k = 0; k < tc->channels; k++) {
+
+                        seen[pass[k]]++;
+
+                    }
+
+                    notPermutations += (memchr(seen, 0, tc->channels) != 0) ? 1 : 0;
+                    next = 0;
+
+                }
+
+                channel = pass[next++];
+
+            }
+
+            words[j] = DDSTuningFreqWord(&g_hopToolTuning[tc->instance],
+                                         HOP_TOOL_BASE + channel * HOP_TOOL_SPACING);
+
+        }
+
+        SweepPackRecords(tc->instance, words, &g_hopToolExpected[i * elems],
+                         SWEEP_BLOCK_STEPS, g_ad9952Shadow.reg[AD9952_REG_POW0]);
+
+    }
+
+    return notPermutations;
+
+}
+
+//************************************************************************************
+//
+// Play the built sequence and check every hop.  Returns the number of bad hops;
+// the interval spread goes to *spread.
+//
+//************************************************************************************
+static uint32_t HopToolPlay(const tHopToolCase *tc, uint64_t *spread, uint32_t *played) {
+
+    uint32_t ssi = (tc->instance == SSISTREAM_AD9834) ? HAL_SSI_0 : HAL_SSI_3;
+    uint32_t elems = DDSChipStepElems(tc->instance);
+    uint32_t total = (2 * g_hop.hops) + HOP_TOOL_EXTRA;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    uint64_t minGap = UINT64_MAX;
+    uint64_t maxGap = 0;
+    uint32_t bad = 0;
+    uint32_t hop = 0;
+    uint32_t elem = 0;
+    uint64_t at = 0;
+    tHalHostFrame frame;
+    const uint16_t *want;
+
+    while (HalHostSsiRead(ssi, &frame)) {
+
+        // Discard anything from before the start.
+
+    }
+
+    if (!HopStart(&g_hop, tc->dwellCycles, true)) {
+
+        printf("  %-13s FAIL: start refused\n", tc->name);
+        return 1;
+
+    }
+
+    while (hop < total) {
+
+        HalHostAdvance(tc->dwellCycles);
+
+        while ((hop < total) && HalHostSsiRead(ssi, &frame)) {
+
+            want = &g_hop.records[(hop % g_hop.hops) * elems];
+
+            if (elem == 0) {
+
+                at = frame.cycle;
+
+                if (hop == 0) {
+
+                    first = at;
+
+                }
+
+                else {
+
+                    minGap = (at - last < minGap) ? (at - last) : minGap;
+                    maxGap = (at - last > maxGap) ? (at - last) : maxGap;
+
+                }
+
+            }
+
+            if ((frame.frame != want[elem]) || (frame.cycle != at) ||
+                (at != first + (uint64_t)hop * tc->dwellCycles)) {
+
+                if (bad++ == 0) {
+
+                    printf("  %-13s FAIL: hop %u frame %u is %04X at cycle %llu, "
+                           "expected %04X at %llu\n", tc->name, hop, elem, frame.frame,
+                           (unsigned long long)(frame.cycle - first), want[elem],
+                           (unsigned long long)((uint64_t)hop * tc->dwellCycles));
+
+                }
+
+            }
+
+            if (++elem == elems) {
+
+                elem = 0;
+                last = at;
+                hop++;
+
+            }
+
+        }
+
+    }
+
+    HopStop(&g_hop);
+    *spread = maxGap - minGap;
+    *played = hop;
+
+    if ((minGap != tc->dwellCycles) || (maxGap != tc->dwellCycles)) {
+
+        bad++;
+
+    }
+
+    return bad;
+
+}
+
+static uint32_t HopToolRun(const tHopToolCase *tc) {
+
+    uint32_t elems = DDSChipStepElems(tc->instance);
+    uint32_t bad = 0;
+    uint32_t played = 0;
+    uint32_t bytes, badPasses, badHops;
+    uint64_t spread = 0;
+    bool same, again;
+
+    if (!HopToolBuild(tc, tc->seed)) {
+
+        printf("  %-13s FAIL: build refused\n", tc->name);
+        return 1;
+
+    }
+
+    bytes = g_hop.hops * elems * sizeof(uint16_t);
+    memcpy(g_hopToolFirst, g_hop.records, bytes);
+    badPasses = HopToolExpect(tc, tc->seed, g_hop.hops);
+    same = (memcmp(g_hop.records, g_hopToolExpected, bytes) == 0);
+
+    again = HopToolBuild(tc, tc->seed + 1) && HopToolBuild(tc, tc->seed) &&
+            (memcmp(g_hop.records, g_hopToolFirst, bytes) == 0);
+
+    badHops = HopToolPlay(tc, &spread, &played);
+    bad = badPasses + (same ? 0 : 1) + (again ? 0 : 1) + badHops;
+
+    printf("  %-13s %5u hops  sequence %s  reproduce %s  %6u hops played, %u bad, "
+           "spread %llu cycles  %s\n", tc->name, g_hop.hops,
+           (same && (badPasses == 0)) ? "ok" : "FAIL", again ? "ok" : "FAIL", played,
+           badHops, (unsigned long long)spread, (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int HopToolCheck(void) {
+
+    const tHopToolCase *tc = &g_hopToolCases[0];
+    uint32_t bad = 0;
+    uint32_t cases = 0;
+    uint32_t i;
+    bool caught = false;
+    bool pass;
+
+    HopToolBoot();
+
+    if (DDSChipBuilt(tc->instance) && HopToolBuild(tc, tc->seed)) {
+
+        HopToolExpect(tc, tc->seed + 1, g_hop.hops);
+        caught = (memcmp(g_hop.records, g_hopToolExpected,
+                         g_hop.hops * DDSChipStepElems(tc->instance) *
+                         sizeof(uint16_t)) != 0);
+
+    }
+
+    else {
+
+        caught = true;
+
+    }
+
+    printf("  control       next seed's order  %s\n\n",
+           caught ? "caught" : "FAIL: never caught");
+
+    for (i = 0; i < HOP_TOOL_CASES; i++) {
+
+        if (DDSChipBuilt(g_hopToolCases[i].instance)) {
+
+            bad += HopToolRun(&g_hopToolCases[i]);
+            cases++;
+
+        }
+
+    }
+
+    pass = (bad == 0) && caught && (cases != 0);
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static int HopToolBench(void) {
+
+    static const uint32_t sizes[] = { 256, 1024, 4096 };
+    static const char *names[] = { "ad9834", "ad9952" };
+    tHopToolCase tc;
+    struct timespec t0, t1;
+    double ns, best, worst, sum;
+    uint32_t instance, s, seed;
+
+    HopToolBoot();
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        if (!DDSChipBuilt(instance)) {
+
+            continue;
+
+        }
+
+        for (s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++) {
+
+            memset(&tc, 0, sizeof(tc));
+            tc.instance = instance;
+            tc.channels = sizes[s];
+            HopLoadGrid(&g_hop, instance, &g_hopToolTuning[instance], HOP_TOOL_BASE,
+                        HOP_TOOL_SPACING, tc.channels);
+            best = 1e30;
+            worst = 0;
+            sum = 0;
+
+            for (seed = 1; seed <= HOP_TOOL_BENCH_SEEDS; seed++) {
+
+                clock_gettime(CLOCK_MONOTONIC, &t0);
+                HopSequenceShuffle(&g_hop, seed * 0x9E3779B9, HopStepsMax(&g_hop));
+                clock_gettime(CLOCK_MONOTONIC, &t1);
+                ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 +
+                      (double)(t1.tv_nsec - t0.tv_nsec)) / g_hop.hops;
+                best = (ns < best) ? ns : best;
+                worst = (ns > worst) ? ns : worst;
+                sum += ns;
+
+            }
+
+            printf("  %s %4u channels  %5u hops  %6.2f ns/hop  (%.2f .. %.2f over %u "
+                   "seeds)\n", names[instance], tc.channels, g_hop.hops,
+                   sum / HOP_TOOL_BENCH_SEEDS, best, worst, HOP_TOOL_BENCH_SEEDS);
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    if ((argc != 2) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return HopToolCheck();
+
+    }
+
+    return HopToolBench();
+
+}
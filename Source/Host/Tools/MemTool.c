@@ -0,0 +1,720 @@
+//************************************************************************************
+//
+// Title:               Memory Arena and Pool Check
+// Author:              Jacob Putz
+// Filename:            MemTool.c
+//
+// Description:     Registers pools in the host arena and checks the arena and
+//                      pool limits, exhaustion and recovery, and the lock-free free
+//                      list under threads allocating and freeing at once.  The bench
+//                      measures alloc/free cost against malloc().
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/mem_tool, without Host/MemHost.c, since the
+//  tool supplies the port: the same arena, and a compare-and-swap that can yield
+//  to another thread first.
+//
+//  Usage:
+//
+//      mem_tool check                  every case below
+//      mem_tool bench [pairs]          ns per alloc/free pair, pools against malloc()
+//
+//  Each case starts from MemInit(), so the arena (the size of ARENA in
+//  tm4c1294ncpdt.cmd) is empty and no pools are registered.
+//
+//  arena       allocations honour their alignment and never overlap; a bad
+//              alignment and an allocation past the end return NULL and the
+//              latter is counted, leaving the arena as it was.
+//  limits      pools of zero blocks, of more than MEM_POOL_BLOCKS_MAX, larger
+//              than the arena left, or beyond MEM_POOLS_MAX are refused.
+//  exhaustion  a pool hands out every block once, aligned and inside the pool,
+//              then refuses and counts the failure; the high-water mark is the
+//              pool size.  Freed in a shuffled order, every block comes back.
+//  stress      MEM_TOOL_THREADS threads allocate and free at random from one
+//              pool, asking for more blocks between them than it holds.  Each
+//              fills its blocks with its own pattern and checks it on free, so a
+//              block handed to two owners at once shows up.  Afterwards nothing
+//              is in use and the free list holds every block exactly once.  One
+//              CAS in MEM_TOOL_YIELD_EVERY yields first, so another thread runs
+//              between a pop reading the link and its CAS, the window an
+//              interrupt on the target would land in, far more often than
+//              pre-emption alone manages (the host may have a single core).
+//
+//  A negative control frees one block twice and the free-list walk has to catch
+//  it.  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Mem.h"
+
+// Defines
+#define     MEM_TOOL_INDEX(head)    ((head) & 0xFFFF)       // See Mem.h
+#define     MEM_TOOL_THREADS        4
+#define     MEM_TOOL_HELD_MAX       96          // Per thread; 4 x 96 > MEM_TOOL_BLOCKS
+#define     MEM_TOOL_BLOCKS         256
+#define     MEM_TOOL_BLOCK_BYTES    40
+#define     MEM_TOOL_OPS            2000000     // Per thread
+#define     MEM_TOOL_SEED           0x5EED1234
+#define     MEM_TOOL_BENCH          10000000
+#define     MEM_TOOL_ARENA_BYTES    0x00010000  // ARENA in tm4c1294ncpdt.cmd
+#define     MEM_TOOL_YIELD_EVERY    16
+
+// Type Definitions
+typedef struct {
+
+    tMemPool *pool;
+    uint32_t id;
+    uint32_t random;
+    uint32_t allocs;
+    uint32_t refused;
+    uint32_t corrupt;               // Blocks whose pattern changed while held
+
+} tMemToolThread;
+
+// Global Variables
+static uint8_t g_memToolArena[MEM_TOOL_ARENA_BYTES] __attribute__((aligned(MEM_ALIGN)));
+static volatile bool g_memToolYield;
+static __thread uint32_t g_memToolCasCount;
+
+//************************************************************************************
+//
+// Memory port, as Host/MemHost.c
+//
+//************************************************************************************
+void MemPortArena(uint8_t **base, uint32_t *size) {
+
+    *base = g_memToolArena;
+    *size = MEM_TOOL_ARENA_BYTES;
+
+}
+
+bool MemPortCas(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+
+    if (g_memToolYield && ((++g_memToolCasCount % MEM_TOOL_YIELD_EVERY) == 0)) {
+
+        sched_yield();
+
+    }
+
+    return __atomic_compare_exchange_n(word, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+
+}
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t MemToolRandom(uint32_t *state) {
+
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// Walk the free list.  Returns the number of blocks on it, or count + 1 if it
+// names a block twice, runs off the pool or does not end.
+//
+//************************************************************************************
+static uint32_t MemToolFreeList(const tMemPool *pool) {
+
+    static uint8_t seen[MEM_POOL_BLOCKS_MAX];
+    uint32_t index = MEM_TOOL_INDEX(pool->head);
+    uint32_t length = 0;
+
+    memset(seen, 0, pool->count);
+
+    while (index != MEM_NIL) {
+
+        if ((index >= pool->count) || seen[index]) {
+
+            return pool->count + 1;
+
+        }
+
+        seen[index] = 1;
+        length++;
+        index = *(const uint32_t *)(pool->base + (index * pool->blockSize));
+
+    }
+
+    return length;
+
+}
+
+//************************************************************************************
+//
+// arena
+//
+//************************************************************************************
+static uint32_t MemToolArena(void) {
+
+    static const uint32_t aligns[] = { 1, 2, 4, 8, 16, 64, 256, 1024 };
+    uint8_t *last = NULL;
+    uint8_t *block;
+    uint32_t lastSize = 0;
+    uint32_t bad = 0;
+    uint32_t used, failures, size, i;
+
+    MemInit();
+
+    for (i = 0; i < 64; i++) {
+
+        size = 1 + ((i * 37) % 300);
+        block = MemArenaAlloc(size, aligns[i % 8]);
+
+        if ((block == NULL) || (((uintptr_t)block & (aligns[i % 8] - 1)) != 0) ||
+            ((last != NULL) && (block < (last + lastSize)))) {
+
+            bad++;
+
+        }
+
+        last = block;
+        lastSize = size;
+
+    }
+
+    used = g_mem.used;
+    failures = g_mem.failures;
+
+    if ((MemArenaAlloc(16, 3) != NULL) || (MemArenaAlloc(16, 0) != NULL) ||
+        (g_mem.used != used)) {
+
+        bad++;
+
+    }
+
+    if ((MemArenaAlloc(MemArenaFree() + 1, 1) != NULL) || (g_mem.used != used) ||
+        (g_mem.failures != failures + 1)) {
+
+        bad++;
+
+    }
+
+    if ((MemArenaAlloc(MemArenaFree(), 1) == NULL) || (MemArenaFree() != 0) ||
+        (MemArenaAlloc(1, 1) != NULL)) {
+
+        bad++;
+
+    }
+
+    printf("  arena       %u bytes  64 allocations  %u bad  %s\n", g_mem.size, bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// limits
+//
+//************************************************************************************
+static uint32_t MemToolLimits(void) {
+
+    static tMemPool pools[MEM_POOLS_MAX + 1];
+    uint32_t bad = 0;
+    uint32_t used, i;
+
+    MemInit();
+
+    if (MemPoolInit(&pools[0], "zero", 8, 0) ||
+        MemPoolInit(&pools[0], "too many", 8, MEM_POOL_BLOCKS_MAX + 1)) {
+
+        bad++;
+
+    }
+
+    used = g_mem.used;
+
+    if (MemPoolInit(&pools[0], "too big", 1024, (MemArenaFree() / 1024) + 1) ||
+        (g_mem.used != used) || (g_mem.poolCount != 0)) {
+
+        bad++;
+
+    }
+
+    for (i = 0; i < MEM_POOLS_MAX; i++) {
+
+        if (!MemPoolInit(&pools[i], "small", 8, 4) || (g_mem.pools[i] != &pools[i])) {
+
+            bad++;
+
+        }
+
+    }
+
+    if (MemPoolInit(&pools[MEM_POOLS_MAX], "one more", 8, 4) ||
+        (g_mem.poolCount != MEM_POOLS_MAX)) {
+
+        bad++;
+
+    }
+
+    printf("  limits      %u pools registered  %u bad  %s\n", g_mem.poolCount, bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// exhaustion
+//
+//************************************************************************************
+static uint32_t MemToolExhaustion(void) {
+
+    static tMemPool pool;
+    static uint8_t *blocks[MEM_TOOL_BLOCKS];
+    uint32_t state = MEM_TOOL_SEED;
+    uint32_t bad = 0;
+    uint32_t round, i, j;
+    uint8_t *held;
+
+    MemInit();
+
+    if (!MEM_POOL_INIT_TYPE(&pool, "exhaust", uint8_t[MEM_TOOL_BLOCK_BYTES],
+                            MEM_TOOL_BLOCKS)) {
+
+        printf("  exhaustion  FAIL: pool refused\n");
+        return 1;
+
+    }
+
+    for (round = 0; round < 3; round++) {
+
+        for (i = 0; i < MEM_TOOL_BLOCKS; i++) {
+
+            blocks[i] = MemPoolAlloc(&pool);
+
+            if ((blocks[i] == NULL) || (((uintptr_t)blocks[i] & (MEM_ALIGN - 1)) != 0) ||
+                (blocks[i] < pool.base) ||
+                (blocks[i] >= (pool.base + (pool.count * pool.blockSize))) ||
+                (((blocks[i] - pool.base) % pool.blockSize) != 0)) {
+
+                bad++;
+                continue;
+
+            }
+
+            memset(blocks[i], (int)i, pool.blockSize);
+
+        }
+
+        for (i = 0; i < MEM_TOOL_BLOCKS; i++) {
+
+            for (j = 0; j < pool.blockSize; j++) {
+
+                if ((blocks[i] != NULL) && (blocks[i][j] != (uint8_t)i)) {
+
+                    bad++;
+                    break;
+
+                }
+
+            }
+
+        }
+
+        if ((MemPoolAlloc(&pool) != NULL) || (pool.failures != round + 1) ||
+            (pool.inUse != MEM_TOOL_BLOCKS) || (pool.highWater != MEM_TOOL_BLOCKS) ||
+            (MemToolFreeList(&pool) != 0)) {
+
+            bad++;
+
+        }
+
+        //
+        // Free in a shuffled order
+        //
+        for (i = MEM_TOOL_BLOCKS - 1; i > 0; i--) {
+
+            j = MemToolRandom(&state) % (i + 1);
+            held = blocks[i];
+            blocks[i] = blocks[j];
+            blocks[j] = held;
+
+        }
+
+        for (i = 0; i < MEM_TOOL_BLOCKS; i++) {
+
+            MemPoolFree(&pool, blocks[i]);
+
+        }
+
+        if ((pool.inUse != 0) || (MemToolFreeList(&pool) != MEM_TOOL_BLOCKS)) {
+
+            bad++;
+
+        }
+
+    }
+
+    printf("  exhaustion  %u blocks x 3 rounds  failures %u  high water %u  %u bad  %s\n",
+           MEM_TOOL_BLOCKS, pool.failures, pool.highWater, bad, (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// stress
+//
+//************************************************************************************
+static void *MemToolWorker(void *arg) {
+
+    tMemToolThread *thread = arg;
+    uint32_t *held[MEM_TOOL_HELD_MAX];
+    uint32_t words = thread->pool->blockSize / sizeof(uint32_t);
+    uint32_t count = 0;
+    uint32_t serial = 0;
+    uint32_t op, pick, pattern, i;
+    uint32_t *block;
+
+    for (op = 0; op < MEM_TOOL_OPS; op++) {
+
+        if ((count < MEM_TOOL_HELD_MAX) &&
+            ((count == 0) || ((MemToolRandom(&thread->random) & 1) != 0))) {
+
+            block = MemPoolAlloc(thread->pool);
+
+            if (block == NULL) {
+
+                thread->refused++;
+                continue;
+
+            }
+
+            pattern = (thread->id << 24) | (++serial & 0x00FFFFFF);
+
+            for (i = 0; i < words; i++) {
+
+                block[i] = pattern;
+
+            }
+
+            held[count++] = block;
+            thread->allocs++;
+
+        }
+
+        else {
+
+            pick = MemToolRandom(&thread->random) % count;
+            block = held[pick];
+            held[pick] = held[--count];
+
+            for (i = 1; i < words; i++) {
+
+                if (block[i] != block[0]) {
+
+                    thread->corrupt++;
+                    break;
+
+                }
+
+            }
+
+            if ((block[0] >> 24) != thread->id) {
+
+                thread->corrupt++;
+
+            }
+
+            MemPoolFree(thread->pool, block);
+
+        }
+
+    }
+
+    while (count != 0) {
+
+        MemPoolFree(thread->pool, held[--count]);
+
+    }
+
+    return NULL;
+
+}
+
+static uint32_t MemToolStress(void) {
+
+    static tMemPool pool;
+    tMemToolThread threads[MEM_TOOL_THREADS];
+    pthread_t handles[MEM_TOOL_THREADS];
+    uint32_t allocs = 0;
+    uint32_t refused = 0;
+    uint32_t corrupt = 0;
+    uint32_t length, i;
+    bool pass;
+
+    MemInit();
+
+    if (!MemPoolInit(&pool, "stress", MEM_TOOL_BLOCK_BYTES, MEM_TOOL_BLOCKS)) {
+
+        printf("  stress      FAIL: pool refused\n");
+        return 1;
+
+    }
+
+    g_memToolYield = true;
+
+    for (i = 0; i < MEM_TOOL_THREADS; i++) {
+
+        memset(&threads[i], 0, sizeof(threads[i]));
+        threads[i].pool = &pool;
+        threads[i].id = i + 1;
+        threads[i].random = MEM_TOOL_SEED + i;
+        pthread_create(&handles[i], NULL, MemToolWorker, &threads[i]);
+
+    }
+
+    for (i = 0; i < MEM_TOOL_THREADS; i++) {
+
+        pthread_join(handles[i], NULL);
+        allocs += threads[i].allocs;
+        refused += threads[i].refused;
+        corrupt += threads[i].corrupt;
+
+    }
+
+    g_memToolYield = false;
+
+    length = MemToolFreeList(&pool);
+    pass = (corrupt == 0) && (pool.inUse == 0) && (length == MEM_TOOL_BLOCKS) &&
+           (pool.failures == refused) && (pool.highWater <= MEM_TOOL_BLOCKS);
+
+    printf("  stress      %u threads  %u allocations  %u refused  high water %u  "
+           "%u corrupt  free list %u of %u  %s\n", MEM_TOOL_THREADS, allocs, refused,
+           pool.highWater, corrupt, length, MEM_TOOL_BLOCKS, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int MemToolCheck(void) {
+
+    static tMemPool pool;
+    uint32_t bad = 0;
+    uint8_t *a;
+    bool caught;
+    bool pass;
+
+    MemInit();
+    MemPoolInit(&pool, "control", 16, 8);
+    a = MemPoolAlloc(&pool);
+    MemPoolAlloc(&pool);
+    MemPoolFree(&pool, a);
+    MemPoolFree(&pool, a);
+    caught = (MemToolFreeList(&pool) != 7);
+    printf("  control     double free  %s\n\n", caught ? "caught" : "FAIL: never caught");
+
+    bad += MemToolArena();
+    bad += MemToolLimits();
+    bad += MemToolExhaustion();
+    bad += MemToolStress();
+
+    pass = (bad == 0) && caught;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  A pair is one alloc and one free; the burst rows take a run of blocks
+// before giving them back, so the free list is exercised deeper than its head.
+// On a host every CAS is a locked cmpxchg, so a pair costs more than the C
+// library's per-thread cache; what the pool buys on the target is a bounded time
+// from any context, not raw speed.
+//
+//************************************************************************************
+static double MemToolElapsed(const struct timespec *t0, const struct timespec *t1) {
+
+    return (double)(t1->tv_sec - t0->tv_sec) * 1e9 + (double)(t1->tv_nsec - t0->tv_nsec);
+
+}
+
+static int MemToolBench(uint32_t pairs) {
+
+    static const uint32_t sizes[] = { 16, 64, 256 };
+    static tMemPool pools[3];
+    static void *blocks[64];
+    struct timespec t0, t1;
+    double poolNs, mallocNs;
+    uint32_t s, done, i;
+
+    MemInit();
+
+    for (s = 0; s < 3; s++) {
+
+        MemPoolInit(&pools[s], "bench", sizes[s], 64);
+
+    }
+
+    for (s = 0; s < 3; s++) {
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (done = 0; done < pairs; done++) {
+
+            MemPoolFree(&pools[s], MemPoolAlloc(&pools[s]));
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        poolNs = MemToolElapsed(&t0, &t1) / pairs;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (done = 0; done < pairs; done++) {
+
+            blocks[0] = malloc(sizes[s]);
+            *(volatile uint8_t *)blocks[0] = 0;
+            free(blocks[0]);
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        mallocNs = MemToolElapsed(&t0, &t1) / pairs;
+
+        printf("  %3u bytes  single  pool %6.2f ns/pair  malloc %6.2f ns/pair\n",
+               sizes[s], poolNs, mallocNs);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (done = 0; done < pairs; done += 64) {
+
+            for (i = 0; i < 64; i++) {
+
+                blocks[i] = MemPoolAlloc(&pools[s]);
+
+            }
+
+            for (i = 0; i < 64; i++) {
+
+                MemPoolFree(&pools[s], blocks[i]);
+
+            }
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        poolNs = MemToolElapsed(&t0, &t1) / done;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (done = 0; done < pairs; done += 64) {
+
+            for (i = 0; i < 64; i++) {
+
+                blocks[i] = malloc(sizes[s]);
+                *(volatile uint8_t *)blocks[i] = 0;
+
+            }
+
+            for (i = 0; i < 64; i++) {
+
+                free(blocks[i]);
+
+            }
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        mallocNs = MemToolElapsed(&t0, &t1) / done;
+
+        printf("  %3u bytes  burst   pool %6.2f ns/pair  malloc %6.2f ns/pair\n",
+               sizes[s], poolNs, mallocNs);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t pairs = 0;
+
+    if (argc >= 3) {
+
+        pairs = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (pairs == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [pairs]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return MemToolCheck();
+
+    }
+
+    return MemToolBench((pairs != 0) ? pairs : MEM_TOOL_BENCH);
+
+}
@@ -0,0 +1,489 @@
+//************************************************************************************
+//
+// Title:               Modulator Symbol Timing Check
+// Author:              Jacob Putz
+// Filename:            ModTool.c
+//
+// Description:     Runs the FSELECT/PSELECT modulator on the simulated HAL with the
+//                      main loop servicing its refills, records every change on the
+//                      select lines, and checks each one against the symbol the input
+//                      bitstream calls for at that symbol boundary.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/mod_tool.
+//
+//  Usage:
+//
+//      mod_tool check                  every case below, exact timing
+//      mod_tool bench [symbols]        host cost of expanding symbols, per mode
+//
+//  Each case configures the modulator with a bitstream, starts it, and runs the
+//  main loop (SchedulerPoll()) for a whole number of symbols, so the refill task
+//  runs on its schedule exactly as on the target.  The symbol timer's handler is
+//  the host port's stand-in for the uDMA writing the GPIO data register, one
+//  table entry per period.  The select lines are watched (HalHostGpioWatch()) and
+//  every change is recorded with its cycle.
+//
+//  The expected waveform is worked out here from the bitstream and the table in
+//  Modulation.h, not by ModulationExpand(): symbol k covers bits k * b onwards
+//  (b bits per symbol, MSB first, a trailing partial symbol dropped), wraps for a
+//  repeating stream and is the idle symbol (both lines low) once a one-shot stream
+//  is exhausted.  It is driven at start + (k + 1) * symbolCycles.  check passes if
+//  the recorded changes are exactly the expected ones -- same cycles, same states,
+//  none missing or extra -- for every case, with no underruns.
+//
+//  A negative control runs first: the longest case with the main loop starved, so
+//  the refill never runs and the third block replays the first.  The comparison
+//  has to catch it.  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "DDSChip.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
+
+// Defines
+#define     MOD_TOOL_PINS           (MOD_FSELECT | MOD_PSELECT)
+#define     MOD_TOOL_EVENTS         65536
+#define     MOD_TOOL_BITS_MAX       8192
+#define     MOD_TOOL_SEED           0x5EED1234
+#define     MOD_TOOL_BENCH          20000000
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint32_t mode;
+    uint32_t bitCount;
+    uint32_t symbolCycles;
+    bool repeat;
+    uint32_t symbols;               // Symbol periods to run
+
+} tModToolCase;
+
+typedef struct {
+
+    uint64_t cycle;
+    uint8_t state;
+
+} tModToolEvent;
+
+// Global Constants
+//
+// 1200 and 9600 baud, then 1, 2 and 4 Msym/s
+static const tModToolCase g_modToolCases[] = {
+
+    { "fsk 1200",       MOD_MODE_FSK,       64,     100000, true,   200 },
+    { "psk 9600",       MOD_MODE_PSK,       1000,   12500,  false,  1500 },
+    { "quad 1M",        MOD_MODE_QUAD,      4099,   120,    true,   20000 },
+    { "fsk 2M",         MOD_MODE_FSK,       8192,   60,     false,  9000 },
+    { "ask 4M",         MOD_MODE_ASK_PHASE, 3000,   30,     true,   40000 },
+
+};
+
+#define     MOD_TOOL_CASES          (sizeof(g_modToolCases) / sizeof(g_modToolCases[0]))
+#define     MOD_TOOL_CONTROL        2           // Runs past two blocks
+
+// Global Variables
+static uint8_t g_modToolBits[MOD_TOOL_BITS_MAX / 8];
+static tModToolEvent g_modToolEvents[MOD_TOOL_EVENTS];
+static uint32_t g_modToolEventCount;
+static uint32_t g_modToolRandom;
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t ModToolRandom(void) {
+
+    uint32_t x = g_modToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_modToolRandom = x;
+
+    return x;
+
+}
+
+static void ModToolGpioWatch(uint32_t port, uint8_t before, uint8_t after) {
+
+    if ((port != HAL_PORT_K) || (((before ^ after) & MOD_TOOL_PINS) == 0)) {
+
+        return;
+
+    }
+
+    if (g_modToolEventCount < MOD_TOOL_EVENTS) {
+
+        g_modToolEvents[g_modToolEventCount].cycle = HalHostCycles();
+        g_modToolEvents[g_modToolEventCount].state = after & MOD_TOOL_PINS;
+
+    }
+
+    g_modToolEventCount++;
+
+}
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c).
+//
+//************************************************************************************
+static void ModToolBoot(void) {
+
+    uint32_t sysClkHz = BootHostRun(false);
+
+    //
+    // Boot.c leaves the modulator's port out of builds without the AD9834
+    //
+    if (!DDSChipBuilt(SSISTREAM_AD9834)) {
+
+        ModulationPortInit(sysClkHz);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Select lines for symbol k of the bitstream, from the table in Modulation.h.
+//
+//************************************************************************************
+static uint8_t ModToolBit(uint32_t pos) {
+
+    return (g_modToolBits[pos >> 3] >> (7 - (pos & 7))) & 1;
+
+}
+
+static uint8_t ModToolExpected(const tModToolCase *tc, uint32_t k) {
+
+    uint32_t per = (tc->mode == MOD_MODE_QUAD) ? 2 : 1;
+    uint32_t usable = tc->bitCount - (tc->bitCount % per);
+    uint64_t pos = (uint64_t)k * per;
+
+    if (pos >= usable) {
+
+        if (!tc->repeat) {
+
+            return 0;
+
+        }
+
+        pos %= usable;
+
+    }
+
+    switch (tc->mode) {
+
+        case MOD_MODE_FSK:
+
+            return ModToolBit(pos) ? MOD_FSELECT : 0;
+
+        case MOD_MODE_QUAD:
+
+            return (ModToolBit(pos) ? MOD_PSELECT : 0) |
+                   (ModToolBit(pos + 1) ? MOD_FSELECT : 0);
+
+        default:
+
+            return ModToolBit(pos) ? MOD_PSELECT : 0;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Run one case and compare.  starve skips the main loop, for the control.  Returns
+// the number of mismatches and prints the first.
+//
+//************************************************************************************
+static uint32_t ModToolRun(const tModToolCase *tc, bool starve, bool quiet) {
+
+    tModulator *mod = &g_modulator;
+    uint64_t start, end;
+    uint32_t bad = 0;
+    uint32_t next = 0;
+    uint32_t edges = 0;
+    uint8_t state = 0;
+    uint32_t i, k;
+
+    g_modToolRandom = MOD_TOOL_SEED ^ tc->bitCount;
+
+    for (i = 0; i < sizeof(g_modToolBits); i++) {
+
+        g_modToolBits[i] = (uint8_t)ModToolRandom();
+
+    }
+
+    if (!ModulationConfigure(mod, tc->mode, g_modToolBits, tc->bitCount,
+                             tc->symbolCycles, tc->repeat)) {
+
+        printf("  %-10s FAIL: configuration rejected\n", tc->name);
+        return 1;
+
+    }
+
+    g_modToolEventCount = 0;
+    HalHostGpioWatch(ModToolGpioWatch);
+
+    start = HalHostCycles();
+    end = start + ((uint64_t)tc->symbols * tc->symbolCycles);
+    ModulationStart(mod);
+
+    if (starve) {
+
+        HalHostAdvance(end - start);
+
+    }
+
+    else {
+
+        while (HalHostCycles() < end) {
+
+            SchedulerPoll();
+
+        }
+
+    }
+
+    //
+    // The stop drives both lines low at end, which is not part of the comparison.
+    //
+    HalHostGpioWatch(0);
+    ModulationStop(mod);
+
+    //
+    // Walk the expected changes in step with the recorded ones.
+    //
+    for (k = 0; k < tc->symbols; k++) {
+
+        uint8_t want = ModToolExpected(tc, k);
+        uint64_t at = start + ((uint64_t)(k + 1) * tc->symbolCycles);
+
+        if (want == state) {
+
+            continue;
+
+        }
+
+        state = want;
+        edges++;
+
+        if ((next >= g_modToolEventCount) || (next >= MOD_TOOL_EVENTS) ||
+            (g_modToolEvents[next].cycle != at) || (g_modToolEvents[next].state != want)) {
+
+            if ((bad++ == 0) && !quiet) {
+
+                printf("  %-10s FAIL: symbol %u should drive %X at cycle %llu\n",
+                       tc->name, k, want, (unsigned long long)(at - start));
+
+            }
+
+            //
+            // Resynchronise on the recorded change at or after this one.
+            //
+            while ((next < g_modToolEventCount) && (next < MOD_TOOL_EVENTS) &&
+                   (g_modToolEvents[next].cycle <= at)) {
+
+                next++;
+
+            }
+
+            continue;
+
+        }
+
+        next++;
+
+    }
+
+    while ((next < g_modToolEventCount) && (next < MOD_TOOL_EVENTS) &&
+           (g_modToolEvents[next].cycle <= end)) {
+
+        if ((bad++ == 0) && !quiet) {
+
+            printf("  %-10s FAIL: extra change to %X at cycle %llu\n", tc->name,
+                   g_modToolEvents[next].state,
+                   (unsigned long long)(g_modToolEvents[next].cycle - start));
+
+        }
+
+        next++;
+
+    }
+
+    if (!starve && (mod->underruns != 0)) {
+
+        if ((bad++ == 0) && !quiet) {
+
+            printf("  %-10s FAIL: %u underruns\n", tc->name, mod->underruns);
+
+        }
+
+    }
+
+    if (!quiet) {
+
+        printf("  %-10s %6u symbols of %6u cycles  %6u edges  %u bad  %s\n", tc->name,
+               tc->symbols, tc->symbolCycles, edges, bad, (bad == 0) ? "ok" : "FAIL");
+
+    }
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int ModToolCheck(void) {
+
+    uint32_t bad = 0;
+    uint32_t caught;
+    uint32_t i;
+    bool pass;
+
+    ModToolBoot();
+
+    caught = ModToolRun(&g_modToolCases[MOD_TOOL_CONTROL], true, true);
+    printf("  control    starved refill  %u mismatches  %s\n\n", caught,
+           (caught != 0) ? "caught" : "FAIL: never caught");
+
+    for (i = 0; i < MOD_TOOL_CASES; i++) {
+
+        bad += ModToolRun(&g_modToolCases[i], false, false);
+
+    }
+
+    pass = (bad == 0) && (caught != 0);
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  ModulationExpand() is the only per-symbol work the CPU does; the rest is
+// the timer and uDMA.
+//
+//************************************************************************************
+static int ModToolBench(uint32_t symbols) {
+
+    static const char *names[] = { "fsk", "psk", "quad", "ask" };
+    tModulator *mod = &g_modulator;
+    uint8_t block[MOD_BLOCK_SYMBOLS];
+    struct timespec t0, t1;
+    uint32_t mode, done;
+    double ns;
+
+    g_modToolRandom = MOD_TOOL_SEED;
+
+    for (done = 0; done < sizeof(g_modToolBits); done++) {
+
+        g_modToolBits[done] = (uint8_t)ModToolRandom();
+
+    }
+
+    for (mode = MOD_MODE_FSK; mode <= MOD_MODE_ASK_PHASE; mode++) {
+
+        ModulationConfigure(mod, mode, g_modToolBits, MOD_TOOL_BITS_MAX, 120, true);
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (done = 0; done < symbols; done += MOD_BLOCK_SYMBOLS) {
+
+            ModulationExpand(mod, block, MOD_BLOCK_SYMBOLS);
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec)) /
+             done;
+        printf("  %-5s %6.2f ns/symbol  %7.1f Msym/s\n", names[mode], ns, 1e3 / ns);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t symbols = 0;
+
+    if (argc >= 3) {
+
+        symbols = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (symbols == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [symbols]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return ModToolCheck();
+
+    }
+
+    return ModToolBench((symbols != 0) ? symbols : MOD_TOOL_BENCH);
+
+}
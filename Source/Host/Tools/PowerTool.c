@@ -0,0 +1,558 @@
+//************************************************************************************
+//
+// Title:               Power Manager Check and Bench
+// Author:              Jacob Putz
+// Filename:            PowerTool.c
+//
+// Description:     Runs idle, sweep and hop workloads through the scheduler's
+//                      sleep path on the simulated HAL and checks the power
+//                      manager's decisions, its deep-sleep wakes against their
+//                      deadlines and the relock budget's recovery from a slow
+//                      relock.  Reports the wake margins and the estimated energy
+//                      per hour of each workload.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/power_tool.
+//
+//  Usage:
+//
+//      power_tool check                every workload below, then the relock case
+//      power_tool bench [seconds]      energy per hour against the relock time
+//
+//  Each workload runs for simulated seconds under SchedulerPoll(), as the main
+//  loop does, with a 100 ms background task standing in for the LEDs:
+//
+//  idle            the background task alone
+//  sweep bursts    a 1000-step sweep at 100 us a step for 100 ms of every second
+//  hop bursts      a 64-channel hop sequence at 100 us a dwell for 50 ms of every
+//                  second
+//  sweep           the same sweep, never stopped
+//
+//  The sweep's step is long enough that its refill task leaves gaps deep sleep
+//  would take, and the hop engine has no task at all, so only the busy hold
+//  keeps either out of deep sleep.
+//
+//  For each, every logged decision must follow the rule in Power.h for its gap
+//  and holds, no deep wake may come back after its deadline, deep sleep must be
+//  taken when idle and never while an engine runs (counted here, not from the
+//  power manager's own holds), and the idle workload must cost the least energy
+//  and the continuous sweep the most.  The report gives
+//  each workload's decisions, time in each state, the worst deep wake margin
+//  against the relock budget, and the simulator's current and energy estimate
+//  (HalHost.c: rough TM4C1294 figures, for ranking workloads).
+//
+//  relock      the simulated relock takes longer than the initial budget.  The
+//              first deep wake must come back late (the negative control: the
+//              check has to see it), the budget must rise to cover the relock,
+//              and no later wake may be late.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "DDSChip.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Hop.h"
+#include "Power.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     POWER_TOOL_SECONDS      10
+#define     POWER_TOOL_BENCH        60
+#define     POWER_TOOL_BLINK_US     100000
+#define     POWER_TOOL_BURST_US     1000000
+#define     POWER_TOOL_SLOW_RELOCK  "900"   // us, against POWER_RELOCK_US
+#define     POWER_TOOL_STEP_CYCLES  12000   // 100 us sweep steps and hop dwells
+
+// Workloads
+#define     POWER_TOOL_IDLE         0
+#define     POWER_TOOL_SWEEPS       1
+#define     POWER_TOOL_HOPS         2
+#define     POWER_TOOL_SWEEP        3
+#define     POWER_TOOL_WORKLOADS    4
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint32_t onUs;                  // Engine time per POWER_TOOL_BURST_US, 0 never,
+                                    // POWER_TOOL_BURST_US always
+
+} tPowerToolWorkload;
+
+typedef struct {
+
+    tHalHostPower sim;
+    uint32_t decisions[POWER_STATE_COUNT];
+    uint32_t lateWakes;
+    int32_t marginMinUs;
+    uint32_t relockUs;
+    uint32_t badDecisions;
+    uint32_t deepWhileOn;           // Deep sleeps while an engine ran
+    uint32_t refused;               // Engine starts refused
+
+} tPowerToolResult;
+
+// Global Constants
+static const tPowerToolWorkload g_powerToolWorkloads[POWER_TOOL_WORKLOADS] = {
+
+    { "idle",           0 },
+    { "sweep bursts",   100000 },
+    { "hop bursts",     50000 },
+    { "sweep",          POWER_TOOL_BURST_US },
+
+};
+
+// Global Variables
+static tDDSTuning g_powerToolTuning[SSISTREAM_COUNT];
+static uint32_t g_powerToolInstance;
+static uint32_t g_powerToolWorkload;
+static bool g_powerToolOn;
+static uint32_t g_powerToolRefused;         // Engine starts refused
+static uint32_t g_powerToolDeepAtOn;        // Deep decisions when the engine started
+static uint32_t g_powerToolDeepWhileOn;
+static tSchedTask g_powerToolBlinkTask;
+static tSchedTask g_powerToolBurstTask;
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c), and a tuning context per part.  Called again
+// for each workload, which the simulator treats as a warm restart.
+//
+//************************************************************************************
+static void PowerToolBoot(void) {
+
+    uint32_t i;
+
+    BootHostRun(false);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i)) {
+
+            DDSChipTuningInit(i, &g_powerToolTuning[i]);
+
+        }
+
+    }
+
+    g_powerToolInstance = DDSChipBuilt(SSISTREAM_AD9952) ? SSISTREAM_AD9952 :
+                                                           SSISTREAM_AD9834;
+
+}
+
+//************************************************************************************
+//
+// The background task, standing in for the LED patterns.
+//
+//************************************************************************************
+static void PowerToolBlink(tSchedTask *task, uint64_t now) {
+
+    (void)now;
+
+    SchedulerDefer(task, POWER_TOOL_BLINK_US);
+
+}
+
+//************************************************************************************
+//
+// Start the workload's engine, and for a burst workload stop it onUs later.
+//
+//************************************************************************************
+static void PowerToolEngine(bool on) {
+
+    uint32_t instance = g_powerToolInstance;
+
+    //
+    // Decisions are made between tasks, so the deep ones between here and the
+    // engine stopping are exactly those taken while it ran
+    //
+    if (!on) {
+
+        g_powerToolDeepWhileOn += g_power.decisions[POWER_STATE_DEEP] -
+                                  g_powerToolDeepAtOn;
+
+        if (g_powerToolWorkload == POWER_TOOL_HOPS) {
+
+            HopStop(&g_hop);
+
+        }
+
+        else {
+
+            SweepStop(&g_sweep);
+
+        }
+
+    }
+
+    else if (g_powerToolWorkload == POWER_TOOL_HOPS) {
+
+        g_powerToolRefused += HopStart(&g_hop, POWER_TOOL_STEP_CYCLES, true) ? 0 : 1;
+
+    }
+
+    else if (!SweepConfigure(&g_sweep, instance, &g_powerToolTuning[instance],
+                             SWEEP_SHAPE_LINEAR, DDS_HZ(1000000), DDS_HZ(10000000),
+                             1000, POWER_TOOL_STEP_CYCLES, true) ||
+             !SweepStart(&g_sweep)) {
+
+        g_powerToolRefused++;
+
+    }
+
+    g_powerToolOn = on;
+    g_powerToolDeepAtOn = g_power.decisions[POWER_STATE_DEEP];
+
+}
+
+static void PowerToolBurst(tSchedTask *task, uint64_t now) {
+
+    uint32_t onUs = g_powerToolWorkloads[g_powerToolWorkload].onUs;
+
+    (void)now;
+
+    PowerToolEngine(!g_powerToolOn);
+
+    if (onUs < POWER_TOOL_BURST_US) {
+
+        SchedulerDefer(task, g_powerToolOn ? onUs : (POWER_TOOL_BURST_US - onUs));
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Run workload for seconds of simulated time and collect what happened.
+//
+//************************************************************************************
+static void PowerToolRun(uint32_t workload, uint32_t seconds,
+                         tPowerToolResult *result) {
+
+    uint64_t end;
+    uint32_t i, first, expect;
+    const tPowerLogEntry *entry;
+
+    PowerToolBoot();
+    g_powerToolWorkload = workload;
+    g_powerToolOn = false;
+    g_powerToolRefused = 0;
+    g_powerToolDeepWhileOn = 0;
+
+    if ((workload == POWER_TOOL_HOPS) &&
+        (!HopLoadGrid(&g_hop, g_powerToolInstance,
+                      &g_powerToolTuning[g_powerToolInstance], DDS_HZ(1000000),
+                      DDS_HZ(100000), 64) ||
+         !HopSequenceShuffle(&g_hop, 1, 64))) {
+
+        g_powerToolRefused++;
+
+    }
+
+    SchedulerTaskInit(&g_powerToolBlinkTask, PowerToolBlink, 0);
+    SchedulerTaskInit(&g_powerToolBurstTask, PowerToolBurst, 0);
+    SchedulerDefer(&g_powerToolBlinkTask, POWER_TOOL_BLINK_US);
+
+    if (g_powerToolWorkloads[workload].onUs != 0) {
+
+        SchedulerDefer(&g_powerToolBurstTask, 1000);
+
+    }
+
+    HalHostPowerReset();
+    end = HalHostCycles() + (uint64_t)seconds * BOOT_SYS_CLK_HZ;
+
+    while (HalHostCycles() < end) {
+
+        SchedulerPoll();
+
+    }
+
+    HalHostPower(&result->sim);
+
+    if (g_powerToolOn) {
+
+        PowerToolEngine(false);
+
+    }
+
+    //
+    // The log holds the last POWER_LOG_SIZE decisions; judge each by the rule with
+    // the budget as it ended (it only moves on a late wake)
+    //
+    result->badDecisions = 0;
+    first = (g_power.logHead > POWER_LOG_SIZE) ? (g_power.logHead - POWER_LOG_SIZE) :
+                                                 0;
+
+    for (i = first; i < g_power.logHead; i++) {
+
+        entry = &g_power.log[i & POWER_LOG_MASK];
+
+        if (entry->gapUs < (POWER_DEEP_MIN_US + g_power.relockUs)) {
+
+            expect = (entry->state == POWER_STATE_SLEEP) && (entry->holds == 0);
+
+        }
+
+        else if (entry->holds != 0) {
+
+            expect = (entry->state == POWER_STATE_SLEEP);
+
+        }
+
+        else {
+
+            expect = (entry->state == POWER_STATE_DEEP) && (entry->marginUs >= 0);
+
+        }
+
+        result->badDecisions += expect ? 0 : 1;
+
+    }
+
+    for (i = 0; i < POWER_STATE_COUNT; i++) {
+
+        result->decisions[i] = g_power.decisions[i];
+
+    }
+
+    result->lateWakes = g_power.lateWakes;
+    result->marginMinUs = g_power.marginMinUs;
+    result->relockUs = g_power.relockUs;
+    result->deepWhileOn = g_powerToolDeepWhileOn;
+    result->refused = g_powerToolRefused;
+
+}
+
+//************************************************************************************
+//
+// Energy per hour at VDD from the average current, in joules.
+//
+//************************************************************************************
+static double PowerToolJoules(const tPowerToolResult *result) {
+
+    return result->sim.averageMa * 3.3 * 3.6;
+
+}
+
+static void PowerToolReport(const char *name, const tPowerToolResult *result,
+                            bool pass) {
+
+    double total = (double)result->sim.cycles;
+    double run = total - (double)result->sim.sleepCycles -
+                 (double)result->sim.deepCycles;
+
+    printf("  %-14s sleep %6u deep %5u decisions  %u off the rule  %u deep busy  "
+           "%u refused  %s\n", name, result->decisions[POWER_STATE_SLEEP],
+           result->decisions[POWER_STATE_DEEP], result->badDecisions,
+           result->deepWhileOn, result->refused, pass ? "ok" : "FAIL");
+    printf("  %-14s run %6.2f%%  sleep %6.2f%%  deep %6.2f%%  %6.2f mA  %6.1f J/h  "
+           "%5.1f mWh/h\n", "", 100.0 * run / total,
+           100.0 * (double)result->sim.sleepCycles / total,
+           100.0 * (double)result->sim.deepCycles / total, result->sim.averageMa,
+           PowerToolJoules(result), result->sim.averageMa * 3.3);
+
+    if (result->sim.deepSleeps != 0) {
+
+        printf("  %-14s %u deep wakes, %u late, worst margin %d us, relock budget %u "
+               "us\n", "", result->sim.deepSleeps, result->lateWakes,
+               result->marginMinUs, result->relockUs);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int PowerToolCheck(void) {
+
+    tPowerToolResult results[POWER_TOOL_WORKLOADS];
+    tPowerToolResult slow;
+    uint32_t bad = 0;
+    uint32_t w;
+    bool pass, caught;
+
+    for (w = 0; w < POWER_TOOL_WORKLOADS; w++) {
+
+        PowerToolRun(w, POWER_TOOL_SECONDS, &results[w]);
+
+        pass = (results[w].badDecisions == 0) && (results[w].lateWakes == 0) &&
+               (results[w].sim.deepLate == 0) && (results[w].deepWhileOn == 0) &&
+               (results[w].refused == 0);
+
+        if (w == POWER_TOOL_IDLE) {
+
+            pass = pass && (results[w].decisions[POWER_STATE_DEEP] != 0);
+
+        }
+
+        if (w == POWER_TOOL_SWEEP) {
+
+            pass = pass && (results[w].decisions[POWER_STATE_DEEP] == 0);
+
+        }
+
+        PowerToolReport(g_powerToolWorkloads[w].name, &results[w], pass);
+        bad += pass ? 0 : 1;
+
+    }
+
+    pass = true;
+
+    for (w = POWER_TOOL_SWEEPS; w < POWER_TOOL_SWEEP; w++) {
+
+        pass = pass && (PowerToolJoules(&results[POWER_TOOL_IDLE]) <
+                        PowerToolJoules(&results[w])) &&
+                       (PowerToolJoules(&results[w]) <
+                        PowerToolJoules(&results[POWER_TOOL_SWEEP]));
+
+    }
+
+    printf("  %-14s idle %.1f J/h < bursts < continuous sweep %.1f J/h  %s\n\n",
+           "energy", PowerToolJoules(&results[POWER_TOOL_IDLE]),
+           PowerToolJoules(&results[POWER_TOOL_SWEEP]), pass ? "ok" : "FAIL");
+    bad += pass ? 0 : 1;
+
+    setenv("DDS_SIM_RELOCK_US", POWER_TOOL_SLOW_RELOCK, 1);
+    PowerToolRun(POWER_TOOL_IDLE, POWER_TOOL_SECONDS, &slow);
+    unsetenv("DDS_SIM_RELOCK_US");
+
+    caught = (slow.sim.deepLate != 0) && (slow.lateWakes != 0);
+    pass = caught && (slow.lateWakes == 1) && (slow.sim.deepLate == 1) &&
+           (slow.relockUs >= (uint32_t)atoi(POWER_TOOL_SLOW_RELOCK));
+    printf("  relock         %s us relock against a %u us budget: %u late of %u, "
+           "worst margin %d us,\n                 budget now %u us  %s\n",
+           POWER_TOOL_SLOW_RELOCK,
+           POWER_RELOCK_US, slow.lateWakes, slow.sim.deepSleeps, slow.marginMinUs,
+           slow.relockUs, !caught ? "FAIL: missed" : (pass ? "caught, ok" : "FAIL"));
+    bad += pass ? 0 : 1;
+
+    pass = (bad == 0);
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static int PowerToolBench(uint32_t seconds) {
+
+    static const char *const relocks[] = { "100", "300", "1000", "2000" };
+    tPowerToolResult result;
+    struct timespec t0, t1;
+    uint32_t r, w;
+    double host;
+
+    for (r = 0; r < 4; r++) {
+
+        setenv("DDS_SIM_RELOCK_US", relocks[r], 1);
+        printf("  relock %s us\n", relocks[r]);
+
+        for (w = 0; w < POWER_TOOL_WORKLOADS; w++) {
+
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            PowerToolRun(w, seconds, &result);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            host = (double)(t1.tv_sec - t0.tv_sec) +
+                   (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+            printf("    %-14s %6.2f mA  %6.1f J/h  deep %6.2f%%  %u late, "
+                   "worst margin %d us  (%.0fx real time)\n",
+                   g_powerToolWorkloads[w].name, result.sim.averageMa,
+                   PowerToolJoules(&result),
+                   100.0 * (double)result.sim.deepCycles / (double)result.sim.cycles,
+                   result.lateWakes,
+                   (result.sim.deepSleeps != 0) ? result.marginMinUs : 0,
+                   seconds / host);
+
+        }
+
+    }
+
+    unsetenv("DDS_SIM_RELOCK_US");
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t seconds = 0;
+
+    if (argc >= 3) {
+
+        seconds = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (seconds == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [seconds]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return PowerToolCheck();
+
+    }
+
+    return PowerToolBench((seconds != 0) ? seconds : POWER_TOOL_BENCH);
+
+}
@@ -0,0 +1,1091 @@
+//************************************************************************************
+//
+// Title:               Flash Preset Store - Image Builder
+// Author:              Jacob Putz
+// Filename:            PresetTool.c
+//
+// Description:     Host command line tool that compiles a text preset list into a
+//                      flash image for the PRESETS region and checks existing images.
+//                      Tuning words and step records are produced by the same Sweep.c
+//                      and DDSTuning.c code the firmware runs.
+//
+// Current Revision:    0.1.6
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.6    -       Pack preset step records with phase 0.
+//
+// 0.1.5    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.4    -       Add bench: load-to-first-step latency, in place and copied.
+//
+// 0.1.3    -       check also feeds the validator corrupted copies of the image.
+//
+// 0.1.2    -       Built by Host/Makefile.
+//
+// 0.1.1    -       Add seeded hopgrid presets built by the hop engine.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/preset_tool.
+//
+//  Usage:
+//
+//      preset_tool build presets.txt presets.bin
+//      preset_tool check presets.bin
+//      preset_tool bench presets.bin [loads]
+//
+//  check validates and lists the image, then makes a corrupted copy per preset
+//  and field -- element and bit counts whose byte sizes wrap 32 bits, counts one
+//  past the end, offsets at the end -- with the CRC recomputed so only the range
+//  checks stand in the way, and fails unless PresetValidate() rejects every one.
+//
+//  bench plays each sweep and hop preset on the simulated HAL, loads times over,
+//  two ways: in place, as PresetPlay() does from flash, and after copying its
+//  setup and data into a RAM image, as a loader without execute-in-place would.
+//  Both go through PresetPlay(), so the copy is the only difference.  It reports
+//  the host time to load (copy included), the simulated time from the load to
+//  the first step record on the SSI, and the bytes copied.  The simulator
+//  charges nothing for the CPU and sends the setup frames at once, so the first
+//  step comes one step period after the load either way; the copy shows up in
+//  the host time, and on the target it adds its flash reads and SRAM writes to
+//  the load and needs the RAM.  Modulation presets are skipped: their bits are
+//  read by the symbol interrupt, not streamed.
+//
+//  The binary is programmed at PRESET_FLASH_BASE (for example with UniFlash) or
+//  handed to the simulator through DDS_SIM_PRESETS.  One preset per line, '#'
+//  starts a comment, frequencies in Hertz:
+//
+//      sweep <id> <name> ad9834|ad9952 <startHz> <stopHz> <steps> <stepCycles>
+//            [log] [repeat]
+//      hop   <id> <name> ad9834|ad9952 <stepCycles> <hz> <hz> ... [repeat]
+//      hopgrid <id> <name> ad9834|ad9952 <stepCycles> <baseHz> <spacingHz>
+//            <channels> <seed> <hops> [repeat]
+//      mod   <id> <name> fsk|psk|quad|ask <symbolCycles> <f0Hz> <f1Hz>
+//            <phase1CentiDeg> <hexBits> [repeat]
+//
+//  Sweep and hop data is padded to whole blocks by holding the last step, so a
+//  repeating table whose length is not a multiple of SWEEP_BLOCK_STEPS dwells on
+//  its last step for the remainder of the final block.  hopgrid presets are built
+//  by the hop engine (Hop.c) instead, which fills the final block by continuing the
+//  shuffled sequence; a seed gives the same order as HOP_START on the remote link.
+//
+//************************************************************************************
+
+// Includes
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include <time.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Hop.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Preset.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     TOOL_MAX_PRESETS        256
+#define     TOOL_MAX_TOKENS         4096
+#define     TOOL_LINE_LEN           65536
+#define     TOOL_BENCH_LOADS        1000
+
+// Type Definitions
+typedef struct {
+
+    uint32_t id;
+    uint32_t offset;
+
+} tToolEntry;
+
+// Global Variables
+static uint32_t g_toolImage[PRESET_FLASH_SIZE / sizeof(uint32_t)];
+static uint32_t g_toolCorrupt[PRESET_FLASH_SIZE / sizeof(uint32_t)];
+static uint32_t g_toolRam[PRESET_FLASH_SIZE / sizeof(uint32_t)];
+static uint32_t g_toolUsed;
+static tToolEntry g_toolEntries[TOOL_MAX_PRESETS];
+static uint32_t g_toolCount;
+static tDDSTuning g_toolTuning[SSISTREAM_COUNT];
+static tSweep g_toolSweep;
+static char g_toolLine[TOOL_LINE_LEN];
+static uint32_t g_toolLineNumber;
+
+static void ToolFail(const char *message) {
+
+    fprintf(stderr, "line %u: %s\n", g_toolLineNumber, message);
+    exit(1);
+
+}
+
+//************************************************************************************
+//
+// Reserve bytes in the image body, 4-byte aligned, and return their offset.  The
+// header and index are written last, once the preset count is known, so the body
+// starts after room for the largest index.
+//
+//************************************************************************************
+static uint32_t ToolAlloc(uint32_t bytes) {
+
+    uint32_t offset = (g_toolUsed + 3) & ~3UL;
+
+    if ((offset + bytes) > PRESET_FLASH_SIZE) {
+
+        ToolFail("image does not fit in the PRESETS region");
+
+    }
+
+    g_toolUsed = offset + bytes;
+
+    return offset;
+
+}
+
+static void *ToolAt(uint32_t offset) {
+
+    return (uint8_t *)g_toolImage + offset;
+
+}
+
+static uint64_t ToolHz(const char *text) {
+
+    char *end;
+    double hz = strtod(text, &end);
+
+    if ((*end != '\0') || (hz < 0.0) || (hz >= 4294967296.0)) {
+
+        ToolFail("bad frequency");
+
+    }
+
+    return (uint64_t)(hz * 4294967296.0 + 0.5);
+
+}
+
+static uint32_t ToolUnsigned(const char *text) {
+
+    char *end;
+    unsigned long value = strtoul(text, &end, 0);
+
+    if ((*end != '\0') || (text[0] == '-')) {
+
+        ToolFail("bad number");
+
+    }
+
+    return (uint32_t)value;
+
+}
+
+static uint32_t ToolInstance(const char *text) {
+
+    if (strcmp(text, "ad9834") == 0) {
+
+        return SSISTREAM_AD9834;
+
+    }
+
+    if (strcmp(text, "ad9952") == 0) {
+
+        return SSISTREAM_AD9952;
+
+    }
+
+    ToolFail("chip must be ad9834 or ad9952");
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// Allocate and fill the common part of a preset.  The id must be unique; the index
+// is sorted once all lines are read.
+//
+//************************************************************************************
+static tPreset *ToolNewPreset(uint32_t type, const char *idText, const char *name,
+                              uint32_t instance, uint32_t stepCycles, bool repeat) {
+
+    uint32_t offset = ToolAlloc(sizeof(tPreset));
+    tPreset *preset = ToolAt(offset);
+    uint32_t id = ToolUnsigned(idText);
+    uint32_t i;
+
+    for (i = 0; i < g_toolCount; i++) {
+
+        if (g_toolEntries[i].id == id) {
+
+            ToolFail("duplicate id");
+
+        }
+
+    }
+
+    if (g_toolCount == TOOL_MAX_PRESETS) {
+
+        ToolFail("too many presets");
+
+    }
+
+    g_toolEntries[g_toolCount].id = id;
+    g_toolEntries[g_toolCount].offset = offset;
+    g_toolCount++;
+
+    memset(preset, 0, sizeof(tPreset));
+    preset->type = (uint16_t)type;
+    preset->instance = (uint16_t)instance;
+    preset->flags = repeat ? PRESET_FLAG_REPEAT : 0;
+    preset->stepCycles = stepCycles;
+    memcpy(preset->name, name, (strlen(name) < PRESET_NAME_LEN) ? strlen(name) :
+                                                                 PRESET_NAME_LEN);
+
+    return preset;
+
+}
+
+//************************************************************************************
+//
+// Setup frames for sweep and hop presets.  The AD9834 needs B28 so each step can
+// be two FREQ0 writes; the AD9952 records are self-contained.
+//
+//************************************************************************************
+static void ToolStepSetup(tPreset *preset) {
+
+    uint16_t *frames;
+
+    if (preset->instance == SSISTREAM_AD9834) {
+
+        preset->setupOffset = ToolAlloc(sizeof(uint16_t));
+        preset->setupCount = 1;
+        frames = ToolAt(preset->setupOffset);
+        frames[0] = AD9834FrameCtrl(AD9834_CTRL_B28);
+
+    }
+
+}
+
+static uint32_t ToolElemsPerStep(uint32_t instance) {
+
+    return (instance == SSISTREAM_AD9834) ? SWEEP_ELEMS_AD9834 : SWEEP_ELEMS_AD9952;
+
+}
+
+static void ToolPackStep(uint32_t instance, uint16_t *record, uint32_t word) {
+
+    SweepPackRecords(instance, &word, record, 1, 0);
+
+}
+
+static void ToolSweep(char **tokens, uint32_t count) {
+
+    uint32_t instance, steps, blocks, i;
+    bool repeat = false;
+    uint32_t shape = SWEEP_SHAPE_LINEAR;
+    tPreset *preset;
+    uint16_t *records;
+
+    if (count < 8) {
+
+        ToolFail("sweep needs id, name, chip, start, stop, steps and stepCycles");
+
+    }
+
+    for (i = 8; i < count; i++) {
+
+        if (strcmp(tokens[i], "log") == 0) {
+
+            shape = SWEEP_SHAPE_LOG;
+
+        }
+
+        else if (strcmp(tokens[i], "repeat") == 0) {
+
+            repeat = true;
+
+        }
+
+        else {
+
+            ToolFail("unknown sweep option");
+
+        }
+
+    }
+
+    instance = ToolInstance(tokens[3]);
+    steps = ToolUnsigned(tokens[6]);
+    preset = ToolNewPreset(PRESET_TYPE_SWEEP, tokens[1], tokens[2], instance,
+                           ToolUnsigned(tokens[7]), repeat);
+
+    //
+    // Generated as a one-shot so the padding holds the stop word; the repeat is
+    // done by the playback wrapping back to block 0.
+    //
+    if (!SweepConfigure(&g_toolSweep, instance, &g_toolTuning[instance], shape,
+                        ToolHz(tokens[4]), ToolHz(tokens[5]), steps,
+                        preset->stepCycles, false)) {
+
+        ToolFail("sweep cannot be represented");
+
+    }
+
+    ToolStepSetup(preset);
+
+    blocks = (steps + SWEEP_BLOCK_STEPS - 1) / SWEEP_BLOCK_STEPS;
+    preset->dataCount = blocks * SWEEP_BLOCK_STEPS * ToolElemsPerStep(instance);
+    preset->dataOffset = ToolAlloc(preset->dataCount * sizeof(uint16_t));
+    records = ToolAt(preset->dataOffset);
+
+    for (i = 0; i < blocks; i++) {
+
+        SweepFillBlock(&g_toolSweep, records);
+        records += SWEEP_BLOCK_STEPS * ToolElemsPerStep(instance);
+
+    }
+
+}
+
+static void ToolHop(char **tokens, uint32_t count) {
+
+    uint32_t instance, hops, steps, elems, word, i;
+    bool repeat = false;
+    tPreset *preset;
+    uint16_t *records;
+
+    if ((count > 5) && (strcmp(tokens[count - 1], "repeat") == 0)) {
+
+        repeat = true;
+        count--;
+
+    }
+
+    if (count < 6) {
+
+        ToolFail("hop needs id, name, chip, stepCycles and at least one frequency");
+
+    }
+
+    instance = ToolInstance(tokens[3]);
+    elems = ToolElemsPerStep(instance);
+    hops = count - 5;
+    steps = ((hops + SWEEP_BLOCK_STEPS - 1) / SWEEP_BLOCK_STEPS) * SWEEP_BLOCK_STEPS;
+    preset = ToolNewPreset(PRESET_TYPE_HOP, tokens[1], tokens[2], instance,
+                           ToolUnsigned(tokens[4]), repeat);
+
+    if ((preset->stepCycles == 0) || (preset->stepCycles > SWEEP_STEP_CYCLES_MAX)) {
+
+        ToolFail("bad step period");
+
+    }
+
+    ToolStepSetup(preset);
+
+    preset->dataCount = steps * elems;
+    preset->dataOffset = ToolAlloc(preset->dataCount * sizeof(uint16_t));
+    records = ToolAt(preset->dataOffset);
+    word = 0;
+
+    for (i = 0; i < steps; i++) {
+
+        if (i < hops) {
+
+            word = DDSTuningFreqWord(&g_toolTuning[instance], ToolHz(tokens[5 + i]));
+
+        }
+
+        ToolPackStep(instance, records, word);
+        records += elems;
+
+    }
+
+}
+
+static void ToolHopGrid(char **tokens, uint32_t count) {
+
+    uint32_t instance;
+    bool repeat = false;
+    tPreset *preset;
+
+    if ((count == 11) && (strcmp(tokens[10], "repeat") == 0)) {
+
+        repeat = true;
+        count--;
+
+    }
+
+    if (count != 10) {
+
+        ToolFail("hopgrid needs id, name, chip, stepCycles, base, spacing, channels, "
+                 "seed and hops");
+
+    }
+
+    instance = ToolInstance(tokens[3]);
+    preset = ToolNewPreset(PRESET_TYPE_HOP, tokens[1], tokens[2], instance,
+                           ToolUnsigned(tokens[4]), repeat);
+
+    if ((preset->stepCycles == 0) || (preset->stepCycles > SWEEP_STEP_CYCLES_MAX)) {
+
+        ToolFail("bad step period");
+
+    }
+
+    if (!HopLoadGrid(&g_hop, instance, &g_toolTuning[instance], ToolHz(tokens[5]),
+                     ToolHz(tokens[6]), ToolUnsigned(tokens[7])) ||
+        !HopSequenceShuffle(&g_hop, ToolUnsigned(tokens[8]), ToolUnsigned(tokens[9]))) {
+
+        ToolFail("hop sequence cannot be represented");
+
+    }
+
+    ToolStepSetup(preset);
+
+    preset->dataCount = g_hop.hops * ToolElemsPerStep(instance);
+    preset->dataOffset = ToolAlloc(preset->dataCount * sizeof(uint16_t));
+    memcpy(ToolAt(preset->dataOffset), g_hop.records,
+           preset->dataCount * sizeof(uint16_t));
+
+}
+
+static void ToolMod(char **tokens, uint32_t count) {
+
+    static const char *const modes[] = { "fsk", "psk", "quad", "ask" };
+    const tDDSTuning *tuning = &g_toolTuning[SSISTREAM_AD9834];
+    uint32_t mode, digits, word0, word1, i;
+    tPreset *preset;
+    uint16_t *frames;
+    uint8_t *bits;
+
+    if ((count < 9) || (count > 10) ||
+        ((count == 10) && (strcmp(tokens[9], "repeat") != 0))) {
+
+        ToolFail("mod needs id, name, mode, symbolCycles, f0, f1, phase1 and bits");
+
+    }
+
+    for (mode = 0; mode < 4; mode++) {
+
+        if (strcmp(tokens[3], modes[mode]) == 0) {
+
+            break;
+
+        }
+
+    }
+
+    if (mode == 4) {
+
+        ToolFail("mode must be fsk, psk, quad or ask");
+
+    }
+
+    digits = (uint32_t)strlen(tokens[8]);
+    preset = ToolNewPreset(PRESET_TYPE_MOD, tokens[1], tokens[2], SSISTREAM_AD9834,
+                           ToolUnsigned(tokens[4]), count == 10);
+    preset->mode = (uint16_t)(MOD_MODE_FSK + mode);
+
+    //
+    // The full bank load ModulationLoadBanks() sends to a part in an unknown state.
+    //
+    word0 = DDSTuningFreqWord(tuning, ToolHz(tokens[5]));
+    word1 = DDSTuningFreqWord(tuning, ToolHz(tokens[6]));
+    preset->setupOffset = ToolAlloc(7 * sizeof(uint16_t));
+    preset->setupCount = 7;
+    frames = ToolAt(preset->setupOffset);
+    frames[0] = AD9834FrameCtrl(AD9834_CTRL_B28 | AD9834_CTRL_PIN_SW);
+    frames[1] = AD9834FrameFreqLSB(AD9834_REG_FREQ0, word0);
+    frames[2] = AD9834FrameFreqMSB(AD9834_REG_FREQ0, word0);
+    frames[3] = AD9834FrameFreqLSB(AD9834_REG_FREQ1, word1);
+    frames[4] = AD9834FrameFreqMSB(AD9834_REG_FREQ1, word1);
+    frames[5] = AD9834FramePhase(AD9834_REG_PHASE0, 0);
+    frames[6] = AD9834FramePhase(AD9834_REG_PHASE1,
+                                 DDSTuningPhaseWordCentiDeg(tuning,
+                                                            ToolUnsigned(tokens[7])));
+
+    preset->dataCount = digits * 4;
+    preset->dataOffset = ToolAlloc((digits + 1) / 2);
+    bits = ToolAt(preset->dataOffset);
+
+    for (i = 0; i < digits; i++) {
+
+        int c = tolower((unsigned char)tokens[8][i]);
+        uint32_t nibble;
+
+        if (!isxdigit(c)) {
+
+            ToolFail("bits must be hexadecimal");
+
+        }
+
+        nibble = (uint32_t)((c <= '9') ? (c - '0') : (c - 'a' + 10));
+        bits[i / 2] |= (uint8_t)(nibble << (((i & 1) == 0) ? 4 : 0));
+
+    }
+
+    if ((preset->dataCount == 0) || (preset->stepCycles == 0)) {
+
+        ToolFail("empty bitstream or zero symbol period");
+
+    }
+
+}
+
+static int ToolCompareEntries(const void *a, const void *b) {
+
+    uint32_t idA = ((const tToolEntry *)a)->id;
+    uint32_t idB = ((const tToolEntry *)b)->id;
+
+    return (idA > idB) - (idA < idB);
+
+}
+
+//************************************************************************************
+//
+// First pass counts the presets so the body can start directly after the index;
+// the second pass builds them.
+//
+//************************************************************************************
+static int ToolBuild(const char *inPath, const char *outPath) {
+
+    char *tokens[TOOL_MAX_TOKENS];
+    tPresetImage *image = (tPresetImage *)g_toolImage;
+    tPresetIndex *index = (tPresetIndex *)(image + 1);
+    uint32_t count, presets, pass, i;
+    FILE *file;
+
+    DDSTuningInit(&g_toolTuning[SSISTREAM_AD9834], AD9834_MCLK_HZ, AD9834_FREQ_BITS,
+                  AD9834_PHASE_BITS);
+    DDSTuningInit(&g_toolTuning[SSISTREAM_AD9952], AD9952_SYSCLK_HZ, AD9952_FREQ_BITS,
+                  AD9952_PHASE_BITS);
+
+    presets = 0;
+
+    for (pass = 0; pass < 2; pass++) {
+
+        file = fopen(inPath, "r");
+
+        if (file == 0) {
+
+            fprintf(stderr, "cannot open %s\n", inPath);
+            return 1;
+
+        }
+
+        g_toolLineNumber = 0;
+        g_toolUsed = sizeof(tPresetImage) + presets * sizeof(tPresetIndex);
+
+        while (fgets(g_toolLine, sizeof(g_toolLine), file) != 0) {
+
+            char *hash = strchr(g_toolLine, '#');
+            char *token;
+
+            g_toolLineNumber++;
+
+            if (hash != 0) {
+
+                *hash = '\0';
+
+            }
+
+            count = 0;
+
+            for (token = strtok(g_toolLine, " \t\r\n"); token != 0;
+                 token = strtok(0, " \t\r\n")) {
+
+                if (count == TOOL_MAX_TOKENS) {
+
+                    ToolFail("line too long");
+
+                }
+
+                tokens[count++] = token;
+
+            }
+
+            if (count == 0) {
+
+                continue;
+
+            }
+
+            if (pass == 0) {
+
+                presets++;
+
+            }
+
+            else if (strcmp(tokens[0], "sweep") == 0) {
+
+                ToolSweep(tokens, count);
+
+            }
+
+            else if (strcmp(tokens[0], "hop") == 0) {
+
+                ToolHop(tokens, count);
+
+            }
+
+            else if (strcmp(tokens[0], "hopgrid") == 0) {
+
+                ToolHopGrid(tokens, count);
+
+            }
+
+            else if (strcmp(tokens[0], "mod") == 0) {
+
+                ToolMod(tokens, count);
+
+            }
+
+            else {
+
+                ToolFail("unknown preset type");
+
+            }
+
+        }
+
+        fclose(file);
+
+    }
+
+    qsort(g_toolEntries, g_toolCount, sizeof(tToolEntry), ToolCompareEntries);
+
+    for (i = 0; i < g_toolCount; i++) {
+
+        index[i].id = g_toolEntries[i].id;
+        index[i].offset = g_toolEntries[i].offset;
+
+    }
+
+    image->magic = PRESET_MAGIC;
+    image->versionMajor = PRESET_VERSION_MAJOR;
+    image->versionMinor = PRESET_VERSION_MINOR;
+    image->count = g_toolCount;
+    image->imageSize = (g_toolUsed + 3) & ~3UL;
+    image->crc = Crc32(CRC32_INIT, image + 1, image->imageSize - sizeof(tPresetImage));
+
+    if (!PresetValidate(image, PRESET_FLASH_SIZE)) {
+
+        fprintf(stderr, "internal error: built image does not validate\n");
+        return 1;
+
+    }
+
+    file = fopen(outPath, "wb");
+
+    if ((file == 0) || (fwrite(image, 1, image->imageSize, file) != image->imageSize)) {
+
+        fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+
+    }
+
+    fclose(file);
+    printf("%u presets, %u bytes\n", image->count, image->imageSize);
+
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// Corrupt one field of one preset in a copy of the image, re-sign it and return
+// whether the validator still accepts it.
+//
+//************************************************************************************
+static bool ToolAccepts(uint32_t index, uint32_t field, uint32_t value) {
+
+    tPresetImage *image = (tPresetImage *)g_toolCorrupt;
+    tPreset *preset;
+
+    memcpy(g_toolCorrupt, g_toolImage, sizeof(g_toolCorrupt));
+    preset = (tPreset *)PresetAt(image, index);
+
+    switch (field) {
+
+        case 0:     preset->setupOffset = value;    break;
+        case 1:     preset->setupCount = value;     break;
+        case 2:     preset->dataOffset = value;     break;
+        default:    preset->dataCount = value;      break;
+
+    }
+
+    image->crc = Crc32(CRC32_INIT, (const uint8_t *)image + sizeof(tPresetImage),
+                       image->imageSize - sizeof(tPresetImage));
+
+    return PresetValidate(image, PRESET_FLASH_SIZE);
+
+}
+
+static uint32_t ToolRejects(const tPresetImage *image) {
+
+    static const char *const fields[] = { "setupOffset", "setupCount", "dataOffset",
+                                          "dataCount" };
+    uint32_t tried = 0;
+    uint32_t accepted = 0;
+    uint32_t i, v;
+
+    for (i = 0; i < image->count; i++) {
+
+        const tPreset *preset = PresetAt(image, i);
+        uint32_t room = image->imageSize - preset->dataOffset;
+        uint32_t blockElems = SWEEP_BLOCK_STEPS * ToolElemsPerStep(preset->instance);
+        uint32_t values[][2] = {
+
+            { 0, image->imageSize + 2 },
+            { 0, 0xFFFFFFFE },
+            { 1, 0x80000000 },
+            { 1, 0x80000001 },
+            { 2, image->imageSize },
+            { 2, 0xFFFFFFFC },
+            { 3, 0x80000000 },
+            { 3, 0xFFFFFC00 },
+            { 3, 0xFFFFFFF9 },
+            { 3, 0xFFFFFFFF },
+
+            //
+            // One byte too many, or for a sweep one block, so the only thing
+            // wrong is the length
+            //
+            { 3, (preset->type == PRESET_TYPE_MOD) ? ((room * 8) + 1) :
+                     ((((room / 2) / blockElems) + 1) * blockElems) },
+
+        };
+
+        for (v = 0; v < (sizeof(values) / sizeof(values[0])); v++) {
+
+            tried++;
+
+            if (ToolAccepts(i, values[v][0], values[v][1])) {
+
+                fprintf(stderr, "preset %u: %s %08X accepted\n", i, fields[values[v][0]],
+                        values[v][1]);
+                accepted++;
+
+            }
+
+        }
+
+    }
+
+    printf("%u corrupted copies, %u accepted\n", tried, accepted);
+
+    return accepted;
+
+}
+
+//************************************************************************************
+//
+// Read path into g_toolImage and validate it.
+//
+//************************************************************************************
+static const tPresetImage *ToolLoad(const char *path) {
+
+    const tPresetImage *image = (const tPresetImage *)g_toolImage;
+    FILE *file = fopen(path, "rb");
+
+    if (file == 0) {
+
+        fprintf(stderr, "cannot open %s\n", path);
+        return 0;
+
+    }
+
+    fread(g_toolImage, 1, sizeof(g_toolImage), file);
+    fclose(file);
+
+    if (!PresetValidate(image, PRESET_FLASH_SIZE)) {
+
+        fprintf(stderr, "%s: invalid image\n", path);
+        return 0;
+
+    }
+
+    return image;
+
+}
+
+static int ToolCheck(const char *path) {
+
+    static const char *const types[] = { "?", "sweep", "hop", "mod" };
+    const tPresetImage *image = ToolLoad(path);
+    uint32_t i;
+
+    if (image == 0) {
+
+        return 1;
+
+    }
+
+    printf("version %u.%u, %u presets, %u bytes, crc %08X\n", image->versionMajor,
+           image->versionMinor, image->count, image->imageSize, image->crc);
+
+    for (i = 0; i < image->count; i++) {
+
+        const tPreset *preset = PresetAt(image, i);
+        const tPresetIndex *entry = (const tPresetIndex *)(image + 1) + i;
+
+        printf("%6u  %-16.16s  %-5s  %s  %8u cycles  %8u %s%s\n", entry->id,
+               preset->name, types[preset->type],
+               (preset->instance == SSISTREAM_AD9834) ? "ad9834" : "ad9952",
+               preset->stepCycles, preset->dataCount,
+               (preset->type == PRESET_TYPE_MOD) ? "bits" : "elements",
+               ((preset->flags & PRESET_FLAG_REPEAT) != 0) ? "  repeat" : "");
+
+    }
+
+    return (ToolRejects(image) == 0) ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  The firmware comes up through the critical boot stages (BootHost.c),
+// as far as playback needs.
+//
+//************************************************************************************
+static void ToolBoot(void) {
+
+    BootHostRun(false);
+
+}
+
+//
+// Copy preset's setup and data into a RAM image, after a copy of the preset
+// itself, and return the copy.  *bytes is what was copied.
+//
+static const tPreset *ToolCopy(const tPresetImage *image, const tPreset *preset,
+                               uint32_t *bytes) {
+
+    uint8_t *ram = (uint8_t *)g_toolRam;
+    tPreset *copy = (tPreset *)(ram + sizeof(tPresetImage));
+    uint32_t setupBytes = preset->setupCount * 2;
+    uint32_t dataBytes = preset->dataCount * 2;
+
+    *copy = *preset;
+    copy->setupOffset = sizeof(tPresetImage) + sizeof(tPreset);
+    copy->dataOffset = (copy->setupOffset + setupBytes + 3) & ~3UL;
+    memcpy(ram + copy->setupOffset, PresetPayload(image, preset->setupOffset),
+           setupBytes);
+    memcpy(ram + copy->dataOffset, PresetPayload(image, preset->dataOffset),
+           dataBytes);
+    *bytes = setupBytes + dataBytes;
+
+    return copy;
+
+}
+
+//
+// Play preset loads times, copied to RAM first or not, and give the mean host
+// nanoseconds per load and simulated cycles from the load to the first step.
+// Returns false if a load was refused or never reached the SSI.
+//
+static bool ToolTimeLoads(const tPresetImage *image, const tPreset *preset,
+                          bool copied, uint32_t loads, double *loadNs,
+                          double *firstCycles, uint32_t *bytes) {
+
+    uint32_t ssi = (preset->instance == SSISTREAM_AD9834) ? HAL_SSI_0 : HAL_SSI_3;
+    const tPresetImage *from = copied ? (const tPresetImage *)g_toolRam : image;
+    const tPreset *play = preset;
+    struct timespec t0, t1;
+    tHalHostFrame frame;
+    uint64_t start, waited;
+    double ns = 0;
+    double cycles = 0;
+    uint32_t i, setup;
+    bool found;
+
+    *bytes = 0;
+
+    for (i = 0; i < loads; i++) {
+
+        start = HalHostCycles();
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        if (copied) {
+
+            play = ToolCopy(image, preset, bytes);
+
+        }
+
+        if (!PresetPlay(from, play)) {
+
+            return false;
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns += (double)(t1.tv_sec - t0.tv_sec) * 1e9 +
+              (double)(t1.tv_nsec - t0.tv_nsec);
+
+        //
+        // The first frame after the setup frames is the first step
+        //
+        setup = preset->setupCount;
+        found = false;
+
+        for (waited = 0; !found && (waited <= (2ULL * preset->stepCycles));
+             waited += 100) {
+
+            while (!found && HalHostSsiRead(ssi, &frame)) {
+
+                found = (setup == 0);
+                setup -= found ? 0 : 1;
+
+            }
+
+            HalHostAdvance(100);
+
+        }
+
+        if (!found) {
+
+            return false;
+
+        }
+
+        cycles += (double)(frame.cycle - start);
+
+        PresetStop(play);
+
+        while (!SSIStreamIdle(&g_ssiStreams[preset->instance])) {
+
+            HalHostAdvance(100);
+
+        }
+
+        while (HalHostSsiRead(ssi, &frame)) {
+
+        }
+
+    }
+
+    *loadNs = ns / loads;
+    *firstCycles = cycles / loads;
+
+    return true;
+
+}
+
+static int ToolBench(const char *path, uint32_t loads) {
+
+    const tPresetImage *image = ToolLoad(path);
+    double xipNs, xipCycles, copyNs, copyCycles;
+    uint32_t bytes, unused, i;
+    bool ok = true;
+
+    if (image == 0) {
+
+        return 1;
+
+    }
+
+    ToolBoot();
+    printf("%u loads each; load is host time, first step is simulated time\n\n",
+           loads);
+
+    for (i = 0; i < image->count; i++) {
+
+        const tPreset *preset = PresetAt(image, i);
+
+        if ((preset->type == PRESET_TYPE_MOD) || !DDSChipBuilt(preset->instance)) {
+
+            printf("  %-16.16s  skipped\n", preset->name);
+            continue;
+
+        }
+
+        if (!ToolTimeLoads(image, preset, false, loads, &xipNs, &xipCycles,
+                           &unused) ||
+            !ToolTimeLoads(image, preset, true, loads, &copyNs, &copyCycles,
+                           &bytes)) {
+
+            printf("  %-16.16s  FAIL: not played\n", preset->name);
+            ok = false;
+            continue;
+
+        }
+
+        printf("  %-16.16s  in place  load %8.2f us  first step %7.2f us  "
+               "0 bytes copied\n", preset->name, xipNs * 1e-3,
+               xipCycles * 1e6 / BOOT_SYS_CLK_HZ);
+        printf("  %-16.16s  copied    load %8.2f us  first step %7.2f us  "
+               "%u bytes copied\n", "", copyNs * 1e-3,
+               copyCycles * 1e6 / BOOT_SYS_CLK_HZ, bytes);
+
+    }
+
+    return ok ? 0 : 1;
+
+}
+
+int main(int argc, char **argv) {
+
+    if ((argc == 4) && (strcmp(argv[1], "build") == 0)) {
+
+        return ToolBuild(argv[2], argv[3]);
+
+    }
+
+    if ((argc == 3) && (strcmp(argv[1], "check") == 0)) {
+
+        return ToolCheck(argv[2]);
+
+    }
+
+    if (((argc == 3) || (argc == 4)) && (strcmp(argv[1], "bench") == 0)) {
+
+        return ToolBench(argv[2], (argc == 4) ? strtoul(argv[3], 0, 10) :
+                                                TOOL_BENCH_LOADS);
+
+    }
+
+    fprintf(stderr, "usage: %s build presets.txt presets.bin\n"
+                    "       %s check presets.bin\n"
+                    "       %s bench presets.bin [loads]\n", argv[0], argv[0],
+            argv[0]);
+
+    return 2;
+
+}
@@ -0,0 +1,653 @@
+//************************************************************************************
+//
+// Title:               Profiling Check and Bench
+// Author:              Jacob Putz
+// Filename:            ProfileTool.c
+//
+// Description:     Checks the profiling module's region statistics, histograms
+//                      and trace ring, and holds the firmware's profiled hot paths
+//                      to time budgets on the host clock.  The bench reports what
+//                      the instrumentation itself costs and each region's timings.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/profile_tool, with PROFILE_ENABLE defined
+//  for the tool and for its own builds of the profiled modules.  On the host
+//  ProfileNow() counts nanoseconds, so every time below is in ns.
+//
+//  Usage:
+//
+//      profile_tool check              every case below
+//      profile_tool bench [count]      instrumentation cost and region timings
+//
+//  regions     known times recorded for a region give its exact count, minimum,
+//              maximum and total, and ProfileWithinBudget() holds at the maximum
+//              and fails one below it.
+//  histograms  interrupt latencies and durations of 0, 1, 2, 3, 4, 65535 and
+//              2^32 - 1 land in buckets 0, 1, 2, 2, 3, 15 and 15.
+//  ring        with no reader, a full ring takes PROFILE_TRACE_SIZE entries and
+//              counts the rest as dropped; they read back in order, then the ring
+//              reads empty.
+//  threads     a producer thread traces a million numbered entries, yielding
+//              after each burst of a little more than the ring holds, while this
+//              thread drains them.  Every
+//              entry must be read whole and in order, and the numbers skipped must
+//              add up to the dropped count.
+//  budgets     the profiled hot paths run on the simulator: SysTick, scheduler
+//              dispatch and the sweep refill while a sweep plays, and hop
+//              sequence builds.  Each region's mean must be within its budget.
+//              The host is not real time, so a preempted call can show up in the
+//              maximum; the budgets are held against the mean, which a
+//              regression moves and a stray preemption does not.
+//
+//  A negative control times a region that deliberately overruns its budget; the
+//  check must catch it.  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "DDSChip.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Hop.h"
+#include "Power.h"
+#include "Profile.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     PROFILE_TOOL_TICKS          1000
+#define     PROFILE_TOOL_BLOCKS         200
+#define     PROFILE_TOOL_HOP_BUILDS     50
+#define     PROFILE_TOOL_THREAD_ENTRIES 1000000
+#define     PROFILE_TOOL_THREAD_BURST   (PROFILE_TRACE_SIZE + 64)   // Between yields
+#define     PROFILE_TOOL_BENCH          1000000
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint32_t id;
+    uint32_t budget;                // Mean ns per call
+
+} tProfileToolBudget;
+
+// Global Constants
+//
+// About ten times what a current desktop takes at -O2, so a slow machine or an
+// unoptimized build still passes and a real regression does not
+//
+static const tProfileToolBudget g_profileToolBudgets[] = {
+
+    { "systick",        PROFILE_ID_SYSTICK,         750 },
+    { "sched dispatch", PROFILE_ID_SCHED_DISPATCH,  5000 },
+    { "sweep refill",   PROFILE_ID_SWEEP_REFILL,    4000 },
+    { "hop load",       PROFILE_ID_HOP_LOAD,        1000000 },
+
+};
+
+#define     PROFILE_TOOL_BUDGETS        (sizeof(g_profileToolBudgets) /              \
+                                         sizeof(g_profileToolBudgets[0]))
+
+// Global Variables
+static tDDSTuning g_profileToolTuning[SSISTREAM_COUNT];
+static uint32_t g_profileToolInstance;     // The part the hot paths drive
+static bool g_profileToolProduced;          // Set by the producer thread when done
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c), and a tuning context per part.
+//
+//************************************************************************************
+static void ProfileToolBoot(void) {
+
+    uint32_t i;
+
+    BootHostRun(false);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i)) {
+
+            DDSChipTuningInit(i, &g_profileToolTuning[i]);
+
+        }
+
+    }
+
+    g_profileToolInstance = DDSChipBuilt(SSISTREAM_AD9834) ? SSISTREAM_AD9834 :
+                                                             SSISTREAM_AD9952;
+
+    //
+    // Only the critical stages: the link stage's ProfilePortInit() would add a
+    // drain task that empties the ring the check reads
+    //
+    ProfileInit();
+
+}
+
+//************************************************************************************
+//
+// regions
+//
+//************************************************************************************
+static uint32_t ProfileToolRegions(void) {
+
+    static const uint32_t times[] = { 700, 300, 1200, 300, 950 };
+    const tProfileRegion *region = &g_profileRegions[PROFILE_ID_PRESET_LOAD];
+    bool pass;
+    uint32_t i;
+
+    ProfileInit();
+
+    for (i = 0; i < 5; i++) {
+
+        ProfileRegionRecord(PROFILE_ID_PRESET_LOAD, times[i]);
+
+    }
+
+    pass = (region->count == 5) && (region->min == 300) && (region->max == 1200) &&
+           (region->total == 3450) &&
+           ProfileWithinBudget(PROFILE_ID_PRESET_LOAD, 1200) &&
+           !ProfileWithinBudget(PROFILE_ID_PRESET_LOAD, 1199) &&
+           ProfileWithinBudget(PROFILE_ID_HOP_LOAD, 0);
+
+    printf("  regions        count %u  min %u  max %u  total %llu  %s\n",
+           region->count, region->min, region->max, (unsigned long long)region->total,
+           pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// histograms
+//
+//************************************************************************************
+static uint32_t ProfileToolHistograms(void) {
+
+    static const uint32_t values[] = { 0, 1, 2, 3, 4, 65535, 0xFFFFFFFF };
+    static const uint32_t want[PROFILE_HIST_BUCKETS] = {
+        1, 1, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2
+    };
+    const tProfileIsr *isr = &g_profileIsrs[PROFILE_ID_MOD_BLOCK];
+    uint32_t bad = 0;
+    uint32_t i;
+
+    ProfileInit();
+
+    for (i = 0; i < 7; i++) {
+
+        ProfileIsrRecord(PROFILE_ID_MOD_BLOCK, values[i], values[6 - i]);
+
+    }
+
+    for (i = 0; i < PROFILE_HIST_BUCKETS; i++) {
+
+        bad += (isr->latency[i] != want[i]) ? 1 : 0;
+        bad += (isr->duration[i] != want[i]) ? 1 : 0;
+
+    }
+
+    bad += (g_profileRegions[PROFILE_ID_MOD_BLOCK].count != 7) ? 1 : 0;
+
+    printf("  histograms     latency %u %u %u %u .. %u  "
+           "duration %u %u %u %u .. %u  %s\n",
+           isr->latency[0], isr->latency[1], isr->latency[2], isr->latency[3],
+           isr->latency[15], isr->duration[0], isr->duration[1], isr->duration[2],
+           isr->duration[3], isr->duration[15], (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// ring
+//
+//************************************************************************************
+static uint32_t ProfileToolRing(void) {
+
+    tProfileTrace entry;
+    uint32_t read = 0;
+    uint32_t bad = 0;
+    uint32_t i;
+    bool pass;
+
+    ProfileInit();
+
+    for (i = 0; i < PROFILE_TRACE_SIZE + 100; i++) {
+
+        ProfileTrace(PROFILE_ID_SYSTICK, i);
+
+    }
+
+    while (ProfileTraceRead(&entry)) {
+
+        bad += ((entry.arg != read) || (entry.seq != (read + 1))) ? 1 : 0;
+        read++;
+
+    }
+
+    ProfileTrace(PROFILE_ID_SYSTICK, 0xBEEF);
+    bad += (ProfileTraceRead(&entry) && (entry.arg == 0xBEEF)) ? 0 : 1;
+    bad += ProfileTraceRead(&entry) ? 1 : 0;
+
+    pass = (bad == 0) && (read == PROFILE_TRACE_SIZE) &&
+           (ProfileTraceDropped() == 100);
+
+    printf("  ring           %u read  %u dropped  %u bad  %s\n", read,
+           ProfileTraceDropped(), bad, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// threads.  Entry n carries n in its id (high half) and arg (low half).
+//
+//************************************************************************************
+static void *ProfileToolProducer(void *arg) {
+
+    uint32_t n;
+
+    (void)arg;
+
+    for (n = 0; n < PROFILE_TOOL_THREAD_ENTRIES; n++) {
+
+        ProfileTrace(n >> 16, n & 0xFFFF);
+
+        //
+        // Unpaced, the producer fills the ring before the reader runs (always, on
+        // one core) and nearly every entry is dropped; bursts a little longer than
+        // the ring give both reads and drops
+        //
+        if ((n % PROFILE_TOOL_THREAD_BURST) == (PROFILE_TOOL_THREAD_BURST - 1)) {
+
+            sched_yield();
+
+        }
+
+    }
+
+    __atomic_store_n(&g_profileToolProduced, true, __ATOMIC_RELEASE);
+
+    return 0;
+
+}
+
+static uint32_t ProfileToolThreads(void) {
+
+    tProfileTrace entry;
+    pthread_t producer;
+    uint32_t read = 0;
+    uint32_t skipped = 0;
+    uint32_t bad = 0;
+    uint32_t last = 0xFFFFFFFF;
+    uint32_t lastTime = 0;
+    uint32_t n, before;
+    bool produced = false;
+    bool pass;
+
+    ProfileInit();
+    g_profileToolProduced = false;
+
+    if (pthread_create(&producer, 0, ProfileToolProducer, 0) != 0) {
+
+        printf("  threads        FAIL: no producer thread\n");
+        return 1;
+
+    }
+
+    //
+    // Once the producer has finished, one more pass drains what it left
+    //
+    while (!produced) {
+
+        produced = __atomic_load_n(&g_profileToolProduced, __ATOMIC_ACQUIRE);
+        before = read;
+
+        while (ProfileTraceRead(&entry)) {
+
+            n = ((uint32_t)entry.id << 16) | entry.arg;
+
+            if ((last != 0xFFFFFFFF) && (n <= last)) {
+
+                bad++;
+
+            }
+
+            else {
+
+                skipped += n - (last + 1);
+
+            }
+
+            bad += ((read != 0) &&
+                    ((int32_t)(entry.timestamp - lastTime) < 0)) ? 1 : 0;
+            bad += (entry.seq != (read + 1)) ? 1 : 0;
+            lastTime = entry.timestamp;
+            last = n;
+            read++;
+
+        }
+
+        if (read == before) {
+
+            sched_yield();
+
+        }
+
+    }
+
+    pthread_join(producer, 0);
+    skipped += (PROFILE_TOOL_THREAD_ENTRIES - 1) - last;
+
+    pass = (bad == 0) && (skipped == ProfileTraceDropped()) &&
+           ((read + ProfileTraceDropped()) == PROFILE_TOOL_THREAD_ENTRIES);
+
+    printf("  threads        %u traced  %u read  %u dropped  %u skipped  %u bad  "
+           "%s\n",
+           PROFILE_TOOL_THREAD_ENTRIES, read, ProfileTraceDropped(), skipped, bad,
+           pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// Run the profiled hot paths: SysTick alone, then a sweep played on the
+// simulator with the scheduler refilling its tables, then hop sequence builds.
+//
+//************************************************************************************
+static void ProfileToolWork(void) {
+
+    uint32_t instance = g_profileToolInstance;
+    uint32_t ssi = (instance == SSISTREAM_AD9834) ? HAL_SSI_0 : HAL_SSI_3;
+    uint32_t stepCycles = 2 * SweepMinStepCycles(instance);
+    tHalHostFrame frame;
+    uint32_t i;
+
+    ProfileInit();
+
+    HalHostAdvance((uint64_t)PROFILE_TOOL_TICKS *
+                   (BOOT_SYS_CLK_HZ / BOOT_TICK_HZ));
+    SchedulerPoll();
+
+    SweepConfigure(&g_sweep, instance, &g_profileToolTuning[instance],
+                   SWEEP_SHAPE_LINEAR, DDS_HZ(1000000), DDS_HZ(2000000), 1000,
+                   stepCycles, true);
+    SweepStart(&g_sweep);
+
+    while (g_sweep.blocksDone < PROFILE_TOOL_BLOCKS) {
+
+        HalHostAdvance(8 * stepCycles);
+        SchedulerPoll();
+
+        while (HalHostSsiRead(ssi, &frame)) {
+
+            // The sweep tool checks what is sent; only the time taken matters here.
+
+        }
+
+    }
+
+    SweepStop(&g_sweep);
+
+    for (i = 0; i < PROFILE_TOOL_HOP_BUILDS; i++) {
+
+        HopLoadGrid(&g_hop, instance, &g_profileToolTuning[instance], DDS_HZ(1000000),
+                    DDS_HZ(1000), HOP_CHANNELS_MAX);
+        HopSequenceShuffle(&g_hop, i + 1, HopStepsMax(&g_hop));
+
+    }
+
+}
+
+static uint32_t ProfileToolMean(uint32_t id) {
+
+    const tProfileRegion *region = &g_profileRegions[id];
+
+    return (region->count != 0) ? (uint32_t)(region->total / region->count) : 0;
+
+}
+
+//************************************************************************************
+//
+// A region that runs for ns, to overrun a budget on purpose.
+//
+//************************************************************************************
+static void ProfileToolOverrun(uint32_t ns) {
+
+    uint32_t start;
+    PROFILE_BEGIN(PROFILE_ID_MOD_REFILL);
+
+    start = ProfileNow();
+
+    while ((ProfileNow() - start) < ns) {
+
+        // Spin
+
+    }
+
+    PROFILE_END(PROFILE_ID_MOD_REFILL);
+
+}
+
+//************************************************************************************
+//
+// budgets
+//
+//************************************************************************************
+static uint32_t ProfileToolBudgets(void) {
+
+    const tProfileToolBudget *budget;
+    const tProfileRegion *region;
+    uint32_t bad = 0;
+    uint32_t i, mean;
+    bool pass;
+
+    ProfileToolWork();
+
+    for (i = 0; i < PROFILE_TOOL_BUDGETS; i++) {
+
+        budget = &g_profileToolBudgets[i];
+        region = &g_profileRegions[budget->id];
+        mean = ProfileToolMean(budget->id);
+        pass = (region->count != 0) && (mean <= budget->budget);
+        bad += pass ? 0 : 1;
+
+        printf("  %-14s %6u calls  mean %7u ns  max %8u ns  budget %7u ns  %s\n",
+               budget->name, region->count, mean, region->max, budget->budget,
+               pass ? "ok" : "FAIL");
+
+    }
+
+    //
+    // Every SysTick was also put in its latency histogram
+    //
+    mean = 0;
+
+    for (i = 0; i < PROFILE_HIST_BUCKETS; i++) {
+
+        mean += g_profileIsrs[PROFILE_ID_SYSTICK].latency[i];
+
+    }
+
+    pass = (mean == g_profileRegions[PROFILE_ID_SYSTICK].count);
+    bad += pass ? 0 : 1;
+    printf("  %-14s %6u latencies for %u ticks  %s\n", "systick", mean,
+           g_profileRegions[PROFILE_ID_SYSTICK].count, pass ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int ProfileToolCheck(void) {
+
+    uint32_t bad = 0;
+    uint32_t budget = g_profileToolBudgets[2].budget;
+    bool caught, pass;
+
+    ProfileToolBoot();
+
+    ProfileInit();
+    ProfileToolOverrun(2 * budget);
+    caught = (ProfileToolMean(PROFILE_ID_MOD_REFILL) > budget) &&
+             !ProfileWithinBudget(PROFILE_ID_MOD_REFILL, budget);
+    printf("  control        region of %u ns against a %u ns budget  %s\n\n",
+           g_profileRegions[PROFILE_ID_MOD_REFILL].max, budget,
+           caught ? "caught" : "FAIL: missed");
+
+    bad += ProfileToolRegions();
+    bad += ProfileToolHistograms();
+    bad += ProfileToolRing();
+    bad += ProfileToolThreads();
+    bad += ProfileToolBudgets();
+
+    pass = (bad == 0) && caught;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static int ProfileToolBench(uint32_t count) {
+
+    const tProfileToolBudget *budget;
+    const tProfileRegion *region;
+    tProfileTrace entry;
+    uint32_t start, elapsed, i;
+
+    ProfileToolBoot();
+    ProfileInit();
+
+    start = ProfileNow();
+
+    for (i = 0; i < count; i++) {
+
+        PROFILE_BEGIN(PROFILE_ID_MOD_REFILL);
+        PROFILE_END(PROFILE_ID_MOD_REFILL);
+
+    }
+
+    elapsed = ProfileNow() - start;
+    printf("  region pair    %6.2f ns (two clock reads and the record)\n",
+           (double)elapsed / count);
+
+    start = ProfileNow();
+
+    for (i = 0; i < count; i++) {
+
+        ProfileTrace(PROFILE_ID_SYSTICK, i);
+        ProfileTraceRead(&entry);
+
+    }
+
+    elapsed = ProfileNow() - start;
+    printf("  trace entry    %6.2f ns (written and read back)\n\n",
+           (double)elapsed / count);
+
+    ProfileToolWork();
+
+    for (i = 0; i < PROFILE_TOOL_BUDGETS; i++) {
+
+        budget = &g_profileToolBudgets[i];
+        region = &g_profileRegions[budget->id];
+
+        printf("  %-14s %6u calls  min %7u  mean %7u  max %8u ns  "
+               "%5.1f%% of budget\n",
+               budget->name, region->count, region->min, ProfileToolMean(budget->id),
+               region->max, (100.0 * ProfileToolMean(budget->id)) / budget->budget);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t count = 0;
+
+    if (argc >= 3) {
+
+        count = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (count == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [count]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return ProfileToolCheck();
+
+    }
+
+    return ProfileToolBench((count != 0) ? count : PROFILE_TOOL_BENCH);
+
+}
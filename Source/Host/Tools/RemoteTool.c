@@ -0,0 +1,1400 @@
+//************************************************************************************
+//
+// Title:               Remote Control Protocol Check
+// Author:              Jacob Putz
+// Filename:            RemoteTool.c
+//
+// Description:     Feeds frames to the remote control parser on the simulated HAL
+//                      and checks the acknowledgements: length errors for every
+//                      fixed-size command, echoes of frames that straddle the end of
+//                      the receive ring, resync after bad CRCs, retransmissions,
+//                      commands that wait for the SSI streams without stalling
+//                      the poll, and frequencies kept through reference clock
+//                      changes.
+//
+// Current Revision:    0.1.5
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.5    -       Pack preset step records with phase 0.
+//
+// 0.1.4    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock from Boot.h.
+//
+// 0.1.3    -       Add the latch case.
+//
+// 0.1.2    -       Bench a pipelined command mix over the simulated link.
+//
+// 0.1.1    -       Add the refclk case.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/remote_tool, without Host/RemoteHost.c,
+//  since the tool supplies the link.
+//
+//  Usage:
+//
+//      remote_tool check               every case below
+//      remote_tool bench [frames]      host cost of parsing and acknowledging,
+//                                      then the pipelined mix below
+//
+//  The firmware is brought up with the boot stages of DDSExperiment.c.  Frames go
+//  straight into the receive ring and the main loop (SchedulerPoll()) runs the
+//  poll task; every acknowledgement is CRC-checked as it is queued.
+//
+//  lengths     every fixed-size command with an empty, a short and a long payload
+//              is answered REMOTE_ERR_LENGTH and nothing else.
+//  ring        pings of random length, one in seven with a broken CRC, until the
+//              ring has wrapped many times.  Every good frame, including those
+//              that straddle the end of the ring, is echoed once and in order;
+//              every bad one is counted and skipped.
+//  duplicate   a repeated seq gets the stored reply, not a new one.
+//  settle      a frequency write, a sweep start on the same part and a sweep stop
+//              arrive together.  The first poll must return with the sweep start
+//              still in the ring (the stream is busy sending the write), and the
+//              sweep must then start.  A control starts a sweep directly behind a
+//              write and has to be refused, showing the wait is needed.
+//  refclk      a frequency that does not land on a tuning word, then a calibration
+//              run's worth of reference clock updates within a few hundred ppm.
+//              After each one the register must hold the word the requested
+//              frequency tunes to at that clock.  A control retunes by way of the
+//              quantized word, as the parser once did, and has to drift.
+//  latch       an AD9952 frequency write, with the part modelled as it is built:
+//              frames fill the I/O buffer and a rising edge on PL4 (IO_UPDATE)
+//              moves it to the output.  Once the remote has settled the output
+//              must hold the new word.  The control is the output when the last
+//              frame went in, which must still be the old word.  With both parts
+//              built the AD9952's reference clock is then moved while a sweep plays
+//              on the AD9834, and its output must follow at once.
+//
+//  Exits 1 on any failure.
+//
+//  The bench's mix is REMOTE_TOOL_MIX commands cycling through set frequency,
+//  sweep start, sweep stop, preset play and preset stop, sent as a host would:
+//  back to back at BOOT_REMOTE_BAUD, once waiting for each acknowledgement and
+//  once with up to REMOTE_TOOL_WINDOW commands unacknowledged.  A frame reaches
+//  the ring when its last byte would have, and an acknowledgement reaches the
+//  host after those queued before it and its own bytes.  Latency is from the first
+//  byte of a command to the last byte of its acknowledgement, in simulated time,
+//  so it includes the poll period and the waits for the SSI streams; commands/s
+//  is over the whole run.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9952.h"
+#include "Boot.h"
+#include "BootHost.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Preset.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     REMOTE_TOOL_ACKS        4096
+#define     REMOTE_TOOL_PINGS       3000
+#define     REMOTE_TOOL_BAD_EVERY   7
+#define     REMOTE_TOOL_TIMEOUT_US  1000000
+#define     REMOTE_TOOL_SEED        0x5EED1234
+#define     REMOTE_TOOL_BENCH       1000000
+#define     REMOTE_TOOL_FREQ        ((uint64_t)1000000 << 32)   // 1 MHz, Q32.32
+#define     REMOTE_TOOL_ODD_FREQ    0x0012D687E35A8A3FULL       // ~1.234567 MHz
+#define     REMOTE_TOOL_CLK_UPDATES 5000
+#define     REMOTE_TOOL_CLK_PPM     300
+#define     REMOTE_TOOL_MIX         20000
+#define     REMOTE_TOOL_MIX_CMDS    5
+#define     REMOTE_TOOL_WINDOW      16          // Commands in flight, at most
+#define     REMOTE_TOOL_PRESET_ID   9
+#define     REMOTE_TOOL_BYTE_NS     (10ULL * 1000000000 / BOOT_REMOTE_BAUD)
+
+// Type Definitions
+typedef struct {
+
+    uint8_t seq;
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t data[REMOTE_PAYLOAD_MAX];
+    uint64_t us;
+
+} tRemoteToolAck;
+
+typedef struct {
+
+    const char *name;
+    uint8_t cmd;
+    uint8_t len;
+
+} tRemoteToolLength;
+
+//
+// A one-preset image: a sweep block played in place
+//
+typedef struct {
+
+    tPresetImage header;
+    tPresetIndex index[1];
+    tPreset preset;
+    uint16_t data[SWEEP_BLOCK_STEPS * AD9952_STEP_ELEMS];
+
+} tRemoteToolImage;
+
+//
+// The AD9952 as the latch case sees it
+//
+typedef struct {
+
+    uint32_t buffer[DDSSHADOW_AD9952_REGS];     // I/O buffer
+    uint32_t active[DDSSHADOW_AD9952_REGS];     // What drives the output
+    uint8_t addr;
+    uint32_t remain;                            // Bytes still due for addr
+    uint32_t value;
+    uint32_t latches;
+
+} tRemoteToolPart;
+
+// Global Constants
+static const tRemoteToolLength g_remoteToolLengths[] = {
+
+    { "mem status",     REMOTE_CMD_MEM_STATUS,      1 },
+    { "record start",   REMOTE_CMD_RECORD_START,    1 },
+    { "record read",    REMOTE_CMD_RECORD_READ,     4 },
+    { "fault read",     REMOTE_CMD_FAULT_READ,      4 },
+    { "set freq",       REMOTE_CMD_SET_FREQ,        10 },
+    { "set phase",      REMOTE_CMD_SET_PHASE,       6 },
+    { "preview",        REMOTE_CMD_PREVIEW,         8 },
+    { "calib start",    REMOTE_CMD_CALIB_START,     4 },
+    { "sync add",       REMOTE_CMD_SYNC_ADD,        5 },
+    { "sync set",       REMOTE_CMD_SYNC_SET,        13 },
+    { "sweep start",    REMOTE_CMD_SWEEP_START,     28 },
+    { "hop start",      REMOTE_CMD_HOP_START,       36 },
+    { "preset play",    REMOTE_CMD_PRESET_PLAY,     4 },
+
+};
+
+#define     REMOTE_TOOL_LENGTHS     (sizeof(g_remoteToolLengths) /                     \
+                                     sizeof(g_remoteToolLengths[0]))
+
+static const char *const g_remoteToolMixNames[REMOTE_TOOL_MIX_CMDS] = {
+
+    "set freq", "sweep start", "sweep stop", "preset play", "preset stop"
+
+};
+
+// Global Variables
+static uint32_t g_remoteToolRxHead;
+static tRemoteToolAck g_remoteToolAcks[REMOTE_TOOL_ACKS];
+static uint32_t g_remoteToolAckCount;
+static uint32_t g_remoteToolBadAcks;        // Acknowledgements failing their CRC
+static bool g_remoteToolKeep = true;        // Log acknowledgements (off for bench)
+static uint8_t g_remoteToolSeq;
+static uint32_t g_remoteToolRandom;
+
+//
+// Pipelined mix: per command, when the host started sending it and when it had
+// the acknowledgement, in simulated nanoseconds
+//
+static bool g_remoteToolLink;               // Pace acknowledgements at the baud rate
+static uint64_t g_remoteToolSentNs[REMOTE_TOOL_MIX];
+static uint64_t g_remoteToolDoneNs[REMOTE_TOOL_MIX];
+static uint8_t g_remoteToolMixSeq;          // Seq of command 0
+static uint32_t g_remoteToolMixAcks;
+static uint32_t g_remoteToolMixRefused;     // Not REMOTE_OK, or out of order
+static uint64_t g_remoteToolTxFreeNs;
+static tRemoteToolImage g_remoteToolImage;
+static tRemoteToolPart g_remoteToolPart;
+static uint32_t g_remoteToolBuffered;       // Output FTW0 as the last frame went in
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t RemoteToolRandom(void) {
+
+    uint32_t x = g_remoteToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_remoteToolRandom = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// Remote link port.  The tool writes frames into the ring itself and publishes
+// them through rxHead; acknowledgements are taken off the transmit ring as soon as
+// they are queued.
+//
+//************************************************************************************
+void RemotePortInit(tRemote *remote, uint32_t sysClkHz, uint32_t baud) {
+
+    (void)sysClkHz;
+    (void)baud;
+
+    g_remoteToolRxHead = remote->rxTail;
+
+}
+
+uint32_t RemotePortRxHead(tRemote *remote) {
+
+    (void)remote;
+
+    return g_remoteToolRxHead;
+
+}
+
+void RemotePortTxKick(tRemote *remote) {
+
+    uint8_t frame[REMOTE_FRAME_MAX];
+    tRemoteToolAck *ack;
+    uint32_t tail = remote->txTail;
+    uint32_t len, crc, i;
+
+    while (tail != remote->txHead) {
+
+        len = remote->tx[(tail + 4) & REMOTE_TX_MASK];
+
+        for (i = 0; i < (REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES); i++) {
+
+            frame[i] = remote->tx[(tail + i) & REMOTE_TX_MASK];
+
+        }
+
+        tail += REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES;
+        crc = (uint32_t)frame[REMOTE_HEADER_BYTES + len] |
+              ((uint32_t)frame[REMOTE_HEADER_BYTES + len + 1] << 8) |
+              ((uint32_t)frame[REMOTE_HEADER_BYTES + len + 2] << 16) |
+              ((uint32_t)frame[REMOTE_HEADER_BYTES + len + 3] << 24);
+
+        if ((frame[0] != REMOTE_SYNC0) || (frame[1] != REMOTE_SYNC1) ||
+            (Crc32(CRC32_INIT, &frame[2], 3 + len) != crc)) {
+
+            g_remoteToolBadAcks++;
+            continue;
+
+        }
+
+        if (g_remoteToolLink && ((frame[3] & REMOTE_ACK) != 0) &&
+            (g_remoteToolMixAcks < REMOTE_TOOL_MIX)) {
+
+            if (g_remoteToolTxFreeNs < (TimeBaseMicros() * 1000)) {
+
+                g_remoteToolTxFreeNs = TimeBaseMicros() * 1000;
+
+            }
+
+            g_remoteToolTxFreeNs += (REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES) *
+                                    REMOTE_TOOL_BYTE_NS;
+            g_remoteToolMixRefused += ((frame[REMOTE_HEADER_BYTES] != REMOTE_OK) ||
+                                       (frame[2] != (uint8_t)(g_remoteToolMixSeq +
+                                                              g_remoteToolMixAcks))) ?
+                                      1 : 0;
+            g_remoteToolDoneNs[g_remoteToolMixAcks++] = g_remoteToolTxFreeNs;
+
+        }
+
+        if (((frame[3] & REMOTE_ACK) == 0) || !g_remoteToolKeep ||
+            (g_remoteToolAckCount >= REMOTE_TOOL_ACKS)) {
+
+            continue;
+
+        }
+
+        ack = &g_remoteToolAcks[g_remoteToolAckCount++];
+        ack->seq = frame[2];
+        ack->cmd = frame[3] & ~REMOTE_ACK;
+        ack->len = (uint8_t)len;
+        ack->us = TimeBaseMicros();
+        memcpy(ack->data, &frame[REMOTE_HEADER_BYTES], len);
+
+    }
+
+    remote->txTail = tail;
+
+}
+
+//************************************************************************************
+//
+// Put one frame in the receive ring, with the CRC broken if asked.  Returns false
+// if the ring has no room for it.
+//
+//************************************************************************************
+static bool RemoteToolSend(uint8_t seq, uint8_t cmd, const uint8_t *payload,
+                           uint32_t len, bool corrupt) {
+
+    uint8_t frame[REMOTE_FRAME_MAX];
+    uint32_t total = REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES;
+    uint32_t crc, i;
+
+    if ((REMOTE_RX_SIZE - (g_remoteToolRxHead - g_remote.rxTail)) < total) {
+
+        return false;
+
+    }
+
+    frame[0] = REMOTE_SYNC0;
+    frame[1] = REMOTE_SYNC1;
+    frame[2] = seq;
+    frame[3] = cmd;
+    frame[4] = (uint8_t)len;
+    memcpy(&frame[REMOTE_HEADER_BYTES], payload, len);
+    crc = Crc32(CRC32_INIT, &frame[2], 3 + len) ^ (corrupt ? 0x00010000 : 0);
+
+    for (i = 0; i < REMOTE_CRC_BYTES; i++) {
+
+        frame[REMOTE_HEADER_BYTES + len + i] = (uint8_t)(crc >> (8 * i));
+
+    }
+
+    for (i = 0; i < total; i++) {
+
+        g_remote.rx[(g_remoteToolRxHead + i) & REMOTE_RX_MASK] = frame[i];
+
+    }
+
+    g_remoteToolRxHead += total;
+
+    return true;
+
+}
+
+static void RemoteToolPut64(uint8_t *bytes, uint64_t value) {
+
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+
+        bytes[i] = (uint8_t)(value >> (8 * i));
+
+    }
+
+}
+
+static void RemoteToolPut32(uint8_t *bytes, uint32_t value) {
+
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+
+        bytes[i] = (uint8_t)(value >> (8 * i));
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Run the main loop until count acknowledgements have been logged.  Returns false
+// on a timeout.
+//
+//************************************************************************************
+static bool RemoteToolWait(uint32_t count) {
+
+    uint64_t limit = TimeBaseMicros() + REMOTE_TOOL_TIMEOUT_US;
+    tHalHostFrame frame;
+
+    while (g_remoteToolAckCount < count) {
+
+        if (TimeBaseMicros() > limit) {
+
+            return false;
+
+        }
+
+        SchedulerPoll();
+
+        while (HalHostSsiRead(HAL_SSI_0, &frame) || HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+            // Keep the capture from filling.
+
+        }
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// The start-up of DDSExperiment.c, without the LEDs.
+//
+//************************************************************************************
+static void RemoteToolBoot(void) {
+
+    BootHostRun(true);
+
+}
+
+//************************************************************************************
+//
+// lengths
+//
+//************************************************************************************
+static uint32_t RemoteToolLengths(void) {
+
+    uint8_t payload[REMOTE_PAYLOAD_MAX];
+    const tRemoteToolLength *entry;
+    uint32_t lens[3];
+    uint32_t sent = 0;
+    uint32_t bad = 0;
+    uint32_t start = g_remoteToolAckCount;
+    uint32_t next = start;
+    uint32_t i, j;
+
+    memset(payload, 0, sizeof(payload));
+
+    for (i = 0; i < REMOTE_TOOL_LENGTHS; i++) {
+
+        entry = &g_remoteToolLengths[i];
+        lens[0] = 0;
+        lens[1] = entry->len - 1;
+        lens[2] = entry->len + 1;
+
+        for (j = (entry->len == 1) ? 1 : 0; j < 3; j++) {
+
+            RemoteToolSend(g_remoteToolSeq++, entry->cmd, payload, lens[j], false);
+            sent++;
+
+        }
+
+        if (!RemoteToolWait(start + sent)) {
+
+            printf("  lengths    FAIL: %s not acknowledged\n", entry->name);
+            return 1;
+
+        }
+
+        for (; next < g_remoteToolAckCount; next++) {
+
+            if ((g_remoteToolAcks[next].cmd != entry->cmd) ||
+                (g_remoteToolAcks[next].len != 1) ||
+                (g_remoteToolAcks[next].data[0] != REMOTE_ERR_LENGTH)) {
+
+                if (bad++ == 0) {
+
+                    printf("  lengths    FAIL: %s answered status %u with %u bytes\n",
+                           entry->name, g_remoteToolAcks[next].data[0],
+                           g_remoteToolAcks[next].len);
+
+                }
+
+            }
+
+        }
+
+    }
+
+    printf("  lengths    %3u frames  %u commands  %u wrong\n", sent,
+           (uint32_t)REMOTE_TOOL_LENGTHS, bad);
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// ring.  Payload bytes stay below 0x80 so no sync pair appears inside a frame and
+// each broken frame is exactly one bad frame.
+//
+//************************************************************************************
+static uint32_t RemoteToolRing(void) {
+
+    static uint8_t payloads[REMOTE_TOOL_PINGS][REMOTE_PAYLOAD_MAX];
+    static uint8_t lengths[REMOTE_TOOL_PINGS];
+    static uint8_t seqs[REMOTE_TOOL_PINGS];
+    const tRemoteToolAck *ack;
+    uint32_t badFrames = g_remote.badFrames;
+    uint32_t first = g_remoteToolAckCount;
+    uint32_t good = 0;
+    uint32_t corrupt = 0;
+    uint32_t straddled = 0;
+    uint32_t bad = 0;
+    uint32_t sent = 0;
+    uint32_t next = 0;
+    uint32_t i, len, echo;
+    bool broken;
+
+    g_remoteToolRandom = REMOTE_TOOL_SEED;
+
+    while (sent < REMOTE_TOOL_PINGS) {
+
+        len = RemoteToolRandom() % (REMOTE_PAYLOAD_MAX + 1);
+        broken = ((sent % REMOTE_TOOL_BAD_EVERY) == (REMOTE_TOOL_BAD_EVERY - 1));
+
+        for (i = 0; i < len; i++) {
+
+            payloads[good][i] = (uint8_t)(RemoteToolRandom() & 0x7F);
+
+        }
+
+        //
+        // Wait for room, draining the acknowledgements so far
+        //
+        while ((REMOTE_RX_SIZE - (g_remoteToolRxHead - g_remote.rxTail)) <
+               (REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES)) {
+
+            SchedulerPoll();
+
+        }
+
+        if (((g_remoteToolRxHead & REMOTE_RX_MASK) + REMOTE_HEADER_BYTES + len +
+             REMOTE_CRC_BYTES) > REMOTE_RX_SIZE) {
+
+            straddled++;
+
+        }
+
+        RemoteToolSend(g_remoteToolSeq, REMOTE_CMD_PING, payloads[good], len, broken);
+        sent++;
+
+        if (broken) {
+
+            corrupt++;
+
+        }
+
+        else {
+
+            lengths[good] = (uint8_t)len;
+            seqs[good] = g_remoteToolSeq;
+            good++;
+
+        }
+
+        g_remoteToolSeq++;
+
+    }
+
+    if (!RemoteToolWait(first + good)) {
+
+        printf("  ring       FAIL: %u of %u echoes\n", g_remoteToolAckCount - first, good);
+        return 1;
+
+    }
+
+    for (next = 0; next < good; next++) {
+
+        ack = &g_remoteToolAcks[first + next];
+        echo = (lengths[next] < REMOTE_PAYLOAD_MAX) ? lengths[next] :
+                                                      (REMOTE_PAYLOAD_MAX - 1);
+
+        if ((ack->cmd != REMOTE_CMD_PING) || (ack->seq != seqs[next]) ||
+            (ack->len != (1 + echo)) || (ack->data[0] != REMOTE_OK) ||
+            (memcmp(&ack->data[1], payloads[next], echo) != 0)) {
+
+            if (bad++ == 0) {
+
+                printf("  ring       FAIL: echo %u (seq %u, %u bytes) differs\n", next,
+                       seqs[next], lengths[next]);
+
+            }
+
+        }
+
+    }
+
+    if ((g_remote.badFrames - badFrames) != corrupt) {
+
+        printf("  ring       FAIL: %u bad frames counted, %u sent\n",
+               g_remote.badFrames - badFrames, corrupt);
+        bad++;
+
+    }
+
+    printf("  ring       %4u frames  %u straddling the end  %u broken  %u wrong\n", sent,
+           straddled, corrupt, bad);
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// duplicate
+//
+//************************************************************************************
+static uint32_t RemoteToolDuplicate(void) {
+
+    static const uint8_t first[] = { 'o', 'n', 'e' };
+    static const uint8_t second[] = { 't', 'w', 'o' };
+    uint32_t duplicates = g_remote.duplicates;
+    uint32_t start = g_remoteToolAckCount;
+    const tRemoteToolAck *a, *b;
+    bool pass;
+
+    RemoteToolSend(g_remoteToolSeq, REMOTE_CMD_PING, first, sizeof(first), false);
+    RemoteToolSend(g_remoteToolSeq, REMOTE_CMD_PING, second, sizeof(second), false);
+    g_remoteToolSeq++;
+
+    if (!RemoteToolWait(start + 2)) {
+
+        printf("  duplicate  FAIL: not acknowledged\n");
+        return 1;
+
+    }
+
+    a = &g_remoteToolAcks[start];
+    b = &g_remoteToolAcks[start + 1];
+    pass = (a->len == b->len) && (memcmp(a->data, b->data, a->len) == 0) &&
+           (memcmp(&b->data[1], first, sizeof(first)) == 0) &&
+           ((g_remote.duplicates - duplicates) == 1);
+
+    printf("  duplicate  reply %s  %s\n", (memcmp(&b->data[1], first, sizeof(first)) == 0) ?
+           "repeated" : "re-run", pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// settle
+//
+//************************************************************************************
+static uint32_t RemoteToolSettle(void) {
+
+    uint32_t instance = DDSChipBuilt(SSISTREAM_AD9834) ? SSISTREAM_AD9834 :
+                                                         SSISTREAM_AD9952;
+    uint8_t freq[10];
+    uint8_t sweep[28];
+    uint32_t start = g_remoteToolAckCount;
+    uint32_t acked;
+    bool control, waited, pass;
+    uint32_t i;
+
+    //
+    // Control: a sweep started straight behind a register write finds the stream
+    // busy
+    //
+    HalIntMasterDisable();
+
+    if (instance == SSISTREAM_AD9834) {
+
+        DDSShadowAD9834SetFreq(&g_ad9834Shadow, 1, 0x123456);
+        DDSShadowAD9834Queue(&g_ad9834Shadow, &g_ssiStreams[instance]);
+
+    }
+
+    else {
+
+        DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_FTW0, 0x1234567);
+        DDSShadowAD9952Queue(&g_ad9952Shadow, &g_ssiStreams[instance]);
+
+    }
+
+    control = SweepConfigure(&g_sweep, instance, &g_remote.tuning[instance],
+                             SWEEP_SHAPE_LINEAR, REMOTE_TOOL_FREQ, 2 * REMOTE_TOOL_FREQ,
+                             64, 12000, false) &&
+              !SweepStart(&g_sweep);
+    printf("  control    sweep behind a write  %s\n",
+           control ? "refused" : "FAIL: started on a busy stream");
+
+    SweepStop(&g_sweep);
+    HalIntMasterEnable();
+
+    //
+    // The same through the protocol
+    //
+    memset(freq, 0, sizeof(freq));
+    freq[0] = (uint8_t)instance;
+    RemoteToolPut64(&freq[2], 3 * REMOTE_TOOL_FREQ);
+
+    memset(sweep, 0, sizeof(sweep));
+    sweep[0] = (uint8_t)instance;
+    sweep[1] = SWEEP_SHAPE_LINEAR;
+    RemoteToolPut64(&sweep[4], REMOTE_TOOL_FREQ);
+    RemoteToolPut64(&sweep[12], 2 * REMOTE_TOOL_FREQ);
+    RemoteToolPut32(&sweep[20], 64);
+    RemoteToolPut32(&sweep[24], 12000);
+
+    RemoteToolSend(g_remoteToolSeq++, REMOTE_CMD_SET_FREQ, freq, sizeof(freq), false);
+    RemoteToolSend(g_remoteToolSeq++, REMOTE_CMD_SWEEP_START, sweep, sizeof(sweep), false);
+    RemoteToolSend(g_remoteToolSeq++, REMOTE_CMD_SWEEP_STOP, sweep, 0, false);
+
+    HalIntMasterDisable();
+    RemotePoll(&g_remote);
+    acked = g_remoteToolAckCount - start;
+    waited = g_remote.settling && (acked == 1) && !g_sweep.running;
+    HalIntMasterEnable();
+
+    if (!RemoteToolWait(start + 3)) {
+
+        printf("  settle     FAIL: not acknowledged\n");
+        return 1;
+
+    }
+
+    pass = control && waited;
+
+    for (i = 0; i < 3; i++) {
+
+        pass = pass && (g_remoteToolAcks[start + i].data[0] == REMOTE_OK);
+
+    }
+
+    printf("  settle     first poll acknowledged %u of 3, %s; statuses %u %u %u  %s\n",
+           acked, waited ? "sweep start waiting" : "not waiting",
+           g_remoteToolAcks[start].data[0], g_remoteToolAcks[start + 1].data[0],
+           g_remoteToolAcks[start + 2].data[0], pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// refclk
+//
+//************************************************************************************
+static uint32_t RemoteToolRefClk(void) {
+
+    uint32_t instance = DDSChipBuilt(SSISTREAM_AD9834) ? SSISTREAM_AD9834 :
+                                                         SSISTREAM_AD9952;
+    uint32_t nominal = g_remote.tuning[instance].refClkHz;
+    uint32_t start = g_remoteToolAckCount;
+    tDDSTuning fresh, before, quantized;
+    uint8_t freq[10];
+    uint32_t clk, word, expect, stale, wrong, i;
+    bool pass;
+
+    memset(freq, 0, sizeof(freq));
+    freq[0] = (uint8_t)instance;
+    RemoteToolPut64(&freq[2], REMOTE_TOOL_ODD_FREQ);
+    RemoteToolSend(g_remoteToolSeq++, REMOTE_CMD_SET_FREQ, freq, sizeof(freq), false);
+
+    if (!RemoteToolWait(start + 1) || (g_remoteToolAcks[start].data[0] != REMOTE_OK)) {
+
+        printf("  refclk     FAIL: frequency not set\n");
+        return 1;
+
+    }
+
+    quantized = g_remote.tuning[instance];
+    stale = (instance == SSISTREAM_AD9834) ? g_ad9834Shadow.freq[0] :
+                                             g_ad9952Shadow.reg[AD9952_REG_FTW0];
+    wrong = 0;
+
+    for (i = 0; i <= REMOTE_TOOL_CLK_UPDATES; i++) {
+
+        //
+        // The last update goes back to the nominal clock
+        //
+        clk = nominal;
+
+        if (i < REMOTE_TOOL_CLK_UPDATES) {
+
+            clk += (uint32_t)(((uint64_t)nominal * (RemoteToolRandom() %
+                               (2 * REMOTE_TOOL_CLK_PPM + 1))) / 1000000) -
+                   (uint32_t)(((uint64_t)nominal * REMOTE_TOOL_CLK_PPM) / 1000000);
+
+        }
+
+        if (!RemoteSetRefClk(&g_remote, instance, clk)) {
+
+            printf("  refclk     FAIL: %u Hz refused\n", clk);
+            return 1;
+
+        }
+
+        fresh = g_remote.tuning[instance];
+        expect = DDSTuningFreqWord(&fresh, REMOTE_TOOL_ODD_FREQ);
+        word = (instance == SSISTREAM_AD9834) ? g_ad9834Shadow.freq[0] :
+                                                g_ad9952Shadow.reg[AD9952_REG_FTW0];
+        wrong += (word != expect) ? 1 : 0;
+
+        before = quantized;
+        quantized = fresh;
+        stale = DDSTuningFreqWord(&quantized, DDSTuningWordToFreq(&before, stale));
+
+    }
+
+    pass = (wrong == 0) && (stale != expect);
+
+    printf("  control    retune from the word  %d LSB off after %u updates\n",
+           (int32_t)(stale - expect), REMOTE_TOOL_CLK_UPDATES);
+    printf("  refclk     %u updates, %u off the requested frequency  %s\n",
+           REMOTE_TOOL_CLK_UPDATES + 1, wrong, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// Feed the captured AD9952 frames to the model, instruction byte then the register
+// MSB first.
+//
+//************************************************************************************
+static void RemoteToolDrain(void) {
+
+    tRemoteToolPart *part = &g_remoteToolPart;
+    tHalHostFrame frame;
+
+    while (HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+        if (part->remain == 0) {
+
+            part->addr = (uint8_t)(frame.frame & AD9952_INSTR_ADDR_MASK);
+            part->remain = ((frame.frame & AD9952_INSTR_READ) != 0) ? 0 :
+                           AD9952RegBytes(part->addr);
+            part->value = 0;
+            continue;
+
+        }
+
+        part->value = (part->value << 8) | (frame.frame & 0xFF);
+
+        if ((--part->remain == 0) && (part->addr < DDSSHADOW_AD9952_REGS)) {
+
+            part->buffer[part->addr] = part->value;
+            g_remoteToolBuffered = part->active[AD9952_REG_FTW0];
+
+        }
+
+    }
+
+}
+
+static void RemoteToolGpioWatch(uint32_t port, uint8_t before, uint8_t after) {
+
+    RemoteToolDrain();
+
+    if ((port == HAL_PORT_L) && ((before & HAL_PIN_4) == 0) &&
+        ((after & HAL_PIN_4) != 0)) {
+
+        memcpy(g_remoteToolPart.active, g_remoteToolPart.buffer,
+               sizeof(g_remoteToolPart.active));
+        g_remoteToolPart.latches++;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Run the main loop until the AD9952 flush has been latched, feeding the model.
+//
+//************************************************************************************
+static void RemoteToolSettleAD9952(void) {
+
+    uint64_t limit = TimeBaseMicros() + REMOTE_TOOL_TIMEOUT_US;
+    tHalHostFrame frame;
+
+    do {
+
+        SchedulerPoll();
+        RemoteToolDrain();
+
+        while (HalHostSsiRead(HAL_SSI_0, &frame)) {
+
+            // Keep the capture from filling.
+
+        }
+
+    } while (g_remote.shadowDirty[SSISTREAM_AD9952] && (TimeBaseMicros() <= limit));
+
+}
+
+//************************************************************************************
+//
+// The AD9952 reference clock moved 200 ppm while a sweep plays on the AD9834, then
+// back.  The sweep's timer latches the retuned word.
+//
+//************************************************************************************
+static bool RemoteToolLatchBeside(uint32_t nominal) {
+
+    uint32_t expect, output;
+    bool pass;
+
+    pass = SweepConfigure(&g_sweep, SSISTREAM_AD9834, &g_remote.tuning[SSISTREAM_AD9834],
+                          SWEEP_SHAPE_LINEAR, REMOTE_TOOL_FREQ, 2 * REMOTE_TOOL_FREQ,
+                          64, 12000, true) &&
+           SweepStart(&g_sweep) &&
+           RemoteSetRefClk(&g_remote, SSISTREAM_AD9952, nominal + nominal / 5000);
+
+    RemoteToolSettleAD9952();
+
+    expect = DDSTuningFreqWord(&g_remote.tuning[SSISTREAM_AD9952], 5 * REMOTE_TOOL_FREQ);
+    output = g_remoteToolPart.active[AD9952_REG_FTW0];
+    pass = pass && g_sweep.running && (output == expect);
+
+    SweepStop(&g_sweep);
+    RemoteSetRefClk(&g_remote, SSISTREAM_AD9952, nominal);
+    RemoteToolSettleAD9952();
+
+    printf("  beside     AD9834 sweep, AD9952 clock +200 ppm  output %08X  %s\n", output,
+           pass ? "ok" : "FAIL");
+
+    return pass;
+
+}
+
+//************************************************************************************
+//
+// latch
+//
+//************************************************************************************
+static uint32_t RemoteToolLatch(void) {
+
+    uint64_t limit = TimeBaseMicros() + REMOTE_TOOL_TIMEOUT_US;
+    uint32_t start = g_remoteToolAckCount;
+    uint32_t nominal, old, expect;
+    uint8_t freq[10];
+    tHalHostFrame frame;
+    bool control, pass;
+
+    if (!DDSChipBuilt(SSISTREAM_AD9952)) {
+
+        return 0;
+
+    }
+
+    nominal = g_remote.tuning[SSISTREAM_AD9952].refClkHz;
+
+    //
+    // Start the model from what the part holds now
+    //
+    while (HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+        // Sent before the model existed
+
+    }
+
+    memset(&g_remoteToolPart, 0, sizeof(g_remoteToolPart));
+    memcpy(g_remoteToolPart.buffer, g_ad9952Shadow.devReg,
+           sizeof(g_remoteToolPart.buffer));
+    memcpy(g_remoteToolPart.active, g_ad9952Shadow.devReg,
+           sizeof(g_remoteToolPart.active));
+    old = g_remoteToolPart.active[AD9952_REG_FTW0];
+    g_remoteToolBuffered = old;
+    HalHostGpioWatch(RemoteToolGpioWatch);
+
+    memset(freq, 0, sizeof(freq));
+    freq[0] = SSISTREAM_AD9952;
+    RemoteToolPut64(&freq[2], 5 * REMOTE_TOOL_FREQ);
+    expect = DDSTuningFreqWord(&g_remote.tuning[SSISTREAM_AD9952], 5 * REMOTE_TOOL_FREQ);
+    RemoteToolSend(g_remoteToolSeq++, REMOTE_CMD_SET_FREQ, freq, sizeof(freq), false);
+
+    while ((g_remoteToolAckCount == start) && (TimeBaseMicros() <= limit)) {
+
+        SchedulerPoll();
+        RemoteToolDrain();
+
+    }
+
+    RemoteToolSettleAD9952();
+
+    control = (old != expect) && (g_remoteToolBuffered == old);
+    pass = control && (g_remoteToolAckCount > start) &&
+           (g_remoteToolAcks[start].data[0] == REMOTE_OK) &&
+           (g_remoteToolPart.buffer[AD9952_REG_FTW0] == expect) &&
+           (g_remoteToolPart.active[AD9952_REG_FTW0] == expect);
+
+    printf("  control    frames alone          output %s\n",
+           control ? "unchanged" : "FAIL: moved without IO_UPDATE");
+    printf("  latch      FTW0 %08X, output %08X after %u IO_UPDATE  %s\n", expect,
+           g_remoteToolPart.active[AD9952_REG_FTW0], g_remoteToolPart.latches,
+           pass ? "ok" : "FAIL");
+
+    if (DDSChipBuilt(SSISTREAM_AD9834)) {
+
+        pass = RemoteToolLatchBeside(nominal) && pass;
+
+    }
+
+    HalHostGpioWatch(0);
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int RemoteToolCheck(void) {
+
+    uint32_t bad = 0;
+    bool pass;
+
+    RemoteToolBoot();
+
+    bad += RemoteToolLengths();
+    bad += RemoteToolRing();
+    bad += RemoteToolDuplicate();
+    bad += RemoteToolSettle();
+    bad += RemoteToolRefClk();
+    bad += RemoteToolLatch();
+
+    if (g_remoteToolBadAcks != 0) {
+
+        printf("  %u acknowledgements failed their CRC\n", g_remoteToolBadAcks);
+
+    }
+
+    pass = (bad == 0) && (g_remoteToolBadAcks == 0);
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// A one-preset image: one block of a linear sweep on instance, played in place.
+//
+//************************************************************************************
+static const tPresetImage *RemoteToolBuildImage(uint32_t instance) {
+
+    tRemoteToolImage *image = &g_remoteToolImage;
+    uint32_t words[SWEEP_BLOCK_STEPS];
+    uint32_t i;
+
+    memset(image, 0, sizeof(*image));
+
+    image->header.magic = PRESET_MAGIC;
+    image->header.versionMajor = PRESET_VERSION_MAJOR;
+    image->header.versionMinor = PRESET_VERSION_MINOR;
+    image->header.count = 1;
+    image->header.imageSize = sizeof(*image);
+
+    image->index[0].id = REMOTE_TOOL_PRESET_ID;
+    image->index[0].offset = offsetof(tRemoteToolImage, preset);
+
+    image->preset.type = PRESET_TYPE_SWEEP;
+    image->preset.instance = (uint16_t)instance;
+    image->preset.stepCycles = 12000;
+    image->preset.dataOffset = offsetof(tRemoteToolImage, data);
+    image->preset.dataCount = SWEEP_BLOCK_STEPS * DDSChipStepElems(instance);
+    strncpy(image->preset.name, "remote-sweep", PRESET_NAME_LEN);
+
+    for (i = 0; i < SWEEP_BLOCK_STEPS; i++) {
+
+        words[i] = 0x100000 + (i << 12);
+
+    }
+
+    DDSChipPackRecords(instance, words, image->data, SWEEP_BLOCK_STEPS, 0);
+
+    image->header.crc = Crc32(CRC32_INIT,
+                              (const uint8_t *)image + sizeof(tPresetImage),
+                              sizeof(*image) - sizeof(tPresetImage));
+
+    return &image->header;
+
+}
+
+//************************************************************************************
+//
+// Command n of the mix into payload.  Returns the payload length.
+//
+//************************************************************************************
+static uint32_t RemoteToolMixCommand(uint32_t n, uint32_t instance, uint8_t *cmd,
+                                     uint8_t *payload) {
+
+    memset(payload, 0, REMOTE_PAYLOAD_MAX);
+
+    switch (n % REMOTE_TOOL_MIX_CMDS) {
+
+        case 0:
+
+            *cmd = REMOTE_CMD_SET_FREQ;
+            payload[0] = (uint8_t)instance;
+            RemoteToolPut64(&payload[2], REMOTE_TOOL_FREQ +
+                            ((uint64_t)(RemoteToolRandom() % 9000000) << 32));
+            return 10;
+
+        case 1:
+
+            *cmd = REMOTE_CMD_SWEEP_START;
+            payload[0] = (uint8_t)instance;
+            payload[1] = SWEEP_SHAPE_LINEAR;
+            RemoteToolPut64(&payload[4], REMOTE_TOOL_FREQ);
+            RemoteToolPut64(&payload[12], 2 * REMOTE_TOOL_FREQ);
+            RemoteToolPut32(&payload[20], 64);
+            RemoteToolPut32(&payload[24], 12000);
+            return 28;
+
+        case 2:
+
+            *cmd = REMOTE_CMD_SWEEP_STOP;
+            return 0;
+
+        case 3:
+
+            *cmd = REMOTE_CMD_PRESET_PLAY;
+            RemoteToolPut32(payload, REMOTE_TOOL_PRESET_ID);
+            return 4;
+
+        default:
+
+            *cmd = REMOTE_CMD_PRESET_STOP;
+            return 0;
+
+    }
+
+}
+
+static int RemoteToolCompare(const void *a, const void *b) {
+
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+
+}
+
+//************************************************************************************
+//
+// Latency percentiles of every stride-th command from first, in microseconds.
+//
+//************************************************************************************
+static void RemoteToolLatencies(const char *name, uint32_t first, uint32_t stride) {
+
+    static uint64_t sorted[REMOTE_TOOL_MIX];
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (i = first; i < REMOTE_TOOL_MIX; i += stride) {
+
+        sorted[count++] = g_remoteToolDoneNs[i] - g_remoteToolSentNs[i];
+
+    }
+
+    qsort(sorted, count, sizeof(sorted[0]), RemoteToolCompare);
+
+    printf("  %-12s  p50 %7.1f  p90 %7.1f  p99 %7.1f  p99.9 %7.1f  max %7.1f us\n",
+           name, sorted[count / 2] / 1e3, sorted[(count * 90) / 100] / 1e3,
+           sorted[(count * 99) / 100] / 1e3, sorted[(count * 999) / 1000] / 1e3,
+           sorted[count - 1] / 1e3);
+
+}
+
+//************************************************************************************
+//
+// The mix with window commands in flight.  Command n may start once the
+// acknowledgement of command n - window is in and the line is free, and goes into
+// the ring when its last byte would have arrived.
+//
+//************************************************************************************
+static bool RemoteToolMix(uint32_t window) {
+
+    uint32_t instance = DDSChipBuilt(SSISTREAM_AD9834) ? SSISTREAM_AD9834 :
+                                                         SSISTREAM_AD9952;
+    uint8_t payload[REMOTE_PAYLOAD_MAX];
+    uint64_t limit = TimeBaseMicros() + (uint64_t)REMOTE_TOOL_MIX * 10000;
+    uint64_t lineNs = TimeBaseMicros() * 1000;
+    uint64_t wireNs = 0;
+    uint64_t startNs, endNs, nowNs, spanNs;
+    tHalHostFrame frame;
+    uint32_t sent = 0;
+    uint32_t len = 0;
+    uint8_t cmd = 0;
+    bool ready = false;
+
+    g_presetImage = RemoteToolBuildImage(instance);
+    g_remoteToolRandom = REMOTE_TOOL_SEED;
+    g_remoteToolMixSeq = g_remoteToolSeq;
+    g_remoteToolMixAcks = 0;
+    g_remoteToolMixRefused = 0;
+    g_remoteToolTxFreeNs = 0;
+    g_remoteToolLink = true;
+
+    while (g_remoteToolMixAcks < REMOTE_TOOL_MIX) {
+
+        if (TimeBaseMicros() > limit) {
+
+            printf("  mix          FAIL: %u of %u acknowledged\n",
+                   g_remoteToolMixAcks, REMOTE_TOOL_MIX);
+            g_remoteToolLink = false;
+            return false;
+
+        }
+
+        nowNs = TimeBaseMicros() * 1000;
+
+        while ((sent < REMOTE_TOOL_MIX) &&
+               ((sent < window) || (g_remoteToolMixAcks > (sent - window)))) {
+
+            if (!ready) {
+
+                len = RemoteToolMixCommand(sent, instance, &cmd, payload);
+                ready = true;
+
+            }
+
+            startNs = lineNs;
+
+            if ((sent >= window) && (g_remoteToolDoneNs[sent - window] > startNs)) {
+
+                startNs = g_remoteToolDoneNs[sent - window];
+
+            }
+
+            endNs = startNs + (REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES) *
+                              REMOTE_TOOL_BYTE_NS;
+
+            if (endNs > nowNs) {
+
+                break;
+
+            }
+
+            RemoteToolSend(g_remoteToolSeq++, cmd, payload, len, false);
+            g_remoteToolSentNs[sent++] = startNs;
+            wireNs += endNs - startNs;
+            lineNs = endNs;
+            ready = false;
+
+        }
+
+        SchedulerPoll();
+
+        while (HalHostSsiRead(HAL_SSI_0, &frame) || HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+            // Keep the capture from filling.
+
+        }
+
+    }
+
+    g_remoteToolLink = false;
+    spanNs = g_remoteToolDoneNs[REMOTE_TOOL_MIX - 1] - g_remoteToolSentNs[0];
+
+    printf("\n  mix          %u commands, %u in flight at %u baud  %.0f commands/s  "
+           "line %.0f%% busy  %u refused\n", REMOTE_TOOL_MIX, window,
+           BOOT_REMOTE_BAUD, REMOTE_TOOL_MIX * 1e9 / spanNs, 100.0 * wireNs / spanNs,
+           g_remoteToolMixRefused);
+
+    for (len = 0; len < REMOTE_TOOL_MIX_CMDS; len++) {
+
+        RemoteToolLatencies(g_remoteToolMixNames[len], len, REMOTE_TOOL_MIX_CMDS);
+
+    }
+
+    RemoteToolLatencies("all", 0, 1);
+
+    return g_remoteToolMixRefused == 0;
+
+}
+
+//************************************************************************************
+//
+// bench.  One RemotePoll() per ring full of pings, so the ring wraps on every
+// other poll and the cost includes the CRC both ways and the acknowledgement.
+//
+//************************************************************************************
+static int RemoteToolBench(uint32_t frames) {
+
+    static const uint32_t sizes[] = { 0, 8, REMOTE_PAYLOAD_MAX };
+    uint8_t payload[REMOTE_PAYLOAD_MAX];
+    struct timespec t0, t1;
+    uint32_t s, done, batch;
+    double ns, total;
+
+    RemoteToolBoot();
+    g_remoteToolKeep = false;
+    memset(payload, 0x11, sizeof(payload));
+
+    for (s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); s++) {
+
+        total = 0;
+
+        for (done = 0; done < frames; done += batch) {
+
+            for (batch = 0; RemoteToolSend(g_remoteToolSeq++, REMOTE_CMD_PING, payload,
+                                           sizes[s], false); batch++) {
+
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            RemotePoll(&g_remote);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            total += (double)(t1.tv_sec - t0.tv_sec) * 1e9 +
+                     (double)(t1.tv_nsec - t0.tv_nsec);
+
+        }
+
+        ns = total / done;
+        printf("  ping %2u bytes  %7.1f ns/frame  %6.1f MB/s parsed\n", sizes[s], ns,
+               (REMOTE_HEADER_BYTES + sizes[s] + REMOTE_CRC_BYTES) * 1e3 / ns);
+
+    }
+
+    return (RemoteToolMix(1) && RemoteToolMix(REMOTE_TOOL_WINDOW)) ? 0 : 1;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t frames = 0;
+
+    if (argc >= 3) {
+
+        frames = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (frames == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [frames]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return RemoteToolCheck();
+
+    }
+
+    return RemoteToolBench((frames != 0) ? frames : REMOTE_TOOL_BENCH);
+
+}
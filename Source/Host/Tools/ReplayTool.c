@@ -0,0 +1,1033 @@
+//************************************************************************************
+//
+// Title:               DDS Command Recorder - Replay Tool
+// Author:              Jacob Putz
+// Filename:            ReplayTool.c
+//
+// Description:     Host command line tool that feeds the remote commands of a
+//                      recorded trace back through the firmware, running on the
+//                      simulated HAL and parts, and compares the register frames it
+//                      produces with the ones recorded.  Reports throughput,
+//                      command latency and how far the output timing drifted.
+//
+// Current Revision:    0.1.3
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.3    -       Take the clock and rates from Boot.h.
+//
+// 0.1.2    -       Compare the replayed commands, and fail on missing
+//                  acknowledgements or, in timed mode, any timing divergence.
+//
+// 0.1.1    -       Built by Host/Makefile.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/replay_tool, without Host/RemoteHost.c,
+//  since the tool supplies the link.
+//
+//  Usage:
+//
+//      replay_tool [-b] [-B baud] trace.rec
+//
+//  The tool takes the place of main() and of the remote link port: it brings the
+//  firmware up the way DDSExperiment.c does (without the LEDs) and hands each
+//  recorded command to the parser.  Run it with the same DDS_SIM_PRESETS and
+//  DDS_SIM_CALIB settings, and a build with the same DDS_CHIP, as the recording,
+//  or the boot preset and calibration traffic will not line up.
+//
+//  By default commands arrive at their recorded times, so a faithful replay
+//  reproduces every recorded register write at the same microsecond, and the
+//  timing divergence shows where it does not.  With -b they arrive back to back at
+//  the link rate (REMOTE_BAUD, or -B), which measures how fast the firmware can
+//  take commands.  More commands then land in each poll and the shadows merge
+//  more of their writes, so the writes no longer pair up one for one; what has to
+//  agree is the state the parts are left in.  In both modes the recorded and the
+//  replayed writes are decoded by a register model of each part and the final
+//  registers compared.
+//
+//  Latency is from a command's arrival to its acknowledgement being queued, in
+//  simulated time.  In timed mode the recorded time is when the command ran, so a
+//  faithful replay shows zero; with -b it includes the wait for the next poll.
+//
+//  The commands the firmware recorded on replay are compared with the recorded
+//  ones as well.  Exits 1 if the trace holds no commands, if any command was not
+//  acknowledged, or if the parts end up in a different state; in timed mode also
+//  if any recorded command or register write was not reproduced, or was
+//  reproduced at a different time.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Boot.h"
+#include "Calib.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Mem.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Preset.h"
+#include "Profile.h"
+#include "Record.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SoftDDS.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     REPLAY_SETTLE_US        100000      // Run on after the last entry
+#define     REPLAY_TIMEOUT_US       10000000    // Give up on missing acknowledgements
+#define     REPLAY_BITS_PER_BYTE    10
+
+// Type Definitions
+typedef struct {
+
+    uint64_t timeUs;                // Unwrapped
+    uint32_t kind;
+    uint32_t origin;
+    uint32_t instance;
+    uint32_t length;
+    const uint16_t *data;
+
+} tReplayEntry;
+
+typedef struct {
+
+    uint16_t *words;
+    uint32_t wordCount;
+    tReplayEntry *entries;
+    uint32_t count;
+
+} tReplayTrace;
+
+typedef struct {
+
+    uint8_t frame[REMOTE_FRAME_MAX];
+    uint32_t bytes;
+    uint64_t arrivalUs;
+    uint64_t latencyUs;
+
+} tReplayCommand;
+
+//
+// Register model of the two parts, fed with the recorded writes
+//
+typedef struct {
+
+    uint16_t ctrl;
+    uint32_t freq[2];
+    uint16_t phase[2];
+    bool msbNext;                   // B28: the next frequency write is the MSBs
+    uint32_t lsb;
+
+    uint32_t reg[AD9952_REG_POW0 + 1];
+    uint8_t addr;
+    uint32_t remain;                // Data bytes still to come for addr
+    uint32_t value;
+
+} tReplayParts;
+
+// Global Variables
+static tReplayTrace g_replayRecorded;
+static tReplayTrace g_replayReplayed;
+static uint32_t g_replayCapacity;
+
+static tReplayCommand *g_replayCommands;
+static uint32_t g_replayCommandCount;
+static uint32_t g_replayNextCommand;        // Next to hand to the parser
+static uint32_t g_replayNextAck;            // Next acknowledgement expected
+static uint32_t g_replayErrors;             // Acknowledged with a non-zero status
+static uint32_t g_replayRxHead;
+
+static uint32_t g_replayWire[SSISTREAM_COUNT];
+
+//************************************************************************************
+//
+// Index a trace: unwrap the times and point each entry at its data.
+//
+//************************************************************************************
+static bool ReplayParse(tReplayTrace *trace) {
+
+    uint32_t index = 0;
+    uint32_t last = 0;
+    uint64_t timeUs = 0;
+    uint32_t header, time, words;
+
+    trace->count = 0;
+    trace->entries = malloc(((trace->wordCount / RECORD_HEADER_WORDS) + 1) *
+                            sizeof(tReplayEntry));
+
+    while (index < trace->wordCount) {
+
+        header = trace->words[index];
+        words = RECORD_ENTRY_WORDS(header);
+
+        if ((index + words) > trace->wordCount) {
+
+            return false;
+
+        }
+
+        time = trace->words[index + 1] | ((uint32_t)trace->words[index + 2] << 16);
+        timeUs += (uint32_t)(time - last);
+        last = time;
+
+        trace->entries[trace->count].timeUs = timeUs;
+        trace->entries[trace->count].kind = RECORD_KIND(header);
+        trace->entries[trace->count].origin = RECORD_ORIGIN(header);
+        trace->entries[trace->count].instance = RECORD_INSTANCE(header);
+        trace->entries[trace->count].length = RECORD_LENGTH(header);
+        trace->entries[trace->count].data = &trace->words[index + RECORD_HEADER_WORDS];
+        trace->count++;
+
+        index += words;
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Apply a register write to the model, decoding the frames as the part would.
+//
+//************************************************************************************
+static void ReplayPartsWrite(tReplayParts *parts, const tReplayEntry *entry) {
+
+    uint32_t i, index, data;
+    uint16_t frame;
+
+    for (i = 0; i < entry->length; i++) {
+
+        frame = entry->data[i];
+
+        if (entry->instance == SSISTREAM_AD9952) {
+
+            if (parts->remain == 0) {
+
+                parts->addr = (uint8_t)(frame & AD9952_INSTR_ADDR_MASK);
+                parts->remain = ((frame & AD9952_INSTR_READ) != 0) ? 0 :
+                                AD9952RegBytes(parts->addr);
+                parts->value = 0;
+
+            }
+
+            else {
+
+                parts->value = (parts->value << 8) | (frame & 0xFF);
+
+                if (--parts->remain == 0) {
+
+                    parts->reg[parts->addr] = parts->value;
+
+                }
+
+            }
+
+            continue;
+
+        }
+
+        switch (frame & 0xC000) {
+
+            case AD9834_REG_CTRL:
+
+                parts->ctrl = frame;
+                break;
+
+            case AD9834_REG_FREQ0:
+            case AD9834_REG_FREQ1:
+
+                index = ((frame & 0xC000) == AD9834_REG_FREQ1) ? 1 : 0;
+                data = frame & AD9834_FREQ_HALF_MASK;
+
+                if ((parts->ctrl & AD9834_CTRL_B28) != 0) {
+
+                    if (parts->msbNext) {
+
+                        parts->freq[index] = parts->lsb | (data << 14);
+
+                    }
+
+                    else {
+
+                        parts->lsb = data;
+
+                    }
+
+                    parts->msbNext = !parts->msbNext;
+
+                }
+
+                else if ((parts->ctrl & AD9834_CTRL_HLB) != 0) {
+
+                    parts->freq[index] = (parts->freq[index] & AD9834_FREQ_HALF_MASK) |
+                                         (data << 14);
+
+                }
+
+                else {
+
+                    parts->freq[index] = (parts->freq[index] & ~AD9834_FREQ_HALF_MASK) |
+                                         data;
+
+                }
+
+                break;
+
+            default:
+
+                parts->phase[((frame & 0xE000) == AD9834_REG_PHASE1) ? 1 : 0] =
+                    frame & AD9834_PHASE_MASK;
+                break;
+
+        }
+
+    }
+
+}
+
+static void ReplayPartsRun(tReplayParts *parts, const tReplayTrace *trace) {
+
+    uint32_t i;
+
+    memset(parts, 0, sizeof(*parts));
+
+    for (i = 0; i < trace->count; i++) {
+
+        if (trace->entries[i].kind == RECORD_KIND_FRAMES) {
+
+            ReplayPartsWrite(parts, &trace->entries[i]);
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Compare where the recorded and replayed writes leave the parts.  Returns true if
+// they agree.
+//
+//************************************************************************************
+static bool ReplayPartsReport(void) {
+
+    tReplayParts recorded, replayed;
+    bool same;
+
+    ReplayPartsRun(&recorded, &g_replayRecorded);
+    ReplayPartsRun(&replayed, &g_replayReplayed);
+
+    same = (recorded.ctrl == replayed.ctrl) &&
+           (memcmp(recorded.freq, replayed.freq, sizeof(recorded.freq)) == 0) &&
+           (memcmp(recorded.phase, replayed.phase, sizeof(recorded.phase)) == 0) &&
+           (memcmp(recorded.reg, replayed.reg, sizeof(recorded.reg)) == 0);
+
+    printf("parts: AD9834 ctrl %04X freq %07X/%07X phase %03X/%03X, AD9952 FTW0 "
+           "%08X POW0 %04X; replay %s\n", recorded.ctrl, recorded.freq[0],
+           recorded.freq[1], recorded.phase[0], recorded.phase[1],
+           recorded.reg[AD9952_REG_FTW0], recorded.reg[AD9952_REG_POW0],
+           same ? "ends in the same state" : "ends in a different state");
+
+    return same;
+
+}
+
+static bool ReplayLoad(const char *path, tRecordFileHeader *header) {
+
+    FILE *file = fopen(path, "rb");
+
+    if (file == 0) {
+
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+
+    }
+
+    if ((fread(header, sizeof(*header), 1, file) != 1) ||
+        (header->magic != RECORD_FILE_MAGIC) ||
+        (header->version != RECORD_FILE_VERSION)) {
+
+        fprintf(stderr, "%s: not a trace file\n", path);
+        fclose(file);
+        return false;
+
+    }
+
+    g_replayRecorded.words = malloc((header->words + 1) * sizeof(uint16_t));
+    g_replayRecorded.wordCount = (uint32_t)fread(g_replayRecorded.words,
+                                                 sizeof(uint16_t), header->words, file);
+    fclose(file);
+
+    if ((g_replayRecorded.wordCount != header->words) ||
+        !ReplayParse(&g_replayRecorded)) {
+
+        fprintf(stderr, "%s: truncated trace\n", path);
+        return false;
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Rebuild the wire frames of the recorded commands and give each an arrival time:
+// the recorded one, or with a baud rate, back to back from the first.
+//
+//************************************************************************************
+static void ReplayCommands(uint32_t baud) {
+
+    const tReplayEntry *entry;
+    tReplayCommand *command;
+    uint64_t arrivalUs = 0;
+    uint32_t crc, i, j;
+
+    g_replayCommands = calloc(g_replayRecorded.count + 1, sizeof(tReplayCommand));
+
+    for (i = 0; i < g_replayRecorded.count; i++) {
+
+        entry = &g_replayRecorded.entries[i];
+
+        if ((entry->kind != RECORD_KIND_COMMAND) ||
+            (entry->length > (REMOTE_FRAME_MAX - 2 - REMOTE_CRC_BYTES))) {
+
+            continue;
+
+        }
+
+        command = &g_replayCommands[g_replayCommandCount++];
+        command->frame[0] = REMOTE_SYNC0;
+        command->frame[1] = REMOTE_SYNC1;
+
+        for (j = 0; j < entry->length; j++) {
+
+            command->frame[2 + j] = (uint8_t)(entry->data[j / 2] >> (8 * (j & 1)));
+
+        }
+
+        crc = Crc32(CRC32_INIT, &command->frame[2], entry->length);
+
+        for (j = 0; j < REMOTE_CRC_BYTES; j++) {
+
+            command->frame[2 + entry->length + j] = (uint8_t)(crc >> (8 * j));
+
+        }
+
+        command->bytes = 2 + entry->length + REMOTE_CRC_BYTES;
+
+        if (baud == 0) {
+
+            command->arrivalUs = entry->timeUs;
+
+        }
+
+        else {
+
+            if (g_replayCommandCount == 1) {
+
+                arrivalUs = entry->timeUs;
+
+            }
+
+            arrivalUs += ((uint64_t)command->bytes * REPLAY_BITS_PER_BYTE * 1000000 +
+                          baud - 1) / baud;
+            command->arrivalUs = arrivalUs;
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Collect what the firmware has recorded and what reached the simulated parts
+// since the last call, so neither ring wraps.
+//
+//************************************************************************************
+static void ReplayCollect(void) {
+
+    tHalHostFrame frame;
+    uint32_t count;
+
+    while ((count = RecordWords(&g_record)) != 0) {
+
+        if ((g_replayReplayed.wordCount + count) > g_replayCapacity) {
+
+            g_replayCapacity = 2 * (g_replayCapacity + count);
+            g_replayReplayed.words = realloc(g_replayReplayed.words,
+                                             g_replayCapacity * sizeof(uint16_t));
+
+        }
+
+        count = RecordRead(&g_record, 0, &g_replayReplayed.words[g_replayReplayed.wordCount],
+                           count);
+        g_replayReplayed.wordCount += count;
+        RecordConsume(&g_record, count);
+
+    }
+
+    while (HalHostSsiRead(HAL_SSI_0, &frame)) {
+
+        g_replayWire[SSISTREAM_AD9834]++;
+
+    }
+
+    while (HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+        g_replayWire[SSISTREAM_AD9952]++;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Remote link port.  Commands are handed over once their arrival time has passed
+// and there is room in the ring, as the UART would deliver them.
+//
+//************************************************************************************
+void RemotePortInit(tRemote *remote, uint32_t sysClkHz, uint32_t baud) {
+
+    (void)remote;
+    (void)sysClkHz;
+    (void)baud;
+
+    g_replayRxHead = 0;
+
+}
+
+uint32_t RemotePortRxHead(tRemote *remote) {
+
+    uint64_t now = TimeBaseMicros();
+    tReplayCommand *command;
+    uint32_t i;
+
+    ReplayCollect();
+
+    while (g_replayNextCommand < g_replayCommandCount) {
+
+        command = &g_replayCommands[g_replayNextCommand];
+
+        if ((command->arrivalUs > now) ||
+            ((REMOTE_RX_SIZE - (g_replayRxHead - remote->rxTail)) < command->bytes)) {
+
+            break;
+
+        }
+
+        for (i = 0; i < command->bytes; i++) {
+
+            remote->rx[(g_replayRxHead + i) & REMOTE_RX_MASK] = command->frame[i];
+
+        }
+
+        g_replayRxHead += command->bytes;
+        g_replayNextCommand++;
+
+    }
+
+    return g_replayRxHead;
+
+}
+
+//************************************************************************************
+//
+// Match acknowledgements to commands in order; events are ignored.
+//
+//************************************************************************************
+void RemotePortTxKick(tRemote *remote) {
+
+    uint64_t now = TimeBaseMicros();
+    uint32_t tail = remote->txTail;
+    uint8_t cmd, len;
+
+    while (tail != remote->txHead) {
+
+        cmd = remote->tx[(tail + 3) & REMOTE_TX_MASK];
+        len = remote->tx[(tail + 4) & REMOTE_TX_MASK];
+
+        if (((cmd & REMOTE_ACK) != 0) && (g_replayNextAck < g_replayNextCommand)) {
+
+            g_replayCommands[g_replayNextAck].latencyUs =
+                now - g_replayCommands[g_replayNextAck].arrivalUs;
+            g_replayNextAck++;
+
+            if (remote->tx[(tail + REMOTE_HEADER_BYTES) & REMOTE_TX_MASK] != REMOTE_OK) {
+
+                g_replayErrors++;
+
+            }
+
+        }
+
+        tail += REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES;
+
+    }
+
+    remote->txTail = tail;
+
+}
+
+//************************************************************************************
+//
+// The firmware start-up of DDSExperiment.c, recording from the start.
+//
+//************************************************************************************
+static void ReplayBoot(void) {
+
+    uint32_t sysClkHz = HalClockInit(BOOT_SYS_CLK_HZ);
+
+    HalHostSetLimit(UINT64_MAX);
+
+    TimeBaseInit(sysClkHz, BOOT_TICK_HZ);
+    SchedulerPortInit(sysClkHz);
+    SchedulerInit();
+    PowerInit();
+    MemInit();
+
+    RecordInit(&g_record);
+    RecordStart(&g_record, 0);
+
+    RemoteInit(&g_remote);
+    RemotePortInit(&g_remote, sysClkHz, BOOT_REMOTE_BAUD);
+    ProfileInit();
+    ProfilePortInit();
+
+    SSIStreamInit(&g_ssiStreams[SSISTREAM_AD9834], SSISTREAM_AD9834);
+    SSIStreamInit(&g_ssiStreams[SSISTREAM_AD9952], SSISTREAM_AD9952);
+    DDSShadowAD9834Init(&g_ad9834Shadow);
+    DDSShadowAD9952Init(&g_ad9952Shadow);
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+    SSIStreamPortInit(&g_ssiStreams[SSISTREAM_AD9834], sysClkHz, BOOT_SSI_BIT_RATE);
+#endif
+#if (DDS_CHIP & DDS_CHIP_AD9952)
+    SSIStreamPortInit(&g_ssiStreams[SSISTREAM_AD9952], sysClkHz, BOOT_SSI_BIT_RATE);
+#endif
+
+    SoftDDSInit();
+    SweepPortInit(sysClkHz);
+#if (DDS_CHIP & DDS_CHIP_AD9834)
+    ModulationPortInit(sysClkHz);
+#endif
+    CalibInit(&g_calib, sysClkHz);
+    CalibPortInit();
+
+    if (PresetInit() && (PresetFind(g_presetImage, PRESET_BOOT_ID) != 0)) {
+
+        PresetPlay(g_presetImage, PresetFind(g_presetImage, PRESET_BOOT_ID));
+
+    }
+
+}
+
+static int ReplayCompareLatency(const void *a, const void *b) {
+
+    uint64_t x = ((const tReplayCommand *)a)->latencyUs;
+    uint64_t y = ((const tReplayCommand *)b)->latencyUs;
+
+    return (x > y) - (x < y);
+
+}
+
+static void ReplayLatencyReport(void) {
+
+    tReplayCommand *sorted;
+    uint32_t n = g_replayNextAck;
+
+    if (n == 0) {
+
+        return;
+
+    }
+
+    sorted = malloc(n * sizeof(tReplayCommand));
+    memcpy(sorted, g_replayCommands, n * sizeof(tReplayCommand));
+    qsort(sorted, n, sizeof(tReplayCommand), ReplayCompareLatency);
+
+    printf("latency: p50 %llu us, p90 %llu us, p99 %llu us, max %llu us "
+           "(arrival to acknowledgement)\n",
+           (unsigned long long)sorted[n / 2].latencyUs,
+           (unsigned long long)sorted[(n * 9) / 10].latencyUs,
+           (unsigned long long)sorted[(n * 99) / 100].latencyUs,
+           (unsigned long long)sorted[n - 1].latencyUs);
+
+    free(sorted);
+
+}
+
+//************************************************************************************
+//
+// Pair the register writes of the two traces in order.  Returns the number that
+// were not reproduced.
+//
+//************************************************************************************
+static uint32_t ReplayCountWrites(const tReplayTrace *trace) {
+
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (i = 0; i < trace->count; i++) {
+
+        count += (trace->entries[i].kind == RECORD_KIND_FRAMES) ? 1 : 0;
+
+    }
+
+    return count;
+
+}
+
+//************************************************************************************
+//
+// Pair the commands of the two traces in order.  Returns the number that were not
+// reproduced, or in timed mode not at the recorded time.
+//
+//************************************************************************************
+static uint32_t ReplayCompareCommands(bool timed) {
+
+    const tReplayTrace *a = &g_replayRecorded;
+    const tReplayTrace *b = &g_replayReplayed;
+    uint32_t ia = 0, ib = 0;
+    uint32_t pairs = 0, differ = 0, moved = 0, missing = 0, extra = 0;
+
+    for (;;) {
+
+        while ((ia < a->count) && (a->entries[ia].kind != RECORD_KIND_COMMAND)) {
+
+            ia++;
+
+        }
+
+        while ((ib < b->count) && (b->entries[ib].kind != RECORD_KIND_COMMAND)) {
+
+            ib++;
+
+        }
+
+        if ((ia == a->count) || (ib == b->count)) {
+
+            break;
+
+        }
+
+        pairs++;
+
+        if ((a->entries[ia].length != b->entries[ib].length) ||
+            (memcmp(a->entries[ia].data, b->entries[ib].data,
+                    ((a->entries[ia].length + 1) / 2) * sizeof(uint16_t)) != 0)) {
+
+            differ++;
+
+        }
+
+        else if (a->entries[ia].timeUs != b->entries[ib].timeUs) {
+
+            moved++;
+
+        }
+
+        ia++;
+        ib++;
+
+    }
+
+    for (; ia < a->count; ia++) {
+
+        missing += (a->entries[ia].kind == RECORD_KIND_COMMAND) ? 1 : 0;
+
+    }
+
+    for (; ib < b->count; ib++) {
+
+        extra += (b->entries[ib].kind == RECORD_KIND_COMMAND) ? 1 : 0;
+
+    }
+
+    printf("commands: %u compared, %u differ, %u missing, %u extra, %u at a different "
+           "time\n", pairs, differ, missing, extra, moved);
+
+    return differ + missing + extra + (timed ? moved : 0);
+
+}
+
+static uint32_t ReplayCompare(bool timed) {
+
+    static const uint64_t bounds[] = { 0, 10, 100, 1000 };
+    uint32_t histogram[5] = { 0, 0, 0, 0, 0 };
+    const tReplayEntry *a = g_replayRecorded.entries;
+    const tReplayEntry *b = g_replayReplayed.entries;
+    uint32_t recorded = ReplayCountWrites(&g_replayRecorded);
+    uint32_t replayed = ReplayCountWrites(&g_replayReplayed);
+    uint32_t pairs = (recorded < replayed) ? recorded : replayed;
+    uint32_t ia = 0, ib = 0;
+    uint32_t differ = 0, origins = 0, frames = 0;
+    uint64_t sum = 0, worst = 0, d;
+    uint32_t bucket, i;
+
+    for (i = 0; i < pairs; i++, ia++, ib++) {
+
+        while (a[ia].kind != RECORD_KIND_FRAMES) {
+
+            ia++;
+
+        }
+
+        while (b[ib].kind != RECORD_KIND_FRAMES) {
+
+            ib++;
+
+        }
+
+        frames += a[ia].length;
+
+        if ((a[ia].instance != b[ib].instance) || (a[ia].length != b[ib].length) ||
+            (memcmp(a[ia].data, b[ib].data, a[ia].length * sizeof(uint16_t)) != 0)) {
+
+            differ++;
+            continue;
+
+        }
+
+        origins += (a[ia].origin != b[ib].origin) ? 1 : 0;
+        d = (b[ib].timeUs > a[ia].timeUs) ? (b[ib].timeUs - a[ia].timeUs) :
+                                            (a[ia].timeUs - b[ib].timeUs);
+
+        for (bucket = 0; (bucket < 4) && (d > bounds[bucket]); bucket++) {
+
+        }
+
+        histogram[bucket]++;
+        sum += d;
+        worst = (d > worst) ? d : worst;
+
+    }
+
+    printf("output: %u register writes (%u frames) compared, %u differ, %u missing, "
+           "%u extra, %u attributed differently\n", pairs, frames, differ,
+           recorded - pairs, replayed - pairs, origins);
+
+    if (!timed) {
+
+        return differ + (recorded - pairs) + (replayed - pairs);
+
+    }
+
+    if (pairs > differ) {
+
+        printf("divergence: exact %u, <=10 us %u, <=100 us %u, <=1 ms %u, >1 ms %u; "
+               "mean %.1f us, worst %llu us\n", histogram[0], histogram[1],
+               histogram[2], histogram[3], histogram[4],
+               (double)sum / (double)(pairs - differ), (unsigned long long)worst);
+
+    }
+
+    return (pairs - histogram[0]) + (recorded - pairs) + (replayed - pairs);
+
+}
+
+int main(int argc, char **argv) {
+
+    tRecordFileHeader header;
+    struct timespec start, stop;
+    const char *path = 0;
+    uint32_t baud = 0;
+    uint64_t endUs = 0;
+    uint64_t limitUs;
+    uint64_t settleUs = 0;
+    double wall, simulated;
+    uint32_t i, missed;
+
+    for (i = 1; i < (uint32_t)argc; i++) {
+
+        if (strcmp(argv[i], "-b") == 0) {
+
+            baud = (baud != 0) ? baud : BOOT_REMOTE_BAUD;
+
+        }
+
+        else if ((strcmp(argv[i], "-B") == 0) && ((i + 1) < (uint32_t)argc)) {
+
+            baud = (uint32_t)strtoul(argv[++i], 0, 10);
+
+        }
+
+        else {
+
+            path = argv[i];
+
+        }
+
+    }
+
+    if ((path == 0) || !ReplayLoad(path, &header)) {
+
+        fprintf(stderr, "usage: %s [-b] [-B baud] trace.rec\n", argv[0]);
+        return 2;
+
+    }
+
+    if (header.chips != DDS_CHIP) {
+
+        printf("warning: recorded with DDS_CHIP=%u, replaying with %u\n", header.chips,
+               (uint32_t)DDS_CHIP);
+
+    }
+
+    if ((header.flags & RECORD_FILE_LOST) != 0) {
+
+        printf("warning: the start of the trace was lost; expect divergence\n");
+
+    }
+
+    ReplayCommands(baud);
+
+    if (g_replayCommandCount == 0) {
+
+        printf("no commands in the trace\n");
+
+    }
+
+    if (g_replayRecorded.count != 0) {
+
+        endUs = g_replayRecorded.entries[g_replayRecorded.count - 1].timeUs;
+
+    }
+
+    limitUs = endUs;
+
+    if ((g_replayCommandCount != 0) &&
+        (g_replayCommands[g_replayCommandCount - 1].arrivalUs > limitUs)) {
+
+        limitUs = g_replayCommands[g_replayCommandCount - 1].arrivalUs;
+
+    }
+
+    limitUs += REPLAY_TIMEOUT_US;
+
+    ReplayBoot();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    //
+    // Timed: run to the end of the recording.  Back to back: until every command
+    // has been acknowledged.  Either way, then a little longer for the output.
+    //
+    for (;;) {
+
+        uint64_t now = TimeBaseMicros();
+
+        if ((g_replayNextAck == g_replayCommandCount) && ((baud != 0) || (now >= endUs))) {
+
+            if (settleUs == 0) {
+
+                settleUs = now + REPLAY_SETTLE_US;
+
+            }
+
+            if (now >= settleUs) {
+
+                break;
+
+            }
+
+        }
+
+        if (now > limitUs) {
+
+            printf("warning: %u commands never acknowledged\n",
+                   g_replayCommandCount - g_replayNextAck);
+            break;
+
+        }
+
+        SchedulerPoll();
+
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    ReplayCollect();
+
+    wall = (double)(stop.tv_sec - start.tv_sec) + 1e-9 * (stop.tv_nsec - start.tv_nsec);
+    simulated = (double)TimeBaseMicros() * 1e-6;
+
+    if (!ReplayParse(&g_replayReplayed)) {
+
+        fprintf(stderr, "internal error: replayed trace does not parse\n");
+        return 2;
+
+    }
+
+    printf("replay: %u commands, %u entries recorded, %.3f s simulated in %.3f s "
+           "(%.0fx real time)\n", g_replayCommandCount, g_replayRecorded.count,
+           simulated, wall, simulated / wall);
+    printf("throughput: %.0f commands/s, %.0f entries/s host; %.0f commands/s "
+           "simulated\n", g_replayCommandCount / wall, g_replayReplayed.count / wall,
+           g_replayCommandCount / simulated);
+
+    ReplayLatencyReport();
+
+    if (g_replayErrors != 0) {
+
+        printf("%u commands acknowledged with an error\n", g_replayErrors);
+
+    }
+
+    printf("wire: %u frames to the AD9834, %u to the AD9952\n",
+           g_replayWire[SSISTREAM_AD9834], g_replayWire[SSISTREAM_AD9952]);
+
+    missed = ReplayCompareCommands(baud == 0);
+    missed += ReplayCompare(baud == 0);
+
+    if (!ReplayPartsReport() || (g_replayCommandCount == 0) ||
+        (g_replayNextAck != g_replayCommandCount)) {
+
+        return 1;
+
+    }
+
+    return ((baud == 0) && (missed != 0)) ? 1 : 0;
+
+}
@@ -0,0 +1,630 @@
+//************************************************************************************
+//
+// Title:               SSI Stream Check and Bench
+// Author:              Jacob Putz
+// Filename:            SSIStreamTool.c
+//
+// Description:     Runs the SSI stream ring against a model of the uDMA ping-pong
+//                      transfer and a bit-timed SSI, and checks that every frame
+//                      accepted goes out once, whole and in order, through ring
+//                      wrap, a full ring and overload.  The bench reports the
+//                      host cost per frame and the queue depth against offered
+//                      load.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Take the clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/ssi_tool, without Host/SSIStreamHost.c,
+//  since the tool supplies the port.  Host/SSIStreamHost.c finishes every transfer
+//  inside SSIStreamPortArm(), which never leaves the ring more than one frame
+//  deep; the port here is the target's uDMA instead:
+//
+//      A slot armed with a run of the ring is sent one element at a time, each
+//      taking its frame bits plus one bit of gap at the SSI bit rate, read from
+//      the ring as it goes out.  The controller runs the slots alternately and
+//      stops when the next one is not armed; finishing a slot raises the
+//      completion interrupt, which runs SSIStreamService() at once.  A slot
+//      reads as stopped only once it has run to completion.  SSIStreamPortKick()
+//      pends the interrupt, which pre-empts the caller, so it runs the service too.
+//
+//  Time only moves when the tool says so, and the tool keeps its own copy of
+//  every frame the ring accepted, so each element on the wire is compared with
+//  the one expected next.
+//
+//  Usage:
+//
+//      ssi_tool check [frames]         every case below, on both streams
+//      ssi_tool bench [frames]         host cost per frame, depth against load
+//
+//  overload    random frequency (AD9834) and register (AD9952) writes offered at
+//              120% of the link rate, so the ring wraps many times, fills and
+//              refuses frames.  A frame is refused exactly when it does not fit,
+//              and everything accepted comes out once and in order; afterwards
+//              the ring is empty and elementsSent is what was accepted.
+//  light       the same at 50% of the link rate, with no frame refused.
+//  burst       with the link held, frames are queued until one is refused; the
+//              ring then holds all but less than a frame of its size, and it
+//              drains in order in runs split at the ring end.
+//
+//  A negative control reports the running slot as stopped part way through, so
+//  the ring reuses elements the uDMA has not read; the check must catch it.
+//  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Boot.h"
+#include "SSIStream.h"
+
+// Defines
+#define     SSI_TOOL_FRAMES         200000
+#define     SSI_TOOL_CONTROL_FRAMES 20000
+#define     SSI_TOOL_EXPECT_SIZE    4096        // Power of two, above the ring size
+#define     SSI_TOOL_EXPECT_MASK    (SSI_TOOL_EXPECT_SIZE - 1)
+#define     SSI_TOOL_SEED           0x5EED1234
+#define     SSI_TOOL_BENCH          1000000
+
+// Type Definitions
+//
+// The uDMA and SSI of one stream
+//
+typedef struct {
+
+    const uint16_t *src[2];
+    uint32_t count[2];              // Elements armed, zero if never armed
+    bool done[2];                   // Ran to completion
+    uint32_t active;                // Slot the controller runs next
+    uint32_t sent;                  // Elements of the active slot already out
+    uint32_t elementCycles;         // Frame bits plus a bit of gap
+    uint64_t budget;                // Cycles given but not yet spent
+
+    //
+    // Elements accepted and not yet sent
+    //
+    uint16_t expect[SSI_TOOL_EXPECT_SIZE];
+    uint32_t expectHead;
+    uint32_t expectTail;
+
+    uint32_t wrong;                 // Elements sent that were not the next expected
+    uint32_t busyArms;              // Slots armed while still running
+
+} tSSIToolLink;
+
+typedef struct {
+
+    uint32_t accepted;
+    uint32_t refused;
+    uint32_t badRefusals;           // Refused with room, or accepted without
+    uint32_t elements;              // Elements accepted
+    uint32_t maxDepth;
+    double meanDepth;
+
+} tSSIToolLoad;
+
+// Global Variables
+static tSSIToolLink g_ssiToolLinks[SSISTREAM_COUNT];
+static bool g_ssiToolEarlyStop;     // Negative control
+static uint32_t g_ssiToolRandom;
+
+static const char *const g_ssiToolNames[SSISTREAM_COUNT] = { "ad9834", "ad9952" };
+
+//************************************************************************************
+//
+// Stream port
+//
+//************************************************************************************
+void SSIStreamPortInit(tSSIStream *stream, uint32_t sysClkHz, uint32_t bitRate) {
+
+    tSSIToolLink *link = &g_ssiToolLinks[stream->instance];
+    uint32_t bits = (stream->instance == SSISTREAM_AD9834) ? AD9834_FRAME_BITS :
+                                                             AD9952_FRAME_BITS;
+
+    memset(link, 0, sizeof(*link));
+    stream->bitCycles = (sysClkHz + bitRate - 1) / bitRate;
+    link->elementCycles = (bits + 1) * stream->bitCycles;
+
+}
+
+void SSIStreamPortArm(tSSIStream *stream, uint32_t slot, const uint16_t *src,
+                      uint32_t count) {
+
+    tSSIToolLink *link = &g_ssiToolLinks[stream->instance];
+
+    if ((link->count[slot] != 0) && !link->done[slot]) {
+
+        link->busyArms++;
+
+    }
+
+    link->src[slot] = src;
+    link->count[slot] = count;
+    link->done[slot] = false;
+
+}
+
+uint32_t SSIStreamPortStoppedSlots(tSSIStream *stream) {
+
+    tSSIToolLink *link = &g_ssiToolLinks[stream->instance];
+    uint32_t stopped = 0;
+    uint32_t slot;
+
+    for (slot = 0; slot < 2; slot++) {
+
+        if ((link->count[slot] == 0) || link->done[slot] ||
+            (g_ssiToolEarlyStop && (slot == link->active) && (link->sent != 0))) {
+
+            stopped |= 1 << slot;
+
+        }
+
+    }
+
+    return stopped;
+
+}
+
+void SSIStreamPortKick(tSSIStream *stream) {
+
+    SSIStreamService(stream);
+
+}
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t SSIToolRandom(void) {
+
+    uint32_t x = g_ssiToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_ssiToolRandom = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// Let cycles of link time pass: send what the armed slots hold, raising the
+// completion interrupt as each one finishes.  An idle link banks no time.
+//
+//************************************************************************************
+static void SSIToolRun(tSSIStream *stream, uint64_t cycles) {
+
+    tSSIToolLink *link = &g_ssiToolLinks[stream->instance];
+    uint32_t slot;
+    uint16_t element;
+
+    link->budget += cycles;
+
+    while (link->budget >= link->elementCycles) {
+
+        slot = link->active;
+
+        if ((link->count[slot] == 0) || link->done[slot]) {
+
+            link->budget = 0;
+            break;
+
+        }
+
+        element = link->src[slot][link->sent];
+        link->budget -= link->elementCycles;
+
+        if ((link->expectHead == link->expectTail) ||
+            (link->expect[link->expectTail & SSI_TOOL_EXPECT_MASK] != element)) {
+
+            link->wrong++;
+
+        }
+
+        if (link->expectHead != link->expectTail) {
+
+            link->expectTail++;
+
+        }
+
+        if (++link->sent >= link->count[slot]) {
+
+            link->done[slot] = true;
+            link->sent = 0;
+            link->active ^= 1;
+            SSIStreamService(stream);
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Run the link until the stream is idle.
+//
+//************************************************************************************
+static void SSIToolDrain(tSSIStream *stream) {
+
+    SSIToolRun(stream, (uint64_t)(SSIStreamDepth(stream) + 1) *
+                       g_ssiToolLinks[stream->instance].elementCycles);
+
+}
+
+//************************************************************************************
+//
+// Offer one random write for the part on stream.  Returns the number of elements
+// in the frame; accepted tells whether the ring took it.
+//
+//************************************************************************************
+static uint32_t SSIToolOffer(tSSIStream *stream, bool *accepted) {
+
+    tSSIToolLink *link = &g_ssiToolLinks[stream->instance];
+    uint16_t frames[AD9952_FRAME_MAX];
+    uint16_t reg;
+    uint32_t word, count, i;
+
+    word = SSIToolRandom();
+
+    if (stream->instance == SSISTREAM_AD9834) {
+
+        reg = ((word & 0x80000000) != 0) ? AD9834_REG_FREQ1 : AD9834_REG_FREQ0;
+        AD9834PackFreq28(frames, AD9834_CTRL_B28, reg, word & 0x0FFFFFFF);
+        count = AD9834_FREQ_FRAMES;
+        *accepted = SSIStreamQueueAD9834Freq(stream, AD9834_CTRL_B28, reg,
+                                             word & 0x0FFFFFFF);
+
+    }
+
+    else {
+
+        reg = (uint16_t)(SSIToolRandom() % (AD9952_REG_POW0 + 1));
+        count = AD9952PackWrite(frames, (uint8_t)reg, word);
+        *accepted = SSIStreamQueueAD9952(stream, (uint8_t)reg, word);
+
+    }
+
+    if (*accepted) {
+
+        for (i = 0; i < count; i++) {
+
+            link->expect[(link->expectHead + i) & SSI_TOOL_EXPECT_MASK] = frames[i];
+
+        }
+
+        link->expectHead += count;
+
+    }
+
+    return count;
+
+}
+
+//************************************************************************************
+//
+// Offer frames writes on instance at loadPct percent of the link rate, the gap
+// before each drawn evenly from zero to twice its share, then drain.
+//
+//************************************************************************************
+static void SSIToolLoad(uint32_t instance, uint32_t frames, uint32_t loadPct,
+                        tSSIToolLoad *load) {
+
+    tSSIStream *stream = &g_ssiStreams[instance];
+    tSSIToolLink *link = &g_ssiToolLinks[instance];
+    uint32_t last = (instance == SSISTREAM_AD9834) ? AD9834_FREQ_FRAMES : 4;
+    uint64_t depthSum = 0;
+    uint64_t share;
+    uint32_t depth, count, i;
+    bool accepted;
+
+    SSIStreamInit(stream, instance);
+    SSIStreamPortInit(stream, BOOT_SYS_CLK_HZ, BOOT_SSI_BIT_RATE);
+    memset(load, 0, sizeof(*load));
+
+    for (i = 0; i < frames; i++) {
+
+        //
+        // The share of the previous frame's length, so the load holds for frames of
+        // mixed length
+        //
+        share = ((uint64_t)2 * last * link->elementCycles * 100) / loadPct;
+        SSIToolRun(stream, SSIToolRandom() % (share + 1));
+
+        depth = SSIStreamDepth(stream);
+        count = SSIToolOffer(stream, &accepted);
+
+        if (accepted != (count <= (SSISTREAM_RING_SIZE - depth))) {
+
+            load->badRefusals++;
+
+        }
+
+        if (accepted) {
+
+            load->accepted++;
+            load->elements += count;
+
+        }
+
+        else {
+
+            load->refused++;
+
+        }
+
+        depth = SSIStreamDepth(stream);
+        depthSum += depth;
+        load->maxDepth = (depth > load->maxDepth) ? depth : load->maxDepth;
+        last = count;
+
+    }
+
+    SSIToolDrain(stream);
+    load->meanDepth = (double)depthSum / frames;
+
+}
+
+//************************************************************************************
+//
+// True if every accepted element of instance went out and the stream agrees.
+//
+//************************************************************************************
+static bool SSIToolClean(uint32_t instance, const tSSIToolLoad *load) {
+
+    const tSSIStream *stream = &g_ssiStreams[instance];
+    const tSSIToolLink *link = &g_ssiToolLinks[instance];
+
+    return (link->wrong == 0) && (link->busyArms == 0) && (load->badRefusals == 0) &&
+           (link->expectHead == link->expectTail) && SSIStreamIdle(stream) &&
+           (stream->elementsSent == load->elements) &&
+           (stream->framesQueued == load->accepted) &&
+           (stream->rejected == load->refused) &&
+           (stream->highWater == load->maxDepth) &&
+           (stream->highWater <= SSISTREAM_RING_SIZE);
+
+}
+
+//************************************************************************************
+//
+// overload and light
+//
+//************************************************************************************
+static uint32_t SSIToolLoadCase(uint32_t instance, const char *name, uint32_t frames,
+                                uint32_t loadPct) {
+
+    const tSSIToolLink *link = &g_ssiToolLinks[instance];
+    tSSIToolLoad load;
+    bool pass;
+
+    SSIToolLoad(instance, frames, loadPct, &load);
+
+    pass = SSIToolClean(instance, &load) &&
+           ((loadPct > 100) ? (load.refused != 0) : (load.refused == 0));
+
+    printf("  %-10s %s  %u frames  %u refused  %u wraps  high water %u  "
+           "%u wrong  %u bad refusals  %s\n",
+           name, g_ssiToolNames[instance], frames, load.refused,
+           load.elements / SSISTREAM_RING_SIZE, load.maxDepth, link->wrong,
+           load.badRefusals, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// burst
+//
+//************************************************************************************
+static uint32_t SSIToolBurst(uint32_t instance) {
+
+    tSSIStream *stream = &g_ssiStreams[instance];
+    const tSSIToolLink *link = &g_ssiToolLinks[instance];
+    uint32_t elements = 0;
+    uint32_t count, full;
+    bool accepted, pass;
+
+    SSIStreamInit(stream, instance);
+    SSIStreamPortInit(stream, BOOT_SYS_CLK_HZ, BOOT_SSI_BIT_RATE);
+
+    for (;;) {
+
+        count = SSIToolOffer(stream, &accepted);
+
+        if (!accepted) {
+
+            break;
+
+        }
+
+        elements += count;
+
+    }
+
+    full = SSIStreamDepth(stream);
+    SSIToolDrain(stream);
+
+    pass = (full == elements) && (full <= SSISTREAM_RING_SIZE) &&
+           ((full + count) > SSISTREAM_RING_SIZE) && (link->wrong == 0) &&
+           (link->busyArms == 0) && SSIStreamIdle(stream) &&
+           (link->expectHead == link->expectTail) &&
+           (stream->elementsSent == elements);
+
+    printf("  %-10s %s  ring held %u of %u, refused a %u element frame, "
+           "drained  %s\n", "burst", g_ssiToolNames[instance], full,
+           SSISTREAM_RING_SIZE, count, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int SSIToolCheck(uint32_t frames) {
+
+    tSSIToolLoad load;
+    uint32_t bad = 0;
+    uint32_t instance;
+    bool caught, pass;
+
+    g_ssiToolRandom = SSI_TOOL_SEED;
+
+    g_ssiToolEarlyStop = true;
+    SSIToolLoad(SSISTREAM_AD9834, SSI_TOOL_CONTROL_FRAMES, 120, &load);
+    g_ssiToolEarlyStop = false;
+    caught = !SSIToolClean(SSISTREAM_AD9834, &load);
+    printf("  control    slot stopped early  %s\n\n",
+           caught ? "caught" : "FAIL: missed");
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        bad += SSIToolLoadCase(instance, "overload", frames, 120);
+        bad += SSIToolLoadCase(instance, "light", frames, 50);
+        bad += SSIToolBurst(instance);
+
+    }
+
+    pass = (bad == 0) && caught;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  Host time per frame queued, serviced and sent with the link keeping up,
+// then the modelled link at rising offered load: the rate the link sustains, and
+// how deep the ring runs and how much is refused as the load nears and passes it.
+//
+//************************************************************************************
+static double SSIToolElapsed(const struct timespec *t0, const struct timespec *t1) {
+
+    return ((double)(t1->tv_sec - t0->tv_sec) * 1e9) +
+           (double)(t1->tv_nsec - t0->tv_nsec);
+
+}
+
+static int SSIToolBench(uint32_t frames) {
+
+    static const uint32_t loads[] = { 25, 50, 75, 90, 100, 110 };
+    struct timespec t0, t1;
+    tSSIToolLoad load;
+    tSSIStream *stream;
+    uint32_t instance, count, done, i;
+    double ns, elements;
+    bool accepted;
+
+    g_ssiToolRandom = SSI_TOOL_SEED;
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        stream = &g_ssiStreams[instance];
+        SSIStreamInit(stream, instance);
+        SSIStreamPortInit(stream, BOOT_SYS_CLK_HZ, BOOT_SSI_BIT_RATE);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (done = 0; done < frames; done++) {
+
+            count = SSIToolOffer(stream, &accepted);
+            SSIToolRun(stream,
+                       (uint64_t)count * g_ssiToolLinks[instance].elementCycles);
+
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = SSIToolElapsed(&t0, &t1) / frames;
+        elements = (double)stream->elementsSent / frames;
+
+        printf("  %s  host %6.1f ns/frame (%.2f elements), link %.0f frames/s at "
+               "%u MHz\n", g_ssiToolNames[instance], ns, elements,
+               BOOT_SYS_CLK_HZ / (elements * g_ssiToolLinks[instance].elementCycles),
+               BOOT_SSI_BIT_RATE / 1000000);
+
+        for (i = 0; i < (sizeof(loads) / sizeof(loads[0])); i++) {
+
+            SSIToolLoad(instance, frames, loads[i], &load);
+            printf("      load %3u%%  depth mean %7.1f max %4u  refused %5.2f%%\n",
+                   loads[i], load.meanDepth, load.maxDepth,
+                   (100.0 * load.refused) / frames);
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t frames = 0;
+
+    if (argc >= 3) {
+
+        frames = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (frames == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [frames]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return SSIToolCheck((frames != 0) ? frames : SSI_TOOL_FRAMES);
+
+    }
+
+    return SSIToolBench((frames != 0) ? frames : SSI_TOOL_BENCH);
+
+}
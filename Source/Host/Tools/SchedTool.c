@@ -0,0 +1,587 @@
+//************************************************************************************
+//
+// Title:               Scheduler Jitter and Idle Harness
+// Author:              Jacob Putz
+// Filename:            SchedTool.c
+//
+// Description:     Runs thousands of periodic tasks through the event scheduler on
+//                      the simulated HAL, with each task charging its own run time,
+//                      and reports the dispatch lateness (jitter) and the share of
+//                      time the CPU spent asleep.  check also verifies that no task
+//                      is run early, out of order, twice or never.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/sched_tool, with Scheduler.c compiled for
+//  it alone with SCHED_MAX_TASKS=4096.
+//
+//  Usage:
+//
+//      sched_tool check [tasks]        jitter and idle at no load and at 60%
+//      sched_tool bench [tasks]        jitter and idle against load, and host
+//                                      cost per dispatch and per move
+//
+//  Every task has a period drawn log-uniformly from 1 ms to 1 s, a random phase
+//  within it, and a run time in cycles; a task requeues itself with
+//  SchedulerDefer() and charges its run time with HalHostAdvance(), which is what
+//  delays the tasks queued behind it.  Run times are drawn uniformly around the
+//  mean that gives the run's load.  A run lasts SCHED_TOOL_SECONDS of simulated
+//  time from SchedulerInit(), at 120 MHz with the 10 Hz tick DDSExperiment.c uses,
+//  so the power manager picks sleep or deep sleep for each gap as on the target.
+//
+//  Lateness is TimeBaseMicros() at dispatch less the deadline, the value the
+//  scheduler adds to g_schedStats.  Idle is g_schedStats.idleCycles over the
+//  cycles elapsed since SchedulerInit().
+//
+//  check passes if, in both runs:
+//
+//      no task is run before its deadline, or while an earlier one is queued
+//      every task is still queued at the end, its next deadline is its phase plus
+//      a whole number of periods for the runs it had, and is not in the past
+//      idle cycles plus the run time charged account for every elapsed cycle
+//
+//      the measured busy share is within SCHED_TOOL_SLACK points of the load
+//      asked for
+//
+//  and, at no load, no dispatch is late at all.  Lateness under load is reported,
+//  not bounded.  Exits 1 on any failure.
+//
+//  The host cost columns in bench are this machine's time for the heap work
+//  alone; simulated time does not advance for it.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Power.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
+
+// Defines
+#define     SCHED_TOOL_TASKS        SCHED_MAX_TASKS
+#define     SCHED_TOOL_SECONDS      2
+#define     SCHED_TOOL_PERIOD_MIN   1000        // us
+#define     SCHED_TOOL_PERIOD_MAX   1000000     // us
+#define     SCHED_TOOL_LOAD         60          // Percent, the loaded check run
+#define     SCHED_TOOL_SLACK        3           // Points of busy share
+#define     SCHED_TOOL_HIST         1024        // Lateness histogram, 1 us bins
+#define     SCHED_TOOL_SEED         0x5EED1234
+
+#define     SCHED_TOOL_DISPATCHES   2000000     // Per heap size, bench
+#define     SCHED_TOOL_MOVES        2000000
+
+// Type Definitions
+typedef struct {
+
+    tSchedTask task;
+    uint64_t phase;                 // First deadline
+    uint32_t period;                // us
+    uint32_t work;                  // Cycles charged per run
+    uint64_t runs;
+
+} tSchedToolTask;
+
+typedef struct {
+
+    uint64_t dispatched;
+    uint64_t early;                 // Run before the deadline
+    uint64_t order;                 // Dispatched while an earlier deadline was queued
+    uint64_t lost;                  // Not queued, off its grid, or overdue at the end
+    uint64_t lateSum;
+    uint64_t lateMax;
+    uint64_t lateP99;
+    uint64_t elapsed;               // Cycles since SchedulerInit()
+    uint64_t idle;
+    uint64_t work;                  // Cycles charged by the tasks
+    double asked;                   // Load asked for, percent
+
+} tSchedToolResult;
+
+// Global Variables
+static tSchedToolTask g_schedToolTasks[SCHED_TOOL_TASKS];
+static tSchedToolResult g_schedToolResult;
+static uint64_t g_schedToolHist[SCHED_TOOL_HIST];   // Last bin collects the rest
+static uint64_t g_schedToolBenchLeft;
+static uint32_t g_schedToolBenchCount;
+static uint32_t g_schedToolRandom;
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t SchedToolRandom(void) {
+
+    uint32_t x = g_schedToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_schedToolRandom = x;
+
+    return x;
+
+}
+
+static double SchedToolSeconds(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (now.tv_nsec * 1e-9);
+
+}
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c).
+//
+//************************************************************************************
+static void SchedToolBoot(void) {
+
+    BootHostRun(false);
+
+}
+
+//************************************************************************************
+//
+// A periodic task: check and record the dispatch, charge the run time, requeue.
+//
+//************************************************************************************
+static void SchedToolTask(tSchedTask *task, uint64_t now) {
+
+    tSchedToolTask *tool = task->arg;
+    tSchedToolResult *result = &g_schedToolResult;
+    uint64_t late = now - task->deadline;
+
+    if (now < task->deadline) {
+
+        result->early++;
+        late = 0;
+
+    }
+
+    //
+    // The task has been popped, so everything left must be due no sooner.
+    //
+    if (task->deadline > SchedulerNextDeadline()) {
+
+        result->order++;
+
+    }
+
+    g_schedToolHist[(late < SCHED_TOOL_HIST) ? late : (SCHED_TOOL_HIST - 1)]++;
+    result->dispatched++;
+    result->lateSum += late;
+
+    if (late > result->lateMax) {
+
+        result->lateMax = late;
+
+    }
+
+    tool->runs++;
+
+    if (tool->work != 0) {
+
+        HalHostAdvance(tool->work);
+        result->work += tool->work;
+
+    }
+
+    SchedulerDefer(task, tool->period);
+
+}
+
+//************************************************************************************
+//
+// Draw count tasks for the given load, in percent of the CPU.
+//
+//************************************************************************************
+static double SchedToolDraw(uint32_t count, uint32_t load) {
+
+    double rate = 0;
+    double asked = 0;
+    double mean;
+    uint32_t i;
+
+    g_schedToolRandom = SCHED_TOOL_SEED;
+
+    for (i = 0; i < count; i++) {
+
+        tSchedToolTask *tool = &g_schedToolTasks[i];
+        double u = (double)SchedToolRandom() / 4294967296.0;
+
+        tool->period = (uint32_t)(SCHED_TOOL_PERIOD_MIN *
+                                  pow((double)SCHED_TOOL_PERIOD_MAX /
+                                      SCHED_TOOL_PERIOD_MIN, u));
+        tool->phase = SchedToolRandom() % tool->period;
+        rate += 1e6 / tool->period;
+
+    }
+
+    //
+    // Run times are uniform on [0, 2 * mean], so the load asked for is what the
+    // draw gives rather than exactly load.
+    //
+    mean = ((double)load / 100.0) * BOOT_SYS_CLK_HZ / rate;
+
+    for (i = 0; i < count; i++) {
+
+        tSchedToolTask *tool = &g_schedToolTasks[i];
+
+        tool->work = (uint32_t)(((double)SchedToolRandom() / 4294967296.0) * 2 * mean);
+        asked += ((double)tool->work * 1e6) / tool->period;
+
+    }
+
+    return (asked * 100.0) / BOOT_SYS_CLK_HZ;
+
+}
+
+//************************************************************************************
+//
+// One run: every task queued from now, SCHED_TOOL_SECONDS of the main loop, then
+// the end-of-run checks.
+//
+//************************************************************************************
+static void SchedToolRun(uint32_t count, uint32_t load) {
+
+    tSchedToolResult *result = &g_schedToolResult;
+    uint64_t start, stop, seen, i;
+
+    memset(result, 0, sizeof(*result));
+    memset(g_schedToolHist, 0, sizeof(g_schedToolHist));
+    result->asked = SchedToolDraw(count, load);
+
+    SchedulerInit();
+    start = TimeBaseMicros();
+    stop = start + (SCHED_TOOL_SECONDS * 1000000ULL);
+
+    for (i = 0; i < count; i++) {
+
+        tSchedToolTask *tool = &g_schedToolTasks[i];
+
+        tool->phase += start;
+        tool->runs = 0;
+        SchedulerTaskInit(&tool->task, SchedToolTask, tool);
+        SchedulerAdd(&tool->task, tool->phase);
+
+    }
+
+    while (TimeBaseMicros() < stop) {
+
+        SchedulerPoll();
+
+    }
+
+    //
+    // The loop only ends after a sleep, which runs up to the earliest deadline and
+    // no further, so nothing queued can be behind the clock.
+    //
+    stop = TimeBaseMicros();
+    result->elapsed = TimeBaseCycles() - g_schedStats.startCycles;
+    result->idle = g_schedStats.idleCycles;
+
+    for (i = 0; i < count; i++) {
+
+        tSchedToolTask *tool = &g_schedToolTasks[i];
+
+        if ((tool->task.heapIndex == SCHED_NOT_QUEUED) ||
+            (tool->task.deadline != (tool->phase + (tool->runs * tool->period))) ||
+            (tool->task.deadline < stop)) {
+
+            result->lost++;
+
+        }
+
+        SchedulerRemove(&tool->task);
+
+    }
+
+    for (i = 0, seen = 0; i < SCHED_TOOL_HIST; i++) {
+
+        seen += g_schedToolHist[i];
+
+        if ((seen * 100) >= (result->dispatched * 99)) {
+
+            break;
+
+        }
+
+    }
+
+    result->lateP99 = i;
+
+}
+
+static void SchedToolPrint(const char *name, uint32_t count) {
+
+    tSchedToolResult *result = &g_schedToolResult;
+    double busy = 100.0 - ((result->idle * 100.0) / result->elapsed);
+
+    printf("  %-10s %5u tasks  %8llu runs  asked %5.1f%%  busy %5.1f%%  "
+           "late mean %6.2f  p99 %4llu%s  max %5llu us\n", name, count,
+           (unsigned long long)result->dispatched, result->asked, busy,
+           (double)result->lateSum / result->dispatched,
+           (unsigned long long)result->lateP99,
+           (result->lateP99 >= (SCHED_TOOL_HIST - 1)) ? "+" : " ",
+           (unsigned long long)result->lateMax);
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static bool SchedToolVerify(const char *name, uint32_t count, bool loaded) {
+
+    tSchedToolResult *result = &g_schedToolResult;
+    uint64_t accounted = result->idle + result->work;
+    double busy = 100.0 - ((result->idle * 100.0) / result->elapsed);
+    bool pass = true;
+
+    SchedToolPrint(name, count);
+
+    if ((result->early != 0) || (result->order != 0) || (result->lost != 0)) {
+
+        printf("    FAIL: %llu early, %llu out of order, %llu lost\n",
+               (unsigned long long)result->early, (unsigned long long)result->order,
+               (unsigned long long)result->lost);
+        pass = false;
+
+    }
+
+    if (accounted != result->elapsed) {
+
+        printf("    FAIL: idle %llu + run %llu cycles, %llu elapsed\n",
+               (unsigned long long)result->idle, (unsigned long long)result->work,
+               (unsigned long long)result->elapsed);
+        pass = false;
+
+    }
+
+    if (!loaded && (result->lateMax != 0)) {
+
+        printf("    FAIL: late with nothing else to run\n");
+        pass = false;
+
+    }
+
+    if (fabs(busy - result->asked) > SCHED_TOOL_SLACK) {
+
+        printf("    FAIL: busy share off the load asked for\n");
+        pass = false;
+
+    }
+
+    return pass;
+
+}
+
+static int SchedToolCheck(uint32_t count) {
+
+    bool pass = true;
+
+    SchedToolBoot();
+    printf("%u s simulated per run, periods %u us to %u us\n\n", SCHED_TOOL_SECONDS,
+           SCHED_TOOL_PERIOD_MIN, SCHED_TOOL_PERIOD_MAX);
+
+    SchedToolRun(count, 0);
+    pass = SchedToolVerify("no load", count, false) && pass;
+
+    SchedToolRun(count, SCHED_TOOL_LOAD);
+    pass = SchedToolVerify("loaded", count, true) && pass;
+
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  Dispatch: every task already due, each requeuing itself a random step
+// ahead, still in the past, until SCHED_TOOL_DISPATCHES have run, timed over one
+// SchedulerPoll().  Move: SchedulerAdd() of a queued task to a random deadline.
+//
+//************************************************************************************
+static void SchedToolBenchTask(tSchedTask *task, uint64_t now) {
+
+    (void)now;
+
+    if (g_schedToolBenchLeft != 0) {
+
+        g_schedToolBenchLeft--;
+        SchedulerDefer(task, 1 + (SchedToolRandom() % g_schedToolBenchCount));
+
+    }
+
+}
+
+static void SchedToolBenchHeap(uint32_t count) {
+
+    uint64_t now = TimeBaseMicros();
+    double start, dispatch, move;
+    uint32_t i;
+
+    SchedulerInit();
+    g_schedToolBenchCount = count;
+
+    for (i = 0; i < count; i++) {
+
+        SchedulerTaskInit(&g_schedToolTasks[i].task, SchedToolBenchTask, 0);
+        SchedulerAdd(&g_schedToolTasks[i].task, SchedToolRandom() % count);
+
+    }
+
+    g_schedToolBenchLeft = SCHED_TOOL_DISPATCHES;
+    start = SchedToolSeconds();
+    SchedulerPoll();
+    dispatch = (SchedToolSeconds() - start) / g_schedStats.dispatched;
+
+    for (i = 0; i < count; i++) {
+
+        SchedulerAdd(&g_schedToolTasks[i].task, now + (SchedToolRandom() % 1000000));
+
+    }
+
+    start = SchedToolSeconds();
+
+    for (i = 0; i < SCHED_TOOL_MOVES; i++) {
+
+        SchedulerAdd(&g_schedToolTasks[SchedToolRandom() % count].task,
+                     now + (SchedToolRandom() % 1000000));
+
+    }
+
+    move = (SchedToolSeconds() - start) / SCHED_TOOL_MOVES;
+
+    for (i = 0; i < count; i++) {
+
+        SchedulerRemove(&g_schedToolTasks[i].task);
+
+    }
+
+    printf("  %5u tasks  %6.1f ns/dispatch  %6.1f ns/move\n", count, dispatch * 1e9,
+           move * 1e9);
+
+}
+
+static int SchedToolBench(uint32_t count) {
+
+    static const uint32_t loads[] = { 0, 25, 50, 75, 90 };
+    uint32_t i;
+
+    SchedToolBoot();
+
+    printf("Jitter and idle against load, %u s simulated each\n\n", SCHED_TOOL_SECONDS);
+
+    for (i = 0; i < (sizeof(loads) / sizeof(loads[0])); i++) {
+
+        char name[16];
+
+        snprintf(name, sizeof(name), "%u%%", loads[i]);
+        SchedToolRun(count, loads[i]);
+        SchedToolPrint(name, count);
+
+    }
+
+    //
+    // Deadlines in the dispatch test have to stay in the past.  Each task steps
+    // half the heap size on average, so they reach about SCHED_TOOL_DISPATCHES / 2
+    // microseconds.
+    //
+    HalHostAdvance((uint64_t)BOOT_SYS_CLK_HZ * (1 + (SCHED_TOOL_DISPATCHES / 1000000)));
+
+    printf("\nHost cost against heap size\n\n");
+
+    for (i = 16; i <= count; i *= 4) {
+
+        SchedToolBenchHeap(i);
+
+    }
+
+    if ((i / 4) != count) {
+
+        SchedToolBenchHeap(count);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t count = SCHED_TOOL_TASKS;
+
+    if (argc >= 3) {
+
+        count = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || (count == 0) || (count > SCHED_TOOL_TASKS) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [tasks, at most %u]\n", argv[0],
+                SCHED_TOOL_TASKS);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return SchedToolCheck(count);
+
+    }
+
+    return SchedToolBench(count);
+
+}
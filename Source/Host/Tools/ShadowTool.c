@@ -0,0 +1,792 @@
+//************************************************************************************
+//
+// Title:               Register Shadow - Check and Benchmark Tool
+// Author:              Jacob Putz
+// Filename:            ShadowTool.c
+//
+// Description:     Host command line tool that drives the AD9834 and AD9952 register
+//                      shadows with seeded workloads, decodes every flush as the
+//                      parts would, checks the parts end up in the requested state
+//                      with no intermediate value on the output, and counts the
+//                      frames sent against the frames the calls would have cost
+//                      written one by one.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/shadow_tool.
+//
+//  Usage:
+//
+//      shadow_tool check [flushes]     every case below
+//      shadow_tool bench [flushes]     frames and host time per flush
+//
+//  The shadows are flushed into a frame buffer, not an SSI stream, and each
+//  flush is decoded by a model of the part written from its datasheet: the
+//  AD9834's control word, B28 pairs, HLB halves, phase registers and the
+//  FSELECT/PSELECT pins; the AD9952's instruction byte and register widths.
+//
+//  minimal     scripted changes from a known state whose smallest flush is
+//              known: a repeated value, one phase, one half in the current mode
+//              and in another, both halves, a glitch-free retune by control word
+//              and by pins.  Each flush must be exactly that size.
+//  workloads   seeded call sequences, flushed after every few calls:
+//
+//      fine        the selected frequency nudged by a few LSBs
+//      coarse      the selected frequency moved by whole MSB steps
+//      hop         Retune() to random frequencies
+//      hop pins    the same with PIN_SW set, switching on the pins
+//      mixed       frequency, phase, control and retune calls on both
+//                  registers, a third of them repeating the current value
+//      ad9952      register writes, a third of them repeating the value
+//
+//              After every flush the part must hold the requested registers,
+//              control bits and selection, no B28 pair may be left half sent,
+//              and the output frequency and phase may each change at most once,
+//              from the old value to the new one.  The frames sent may never
+//              exceed the frames the calls would have cost written one by one
+//              (naiveFrames).
+//
+//  Two negative controls must be caught: a flush with its last frame dropped
+//  (the state check) and both halves of the selected register written as two
+//  HLB frames (the output check).  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+
+// Defines
+#define     SHADOW_TOOL_SEED        0x5EED1234
+#define     SHADOW_TOOL_FLUSHES     20000
+#define     SHADOW_TOOL_BENCH       1000000
+#define     SHADOW_TOOL_FREQ_MASK   ((1UL << AD9834_FREQ_BITS) - 1)
+#define     SHADOW_TOOL_SEL_MASK    (AD9834_CTRL_FSEL | AD9834_CTRL_PSEL)
+#define     SHADOW_TOOL_MODE_MASK   (AD9834_CTRL_B28 | AD9834_CTRL_HLB)
+
+// Control bits the workloads change.  RESET and SLEEP are left alone only to keep
+// the output meaningful; the shadow treats every bit alike.
+#define     SHADOW_TOOL_CTRL_BITS   (AD9834_CTRL_OPBITEN | AD9834_CTRL_SIGN_PIB |   \
+                                     AD9834_CTRL_DIV2 | AD9834_CTRL_MODE)
+
+// Workloads
+#define     SHADOW_TOOL_FINE        0
+#define     SHADOW_TOOL_COARSE      1
+#define     SHADOW_TOOL_HOP         2
+#define     SHADOW_TOOL_HOP_PINS    3
+#define     SHADOW_TOOL_MIXED       4
+#define     SHADOW_TOOL_AD9952      5
+#define     SHADOW_TOOL_WORKLOADS   6
+
+// Type Definitions
+typedef struct {
+
+    uint16_t ctrl;
+    uint32_t freq[2];
+    uint16_t phase[2];
+    uint16_t pins;                  // FSELECT/PSELECT levels, as control bits
+    int32_t pending;                // B28 register waiting for its MSB, or -1
+    uint16_t lsb;
+
+    //
+    // Output over one update
+    //
+    uint32_t outFreq;
+    uint16_t outPhase;
+    uint32_t freqChanges;
+    uint32_t phaseChanges;
+
+} tShadowToolAD9834;
+
+typedef struct {
+
+    uint32_t reg[DDSSHADOW_AD9952_REGS];
+    uint8_t addr;
+    uint32_t remain;
+    uint32_t value;
+
+} tShadowToolAD9952;
+
+typedef struct {
+
+    uint32_t flushes;
+    uint32_t naive;
+    uint32_t sent;
+    uint32_t bad;
+
+} tShadowToolStats;
+
+// Global Constants
+static const char *const g_shadowToolNames[SHADOW_TOOL_WORKLOADS] = {
+
+    "fine", "coarse", "hop", "hop pins", "mixed", "ad9952"
+
+};
+
+// Global Variables
+static uint32_t g_shadowToolRandom = SHADOW_TOOL_SEED;
+static tAD9834Shadow g_shadowToolAD9834;
+static tAD9952Shadow g_shadowToolAD9952;
+static tShadowToolAD9834 g_shadowToolPart;
+static tShadowToolAD9952 g_shadowToolPart9952;
+static uint16_t g_shadowToolFrames[DDSSHADOW_AD9952_FRAMES_MAX];
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t ShadowToolRandom(void) {
+
+    uint32_t x = g_shadowToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_shadowToolRandom = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// The AD9834 model.  The output is the register FSELECT/PSELECT pick: the control
+// bits, or the pins with PIN_SW set.
+//
+//************************************************************************************
+static uint16_t ShadowToolSelected(const tShadowToolAD9834 *part) {
+
+    if ((part->ctrl & AD9834_CTRL_PIN_SW) != 0) {
+
+        return part->pins;
+
+    }
+
+    return part->ctrl & SHADOW_TOOL_SEL_MASK;
+
+}
+
+static void ShadowToolObserve(tShadowToolAD9834 *part) {
+
+    uint16_t sel = ShadowToolSelected(part);
+    uint32_t freq = part->freq[((sel & AD9834_CTRL_FSEL) != 0) ? 1 : 0];
+    uint16_t phase = part->phase[((sel & AD9834_CTRL_PSEL) != 0) ? 1 : 0];
+
+    part->freqChanges += (freq != part->outFreq) ? 1 : 0;
+    part->phaseChanges += (phase != part->outPhase) ? 1 : 0;
+    part->outFreq = freq;
+    part->outPhase = phase;
+
+}
+
+static void ShadowToolFrame(tShadowToolAD9834 *part, uint16_t frame) {
+
+    uint32_t index, data;
+
+    switch (frame & 0xC000) {
+
+        case AD9834_REG_CTRL:
+
+            part->ctrl = frame & 0x3FFF;
+            break;
+
+        case AD9834_REG_FREQ0:
+        case AD9834_REG_FREQ1:
+
+            index = ((frame & 0xC000) == AD9834_REG_FREQ1) ? 1 : 0;
+            data = frame & AD9834_FREQ_HALF_MASK;
+
+            if ((part->ctrl & AD9834_CTRL_B28) != 0) {
+
+                if (part->pending == (int32_t)index) {
+
+                    part->freq[index] = part->lsb | (data << 14);
+                    part->pending = -1;
+
+                }
+
+                else {
+
+                    //
+                    // A pair started on the other register is lost
+                    //
+                    part->lsb = (uint16_t)data;
+                    part->pending = (int32_t)index;
+
+                }
+
+            }
+
+            else if ((part->ctrl & AD9834_CTRL_HLB) != 0) {
+
+                part->freq[index] = (part->freq[index] & AD9834_FREQ_HALF_MASK) |
+                                    (data << 14);
+
+            }
+
+            else {
+
+                part->freq[index] = (part->freq[index] & ~AD9834_FREQ_HALF_MASK) |
+                                    data;
+
+            }
+
+            break;
+
+        default:
+
+            part->phase[((frame & 0xE000) == AD9834_REG_PHASE1) ? 1 : 0] =
+                frame & AD9834_PHASE_MASK;
+            break;
+
+    }
+
+    ShadowToolObserve(part);
+
+}
+
+static void ShadowToolFrames(tShadowToolAD9834 *part, const uint16_t *frames,
+                             uint32_t count) {
+
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+
+        ShadowToolFrame(part, frames[i]);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Differences between the model and what was asked of the shadow, and output
+// changes beyond one each for frequency and phase.
+//
+//************************************************************************************
+static uint32_t ShadowToolCompare(const tAD9834Shadow *shadow,
+                                  const tShadowToolAD9834 *part) {
+
+    uint16_t keep = (uint16_t)~(SHADOW_TOOL_MODE_MASK | SHADOW_TOOL_SEL_MASK);
+    uint32_t bad = 0;
+    uint32_t i;
+
+    for (i = 0; i < 2; i++) {
+
+        bad += (((shadow->set & (DDSSHADOW_AD9834_FREQ0 << i)) != 0) &&
+                (part->freq[i] != shadow->freq[i])) ? 1 : 0;
+        bad += (((shadow->set & (DDSSHADOW_AD9834_PHASE0 << i)) != 0) &&
+                (part->phase[i] != shadow->phase[i])) ? 1 : 0;
+
+    }
+
+    bad += ((part->ctrl & keep) != (shadow->ctrl & keep)) ? 1 : 0;
+    bad += (ShadowToolSelected(part) != (shadow->ctrl & SHADOW_TOOL_SEL_MASK)) ?
+           1 : 0;
+    bad += (part->pending >= 0) ? 1 : 0;
+    bad += (part->freqChanges > 1) ? 1 : 0;
+    bad += (part->phaseChanges > 1) ? 1 : 0;
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// Flush the AD9834 shadow into the model, switching the pins when the flush
+// stops for them, and check the result.  drop leaves the last frame out.  Adds
+// the frames sent to *sent.
+//
+//************************************************************************************
+static uint32_t ShadowToolUpdate(tAD9834Shadow *shadow, tShadowToolAD9834 *part,
+                                 uint32_t *sent, bool drop) {
+
+    uint32_t count;
+
+    part->freqChanges = 0;
+    part->phaseChanges = 0;
+
+    count = DDSShadowAD9834Flush(shadow, g_shadowToolFrames);
+    *sent += count;
+    ShadowToolFrames(part, g_shadowToolFrames, (drop && (count != 0)) ? (count - 1) :
+                                                                       count);
+
+    if (shadow->pinSwitch) {
+
+        part->pins = shadow->ctrl & SHADOW_TOOL_SEL_MASK;
+        ShadowToolObserve(part);
+        DDSShadowAD9834PinsSwitched(shadow);
+        count = DDSShadowAD9834Flush(shadow, g_shadowToolFrames);
+        *sent += count;
+        ShadowToolFrames(part, g_shadowToolFrames, count);
+
+    }
+
+    return ShadowToolCompare(shadow, part);
+
+}
+
+//************************************************************************************
+//
+// Fresh shadow and model with every register set and sent once.
+//
+//************************************************************************************
+static void ShadowToolStartAD9834(bool pins) {
+
+    uint32_t sent = 0;
+
+    DDSShadowAD9834Init(&g_shadowToolAD9834);
+    memset(&g_shadowToolPart, 0, sizeof(g_shadowToolPart));
+    g_shadowToolPart.pending = -1;
+
+    DDSShadowAD9834SetCtrl(&g_shadowToolAD9834, pins ? AD9834_CTRL_PIN_SW : 0,
+                           0x3FFF);
+    DDSShadowAD9834SetFreq(&g_shadowToolAD9834, 0, 0x0123456);
+    DDSShadowAD9834SetFreq(&g_shadowToolAD9834, 1, 0x0654321);
+    DDSShadowAD9834SetPhase(&g_shadowToolAD9834, 0, 0x000);
+    DDSShadowAD9834SetPhase(&g_shadowToolAD9834, 1, 0x800);
+    ShadowToolUpdate(&g_shadowToolAD9834, &g_shadowToolPart, &sent, false);
+
+}
+
+//************************************************************************************
+//
+// minimal
+//
+//************************************************************************************
+static uint32_t ShadowToolMinimal(void) {
+
+    tAD9834Shadow *shadow = &g_shadowToolAD9834;
+    tShadowToolAD9834 *part = &g_shadowToolPart;
+    uint32_t bad = 0;
+    uint32_t sent, step, expect, word;
+
+    for (step = 0; step < 9; step++) {
+
+        if ((step == 0) || (step == 7)) {
+
+            ShadowToolStartAD9834(step == 7);
+
+        }
+
+        word = shadow->freq[0];
+
+        switch (step) {
+
+            case 0:     // Same value: nothing to send
+                DDSShadowAD9834SetFreq(shadow, 0, word);
+                DDSShadowAD9834SetPhase(shadow, 1, shadow->phase[1]);
+                expect = 0;
+                break;
+
+            case 1:     // One phase register: any mode will do
+                DDSShadowAD9834SetPhase(shadow, 1, 0x123);
+                expect = 1;
+                break;
+
+            case 2:     // Both halves, already in B28 mode
+                DDSShadowAD9834SetFreq(shadow, 0, word ^ 0x0404040);
+                expect = 2;
+                break;
+
+            case 3:     // Low half: one control frame into LSB mode, one write
+                DDSShadowAD9834SetFreq(shadow, 0, word + 1);
+                expect = 2;
+                break;
+
+            case 4:     // Low half again, already in LSB mode
+                DDSShadowAD9834SetFreq(shadow, 0, word + 1);
+                expect = 1;
+                break;
+
+            case 5:     // High half: into HLB mode, one write
+                DDSShadowAD9834SetFreq(shadow, 0, word + (1UL << 14));
+                expect = 2;
+                break;
+
+            case 6:     // Retune: control into B28, both halves, control to switch
+                DDSShadowAD9834Retune(shadow, word ^ 0x0404040);
+                expect = 4;
+                break;
+
+            case 7:     // Retune on the pins: both halves in B28 mode, no control
+                DDSShadowAD9834Retune(shadow, word ^ 0x0404040);
+                expect = 2;
+                break;
+
+            default:    // And back, to the other register
+                DDSShadowAD9834Retune(shadow, word ^ 0x0101010);
+                expect = 2;
+                break;
+
+        }
+
+        sent = 0;
+
+        if ((ShadowToolUpdate(shadow, part, &sent, false) != 0) || (sent != expect)) {
+
+            printf("    step %u: %u frames, expected %u\n", step, sent, expect);
+            bad++;
+
+        }
+
+    }
+
+    printf("  minimal        9 scripted flushes  %u bad  %s\n", bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// One workload's calls between two flushes.
+//
+//************************************************************************************
+static void ShadowToolCalls(uint32_t workload) {
+
+    tAD9834Shadow *shadow = &g_shadowToolAD9834;
+    uint32_t sel = ((ShadowToolSelected(&g_shadowToolPart) & AD9834_CTRL_FSEL) != 0) ?
+                   1 : 0;
+    uint32_t calls = 1 + (ShadowToolRandom() % 4);
+    uint32_t r, index, word;
+
+    while (calls-- != 0) {
+
+        r = ShadowToolRandom();
+        index = (r >> 8) & 1;
+        word = (r % 3 == 0) ? shadow->freq[index] :
+               (ShadowToolRandom() & SHADOW_TOOL_FREQ_MASK);
+
+        switch (workload) {
+
+            case SHADOW_TOOL_FINE:
+                DDSShadowAD9834SetFreq(shadow, sel,
+                                       shadow->freq[sel] + (r % 64) - 32);
+                break;
+
+            case SHADOW_TOOL_COARSE:
+                DDSShadowAD9834SetFreq(shadow, sel,
+                                       shadow->freq[sel] + (((r % 8) + 1) << 14));
+                break;
+
+            case SHADOW_TOOL_HOP:
+            case SHADOW_TOOL_HOP_PINS:
+                DDSShadowAD9834Retune(shadow, word);
+                break;
+
+            case SHADOW_TOOL_MIXED:
+
+                switch ((r >> 4) % 6) {
+
+                    case 0:
+                    case 1:
+                        DDSShadowAD9834SetFreq(shadow, index, word);
+                        break;
+
+                    case 2:
+                        word = (r % 3 == 0) ? shadow->phase[index] :
+                                              ShadowToolRandom();
+                        DDSShadowAD9834SetPhase(shadow, index, word);
+                        break;
+
+                    case 3:
+                        DDSShadowAD9834SetCtrl(shadow, (uint16_t)ShadowToolRandom(),
+                                               SHADOW_TOOL_CTRL_BITS);
+                        break;
+
+                    case 4:
+                        DDSShadowAD9834Retune(shadow, word);
+                        break;
+
+                    default:
+                        DDSShadowAD9834Rephase(shadow, ShadowToolRandom());
+                        break;
+
+                }
+
+                break;
+
+            default:
+
+                index = (r >> 4) % DDSSHADOW_AD9952_REGS;
+                DDSShadowAD9952Set(&g_shadowToolAD9952, (uint8_t)index,
+                                   (r % 3 == 0) ? g_shadowToolAD9952.reg[index] :
+                                                  ShadowToolRandom());
+                break;
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The AD9952 model: instruction byte, then the register's bytes MSB first.
+//
+//************************************************************************************
+static uint32_t ShadowToolUpdateAD9952(tAD9952Shadow *shadow, tShadowToolAD9952 *part,
+                                       uint32_t *sent) {
+
+    uint32_t count = DDSShadowAD9952Flush(shadow, g_shadowToolFrames);
+    uint32_t bad = 0;
+    uint32_t i;
+
+    *sent += count;
+
+    for (i = 0; i < count; i++) {
+
+        if (part->remain == 0) {
+
+            part->addr = (uint8_t)(g_shadowToolFrames[i] & AD9952_INSTR_ADDR_MASK);
+            part->remain = AD9952RegBytes(part->addr);
+            part->value = 0;
+            bad += (part->remain == 0) ? 1 : 0;
+
+        }
+
+        else {
+
+            part->value = (part->value << 8) | (g_shadowToolFrames[i] & 0xFF);
+
+            if (--part->remain == 0) {
+
+                part->reg[part->addr] = part->value;
+
+            }
+
+        }
+
+    }
+
+    bad += (part->remain != 0) ? 1 : 0;
+
+    for (i = 0; i < DDSSHADOW_AD9952_REGS; i++) {
+
+        bad += (((shadow->set & DDSSHADOW_AD9952_REG(i)) != 0) &&
+                (part->reg[i] != shadow->reg[i])) ? 1 : 0;
+
+    }
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// Run flushes of workload, from a fresh shadow, into stats.
+//
+//************************************************************************************
+static void ShadowToolRun(uint32_t workload, uint32_t flushes,
+                          tShadowToolStats *stats) {
+
+    uint32_t naive0, i;
+
+    memset(stats, 0, sizeof(*stats));
+
+    if (workload == SHADOW_TOOL_AD9952) {
+
+        DDSShadowAD9952Init(&g_shadowToolAD9952);
+        memset(&g_shadowToolPart9952, 0, sizeof(g_shadowToolPart9952));
+
+        for (i = 0; i < DDSSHADOW_AD9952_REGS; i++) {
+
+            DDSShadowAD9952Set(&g_shadowToolAD9952, (uint8_t)i, i);
+
+        }
+
+        ShadowToolUpdateAD9952(&g_shadowToolAD9952, &g_shadowToolPart9952,
+                               &stats->sent);
+        naive0 = g_shadowToolAD9952.naiveFrames;
+        stats->sent = 0;
+
+        for (i = 0; i < flushes; i++) {
+
+            ShadowToolCalls(workload);
+            stats->bad += ShadowToolUpdateAD9952(&g_shadowToolAD9952,
+                                                 &g_shadowToolPart9952, &stats->sent);
+
+        }
+
+        stats->naive = g_shadowToolAD9952.naiveFrames - naive0;
+
+    }
+
+    else {
+
+        ShadowToolStartAD9834(workload == SHADOW_TOOL_HOP_PINS);
+        naive0 = g_shadowToolAD9834.naiveFrames;
+
+        for (i = 0; i < flushes; i++) {
+
+            ShadowToolCalls(workload);
+            stats->bad += ShadowToolUpdate(&g_shadowToolAD9834, &g_shadowToolPart,
+                                           &stats->sent, false);
+
+        }
+
+        stats->naive = g_shadowToolAD9834.naiveFrames - naive0;
+
+    }
+
+    stats->flushes = flushes;
+    stats->bad += (stats->sent > stats->naive) ? 1 : 0;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int ShadowToolCheck(uint32_t flushes) {
+
+    tAD9834Shadow *shadow = &g_shadowToolAD9834;
+    tShadowToolAD9834 *part = &g_shadowToolPart;
+    tShadowToolStats stats;
+    uint32_t bad = 0;
+    uint32_t sent = 0;
+    uint32_t dropped, split, w;
+    bool pass;
+
+    //
+    // Controls: a flush short of its last frame, then the selected register's
+    // halves written one at a time through HLB
+    //
+    ShadowToolStartAD9834(false);
+    DDSShadowAD9834SetFreq(shadow, 1, 0x0ABCDEF);
+    DDSShadowAD9834SetPhase(shadow, 0, 0x456);
+    dropped = ShadowToolUpdate(shadow, part, &sent, true);
+
+    ShadowToolStartAD9834(false);
+    part->freqChanges = 0;
+    part->phaseChanges = 0;
+    ShadowToolFrame(part, AD9834FrameCtrl(0));
+    ShadowToolFrame(part, AD9834FrameFreqLSB(AD9834_REG_FREQ0, 0x0ABCDEF));
+    ShadowToolFrame(part, AD9834FrameCtrl(AD9834_CTRL_HLB));
+    ShadowToolFrame(part, AD9834FrameFreqMSB(AD9834_REG_FREQ0, 0x0ABCDEF));
+    split = part->freqChanges;
+
+    printf("  control        last frame dropped, %u differences  %s\n", dropped,
+           (dropped != 0) ? "caught" : "FAIL: missed");
+    printf("  control        halves sent apart, %u output changes  %s\n\n", split,
+           (split > 1) ? "caught" : "FAIL: missed");
+
+    bad += ShadowToolMinimal();
+
+    for (w = 0; w < SHADOW_TOOL_WORKLOADS; w++) {
+
+        ShadowToolRun(w, flushes, &stats);
+        printf("  %-13s  %u flushes  %7u frames naive  %7u sent  %5.1f%%  "
+               "%u bad  %s\n", g_shadowToolNames[w], stats.flushes, stats.naive,
+               stats.sent, 100.0 * stats.sent / stats.naive, stats.bad,
+               (stats.bad == 0) ? "ok" : "FAIL");
+        bad += stats.bad;
+
+    }
+
+    pass = (bad == 0) && (dropped != 0) && (split > 1);
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  Host time per flush, model included, against the frames it saved.
+//
+//************************************************************************************
+static int ShadowToolBench(uint32_t flushes) {
+
+    tShadowToolStats stats;
+    struct timespec t0, t1;
+    double ns;
+    uint32_t w;
+
+    for (w = 0; w < SHADOW_TOOL_WORKLOADS; w++) {
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        ShadowToolRun(w, flushes, &stats);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9 +
+              (double)(t1.tv_nsec - t0.tv_nsec)) / flushes;
+
+        printf("  %-13s  %6.2f frames naive  %6.2f sent per flush  %6.1f ns/flush\n",
+               g_shadowToolNames[w], (double)stats.naive / flushes,
+               (double)stats.sent / flushes, ns);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t flushes = 0;
+
+    if (argc >= 3) {
+
+        flushes = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (flushes == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [flushes]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return ShadowToolCheck((flushes != 0) ? flushes : SHADOW_TOOL_FLUSHES);
+
+    }
+
+    return ShadowToolBench((flushes != 0) ? flushes : SHADOW_TOOL_BENCH);
+
+}
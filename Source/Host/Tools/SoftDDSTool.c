@@ -0,0 +1,508 @@
+//************************************************************************************
+//
+// Title:               Software DDS Check and Bench
+// Author:              Jacob Putz
+// Filename:            SoftDDSTool.c
+//
+// Description:     Checks that the host's vector SoftDDSRender() is bit-exact with
+//                      the scalar reference SoftDDSRenderRef() and that both are
+//                      within the model's error of an ideal sine.  The bench
+//                      compares their samples per second.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/softdds_tool.  Which SoftDDSRender() it
+//  measures is whatever Host/SoftDDSHost.c compiles to for the host: SSE2 on
+//  x86-64, the scalar reference elsewhere.
+//
+//  Usage:
+//
+//      softdds_tool check              every case below
+//      softdds_tool bench [samples]    samples per second, vector and scalar
+//
+//  table       the packed table is odd and half-wave symmetric, peaks at
+//              SOFTDDS_PEAK, and each entry's high half is the next entry's low.
+//  exact       random tuning and phase words for both parts' register widths,
+//              plus the slowest, fastest and Nyquist steps, are rendered by both
+//              paths at every length from 0 to 40 and at long lengths, into
+//              buffers at every alignment.  The samples and the accumulator left
+//              behind must be identical, and a render split into random chunks
+//              must equal one render of the whole.
+//  seek        SoftDDSSeek() to sample n gives the samples a render from zero
+//              gives from n on.
+//  sine        samples are within 2 LSB of SOFTDDS_PEAK sin(2 pi phase / 2^32),
+//              the table's interpolation error plus the rounding of the table
+//              and of the sample.
+//
+//  A negative control renders with a step one LSB larger; the comparison must
+//  find the difference.  Exits 1 on any failure.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DDSChip.h"
+#include "DDSTuning.h"
+#include "SoftDDS.h"
+
+// Defines
+#define     SOFTDDS_TOOL_SEED       0x5EED1234
+#define     SOFTDDS_TOOL_CONFIGS    200
+#define     SOFTDDS_TOOL_SHORT      40
+#define     SOFTDDS_TOOL_LONG       4099
+#define     SOFTDDS_TOOL_ERROR_MAX  2
+#define     SOFTDDS_TOOL_BENCH      100000000
+#define     SOFTDDS_TOOL_BLOCK      4096
+
+// Global Variables
+static uint32_t g_softDDSToolRandom = SOFTDDS_TOOL_SEED;
+static tDDSTuning g_softDDSToolTuning[2];
+static int16_t g_softDDSToolRef[SOFTDDS_TOOL_LONG + 8];
+static int16_t g_softDDSToolOut[SOFTDDS_TOOL_LONG + 8];
+
+//************************************************************************************
+//
+// Xorshift32, so every run checks the same configurations.
+//
+//************************************************************************************
+static uint32_t SoftDDSToolRandom(void) {
+
+    uint32_t x = g_softDDSToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_softDDSToolRandom = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// Render count samples both ways from the same state.  The vector output goes
+// skew elements into its buffer so every alignment is exercised.  Returns the
+// number of samples, plus one for the accumulator, that differ.
+//
+//************************************************************************************
+static uint32_t SoftDDSToolCompare(const tSoftDDS *dds, uint32_t count,
+                                   uint32_t skew) {
+
+    tSoftDDS ref = *dds;
+    tSoftDDS vec = *dds;
+    int16_t *out = &g_softDDSToolOut[skew];
+    uint32_t bad = 0;
+    uint32_t i;
+
+    SoftDDSRenderRef(&ref, g_softDDSToolRef, count);
+    SoftDDSRender(&vec, out, count);
+
+    for (i = 0; i < count; i++) {
+
+        bad += (out[i] != g_softDDSToolRef[i]) ? 1 : 0;
+
+    }
+
+    return bad + ((vec.phase != ref.phase) ? 1 : 0);
+
+}
+
+//************************************************************************************
+//
+// Render count samples in random chunks and compare with a single render.
+//
+//************************************************************************************
+static uint32_t SoftDDSToolChunks(const tSoftDDS *dds, uint32_t count) {
+
+    tSoftDDS ref = *dds;
+    tSoftDDS vec = *dds;
+    uint32_t done = 0;
+    uint32_t bad = 0;
+    uint32_t chunk, i;
+
+    SoftDDSRenderRef(&ref, g_softDDSToolRef, count);
+
+    while (done < count) {
+
+        chunk = SoftDDSToolRandom() % 37;
+        chunk = (chunk > (count - done)) ? (count - done) : chunk;
+        SoftDDSRender(&vec, &g_softDDSToolOut[done], chunk);
+        done += chunk;
+
+    }
+
+    for (i = 0; i < count; i++) {
+
+        bad += (g_softDDSToolOut[i] != g_softDDSToolRef[i]) ? 1 : 0;
+
+    }
+
+    return bad + ((vec.phase != ref.phase) ? 1 : 0);
+
+}
+
+//************************************************************************************
+//
+// table
+//
+//************************************************************************************
+static uint32_t SoftDDSToolTable(void) {
+
+    uint32_t half = SOFTDDS_LUT_SIZE / 2;
+    uint32_t bad = 0;
+    int16_t lo, hi, peak = 0;
+    uint32_t i;
+
+    for (i = 0; i < SOFTDDS_LUT_SIZE; i++) {
+
+        lo = (int16_t)g_softDDSPairs[i];
+        hi = (int16_t)(g_softDDSPairs[i] >> 16);
+        peak = (lo > peak) ? lo : peak;
+
+        bad += (hi != (int16_t)g_softDDSPairs[(i + 1) % SOFTDDS_LUT_SIZE]) ? 1 : 0;
+        bad += (lo != -(int16_t)g_softDDSPairs[(i + half) % SOFTDDS_LUT_SIZE]) ?
+               1 : 0;
+        bad += ((i != 0) && (i < half) &&
+                (lo != (int16_t)g_softDDSPairs[half - i])) ? 1 : 0;
+
+    }
+
+    bad += (peak != SOFTDDS_PEAK) ? 1 : 0;
+    bad += ((int16_t)g_softDDSPairs[0] != 0) ? 1 : 0;
+
+    printf("  table          %u entries  peak %d  %u bad  %s\n", SOFTDDS_LUT_SIZE,
+           peak, bad, (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// Configure dds as part (0 AD9834, 1 AD9952) with config: the first few are the
+// edge steps, the rest random.
+//
+//************************************************************************************
+static void SoftDDSToolConfigure(tSoftDDS *dds, uint32_t part, uint32_t config) {
+
+    const tDDSTuning *tuning = &g_softDDSToolTuning[part];
+    uint32_t freqMask = (tuning->freqBits >= 32) ? 0xFFFFFFFF :
+                                                   ((1UL << tuning->freqBits) - 1);
+    uint32_t phaseMask = (1UL << tuning->phaseBits) - 1;
+    uint32_t freqWord;
+
+    switch (config) {
+
+        case 0:
+            freqWord = 0;
+            break;
+
+        case 1:
+            freqWord = 1;
+            break;
+
+        case 2:
+            freqWord = (freqMask >> 1) + 1;         // Nyquist
+            break;
+
+        case 3:
+            freqWord = freqMask;
+            break;
+
+        default:
+            freqWord = SoftDDSToolRandom() & freqMask;
+            break;
+
+    }
+
+    SoftDDSConfigure(dds, tuning, freqWord, SoftDDSToolRandom() & phaseMask);
+
+}
+
+//************************************************************************************
+//
+// exact
+//
+//************************************************************************************
+static uint32_t SoftDDSToolExact(uint32_t part) {
+
+    tSoftDDS dds;
+    uint32_t bad = 0;
+    uint32_t compared = 0;
+    uint32_t config, count;
+
+    for (config = 0; config < SOFTDDS_TOOL_CONFIGS; config++) {
+
+        SoftDDSToolConfigure(&dds, part, config);
+
+        for (count = 0; count <= SOFTDDS_TOOL_SHORT; count++) {
+
+            bad += SoftDDSToolCompare(&dds, count, count % 8);
+            compared += count;
+
+        }
+
+        bad += SoftDDSToolCompare(&dds, SOFTDDS_TOOL_LONG, config % 8);
+        bad += SoftDDSToolChunks(&dds, SOFTDDS_TOOL_LONG);
+        compared += 2 * SOFTDDS_TOOL_LONG;
+
+    }
+
+    printf("  %s exact   %u configurations  %u samples  %u differ  %s\n",
+           (part == 0) ? "ad9834" : "ad9952", SOFTDDS_TOOL_CONFIGS, compared, bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// seek
+//
+//************************************************************************************
+static uint32_t SoftDDSToolSeek(void) {
+
+    tSoftDDS dds, seek;
+    uint32_t bad = 0;
+    uint32_t config, n, i;
+
+    for (config = 0; config < SOFTDDS_TOOL_CONFIGS; config++) {
+
+        SoftDDSToolConfigure(&dds, config & 1, config);
+        seek = dds;
+        SoftDDSRender(&dds, g_softDDSToolRef, SOFTDDS_TOOL_LONG);
+
+        n = SoftDDSToolRandom() % (SOFTDDS_TOOL_LONG - 64);
+        SoftDDSSeek(&seek, n);
+        SoftDDSRender(&seek, g_softDDSToolOut, 64);
+
+        for (i = 0; i < 64; i++) {
+
+            bad += (g_softDDSToolOut[i] != g_softDDSToolRef[n + i]) ? 1 : 0;
+
+        }
+
+    }
+
+    printf("  seek           %u seeks  %u differ  %s\n", SOFTDDS_TOOL_CONFIGS, bad,
+           (bad == 0) ? "ok" : "FAIL");
+
+    return bad;
+
+}
+
+//************************************************************************************
+//
+// sine
+//
+//************************************************************************************
+static uint32_t SoftDDSToolSine(void) {
+
+    tSoftDDS dds;
+    double want, error;
+    double worst = 0.0;
+    uint32_t config, phase, i;
+    bool pass;
+
+    for (config = 4; config < SOFTDDS_TOOL_CONFIGS; config++) {
+
+        SoftDDSToolConfigure(&dds, config & 1, config);
+        phase = dds.phase;
+        SoftDDSRender(&dds, g_softDDSToolOut, SOFTDDS_TOOL_LONG);
+
+        for (i = 0; i < SOFTDDS_TOOL_LONG; i++) {
+
+            want = SOFTDDS_PEAK * sin((6.283185307179586 * phase) / 4294967296.0);
+            error = fabs(g_softDDSToolOut[i] - want);
+            worst = (error > worst) ? error : worst;
+            phase += dds.step;
+
+        }
+
+    }
+
+    pass = (worst <= SOFTDDS_TOOL_ERROR_MAX);
+    printf("  sine           worst %.3f LSB of a %d peak (limit %d)  %s\n", worst,
+           SOFTDDS_PEAK, SOFTDDS_TOOL_ERROR_MAX, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int SoftDDSToolCheck(void) {
+
+    tSoftDDS dds, off;
+    uint32_t bad = 0;
+    uint32_t differ, i;
+    bool caught, pass;
+
+    SoftDDSToolConfigure(&dds, 1, 4);
+    off = dds;
+    off.step++;
+    SoftDDSRenderRef(&dds, g_softDDSToolRef, SOFTDDS_TOOL_LONG);
+    SoftDDSRender(&off, g_softDDSToolOut, SOFTDDS_TOOL_LONG);
+    differ = 0;
+
+    for (i = 0; i < SOFTDDS_TOOL_LONG; i++) {
+
+        differ += (g_softDDSToolOut[i] != g_softDDSToolRef[i]) ? 1 : 0;
+
+    }
+
+    caught = (differ != 0);
+    printf("  control        step one LSB high, %u of %u samples differ  %s\n\n",
+           differ, SOFTDDS_TOOL_LONG, caught ? "caught" : "FAIL: missed");
+
+    bad += SoftDDSToolTable();
+    bad += SoftDDSToolExact(0);
+    bad += SoftDDSToolExact(1);
+    bad += SoftDDSToolSeek();
+    bad += SoftDDSToolSine();
+
+    pass = (bad == 0) && caught;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static double SoftDDSToolTime(void (*render)(tSoftDDS *, int16_t *, uint32_t),
+                              uint32_t block, uint32_t samples) {
+
+    static int16_t out[SOFTDDS_TOOL_BLOCK];
+    struct timespec t0, t1;
+    tSoftDDS dds;
+    uint32_t done;
+
+    SoftDDSConfigure(&dds, &g_softDDSToolTuning[1], 0x12345677, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (done = 0; done < samples; done += block) {
+
+        render(&dds, out, block);
+
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    //
+    // Keep the renders from being optimized away
+    //
+    if (out[block - 1] == 0x7FFF) {
+
+        printf(" ");
+
+    }
+
+    return done / ((double)(t1.tv_sec - t0.tv_sec) +
+                   (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9);
+
+}
+
+static int SoftDDSToolBench(uint32_t samples) {
+
+    static const uint32_t blocks[] = { 16, 256, SOFTDDS_TOOL_BLOCK };
+    double ref, vec;
+    uint32_t i;
+
+#if defined(__SSE2__)
+    printf("  SoftDDSRender() is the SSE2 path\n");
+#else
+    printf("  SoftDDSRender() is the scalar reference on this host\n");
+#endif
+
+    for (i = 0; i < 3; i++) {
+
+        ref = SoftDDSToolTime(SoftDDSRenderRef, blocks[i], samples);
+        vec = SoftDDSToolTime(SoftDDSRender, blocks[i], samples);
+
+        printf("  %4u-sample blocks  scalar %7.1f Msamples/s  "
+               "vector %7.1f Msamples/s  %.2fx\n", blocks[i], ref * 1e-6, vec * 1e-6,
+               vec / ref);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t samples = 0;
+
+    if (argc >= 3) {
+
+        samples = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (samples == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [samples]\n", argv[0]);
+        return 2;
+
+    }
+
+    SoftDDSInit();
+    DDSTuningInit(&g_softDDSToolTuning[0], AD9834_MCLK_HZ, AD9834_FREQ_BITS,
+                  AD9834_PHASE_BITS);
+    DDSTuningInit(&g_softDDSToolTuning[1], AD9952_SYSCLK_HZ, AD9952_FREQ_BITS,
+                  AD9952_PHASE_BITS);
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return SoftDDSToolCheck();
+
+    }
+
+    return SoftDDSToolBench((samples != 0) ? samples : SOFTDDS_TOOL_BENCH);
+
+}
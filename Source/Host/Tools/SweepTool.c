@@ -0,0 +1,554 @@
+//************************************************************************************
+//
+// Title:               Sweep Check and Bench
+// Author:              Jacob Putz
+// Filename:            SweepTool.c
+//
+// Description:     Checks the sweep generator's words against a double precision
+//                      reference for both shapes and parts, the configuration
+//                      limits, and a sweep played on the simulated HAL with its
+//                      tables refilled by the scheduler.  The bench reports table
+//                      generation throughput and the step rate the SSI sustains
+//                      for each shape.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Play the sweep with a phase set, which every step must carry.
+//
+// 0.1.1    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/sweep_tool.
+//
+//  Usage:
+//
+//      sweep_tool check                every case below, on each built part
+//      sweep_tool bench [steps]        generation cost and step rate per shape
+//
+//  words       linear and logarithmic sweeps up and down, narrow and across most
+//              of the part's range (on the AD9952 a span of more than 2^31 words),
+//              generated for two passes.  Step i must be within one LSB of
+//              start + (stop - start) i / (steps - 1), or start (stop / start)
+//              ^ (i / (steps - 1)), worked in double precision; the end points
+//              must be exact, the second pass of a repeating sweep the same as
+//              the first, and a one-shot sweep must hold its stop word.
+//  limits      a single step, a step shorter than the SSI can send a record in,
+//              one longer than the timer counts, a log sweep from zero and a log
+//              ratio of four per step are refused; the shortest step is taken.
+//  play        a repeating linear sweep runs from SweepStart() for many blocks,
+//              the scheduler refilling its tables as the main loop would.  Step k
+//              must put the records of the generator's k-th word on the part's SSI
+//              at first + k * step cycles, with no underrun.  The sweep starts
+//              with SWEEP_TOOL_PHASE in the AD9952's POW0, and every record must
+//              carry it rather than return the phase to zero.
+//
+//  A negative control compares a sweep's words with the reference for one more
+//  step than it was built with; the error must show.  Exits 1 on any failure.
+//
+//  bench times SweepFillBlock() (generate and pack one table block) per step for
+//  each shape and part, and sets it against the fastest step the SSI can send at
+//  the firmware's bit rate: the share of the host one core would spend keeping
+//  the tables full at that rate.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Boot.h"
+#include "BootHost.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Power.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Defines
+#define     SWEEP_TOOL_STEPS_MAX    100000
+#define     SWEEP_TOOL_PLAY_BLOCKS  40
+#define     SWEEP_TOOL_PHASE        0x1234
+#define     SWEEP_TOOL_BENCH        10000000
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint32_t instance;
+    uint32_t shape;
+    uint64_t startQ32;
+    uint64_t stopQ32;
+    uint32_t steps;
+
+} tSweepToolCase;
+
+// Global Constants
+static const tSweepToolCase g_sweepToolCases[] = {
+
+    { "ad9834 linear up",   SSISTREAM_AD9834,   SWEEP_SHAPE_LINEAR,
+      DDS_HZ(1000),         DDS_HZ(10000000),   1000 },
+    { "ad9834 linear down", SSISTREAM_AD9834,   SWEEP_SHAPE_LINEAR,
+      DDS_HZ_FRAC(30000000, 0x80000000),        DDS_HZ(1000),       4096 },
+    { "ad9834 linear fine", SSISTREAM_AD9834,   SWEEP_SHAPE_LINEAR,
+      DDS_HZ(1000000),      DDS_HZ(1000010),    65536 },
+    { "ad9834 log up",      SSISTREAM_AD9834,   SWEEP_SHAPE_LOG,
+      DDS_HZ(100),          DDS_HZ(30000000),   2000 },
+    { "ad9952 linear wide", SSISTREAM_AD9952,   SWEEP_SHAPE_LINEAR,
+      DDS_HZ(1000000),      DDS_HZ(390000000),  SWEEP_TOOL_STEPS_MAX },
+    { "ad9952 linear down", SSISTREAM_AD9952,   SWEEP_SHAPE_LINEAR,
+      DDS_HZ(390000000),    DDS_HZ(1000000),    777 },
+    { "ad9952 log down",    SSISTREAM_AD9952,   SWEEP_SHAPE_LOG,
+      DDS_HZ(300000000),    DDS_HZ(10000),      5000 },
+    { "ad9952 log wide",    SSISTREAM_AD9952,   SWEEP_SHAPE_LOG,
+      DDS_HZ(1),            DDS_HZ(399000000),  SWEEP_TOOL_STEPS_MAX },
+
+};
+
+#define     SWEEP_TOOL_CASES        (sizeof(g_sweepToolCases) / \
+                                     sizeof(g_sweepToolCases[0]))
+
+static const char *const g_sweepToolShapes[] = { "linear", "log" };
+
+// Global Variables
+static tDDSTuning g_sweepToolTuning[SSISTREAM_COUNT];
+static tSweep g_sweepToolRef;       // Generates what the played sweep should send
+static uint32_t g_sweepToolWords[2 * SWEEP_TOOL_STEPS_MAX];
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c), and a tuning context per part.
+//
+//************************************************************************************
+static void SweepToolBoot(void) {
+
+    uint32_t i;
+
+    BootHostRun(false);
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i)) {
+
+            DDSChipTuningInit(i, &g_sweepToolTuning[i]);
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Largest distance, in LSBs, between the first steps words and the reference for
+// a sweep of steps points from startWord to stopWord.
+//
+//************************************************************************************
+static double SweepToolError(uint32_t shape, uint32_t startWord, uint32_t stopWord,
+                             uint32_t steps, const uint32_t *words) {
+
+    double start = (double)startWord;
+    double stop = (double)stopWord;
+    double worst = 0.0;
+    double want, error;
+    uint32_t i;
+
+    for (i = 0; i < steps; i++) {
+
+        if (shape == SWEEP_SHAPE_LOG) {
+
+            want = start * pow(stop / start, (double)i / (double)(steps - 1));
+
+        }
+
+        else {
+
+            want = start + ((stop - start) * (double)i) / (double)(steps - 1);
+
+        }
+
+        error = fabs((double)words[i] - want);
+        worst = (error > worst) ? error : worst;
+
+    }
+
+    return worst;
+
+}
+
+//************************************************************************************
+//
+// words
+//
+//************************************************************************************
+static uint32_t SweepToolWords(const tSweepToolCase *tc) {
+
+    tSweep *sweep = &g_sweepToolRef;
+    uint32_t held[4];
+    double worst;
+    bool ends, again, hold, pass;
+    uint32_t i;
+
+    if (!SweepConfigure(sweep, tc->instance, &g_sweepToolTuning[tc->instance],
+                        tc->shape, tc->startQ32, tc->stopQ32, tc->steps,
+                        SWEEP_STEP_CYCLES_MAX, true)) {
+
+        printf("  %-20s FAIL: refused\n", tc->name);
+        return 1;
+
+    }
+
+    SweepGenerateWords(sweep, g_sweepToolWords, 2 * tc->steps);
+    worst = SweepToolError(tc->shape, sweep->startWord, sweep->stopWord, tc->steps,
+                           g_sweepToolWords);
+    ends = (g_sweepToolWords[0] == sweep->startWord) &&
+           (g_sweepToolWords[tc->steps - 1] == sweep->stopWord);
+    again = (memcmp(g_sweepToolWords, &g_sweepToolWords[tc->steps],
+                    tc->steps * sizeof(uint32_t)) == 0);
+
+    sweep->repeat = false;
+    SweepRewind(sweep);
+    SweepGenerateWords(sweep, g_sweepToolWords, tc->steps);
+    SweepGenerateWords(sweep, held, 4);
+    hold = true;
+
+    for (i = 0; i < 4; i++) {
+
+        hold = hold && (held[i] == sweep->stopWord);
+
+    }
+
+    pass = (worst <= 1.0) && ends && again && hold;
+
+    printf("  %-20s %6u steps  %08X to %08X  worst %.3f LSB  ends %s  repeat %s  "
+           "hold %s  %s\n", tc->name, tc->steps, sweep->startWord, sweep->stopWord,
+           worst, ends ? "ok" : "FAIL", again ? "ok" : "FAIL", hold ? "ok" : "FAIL",
+           pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// limits
+//
+//************************************************************************************
+static uint32_t SweepToolLimits(uint32_t instance) {
+
+    const tDDSTuning *tuning = &g_sweepToolTuning[instance];
+    tSweep *sweep = &g_sweepToolRef;
+    uint32_t min = SweepMinStepCycles(instance);
+    uint32_t wrong = 0;
+
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LINEAR, DDS_HZ(1000),
+                            DDS_HZ(2000), 1, min, false) ? 1 : 0;
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LINEAR, DDS_HZ(1000),
+                            DDS_HZ(2000), 10, min - 1, false) ? 1 : 0;
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LINEAR, DDS_HZ(1000),
+                            DDS_HZ(2000), 10, SWEEP_STEP_CYCLES_MAX + 1,
+                            false) ? 1 : 0;
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LOG, 0, DDS_HZ(2000),
+                            10, min, false) ? 1 : 0;
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LOG, DDS_HZ(1000),
+                            DDS_HZ(4000), 2, min, false) ? 1 : 0;
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LINEAR, DDS_HZ(1000),
+                            DDS_HZ(2000), 2, min, false) ? 0 : 1;
+    wrong += SweepConfigure(sweep, instance, tuning, SWEEP_SHAPE_LINEAR, DDS_HZ(1000),
+                            DDS_HZ(2000), 2, SWEEP_STEP_CYCLES_MAX, false) ? 0 : 1;
+
+    printf("  %-20s shortest step %u cycles  %u of 7 wrong  %s\n",
+           (instance == SSISTREAM_AD9834) ? "ad9834 limits" : "ad9952 limits", min,
+           wrong, (wrong == 0) ? "ok" : "FAIL");
+
+    return wrong;
+
+}
+
+//************************************************************************************
+//
+// play
+//
+//************************************************************************************
+static uint32_t SweepToolPlay(uint32_t instance) {
+
+    uint32_t ssi = (instance == SSISTREAM_AD9834) ? HAL_SSI_0 : HAL_SSI_3;
+    uint32_t elems = DDSChipStepElems(instance);
+    uint32_t stepCycles = 2 * SweepMinStepCycles(instance);
+    uint32_t total = SWEEP_TOOL_PLAY_BLOCKS * SWEEP_BLOCK_STEPS;
+    const char *name = (instance == SSISTREAM_AD9834) ? "ad9834 play" : "ad9952 play";
+    uint16_t want[SWEEP_ELEMS_MAX];
+    uint32_t word = 0;
+    uint32_t bad = 0;
+    uint32_t step = 0;
+    uint32_t elem = 0;
+    uint64_t first = 0;
+    uint64_t at = 0;
+    tHalHostFrame frame;
+    bool pass;
+
+    while (HalHostSsiRead(ssi, &frame)) {
+
+        // Discard anything from before the start.
+
+    }
+
+    DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_POW0, SWEEP_TOOL_PHASE);
+
+    if (!SweepConfigure(&g_sweep, instance, &g_sweepToolTuning[instance],
+                        SWEEP_SHAPE_LINEAR, DDS_HZ(1000000), DDS_HZ(2000000), 1000,
+                        stepCycles, true) ||
+        !SweepConfigure(&g_sweepToolRef, instance, &g_sweepToolTuning[instance],
+                        SWEEP_SHAPE_LINEAR, DDS_HZ(1000000), DDS_HZ(2000000), 1000,
+                        stepCycles, true) ||
+        !SweepStart(&g_sweep)) {
+
+        printf("  %-20s FAIL: refused\n", name);
+        return 1;
+
+    }
+
+    while (step < total) {
+
+        //
+        // The main loop: time passes a few steps at a time and the scheduler runs
+        // whatever is due
+        //
+        HalHostAdvance(8 * stepCycles);
+        SchedulerPoll();
+
+        while ((step < total) && HalHostSsiRead(ssi, &frame)) {
+
+            if (elem == 0) {
+
+                SweepGenerateWords(&g_sweepToolRef, &word, 1);
+                SweepPackRecords(instance, &word, want, 1, SWEEP_TOOL_PHASE);
+                at = frame.cycle;
+                first = (step == 0) ? at : first;
+
+            }
+
+            if ((frame.frame != want[elem]) || (frame.cycle != at) ||
+                (at != first + (uint64_t)step * stepCycles)) {
+
+                if (bad++ == 0) {
+
+                    printf("  %-20s FAIL: step %u frame %u is %04X at cycle %llu, "
+                           "expected %04X at %llu\n", name, step, elem, frame.frame,
+                           (unsigned long long)(frame.cycle - first), want[elem],
+                           (unsigned long long)((uint64_t)step * stepCycles));
+
+                }
+
+            }
+
+            if (++elem == elems) {
+
+                elem = 0;
+                step++;
+
+            }
+
+        }
+
+    }
+
+    SweepStop(&g_sweep);
+    DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_POW0, 0);
+    pass = (bad == 0) && (g_sweep.underruns == 0);
+
+    printf("  %-20s %u steps of %u cycles, %u blocks refilled  %u bad  %u underruns  "
+           "%s\n", name, step, stepCycles, g_sweep.blocksGenerated, bad,
+           g_sweep.underruns, pass ? "ok" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int SweepToolCheck(void) {
+
+    const tSweepToolCase *tc = 0;
+    uint32_t bad = 0;
+    uint32_t i;
+    double worst;
+    bool caught, pass;
+
+    SweepToolBoot();
+
+    for (i = 0; (i < SWEEP_TOOL_CASES) && (tc == 0); i++) {
+
+        tc = DDSChipBuilt(g_sweepToolCases[i].instance) ? &g_sweepToolCases[i] : 0;
+
+    }
+
+    SweepConfigure(&g_sweepToolRef, tc->instance, &g_sweepToolTuning[tc->instance],
+                   tc->shape, tc->startQ32, tc->stopQ32, tc->steps,
+                   SWEEP_STEP_CYCLES_MAX, false);
+    SweepGenerateWords(&g_sweepToolRef, g_sweepToolWords, tc->steps);
+    worst = SweepToolError(tc->shape, g_sweepToolRef.startWord,
+                           g_sweepToolRef.stopWord, tc->steps + 1, g_sweepToolWords);
+    caught = (worst > 1.0);
+    printf("  control              one step short, worst %.1f LSB  %s\n\n", worst,
+           caught ? "caught" : "FAIL: missed");
+
+    for (i = 0; i < SWEEP_TOOL_CASES; i++) {
+
+        if (DDSChipBuilt(g_sweepToolCases[i].instance)) {
+
+            bad += SweepToolWords(&g_sweepToolCases[i]);
+
+        }
+
+    }
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i)) {
+
+            bad += SweepToolLimits(i);
+            bad += SweepToolPlay(i);
+
+        }
+
+    }
+
+    pass = (bad == 0) && caught;
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench
+//
+//************************************************************************************
+static double SweepToolElapsed(const struct timespec *t0, const struct timespec *t1) {
+
+    return ((double)(t1->tv_sec - t0->tv_sec) * 1e9) +
+           (double)(t1->tv_nsec - t0->tv_nsec);
+
+}
+
+static int SweepToolBench(uint32_t steps) {
+
+    static uint16_t record[SWEEP_BLOCK_STEPS * SWEEP_ELEMS_MAX];
+    struct timespec t0, t1;
+    tSweep *sweep = &g_sweepToolRef;
+    uint32_t instance, shape, rate, done;
+    double ns;
+
+    SweepToolBoot();
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        if (!DDSChipBuilt(instance)) {
+
+            continue;
+
+        }
+
+        rate = SweepMaxStepRate(instance, BOOT_SSI_BIT_RATE);
+
+        for (shape = SWEEP_SHAPE_LINEAR; shape <= SWEEP_SHAPE_LOG; shape++) {
+
+            SweepConfigure(sweep, instance, &g_sweepToolTuning[instance], shape,
+                           DDS_HZ(1000), DDS_HZ(10000000), 100000,
+                           SWEEP_STEP_CYCLES_MAX, true);
+
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+
+            for (done = 0; done < steps; done += SWEEP_BLOCK_STEPS) {
+
+                SweepFillBlock(sweep, record);
+
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            ns = SweepToolElapsed(&t0, &t1) / done;
+
+            printf("  %s %-6s  generate %5.2f ns/step (%6.1f Msteps/s)  SSI limit %u "
+                   "steps/s at %u MHz  refill %.2f%% of a core\n",
+                   (instance == SSISTREAM_AD9834) ? "ad9834" : "ad9952",
+                   g_sweepToolShapes[shape], ns, 1e3 / ns, rate,
+                   BOOT_SSI_BIT_RATE / 1000000, (ns * rate) / 1e7);
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t steps = 0;
+
+    if (argc >= 3) {
+
+        steps = strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (steps == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [steps]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return SweepToolCheck();
+
+    }
+
+    return SweepToolBench((steps != 0) ? steps : SWEEP_TOOL_BENCH);
+
+}
@@ -0,0 +1,1008 @@
+//************************************************************************************
+//
+// Title:               Multi-Channel Synchronized Update - Check and Benchmark Tool
+// Author:              Jacob Putz
+// Filename:            SyncTool.c
+//
+// Description:     Host command line tool that runs the synchronized update manager
+//                      on the simulated HAL against register models of every part on
+//                      the buses, checks that each commit changes all the outputs on
+//                      the same edge and nothing before it, and measures how the
+//                      update rate falls with the number of channels.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Start up through the shared host fixture (BootHost.c); take the
+//                  clock and rates from Boot.h.
+//
+// 0.1.3    -       Check only the layouts whose parts are built; AD9834-only
+//                  layout and an AD9952 negative control; common PASS/FAIL lines.
+//
+// 0.1.2    -       Check that lines owned elsewhere are refused; AD9834 selects
+//                  move to port D, off the SSI3 pins.
+//
+// 0.1.1    -       Built by Host/Makefile.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/sync_tool.
+//
+//  Usage:
+//
+//      sync_tool check [commits]       atomicity check over several board layouts
+//      sync_tool bench [commits]       update rate against channel count
+//
+//  Each part is modelled from its datasheet: the AD9952 collects writes in its
+//  I/O buffer and copies them to the active registers on the rising edge of
+//  IO_UPDATE; the AD9834's registers take effect at once and FSELECT/PSELECT
+//  pick the bank on the output.  A part only sees frames while its select line
+//  is low.  The model watches every GPIO write (HalHostGpioWatch()); the frames
+//  captured since the previous write are delivered first, under the selects that
+//  were in force when they were sent, then the edge is applied.  Each output
+//  change is stamped with the write it happened at and whether it came from the
+//  frames or the edge.
+//
+//  check passes if, in every commit, every part that was given a new state shows
+//  it afterwards, every part that was not keeps its output, and every change
+//  happened on the edge of the same latch port write.  Before the layouts it runs
+//  a negative control -- the first part's output frequency changed during staging,
+//  on the output bank for an AD9834 or latched early for an AD9952 -- which the
+//  check must catch, and offers SyncAdd() lines other subsystems own (the link's
+//  UART, the SSI pins, the sweep's IO_UPDATE, FSELECT as an AD9952 line), each of
+//  which must be refused.  Layouts using a part DDS_CHIP leaves out are skipped.
+//  Exits 1 on any failure.
+//
+//  bench stages a new frequency and phase on every channel for each commit.  The
+//  simulated SSI sends frames instantly, so bus time is modelled: each frame costs
+//  its bits plus one clock of gap at the SSI bit rate, a round of staging lasts as
+//  long as the slower bus, and a shared bus takes one round per part.  The spread
+//  is the modelled time between the first and the last part's registers being
+//  loaded, which is how far apart the outputs would change if each part were
+//  written and latched on its own.  Host time per commit is the firmware's own
+//  work on this machine, for comparison between layouts only.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Boot.h"
+#include "BootHost.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "HalHost.h"
+#include "Mem.h"
+#include "Power.h"
+#include "Record.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sync.h"
+#include "TimeBase.h"
+
+// Defines
+#define     SYNC_TOOL_COMMITS       2000
+#define     SYNC_TOOL_SEED          0x5EED1234
+
+// Board lines.  The first AD9834's FSELECT/PSELECT are PK0/PK1 and every other
+// AD9834 shares them; IO_UPDATE is fanned out from PK2 (or PM2 in the split
+// layout).  Selects are PP0..PP7 on SSI3 and PD0..PD7 on SSI0.
+#define     SYNC_TOOL_FSELECT       (HAL_PIN_0 | HAL_PIN_1)
+#define     SYNC_TOOL_IOUPDATE      HAL_PIN_2
+
+// Output change stamps: GPIO write number times two, plus one for the edge
+#define     SYNC_TOOL_NONE          0xFFFFFFFF
+
+// Type Definitions
+typedef struct {
+
+    uint32_t instance;
+    uint32_t selectPort;
+    uint8_t selectPins;
+    uint32_t latchPort;
+    uint8_t latchPins;
+
+} tSyncToolWiring;
+
+typedef struct {
+
+    const char *name;
+    uint32_t count;
+    tSyncToolWiring wiring[SYNC_CHANNELS_MAX];
+
+} tSyncToolLayout;
+
+typedef struct {
+
+    //
+    // AD9834
+    //
+    uint16_t ctrl;
+    uint32_t freq[2];
+    uint16_t phase[2];
+    uint16_t lsb;
+    bool msbNext;
+
+    //
+    // AD9952
+    //
+    uint32_t buffer[DDSSHADOW_AD9952_REGS];
+    uint32_t active[DDSSHADOW_AD9952_REGS];
+    uint8_t addr;
+    uint32_t remain;
+    uint32_t value;
+
+    //
+    // Output and what changed it
+    //
+    uint32_t outFreq;
+    uint32_t outPhase;
+    uint32_t changes;               // Output changes since the commit began
+    uint32_t firstStamp;
+    uint32_t lastStamp;
+    uint32_t frames;                // Frames received since the commit began
+
+} tSyncToolPart;
+
+// Global Variables
+static const tSyncToolLayout *g_syncToolLayout;
+static tSyncToolPart g_syncToolParts[SYNC_CHANNELS_MAX];
+static uint8_t g_syncToolGpio[HAL_PORT_COUNT];  // Lines as the parts last saw them
+static uint32_t g_syncToolWrites;               // GPIO writes seen
+static uint32_t g_syncToolRandom = SYNC_TOOL_SEED;
+
+//************************************************************************************
+//
+// Xorshift32, so runs repeat.
+//
+//************************************************************************************
+static uint32_t SyncToolRandom(void) {
+
+    uint32_t x = g_syncToolRandom;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_syncToolRandom = x;
+
+    return x;
+
+}
+
+//************************************************************************************
+//
+// Decode one frame as the part would.
+//
+//************************************************************************************
+static void SyncToolFrame(tSyncToolPart *part, uint32_t instance, uint16_t frame) {
+
+    uint32_t index, data;
+
+    part->frames++;
+
+    if (instance == SSISTREAM_AD9952) {
+
+        if (part->remain == 0) {
+
+            part->addr = (uint8_t)(frame & AD9952_INSTR_ADDR_MASK);
+            part->remain = ((frame & AD9952_INSTR_READ) != 0) ? 0 :
+                           AD9952RegBytes(part->addr);
+            part->value = 0;
+
+        }
+
+        else {
+
+            part->value = (part->value << 8) | (frame & 0xFF);
+
+            if (--part->remain == 0) {
+
+                part->buffer[part->addr] = part->value;
+
+            }
+
+        }
+
+        return;
+
+    }
+
+    switch (frame & 0xC000) {
+
+        case AD9834_REG_CTRL:
+
+            part->ctrl = frame;
+            break;
+
+        case AD9834_REG_FREQ0:
+        case AD9834_REG_FREQ1:
+
+            index = ((frame & 0xC000) == AD9834_REG_FREQ1) ? 1 : 0;
+            data = frame & AD9834_FREQ_HALF_MASK;
+
+            if ((part->ctrl & AD9834_CTRL_B28) != 0) {
+
+                if (part->msbNext) {
+
+                    part->freq[index] = part->lsb | (data << 14);
+
+                }
+
+                else {
+
+                    part->lsb = (uint16_t)data;
+
+                }
+
+                part->msbNext = !part->msbNext;
+
+            }
+
+            else if ((part->ctrl & AD9834_CTRL_HLB) != 0) {
+
+                part->freq[index] = (part->freq[index] & AD9834_FREQ_HALF_MASK) |
+                                    (data << 14);
+
+            }
+
+            else {
+
+                part->freq[index] = (part->freq[index] & ~AD9834_FREQ_HALF_MASK) | data;
+
+            }
+
+            break;
+
+        default:
+
+            part->phase[((frame & 0xE000) == AD9834_REG_PHASE1) ? 1 : 0] =
+                frame & AD9834_PHASE_MASK;
+            break;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Recompute a part's output from its registers and lines, and stamp a change.
+//
+//************************************************************************************
+static void SyncToolOutput(uint32_t channel, uint32_t stamp) {
+
+    const tSyncToolWiring *wiring = &g_syncToolLayout->wiring[channel];
+    tSyncToolPart *part = &g_syncToolParts[channel];
+    uint8_t lines = g_syncToolGpio[wiring->latchPort] & wiring->latchPins;
+    uint8_t fselect = wiring->latchPins & (uint8_t)-wiring->latchPins;
+    uint8_t pselect = HAL_PIN_7;
+    uint32_t freq, phase, fsel, psel;
+
+    while ((pselect & wiring->latchPins) == 0) {
+
+        pselect >>= 1;
+
+    }
+
+    if (wiring->instance == SSISTREAM_AD9952) {
+
+        freq = part->active[AD9952_REG_FTW0];
+        phase = part->active[AD9952_REG_POW0];
+
+    }
+
+    else {
+
+        //
+        // FSELECT is the lowest latch line and PSELECT the highest; a single
+        // line drives both.
+        //
+        if ((part->ctrl & AD9834_CTRL_PIN_SW) != 0) {
+
+            fsel = ((lines & fselect) != 0) ? 1 : 0;
+            psel = ((lines & pselect) != 0) ? 1 : 0;
+
+        }
+
+        else {
+
+            fsel = ((part->ctrl & AD9834_CTRL_FSEL) != 0) ? 1 : 0;
+            psel = ((part->ctrl & AD9834_CTRL_PSEL) != 0) ? 1 : 0;
+
+        }
+
+        freq = part->freq[fsel];
+        phase = part->phase[psel];
+
+    }
+
+    if ((freq != part->outFreq) || (phase != part->outPhase)) {
+
+        part->outFreq = freq;
+        part->outPhase = phase;
+
+        if (part->changes++ == 0) {
+
+            part->firstStamp = stamp;
+
+        }
+
+        part->lastStamp = stamp;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Deliver the frames captured so far to the parts selected on their bus.
+//
+//************************************************************************************
+static void SyncToolDrain(uint32_t stamp) {
+
+    static const uint32_t ssi[SSISTREAM_COUNT] = { HAL_SSI_0, HAL_SSI_3 };
+    const tSyncToolWiring *wiring;
+    tHalHostFrame frame;
+    uint32_t bus, i;
+
+    for (bus = 0; bus < SSISTREAM_COUNT; bus++) {
+
+        while (HalHostSsiRead(ssi[bus], &frame)) {
+
+            for (i = 0; i < g_syncToolLayout->count; i++) {
+
+                wiring = &g_syncToolLayout->wiring[i];
+
+                if ((wiring->instance == bus) &&
+                    ((wiring->selectPins == 0) ||
+                     ((g_syncToolGpio[wiring->selectPort] & wiring->selectPins) == 0))) {
+
+                    SyncToolFrame(&g_syncToolParts[i], bus, frame.frame);
+
+                }
+
+            }
+
+        }
+
+    }
+
+    for (i = 0; i < g_syncToolLayout->count; i++) {
+
+        SyncToolOutput(i, stamp);
+
+    }
+
+}
+
+static void SyncToolGpioWatch(uint32_t port, uint8_t before, uint8_t after) {
+
+    const tSyncToolWiring *wiring;
+    tSyncToolPart *part;
+    uint32_t stamp = 2 * g_syncToolWrites++;
+    uint32_t i;
+
+    (void)before;
+
+    SyncToolDrain(stamp);
+
+    for (i = 0; i < g_syncToolLayout->count; i++) {
+
+        wiring = &g_syncToolLayout->wiring[i];
+        part = &g_syncToolParts[i];
+
+        if ((wiring->instance == SSISTREAM_AD9952) && (wiring->latchPort == port) &&
+            ((g_syncToolGpio[port] & wiring->latchPins) == 0) &&
+            ((after & wiring->latchPins) != 0)) {
+
+            memcpy(part->active, part->buffer, sizeof(part->active));
+
+        }
+
+    }
+
+    g_syncToolGpio[port] = after;
+
+    for (i = 0; i < g_syncToolLayout->count; i++) {
+
+        SyncToolOutput(i, stamp + 1);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The firmware start-up (BootHost.c).
+//
+//************************************************************************************
+static void SyncToolBoot(void) {
+
+    BootHostRun(false);
+
+}
+
+//************************************************************************************
+//
+// Fresh parts and shadows, all lines low, and the layout's channels added.
+//
+//************************************************************************************
+static bool SyncToolSetup(const tSyncToolLayout *layout) {
+
+    const tSyncToolWiring *wiring;
+    tHalHostFrame frame;
+    uint32_t port, i;
+
+    HalHostGpioWatch(0);
+
+    for (port = 0; port < HAL_PORT_COUNT; port++) {
+
+        HalGpioWrite(port, 0xFF, 0);
+
+    }
+
+    while (HalHostSsiRead(HAL_SSI_0, &frame) || HalHostSsiRead(HAL_SSI_3, &frame)) {
+
+        // Drop what earlier layouts left.
+
+    }
+
+    memset(g_syncToolParts, 0, sizeof(g_syncToolParts));
+    memset(g_syncToolGpio, 0, sizeof(g_syncToolGpio));
+    g_syncToolLayout = layout;
+    g_syncToolWrites = 0;
+
+    DDSShadowAD9834Init(&g_ad9834Shadow);
+    DDSShadowAD9952Init(&g_ad9952Shadow);
+    SyncInit(&g_sync);
+    HalHostGpioWatch(SyncToolGpioWatch);
+
+    for (i = 0; i < layout->count; i++) {
+
+        wiring = &layout->wiring[i];
+
+        if (!SyncAdd(&g_sync, wiring->instance, wiring->selectPort, wiring->selectPins,
+                     wiring->latchPort, wiring->latchPins)) {
+
+            printf("  %-26s FAIL: channel %u rejected\n", layout->name, i);
+            return false;
+
+        }
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// A random frequency the part can make, and a random phase.
+//
+//************************************************************************************
+static void SyncToolPick(uint32_t instance, uint64_t *freqQ32, uint32_t *centiDeg) {
+
+    uint32_t maxHz = (instance == SSISTREAM_AD9834) ? 30000000 : 160000000;
+
+    *freqQ32 = DDS_HZ_FRAC(1000 + (SyncToolRandom() % maxHz), SyncToolRandom());
+    *centiDeg = SyncToolRandom() % 36000;
+
+}
+
+//************************************************************************************
+//
+// One commit with a new state for each channel in mask.  Returns the number of
+// channels that broke atomicity.  When corrupt is set, the first channel's output
+// frequency is rewritten during staging, which the check must catch.
+//
+//************************************************************************************
+static uint32_t SyncToolCommit(uint32_t mask, bool corrupt) {
+
+    const tSyncChannel *channel;
+    tSyncToolPart *part;
+    uint32_t expectFreq[SYNC_CHANNELS_MAX];
+    uint32_t expectPhase[SYNC_CHANNELS_MAX];
+    uint32_t edge = SYNC_TOOL_NONE;
+    uint32_t failures = 0;
+    uint32_t active, i;
+    uint64_t freqQ32;
+    uint32_t centiDeg;
+
+    for (i = 0; i < g_sync.count; i++) {
+
+        part = &g_syncToolParts[i];
+        part->changes = 0;
+        part->frames = 0;
+        expectFreq[i] = part->outFreq;
+        expectPhase[i] = part->outPhase;
+
+        if ((mask & (1UL << i)) != 0) {
+
+            SyncToolPick(g_sync.channels[i].instance, &freqQ32, &centiDeg);
+            SyncSet(&g_sync, i, freqQ32, centiDeg);
+            expectFreq[i] = g_sync.channels[i].freqWord;
+            expectPhase[i] = g_sync.channels[i].phaseWord;
+
+        }
+
+    }
+
+    if (corrupt && (g_sync.channels[0].instance == SSISTREAM_AD9834)) {
+
+        channel = &g_sync.channels[0];
+        active = ((channel->ad9834->pins & AD9834_CTRL_FSEL) != 0) ? 1 : 0;
+        DDSShadowAD9834SetFreq(channel->ad9834, active,
+                               channel->ad9834->freq[active] ^ 0x1);
+        DDSShadowAD9834Queue(channel->ad9834, &g_ssiStreams[SSISTREAM_AD9834]);
+        HalGpioWrite(HAL_PORT_A, HAL_PIN_7, HAL_PIN_7);     // Lets the model see it
+        HalGpioWrite(HAL_PORT_A, HAL_PIN_7, 0);
+
+    }
+
+    else if (corrupt) {
+
+        //
+        // An AD9952 only shows a write on IO_UPDATE, so latch it early.
+        //
+        channel = &g_sync.channels[0];
+        DDSShadowAD9952Set(channel->ad9952, AD9952_REG_FTW0,
+                           channel->ad9952->devReg[AD9952_REG_FTW0] ^ 0x1);
+        DDSShadowAD9952Queue(channel->ad9952, &g_ssiStreams[SSISTREAM_AD9952]);
+        HalGpioWrite(channel->latchPort, channel->latchPins, channel->latchPins);
+        HalGpioWrite(channel->latchPort, channel->latchPins, 0);
+
+    }
+
+    if (!SyncCommit(&g_sync)) {
+
+        printf("  commit refused\n");
+        return g_sync.count;
+
+    }
+
+    SyncToolDrain(2 * g_syncToolWrites);
+
+    for (i = 0; i < g_sync.count; i++) {
+
+        part = &g_syncToolParts[i];
+
+        if ((part->outFreq != expectFreq[i]) || (part->outPhase != expectPhase[i])) {
+
+            failures++;
+            continue;
+
+        }
+
+        if (part->changes == 0) {
+
+            continue;
+
+        }
+
+        if ((part->changes != 1) || ((part->firstStamp & 1) == 0) ||
+            ((edge != SYNC_TOOL_NONE) && (part->firstStamp != edge) &&
+             (g_sync.latchWrites == 1))) {
+
+            failures++;
+            continue;
+
+        }
+
+        edge = part->firstStamp;
+
+    }
+
+    return failures;
+
+}
+
+//************************************************************************************
+//
+// Run commits over a layout, with a random subset of channels staged each time.
+//
+//************************************************************************************
+static bool SyncToolCheckLayout(const tSyncToolLayout *layout, uint32_t commits) {
+
+    uint32_t failures = 0;
+    uint32_t all = (1UL << layout->count) - 1;
+    uint32_t i, mask;
+
+    if (!SyncToolSetup(layout)) {
+
+        return false;
+
+    }
+
+    for (i = 0; i < commits; i++) {
+
+        mask = (i == 0) ? all : (SyncToolRandom() & all);
+        failures += SyncToolCommit(mask, false);
+
+    }
+
+    printf("  %-26s %u channels  %6u commits  %6u frames  %u latch write%s  skew "
+           "max %u cycles  ", layout->name, layout->count, g_sync.commits,
+           g_sync.stagedFrames, g_sync.latchWrites, (g_sync.latchWrites == 1) ? " " : "s",
+           g_sync.maxSkewCycles);
+
+    if (failures != 0) {
+
+        printf("FAIL: %u channel updates not atomic\n", failures);
+
+    }
+
+    else {
+
+        printf("ok\n");
+
+    }
+
+    return failures == 0;
+
+}
+
+//************************************************************************************
+//
+// Fill a layout: ad9834 AD9834s then ad9952 AD9952s, alternating between the
+// buses when both are used.  The first part on each bus has no select line when
+// it is alone there.
+//
+//************************************************************************************
+static void SyncToolBuild(tSyncToolLayout *layout, const char *name, uint32_t ad9834,
+                          uint32_t ad9952, uint32_t ioUpdatePort) {
+
+    tSyncToolWiring *wiring;
+    uint32_t n834 = 0, n952 = 0;
+
+    layout->name = name;
+    layout->count = 0;
+
+    while ((n834 < ad9834) || (n952 < ad9952)) {
+
+        wiring = &layout->wiring[layout->count++];
+
+        if ((n834 < ad9834) && ((n834 <= n952) || (n952 == ad9952))) {
+
+            wiring->instance = SSISTREAM_AD9834;
+            wiring->selectPort = HAL_PORT_D;
+            wiring->selectPins = (ad9834 > 1) ? (uint8_t)(1 << n834) : 0;
+            wiring->latchPort = HAL_PORT_K;
+            wiring->latchPins = SYNC_TOOL_FSELECT;
+            n834++;
+
+        }
+
+        else {
+
+            wiring->instance = SSISTREAM_AD9952;
+            wiring->selectPort = HAL_PORT_P;
+            wiring->selectPins = (ad9952 > 1) ? (uint8_t)(1 << n952) : 0;
+            wiring->latchPort = ioUpdatePort;
+            wiring->latchPins = SYNC_TOOL_IOUPDATE;
+            n952++;
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// True if every part the layout uses is built.
+//
+//************************************************************************************
+static bool SyncToolLayoutBuilt(const tSyncToolLayout *layout) {
+
+    uint32_t i;
+
+    for (i = 0; i < layout->count; i++) {
+
+        if (!DDSChipBuilt(layout->wiring[i].instance)) {
+
+            return false;
+
+        }
+
+    }
+
+    return true;
+
+}
+
+static int SyncToolCheck(uint32_t commits) {
+
+    static const struct {
+
+        const char *name;
+        tSyncToolWiring wiring;
+
+    } owned[] = {
+
+        { "UART0 RX/TX as IO_UPDATE",
+          { SSISTREAM_AD9952, HAL_PORT_P, 0, HAL_PORT_A, HAL_PIN_0 | HAL_PIN_1 } },
+        { "SSI0 CLK as IO_UPDATE",
+          { SSISTREAM_AD9952, HAL_PORT_P, 0, HAL_PORT_A, HAL_PIN_2 } },
+        { "SSI3 FSS as a select",
+          { SSISTREAM_AD9834, HAL_PORT_Q, HAL_PIN_1, HAL_PORT_K, SYNC_TOOL_FSELECT } },
+        { "sweep IO_UPDATE PL4",
+          { SSISTREAM_AD9952, HAL_PORT_P, 0, HAL_PORT_L, HAL_PIN_4 } },
+        { "calibration input PM0",
+          { SSISTREAM_AD9952, HAL_PORT_P, 0, HAL_PORT_M, HAL_PIN_0 } },
+        { "FSELECT as IO_UPDATE",
+          { SSISTREAM_AD9952, HAL_PORT_P, 0, HAL_PORT_K, HAL_PIN_0 } },
+        { "PSELECT as a select",
+          { SSISTREAM_AD9952, HAL_PORT_K, HAL_PIN_1, HAL_PORT_K, SYNC_TOOL_IOUPDATE } }
+
+    };
+    tSyncToolLayout layouts[5];
+    tSyncToolLayout control;
+    bool ok = true, refused;
+    uint32_t failures, i;
+
+    SyncToolBuild(&layouts[0], "AD9834 + AD9952", 1, 1, HAL_PORT_K);
+    SyncToolBuild(&layouts[1], "4 x AD9834, shared SSI0", 4, 0, HAL_PORT_K);
+    SyncToolBuild(&layouts[2], "4 x AD9952, shared SSI3", 0, 4, HAL_PORT_K);
+    SyncToolBuild(&layouts[3], "4 + 4, shared IO_UPDATE", 4, 4, HAL_PORT_K);
+    SyncToolBuild(&layouts[4], "4 + 4, IO_UPDATE on PM", 4, 4, HAL_PORT_M);
+
+    //
+    // Negative control: the check has to see a write to the output bank.  One of
+    // each part that is built, none behind a select line.
+    //
+    SyncToolBuild(&control, "control",
+                  DDSChipBuilt(SSISTREAM_AD9834) ? 1 : 0,
+                  DDSChipBuilt(SSISTREAM_AD9952) ? 1 : 0, HAL_PORT_K);
+
+    if (!SyncToolSetup(&control)) {
+
+        return 1;
+
+    }
+
+    SyncToolCommit((1UL << control.count) - 1, false);
+    failures = SyncToolCommit((1UL << control.count) - 1, true);
+    printf("  %-26s %s\n", "control    staging write",
+           (failures != 0) ? "caught" : "FAIL: missed");
+    ok = ok && (failures != 0);
+
+    for (i = 0; i < (sizeof(owned) / sizeof(owned[0])); i++) {
+
+        if (DDSChipBuilt(owned[i].wiring.instance)) {
+
+            SyncInit(&g_sync);
+            refused = !SyncAdd(&g_sync, owned[i].wiring.instance,
+                               owned[i].wiring.selectPort, owned[i].wiring.selectPins,
+                               owned[i].wiring.latchPort, owned[i].wiring.latchPins);
+            printf("  %-26s %s\n", owned[i].name, refused ? "refused" : "FAIL: taken");
+            ok = ok && refused;
+
+        }
+
+    }
+
+    //
+    // Only the layouts whose parts are all built.
+    //
+    for (i = 0; i < (sizeof(layouts) / sizeof(layouts[0])); i++) {
+
+        if (SyncToolLayoutBuilt(&layouts[i])) {
+
+            ok = SyncToolCheckLayout(&layouts[i], commits) && ok;
+
+        }
+
+        else {
+
+            printf("  %-26s not built\n", layouts[i].name);
+
+        }
+
+    }
+
+    printf("\n%s\n", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// Modelled bus time of the last commit in microseconds, and the spread between
+// the first and last part being loaded.
+//
+//************************************************************************************
+static double SyncToolBusUs(const tSyncToolLayout *layout, double *spreadUs) {
+
+    static const uint32_t bits[SSISTREAM_COUNT] = {
+
+        AD9834_FRAME_BITS + 1, AD9952_FRAME_BITS + 1
+
+    };
+    uint32_t next[SSISTREAM_COUNT] = { 0, 0 };
+    double total = 0.0, first = -1.0, round, cost;
+    uint32_t bus, i;
+    bool any;
+
+    for (;;) {
+
+        any = false;
+        round = 0.0;
+
+        for (bus = 0; bus < SSISTREAM_COUNT; bus++) {
+
+            for (i = next[bus]; i < layout->count; i++) {
+
+                if (layout->wiring[i].instance == bus) {
+
+                    break;
+
+                }
+
+            }
+
+            next[bus] = i + 1;
+
+            if (i >= layout->count) {
+
+                continue;
+
+            }
+
+            cost = (g_syncToolParts[i].frames * bits[bus] * 1e6) / BOOT_SSI_BIT_RATE;
+            round = (cost > round) ? cost : round;
+            any = true;
+
+        }
+
+        if (!any) {
+
+            break;
+
+        }
+
+        total += round;
+
+        if (first < 0.0) {
+
+            first = total;
+
+        }
+
+    }
+
+    *spreadUs = total - first;
+
+    return total;
+
+}
+
+static int SyncToolBench(uint32_t commits) {
+
+    static const char *names[2] = { "shared", "split" };
+    tSyncToolLayout layout;
+    struct timespec start, stop;
+    double busUs, spreadUs, busTotal, spreadTotal, wall;
+    uint32_t frames, failures, kind, n, i;
+
+    printf("layout  chans  frames/commit  bus us/commit  commits/s  updates/s  "
+           "spread us  host us/commit\n");
+
+    for (kind = 0; kind < 2; kind++) {
+
+        for (n = 1; n <= SYNC_CHANNELS_MAX; n++) {
+
+            if (kind == 0) {
+
+                SyncToolBuild(&layout, names[kind], 0, n, HAL_PORT_K);
+
+            }
+
+            else {
+
+                SyncToolBuild(&layout, names[kind], (n + 1) / 2, n / 2, HAL_PORT_K);
+
+            }
+
+            if (!SyncToolSetup(&layout)) {
+
+                return 1;
+
+            }
+
+            SyncToolCommit((1UL << n) - 1, false);
+
+            frames = 0;
+            failures = 0;
+            busTotal = 0.0;
+            spreadTotal = 0.0;
+            wall = 0.0;
+
+            for (i = 0; i < commits; i++) {
+
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                failures += SyncToolCommit((1UL << n) - 1, false);
+                clock_gettime(CLOCK_MONOTONIC, &stop);
+
+                wall += (stop.tv_sec - start.tv_sec) +
+                        ((stop.tv_nsec - start.tv_nsec) * 1e-9);
+                frames += g_sync.stagedFrames;
+                busUs = SyncToolBusUs(&layout, &spreadUs);
+                busTotal += busUs;
+                spreadTotal += spreadUs;
+
+            }
+
+            busUs = busTotal / commits;
+            printf("%-6s  %5u  %13.1f  %13.2f  %9.0f  %9.0f  %9.2f  %14.2f%s\n",
+                   layout.name, n, (double)frames / commits, busUs, 1e6 / busUs,
+                   (1e6 * n) / busUs, spreadTotal / commits, (wall * 1e6) / commits,
+                   (failures != 0) ? "  NOT ATOMIC" : "");
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint32_t commits = SYNC_TOOL_COMMITS;
+
+    if (argc >= 3) {
+
+        commits = (uint32_t)strtoul(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || (commits == 0) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [commits]\n", argv[0]);
+        return 2;
+
+    }
+
+    SyncToolBoot();
+
+    return (strcmp(argv[1], "check") == 0) ? SyncToolCheck(commits) :
+                                             SyncToolBench(commits);
+
+}
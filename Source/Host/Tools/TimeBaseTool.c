@@ -0,0 +1,430 @@
+//************************************************************************************
+//
+// Title:               Time Base Stress Test
+// Author:              Jacob Putz
+// Filename:            TimeBaseTool.c
+//
+// Description:     Runs the SysTick path of the time base on a writer thread, as
+//                      fast as the host allows, against reader threads calling the
+//                      sequence-locked reads, and checks that no read ever returns
+//                      a torn or inconsistent value.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/timebase_tool.
+//
+//  Usage:
+//
+//      timebase_tool check [reads]     stress test, reads per reader (default 10M)
+//      timebase_tool bench [reads]     cost of each read, idle and under the writer
+//
+//  The time base runs on the host HAL with TIMEBASE_TOOL_CLK_HZ and a 1 Hz tick,
+//  so a tick is TIMEBASE_TOOL_PERIOD cycles, 93% of 2^32: the high word of the
+//  64-bit cycle count changes on nearly every tick, and every read that mixes two
+//  ticks' words gives a value off the tick grid.  The writer thread calls
+//  HalHostAdvance() one period at a time, which moves the simulated cycle counter
+//  and runs the real SysTick handler (TimeBasePort.c), as the interrupt would.
+//  The host's 64-bit loads cannot tear by themselves, so what is being tested is
+//  what the sequence lock adds: that the fields a read combines all come from the
+//  same tick.
+//
+//  Each reader thread calls TimeBaseCycles(), TimeBaseTicks() and TimeBaseMicros()
+//  in turn and checks every result:
+//
+//      cycles      a whole number of periods (the simulated counter only ever
+//                  stands on the tick grid), never behind the reader's last
+//                  cycles, never ahead of the counter read just after
+//      ticks       never behind the last ticks, never ahead of the counter
+//      micros      never behind the last micros
+//
+//  A negative control runs alongside: a reader that combines the same fields
+//  without the lock, loading the 64-bit tick cycle count as two 32-bit halves the
+//  way the M4 does, with TIMEBASE_TOOL_WINDOW loads between the halves so a single
+//  host CPU switching threads lands between them often enough.  It has to be
+//  caught at least once, or the run did not race the writer enough to mean
+//  anything.  check exits 1 if any locked read fails or the control is never
+//  caught.
+//
+//  The simulated cycle counter the readers sample through HalCycles32() is a
+//  plain 64-bit variable written by the writer thread; 64-bit loads and stores
+//  are single instructions on the hosts this runs on.
+//
+//************************************************************************************
+
+// Includes
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Hal.h"
+#include "HalHost.h"
+#include "TimeBase.h"
+
+// Defines
+#define     TIMEBASE_TOOL_CLK_HZ    4000000000UL
+#define     TIMEBASE_TOOL_TICK_HZ   1
+#define     TIMEBASE_TOOL_PERIOD    (TIMEBASE_TOOL_CLK_HZ / TIMEBASE_TOOL_TICK_HZ)
+#define     TIMEBASE_TOOL_READERS   2
+#define     TIMEBASE_TOOL_READS     10000000ULL
+#define     TIMEBASE_TOOL_WINDOW    32          // Loads between the control's halves
+#define     TIMEBASE_TOOL_BENCH     20000000ULL
+
+// Type Definitions
+typedef struct {
+
+    pthread_t thread;
+    uint64_t reads;                 // Of each kind
+    uint64_t bad;
+    char first[128];                // The first failure
+
+} tTimeBaseToolReader;
+
+// Global Variables
+static volatile bool g_timeBaseToolStop;
+static volatile uint64_t g_timeBaseToolTicks;   // Written by the writer
+
+//************************************************************************************
+//
+// The writer: one tick per call, through the host HAL and the real SysTick handler.
+//
+//************************************************************************************
+static void *TimeBaseToolWriter(void *arg) {
+
+    (void)arg;
+
+    while (!g_timeBaseToolStop) {
+
+        HalHostAdvance(TIMEBASE_TOOL_PERIOD);
+        g_timeBaseToolTicks++;
+
+    }
+
+    return 0;
+
+}
+
+static void TimeBaseToolFail(tTimeBaseToolReader *reader, const char *what,
+                             uint64_t value, uint64_t bound) {
+
+    if (reader->bad++ == 0) {
+
+        snprintf(reader->first, sizeof(reader->first), "%s %llu (bound %llu)", what,
+                 (unsigned long long)value, (unsigned long long)bound);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// A reader through the sequence lock.
+//
+//************************************************************************************
+static void *TimeBaseToolReader(void *arg) {
+
+    tTimeBaseToolReader *reader = arg;
+    uint64_t cycles, ticks, micros, now;
+    uint64_t lastCycles = 0, lastTicks = 0, lastMicros = 0;
+    uint64_t i;
+
+    for (i = 0; i < reader->reads; i++) {
+
+        cycles = TimeBaseCycles();
+        now = HalHostCycles();
+
+        if ((cycles % TIMEBASE_TOOL_PERIOD) != 0) {
+
+            TimeBaseToolFail(reader, "cycles off the tick grid", cycles, now);
+
+        }
+
+        else if (cycles < lastCycles) {
+
+            TimeBaseToolFail(reader, "cycles went back", cycles, lastCycles);
+
+        }
+
+        else if (cycles > now) {
+
+            TimeBaseToolFail(reader, "cycles ahead of the counter", cycles, now);
+
+        }
+
+        lastCycles = cycles;
+
+        ticks = TimeBaseTicks();
+        now = HalHostCycles();
+
+        if (ticks < lastTicks) {
+
+            TimeBaseToolFail(reader, "ticks went back", ticks, lastTicks);
+
+        }
+
+        else if ((ticks * TIMEBASE_TOOL_PERIOD) > now) {
+
+            TimeBaseToolFail(reader, "ticks ahead of the counter", ticks, now);
+
+        }
+
+        lastTicks = ticks;
+
+        micros = TimeBaseMicros();
+
+        if (micros < lastMicros) {
+
+            TimeBaseToolFail(reader, "micros went back", micros, lastMicros);
+
+        }
+
+        lastMicros = micros;
+
+    }
+
+    return 0;
+
+}
+
+//************************************************************************************
+//
+// The negative control: TimeBaseCycles() without the lock, with the 64-bit field
+// loaded as the M4 would, low word first.
+//
+//************************************************************************************
+static void *TimeBaseToolControl(void *arg) {
+
+    tTimeBaseToolReader *reader = arg;
+    const volatile uint32_t *words = (const volatile uint32_t *)&g_timeBase.tickCycles;
+    uint64_t cycles, last = 0;
+    uint32_t lo, hi, spin;
+    uint64_t i;
+
+    for (i = 0; i < reader->reads; i++) {
+
+        lo = words[0];
+
+        for (spin = 0; spin < TIMEBASE_TOOL_WINDOW; spin++) {
+
+            (void)g_timeBase.seq;
+
+        }
+
+        hi = words[1];
+        cycles = (((uint64_t)hi << 32) | lo) +
+                 (uint32_t)(HalCycles32() - g_timeBase.tickCycles32);
+
+        if (((cycles % TIMEBASE_TOOL_PERIOD) != 0) || (cycles < last)) {
+
+            TimeBaseToolFail(reader, "torn", cycles, last);
+
+        }
+
+        last = cycles;
+
+    }
+
+    return 0;
+
+}
+
+static void TimeBaseToolSetup(void) {
+
+    HalClockInit(TIMEBASE_TOOL_CLK_HZ);
+    HalHostSetLimit(~0ULL);
+    TimeBaseInit(TIMEBASE_TOOL_CLK_HZ, TIMEBASE_TOOL_TICK_HZ);
+
+}
+
+static double TimeBaseToolSeconds(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (now.tv_nsec * 1e-9);
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int TimeBaseToolCheck(uint64_t reads) {
+
+    tTimeBaseToolReader readers[TIMEBASE_TOOL_READERS + 1];
+    pthread_t writer;
+    uint64_t bad = 0;
+    double start;
+    uint32_t i;
+    bool pass;
+
+    TimeBaseToolSetup();
+    memset(readers, 0, sizeof(readers));
+
+    g_timeBaseToolStop = false;
+    pthread_create(&writer, 0, TimeBaseToolWriter, 0);
+    start = TimeBaseToolSeconds();
+
+    for (i = 0; i <= TIMEBASE_TOOL_READERS; i++) {
+
+        readers[i].reads = reads;
+        pthread_create(&readers[i].thread, 0,
+                       (i < TIMEBASE_TOOL_READERS) ? TimeBaseToolReader :
+                                                     TimeBaseToolControl,
+                       &readers[i]);
+
+    }
+
+    for (i = 0; i <= TIMEBASE_TOOL_READERS; i++) {
+
+        pthread_join(readers[i].thread, 0);
+
+    }
+
+    g_timeBaseToolStop = true;
+    pthread_join(writer, 0);
+
+    printf("%llu ticks written, %.1f s\n\n", (unsigned long long)g_timeBaseToolTicks,
+           TimeBaseToolSeconds() - start);
+
+    for (i = 0; i < TIMEBASE_TOOL_READERS; i++) {
+
+        printf("  reader %u    %llu x 3 reads  %llu bad  %s%s\n", i,
+               (unsigned long long)readers[i].reads, (unsigned long long)readers[i].bad,
+               (readers[i].bad == 0) ? "ok" : "FAIL: ", readers[i].first);
+        bad += readers[i].bad;
+
+    }
+
+    printf("  control     %llu reads      %llu torn  %s\n",
+           (unsigned long long)readers[i].reads, (unsigned long long)readers[i].bad,
+           (readers[i].bad != 0) ? "caught" : "FAIL: never caught");
+
+    pass = (bad == 0) && (readers[i].bad != 0);
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  Each read alone, then with the writer running.  On a single host CPU
+// the writer only takes turns with the reader, so the second figure is mostly the
+// cost of sharing the cache lines, not of retries.
+//
+//************************************************************************************
+static void TimeBaseToolTime(const char *name, uint64_t (*read)(void), uint64_t reads,
+                             bool writing) {
+
+    pthread_t writer;
+    uint64_t sum = 0, i;
+    double start, seconds;
+
+    if (writing) {
+
+        g_timeBaseToolStop = false;
+        pthread_create(&writer, 0, TimeBaseToolWriter, 0);
+
+    }
+
+    start = TimeBaseToolSeconds();
+
+    for (i = 0; i < reads; i++) {
+
+        sum += read();
+
+    }
+
+    seconds = TimeBaseToolSeconds() - start;
+
+    if (writing) {
+
+        g_timeBaseToolStop = true;
+        pthread_join(writer, 0);
+
+    }
+
+    printf("  %-18s %-9s %8.2f ns/read  (%llx)\n", name, writing ? "writing" : "idle",
+           seconds * 1e9 / reads, (unsigned long long)(sum & 0xF));
+
+}
+
+static int TimeBaseToolBench(uint64_t reads) {
+
+    TimeBaseToolSetup();
+
+    printf("%llu reads each\n\n", (unsigned long long)reads);
+
+    TimeBaseToolTime("TimeBaseTicks()", TimeBaseTicks, reads, false);
+    TimeBaseToolTime("TimeBaseCycles()", TimeBaseCycles, reads, false);
+    TimeBaseToolTime("TimeBaseMicros()", TimeBaseMicros, reads, false);
+    TimeBaseToolTime("TimeBaseTicks()", TimeBaseTicks, reads, true);
+    TimeBaseToolTime("TimeBaseCycles()", TimeBaseCycles, reads, true);
+    TimeBaseToolTime("TimeBaseMicros()", TimeBaseMicros, reads, true);
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint64_t reads = 0;
+
+    if (argc >= 3) {
+
+        reads = strtoull(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (reads == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [reads]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return TimeBaseToolCheck((reads != 0) ? reads : TIMEBASE_TOOL_READS);
+
+    }
+
+    return TimeBaseToolBench((reads != 0) ? reads : TIMEBASE_TOOL_BENCH);
+
+}
@@ -0,0 +1,396 @@
+//************************************************************************************
+//
+// Title:               Tuning Word Check and Benchmark
+// Author:              Jacob Putz
+// Filename:            TuningTool.c
+//
+// Description:     Checks every tuning word path in DDSTuning.h against the exact
+//                      rational value over millions of random frequencies, and
+//                      measures how many words per second each path produces.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+//************************************************************************************
+//
+// Notes
+//
+//  Host/Makefile builds this as build/tuning_tool.
+//
+//  Usage:
+//
+//      tuning_tool check [count]       words against the exact value (default 4M)
+//      tuning_tool bench [count]       words per second for each path
+//
+//  The reference is the exact rational word, f * 2^N / (fClk * 2^32), rounded to
+//  nearest with halves up, in 128-bit integer arithmetic.  check draws count
+//  uniform random Q32.32 frequencies below the reference clock for each case:
+//
+//      AD9834, AD9952          the compile-time paths, AD9834FreqWord() and
+//                              AD9952FreqWord()
+//      runtime                 DDSTuningFreqWord() for a random clock and width
+//                              every TUNING_TOOL_CLK_EVERY frequencies, clocks
+//                              from 1 MHz to 2^32 - 1 Hz, widths 28 or 32
+//      batch                   DDSTuningFreqWords() over the runtime draws
+//
+//  A case passes if every word equals the reference.  The worst error is shown in
+//  LSB for the result and, for comparison, for the reciprocal estimate alone
+//  (DDSTuneMulShift()), which the correction step in DDSTuneWord() fixes up.
+//  Exits 1 on any mismatch.
+//
+//  bench converts a table of count random frequencies (default 1M) repeatedly
+//  for about TUNING_TOOL_BENCH_NS per path and reports host words per second.
+//  The ratio between the paths is what carries over to the target; the estimate
+//  alone is the cost before the correction.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DDSTuning.h"
+
+// Defines
+#define     TUNING_TOOL_CHECKS      4000000
+#define     TUNING_TOOL_BENCH       1000000
+#define     TUNING_TOOL_BENCH_NS    500000000ULL
+#define     TUNING_TOOL_CLK_EVERY   1000
+#define     TUNING_TOOL_CLK_MIN     1000000
+#define     TUNING_TOOL_SEED        0x5DD5EEDULL
+
+// Type Definitions
+typedef unsigned __int128 tU128;
+
+typedef struct {
+
+    const char *name;
+    uint64_t count;
+    uint64_t wrong;
+    double worst;                   // LSB, result
+    double worstEstimate;           // LSB, reciprocal estimate alone
+
+} tTuningToolCase;
+
+// Global Variables
+static uint64_t g_tuningToolRandom = TUNING_TOOL_SEED;
+
+//************************************************************************************
+//
+// splitmix64, so every run draws the same frequencies.
+//
+//************************************************************************************
+static uint64_t TuningToolRandom(void) {
+
+    uint64_t z = (g_tuningToolRandom += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+
+}
+
+//
+// Uniform Q32.32 frequency in [0, clk)
+//
+static uint64_t TuningToolFreq(uint32_t clk) {
+
+    return (uint64_t)(((tU128)TuningToolRandom() * ((uint64_t)clk << 32)) >> 64);
+
+}
+
+static uint64_t TuningToolNs(void) {
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+
+}
+
+//************************************************************************************
+//
+// Score one word.  word is compared unmasked with the exact value, whose bits
+// above the register width are put back on masked words before the distance is
+// taken.
+//
+//************************************************************************************
+static void TuningToolScore(tTuningToolCase *test, uint64_t freqQ32, uint32_t clk,
+                            uint32_t bits, uint64_t word, uint64_t estimate) {
+
+    tU128 num = (tU128)freqQ32 << bits;
+    tU128 den = (tU128)clk << 32;
+    uint64_t mask = (1ULL << bits) - 1;
+    uint64_t exact = (uint64_t)(((2 * num) + den) / (2 * den));
+    double error, errorEstimate;
+
+    test->count++;
+
+    if ((word & mask) != (exact & mask)) {
+
+        if (test->wrong == 0) {
+
+            printf("    %s: f 0x%016llX clk %u N %u: word 0x%llX, exact 0x%llX\n",
+                   test->name, (unsigned long long)freqQ32, clk, bits,
+                   (unsigned long long)(word & mask), (unsigned long long)(exact & mask));
+
+        }
+
+        test->wrong++;
+
+    }
+
+    word = (word & mask) | (exact & ~mask);
+    error = (double)((tU128)word * den > num ? (tU128)word * den - num :
+                                               num - (tU128)word * den) / (double)den;
+    errorEstimate = (double)((tU128)estimate * den > num ? (tU128)estimate * den - num :
+                                                           num - (tU128)estimate * den) /
+                    (double)den;
+
+    if (error > test->worst) {
+
+        test->worst = error;
+
+    }
+
+    if (errorEstimate > test->worstEstimate) {
+
+        test->worstEstimate = errorEstimate;
+
+    }
+
+}
+
+static bool TuningToolReport(const tTuningToolCase *test) {
+
+    printf("  %-8s %10llu words  worst %.3f LSB (estimate %.3f LSB)  %s\n", test->name,
+           (unsigned long long)test->count, test->worst, test->worstEstimate,
+           (test->wrong == 0) ? "ok" : "FAIL");
+
+    if (test->wrong != 0) {
+
+        printf("    %llu words differ from the nearest\n",
+               (unsigned long long)test->wrong);
+
+    }
+
+    return (test->wrong == 0);
+
+}
+
+//************************************************************************************
+//
+// A runtime context for a random clock and width that DDSTuningInit() accepts.
+//
+//************************************************************************************
+static void TuningToolContext(tDDSTuning *tuning) {
+
+    uint32_t clk, bits;
+
+    do {
+
+        clk = TUNING_TOOL_CLK_MIN +
+              (uint32_t)(TuningToolRandom() % (0xFFFFFFFFULL - TUNING_TOOL_CLK_MIN));
+        bits = (TuningToolRandom() & 1) ? 32 : 28;
+
+    } while (!DDSTuningInit(tuning, clk, bits, 12));
+
+}
+
+//************************************************************************************
+//
+// check
+//
+//************************************************************************************
+static int TuningToolCheck(uint64_t count) {
+
+    tTuningToolCase ad9834 = { "AD9834" }, ad9952 = { "AD9952" };
+    tTuningToolCase runtime = { "runtime" }, batch = { "batch" };
+    uint64_t freqs[TUNING_TOOL_CLK_EVERY];
+    uint32_t words[TUNING_TOOL_CLK_EVERY];
+    tDDSTuning tuning;
+    uint64_t f, i, j, done;
+    bool pass;
+
+    for (i = 0; i < count; i++) {
+
+        f = TuningToolFreq(AD9834_MCLK_HZ);
+        TuningToolScore(&ad9834, f, AD9834_MCLK_HZ, AD9834_FREQ_BITS, AD9834FreqWord(f),
+                        DDSTuneMulShift(f, AD9834_RECIP, AD9834_RECIP_SHIFT));
+
+        f = TuningToolFreq(AD9952_SYSCLK_HZ);
+        TuningToolScore(&ad9952, f, AD9952_SYSCLK_HZ, AD9952_FREQ_BITS, AD9952FreqWord(f),
+                        DDSTuneMulShift(f, AD9952_RECIP, AD9952_RECIP_SHIFT));
+
+    }
+
+    for (done = 0; done < count; done += TUNING_TOOL_CLK_EVERY) {
+
+        TuningToolContext(&tuning);
+
+        for (j = 0; j < TUNING_TOOL_CLK_EVERY; j++) {
+
+            freqs[j] = TuningToolFreq(tuning.refClkHz);
+            TuningToolScore(&runtime, freqs[j], tuning.refClkHz, tuning.freqBits,
+                            DDSTuningFreqWord(&tuning, freqs[j]),
+                            DDSTuneMulShift(freqs[j], tuning.recip, tuning.shift));
+
+        }
+
+        DDSTuningFreqWords(&tuning, freqs, words, TUNING_TOOL_CLK_EVERY);
+
+        for (j = 0; j < TUNING_TOOL_CLK_EVERY; j++) {
+
+            TuningToolScore(&batch, freqs[j], tuning.refClkHz, tuning.freqBits,
+                            words[j], DDSTuneMulShift(freqs[j], tuning.recip,
+                                                      tuning.shift));
+
+        }
+
+    }
+
+    pass = TuningToolReport(&ad9834);
+    pass = TuningToolReport(&ad9952) && pass;
+    pass = TuningToolReport(&runtime) && pass;
+    pass = TuningToolReport(&batch) && pass;
+
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+
+}
+
+//************************************************************************************
+//
+// bench.  Each path runs over the table until TUNING_TOOL_BENCH_NS has passed;
+// the words are folded into a checksum so none of the work can be dropped.
+//
+//************************************************************************************
+#define TUNING_TOOL_TIME(label, expr)                                               \
+    do {                                                                            \
+        uint64_t begin = TuningToolNs(), words = 0, ns;                             \
+        do {                                                                        \
+            for (i = 0; i < count; i++) {                                           \
+                sum += (expr);                                                      \
+            }                                                                       \
+            words += count;                                                         \
+        } while ((ns = TuningToolNs() - begin) < TUNING_TOOL_BENCH_NS);             \
+        printf("  %-24s %8.1f M words/s  %6.2f ns/word\n", (label),                 \
+               words * 1e3 / ns, (double)ns / words);                               \
+    } while (0)
+
+static int TuningToolBench(uint64_t count) {
+
+    uint64_t *f34 = malloc(count * sizeof(uint64_t));
+    uint64_t *f52 = malloc(count * sizeof(uint64_t));
+    uint32_t *words = malloc(count * sizeof(uint32_t));
+    tDDSTuning tuning;
+    uint64_t begin, ns, done, i;
+    uint32_t sum = 0;
+
+    if ((f34 == 0) || (f52 == 0) || (words == 0)) {
+
+        fprintf(stderr, "tuning_tool: out of memory\n");
+        return 1;
+
+    }
+
+    for (i = 0; i < count; i++) {
+
+        f34[i] = TuningToolFreq(AD9834_MCLK_HZ);
+        f52[i] = TuningToolFreq(AD9952_SYSCLK_HZ);
+
+    }
+
+    DDSTuningInit(&tuning, AD9952_SYSCLK_HZ, AD9952_FREQ_BITS, AD9952_PHASE_BITS);
+
+    printf("%llu frequencies per pass\n\n", (unsigned long long)count);
+
+    TUNING_TOOL_TIME("AD9834 estimate only",
+                     (uint32_t)DDSTuneMulShift(f34[i], AD9834_RECIP, AD9834_RECIP_SHIFT));
+    TUNING_TOOL_TIME("AD9834FreqWord()", AD9834FreqWord(f34[i]));
+    TUNING_TOOL_TIME("AD9952 estimate only",
+                     (uint32_t)DDSTuneMulShift(f52[i], AD9952_RECIP, AD9952_RECIP_SHIFT));
+    TUNING_TOOL_TIME("AD9952FreqWord()", AD9952FreqWord(f52[i]));
+    TUNING_TOOL_TIME("DDSTuningFreqWord()", DDSTuningFreqWord(&tuning, f52[i]));
+
+    begin = TuningToolNs();
+    done = 0;
+
+    do {
+
+        DDSTuningFreqWords(&tuning, f52, words, (uint32_t)count);
+        sum += words[count - 1];
+        done += count;
+
+    } while ((ns = TuningToolNs() - begin) < TUNING_TOOL_BENCH_NS);
+
+    printf("  %-24s %8.1f M words/s  %6.2f ns/word\n", "DDSTuningFreqWords()",
+           done * 1e3 / ns, (double)ns / done);
+    printf("\n(checksum %08X)\n", sum);
+
+    free(f34);
+    free(f52);
+    free(words);
+
+    return 0;
+
+}
+
+int main(int argc, char **argv) {
+
+    uint64_t count = 0;
+
+    if (argc >= 3) {
+
+        count = strtoull(argv[2], 0, 10);
+
+    }
+
+    if ((argc < 2) || ((argc >= 3) && (count == 0)) ||
+        ((strcmp(argv[1], "check") != 0) && (strcmp(argv[1], "bench") != 0))) {
+
+        fprintf(stderr, "usage: %s check|bench [count]\n", argv[0]);
+        return 2;
+
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+
+        return TuningToolCheck((count != 0) ? count : TUNING_TOOL_CHECKS);
+
+    }
+
+    return TuningToolBench((count != 0) ? count : TUNING_TOOL_BENCH);
+
+}
@@ -0,0 +1,264 @@
+//************************************************************************************
+//
+// Title:               Static Memory Arena and Block Pools
+// Author:              Jacob Putz
+// Filename:            Mem.c
+//
+// Description:     Bump arena and lock-free fixed-block pools.  The only port
+//                      dependencies are the arena bounds and a 32-bit compare-and-swap.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Mem.h"
+
+// Defines
+#define     MEM_TAG_STEP            0x00010000
+#define     MEM_INDEX_MASK          0x0000FFFF
+
+// Global Variables
+tMem g_mem;
+
+//************************************************************************************
+//
+// Add delta to a counter and return the new value.
+//
+//************************************************************************************
+static uint32_t MemAtomicAdd(volatile uint32_t *word, uint32_t delta) {
+
+    uint32_t old;
+
+    do {
+
+        old = *word;
+
+    } while (!MemPortCas(word, old, old + delta));
+
+    return old + delta;
+
+}
+
+static uintptr_t MemRoundUp(uintptr_t value, uint32_t align) {
+
+    return (value + align - 1) & ~(uintptr_t)(align - 1);
+
+}
+
+void MemInit(void) {
+
+    uint8_t *base;
+    uint32_t size;
+
+    MemPortArena(&base, &size);
+
+    //
+    // Start on a MEM_ALIGN boundary whatever the linker handed over.
+    //
+    g_mem.base = (uint8_t *)MemRoundUp((uintptr_t)base, MEM_ALIGN);
+    g_mem.size = size - (uint32_t)(g_mem.base - base);
+    g_mem.used = 0;
+    g_mem.failures = 0;
+    g_mem.poolCount = 0;
+
+}
+
+//************************************************************************************
+//
+// Take size bytes aligned to align (a power of two) from the arena, or return NULL
+// if it cannot be satisfied.  Safe from interrupts, though allocations that live
+// until reset normally all happen during start-up.
+//
+//************************************************************************************
+void *MemArenaAlloc(uint32_t size, uint32_t align) {
+
+    uintptr_t base = (uintptr_t)g_mem.base;
+    uint32_t used, start;
+
+    if ((align == 0) || ((align & (align - 1)) != 0)) {
+
+        return NULL;
+
+    }
+
+    do {
+
+        used = g_mem.used;
+        start = (uint32_t)(MemRoundUp(base + used, align) - base);
+
+        if ((start > g_mem.size) || (size > (g_mem.size - start))) {
+
+            MemAtomicAdd(&g_mem.failures, 1);
+            return NULL;
+
+        }
+
+    } while (!MemPortCas(&g_mem.used, used, start + size));
+
+    return g_mem.base + start;
+
+}
+
+uint32_t MemArenaFree(void) {
+
+    return g_mem.size - g_mem.used;
+
+}
+
+//************************************************************************************
+//
+// Carve count blocks of blockSize bytes out of the arena, thread them onto the free
+// list and register the pool for reporting.  Must finish before the pool is shared
+// with an interrupt.
+//
+//************************************************************************************
+bool MemPoolInit(tMemPool *pool, const char *name, uint32_t blockSize,
+                 uint32_t count) {
+
+    uint32_t i;
+
+    if ((count == 0) || (count > MEM_POOL_BLOCKS_MAX) ||
+        (g_mem.poolCount >= MEM_POOLS_MAX)) {
+
+        return false;
+
+    }
+
+    blockSize = (uint32_t)MemRoundUp((blockSize == 0) ? 1 : blockSize, MEM_ALIGN);
+
+    if (blockSize > (0xFFFFFFFFUL / count)) {
+
+        return false;
+
+    }
+
+    pool->base = MemArenaAlloc(blockSize * count, MEM_ALIGN);
+
+    if (pool->base == NULL) {
+
+        return false;
+
+    }
+
+    for (i = 0; (i + 1) < count; i++) {
+
+        *(uint32_t *)(pool->base + (i * blockSize)) = i + 1;
+
+    }
+
+    *(uint32_t *)(pool->base + (i * blockSize)) = MEM_NIL;
+
+    pool->name = name;
+    pool->blockSize = blockSize;
+    pool->count = count;
+    pool->head = 0;
+    pool->inUse = 0;
+    pool->highWater = 0;
+    pool->failures = 0;
+
+    g_mem.pools[g_mem.poolCount++] = pool;
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Pop a block, or return NULL if the pool is empty.  The link read may come from a
+// block another context has just taken; the tag makes the CAS fail in that case.
+//
+//************************************************************************************
+void *MemPoolAlloc(tMemPool *pool) {
+
+    uint32_t head, index, next, used, high;
+
+    do {
+
+        head = pool->head;
+        index = head & MEM_INDEX_MASK;
+
+        if (index == MEM_NIL) {
+
+            MemAtomicAdd(&pool->failures, 1);
+            return NULL;
+
+        }
+
+        next = *(volatile uint32_t *)(pool->base + (index * pool->blockSize));
+
+    } while (!MemPortCas(&pool->head, head,
+                         ((head + MEM_TAG_STEP) & ~MEM_INDEX_MASK) | next));
+
+    used = MemAtomicAdd(&pool->inUse, 1);
+
+    do {
+
+        high = pool->highWater;
+
+    } while ((used > high) && !MemPortCas(&pool->highWater, high, used));
+
+    return pool->base + (index * pool->blockSize);
+
+}
+
+//************************************************************************************
+//
+// Push a block back.  block must have come from MemPoolAlloc() on the same pool;
+// NULL is ignored.
+//
+//************************************************************************************
+void MemPoolFree(tMemPool *pool, void *block) {
+
+    uint32_t index, head;
+
+    if (block == NULL) {
+
+        return;
+
+    }
+
+    index = (uint32_t)((uint8_t *)block - pool->base) / pool->blockSize;
+
+    //
+    // Count the block out before it is visible on the free list, so inUse (and
+    // with it highWater) can never exceed count.
+    //
+    MemAtomicAdd(&pool->inUse, 0xFFFFFFFF);
+
+    do {
+
+        head = pool->head;
+        *(volatile uint32_t *)block = head & MEM_INDEX_MASK;
+
+    } while (!MemPortCas(&pool->head, head,
+                         ((head + MEM_TAG_STEP) & ~MEM_INDEX_MASK) | index));
+
+}
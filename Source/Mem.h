@@ -0,0 +1,140 @@
+//************************************************************************************
+//
+// Title:               Static Memory Arena and Block Pools
+// Author:              Jacob Putz
+// Filename:            Mem.h
+//
+// Description:     Allocation for runtime objects without a heap.  A bump arena
+//                      placed by the linker hands out memory that lives until reset;
+//                      fixed-size block pools carved from it give O(1) allocation and
+//                      release that is safe from any interrupt.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Point at the host check.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef MEM_H_
+#define MEM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  The arena is the ARENA region of tm4c1294ncpdt.cmd, so its size is fixed at link
+//  time and the linker fails the build if .bss grows into it.  MemArenaAlloc()
+//  only ever moves forward; nothing allocated from it is returned.
+//
+//  A pool is a Treiber stack of free blocks.  The free-list link lives in the
+//  first word of each free block, and the head word packs the index of the first
+//  free block with a 16-bit tag that changes on every push and pop:
+//
+//      head = (tag << 16) | index          index MEM_NIL when the pool is empty
+//
+//  so a compare-and-swap on the head cannot succeed against a stale view of the
+//  list (the ABA case) unless 65536 other operations landed in between.  Every
+//  update is a MemPortCas() retry loop; nothing masks interrupts, and an interrupt
+//  that pre-empts an allocation simply makes the interrupted CAS retry.
+//
+//  Pools hold at most MEM_POOL_BLOCKS_MAX blocks.  Blocks are rounded up to
+//  MEM_ALIGN bytes so any type can be stored in them.
+//
+//  Host/Tools/MemTool.c registers pools and checks exhaustion and recovery, and
+//  the free list under several threads allocating and freeing at once.
+//
+//************************************************************************************
+
+// Defines
+#define     MEM_ALIGN               8
+#define     MEM_POOLS_MAX           8
+#define     MEM_NIL                 0xFFFF
+#define     MEM_POOL_BLOCKS_MAX     MEM_NIL
+
+//
+// Typed pool helpers
+//
+#define     MEM_POOL_INIT_TYPE(pool, name, type, count)                             \
+                MemPoolInit((pool), (name), sizeof(type), (count))
+#define     MEM_POOL_NEW(pool, type)    ((type *)MemPoolAlloc(pool))
+
+// Type Definitions
+typedef struct {
+
+    const char *name;
+    uint8_t *base;                  // First block, in the arena
+    uint32_t blockSize;             // Rounded up to MEM_ALIGN
+    uint32_t count;
+
+    volatile uint32_t head;         // (tag << 16) | first free block
+
+    //
+    // Statistics
+    //
+    volatile uint32_t inUse;
+    volatile uint32_t highWater;    // Most blocks ever in use at once
+    volatile uint32_t failures;     // Allocations refused because the pool was empty
+
+} tMemPool;
+
+typedef struct {
+
+    uint8_t *base;
+    uint32_t size;
+    volatile uint32_t used;
+    volatile uint32_t failures;
+
+    tMemPool *pools[MEM_POOLS_MAX];
+    uint32_t poolCount;
+
+} tMem;
+
+// Global Variables
+extern tMem g_mem;
+
+// Function Prototypes
+//
+// Portable core (Mem.c)
+//
+extern void MemInit(void);
+extern void *MemArenaAlloc(uint32_t size, uint32_t align);
+extern uint32_t MemArenaFree(void);
+extern bool MemPoolInit(tMemPool *pool, const char *name, uint32_t blockSize,
+                        uint32_t count);
+extern void *MemPoolAlloc(tMemPool *pool);
+extern void MemPoolFree(tMemPool *pool, void *block);
+
+//
+// Port layer (MemTiva.c on target, Host/MemHost.c on a host build)
+//
+extern void MemPortArena(uint8_t **base, uint32_t *size);
+extern bool MemPortCas(volatile uint32_t *word, uint32_t expected, uint32_t desired);
+
+#endif /* MEM_H_ */
@@ -0,0 +1,115 @@
+//************************************************************************************
+//
+// Title:               Static Memory Arena and Block Pools - TM4C129 Port
+// Author:              Jacob Putz
+// Filename:            MemTiva.c
+//
+// Description:     Arena bounds from the linker and an LDREX/STREX compare-and-
+//                      swap.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Mem.h"
+
+// Global Variables
+//
+// Defined in tm4c1294ncpdt.cmd.  Only their addresses mean anything.
+//
+extern uint8_t __ARENA_START;
+extern uint8_t __ARENA_END;
+
+//************************************************************************************
+//
+// Exclusive access intrinsics.  An exception entry or return clears the local
+// monitor, so an interrupt landing between the load and the store always makes
+// the store fail and the CAS retry.  Without either intrinsic set the CAS falls
+// back to masking interrupts, which is still safe on a single core.
+//
+//************************************************************************************
+#if defined(__TI_ARM__)
+#define     MEM_LDREX(word)         ((uint32_t)__ldrex((void *)(word)))
+#define     MEM_STREX(value, word)  __strex((value), (void *)(word))
+#define     MEM_CLREX()             __clrex()
+#elif defined(__ARM_FEATURE_LDREX)
+#include <arm_acle.h>
+#define     MEM_LDREX(word)         __ldrex(word)
+#define     MEM_STREX(value, word)  __strex((value), (word))
+#define     MEM_CLREX()             __clrex()
+#endif
+
+void MemPortArena(uint8_t **base, uint32_t *size) {
+
+    *base = &__ARENA_START;
+    *size = (uint32_t)(&__ARENA_END - &__ARENA_START);
+
+}
+
+#if defined(MEM_LDREX)
+bool MemPortCas(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+
+    do {
+
+        if (MEM_LDREX(word) != expected) {
+
+            MEM_CLREX();
+            return false;
+
+        }
+
+    } while (MEM_STREX(desired, word) != 0);
+
+    return true;
+
+}
+#else
+bool MemPortCas(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+
+    bool wasMasked = HalIntMasterDisable();
+    bool swapped = (*word == expected);
+
+    if (swapped) {
+
+        *word = desired;
+
+    }
+
+    if (!wasMasked) {
+
+        HalIntMasterEnable();
+
+    }
+
+    return swapped;
+
+}
+#endif
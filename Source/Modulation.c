@@ -0,0 +1,322 @@
+//************************************************************************************
+//
+// Title:               Pin-Switched Modulation
+// Author:              Jacob Putz
+// Filename:            Modulation.c
+//
+// Description:     Bank loading, bitstream expansion and buffer bookkeeping for the
+//                      pin-switched modulator.  Nothing in this file touches hardware;
+//                      see ModulationTiva.c for the timer, uDMA and GPIO port.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Attribute bank loads in the command trace.
+//
+// 0.1.1    -       Load the banks through the AD9834 shadow.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Modulation.h"
+#include "Profile.h"
+#include "Record.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "TimeBase.h"
+
+// Global Variables
+tModulator g_modulator;
+
+//************************************************************************************
+//
+// Load FREQ0/FREQ1 and PHASE0/PHASE1 and hand register selection to the pins.  The
+// changes go through the AD9834 shadow as one queue entry, so the part is never
+// left with one bank updated and the other stale, and reloading an unchanged bank
+// costs nothing.
+//
+//************************************************************************************
+bool ModulationLoadBanks(const tDDSTuning *tuning, uint64_t freq0Q32,
+                         uint64_t freq1Q32, uint32_t phase0, uint32_t phase1) {
+
+    tAD9834Shadow *shadow = &g_ad9834Shadow;
+    uint32_t origin;
+    bool queued;
+
+    DDSShadowAD9834SetCtrl(shadow, AD9834_CTRL_PIN_SW,
+                           AD9834_CTRL_PIN_SW | AD9834_CTRL_FSEL | AD9834_CTRL_PSEL);
+    DDSShadowAD9834SetFreq(shadow, 0, DDSTuningFreqWord(tuning, freq0Q32));
+    DDSShadowAD9834SetFreq(shadow, 1, DDSTuningFreqWord(tuning, freq1Q32));
+    DDSShadowAD9834SetPhase(shadow, 0, phase0);
+    DDSShadowAD9834SetPhase(shadow, 1, phase1);
+
+    origin = RecordOrigin(&g_record, RECORD_ORIGIN_MOD);
+    queued = DDSShadowAD9834Queue(shadow, &g_ssiStreams[SSISTREAM_AD9834]);
+    RecordOrigin(&g_record, origin);
+
+    return queued;
+
+}
+
+//************************************************************************************
+//
+// PHASE1 word that scales a summed output by ratioPermille / 1000.  Configuration
+// time only, so the libm call is acceptable.
+//
+//************************************************************************************
+uint32_t ModulationAskPhase(const tDDSTuning *tuning, uint32_t ratioPermille) {
+
+    double turns;
+
+    if (ratioPermille > 1000) {
+
+        ratioPermille = 1000;
+
+    }
+
+    //
+    // |1 + e^(j*phi)| / 2 = cos(phi / 2), so phi = 2 * acos(ratio); in turns that
+    // is acos(ratio) / pi.
+    //
+    turns = acos((double)ratioPermille / 1000.0) / 3.14159265358979323846;
+
+    return DDSTuningPhaseWord(tuning, (uint16_t)(turns * 65535.0 + 0.5));
+
+}
+
+//************************************************************************************
+//
+// Select the mode and bitstream.  Returns false for an unknown mode, an empty
+// bitstream or while the modulator is running.
+//
+//************************************************************************************
+bool ModulationConfigure(tModulator *mod, uint32_t mode, const uint8_t *bits,
+                         uint32_t bitCount, uint32_t symbolCycles, bool repeat) {
+
+    if ((mod->running) || (bits == 0) || (bitCount == 0) || (symbolCycles == 0)) {
+
+        return false;
+
+    }
+
+    switch (mode) {
+
+        case MOD_MODE_FSK:
+
+            mod->bitsPerSymbol = 1;
+            mod->symbolPins[0] = 0;
+            mod->symbolPins[1] = MOD_FSELECT;
+            break;
+
+        case MOD_MODE_PSK:
+        case MOD_MODE_ASK_PHASE:
+
+            mod->bitsPerSymbol = 1;
+            mod->symbolPins[0] = 0;
+            mod->symbolPins[1] = MOD_PSELECT;
+            break;
+
+        case MOD_MODE_QUAD:
+
+            mod->bitsPerSymbol = 2;
+            mod->symbolPins[0] = 0;
+            mod->symbolPins[1] = MOD_FSELECT;
+            mod->symbolPins[2] = MOD_PSELECT;
+            mod->symbolPins[3] = MOD_FSELECT | MOD_PSELECT;
+            break;
+
+        default:
+
+            return false;
+
+    }
+
+    mod->mode = mode;
+    mod->bits = bits;
+    mod->bitCount = bitCount - (bitCount % mod->bitsPerSymbol);
+    mod->symbolCycles = symbolCycles;
+    mod->repeat = repeat;
+    mod->bitPos = 0;
+    mod->underruns = 0;
+    mod->symbolsGenerated = 0;
+
+    return mod->bitCount != 0;
+
+}
+
+//************************************************************************************
+//
+// Expand the next count symbols into pin states.  Once a one-shot bitstream is
+// exhausted the idle symbol (both pins low) is emitted.  Returns count.
+//
+//************************************************************************************
+uint32_t ModulationExpand(tModulator *mod, uint8_t *pins, uint32_t count) {
+
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+
+        uint32_t symbol;
+        uint32_t pos = mod->bitPos;
+
+        if (pos >= mod->bitCount) {
+
+            if (!mod->repeat) {
+
+                pins[i] = mod->symbolPins[0];
+                continue;
+
+            }
+
+            pos = 0;
+
+        }
+
+        symbol = (mod->bits[pos >> 3] >> (7 - (pos & 7))) & 1;
+
+        if (mod->bitsPerSymbol == 2) {
+
+            //
+            // Two bits per symbol never straddle a byte because bitPos stays even.
+            //
+            symbol = (symbol << 1) | ((mod->bits[pos >> 3] >> (6 - (pos & 7))) & 1);
+
+        }
+
+        pins[i] = mod->symbolPins[symbol];
+        mod->bitPos = pos + mod->bitsPerSymbol;
+
+    }
+
+    mod->symbolsGenerated += count;
+
+    return count;
+
+}
+
+//************************************************************************************
+//
+// Refill task, run twice per block period.
+//
+//************************************************************************************
+static void ModulationRefillTask(tSchedTask *task, uint64_t now) {
+
+    tModulator *mod = (tModulator *)task->arg;
+    uint32_t halfBlockUs;
+    PROFILE_BEGIN(PROFILE_ID_MOD_REFILL);
+
+    (void)now;
+
+    if (!mod->running) {
+
+        return;
+
+    }
+
+    ModulationRefill(mod);
+    PROFILE_END(PROFILE_ID_MOD_REFILL);
+
+    halfBlockUs = (uint32_t)(((uint64_t)mod->symbolCycles * (MOD_BLOCK_SYMBOLS / 2)) /
+                             g_timeBase.cyclesPerUs);
+    SchedulerDefer(task, halfBlockUs ? halfBlockUs : 1);
+
+}
+
+bool ModulationStart(tModulator *mod) {
+
+    if (mod->running) {
+
+        return false;
+
+    }
+
+    mod->bitPos = 0;
+    ModulationExpand(mod, mod->table[0], MOD_BLOCK_SYMBOLS);
+    ModulationExpand(mod, mod->table[1], MOD_BLOCK_SYMBOLS);
+
+    mod->blocksFilled = 2;
+    mod->blocksDone = 0;
+    mod->running = true;
+
+    SchedulerTaskInit(&mod->refillTask, ModulationRefillTask, mod);
+    SchedulerAdd(&mod->refillTask, TimeBaseMicros());
+
+    ModulationPortStart(mod);
+
+    return true;
+
+}
+
+void ModulationStop(tModulator *mod) {
+
+    if (!mod->running) {
+
+        return;
+
+    }
+
+    ModulationPortStop(mod);
+    SchedulerRemove(&mod->refillTask);
+    mod->running = false;
+
+}
+
+//************************************************************************************
+//
+// Regenerate every buffer the uDMA has finished since the last call; block n lives
+// in table[n & 1].
+//
+//************************************************************************************
+void ModulationRefill(tModulator *mod) {
+
+    uint32_t consumed = mod->blocksDone + 2 - mod->blocksFilled;
+
+    if (consumed >= 2) {
+
+        mod->underruns++;
+
+    }
+
+    while (consumed--) {
+
+        ModulationExpand(mod, mod->table[mod->blocksFilled & 1], MOD_BLOCK_SYMBOLS);
+        mod->blocksFilled++;
+
+    }
+
+}
+
+void ModulationBlockDone(tModulator *mod) {
+
+    mod->blocksDone++;
+
+}
@@ -0,0 +1,162 @@
+//************************************************************************************
+//
+// Title:               Pin-Switched Modulation
+// Author:              Jacob Putz
+// Filename:            Modulation.h
+//
+// Description:     FSK, PSK and two-level ASK on the AD9834 by driving its FSELECT
+//                      and PSELECT pins.  Both frequency and phase banks are loaded
+//                      over SPI ahead of time; the bitstream is expanded into GPIO pin
+//                      states in a double-buffered table that a GPTM timeout moves to
+//                      the GPIO data register with the uDMA, one symbol per request.
+//                      The CPU only regenerates table blocks.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Point at the symbol timing check.
+//
+// 0.1.1    -       Add MOD_PERIPHS.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef MODULATION_H_
+#define MODULATION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "Scheduler.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Mode            Bits/symbol     Symbol bit 0    Symbol bit 1
+//  FSK             1               FSELECT         -
+//  PSK             1               PSELECT         -
+//  QUAD            2               FSELECT         PSELECT
+//  ASK_PHASE       1               PSELECT         -
+//
+//  ASK_PHASE is amplitude keying for an output that is summed with a reference
+//  at the same frequency: switching this channel's phase between 0 and phi
+//  changes the sum's amplitude by cos(phi / 2).  ModulationAskPhase() returns the
+//  PHASE1 offset for a requested amplitude ratio.
+//
+//  Bits are taken MSB first from each byte of the bitstream.
+//
+//  Host/Tools/ModTool.c runs the modulator on the simulated HAL and checks every
+//  select line change against the bitstream, to the cycle.
+//
+//************************************************************************************
+
+// Defines
+//
+// FSELECT/PSELECT pins on Port K.  Same values as GPIO_PIN_0/GPIO_PIN_1, spelled
+// out so the portable core does not need driverlib.
+#define     MOD_FSELECT             0x01        // PK0
+#define     MOD_PSELECT             0x02        // PK1
+
+// Peripherals ModulationPortInit() brings up: the select lines, Timer 1 pacing the
+// symbols and the uDMA moving them
+#define     MOD_PERIPHS             (HAL_PERIPH_GPIO(HAL_PORT_K) |                        \
+                                     HAL_PERIPH_TIMER(HAL_TIMER_1) | HAL_PERIPH_UDMA)
+
+// Symbols per table block (one uDMA control structure)
+#define     MOD_BLOCK_SYMBOLS       1024
+
+// Modes
+#define     MOD_MODE_FSK            0
+#define     MOD_MODE_PSK            1
+#define     MOD_MODE_QUAD           2
+#define     MOD_MODE_ASK_PHASE      3
+
+// Type Definitions
+typedef struct {
+
+    //
+    // Configuration
+    //
+    uint32_t mode;
+    uint32_t bitsPerSymbol;
+    uint32_t symbolCycles;          // Symbol period in system clock cycles
+    uint8_t symbolPins[4];          // Pin states for each symbol value
+    const uint8_t *bits;
+    uint32_t bitCount;
+    bool repeat;
+
+    //
+    // Generator state (thread)
+    //
+    uint32_t bitPos;
+    uint32_t blocksFilled;
+
+    //
+    // Output state
+    //
+    uint8_t table[2][MOD_BLOCK_SYMBOLS];
+    volatile uint32_t blocksDone;   // Written by the block interrupt only
+    volatile bool running;
+    tSchedTask refillTask;
+
+    //
+    // Statistics
+    //
+    uint32_t underruns;
+    uint32_t symbolsGenerated;
+
+} tModulator;
+
+// Global Variables
+//
+// The modulator owns Timer 1A, so there is a single instance.
+//
+extern tModulator g_modulator;
+
+// Function Prototypes
+//
+// Portable core (Modulation.c)
+//
+extern bool ModulationLoadBanks(const tDDSTuning *tuning, uint64_t freq0Q32,
+                                uint64_t freq1Q32, uint32_t phase0, uint32_t phase1);
+extern uint32_t ModulationAskPhase(const tDDSTuning *tuning, uint32_t ratioPermille);
+extern bool ModulationConfigure(tModulator *mod, uint32_t mode, const uint8_t *bits,
+                                uint32_t bitCount, uint32_t symbolCycles, bool repeat);
+extern uint32_t ModulationExpand(tModulator *mod, uint8_t *pins, uint32_t count);
+extern bool ModulationStart(tModulator *mod);
+extern void ModulationStop(tModulator *mod);
+extern void ModulationRefill(tModulator *mod);
+extern void ModulationBlockDone(tModulator *mod);
+
+//
+// Port layer (ModulationTiva.c on target, Host/ModulationHost.c on a host)
+//
+extern void ModulationPortInit(uint32_t sysClkHz);
+extern void ModulationPortStart(tModulator *mod);
+extern void ModulationPortStop(tModulator *mod);
+
+#endif /* MODULATION_H_ */
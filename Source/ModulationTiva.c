@@ -0,0 +1,189 @@
+//************************************************************************************
+//
+// Title:               Pin-Switched Modulation - TM4C1294 Port
+// Author:              Jacob Putz
+// Filename:            ModulationTiva.c
+//
+// Description:     Timer 1A, uDMA and Port K port for Modulation.c.  Each Timer 1A
+//                      timeout raises a single uDMA request that copies one byte from
+//                      the symbol table to the Port K data register through the
+//                      FSELECT/PSELECT address mask, so symbol edges are timed by
+//                      hardware and other Port K pins are untouched.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Wait only for the peripherals to be ready; their clocks are
+//                  enabled at boot.
+//
+// 0.1.1    -       Drive the select lines to the shadow's selection at start-up.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_gpio.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+#include "AD9834.h"
+#include "DDSShadow.h"
+#include "DMAControl.h"
+#include "Hal.h"
+#include "Profile.h"
+#include "Modulation.h"
+
+// Defines
+#define     MOD_PORT                GPIO_PORTK_BASE
+#define     MOD_TIMER_BASE          TIMER1_BASE
+#define     MOD_TIMER_INT           INT_TIMER1A
+#define     MOD_DMA_CHANNEL         20
+#define     MOD_DMA_ASSIGN          UDMA_CH20_TIMER1A
+
+//
+// Writes to DATA + (mask << 2) only affect the pins in mask.
+//
+#define     MOD_PIN_DATA            (MOD_PORT + GPIO_O_DATA +                       \
+                                     ((MOD_FSELECT | MOD_PSELECT) << 2))
+
+//************************************************************************************
+//
+// Block-complete interrupt.  Re-arm the finished structure with its own buffer and
+// let ModulationRefill() regenerate it.  The periodic timer has already reloaded,
+// so (load - value) is the entry latency.
+//
+//************************************************************************************
+static void ModulationTimerHandler(void) {
+
+    tModulator *mod = &g_modulator;
+    PROFILE_ISR_ENTER(PROFILE_ID_MOD_BLOCK);
+
+    TimerIntClear(MOD_TIMER_BASE, TIMER_TIMA_DMA);
+
+    if (uDMAChannelModeGet(MOD_DMA_CHANNEL | UDMA_PRI_SELECT) == UDMA_MODE_STOP) {
+
+        uDMAChannelTransferSet(MOD_DMA_CHANNEL | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+                               mod->table[0], (void *)MOD_PIN_DATA, MOD_BLOCK_SYMBOLS);
+        ModulationBlockDone(mod);
+
+    }
+
+    if (uDMAChannelModeGet(MOD_DMA_CHANNEL | UDMA_ALT_SELECT) == UDMA_MODE_STOP) {
+
+        uDMAChannelTransferSet(MOD_DMA_CHANNEL | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+                               mod->table[1], (void *)MOD_PIN_DATA, MOD_BLOCK_SYMBOLS);
+        ModulationBlockDone(mod);
+
+    }
+
+    PROFILE_ISR_EXIT(PROFILE_ID_MOD_BLOCK, TimerLoadGet(MOD_TIMER_BASE, TIMER_A) -
+                     TimerValueGet(MOD_TIMER_BASE, TIMER_A));
+
+}
+
+void ModulationPortInit(uint32_t sysClkHz) {
+
+    (void)sysClkHz;
+
+    DMAControlInit();
+
+    //
+    // Enabled at boot (Boot.h); wait until they can be accessed
+    //
+    HalPeriphReady(MOD_PERIPHS);
+
+    //
+    // Configure GPIO Type
+    //
+    GPIOPinTypeGPIOOutput(MOD_PORT, MOD_FSELECT | MOD_PSELECT);
+
+    //
+    // Set GPIO Direction
+    //
+    GPIODirModeSet(MOD_PORT, MOD_FSELECT | MOD_PSELECT, GPIO_DIR_MODE_OUT);
+
+    //
+    // Configure GPIO Pad Properties
+    //
+    GPIOPadConfigSet(MOD_PORT, MOD_FSELECT | MOD_PSELECT, GPIO_STRENGTH_8MA,
+                     GPIO_PIN_TYPE_STD);
+
+    //
+    // Hold the selection the shadow has: low after a cold start, the restored one
+    // after a fault restart (Fault.h), so the output does not change bank here.
+    //
+    GPIOPinWrite(MOD_PORT, MOD_FSELECT | MOD_PSELECT,
+                 (((g_ad9834Shadow.pins & AD9834_CTRL_FSEL) != 0) ? MOD_FSELECT : 0) |
+                 (((g_ad9834Shadow.pins & AD9834_CTRL_PSEL) != 0) ? MOD_PSELECT : 0));
+
+    //
+    // Timer 1A as a 32-bit periodic uDMA trigger
+    //
+    TimerConfigure(MOD_TIMER_BASE, TIMER_CFG_PERIODIC);
+    TimerDMAEventSet(MOD_TIMER_BASE, TIMER_DMA_TIMEOUT_A);
+    TimerIntRegister(MOD_TIMER_BASE, TIMER_A, ModulationTimerHandler);
+    IntEnable(MOD_TIMER_INT);
+
+    uDMAChannelAssign(MOD_DMA_ASSIGN);
+    uDMAChannelAttributeDisable(MOD_DMA_CHANNEL, UDMA_ATTR_ALL);
+    uDMAChannelControlSet(MOD_DMA_CHANNEL | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    uDMAChannelControlSet(MOD_DMA_CHANNEL | UDMA_ALT_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+
+}
+
+void ModulationPortStart(tModulator *mod) {
+
+    uDMAChannelTransferSet(MOD_DMA_CHANNEL | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+                           mod->table[0], (void *)MOD_PIN_DATA, MOD_BLOCK_SYMBOLS);
+    uDMAChannelTransferSet(MOD_DMA_CHANNEL | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+                           mod->table[1], (void *)MOD_PIN_DATA, MOD_BLOCK_SYMBOLS);
+    uDMAChannelEnable(MOD_DMA_CHANNEL);
+
+    TimerLoadSet(MOD_TIMER_BASE, TIMER_A, mod->symbolCycles - 1);
+    TimerIntClear(MOD_TIMER_BASE, TIMER_TIMA_DMA);
+    TimerIntEnable(MOD_TIMER_BASE, TIMER_TIMA_DMA);
+    TimerEnable(MOD_TIMER_BASE, TIMER_A);
+
+}
+
+void ModulationPortStop(tModulator *mod) {
+
+    (void)mod;
+
+    TimerDisable(MOD_TIMER_BASE, TIMER_A);
+    TimerIntDisable(MOD_TIMER_BASE, TIMER_TIMA_DMA);
+    uDMAChannelDisable(MOD_DMA_CHANNEL);
+    GPIOPinWrite(MOD_PORT, MOD_FSELECT | MOD_PSELECT, 0x0);
+
+}
@@ -0,0 +1,200 @@
+//************************************************************************************
+//
+// Title:               Power Manager
+// Author:              Jacob Putz
+// Filename:            Power.c
+//
+// Description:     Sleep state selection, hold bits, relock budget and the decision
+//                      log.  The sleep itself is done by the scheduler port through the
+//                      HAL.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+// Global Variables
+tPower g_power;
+
+void PowerInit(void) {
+
+    uint32_t i;
+
+    g_power.holds = 0;
+    g_power.relockUs = POWER_RELOCK_US;
+    g_power.logHead = 0;
+    g_power.lateWakes = 0;
+    g_power.marginMinUs = 0x7FFFFFFF;
+
+    for (i = 0; i < POWER_STATE_COUNT; i++) {
+
+        g_power.decisions[i] = 0;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Hold bits may be set from thread or interrupt context, so the read-modify-write
+// is done with interrupts masked.
+//
+//************************************************************************************
+void PowerHold(uint32_t reason) {
+
+    bool wasMasked = HalIntMasterDisable();
+
+    g_power.holds |= reason;
+
+    if (!wasMasked) {
+
+        HalIntMasterEnable();
+
+    }
+
+}
+
+void PowerRelease(uint32_t reason) {
+
+    bool wasMasked = HalIntMasterDisable();
+
+    g_power.holds &= ~reason;
+
+    if (!wasMasked) {
+
+        HalIntMasterEnable();
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Hold bits that currently rule out deep sleep, the running engines included.
+//
+//************************************************************************************
+static uint32_t PowerHolds(void) {
+
+    uint32_t holds = g_power.holds;
+
+    if (g_sweep.running || g_modulator.running ||
+        !SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9834]) ||
+        !SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9952])) {
+
+        holds |= POWER_HOLD_BUSY;
+
+    }
+
+    return holds;
+
+}
+
+//************************************************************************************
+//
+// Pick a state for the gap from now to deadline and log it.  Called with
+// interrupts masked by the sleep port, just before it sleeps.
+//
+//************************************************************************************
+uint32_t PowerDecide(uint64_t now, uint64_t deadline) {
+
+    uint64_t gap = deadline - now;
+    tPowerLogEntry *entry = &g_power.log[g_power.logHead & POWER_LOG_MASK];
+    uint32_t holds = 0;
+    uint32_t state;
+
+    if (gap < (POWER_DEEP_MIN_US + g_power.relockUs)) {
+
+        state = POWER_STATE_SLEEP;
+
+    }
+
+    else {
+
+        holds = PowerHolds();
+        state = (holds == 0) ? POWER_STATE_DEEP : POWER_STATE_SLEEP;
+
+    }
+
+    entry->timeUs = (uint32_t)now;
+    entry->gapUs = (gap > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)gap;
+    entry->marginUs = 0;
+    entry->state = (uint16_t)state;
+    entry->holds = (uint16_t)holds;
+    g_power.logHead++;
+    g_power.decisions[state]++;
+
+    return state;
+
+}
+
+//************************************************************************************
+//
+// Record how the wake went.  A late deep wake raises the relock budget by the
+// overshoot.
+//
+//************************************************************************************
+void PowerWoke(uint32_t state, uint64_t deadline, uint64_t now) {
+
+    int64_t margin = (int64_t)deadline - (int64_t)now;
+    tPowerLogEntry *entry = &g_power.log[(g_power.logHead - 1) & POWER_LOG_MASK];
+
+    entry->marginUs = (margin < -0x7FFFFFFFLL) ? -0x7FFFFFFF : (int32_t)margin;
+
+    if (state != POWER_STATE_DEEP) {
+
+        return;
+
+    }
+
+    if (entry->marginUs < g_power.marginMinUs) {
+
+        g_power.marginMinUs = entry->marginUs;
+
+    }
+
+    if (margin < 0) {
+
+        g_power.lateWakes++;
+        g_power.relockUs += (uint32_t)-entry->marginUs;
+
+        if (g_power.relockUs > POWER_RELOCK_MAX_US) {
+
+            g_power.relockUs = POWER_RELOCK_MAX_US;
+
+        }
+
+    }
+
+}
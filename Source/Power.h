@@ -0,0 +1,135 @@
+//************************************************************************************
+//
+// Title:               Power Manager
+// Author:              Jacob Putz
+// Filename:            Power.h
+//
+// Description:     Chooses how to spend each gap the scheduler hands to the sleep
+//                      port: WFI sleep, or deep sleep with the PLL down and
+//                      peripheral clocks gated.  Deep sleep is only taken when the gap
+//                      pays for the relock and nothing that needs the full system clock
+//                      is running.  Every decision goes into a small log.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Point to the host check.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  For a gap of g microseconds to the next deadline:
+//
+//      g < POWER_DEEP_MIN_US + relockUs, or held   SLEEP   WFI, every clock running
+//      otherwise                                   DEEP    HalDeepSleep()
+//
+//  WFI costs a handful of cycles on the M4, so there is no spin state: even the
+//  shortest gap is slept through.
+//
+//  Deep sleep wakes relockUs ahead of the deadline so the PLL is locked again
+//  when the deadline comes due.  The budget starts at POWER_RELOCK_US and is
+//  raised by the overshoot whenever a deep wake comes back late, so a slow
+//  relock costs one late deadline rather than one per sleep.
+//
+//  The sweep, hop and modulation engines and the SSI streams run from the system
+//  clock through uDMA and timers, so deep sleep is refused while any of them is
+//  busy.  Other modules that need it refused (the remote link while traffic is
+//  flowing) set a hold bit.
+//
+//  Host/Tools/PowerTool.c runs idle, burst and continuous workloads against
+//  these rules and a slow relock against the budget, and ranks their energy.
+//
+//************************************************************************************
+
+// Defines
+//
+// Power states
+#define     POWER_STATE_SLEEP       0
+#define     POWER_STATE_DEEP        1
+#define     POWER_STATE_COUNT       2
+
+// Decision thresholds
+#define     POWER_DEEP_MIN_US       3000        // Deep sleep has to pay for the relock
+#define     POWER_RELOCK_US         500         // Initial relock budget
+#define     POWER_RELOCK_MAX_US     2000
+
+// Reasons to refuse deep sleep (PowerHold())
+#define     POWER_HOLD_REMOTE       0x0001
+#define     POWER_HOLD_CALIB        0x0002      // Edge counter runs from the system clock
+#define     POWER_HOLD_BUSY         0x8000      // Logged only: an engine was running
+
+// Decision log (power of two)
+#define     POWER_LOG_SIZE          64
+#define     POWER_LOG_MASK          (POWER_LOG_SIZE - 1)
+
+// Type Definitions
+typedef struct {
+
+    uint32_t timeUs;                // Low word of TimeBaseMicros() at the decision
+    uint32_t gapUs;                 // Time to the deadline
+    int32_t marginUs;               // Deadline minus wake time (negative is late)
+    uint16_t state;                 // POWER_STATE_*
+    uint16_t holds;                 // Hold bits when deep sleep was refused
+
+} tPowerLogEntry;
+
+typedef struct {
+
+    volatile uint32_t holds;
+    uint32_t relockUs;              // Current relock budget
+
+    tPowerLogEntry log[POWER_LOG_SIZE];
+    uint32_t logHead;               // Running count; the newest entry is head - 1
+
+    //
+    // Statistics
+    //
+    uint32_t decisions[POWER_STATE_COUNT];
+    uint32_t lateWakes;             // Deep wakes after their deadline
+    int32_t marginMinUs;            // Worst deep-sleep wake margin
+
+} tPower;
+
+// Global Variables
+extern tPower g_power;
+
+// Function Prototypes
+extern void PowerInit(void);
+extern void PowerHold(uint32_t reason);
+extern void PowerRelease(uint32_t reason);
+extern uint32_t PowerDecide(uint64_t now, uint64_t deadline);
+extern void PowerWoke(uint32_t state, uint64_t deadline, uint64_t now);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,351 @@
+//************************************************************************************
+//
+// Title:               Flash Preset Store
+// Author:              Jacob Putz
+// Filename:            Preset.c
+//
+// Description:     Image validation, indexed lookup and in-place playback.
+//                      Portable; the image location comes from PresetPortImage().
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Check element counts against the image without forming their
+//                  byte sizes, which could wrap.
+//
+// 0.1.3    -       Attribute preset writes in the command trace.
+//
+// 0.1.2    -       Size records through the DDSChip front end and reject parts not
+//                  built.
+//
+// 0.1.1    -       Invalidate the shadow after a preset's setup frames.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "Modulation.h"
+#include "Preset.h"
+#include "Profile.h"
+#include "Record.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+// Global Variables
+const tPresetImage *g_presetImage = 0;
+
+//************************************************************************************
+//
+// True if [offset, offset + bytes) lies inside the image.  Written so neither sum
+// can overflow.
+//
+//************************************************************************************
+static bool PresetInRange(const tPresetImage *image, uint32_t offset, uint32_t bytes) {
+
+    return (offset <= image->imageSize) && (bytes <= (image->imageSize - offset));
+
+}
+
+//************************************************************************************
+//
+// True if count elements of elemBytes each fit at offset.  The count is compared
+// with what the space holds rather than multiplied out, so a huge count cannot
+// wrap into a small size.
+//
+//************************************************************************************
+static bool PresetFits(const tPresetImage *image, uint32_t offset, uint32_t count,
+                       uint32_t elemBytes) {
+
+    return (offset <= image->imageSize) &&
+           (count <= ((image->imageSize - offset) / elemBytes));
+
+}
+
+static bool PresetCheck(const tPresetImage *image, const tPreset *preset) {
+
+    uint32_t blockElems;
+
+    if (!DDSChipBuilt(preset->instance) || (preset->stepCycles == 0) ||
+        (preset->setupCount > SSISTREAM_RING_SIZE) || ((preset->setupOffset & 1) != 0) ||
+        !PresetFits(image, preset->setupOffset, preset->setupCount, 2) ||
+        ((preset->dataOffset & 3) != 0) || (preset->dataCount == 0)) {
+
+        return false;
+
+    }
+
+    switch (preset->type) {
+
+        case PRESET_TYPE_SWEEP:
+        case PRESET_TYPE_HOP:
+
+            blockElems = SWEEP_BLOCK_STEPS * DDSChipStepElems(preset->instance);
+
+            return (preset->stepCycles <= SWEEP_STEP_CYCLES_MAX) &&
+                   ((preset->dataCount % blockElems) == 0) &&
+                   PresetFits(image, preset->dataOffset, preset->dataCount, 2);
+
+        //
+        // dataCount is in bits; the byte count is rounded up without adding 7.
+        //
+        case PRESET_TYPE_MOD:
+
+            return (preset->instance == SSISTREAM_AD9834) &&
+                   (preset->mode <= MOD_MODE_ASK_PHASE) &&
+                   PresetInRange(image, preset->dataOffset,
+                                 (preset->dataCount >> 3) + ((preset->dataCount & 7) != 0));
+
+        default:
+
+            return false;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Locate and validate the image.  Returns false (and leaves g_presetImage at 0) if
+// there is no usable image, which is not an error for the rest of the firmware.
+//
+//************************************************************************************
+bool PresetInit(void) {
+
+    const tPresetImage *image = PresetPortImage();
+
+    g_presetImage = PresetValidate(image, PRESET_FLASH_SIZE) ? image : 0;
+
+    return g_presetImage != 0;
+
+}
+
+//************************************************************************************
+//
+// Full structural check: header, CRC, index order and every preset's ranges.  Runs
+// once at start-up (and in the host tool) so lookups and playback can trust the
+// image afterwards.
+//
+//************************************************************************************
+bool PresetValidate(const tPresetImage *image, uint32_t maxSize) {
+
+    const tPresetIndex *index;
+    uint32_t i;
+
+    if ((image == 0) || (image->magic != PRESET_MAGIC) ||
+        (image->versionMajor != PRESET_VERSION_MAJOR) || (image->imageSize > maxSize) ||
+        (image->imageSize < sizeof(tPresetImage)) ||
+        (image->count > ((image->imageSize - sizeof(tPresetImage)) /
+                         sizeof(tPresetIndex)))) {
+
+        return false;
+
+    }
+
+    if (Crc32(CRC32_INIT, (const uint8_t *)image + sizeof(tPresetImage),
+              image->imageSize - sizeof(tPresetImage)) != image->crc) {
+
+        return false;
+
+    }
+
+    index = (const tPresetIndex *)(image + 1);
+
+    for (i = 0; i < image->count; i++) {
+
+        if (((i != 0) && (index[i].id <= index[i - 1].id)) ||
+            ((index[i].offset & 3) != 0) ||
+            !PresetInRange(image, index[i].offset, sizeof(tPreset)) ||
+            !PresetCheck(image, PresetAt(image, i))) {
+
+            return false;
+
+        }
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Binary search of the sorted index.  Returns 0 if id is not present.
+//
+//************************************************************************************
+const tPreset *PresetFind(const tPresetImage *image, uint32_t id) {
+
+    const tPresetIndex *index;
+    uint32_t lo = 0;
+    uint32_t hi;
+
+    if (image == 0) {
+
+        return 0;
+
+    }
+
+    index = (const tPresetIndex *)(image + 1);
+    hi = image->count;
+
+    while (lo < hi) {
+
+        uint32_t mid = lo + ((hi - lo) >> 1);
+
+        if (index[mid].id < id) {
+
+            lo = mid + 1;
+
+        }
+
+        else {
+
+            hi = mid;
+
+        }
+
+    }
+
+    if ((lo < image->count) && (index[lo].id == id)) {
+
+        return PresetAt(image, lo);
+
+    }
+
+    return 0;
+
+}
+
+const tPreset *PresetAt(const tPresetImage *image, uint32_t index) {
+
+    const tPresetIndex *entry = (const tPresetIndex *)(image + 1) + index;
+
+    return (const tPreset *)PresetPayload(image, entry->offset);
+
+}
+
+const void *PresetPayload(const tPresetImage *image, uint32_t offset) {
+
+    return (const uint8_t *)image + offset;
+
+}
+
+//************************************************************************************
+//
+// Queue the setup frames, then start playback with the data read in place.  The
+// sweep engine needs the SSI stream idle, so this waits for the setup frames to
+// drain (a handful of frames, a few microseconds at 20 MHz).
+//
+//************************************************************************************
+bool PresetPlay(const tPresetImage *image, const tPreset *preset) {
+
+    tSSIStream *stream = &g_ssiStreams[preset->instance];
+    const void *data = PresetPayload(image, preset->dataOffset);
+    bool repeat = (preset->flags & PRESET_FLAG_REPEAT) != 0;
+    bool started = false;
+    uint32_t origin = RecordOrigin(&g_record, RECORD_ORIGIN_PRESET);
+    PROFILE_BEGIN(PROFILE_ID_PRESET_LOAD);
+
+    if (preset->setupCount != 0) {
+
+        if (!SSIStreamQueue(stream, PresetPayload(image, preset->setupOffset),
+                            preset->setupCount)) {
+
+            RecordOrigin(&g_record, origin);
+            return false;
+
+        }
+
+        while (!SSIStreamIdle(stream)) {
+
+            // Wait for the setup frames to go out.
+
+        }
+
+        if (preset->instance == SSISTREAM_AD9834) {
+
+            DDSShadowAD9834Forget(&g_ad9834Shadow, DDSSHADOW_AD9834_ALL);
+
+        }
+
+        else {
+
+            DDSShadowAD9952Forget(&g_ad9952Shadow, DDSSHADOW_AD9952_ALL);
+
+        }
+
+    }
+
+    switch (preset->type) {
+
+        case PRESET_TYPE_SWEEP:
+        case PRESET_TYPE_HOP:
+
+            started = SweepStartXip(&g_sweep, preset->instance, (const uint16_t *)data,
+                                    preset->dataCount / (SWEEP_BLOCK_STEPS *
+                                        DDSChipStepElems(preset->instance)),
+                                    preset->stepCycles, repeat);
+            break;
+
+        case PRESET_TYPE_MOD:
+
+            started = ModulationConfigure(&g_modulator, preset->mode,
+                                          (const uint8_t *)data, preset->dataCount,
+                                          preset->stepCycles, repeat) &&
+                      ModulationStart(&g_modulator);
+            break;
+
+        default:
+
+            break;
+
+    }
+
+    PROFILE_END(PROFILE_ID_PRESET_LOAD);
+    RecordOrigin(&g_record, origin);
+
+    return started;
+
+}
+
+void PresetStop(const tPreset *preset) {
+
+    if (preset->type == PRESET_TYPE_MOD) {
+
+        ModulationStop(&g_modulator);
+
+    }
+
+    else {
+
+        SweepStop(&g_sweep);
+
+    }
+
+}
@@ -0,0 +1,157 @@
+//************************************************************************************
+//
+// Title:               Flash Preset Store
+// Author:              Jacob Putz
+// Filename:            Preset.h
+//
+// Description:     Versioned binary image of waveform presets (sweeps, hop lists
+//                      and modulation patterns) kept in the PRESETS flash region, with
+//                      a sorted index for binary-search lookup.  Sweep and hop presets
+//                      are stored as ready-to-send SSI step records and played in place
+//                      by the sweep engine; modulation bitstreams are read in place by
+//                      the modulator.  Nothing is copied to SRAM.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef PRESET_H_
+#define PRESET_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  Image layout (little-endian, every structure 4-byte aligned):
+//
+//      tPresetImage                header; crc covers everything after it
+//      tPresetIndex[count]         sorted by strictly increasing id
+//      tPreset, setup, data ...    one per preset, in any order
+//
+//  All offsets are from the start of the image.  Setup elements are SSI frames
+//  queued through the SSI stream before playback starts (control word, register
+//  banks).  Data is:
+//
+//      SWEEP / HOP     whole blocks of SWEEP_BLOCK_STEPS step records; dataCount
+//                      is the number of 16-bit elements
+//      MOD             packed bitstream, MSB first; dataCount is the bit count
+//
+//  Tuning words are baked against the nominal reference clock when the image is
+//  built (Host/PresetTool.c).  The uDMA on the TM4C129 can read flash, so step
+//  records go from the PRESETS region to the SSI with no intermediate copy.
+//
+//  A reader accepts any image with the same major version; minor versions only
+//  add fields in space that older readers ignore.
+//
+//************************************************************************************
+
+// Defines
+//
+// Flash region reserved in tm4c1294ncpdt.cmd
+#define     PRESET_FLASH_BASE       0x000C0000
+#define     PRESET_FLASH_SIZE       0x00040000
+
+// Image header
+#define     PRESET_MAGIC            0x50534444      // "DDSP"
+#define     PRESET_VERSION_MAJOR    1
+#define     PRESET_VERSION_MINOR    0
+
+// Preset types
+#define     PRESET_TYPE_SWEEP       1
+#define     PRESET_TYPE_HOP         2
+#define     PRESET_TYPE_MOD         3
+
+// Preset flags
+#define     PRESET_FLAG_REPEAT      0x0001
+
+#define     PRESET_NAME_LEN         16
+
+// Preset started by main() when the image has one
+#define     PRESET_BOOT_ID          0
+
+// Type Definitions
+typedef struct {
+
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    uint32_t count;                 // Number of presets (index entries)
+    uint32_t imageSize;             // Bytes, header included
+    uint32_t crc;                   // Crc32() of bytes [sizeof(tPresetImage), imageSize)
+    uint32_t reserved[3];
+
+} tPresetImage;
+
+typedef struct {
+
+    uint32_t id;
+    uint32_t offset;                // Offset of the tPreset
+
+} tPresetIndex;
+
+typedef struct {
+
+    uint16_t type;                  // PRESET_TYPE_*
+    uint16_t instance;              // SSISTREAM_AD9834 or SSISTREAM_AD9952
+    uint16_t flags;                 // PRESET_FLAG_*
+    uint16_t mode;                  // MOD_MODE_* for modulation presets
+    uint32_t stepCycles;            // Step or symbol period in system clock cycles
+    uint32_t setupOffset;
+    uint32_t setupCount;            // 16-bit SSI elements
+    uint32_t dataOffset;
+    uint32_t dataCount;             // Elements (SWEEP/HOP) or bits (MOD)
+    char name[PRESET_NAME_LEN];     // NUL padded, not necessarily terminated
+
+} tPreset;
+
+// Global Variables
+//
+// The validated image found by PresetInit(), or 0.
+//
+extern const tPresetImage *g_presetImage;
+
+// Function Prototypes
+//
+// Portable core (Preset.c)
+//
+extern bool PresetInit(void);
+extern bool PresetValidate(const tPresetImage *image, uint32_t maxSize);
+extern const tPreset *PresetFind(const tPresetImage *image, uint32_t id);
+extern const tPreset *PresetAt(const tPresetImage *image, uint32_t index);
+extern const void *PresetPayload(const tPresetImage *image, uint32_t offset);
+extern bool PresetPlay(const tPresetImage *image, const tPreset *preset);
+extern void PresetStop(const tPreset *preset);
+
+//
+// Port layer (PresetTiva.c on target, Host/PresetHost.c on a host build)
+//
+extern const tPresetImage *PresetPortImage(void);
+
+#endif /* PRESET_H_ */
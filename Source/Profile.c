@@ -0,0 +1,234 @@
+//************************************************************************************
+//
+// Title:               Cycle-Accurate Profiling
+// Author:              Jacob Putz
+// Filename:            Profile.c
+//
+// Description:     Region statistics, ISR histograms and the trace ring.  Empty
+//                      unless PROFILE_ENABLE is defined.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Profile.h"
+
+#if defined(PROFILE_ENABLE)
+
+// Global Variables
+tProfileRegion g_profileRegions[PROFILE_ID_COUNT];
+tProfileIsr g_profileIsrs[PROFILE_ID_COUNT];
+tProfileTrace g_profileTrace[PROFILE_TRACE_SIZE];
+
+static volatile uint32_t g_profileHead = 0;     // Next slot to claim (producers)
+static volatile uint32_t g_profileTail = 0;     // Next slot to read (consumer)
+static volatile uint32_t g_profileDropped = 0;
+
+//************************************************************************************
+//
+// Atomic post-increment.  Producers may be the main loop and any number of nested
+// interrupts, so the claim has to be a real read-modify-write; LDREX/STREX keeps it
+// lock-free on the M4.
+//
+//************************************************************************************
+static uint32_t ProfileClaim(volatile uint32_t *counter) {
+
+#if defined(__TI_ARM__)
+    uint32_t value;
+
+    do {
+
+        value = __ldrex((void *)counter);
+
+    } while (__strex(value + 1, (void *)counter));
+
+    return value;
+#else
+    return __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+#endif
+
+}
+
+static uint32_t ProfileBucket(uint32_t value) {
+
+    uint32_t bucket = 0;
+
+    while ((value != 0) && (bucket < (PROFILE_HIST_BUCKETS - 1))) {
+
+        value >>= 1;
+        bucket++;
+
+    }
+
+    return bucket;
+
+}
+
+void ProfileInit(void) {
+
+    uint32_t i, j;
+
+    for (i = 0; i < PROFILE_ID_COUNT; i++) {
+
+        g_profileRegions[i].count = 0;
+        g_profileRegions[i].min = 0xFFFFFFFF;
+        g_profileRegions[i].max = 0;
+        g_profileRegions[i].total = 0;
+
+        for (j = 0; j < PROFILE_HIST_BUCKETS; j++) {
+
+            g_profileIsrs[i].latency[j] = 0;
+            g_profileIsrs[i].duration[j] = 0;
+
+        }
+
+    }
+
+    for (i = 0; i < PROFILE_TRACE_SIZE; i++) {
+
+        g_profileTrace[i].seq = 0;
+
+    }
+
+    g_profileHead = 0;
+    g_profileTail = 0;
+    g_profileDropped = 0;
+
+}
+
+//************************************************************************************
+//
+// Region statistics are only ever updated from the region's own context, so plain
+// read-modify-write is safe here.
+//
+//************************************************************************************
+void ProfileRegionRecord(uint32_t id, uint32_t elapsed) {
+
+    tProfileRegion *region = &g_profileRegions[id];
+
+    region->count++;
+    region->total += elapsed;
+
+    if (elapsed < region->min) {
+
+        region->min = elapsed;
+
+    }
+
+    if (elapsed > region->max) {
+
+        region->max = elapsed;
+
+    }
+
+}
+
+void ProfileIsrRecord(uint32_t id, uint32_t latency, uint32_t duration) {
+
+    g_profileIsrs[id].latency[ProfileBucket(latency)]++;
+    g_profileIsrs[id].duration[ProfileBucket(duration)]++;
+    ProfileRegionRecord(id, duration);
+
+}
+
+//************************************************************************************
+//
+// Append a trace entry.  When the consumer has fallen a full ring behind, the entry
+// is dropped (and counted) rather than overwriting unread data.
+//
+//************************************************************************************
+void ProfileTrace(uint32_t id, uint32_t arg) {
+
+    uint32_t slot;
+    tProfileTrace *entry;
+
+    if ((g_profileHead - g_profileTail) >= PROFILE_TRACE_SIZE) {
+
+        g_profileDropped++;
+        return;
+
+    }
+
+    slot = ProfileClaim(&g_profileHead);
+    entry = &g_profileTrace[slot & PROFILE_TRACE_MASK];
+
+    entry->timestamp = ProfileNow();
+    entry->id = (uint16_t)id;
+    entry->arg = (uint16_t)arg;
+    entry->seq = slot + 1;
+
+}
+
+//************************************************************************************
+//
+// Single consumer (the UART drain or a debugger script).  Returns false when the
+// next entry has not been published yet.
+//
+//************************************************************************************
+bool ProfileTraceRead(tProfileTrace *entry) {
+
+    uint32_t tail = g_profileTail;
+    tProfileTrace *slot = &g_profileTrace[tail & PROFILE_TRACE_MASK];
+
+    if (slot->seq != (tail + 1)) {
+
+        return false;
+
+    }
+
+    entry->timestamp = slot->timestamp;
+    entry->id = slot->id;
+    entry->arg = slot->arg;
+    entry->seq = slot->seq;
+
+    g_profileTail = tail + 1;
+
+    return true;
+
+}
+
+uint32_t ProfileTraceDropped(void) {
+
+    return g_profileDropped;
+
+}
+
+//************************************************************************************
+//
+// Regression check: true if the worst observed time for id is within budget.
+//
+//************************************************************************************
+bool ProfileWithinBudget(uint32_t id, uint32_t budget) {
+
+    return g_profileRegions[id].max <= budget;
+
+}
+
+#endif
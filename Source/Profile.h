@@ -0,0 +1,185 @@
+//************************************************************************************
+//
+// Title:               Cycle-Accurate Profiling
+// Author:              Jacob Putz
+// Filename:            Profile.h
+//
+// Description:     Scoped regions timed by the DWT cycle counter, per-ISR entry-
+//                      latency and duration histograms, and a lock-free trace ring in
+//                      SRAM.  Everything here compiles to nothing unless PROFILE_ENABLE
+//                      is defined (the Debug configuration defines it).  On a host
+//                      build the counter is CLOCK_MONOTONIC in nanoseconds instead of
+//                      cycles, and Host/Tools/ProfileTool.c holds the profiled hot
+//                      paths to time budgets.
+//
+// Current Revision:    0.1.3
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.3    -       Point to the host budget check.
+//
+// 0.1.2    -       Add the hop sequence build region.
+//
+// 0.1.1    -       Add the preset load region.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if !defined(PART_TM4C1294NCPDT)
+#include <time.h>
+#endif
+
+// Defines
+//
+// Profiled regions and interrupts.  Add new identifiers before PROFILE_ID_COUNT.
+//
+#define     PROFILE_ID_SYSTICK          0
+#define     PROFILE_ID_SSI_AD9834       1
+#define     PROFILE_ID_SSI_AD9952       2
+#define     PROFILE_ID_SWEEP_BLOCK      3
+#define     PROFILE_ID_MOD_BLOCK        4
+#define     PROFILE_ID_SCHED_DISPATCH   5
+#define     PROFILE_ID_SWEEP_REFILL     6
+#define     PROFILE_ID_MOD_REFILL       7
+#define     PROFILE_ID_PRESET_LOAD      8
+#define     PROFILE_ID_HOP_LOAD         9
+#define     PROFILE_ID_COUNT            10
+
+// Histogram buckets: bucket n counts values in [2^(n-1), 2^n), bucket 0 counts 0
+#define     PROFILE_HIST_BUCKETS        16
+
+// Trace ring entries (power of two)
+#define     PROFILE_TRACE_SIZE          256
+#define     PROFILE_TRACE_MASK          (PROFILE_TRACE_SIZE - 1)
+
+// DWT cycle counter (see TimeBase.h)
+#define     PROFILE_CYCCNT              0xE0001004
+
+// Type Definitions
+typedef struct {
+
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+
+} tProfileRegion;
+
+typedef struct {
+
+    uint32_t latency[PROFILE_HIST_BUCKETS];
+    uint32_t duration[PROFILE_HIST_BUCKETS];
+
+} tProfileIsr;
+
+//
+// seq is written last and holds the claimed ring position plus one, so a reader
+// can tell a finished entry from one a preempted producer has only claimed.
+//
+typedef struct {
+
+    uint32_t timestamp;
+    uint16_t id;
+    uint16_t arg;
+    volatile uint32_t seq;
+
+} tProfileTrace;
+
+//************************************************************************************
+//
+// Free-running 32-bit counter: DWT CYCCNT on target, nanoseconds on a host.
+//
+//************************************************************************************
+static inline uint32_t ProfileNow(void) {
+
+#if defined(PART_TM4C1294NCPDT)
+    return *((volatile uint32_t *)PROFILE_CYCCNT);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+
+}
+
+#if defined(PROFILE_ENABLE)
+
+// Global Variables
+extern tProfileRegion g_profileRegions[PROFILE_ID_COUNT];
+extern tProfileIsr g_profileIsrs[PROFILE_ID_COUNT];
+extern tProfileTrace g_profileTrace[PROFILE_TRACE_SIZE];
+
+// Function Prototypes
+extern void ProfileInit(void);
+extern void ProfileRegionRecord(uint32_t id, uint32_t elapsed);
+extern void ProfileIsrRecord(uint32_t id, uint32_t latency, uint32_t duration);
+extern void ProfileTrace(uint32_t id, uint32_t arg);
+extern bool ProfileTraceRead(tProfileTrace *entry);
+extern uint32_t ProfileTraceDropped(void);
+extern bool ProfileWithinBudget(uint32_t id, uint32_t budget);
+
+// Port Prototypes
+extern void ProfilePortInit(void);
+
+//
+// Region timing.  BEGIN is a declaration when enabled and an empty statement when
+// not, so put it after the block's other declarations and before its first
+// statement; END must be in the same scope.
+//
+#define     PROFILE_BEGIN(id)           uint32_t profStart_##id = ProfileNow()
+#define     PROFILE_END(id)             ProfileRegionRecord((id),                   \
+                                            ProfileNow() - profStart_##id)
+
+//
+// Interrupt timing.  latency is the number of counts between the hardware event
+// and handler entry, which only the handler can work out (e.g. SysTick LOAD - VAL).
+//
+#define     PROFILE_ISR_ENTER(id)       uint32_t profIsr_##id = ProfileNow()
+#define     PROFILE_ISR_EXIT(id, latency)                                           \
+                                        ProfileIsrRecord((id), (latency),           \
+                                            ProfileNow() - profIsr_##id)
+
+#define     PROFILE_TRACE(id, arg)      ProfileTrace((id), (arg))
+
+#else
+
+#define     ProfileInit()
+#define     ProfilePortInit()
+#define     PROFILE_BEGIN(id)
+#define     PROFILE_END(id)
+#define     PROFILE_ISR_ENTER(id)
+#define     PROFILE_ISR_EXIT(id, latency)
+#define     PROFILE_TRACE(id, arg)
+
+#endif
+
+#endif /* PROFILE_H_ */
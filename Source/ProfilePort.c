@@ -0,0 +1,129 @@
+//************************************************************************************
+//
+// Title:               Cycle-Accurate Profiling
+// Author:              Jacob Putz
+// Filename:            ProfilePort.c
+//
+// Description:     Drains the trace ring from a scheduler task as REMOTE_EVT_TRACE
+//                      frames on the remote control link, so the trace shares
+//                      UART0 with the command protocol.  Empty unless PROFILE_ENABLE
+//                      is defined.
+//
+// Current Revision:    0.2.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.2.0    -       Renamed from ProfileTiva.c.  Send the trace as frames on the
+//                  remote control link instead of owning UART0.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Profile.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
+
+#if defined(PROFILE_ENABLE)
+
+// Defines
+#define     PROFILE_DRAIN_US        10000       // Drain task period
+#define     PROFILE_RECORD_BYTES    8           // Timestamp + id + arg
+#define     PROFILE_FRAME_RECORDS   (REMOTE_PAYLOAD_MAX / PROFILE_RECORD_BYTES)
+
+// Global Variables
+static tSchedTask g_profileDrainTask;
+static uint8_t g_profileFrame[PROFILE_FRAME_RECORDS * PROFILE_RECORD_BYTES];
+static uint32_t g_profileFrameLen = 0;
+
+//************************************************************************************
+//
+// Serialise an entry little-endian onto the pending frame.
+//
+//************************************************************************************
+static void ProfileRecordAppend(const tProfileTrace *entry) {
+
+    uint8_t *record = &g_profileFrame[g_profileFrameLen];
+
+    record[0] = (uint8_t)(entry->timestamp);
+    record[1] = (uint8_t)(entry->timestamp >> 8);
+    record[2] = (uint8_t)(entry->timestamp >> 16);
+    record[3] = (uint8_t)(entry->timestamp >> 24);
+    record[4] = (uint8_t)(entry->id);
+    record[5] = (uint8_t)(entry->id >> 8);
+    record[6] = (uint8_t)(entry->arg);
+    record[7] = (uint8_t)(entry->arg >> 8);
+    g_profileFrameLen += PROFILE_RECORD_BYTES;
+
+}
+
+//************************************************************************************
+//
+// Pack entries into frames and hand them to the remote link.  A frame the link has
+// no room for is kept and offered again on the next run, so the task never waits
+// on the wire; the trace ring absorbs the backlog and drops, and counts, the rest.
+//
+//************************************************************************************
+static void ProfileDrainTask(tSchedTask *task, uint64_t now) {
+
+    tProfileTrace entry;
+
+    (void)now;
+
+    for (;;) {
+
+        while ((g_profileFrameLen < sizeof(g_profileFrame)) &&
+               ProfileTraceRead(&entry)) {
+
+            ProfileRecordAppend(&entry);
+
+        }
+
+        if ((g_profileFrameLen == 0) ||
+            !RemoteSendEvent(&g_remote, REMOTE_EVT_TRACE, g_profileFrame,
+                             g_profileFrameLen)) {
+
+            break;
+
+        }
+
+        g_profileFrameLen = 0;
+
+    }
+
+    SchedulerDefer(task, PROFILE_DRAIN_US);
+
+}
+
+void ProfilePortInit(void) {
+
+    SchedulerTaskInit(&g_profileDrainTask, ProfileDrainTask, 0);
+    SchedulerAdd(&g_profileDrainTask, TimeBaseMicros() + PROFILE_DRAIN_US);
+
+}
+
+#endif
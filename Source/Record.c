@@ -0,0 +1,306 @@
+//************************************************************************************
+//
+// Title:               DDS Command Recorder
+// Author:              Jacob Putz
+// Filename:            Record.c
+//
+// Description:     Trace ring, entry encoding and read-back.  Portable; the port
+//                      layer only decides what happens to the trace outside the
+//                      firmware.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Mem.h"
+#include "Record.h"
+#include "TimeBase.h"
+
+// Global Variables
+tRecord g_record;
+
+//************************************************************************************
+//
+// Take the ring from the arena.  Recording stays unavailable if it does not fit.
+//
+//************************************************************************************
+bool RecordInit(tRecord *record) {
+
+    record->ring = (uint16_t *)MemArenaAlloc(RECORD_WORDS * sizeof(uint16_t),
+                                             sizeof(uint16_t));
+    record->head = 0;
+    record->tail = 0;
+    record->running = false;
+    record->flags = 0;
+    record->origin = RECORD_ORIGIN_LOCAL;
+
+    record->entries = 0;
+    record->overwritten = 0;
+    record->full = false;
+
+    return record->ring != 0;
+
+}
+
+//************************************************************************************
+//
+// Empty the ring and start recording.
+//
+//************************************************************************************
+void RecordStart(tRecord *record, uint32_t flags) {
+
+    if (record->ring == 0) {
+
+        return;
+
+    }
+
+    record->head = 0;
+    record->tail = 0;
+    record->flags = flags;
+    record->entries = 0;
+    record->overwritten = 0;
+    record->full = false;
+    record->running = true;
+
+}
+
+//************************************************************************************
+//
+// Stop recording.  The trace stays readable until the next RecordStart().
+//
+//************************************************************************************
+void RecordStop(tRecord *record) {
+
+    record->running = false;
+
+}
+
+//************************************************************************************
+//
+// Attribute what follows to origin and return the previous origin, for the caller
+// to put back.
+//
+//************************************************************************************
+uint32_t RecordOrigin(tRecord *record, uint32_t origin) {
+
+    uint32_t previous = record->origin;
+
+    record->origin = origin;
+
+    return previous;
+
+}
+
+//************************************************************************************
+//
+// Make room for an entry of words, dropping the oldest whole entries if the ring
+// wraps.  Returns false, and stops recording, if it cannot.
+//
+//************************************************************************************
+static bool RecordReserve(tRecord *record, uint32_t words) {
+
+    while ((RECORD_WORDS - (record->head - record->tail)) < words) {
+
+        if ((record->flags & RECORD_FLAG_WRAP) == 0) {
+
+            record->running = false;
+            record->full = true;
+
+            return false;
+
+        }
+
+        record->tail += RECORD_ENTRY_WORDS(record->ring[record->tail & RECORD_MASK]);
+        record->overwritten++;
+
+    }
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Write an entry header and return the index of its first data word.
+//
+//************************************************************************************
+static uint32_t RecordHeader(tRecord *record, uint32_t kind, uint32_t instance,
+                             uint32_t length, uint32_t time) {
+
+    uint32_t head = record->head;
+
+    record->ring[head & RECORD_MASK] =
+        (uint16_t)((kind << RECORD_KIND_SHIFT) |
+                   ((record->origin & RECORD_ORIGIN_MASK) << RECORD_ORIGIN_SHIFT) |
+                   ((instance & 1) << RECORD_INSTANCE_SHIFT) | length);
+    record->ring[(head + 1) & RECORD_MASK] = (uint16_t)time;
+    record->ring[(head + 2) & RECORD_MASK] = (uint16_t)(time >> 16);
+
+    return head + RECORD_HEADER_WORDS;
+
+}
+
+//************************************************************************************
+//
+// Record register frames queued on the stream for instance.
+//
+//************************************************************************************
+void RecordFrames(tRecord *record, uint32_t instance, const uint16_t *frames,
+                  uint32_t count) {
+
+    uint32_t time, length, index, i;
+
+    if (!record->running) {
+
+        return;
+
+    }
+
+    time = (uint32_t)TimeBaseMicros();
+
+    while (count != 0) {
+
+        length = (count > RECORD_LENGTH_MAX) ? RECORD_LENGTH_MAX : count;
+
+        if (!RecordReserve(record, RECORD_HEADER_WORDS + length)) {
+
+            return;
+
+        }
+
+        index = RecordHeader(record, RECORD_KIND_FRAMES, instance, length, time);
+
+        for (i = 0; i < length; i++) {
+
+            record->ring[(index + i) & RECORD_MASK] = frames[i];
+
+        }
+
+        record->head = index + length;
+        record->entries++;
+
+        frames += length;
+        count -= length;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Record a remote command: len bytes from the frame's seq to the end of its payload.
+//
+//************************************************************************************
+void RecordCommand(tRecord *record, const uint8_t *bytes, uint32_t len) {
+
+    uint32_t words = (len + 1) / 2;
+    uint32_t index, i;
+
+    if (!record->running || (len > RECORD_LENGTH_MAX) ||
+        !RecordReserve(record, RECORD_HEADER_WORDS + words)) {
+
+        return;
+
+    }
+
+    index = RecordHeader(record, RECORD_KIND_COMMAND, 0, len,
+                         (uint32_t)TimeBaseMicros());
+
+    for (i = 0; i < words; i++) {
+
+        record->ring[(index + i) & RECORD_MASK] =
+            (uint16_t)(bytes[2 * i] |
+                       ((((2 * i) + 1) < len) ? (bytes[(2 * i) + 1] << 8) : 0));
+
+    }
+
+    record->head = index + words;
+    record->entries++;
+
+}
+
+uint32_t RecordWords(const tRecord *record) {
+
+    return record->head - record->tail;
+
+}
+
+//************************************************************************************
+//
+// Copy up to count words of the trace, starting offset words after the oldest, and
+// return how many were copied.
+//
+//************************************************************************************
+uint32_t RecordRead(const tRecord *record, uint32_t offset, uint16_t *words,
+                    uint32_t count) {
+
+    uint32_t available = record->head - record->tail;
+    uint32_t i;
+
+    if (offset >= available) {
+
+        return 0;
+
+    }
+
+    if (count > (available - offset)) {
+
+        count = available - offset;
+
+    }
+
+    for (i = 0; i < count; i++) {
+
+        words[i] = record->ring[(record->tail + offset + i) & RECORD_MASK];
+
+    }
+
+    return count;
+
+}
+
+//************************************************************************************
+//
+// Drop words from the oldest end once they have been read.  words must end on an
+// entry boundary, which it does if it came from RecordWords().
+//
+//************************************************************************************
+void RecordConsume(tRecord *record, uint32_t words) {
+
+    if (words > (record->head - record->tail)) {
+
+        words = record->head - record->tail;
+
+    }
+
+    record->tail += words;
+
+}
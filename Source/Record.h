@@ -0,0 +1,194 @@
+//************************************************************************************
+//
+// Title:               DDS Command Recorder
+// Author:              Jacob Putz
+// Filename:            Record.h
+//
+// Description:     Compact binary trace of everything that reaches the DDS layer:
+//                      remote command frames as received and the register frames
+//                      queued on the SSI streams, each with a timestamp and the
+//                      part of the firmware that produced it.  The trace is kept in
+//                      a ring in the memory arena and read back over the remote
+//                      link, or written to a file by the simulator, for the replay
+//                      tool.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Add the fault restore origin.
+//
+// 0.1.1    -       Add the synchronized update origin.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef RECORD_H_
+#define RECORD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  The trace is a sequence of variable-length entries of 16-bit words:
+//
+//      0       header      kind (15:14), origin (13:11), instance (10),
+//                          length (7:0)
+//      1       time        TimeBaseMicros() when recorded, bits 15:0
+//      2       time        bits 31:16
+//      3       data        RECORD_KIND_FRAMES: length SSI frames as queued
+//                          RECORD_KIND_COMMAND: length bytes, two to a word,
+//                          low byte first, of the remote frame from seq to the
+//                          end of the payload (no sync, no CRC)
+//
+//  The time wraps after 71 minutes; a reader unwraps it by assuming entries are
+//  never that far apart.  Register writes longer than 255 frames (preset setup)
+//  are split over several entries with the same time.
+//
+//  Commands are recorded when the parser accepts them, retransmissions included,
+//  so replaying the COMMAND entries at their times reproduces the input.  The
+//  FRAMES entries are the output to compare against: every write through an SSI
+//  stream (shadow flushes, preset setup, modulator bank loads, calibration
+//  corrections).  The step tables the sweep and hop engines feed to the SSI by
+//  uDMA are not recorded frame by frame -- at up to a few hundred thousand steps
+//  a second they would fill the ring in milliseconds -- but the command or preset
+//  that started them is, and they are a pure function of it.
+//
+//  The origin is whichever part of the firmware is running when the entry is made.
+//  Entry points that produce DDS traffic set it with RecordOrigin() and put the
+//  previous value back on the way out, so a preset played from a remote command
+//  is attributed to the preset.  Recording is done from thread level only, like
+//  queueing on an SSI stream, so nothing masks interrupts.
+//
+//  When the ring fills, recording stops (a capture from RecordStart() onwards) or,
+//  with RECORD_FLAG_WRAP, the oldest entries are dropped whole to make room (the
+//  most recent history, for post-mortem use).
+//
+//  A trace file is a tRecordFileHeader followed by the words, little-endian.
+//  RECORD_READ on the remote link returns the same words in order, so a host can
+//  build the file from a target capture.
+//
+//************************************************************************************
+
+// Defines
+#define     RECORD_WORDS            4096        // Ring size (power of two), 8 KB
+#define     RECORD_MASK             (RECORD_WORDS - 1)
+#define     RECORD_HEADER_WORDS     3
+#define     RECORD_LENGTH_MAX       255
+
+// Header fields
+#define     RECORD_KIND_SHIFT       14
+#define     RECORD_ORIGIN_SHIFT     11
+#define     RECORD_ORIGIN_MASK      0x7
+#define     RECORD_INSTANCE_SHIFT   10
+#define     RECORD_LENGTH_MASK      0xFF
+
+#define     RECORD_KIND(header)     ((uint32_t)(header) >> RECORD_KIND_SHIFT)
+#define     RECORD_ORIGIN(header)   (((uint32_t)(header) >> RECORD_ORIGIN_SHIFT) &  \
+                                     RECORD_ORIGIN_MASK)
+#define     RECORD_INSTANCE(header) (((uint32_t)(header) >> RECORD_INSTANCE_SHIFT) & 1)
+#define     RECORD_LENGTH(header)   ((uint32_t)(header) & RECORD_LENGTH_MASK)
+#define     RECORD_ENTRY_WORDS(header)                                              \
+                (RECORD_HEADER_WORDS + ((RECORD_KIND(header) == RECORD_KIND_FRAMES) ? \
+                    RECORD_LENGTH(header) : ((RECORD_LENGTH(header) + 1) / 2)))
+
+// Entry kinds
+#define     RECORD_KIND_FRAMES      0           // Register frames queued on a stream
+#define     RECORD_KIND_COMMAND     1           // Remote command frame
+
+// Origins
+#define     RECORD_ORIGIN_LOCAL     0           // Start-up and anything unattributed
+#define     RECORD_ORIGIN_REMOTE    1
+#define     RECORD_ORIGIN_PRESET    2
+#define     RECORD_ORIGIN_MOD       3
+#define     RECORD_ORIGIN_CALIB     4
+#define     RECORD_ORIGIN_SYNC      5
+#define     RECORD_ORIGIN_RESTORE   6           // Fault.h restart
+
+// RecordStart() flags
+#define     RECORD_FLAG_WRAP        0x01        // Drop the oldest entries when full
+
+// Trace file
+#define     RECORD_FILE_MAGIC       0x52534444  // "DDSR"
+#define     RECORD_FILE_VERSION     1
+#define     RECORD_FILE_LOST        0x01        // Entries were dropped from the start
+
+// Type Definitions
+typedef struct {
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t chips;                 // DDS_CHIP of the build that recorded it
+    uint32_t words;
+    uint32_t flags;
+
+} tRecordFileHeader;
+
+typedef struct {
+
+    uint16_t *ring;                 // RECORD_WORDS words from the arena
+    uint32_t head;                  // Free-running word indices
+    uint32_t tail;
+
+    bool running;
+    uint32_t flags;
+    uint32_t origin;
+
+    //
+    // Statistics
+    //
+    uint32_t entries;
+    uint32_t overwritten;           // Entries dropped by RECORD_FLAG_WRAP
+    bool full;                      // Stopped because the ring filled
+
+} tRecord;
+
+// Global Variables
+extern tRecord g_record;
+
+// Function Prototypes
+//
+// Portable core (Record.c)
+//
+extern bool RecordInit(tRecord *record);
+extern void RecordStart(tRecord *record, uint32_t flags);
+extern void RecordStop(tRecord *record);
+extern uint32_t RecordOrigin(tRecord *record, uint32_t origin);
+extern void RecordFrames(tRecord *record, uint32_t instance, const uint16_t *frames,
+                         uint32_t count);
+extern void RecordCommand(tRecord *record, const uint8_t *bytes, uint32_t len);
+extern uint32_t RecordWords(const tRecord *record);
+extern uint32_t RecordRead(const tRecord *record, uint32_t offset, uint16_t *words,
+                           uint32_t count);
+extern void RecordConsume(tRecord *record, uint32_t words);
+
+//
+// Port layer (RecordTiva.c on target, Host/RecordHost.c on a host build)
+//
+extern void RecordPortInit(tRecord *record);
+
+#endif /* RECORD_H_ */
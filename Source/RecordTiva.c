@@ -0,0 +1,54 @@
+//************************************************************************************
+//
+// Title:               DDS Command Recorder - TM4C1294 Port
+// Author:              Jacob Putz
+// Filename:            RecordTiva.c
+//
+// Description:     Start-up policy for Record.c on the target.  The trace lives in
+//                      SRAM and is read back with RECORD_READ on the remote link.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Record.h"
+
+//************************************************************************************
+//
+// Record from power-up in wrap mode, so the most recent history is always there
+// to read back after something has gone wrong.  RECORD_START replaces this with a
+// capture from a known point.
+//
+//************************************************************************************
+void RecordPortInit(tRecord *record) {
+
+    RecordStart(record, RECORD_FLAG_WRAP);
+
+}
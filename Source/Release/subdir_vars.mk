@@ -8,28 +8,252 @@ SHELL = cmd.exe
 CMD_SRCS += \
 ../tm4c1294ncpdt.cmd 
 
+ASM_SRCS += \
+../FaultVectors.asm 
+
 C_SRCS += \
+../Boot.c \
+../Calib.c \
+../CalibTiva.c \
+../Crc.c \
 ../DDSExperiment.c \
+../DDSShadow.c \
+../DDSTuning.c \
+../DMAControl.c \
+../Fault.c \
+../FaultTiva.c \
+../HalTiva.c \
+../Hop.c \
+../Mem.c \
+../MemTiva.c \
+../Modulation.c \
+../ModulationTiva.c \
+../Power.c \
+../Preset.c \
+../PresetTiva.c \
+../Profile.c \
+../ProfilePort.c \
+../Record.c \
+../RecordTiva.c \
+../Remote.c \
+../RemoteTiva.c \
+../SSIStream.c \
+../SSIStreamTiva.c \
+../Scheduler.c \
+../SchedulerPort.c \
+../SoftDDS.c \
+../SoftDDSTiva.c \
+../Sweep.c \
+../SweepTiva.c \
+../Sync.c \
+../TimeBase.c \
+../TimeBasePort.c \
 ../tm4c1294ncpdt_startup_ccs.c 
 
 C_DEPS += \
+./Boot.d \
+./Calib.d \
+./CalibTiva.d \
+./Crc.d \
 ./DDSExperiment.d \
+./DDSShadow.d \
+./DDSTuning.d \
+./DMAControl.d \
+./Fault.d \
+./FaultTiva.d \
+./HalTiva.d \
+./Hop.d \
+./Mem.d \
+./MemTiva.d \
+./Modulation.d \
+./ModulationTiva.d \
+./Power.d \
+./Preset.d \
+./PresetTiva.d \
+./Profile.d \
+./ProfilePort.d \
+./Record.d \
+./RecordTiva.d \
+./Remote.d \
+./RemoteTiva.d \
+./SSIStream.d \
+./SSIStreamTiva.d \
+./Scheduler.d \
+./SchedulerPort.d \
+./SoftDDS.d \
+./SoftDDSTiva.d \
+./Sweep.d \
+./SweepTiva.d \
+./Sync.d \
+./TimeBase.d \
+./TimeBasePort.d \
 ./tm4c1294ncpdt_startup_ccs.d 
 
 OBJS += \
+./Boot.obj \
+./Calib.obj \
+./CalibTiva.obj \
+./Crc.obj \
 ./DDSExperiment.obj \
+./DDSShadow.obj \
+./DDSTuning.obj \
+./DMAControl.obj \
+./Fault.obj \
+./FaultTiva.obj \
+./FaultVectors.obj \
+./HalTiva.obj \
+./Hop.obj \
+./Mem.obj \
+./MemTiva.obj \
+./Modulation.obj \
+./ModulationTiva.obj \
+./Power.obj \
+./Preset.obj \
+./PresetTiva.obj \
+./Profile.obj \
+./ProfilePort.obj \
+./Record.obj \
+./RecordTiva.obj \
+./Remote.obj \
+./RemoteTiva.obj \
+./SSIStream.obj \
+./SSIStreamTiva.obj \
+./Scheduler.obj \
+./SchedulerPort.obj \
+./SoftDDS.obj \
+./SoftDDSTiva.obj \
+./Sweep.obj \
+./SweepTiva.obj \
+./Sync.obj \
+./TimeBase.obj \
+./TimeBasePort.obj \
 ./tm4c1294ncpdt_startup_ccs.obj 
 
+ASM_DEPS += \
+./FaultVectors.d 
+
 OBJS__QUOTED += \
+"Boot.obj" \
+"Calib.obj" \
+"CalibTiva.obj" \
+"Crc.obj" \
 "DDSExperiment.obj" \
+"DDSShadow.obj" \
+"DDSTuning.obj" \
+"DMAControl.obj" \
+"Fault.obj" \
+"FaultTiva.obj" \
+"FaultVectors.obj" \
+"HalTiva.obj" \
+"Hop.obj" \
+"Mem.obj" \
+"MemTiva.obj" \
+"Modulation.obj" \
+"ModulationTiva.obj" \
+"Power.obj" \
+"Preset.obj" \
+"PresetTiva.obj" \
+"Profile.obj" \
+"ProfilePort.obj" \
+"Record.obj" \
+"RecordTiva.obj" \
+"Remote.obj" \
+"RemoteTiva.obj" \
+"SSIStream.obj" \
+"SSIStreamTiva.obj" \
+"Scheduler.obj" \
+"SchedulerPort.obj" \
+"SoftDDS.obj" \
+"SoftDDSTiva.obj" \
+"Sweep.obj" \
+"SweepTiva.obj" \
+"Sync.obj" \
+"TimeBase.obj" \
+"TimeBasePort.obj" \
 "tm4c1294ncpdt_startup_ccs.obj" 
 
+ASM_DEPS__QUOTED += \
+"FaultVectors.d" 
+
 C_DEPS__QUOTED += \
+"Boot.d" \
+"Calib.d" \
+"CalibTiva.d" \
+"Crc.d" \
 "DDSExperiment.d" \
+"DDSShadow.d" \
+"DDSTuning.d" \
+"DMAControl.d" \
+"Fault.d" \
+"FaultTiva.d" \
+"HalTiva.d" \
+"Hop.d" \
+"Mem.d" \
+"MemTiva.d" \
+"Modulation.d" \
+"ModulationTiva.d" \
+"Power.d" \
+"Preset.d" \
+"PresetTiva.d" \
+"Profile.d" \
+"ProfilePort.d" \
+"Record.d" \
+"RecordTiva.d" \
+"Remote.d" \
+"RemoteTiva.d" \
+"SSIStream.d" \
+"SSIStreamTiva.d" \
+"Scheduler.d" \
+"SchedulerPort.d" \
+"SoftDDS.d" \
+"SoftDDSTiva.d" \
+"Sweep.d" \
+"SweepTiva.d" \
+"Sync.d" \
+"TimeBase.d" \
+"TimeBasePort.d" \
 "tm4c1294ncpdt_startup_ccs.d" 
 
+ASM_SRCS__QUOTED += \
+"../FaultVectors.asm" 
+
 C_SRCS__QUOTED += \
+"../Boot.c" \
+"../Calib.c" \
+"../CalibTiva.c" \
+"../Crc.c" \
 "../DDSExperiment.c" \
+"../DDSShadow.c" \
+"../DDSTuning.c" \
+"../DMAControl.c" \
+"../Fault.c" \
+"../FaultTiva.c" \
+"../HalTiva.c" \
+"../Hop.c" \
+"../Mem.c" \
+"../MemTiva.c" \
+"../Modulation.c" \
+"../ModulationTiva.c" \
+"../Power.c" \
+"../Preset.c" \
+"../PresetTiva.c" \
+"../Profile.c" \
+"../ProfilePort.c" \
+"../Record.c" \
+"../RecordTiva.c" \
+"../Remote.c" \
+"../RemoteTiva.c" \
+"../SSIStream.c" \
+"../SSIStreamTiva.c" \
+"../Scheduler.c" \
+"../SchedulerPort.c" \
+"../SoftDDS.c" \
+"../SoftDDSTiva.c" \
+"../Sweep.c" \
+"../SweepTiva.c" \
+"../Sync.c" \
+"../TimeBase.c" \
+"../TimeBasePort.c" \
 "../tm4c1294ncpdt_startup_ccs.c" 
 
 
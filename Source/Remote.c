@@ -0,0 +1,1503 @@
+//************************************************************************************
+//
+// Title:               Remote Control Protocol
+// Author:              Jacob Putz
+// Filename:            Remote.c
+//
+// Description:     Frame parser, command dispatcher and reply framing.  Portable;
+//                      bytes move through RemotePortRxHead() and RemotePortTxKick().
+//
+// Current Revision:    0.1.14
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.14   -       Hold a reference clock retune only while an engine owns that
+//                  part, and make it once the engine stops.
+//
+// 0.1.13   -       Pulse IO_UPDATE once the AD9952 frames of a flush are out.
+//
+// 0.1.12   -       Document the lines SYNC_ADD refuses.
+//
+// 0.1.11   -       Retune from the requested frequency after a reference clock
+//                  change instead of from the quantized word.
+//
+// 0.1.10   -       Check lengths before reading payloads, parse frames in place
+//                  from the ring and defer commands that need idle streams.
+//
+// 0.1.9    -       Add FAULT_READ for the crash snapshot.
+//
+// 0.1.8    -       Add the synchronized multi-channel commands.
+//
+// 0.1.7    -       Record received commands and add RECORD_START/STOP/READ.
+//
+// 0.1.6    -       Add the calibration commands and re-send frequencies when a
+//                  reference clock is replaced.
+//
+// 0.1.5    -       Reject parts not built and set up tuning through the DDSChip front
+//                  end.
+//
+// 0.1.4    -       Add MEM_STATUS for arena and pool high-water marks.
+//
+// 0.1.3    -       Back the poll off when the link is idle and hold off deep sleep
+//                  while it is busy.
+//
+// 0.1.2    -       Add PREVIEW, rendered by the software DDS model.
+//
+// 0.1.1    -       Add HOP_START over a shuffled channel grid.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Calib.h"
+#include "Crc.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Fault.h"
+#include "Hal.h"
+#include "Hop.h"
+#include "Mem.h"
+#include "Modulation.h"
+#include "Power.h"
+#include "Preset.h"
+#include "Record.h"
+#include "Remote.h"
+#include "Scheduler.h"
+#include "SoftDDS.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "Sync.h"
+#include "TimeBase.h"
+
+// Defines
+#define     REMOTE_STATUS_BYTES     25          // Status byte + six counters
+#define     REMOTE_SWEEP_BYTES      28
+#define     REMOTE_HOP_BYTES        36
+#define     REMOTE_PREVIEW_MAX      ((REMOTE_PAYLOAD_MAX - 1) / 2)
+#define     REMOTE_MEM_NAME_BYTES   12
+#define     REMOTE_CALIB_BYTES      39
+#define     REMOTE_RECORD_HEADER    11          // Status byte + state, chips, counters
+#define     REMOTE_RECORD_WORDS     ((REMOTE_PAYLOAD_MAX - REMOTE_RECORD_HEADER) / 2)
+#define     REMOTE_SYNC_SET_BYTES   13
+#define     REMOTE_SYNC_BYTES       22
+#define     REMOTE_FAULT_HEADER     4           // Status byte + valid, u16 size
+#define     REMOTE_FAULT_BYTES      (REMOTE_PAYLOAD_MAX - REMOTE_FAULT_HEADER)
+
+// Global Variables
+tRemote g_remote;
+
+static uint32_t RemoteGet32(const uint8_t *bytes) {
+
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) |
+           ((uint32_t)bytes[3] << 24);
+
+}
+
+static uint64_t RemoteGet64(const uint8_t *bytes) {
+
+    return (uint64_t)RemoteGet32(bytes) | ((uint64_t)RemoteGet32(bytes + 4) << 32);
+
+}
+
+static void RemotePut32(uint8_t *bytes, uint32_t value) {
+
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+    bytes[2] = (uint8_t)(value >> 16);
+    bytes[3] = (uint8_t)(value >> 24);
+
+}
+
+static void RemotePut64(uint8_t *bytes, uint64_t value) {
+
+    RemotePut32(bytes, (uint32_t)value);
+    RemotePut32(bytes + 4, (uint32_t)(value >> 32));
+
+}
+
+static uint32_t RemoteTxFree(const tRemote *remote) {
+
+    return REMOTE_TX_SIZE - (remote->txHead - remote->txTail);
+
+}
+
+//************************************************************************************
+//
+// Append one frame to the transmit ring.  The caller has checked for space.  The
+// head is published once the whole frame is in place, so the transmit interrupt
+// never sends part of one.
+//
+//************************************************************************************
+static void RemoteTxFrame(tRemote *remote, uint8_t seq, uint8_t cmd,
+                          const uint8_t *payload, uint32_t len) {
+
+    uint8_t header[REMOTE_HEADER_BYTES];
+    uint8_t crc[REMOTE_CRC_BYTES];
+    uint32_t head = remote->txHead;
+    uint32_t i;
+
+    header[0] = REMOTE_SYNC0;
+    header[1] = REMOTE_SYNC1;
+    header[2] = seq;
+    header[3] = cmd;
+    header[4] = (uint8_t)len;
+
+    RemotePut32(crc, Crc32(Crc32(CRC32_INIT, &header[2], 3), payload, len));
+
+    for (i = 0; i < REMOTE_HEADER_BYTES; i++) {
+
+        remote->tx[head++ & REMOTE_TX_MASK] = header[i];
+
+    }
+
+    for (i = 0; i < len; i++) {
+
+        remote->tx[head++ & REMOTE_TX_MASK] = payload[i];
+
+    }
+
+    for (i = 0; i < REMOTE_CRC_BYTES; i++) {
+
+        remote->tx[head++ & REMOTE_TX_MASK] = crc[i];
+
+    }
+
+    remote->txHead = head;
+
+}
+
+//************************************************************************************
+//
+// Queue a device-initiated frame.  Thread context only, like everything else that
+// writes the transmit ring.  Returns false (and counts it) if there is no room.
+//
+//************************************************************************************
+bool RemoteSendEvent(tRemote *remote, uint8_t cmd, const uint8_t *payload,
+                     uint32_t len) {
+
+    if ((len > REMOTE_PAYLOAD_MAX) ||
+        (RemoteTxFree(remote) < (REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES))) {
+
+        remote->eventsDropped++;
+        return false;
+
+    }
+
+    RemoteTxFrame(remote, remote->eventSeq++, cmd, payload, len);
+    RemotePortTxKick(remote);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Move what the AD9952 flushes sent from its I/O buffer to the output.  Returns
+// false while frames are still going out.  A running sweep or hop owns PL4 and
+// pulses it every step, which latches the buffer just as well.
+//
+//************************************************************************************
+static bool RemoteLatchAD9952(tRemote *remote) {
+
+    if (g_ad9952Shadow.sentFrames == remote->latchedFrames) {
+
+        return true;
+
+    }
+
+    if (!SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9952]) || HalSsiBusy(HAL_SSI_3)) {
+
+        return false;
+
+    }
+
+    if (!g_sweep.running) {
+
+        SweepPortIOUpdate();
+
+    }
+
+    remote->latchedFrames = g_ad9952Shadow.sentFrames;
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Send what the shadows have collected.  AD9952 writes count as sent once
+// IO_UPDATE has latched them.  A flush that stopped for a select pin switch is
+// finished here once the frames before the switch are out, unless the modulator
+// owns the pins.
+//
+//************************************************************************************
+static void RemoteFlush(tRemote *remote) {
+
+    tAD9834Shadow *shadow = &g_ad9834Shadow;
+
+    if (remote->shadowDirty[SSISTREAM_AD9952] &&
+        DDSShadowAD9952Queue(&g_ad9952Shadow, &g_ssiStreams[SSISTREAM_AD9952]) &&
+        RemoteLatchAD9952(remote)) {
+
+        remote->shadowDirty[SSISTREAM_AD9952] = false;
+
+    }
+
+    if (!remote->shadowDirty[SSISTREAM_AD9834]) {
+
+        return;
+
+    }
+
+    if (shadow->pinSwitch && !g_modulator.running &&
+        SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9834])) {
+
+        HalGpioWrite(HAL_PORT_K, MOD_FSELECT | MOD_PSELECT,
+                     (((shadow->ctrl & AD9834_CTRL_FSEL) != 0) ? MOD_FSELECT : 0) |
+                     (((shadow->ctrl & AD9834_CTRL_PSEL) != 0) ? MOD_PSELECT : 0));
+        DDSShadowAD9834PinsSwitched(shadow);
+
+    }
+
+    if (DDSShadowAD9834Queue(shadow, &g_ssiStreams[SSISTREAM_AD9834]) &&
+        !shadow->pinSwitch) {
+
+        remote->shadowDirty[SSISTREAM_AD9834] = false;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Sweeps, hops and presets write the parts directly, so pending shadow writes go
+// first and the stream has to drain (a handful of frames) before they start.  A
+// sync commit needs both streams idle with no select switch pending.  Queues what
+// is pending and returns false while the command has to wait; commands that will
+// be refused anyway (bad length or argument, engine busy) never wait.
+//
+//************************************************************************************
+static bool RemoteSettled(tRemote *remote, uint8_t cmd, const uint8_t *payload,
+                          uint32_t len) {
+
+    const tPreset *preset;
+    uint32_t instance;
+
+    switch (cmd) {
+
+        case REMOTE_CMD_SWEEP_START:
+
+            if ((len != REMOTE_SWEEP_BYTES) || g_sweep.running) {
+
+                return true;
+
+            }
+
+            instance = payload[0];
+            break;
+
+        case REMOTE_CMD_HOP_START:
+
+            if ((len != REMOTE_HOP_BYTES) || g_sweep.running || g_modulator.running) {
+
+                return true;
+
+            }
+
+            instance = payload[0];
+            break;
+
+        case REMOTE_CMD_PRESET_PLAY:
+
+            if ((len != 4) || g_sweep.running || g_modulator.running) {
+
+                return true;
+
+            }
+
+            preset = PresetFind(g_presetImage, RemoteGet32(payload));
+
+            if (preset == 0) {
+
+                return true;
+
+            }
+
+            instance = preset->instance;
+            break;
+
+        case REMOTE_CMD_SYNC_COMMIT:
+
+            if (g_sweep.running || g_modulator.running) {
+
+                return true;
+
+            }
+
+            RemoteFlush(remote);
+
+            return !remote->shadowDirty[SSISTREAM_AD9834] &&
+                   !remote->shadowDirty[SSISTREAM_AD9952] &&
+                   SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9834]) &&
+                   SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9952]);
+
+        default:
+
+            return true;
+
+    }
+
+    if (!DDSChipBuilt(instance)) {
+
+        return true;
+
+    }
+
+    if (instance == SSISTREAM_AD9834) {
+
+        DDSShadowAD9834RequireB28(&g_ad9834Shadow);
+        remote->shadowDirty[SSISTREAM_AD9834] = true;
+
+    }
+
+    RemoteFlush(remote);
+
+    return !remote->shadowDirty[instance] && SSIStreamIdle(&g_ssiStreams[instance]);
+
+}
+
+static uint8_t RemoteSetFreq(tRemote *remote, const uint8_t *payload, uint32_t len) {
+
+    uint64_t freq;
+    uint32_t instance, reg, word;
+
+    if (len != 10) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    instance = payload[0];
+    reg = payload[1];
+
+    if (!DDSChipBuilt(instance)) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    if (g_sweep.running && (g_sweep.instance == instance)) {
+
+        return REMOTE_ERR_BUSY;
+
+    }
+
+    freq = RemoteGet64(&payload[2]);
+    word = DDSTuningFreqWord(&remote->tuning[instance], freq);
+
+    if (instance == SSISTREAM_AD9952) {
+
+        DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_FTW0, word);
+        reg = 0;
+
+    }
+
+    else if (reg == REMOTE_REG_SWITCH) {
+
+        reg = DDSShadowAD9834Retune(&g_ad9834Shadow, word);
+
+    }
+
+    else if (reg < 2) {
+
+        DDSShadowAD9834SetFreq(&g_ad9834Shadow, reg, word);
+
+    }
+
+    else {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    remote->freqQ32[instance][reg] = freq;
+    remote->freqWord[instance][reg] = word;
+    remote->freqSet[instance] |= 1UL << reg;
+    remote->shadowDirty[instance] = true;
+
+    return REMOTE_OK;
+
+}
+
+static uint8_t RemoteSetPhase(tRemote *remote, const uint8_t *payload, uint32_t len) {
+
+    uint32_t instance, reg, word;
+
+    if (len != 6) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    instance = payload[0];
+    reg = payload[1];
+
+    if (!DDSChipBuilt(instance)) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    if (g_sweep.running && (g_sweep.instance == instance)) {
+
+        return REMOTE_ERR_BUSY;
+
+    }
+
+    word = DDSTuningPhaseWordCentiDeg(&remote->tuning[instance], RemoteGet32(&payload[2]));
+
+    if (instance == SSISTREAM_AD9952) {
+
+        DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_POW0, word);
+
+    }
+
+    else if (reg == REMOTE_REG_SWITCH) {
+
+        DDSShadowAD9834Rephase(&g_ad9834Shadow, word);
+
+    }
+
+    else if (reg < 2) {
+
+        DDSShadowAD9834SetPhase(&g_ad9834Shadow, reg, word);
+
+    }
+
+    else {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    remote->shadowDirty[instance] = true;
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// Word for frequency register reg of instance, holding word now, on the new
+// tuning context.  If the register still holds what SET_FREQ put there it is tuned
+// again from the frequency asked for; otherwise word is converted through the old
+// context, once, and that frequency is kept for later clock changes.
+//
+//************************************************************************************
+static uint32_t RemoteRetuneWord(tRemote *remote, const tDDSTuning *old, uint32_t instance,
+                                 uint32_t reg, uint32_t word) {
+
+    if (((remote->freqSet[instance] & (1UL << reg)) == 0) ||
+        (remote->freqWord[instance][reg] != word)) {
+
+        remote->freqQ32[instance][reg] = DDSTuningWordToFreq(old, word);
+        remote->freqSet[instance] |= 1UL << reg;
+
+    }
+
+    word = DDSTuningFreqWord(&remote->tuning[instance], remote->freqQ32[instance][reg]);
+    remote->freqWord[instance][reg] = word;
+
+    return word;
+
+}
+
+//************************************************************************************
+//
+// True while a sweep or hop plays on instance or the modulator owns its banks.
+//
+//************************************************************************************
+static bool RemoteEngineOwns(uint32_t instance) {
+
+    return (g_sweep.running && (g_sweep.instance == instance)) ||
+           (g_modulator.running && (instance == SSISTREAM_AD9834));
+
+}
+
+//************************************************************************************
+//
+// Move the frequency registers of each instance with a retune pending onto its
+// new tuning context, unless an engine owns the part.  A register the part still
+// holds as the shadow left it is sent again; one an engine has overwritten since
+// is only retuned in the shadow, so the output the engine left is not disturbed.
+//
+//************************************************************************************
+static void RemoteRetune(tRemote *remote) {
+
+    const tDDSTuning *old;
+    uint32_t instance, bit, word, i;
+
+    for (instance = 0; instance < SSISTREAM_COUNT; instance++) {
+
+        if (!remote->retunePending[instance] || RemoteEngineOwns(instance)) {
+
+            continue;
+
+        }
+
+        old = &remote->retuneFrom[instance];
+        remote->retunePending[instance] = false;
+
+        if (instance == SSISTREAM_AD9952) {
+
+            bit = DDSSHADOW_AD9952_REG(AD9952_REG_FTW0);
+            word = g_ad9952Shadow.reg[AD9952_REG_FTW0];
+
+            if ((g_ad9952Shadow.set & bit) != 0) {
+
+                DDSShadowAD9952Set(&g_ad9952Shadow, AD9952_REG_FTW0,
+                                   RemoteRetuneWord(remote, old, instance, 0, word));
+                remote->shadowDirty[instance] |= (g_ad9952Shadow.known & bit) != 0;
+
+            }
+
+            continue;
+
+        }
+
+        for (i = 0; i < 2; i++) {
+
+            bit = DDSSHADOW_AD9834_FREQ0 << i;
+
+            if ((g_ad9834Shadow.set & bit) != 0) {
+
+                DDSShadowAD9834SetFreq(&g_ad9834Shadow, i,
+                                       RemoteRetuneWord(remote, old, instance, i,
+                                                        g_ad9834Shadow.freq[i]));
+                remote->shadowDirty[instance] |= (g_ad9834Shadow.known & bit) != 0;
+
+            }
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Replace the tuning context of instance with one for refClkHz and move the
+// frequency registers already set onto it, now or once the engine that owns the
+// part stops.  Returns false if the clock cannot be represented, leaving the old
+// context in place.
+//
+//************************************************************************************
+bool RemoteSetRefClk(tRemote *remote, uint32_t instance, uint32_t refClkHz) {
+
+    tDDSTuning old;
+    tDDSTuning *tuning = &remote->tuning[instance];
+
+    if (!DDSChipBuilt(instance)) {
+
+        return false;
+
+    }
+
+    old = *tuning;
+
+    if (!DDSTuningInit(tuning, refClkHz, old.freqBits, old.phaseBits)) {
+
+        return false;
+
+    }
+
+    //
+    // Registers are converted from the context they were tuned with, which is the
+    // first one replaced while a retune waits
+    //
+    if (!remote->retunePending[instance]) {
+
+        remote->retuneFrom[instance] = old;
+        remote->retunePending[instance] = true;
+
+    }
+
+    RemoteRetune(remote);
+    RemoteFlush(remote);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// u8 index.  REMOTE_MEM_ARENA replies u8 pools, u32 size, u32 used, u32 failures
+// for the arena; a pool index replies u8 pools, u32 blockSize, u32 count,
+// u32 inUse, u32 highWater, u32 failures and the pool name, NUL padded.
+//
+//************************************************************************************
+static uint8_t RemoteMemStatus(const uint8_t *payload, uint32_t len, uint8_t *reply,
+                               uint32_t *replyLen) {
+
+    const tMemPool *pool;
+    const char *name;
+    uint32_t i;
+
+    if (len != 1) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    reply[1] = (uint8_t)g_mem.poolCount;
+
+    if (payload[0] == REMOTE_MEM_ARENA) {
+
+        RemotePut32(&reply[2], g_mem.size);
+        RemotePut32(&reply[6], g_mem.used);
+        RemotePut32(&reply[10], g_mem.failures);
+        *replyLen = 14;
+
+        return REMOTE_OK;
+
+    }
+
+    if (payload[0] >= g_mem.poolCount) {
+
+        return REMOTE_ERR_NOT_FOUND;
+
+    }
+
+    pool = g_mem.pools[payload[0]];
+
+    RemotePut32(&reply[2], pool->blockSize);
+    RemotePut32(&reply[6], pool->count);
+    RemotePut32(&reply[10], pool->inUse);
+    RemotePut32(&reply[14], pool->highWater);
+    RemotePut32(&reply[18], pool->failures);
+
+    name = (pool->name != 0) ? pool->name : "";
+
+    for (i = 0; i < REMOTE_MEM_NAME_BYTES; i++) {
+
+        reply[22 + i] = (uint8_t)*name;
+
+        if (*name != '\0') {
+
+            name++;
+
+        }
+
+    }
+
+    *replyLen = 22 + REMOTE_MEM_NAME_BYTES;
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// u8 chip, u8 flags (CALIB_FLAG_*), u16 fitSamples (zero for the default).
+//
+//************************************************************************************
+static uint8_t RemoteCalibStart(const uint8_t *payload, uint32_t len) {
+
+    if (len != 4) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    return CalibStart(&g_calib, payload[0], payload[1],
+                      (uint32_t)payload[2] | ((uint32_t)payload[3] << 8)) ? REMOTE_OK :
+                                                                            REMOTE_ERR_ARG;
+
+}
+
+//************************************************************************************
+//
+// Replies u8 running, u8 chip, u32 fits, u32 applied, u32 restarts, u32 rejected,
+// u32 reference clock in use, and the last reference clock estimate and output
+// frequency fit, both u64 Q32.32 Hz.
+//
+//************************************************************************************
+static uint8_t RemoteCalibStatus(tRemote *remote, uint8_t *reply, uint32_t *replyLen) {
+
+    const tCalib *calib = &g_calib;
+
+    reply[1] = calib->running ? 1 : 0;
+    reply[2] = (uint8_t)calib->instance;
+    RemotePut32(&reply[3], calib->fits);
+    RemotePut32(&reply[7], calib->applied);
+    RemotePut32(&reply[11], calib->restarts);
+    RemotePut32(&reply[15], calib->rejected);
+    RemotePut32(&reply[19], DDSChipBuilt(calib->instance) ?
+                            remote->tuning[calib->instance].refClkHz : 0);
+    RemotePut64(&reply[23], (uint64_t)(calib->refClkHz * 4294967296.0));
+    RemotePut64(&reply[31], (uint64_t)(calib->outputHz * 4294967296.0));
+    *replyLen = REMOTE_CALIB_BYTES;
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// u32 offset.  Replies u8 state (bit 0 recording, bit 1 stopped full, bit 2 oldest
+// entries dropped), u8 DDS_CHIP, u32 words in the trace, u32 entries recorded,
+// then up to REMOTE_RECORD_WORDS u16 trace words starting offset words after the
+// oldest.  Reading a trace that is still recording in wrap mode can tear; stop it
+// first.
+//
+//************************************************************************************
+static uint8_t RemoteRecordRead(const uint8_t *payload, uint32_t len, uint8_t *reply,
+                                uint32_t *replyLen) {
+
+    const tRecord *record = &g_record;
+    uint16_t words[REMOTE_RECORD_WORDS];
+    uint32_t count, i;
+
+    if (len != 4) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    count = RecordRead(record, RemoteGet32(payload), words, REMOTE_RECORD_WORDS);
+
+    reply[1] = (uint8_t)((record->running ? 0x01 : 0) | (record->full ? 0x02 : 0) |
+                         ((record->overwritten != 0) ? 0x04 : 0));
+    reply[2] = (uint8_t)DDS_CHIP;
+    RemotePut32(&reply[3], RecordWords(record));
+    RemotePut32(&reply[7], record->entries);
+
+    for (i = 0; i < count; i++) {
+
+        reply[REMOTE_RECORD_HEADER + (2 * i)] = (uint8_t)words[i];
+        reply[REMOTE_RECORD_HEADER + (2 * i) + 1] = (uint8_t)(words[i] >> 8);
+
+    }
+
+    *replyLen = REMOTE_RECORD_HEADER + (2 * count);
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// u32 offset.  Replies u8 1 if the snapshot's seal is good, u16 its size, then up
+// to REMOTE_FAULT_BYTES of it starting at offset, in memory order (Fault.h).
+//
+//************************************************************************************
+static uint8_t RemoteFaultRead(const uint8_t *payload, uint32_t len, uint8_t *reply,
+                               uint32_t *replyLen) {
+
+    const uint8_t *bytes = (const uint8_t *)&g_faultSnapshot;
+    uint32_t offset, count, i;
+
+    if (len != 4) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    offset = RemoteGet32(payload);
+    count = (offset < sizeof(tFaultSnapshot)) ? (sizeof(tFaultSnapshot) - offset) : 0;
+
+    if (count > REMOTE_FAULT_BYTES) {
+
+        count = REMOTE_FAULT_BYTES;
+
+    }
+
+    reply[1] = FaultValid(&g_faultSnapshot) ? 1 : 0;
+    reply[2] = (uint8_t)sizeof(tFaultSnapshot);
+    reply[3] = (uint8_t)(sizeof(tFaultSnapshot) >> 8);
+
+    for (i = 0; i < count; i++) {
+
+        reply[REMOTE_FAULT_HEADER + i] = bytes[offset + i];
+
+    }
+
+    *replyLen = REMOTE_FAULT_HEADER + count;
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// u8 chip, u8 select port, u8 select pins, u8 latch port, u8 latch pins (HAL_PORT_*
+// and HAL_PIN_* values; select pins zero for none).  Replies u8 channel index.
+// Lines another subsystem owns, this link's UART among them, are REMOTE_ERR_ARG.
+//
+//************************************************************************************
+static uint8_t RemoteSyncAdd(const uint8_t *payload, uint32_t len, uint8_t *reply,
+                             uint32_t *replyLen) {
+
+    if (len != 5) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    if (!SyncAdd(&g_sync, payload[0], payload[1], payload[2], payload[3], payload[4])) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    reply[1] = (uint8_t)(g_sync.count - 1);
+    *replyLen = 2;
+
+    return REMOTE_OK;
+
+}
+
+static uint8_t RemoteSyncSet(const uint8_t *payload, uint32_t len) {
+
+    if (len != REMOTE_SYNC_SET_BYTES) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    return SyncSet(&g_sync, payload[0], RemoteGet64(&payload[1]),
+                   RemoteGet32(&payload[9])) ? REMOTE_OK : REMOTE_ERR_ARG;
+
+}
+
+//************************************************************************************
+//
+// RemoteSettled() has sent the writes already collected for the first channels,
+// so the commit starts from idle streams with no glitch-free switch pending.  Replies
+// u8 latch writes, u32 commits, u32 frames staged, u32 stage, u32 spread and
+// u32 skew cycles, all for this commit.
+//
+//************************************************************************************
+static uint8_t RemoteSyncCommit(uint8_t *reply, uint32_t *replyLen) {
+
+    tSync *sync = &g_sync;
+    uint32_t refused = sync->refused;
+
+    if (!SyncCommit(sync)) {
+
+        return (sync->refused != refused) ? REMOTE_ERR_BUSY : REMOTE_ERR_ARG;
+
+    }
+
+    reply[1] = (uint8_t)sync->latchWrites;
+    RemotePut32(&reply[2], sync->commits);
+    RemotePut32(&reply[6], sync->stagedFrames);
+    RemotePut32(&reply[10], sync->stageCycles);
+    RemotePut32(&reply[14], sync->spreadCycles);
+    RemotePut32(&reply[18], sync->skewCycles);
+    *replyLen = REMOTE_SYNC_BYTES;
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// u8 chip, u8 reg, u8 count, u8 reserved, u32 first sample.  Replies with count
+// Q15 samples of the ideal waveform for the requested (shadowed) frequency and
+// phase of reg, starting at sample first, one sample per reference clock.
+//
+//************************************************************************************
+static uint8_t RemotePreview(tRemote *remote, const uint8_t *payload, uint32_t len,
+                             uint8_t *reply, uint32_t *replyLen) {
+
+    uint32_t instance, reg, count, i;
+    int16_t samples[REMOTE_PREVIEW_MAX];
+    tSoftDDS dds;
+
+    if (len != 8) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    instance = payload[0];
+    reg = payload[1];
+    count = payload[2];
+
+    if (!DDSChipBuilt(instance) || (count > REMOTE_PREVIEW_MAX) ||
+        ((instance == SSISTREAM_AD9834) && (reg >= 2))) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    if (instance == SSISTREAM_AD9952) {
+
+        SoftDDSConfigure(&dds, &remote->tuning[instance],
+                         g_ad9952Shadow.reg[AD9952_REG_FTW0],
+                         g_ad9952Shadow.reg[AD9952_REG_POW0]);
+
+    }
+
+    else {
+
+        SoftDDSConfigure(&dds, &remote->tuning[instance], g_ad9834Shadow.freq[reg],
+                         g_ad9834Shadow.phase[reg]);
+
+    }
+
+    SoftDDSSeek(&dds, RemoteGet32(&payload[4]));
+    SoftDDSRender(&dds, samples, count);
+
+    for (i = 0; i < count; i++) {
+
+        reply[1 + (2 * i)] = (uint8_t)samples[i];
+        reply[2 + (2 * i)] = (uint8_t)((uint16_t)samples[i] >> 8);
+
+    }
+
+    *replyLen = 1 + (2 * count);
+
+    return REMOTE_OK;
+
+}
+
+//************************************************************************************
+//
+// u8 chip, u8 shape, u8 repeat, u8 reserved, u64 start, u64 stop (Q32.32 Hz),
+// u32 steps, u32 stepCycles.
+//
+//************************************************************************************
+static uint8_t RemoteSweepStart(tRemote *remote, const uint8_t *payload, uint32_t len) {
+
+    uint32_t instance;
+
+    if (len != REMOTE_SWEEP_BYTES) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    instance = payload[0];
+
+    if (!DDSChipBuilt(instance)) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    if (g_sweep.running) {
+
+        return REMOTE_ERR_BUSY;
+
+    }
+
+    if (!SweepConfigure(&g_sweep, instance, &remote->tuning[instance], payload[1],
+                        RemoteGet64(&payload[4]), RemoteGet64(&payload[12]),
+                        RemoteGet32(&payload[20]), RemoteGet32(&payload[24]),
+                        payload[2] != 0)) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    return SweepStart(&g_sweep) ? REMOTE_OK : REMOTE_ERR_BUSY;
+
+}
+
+//************************************************************************************
+//
+// u8 chip, u8 repeat, u16 reserved, u64 base, u64 spacing (Q32.32 Hz), u32 channels,
+// u32 seed, u32 hops, u32 dwellCycles.  Hops over an evenly spaced grid in seeded
+// shuffled passes; hops of zero is one pass.  The reply carries the hop count
+// after rounding to whole blocks and the cycles spent building the sequence.
+//
+//************************************************************************************
+static uint8_t RemoteHopStart(tRemote *remote, const uint8_t *payload, uint32_t len,
+                              uint8_t *reply, uint32_t *replyLen) {
+
+    uint32_t instance;
+
+    if (len != REMOTE_HOP_BYTES) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    instance = payload[0];
+
+    if (!DDSChipBuilt(instance)) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    if (g_sweep.running || g_modulator.running) {
+
+        return REMOTE_ERR_BUSY;
+
+    }
+
+    if (!HopLoadGrid(&g_hop, instance, &remote->tuning[instance],
+                     RemoteGet64(&payload[4]), RemoteGet64(&payload[12]),
+                     RemoteGet32(&payload[20])) ||
+        !HopSequenceShuffle(&g_hop, RemoteGet32(&payload[24]),
+                            RemoteGet32(&payload[28]))) {
+
+        return REMOTE_ERR_ARG;
+
+    }
+
+    RemotePut32(&reply[1], g_hop.hops);
+    RemotePut32(&reply[5], g_hop.loadCycles);
+    *replyLen = 9;
+
+    return HopStart(&g_hop, RemoteGet32(&payload[32]), payload[1] != 0) ? REMOTE_OK :
+                                                                          REMOTE_ERR_ARG;
+
+}
+
+static uint8_t RemotePresetPlay(const uint8_t *payload, uint32_t len) {
+
+    const tPreset *preset;
+
+    if (len != 4) {
+
+        return REMOTE_ERR_LENGTH;
+
+    }
+
+    preset = PresetFind(g_presetImage, RemoteGet32(payload));
+
+    if (preset == 0) {
+
+        return REMOTE_ERR_NOT_FOUND;
+
+    }
+
+    if (g_sweep.running || g_modulator.running) {
+
+        return REMOTE_ERR_BUSY;
+
+    }
+
+    return PresetPlay(g_presetImage, preset) ? REMOTE_OK : REMOTE_ERR_BUSY;
+
+}
+
+//************************************************************************************
+//
+// Run one command and queue its acknowledgement.  reply[0] is the status.
+//
+//************************************************************************************
+static void RemoteDispatch(tRemote *remote, uint8_t seq, uint8_t cmd,
+                           const uint8_t *payload, uint32_t len) {
+
+    uint8_t *reply = remote->lastReply;
+    uint32_t replyLen = 1;
+    uint32_t i;
+
+    if (remote->haveLast && (seq == remote->lastSeq) && (cmd == remote->lastCmd)) {
+
+        remote->duplicates++;
+        RemoteTxFrame(remote, seq, cmd | REMOTE_ACK, reply, remote->lastReplyLen);
+        return;
+
+    }
+
+    if (remote->haveLast && (seq != (uint8_t)(remote->lastSeq + 1))) {
+
+        remote->seqGaps += (uint8_t)(seq - remote->lastSeq - 1);
+
+    }
+
+    switch (cmd) {
+
+        case REMOTE_CMD_PING:
+
+            reply[0] = REMOTE_OK;
+
+            for (i = 0; (i < len) && (replyLen < REMOTE_PAYLOAD_MAX); i++) {
+
+                reply[replyLen++] = payload[i];
+
+            }
+
+            break;
+
+        case REMOTE_CMD_STATUS:
+
+            reply[0] = REMOTE_OK;
+            RemotePut32(&reply[1], remote->framesRx);
+            RemotePut32(&reply[5], remote->badFrames);
+            RemotePut32(&reply[9], remote->seqGaps);
+            RemotePut32(&reply[13], remote->duplicates);
+            RemotePut32(&reply[17], remote->overruns);
+            RemotePut32(&reply[21], remote->eventsDropped);
+            replyLen = REMOTE_STATUS_BYTES;
+            break;
+
+        case REMOTE_CMD_MEM_STATUS:
+
+            reply[0] = RemoteMemStatus(payload, len, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_RECORD_START:
+
+            if (len != 1) {
+
+                reply[0] = REMOTE_ERR_LENGTH;
+                break;
+
+            }
+
+            RecordStart(&g_record, payload[0]);
+            reply[0] = g_record.running ? REMOTE_OK : REMOTE_ERR_BUSY;
+            break;
+
+        case REMOTE_CMD_RECORD_STOP:
+
+            RecordStop(&g_record);
+            reply[0] = REMOTE_OK;
+            break;
+
+        case REMOTE_CMD_RECORD_READ:
+
+            reply[0] = RemoteRecordRead(payload, len, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_FAULT_READ:
+
+            reply[0] = RemoteFaultRead(payload, len, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_SET_FREQ:
+
+            reply[0] = RemoteSetFreq(remote, payload, len);
+            break;
+
+        case REMOTE_CMD_SET_PHASE:
+
+            reply[0] = RemoteSetPhase(remote, payload, len);
+            break;
+
+        case REMOTE_CMD_PREVIEW:
+
+            reply[0] = RemotePreview(remote, payload, len, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_CALIB_START:
+
+            reply[0] = RemoteCalibStart(payload, len);
+            break;
+
+        case REMOTE_CMD_CALIB_STOP:
+
+            CalibStop(&g_calib);
+            reply[0] = REMOTE_OK;
+            break;
+
+        case REMOTE_CMD_CALIB_STATUS:
+
+            reply[0] = RemoteCalibStatus(remote, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_SYNC_ADD:
+
+            reply[0] = RemoteSyncAdd(payload, len, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_SYNC_SET:
+
+            reply[0] = RemoteSyncSet(payload, len);
+            break;
+
+        case REMOTE_CMD_SYNC_COMMIT:
+
+            reply[0] = RemoteSyncCommit(reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_SYNC_RESET:
+
+            SyncInit(&g_sync);
+            reply[0] = REMOTE_OK;
+            break;
+
+        case REMOTE_CMD_SWEEP_START:
+
+            reply[0] = RemoteSweepStart(remote, payload, len);
+            break;
+
+        case REMOTE_CMD_HOP_START:
+
+            reply[0] = RemoteHopStart(remote, payload, len, reply, &replyLen);
+            break;
+
+        case REMOTE_CMD_SWEEP_STOP:
+
+            SweepStop(&g_sweep);
+            reply[0] = REMOTE_OK;
+            break;
+
+        case REMOTE_CMD_PRESET_PLAY:
+
+            reply[0] = RemotePresetPlay(payload, len);
+            break;
+
+        case REMOTE_CMD_PRESET_STOP:
+
+            SweepStop(&g_sweep);
+            ModulationStop(&g_modulator);
+            reply[0] = REMOTE_OK;
+            break;
+
+        default:
+
+            reply[0] = REMOTE_ERR_UNKNOWN;
+            break;
+
+    }
+
+    remote->haveLast = true;
+    remote->lastSeq = seq;
+    remote->lastCmd = cmd;
+    remote->lastReplyLen = replyLen;
+
+    RemoteTxFrame(remote, seq, cmd | REMOTE_ACK, reply, replyLen);
+
+}
+
+//************************************************************************************
+//
+// Parse every complete frame in the receive ring, then flush the register shadows
+// once for the whole batch.  Frames are checked and run where they lie in the
+// ring; one that wraps past the end is copied out so the command sees it whole.
+// Parsing stops at a command that has to wait for the SSI streams.
+//
+//************************************************************************************
+void RemotePoll(tRemote *remote) {
+
+    uint8_t wrapped[REMOTE_FRAME_MAX];
+    const uint8_t *frame;
+    uint32_t head = RemotePortRxHead(remote);
+    uint32_t tail = remote->rxTail;
+    uint32_t txHead = remote->txHead;
+    uint32_t origin = RecordOrigin(&g_record, RECORD_ORIGIN_REMOTE);
+    uint32_t total, len, first, i;
+
+    remote->settling = false;
+
+    if ((head - tail) > REMOTE_RX_SIZE) {
+
+        //
+        // The uDMA has lapped the parser; what is left in the ring is a mix of
+        // old and new bytes.
+        //
+        remote->overruns++;
+        tail = head;
+
+    }
+
+    while ((head - tail) >= (REMOTE_HEADER_BYTES + REMOTE_CRC_BYTES)) {
+
+        if ((remote->rx[tail & REMOTE_RX_MASK] != REMOTE_SYNC0) ||
+            (remote->rx[(tail + 1) & REMOTE_RX_MASK] != REMOTE_SYNC1)) {
+
+            tail++;
+            continue;
+
+        }
+
+        len = remote->rx[(tail + 4) & REMOTE_RX_MASK];
+
+        if (len > REMOTE_PAYLOAD_MAX) {
+
+            remote->badFrames++;
+            tail++;
+            continue;
+
+        }
+
+        total = REMOTE_HEADER_BYTES + len + REMOTE_CRC_BYTES;
+
+        if (((head - tail) < total) || (RemoteTxFree(remote) < REMOTE_FRAME_MAX)) {
+
+            break;
+
+        }
+
+        first = REMOTE_RX_SIZE - (tail & REMOTE_RX_MASK);
+
+        if (first >= total) {
+
+            frame = &remote->rx[tail & REMOTE_RX_MASK];
+
+        }
+
+        else {
+
+            for (i = 0; i < total; i++) {
+
+                wrapped[i] = remote->rx[(tail + i) & REMOTE_RX_MASK];
+
+            }
+
+            frame = wrapped;
+
+        }
+
+        if (Crc32(CRC32_INIT, &frame[2], 3 + len) !=
+            RemoteGet32(&frame[REMOTE_HEADER_BYTES + len])) {
+
+            remote->badFrames++;
+            tail++;
+            continue;
+
+        }
+
+        if (!RemoteSettled(remote, frame[3], &frame[REMOTE_HEADER_BYTES], len)) {
+
+            remote->settling = true;
+            break;
+
+        }
+
+        tail += total;
+        remote->framesRx++;
+
+        RecordCommand(&g_record, &frame[2], 3 + len);
+        RemoteDispatch(remote, frame[2], frame[3], &frame[REMOTE_HEADER_BYTES], len);
+
+    }
+
+    remote->rxTail = tail;
+
+    RemoteRetune(remote);
+    RemoteFlush(remote);
+
+    if (remote->txHead != txHead) {
+
+        RemotePortTxKick(remote);
+
+    }
+
+    RecordOrigin(&g_record, origin);
+
+}
+
+//************************************************************************************
+//
+// Poll at REMOTE_POLL_US while the link is busy, holding off deep sleep so replies
+// are not delayed by a PLL relock, and at REMOTE_POLL_IDLE_US once it goes quiet.
+// A command waiting for the streams or an AD9952 flush waiting for its IO_UPDATE
+// brings the task back after REMOTE_SETTLE_US.
+//
+//************************************************************************************
+static void RemotePollTask(tSchedTask *task, uint64_t now) {
+
+    tRemote *remote = (tRemote *)task->arg;
+
+    if ((RemotePortRxHead(remote) != remote->rxTail) ||
+        (remote->txHead != remote->txTail)) {
+
+        remote->lastActivity = now;
+
+    }
+
+    RemotePoll(remote);
+
+    if (remote->settling || remote->shadowDirty[SSISTREAM_AD9952]) {
+
+        PowerHold(POWER_HOLD_REMOTE);
+        SchedulerDefer(task, REMOTE_SETTLE_US);
+
+    }
+
+    else if ((now - remote->lastActivity) < REMOTE_IDLE_AFTER_US) {
+
+        PowerHold(POWER_HOLD_REMOTE);
+        SchedulerDefer(task, REMOTE_POLL_US);
+
+    }
+
+    else {
+
+        PowerRelease(POWER_HOLD_REMOTE);
+        SchedulerDefer(task, REMOTE_POLL_IDLE_US);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Reset the protocol state and start polling.  Tuning uses the nominal reference
+// clocks of the built parts until something better is known.
+//
+//************************************************************************************
+void RemoteInit(tRemote *remote) {
+
+    uint32_t i;
+
+    remote->rxTail = 0;
+    remote->txHead = 0;
+    remote->txTail = 0;
+    remote->haveLast = false;
+    remote->eventSeq = 0;
+    remote->shadowDirty[SSISTREAM_AD9834] = false;
+    remote->shadowDirty[SSISTREAM_AD9952] = false;
+    remote->latchedFrames = g_ad9952Shadow.sentFrames;
+    remote->retunePending[SSISTREAM_AD9834] = false;
+    remote->retunePending[SSISTREAM_AD9952] = false;
+    remote->freqSet[SSISTREAM_AD9834] = 0;
+    remote->freqSet[SSISTREAM_AD9952] = 0;
+    remote->framesRx = 0;
+    remote->badFrames = 0;
+    remote->seqGaps = 0;
+    remote->duplicates = 0;
+    remote->overruns = 0;
+    remote->eventsDropped = 0;
+    remote->lastActivity = TimeBaseMicros();
+    remote->settling = false;
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if (DDSChipBuilt(i)) {
+
+            DDSChipTuningInit(i, &remote->tuning[i]);
+
+        }
+
+    }
+
+    SchedulerTaskInit(&remote->pollTask, RemotePollTask, remote);
+    SchedulerAdd(&remote->pollTask, TimeBaseMicros() + REMOTE_POLL_US);
+
+}
@@ -0,0 +1,294 @@
+//************************************************************************************
+//
+// Title:               Remote Control Protocol
+// Author:              Jacob Putz
+// Filename:            Remote.h
+//
+// Description:     Binary, CRC-checked command protocol on UART0 (the ICDI virtual
+//                      COM port).  Commands carry sequence numbers so a host can
+//                      pipeline them without waiting for each acknowledgement.
+//
+// Current Revision:    0.1.13
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.13   -       Add retunePending[] and retuneFrom[].
+//
+// 0.1.12   -       Latch AD9952 shadow flushes with IO_UPDATE.
+//
+// 0.1.11   -       Keep the requested frequency of each register for retuning.
+//
+// 0.1.10   -       Parse frames in place from the receive ring and wait for the SSI
+//                  streams from the scheduler instead of spinning.
+//
+// 0.1.9    -       Add REMOTE_PERIPHS.
+//
+// 0.1.8    -       Add FAULT_READ.
+//
+// 0.1.7    -       Add SYNC_ADD/SET/COMMIT/RESET.
+//
+// 0.1.6    -       Add RECORD_START/STOP/READ.
+//
+// 0.1.5    -       Add CALIB_START/STOP/STATUS and RemoteSetRefClk().
+//
+// 0.1.4    -       Add MEM_STATUS.
+//
+// 0.1.3    -       Add the idle poll period.
+//
+// 0.1.2    -       Add PREVIEW.
+//
+// 0.1.1    -       Add HOP_START.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef REMOTE_H_
+#define REMOTE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Frame (both directions, multi-byte fields little-endian):
+//
+//      0       0xA5        sync
+//      1       0x5A        sync
+//      2       seq
+//      3       cmd
+//      4       len         payload bytes, at most REMOTE_PAYLOAD_MAX
+//      5       payload
+//      5+len   crc         Crc32() of bytes 2 .. 4+len
+//
+//  Every command is answered with cmd | REMOTE_ACK, the same seq and a status byte
+//  followed by any reply data.  Commands are executed in the order received, so a
+//  host may keep many in flight and match acknowledgements by seq.  A command with
+//  the seq of the one just executed is treated as a retransmission: it is not run
+//  again and its acknowledgement is repeated.  Skipped sequence numbers (frames
+//  lost to CRC errors) are counted in seqGaps.
+//
+//  The receiver parses straight out of the uDMA-fed ring: the CRC is run over the
+//  ring and a command is handed its payload where it lies.  Only a frame that
+//  straddles the end of the ring is copied out first.  A bad CRC or length drops
+//  one byte and the hunt for the sync pair starts again, so the parser recovers
+//  from any corruption.  Commands stay in the ring until the transmit ring has
+//  room for their acknowledgement, which gives the host back-pressure instead of
+//  lost replies.
+//
+//  Sweeps, hops and presets write the parts directly and a sync commit needs idle
+//  streams, so those commands first push out the pending shadow writes.  Until
+//  the stream has drained the command stays in the ring and the poll task comes
+//  back after REMOTE_SETTLE_US; nothing spins in the poll.
+//
+//  Device-initiated frames use cmd values with REMOTE_EVENT set (trace records
+//  from the profiler) and their own running seq.
+//
+//  Register writes (SET_FREQ/SET_PHASE) go through the DDS shadows and are flushed
+//  once per batch of received commands, so a burst of pipelined writes to the
+//  same register costs one SSI update.  The AD9952 only moves its I/O buffer to
+//  the output on IO_UPDATE, so once the frames of a flush are out of the SSI the
+//  flush pulses it (SweepPortIOUpdate(), or the sweep timer's own pulse when a
+//  sweep is playing on the other part).  shadowDirty[] stays set until then, and
+//  the poll task comes back after REMOTE_SETTLE_US in the meantime.
+//
+//  Every command the parser accepts is recorded (Record.h) before it runs, along
+//  with the register frames it produces, so a session can be replayed.
+//
+//  Frequencies are converted with the tuning contexts in tuning[], which start at
+//  the nominal reference clocks.  RemoteSetRefClk() replaces a context (the
+//  calibration loop does this) and re-sends the frequency registers already set,
+//  tuned again from the Q32.32 frequency SET_FREQ asked for (freqQ32[]), so
+//  repeated clock updates do not add up rounding errors.  A register written some
+//  other way (a preset, a sync commit) no longer holds the word in freqWord[]; it
+//  is converted through the old context once and kept from then on.  While a sweep
+//  or hop plays on that part, or the modulator owns the AD9834, the retune waits
+//  in retunePending[] and the next poll after the engine stops makes it.  A
+//  register the engine overwrote meanwhile is retuned in the shadow only; the part
+//  keeps what the engine left until the register is next written.
+//
+//************************************************************************************
+
+// Defines
+//
+// Ring sizes in bytes (powers of two).  The receive ring is filled by the uDMA in
+// two halves.
+#define     REMOTE_RX_SIZE          1024
+#define     REMOTE_RX_MASK          (REMOTE_RX_SIZE - 1)
+#define     REMOTE_TX_SIZE          2048
+#define     REMOTE_TX_MASK          (REMOTE_TX_SIZE - 1)
+
+// Peripherals RemotePortInit() brings up: UART0 on PA0/PA1 and the uDMA
+#define     REMOTE_PERIPHS          (HAL_PERIPH_UART0 | HAL_PERIPH_GPIO(HAL_PORT_A) |     \
+                                     HAL_PERIPH_UDMA)
+
+// Framing
+#define     REMOTE_SYNC0            0xA5
+#define     REMOTE_SYNC1            0x5A
+#define     REMOTE_HEADER_BYTES     5
+#define     REMOTE_CRC_BYTES        4
+#define     REMOTE_PAYLOAD_MAX      48
+#define     REMOTE_FRAME_MAX        (REMOTE_HEADER_BYTES + REMOTE_PAYLOAD_MAX +        \
+                                     REMOTE_CRC_BYTES)
+
+// Poll period of the receive task.  After REMOTE_IDLE_AFTER_US without traffic
+// the task backs off so the scheduler can leave gaps long enough for deep sleep;
+// the idle period still drains the ring well before 1024 bytes can arrive.
+#define     REMOTE_POLL_US          1000
+#define     REMOTE_POLL_IDLE_US     8000
+#define     REMOTE_IDLE_AFTER_US    100000
+
+// Poll period while a command waits for the SSI streams to drain (a few frames)
+#define     REMOTE_SETTLE_US        20
+
+// Commands (host to device)
+#define     REMOTE_CMD_PING         0x01        // Any payload, echoed back
+#define     REMOTE_CMD_STATUS       0x02        // Reply: protocol counters
+#define     REMOTE_CMD_MEM_STATUS   0x03        // u8 pool index or REMOTE_MEM_ARENA
+#define     REMOTE_CMD_RECORD_START 0x04        // u8 RecordStart() flags
+#define     REMOTE_CMD_RECORD_STOP  0x05
+#define     REMOTE_CMD_RECORD_READ  0x06        // See RemoteRecordRead()
+#define     REMOTE_CMD_FAULT_READ   0x07        // See RemoteFaultRead()
+#define     REMOTE_CMD_SET_FREQ     0x10        // u8 chip, u8 reg, u64 Q32.32 Hz
+#define     REMOTE_CMD_SET_PHASE    0x11        // u8 chip, u8 reg, u32 centidegrees
+#define     REMOTE_CMD_PREVIEW      0x12        // See RemotePreview()
+#define     REMOTE_CMD_CALIB_START  0x13        // u8 chip, u8 flags, u16 fitSamples
+#define     REMOTE_CMD_CALIB_STOP   0x14
+#define     REMOTE_CMD_CALIB_STATUS 0x15        // See RemoteCalibStatus()
+#define     REMOTE_CMD_SYNC_ADD     0x16        // See RemoteSyncAdd()
+#define     REMOTE_CMD_SYNC_SET     0x17        // u8 channel, u64 Q32.32 Hz, u32 centideg
+#define     REMOTE_CMD_SYNC_COMMIT  0x18        // See RemoteSyncCommit()
+#define     REMOTE_CMD_SYNC_RESET   0x19        // Empty the channel table
+#define     REMOTE_CMD_SWEEP_START  0x20        // See RemoteSweepStart()
+#define     REMOTE_CMD_SWEEP_STOP   0x21        // Also stops a hop sequence
+#define     REMOTE_CMD_HOP_START    0x22        // See RemoteHopStart()
+#define     REMOTE_CMD_PRESET_PLAY  0x30        // u32 id
+#define     REMOTE_CMD_PRESET_STOP  0x31
+
+// MEM_STATUS index selecting the arena rather than a pool
+#define     REMOTE_MEM_ARENA        0xFF
+
+// reg value for a glitch-free write to the idle register followed by a select
+#define     REMOTE_REG_SWITCH       0xFF
+
+// Frequency registers per part whose requested frequency is kept (AD9834 FREQ0/1;
+// the AD9952 uses the first for FTW0)
+#define     REMOTE_FREQ_REGS        2
+
+// Replies and device-initiated frames
+#define     REMOTE_ACK              0x80
+#define     REMOTE_EVENT            0x40
+#define     REMOTE_EVT_TRACE        (REMOTE_EVENT | 0x01)
+
+// Status codes (first reply byte)
+#define     REMOTE_OK               0
+#define     REMOTE_ERR_LENGTH       1
+#define     REMOTE_ERR_ARG          2
+#define     REMOTE_ERR_BUSY         3
+#define     REMOTE_ERR_UNKNOWN      4
+#define     REMOTE_ERR_NOT_FOUND    5
+
+// Type Definitions
+typedef struct {
+
+    //
+    // Receive ring.  The port writes rx[] and publishes the running byte count in
+    // rxHead; the parser owns rxTail.
+    //
+    uint8_t rx[REMOTE_RX_SIZE];
+    uint32_t rxTail;
+
+    //
+    // Transmit ring.  The parser owns txHead, the port's interrupt owns txTail.
+    //
+    uint8_t tx[REMOTE_TX_SIZE];
+    volatile uint32_t txHead;
+    volatile uint32_t txTail;
+
+    //
+    // Sequencing
+    //
+    bool haveLast;
+    uint8_t lastSeq;
+    uint8_t lastCmd;
+    uint8_t lastReply[REMOTE_PAYLOAD_MAX];
+    uint32_t lastReplyLen;
+    uint8_t eventSeq;
+
+    //
+    // Command state
+    //
+    tDDSTuning tuning[SSISTREAM_COUNT];
+    bool shadowDirty[SSISTREAM_COUNT];
+    uint32_t latchedFrames;         // g_ad9952Shadow.sentFrames at the last IO_UPDATE
+    uint64_t freqQ32[SSISTREAM_COUNT][REMOTE_FREQ_REGS];   // Requested, Hz Q32.32
+    uint32_t freqWord[SSISTREAM_COUNT][REMOTE_FREQ_REGS];  // Word it was tuned to
+    uint32_t freqSet[SSISTREAM_COUNT];                     // Bit per register held
+    bool retunePending[SSISTREAM_COUNT];    // Clock replaced while an engine ran
+    tDDSTuning retuneFrom[SSISTREAM_COUNT]; // Context the registers were tuned with
+    tSchedTask pollTask;
+    uint64_t lastActivity;          // TimeBaseMicros() of the last traffic seen
+    bool settling;                  // The next command waits for the streams
+
+    //
+    // Statistics
+    //
+    uint32_t framesRx;
+    uint32_t badFrames;             // CRC or length errors
+    uint32_t seqGaps;
+    uint32_t duplicates;
+    uint32_t overruns;
+    uint32_t eventsDropped;
+
+} tRemote;
+
+// Global Variables
+//
+// UART0 is the only remote link.
+//
+extern tRemote g_remote;
+
+// Function Prototypes
+//
+// Portable core (Remote.c)
+//
+extern void RemoteInit(tRemote *remote);
+extern void RemotePoll(tRemote *remote);
+extern bool RemoteSendEvent(tRemote *remote, uint8_t cmd, const uint8_t *payload,
+                            uint32_t len);
+extern bool RemoteSetRefClk(tRemote *remote, uint32_t instance, uint32_t refClkHz);
+
+//
+// Port layer (RemoteTiva.c on target, Host/RemoteHost.c on a host build)
+//
+extern void RemotePortInit(tRemote *remote, uint32_t sysClkHz, uint32_t baud);
+extern uint32_t RemotePortRxHead(tRemote *remote);
+extern void RemotePortTxKick(tRemote *remote);
+
+#endif /* REMOTE_H_ */
@@ -0,0 +1,236 @@
+//************************************************************************************
+//
+// Title:               Remote Control Protocol - Tiva Port
+// Author:              Jacob Putz
+// Filename:            RemoteTiva.c
+//
+// Description:     UART0 on PA0/PA1 (the ICDI virtual COM port).  Received bytes go
+//                      straight into the protocol ring through uDMA channel 8 in ping-
+//                      pong mode; replies are fed to the TX FIFO from the UART
+//                      interrupt.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Wait only for the peripherals to be ready; their clocks are
+//                  enabled at boot.
+//
+// 0.1.1    -       Clock the UART from the PIOSC so the link survives deep sleep.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_uart.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "DMAControl.h"
+#include "Hal.h"
+#include "Remote.h"
+
+// Defines
+#define     REMOTE_DMA_CHANNEL      8               // UART0 RX
+#define     REMOTE_RX_HALF          (REMOTE_RX_SIZE / 2)
+#define     REMOTE_UART_CLK_HZ      16000000        // PIOSC, running in deep sleep
+
+// Global Variables
+//
+// Ring halves the uDMA has filled.  Written by the interrupt only.
+//
+static volatile uint32_t g_remoteRxBlocks;
+
+//************************************************************************************
+//
+// The primary control structure always fills the first half of the ring and the
+// alternate the second, so re-arming a structure never moves it.
+//
+//************************************************************************************
+static void RemoteRxArm(tRemote *remote, uint32_t select) {
+
+    uint32_t half = (select == UDMA_PRI_SELECT) ? 0 : REMOTE_RX_HALF;
+
+    uDMAChannelTransferSet(REMOTE_DMA_CHANNEL | select, UDMA_MODE_PINGPONG,
+                           (void *)(UART0_BASE + UART_O_DR), &remote->rx[half],
+                           REMOTE_RX_HALF);
+
+}
+
+//************************************************************************************
+//
+// UART0 interrupt: uDMA receive completion, transmit FIFO below its trigger level,
+// or a pend from RemotePortTxKick().
+//
+//************************************************************************************
+static void RemoteUartHandler(void) {
+
+    tRemote *remote = &g_remote;
+    uint32_t tail = remote->txTail;
+    uint32_t select;
+
+    UARTIntClear(UART0_BASE, UARTIntStatus(UART0_BASE, true));
+
+    //
+    // Re-arm every half that has filled, oldest first.
+    //
+    for (;;) {
+
+        select = ((g_remoteRxBlocks & 1) == 0) ? UDMA_PRI_SELECT : UDMA_ALT_SELECT;
+
+        if (uDMAChannelModeGet(REMOTE_DMA_CHANNEL | select) != UDMA_MODE_STOP) {
+
+            break;
+
+        }
+
+        RemoteRxArm(remote, select);
+        uDMAChannelEnable(REMOTE_DMA_CHANNEL);
+        g_remoteRxBlocks++;
+
+    }
+
+    while ((tail != remote->txHead) && UARTSpaceAvail(UART0_BASE)) {
+
+        UARTCharPutNonBlocking(UART0_BASE, remote->tx[tail & REMOTE_TX_MASK]);
+        tail++;
+
+    }
+
+    remote->txTail = tail;
+
+    if (tail != remote->txHead) {
+
+        UARTIntEnable(UART0_BASE, UART_INT_TX);
+
+    }
+
+    else {
+
+        UARTIntDisable(UART0_BASE, UART_INT_TX);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The UART is clocked from the PIOSC rather than the system clock so the link, and
+// the uDMA filling the ring, keep running while the PLL is down in deep sleep.
+// 921600 baud comes out 0.6% fast from 16 MHz, well inside the UART's tolerance.
+//
+//************************************************************************************
+void RemotePortInit(tRemote *remote, uint32_t sysClkHz, uint32_t baud) {
+
+    (void)sysClkHz;
+
+    DMAControlInit();
+
+    //
+    // Enabled at boot (Boot.h); wait until they can be accessed
+    //
+    HalPeriphReady(REMOTE_PERIPHS);
+
+    SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_UART0);
+    SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_GPIOA);
+    SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_UDMA);
+
+    GPIOPinConfigure(GPIO_PA0_U0RX);
+    GPIOPinConfigure(GPIO_PA1_U0TX);
+    GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+
+    UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
+    UARTConfigSetExpClk(UART0_BASE, REMOTE_UART_CLK_HZ, baud,
+                        UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE);
+    UARTFIFOLevelSet(UART0_BASE, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+    UARTFIFOEnable(UART0_BASE);
+
+    //
+    // Receive channel.  No burst attribute, so every byte is moved on its single
+    // request and nothing waits in the FIFO for the trigger level.
+    //
+    uDMAChannelAssign(UDMA_CH8_UART0RX);
+    uDMAChannelAttributeDisable(REMOTE_DMA_CHANNEL, UDMA_ATTR_ALL);
+    uDMAChannelControlSet(REMOTE_DMA_CHANNEL | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_4);
+    uDMAChannelControlSet(REMOTE_DMA_CHANNEL | UDMA_ALT_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_4);
+
+    g_remoteRxBlocks = 0;
+    RemoteRxArm(remote, UDMA_PRI_SELECT);
+    RemoteRxArm(remote, UDMA_ALT_SELECT);
+    uDMAChannelEnable(REMOTE_DMA_CHANNEL);
+    UARTDMAEnable(UART0_BASE, UART_DMA_RX);
+
+    UARTIntRegister(UART0_BASE, RemoteUartHandler);
+    UARTIntEnable(UART0_BASE, UART_INT_DMARX);
+    IntEnable(INT_UART0);
+
+}
+
+//************************************************************************************
+//
+// Bytes received so far: whole halves plus however far the active structure has
+// got.  Read twice around the block count so a half completing in between cannot
+// make the head go backwards.
+//
+//************************************************************************************
+uint32_t RemotePortRxHead(tRemote *remote) {
+
+    uint32_t blocks, remaining, select;
+
+    (void)remote;
+
+    do {
+
+        blocks = g_remoteRxBlocks;
+        select = ((blocks & 1) == 0) ? UDMA_PRI_SELECT : UDMA_ALT_SELECT;
+        remaining = uDMAChannelSizeGet(REMOTE_DMA_CHANNEL | select);
+
+    } while (blocks != g_remoteRxBlocks);
+
+    return (blocks * REMOTE_RX_HALF) + (REMOTE_RX_HALF - remaining);
+
+}
+
+//************************************************************************************
+//
+// Same trick as SSIStreamPortKick(): run the interrupt so the FIFO is only ever
+// filled from one context.
+//
+//************************************************************************************
+void RemotePortTxKick(tRemote *remote) {
+
+    (void)remote;
+
+    IntPendSet(INT_UART0);
+
+}
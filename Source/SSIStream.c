@@ -0,0 +1,249 @@
+//************************************************************************************
+//
+// Title:               SSI Register Frame Stream
+// Author:              Jacob Putz
+// Filename:            SSIStream.c
+//
+// Description:     Portable ring and ping-pong scheduling for the SSI frame stream.
+//                      Nothing in this file touches hardware; see SSIStreamTiva.c for
+//                      the TM4C1294 port.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Clear the SSI bit period.
+//
+// 0.1.1    -       Record queued frames for the command trace.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Record.h"
+#include "SSIStream.h"
+
+// Global Variables
+tSSIStream g_ssiStreams[SSISTREAM_COUNT];
+
+//************************************************************************************
+//
+// Reset a stream to empty.  The port must be initialized separately.
+//
+//************************************************************************************
+void SSIStreamInit(tSSIStream *stream, uint32_t instance) {
+
+    stream->head = 0;
+    stream->tail = 0;
+    stream->dmaHead = 0;
+    stream->slotCount[SSISTREAM_SLOT_PRI] = 0;
+    stream->slotCount[SSISTREAM_SLOT_ALT] = 0;
+    stream->nextSlot = SSISTREAM_SLOT_PRI;
+    stream->instance = instance;
+    stream->bitCycles = 0;
+
+    stream->framesQueued = 0;
+    stream->elementsSent = 0;
+    stream->rejected = 0;
+    stream->highWater = 0;
+    stream->interrupts = 0;
+
+}
+
+//************************************************************************************
+//
+// Copy count elements into the ring and let the completion interrupt pick them up.
+// A frame is never split: if the ring cannot hold all of it the call fails and
+// nothing is queued.
+//
+// The interrupt is always pended rather than checking whether the uDMA is busy;
+// doing the check here would race with the ISR retiring the last slot.
+//
+// Everything queued is also recorded for the command trace (Record.h); apart from
+// the sweep engine's step tables, every register write passes through here.
+//
+//************************************************************************************
+bool SSIStreamQueue(tSSIStream *stream, const uint16_t *elements, uint32_t count) {
+
+    uint32_t head = stream->head;
+    uint32_t depth = head - stream->tail;
+    uint32_t i;
+
+    if (count > (SSISTREAM_RING_SIZE - depth)) {
+
+        stream->rejected++;
+        return false;
+
+    }
+
+    for (i = 0; i < count; i++) {
+
+        stream->ring[(head + i) & SSISTREAM_RING_MASK] = elements[i];
+
+    }
+
+    //
+    // Publish the new head only after the elements are in place.
+    //
+    stream->head = head + count;
+    stream->framesQueued++;
+
+    RecordFrames(&g_record, stream->instance, elements, count);
+
+    depth += count;
+
+    if (depth > stream->highWater) {
+
+        stream->highWater = depth;
+
+    }
+
+    SSIStreamPortKick(stream);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Queue a complete B28 frequency write (control + LSB + MSB) as one unit.
+//
+//************************************************************************************
+bool SSIStreamQueueAD9834Freq(tSSIStream *stream, uint16_t ctrl, uint16_t reg,
+                              uint32_t word) {
+
+    uint16_t frames[AD9834_FREQ_FRAMES];
+
+    AD9834PackFreq28(frames, ctrl, reg, word);
+
+    return SSIStreamQueue(stream, frames, AD9834_FREQ_FRAMES);
+
+}
+
+//************************************************************************************
+//
+// Queue a single AD9952 register write (instruction byte plus data bytes).
+//
+//************************************************************************************
+bool SSIStreamQueueAD9952(tSSIStream *stream, uint8_t reg, uint32_t value) {
+
+    uint16_t frames[AD9952_FRAME_MAX];
+    uint32_t count = AD9952PackWrite(frames, reg, value);
+
+    return SSIStreamQueue(stream, frames, count);
+
+}
+
+//************************************************************************************
+//
+// Number of elements queued or in flight.
+//
+//************************************************************************************
+uint32_t SSIStreamDepth(const tSSIStream *stream) {
+
+    return stream->head - stream->tail;
+
+}
+
+bool SSIStreamIdle(const tSSIStream *stream) {
+
+    return stream->head == stream->tail;
+
+}
+
+//************************************************************************************
+//
+// Completion interrupt body.  Retires every slot the uDMA has finished, then arms
+// each free slot with the next contiguous run of the ring, in the order the
+// controller will execute them.  Only the ISR (or a pended ISR via
+// SSIStreamPortKick()) may call this.
+//
+//************************************************************************************
+void SSIStreamService(tSSIStream *stream) {
+
+    uint32_t stopped = SSIStreamPortStoppedSlots(stream);
+    uint32_t slot;
+    uint32_t pending;
+    uint32_t start;
+    uint32_t run;
+
+    stream->interrupts++;
+
+    //
+    // Retire finished slots.  An armed slot that has not started yet is still in
+    // ping-pong mode, so only slots the controller has run to completion report
+    // as stopped.
+    //
+    for (slot = 0; slot < 2; slot++) {
+
+        if ((stream->slotCount[slot] != 0) && (stopped & (1 << slot))) {
+
+            stream->tail += stream->slotCount[slot];
+            stream->elementsSent += stream->slotCount[slot];
+            stream->slotCount[slot] = 0;
+
+        }
+
+    }
+
+    //
+    // Arm free slots with whatever has been queued since.
+    //
+    while (stream->slotCount[stream->nextSlot] == 0) {
+
+        pending = stream->head - stream->dmaHead;
+
+        if (pending == 0) {
+
+            break;
+
+        }
+
+        start = stream->dmaHead & SSISTREAM_RING_MASK;
+        run = SSISTREAM_RING_SIZE - start;
+
+        if (run > pending) {
+
+            run = pending;
+
+        }
+
+        if (run > SSISTREAM_DMA_MAX) {
+
+            run = SSISTREAM_DMA_MAX;
+
+        }
+
+        stream->slotCount[stream->nextSlot] = run;
+        stream->dmaHead += run;
+        SSIStreamPortArm(stream, stream->nextSlot, &stream->ring[start], run);
+        stream->nextSlot ^= 1;
+
+    }
+
+}
@@ -0,0 +1,140 @@
+//************************************************************************************
+//
+// Title:               SSI Register Frame Stream
+// Author:              Jacob Putz
+// Filename:            SSIStream.h
+//
+// Description:     Interrupt-driven, uDMA-backed transport for DDS register frames.
+//                      Frames are queued into a ring by the application; the completion
+//                      interrupt hands contiguous runs of the ring to the primary and
+//                      alternate uDMA control structures in ping-pong fashion so the
+//                      CPU never touches individual frames.  The ring logic is
+//                      portable; everything that touches hardware is behind the
+//                      SSIStreamPort*() functions.
+//
+// Current Revision:    0.1.3
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.3    -       Point to the host check of the ring.
+//
+// 0.1.2    -       Keep the SSI bit period for the sweep's step rate limit.
+//
+// 0.1.1    -       Add SSISTREAM_PERIPHS().
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef SSISTREAM_H_
+#define SSISTREAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+
+// Defines
+//
+// Ring size in 16-bit elements (must be a power of two) and the largest run the
+// uDMA can move per control structure.
+#define     SSISTREAM_RING_SIZE     1024
+#define     SSISTREAM_RING_MASK     (SSISTREAM_RING_SIZE - 1)
+#define     SSISTREAM_DMA_MAX       1024
+
+// Stream instances
+#define     SSISTREAM_AD9834        0       // SSI0, 16-bit frames, SPI mode 2
+#define     SSISTREAM_AD9952        1       // SSI3, 8-bit frames, SPI mode 0
+#define     SSISTREAM_COUNT         2
+
+// Peripherals SSIStreamPortInit() brings up for an instance: the SSI, its pins and
+// the uDMA
+#define     SSISTREAM_PERIPHS(instance)                                                 \
+                ((((instance) == SSISTREAM_AD9834) ?                                    \
+                     (HAL_PERIPH_SSI(HAL_SSI_0) | HAL_PERIPH_GPIO(HAL_PORT_A)) :        \
+                     (HAL_PERIPH_SSI(HAL_SSI_3) | HAL_PERIPH_GPIO(HAL_PORT_Q))) |       \
+                 HAL_PERIPH_UDMA)
+
+// Ping-pong slots
+#define     SSISTREAM_SLOT_PRI      0
+#define     SSISTREAM_SLOT_ALT      1
+
+// Type Definitions
+//
+// head is only written by the producer and tail only by the completion interrupt,
+// so neither side needs to mask interrupts.  Both are free-running; the ring index
+// is the value masked with SSISTREAM_RING_MASK.
+//
+typedef struct {
+
+    uint16_t ring[SSISTREAM_RING_SIZE];
+
+    volatile uint32_t head;         // Next free element (producer)
+    volatile uint32_t tail;         // Oldest element not yet sent (ISR)
+
+    uint32_t dmaHead;               // Next element to hand to the uDMA (ISR)
+    uint32_t slotCount[2];          // Elements armed in each slot (ISR)
+    uint32_t nextSlot;              // Slot the controller will run next (ISR)
+
+    uint32_t instance;              // SSISTREAM_AD9834 or SSISTREAM_AD9952
+    uint32_t bitCycles;             // System clocks per SSI bit, 0 until the port is up
+
+    //
+    // Statistics
+    //
+    volatile uint32_t framesQueued;
+    volatile uint32_t elementsSent;
+    volatile uint32_t rejected;
+    volatile uint32_t highWater;
+    volatile uint32_t interrupts;
+
+} tSSIStream;
+
+extern tSSIStream g_ssiStreams[SSISTREAM_COUNT];
+
+// Function Prototypes
+//
+// Portable ring logic (SSIStream.c)
+//
+extern void SSIStreamInit(tSSIStream *stream, uint32_t instance);
+extern bool SSIStreamQueue(tSSIStream *stream, const uint16_t *elements,
+                           uint32_t count);
+extern bool SSIStreamQueueAD9834Freq(tSSIStream *stream, uint16_t ctrl,
+                                     uint16_t reg, uint32_t word);
+extern bool SSIStreamQueueAD9952(tSSIStream *stream, uint8_t reg, uint32_t value);
+extern uint32_t SSIStreamDepth(const tSSIStream *stream);
+extern bool SSIStreamIdle(const tSSIStream *stream);
+extern void SSIStreamService(tSSIStream *stream);
+
+//
+// Port layer (SSIStreamTiva.c on target, Host/SSIStreamHost.c on a host build).
+// Host/Tools/SSIStreamTool.c supplies one that models the uDMA and the SSI bit
+// timing, to check the ring under load.
+//
+extern void SSIStreamPortInit(tSSIStream *stream, uint32_t sysClkHz,
+                              uint32_t bitRate);
+extern void SSIStreamPortArm(tSSIStream *stream, uint32_t slot,
+                             const uint16_t *src, uint32_t count);
+extern uint32_t SSIStreamPortStoppedSlots(tSSIStream *stream);
+extern void SSIStreamPortKick(tSSIStream *stream);
+
+#endif /* SSISTREAM_H_ */
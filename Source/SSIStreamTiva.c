@@ -0,0 +1,234 @@
+//************************************************************************************
+//
+// Title:               SSI Register Frame Stream - TM4C1294 Port
+// Author:              Jacob Putz
+// Filename:            SSIStreamTiva.c
+//
+// Description:     SSI and uDMA port layer for SSIStream.c.  The AD9834 stream runs
+//                      on SSI0 (PA2 CLK, PA3 FSS, PA4 DAT0) with 16-bit SPI mode 2
+//                      frames, the AD9952 stream on SSI3 (PQ0 CLK, PQ1 FSS, PQ2 DAT0)
+//                      with 8-bit SPI mode 0 frames.  Each stream has one uDMA TX
+//                      channel used in ping-pong mode and one interrupt that fires on
+//                      uDMA completion.
+//
+// Current Revision:    0.1.2
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.2    -       Record the SSI bit period.
+//
+// 0.1.1    -       Configure the SSI and its pins through HalSsiInit().
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/ssi.h"
+#include "driverlib/udma.h"
+#include "DMAControl.h"
+#include "Hal.h"
+#include "Profile.h"
+#include "SSIStream.h"
+
+// Type Definitions
+typedef struct {
+
+    uint32_t halSsi;
+    uint32_t ssiBase;
+    uint32_t mode;
+    uint32_t dataWidth;
+    uint32_t dmaChannel;
+    uint32_t dmaAssign;
+    uint32_t intNum;
+
+} tSSIStreamHW;
+
+// Global Constants
+static const tSSIStreamHW g_ssiStreamHW[SSISTREAM_COUNT] = {
+
+    //
+    // AD9834: FSYNC is sampled on the falling edge of SCLK with SCLK idling high.
+    //
+    { HAL_SSI_0, SSI0_BASE, HAL_SSI_MODE_2, 16, 11, UDMA_CH11_SSI0TX, INT_SSI0 },
+
+    //
+    // AD9952: SDIO is sampled on the rising edge of SCLK with SCLK idling low.
+    //
+    { HAL_SSI_3, SSI3_BASE, HAL_SSI_MODE_0, 8, 15, UDMA_CH15_SSI3TX, INT_SSI3 },
+
+};
+
+//************************************************************************************
+//
+// Completion interrupts.  The SSI raises SSI_DMATX when its TX channel finishes a
+// control structure; the same vector is pended by SSIStreamPortKick().  Neither
+// source leaves a timestamp behind, so entry latency is not measured here.
+//
+//************************************************************************************
+static void SSIStreamAD9834Handler(void) {
+
+    PROFILE_ISR_ENTER(PROFILE_ID_SSI_AD9834);
+
+    SSIIntClear(SSI0_BASE, SSI_DMATX);
+    SSIStreamService(&g_ssiStreams[SSISTREAM_AD9834]);
+
+    PROFILE_ISR_EXIT(PROFILE_ID_SSI_AD9834, 0);
+
+}
+
+static void SSIStreamAD9952Handler(void) {
+
+    PROFILE_ISR_ENTER(PROFILE_ID_SSI_AD9952);
+
+    SSIIntClear(SSI3_BASE, SSI_DMATX);
+    SSIStreamService(&g_ssiStreams[SSISTREAM_AD9952]);
+
+    PROFILE_ISR_EXIT(PROFILE_ID_SSI_AD9952, 0);
+
+}
+
+//************************************************************************************
+//
+// Bring up the SSI, its pins and its uDMA channel.  sysClkHz is the actual system
+// clock returned by SysCtlClockFreqSet().
+//
+//************************************************************************************
+void SSIStreamPortInit(tSSIStream *stream, uint32_t sysClkHz, uint32_t bitRate) {
+
+    const tSSIStreamHW *hw = &g_ssiStreamHW[stream->instance];
+
+    DMAControlInit();
+
+    //
+    // Configure the SSI and its pins
+    //
+    HalSsiInit(hw->halSsi, sysClkHz, bitRate, hw->mode, hw->dataWidth);
+    SSIDMAEnable(hw->ssiBase, SSI_DMA_TX);
+
+    //
+    // Rounded up, so a step rate limit derived from it errs on the slow side of
+    // whichever divider SSIConfigSetExpClk() picked.
+    //
+    stream->bitCycles = (sysClkHz + bitRate - 1) / bitRate;
+
+    //
+    // Configure the uDMA channel.  Both control structures move 16-bit elements
+    // from the ring into the data register; in 8-bit mode the SSI ignores the
+    // upper byte.
+    //
+    uDMAChannelAssign(hw->dmaAssign);
+    uDMAChannelAttributeDisable(hw->dmaChannel, UDMA_ATTR_ALL);
+    uDMAChannelAttributeEnable(hw->dmaChannel, UDMA_ATTR_USEBURST);
+    uDMAChannelControlSet(hw->dmaChannel | UDMA_PRI_SELECT,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_16 | UDMA_DST_INC_NONE |
+                          UDMA_ARB_4);
+    uDMAChannelControlSet(hw->dmaChannel | UDMA_ALT_SELECT,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_16 | UDMA_DST_INC_NONE |
+                          UDMA_ARB_4);
+
+    //
+    // Configure the completion interrupt
+    //
+    if (stream->instance == SSISTREAM_AD9834) {
+
+        SSIIntRegister(hw->ssiBase, SSIStreamAD9834Handler);
+
+    }
+
+    else {
+
+        SSIIntRegister(hw->ssiBase, SSIStreamAD9952Handler);
+
+    }
+
+    SSIIntClear(hw->ssiBase, SSI_DMATX);
+    SSIIntEnable(hw->ssiBase, SSI_DMATX);
+    IntEnable(hw->intNum);
+
+}
+
+//************************************************************************************
+//
+// Load one control structure and make sure the channel is running.  Enabling an
+// already enabled channel is harmless, so this is safe whether or not the other
+// slot is still in flight.
+//
+//************************************************************************************
+void SSIStreamPortArm(tSSIStream *stream, uint32_t slot, const uint16_t *src,
+                      uint32_t count) {
+
+    const tSSIStreamHW *hw = &g_ssiStreamHW[stream->instance];
+    uint32_t select = (slot == SSISTREAM_SLOT_PRI) ? UDMA_PRI_SELECT : UDMA_ALT_SELECT;
+
+    uDMAChannelTransferSet(hw->dmaChannel | select, UDMA_MODE_PINGPONG, (void *)src,
+                           (void *)(hw->ssiBase + SSI_O_DR), count);
+    uDMAChannelEnable(hw->dmaChannel);
+
+}
+
+//************************************************************************************
+//
+// A control structure reads back as UDMA_MODE_STOP once the controller has
+// finished it.
+//
+//************************************************************************************
+uint32_t SSIStreamPortStoppedSlots(tSSIStream *stream) {
+
+    const tSSIStreamHW *hw = &g_ssiStreamHW[stream->instance];
+    uint32_t stopped = 0;
+
+    if (uDMAChannelModeGet(hw->dmaChannel | UDMA_PRI_SELECT) == UDMA_MODE_STOP) {
+
+        stopped |= 1 << SSISTREAM_SLOT_PRI;
+
+    }
+
+    if (uDMAChannelModeGet(hw->dmaChannel | UDMA_ALT_SELECT) == UDMA_MODE_STOP) {
+
+        stopped |= 1 << SSISTREAM_SLOT_ALT;
+
+    }
+
+    return stopped;
+
+}
+
+//************************************************************************************
+//
+// Run the completion interrupt from thread context so that new frames are armed by
+// the same code, at the same priority, as retired ones.
+//
+//************************************************************************************
+void SSIStreamPortKick(tSSIStream *stream) {
+
+    IntPendSet(g_ssiStreamHW[stream->instance].intNum);
+
+}
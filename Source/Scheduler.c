@@ -0,0 +1,303 @@
+//************************************************************************************
+//
+// Title:               Tickless Event Scheduler
+// Author:              Jacob Putz
+// Filename:            Scheduler.c
+//
+// Description:     Binary min-heap scheduler.  Tasks run to completion from thread
+//                      context and reschedule themselves with SchedulerDefer(), which
+//                      advances from the previous deadline rather than from the
+//                      dispatch time so periodic tasks never drift.  Nothing in this
+//                      file touches hardware; see SchedulerPort.c for the one-shot
+//                      timer and sleep port.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Profile.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
+
+// Global Variables
+tSchedStats g_schedStats;
+
+static tSchedTask *g_schedHeap[SCHED_MAX_TASKS];
+static uint32_t g_schedCount = 0;
+
+//************************************************************************************
+//
+// Heap helpers.  Every move keeps task->heapIndex in step so removal is O(log n).
+//
+//************************************************************************************
+static void SchedulerPlace(tSchedTask *task, uint32_t index) {
+
+    g_schedHeap[index] = task;
+    task->heapIndex = index;
+
+}
+
+static void SchedulerSiftUp(uint32_t index) {
+
+    tSchedTask *task = g_schedHeap[index];
+
+    while (index > 0) {
+
+        uint32_t parent = (index - 1) >> 1;
+
+        if (g_schedHeap[parent]->deadline <= task->deadline) {
+
+            break;
+
+        }
+
+        SchedulerPlace(g_schedHeap[parent], index);
+        index = parent;
+
+    }
+
+    SchedulerPlace(task, index);
+
+}
+
+static void SchedulerSiftDown(uint32_t index) {
+
+    tSchedTask *task = g_schedHeap[index];
+
+    while (1) {
+
+        uint32_t child = (index << 1) + 1;
+
+        if (child >= g_schedCount) {
+
+            break;
+
+        }
+
+        if (((child + 1) < g_schedCount) &&
+            (g_schedHeap[child + 1]->deadline < g_schedHeap[child]->deadline)) {
+
+            child++;
+
+        }
+
+        if (task->deadline <= g_schedHeap[child]->deadline) {
+
+            break;
+
+        }
+
+        SchedulerPlace(g_schedHeap[child], index);
+        index = child;
+
+    }
+
+    SchedulerPlace(task, index);
+
+}
+
+//************************************************************************************
+//
+// Empty the heap and reset statistics.  The timebase must already be running.
+//
+//************************************************************************************
+void SchedulerInit(void) {
+
+    g_schedCount = 0;
+
+    g_schedStats.dispatched = 0;
+    g_schedStats.lateSumUs = 0;
+    g_schedStats.lateMaxUs = 0;
+    g_schedStats.idleCycles = 0;
+    g_schedStats.startCycles = TimeBaseCycles();
+
+}
+
+void SchedulerTaskInit(tSchedTask *task, tSchedFn fn, void *arg) {
+
+    task->deadline = 0;
+    task->fn = fn;
+    task->arg = arg;
+    task->heapIndex = SCHED_NOT_QUEUED;
+
+}
+
+//************************************************************************************
+//
+// Queue task for an absolute deadline.  A task that is already queued is moved.
+// Returns false if the heap is full.
+//
+//************************************************************************************
+bool SchedulerAdd(tSchedTask *task, uint64_t deadline) {
+
+    if (task->heapIndex != SCHED_NOT_QUEUED) {
+
+        SchedulerRemove(task);
+
+    }
+
+    if (g_schedCount >= SCHED_MAX_TASKS) {
+
+        return false;
+
+    }
+
+    task->deadline = deadline;
+    g_schedHeap[g_schedCount] = task;
+    SchedulerSiftUp(g_schedCount++);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Queue task delayUs after its previous deadline.
+//
+//************************************************************************************
+bool SchedulerDefer(tSchedTask *task, uint32_t delayUs) {
+
+    return SchedulerAdd(task, task->deadline + delayUs);
+
+}
+
+void SchedulerRemove(tSchedTask *task) {
+
+    uint32_t index = task->heapIndex;
+    tSchedTask *moved;
+
+    if (index == SCHED_NOT_QUEUED) {
+
+        return;
+
+    }
+
+    task->heapIndex = SCHED_NOT_QUEUED;
+
+    if (--g_schedCount == index) {
+
+        return;
+
+    }
+
+    //
+    // Move the last element into the hole and restore heap order in whichever
+    // direction it is violated.
+    //
+    moved = g_schedHeap[g_schedCount];
+    SchedulerPlace(moved, index);
+    SchedulerSiftDown(index);
+    SchedulerSiftUp(moved->heapIndex);
+
+}
+
+uint64_t SchedulerNextDeadline(void) {
+
+    return (g_schedCount != 0) ? g_schedHeap[0]->deadline : UINT64_MAX;
+
+}
+
+//************************************************************************************
+//
+// Run every task whose deadline has passed, then sleep until the next one.  Call
+// from the main loop; each call sleeps at most SCHED_IDLE_MAX_US.
+//
+//************************************************************************************
+void SchedulerPoll(void) {
+
+    uint64_t now = TimeBaseMicros();
+    uint64_t next;
+    uint64_t sleepStart;
+
+    while ((g_schedCount != 0) && (g_schedHeap[0]->deadline <= now)) {
+
+        tSchedTask *task = g_schedHeap[0];
+        uint64_t late = now - task->deadline;
+        PROFILE_BEGIN(PROFILE_ID_SCHED_DISPATCH);
+
+        //
+        // Pop the root before dispatching so the task is free to requeue itself.
+        //
+        task->heapIndex = SCHED_NOT_QUEUED;
+
+        if (--g_schedCount != 0) {
+
+            SchedulerPlace(g_schedHeap[g_schedCount], 0);
+            SchedulerSiftDown(0);
+
+        }
+
+        g_schedStats.dispatched++;
+        g_schedStats.lateSumUs += late;
+
+        if (late > g_schedStats.lateMaxUs) {
+
+            g_schedStats.lateMaxUs = (uint32_t)late;
+
+        }
+
+        task->fn(task, now);
+        PROFILE_END(PROFILE_ID_SCHED_DISPATCH);
+        now = TimeBaseMicros();
+
+    }
+
+    next = SchedulerNextDeadline();
+
+    if (next > (now + SCHED_IDLE_MAX_US)) {
+
+        next = now + SCHED_IDLE_MAX_US;
+
+    }
+
+    sleepStart = TimeBaseCycles();
+    SchedulerPortSleepUntil(next);
+    g_schedStats.idleCycles += TimeBaseCycles() - sleepStart;
+
+}
+
+//************************************************************************************
+//
+// Share of elapsed time spent asleep since SchedulerInit(), in percent.
+//
+//************************************************************************************
+uint32_t SchedulerIdlePercent(void) {
+
+    uint64_t elapsed = TimeBaseCycles() - g_schedStats.startCycles;
+
+    if (elapsed == 0) {
+
+        return 0;
+
+    }
+
+    return (uint32_t)((g_schedStats.idleCycles * 100) / elapsed);
+
+}
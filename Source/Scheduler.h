@@ -0,0 +1,107 @@
+//************************************************************************************
+//
+// Title:               Tickless Event Scheduler
+// Author:              Jacob Putz
+// Filename:            Scheduler.h
+//
+// Description:     Min-heap of timed tasks keyed on 64-bit microsecond deadlines.
+//                      Dispatch and insertion are O(log n).  Between events the core
+//                      sleeps until the earliest deadline, which the port programs into
+//                      a one-shot GPTM so nothing wakes the CPU early.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Add SCHED_TIMER and SCHED_PERIPHS for the boot sequencer.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+
+// Defines
+#ifndef SCHED_MAX_TASKS
+#define     SCHED_MAX_TASKS         32
+#endif
+
+// Longest sleep when nothing is scheduled
+#define     SCHED_IDLE_MAX_US       1000000
+
+// Wake-up timer used by SchedulerPort.c, and the peripherals it needs
+#define     SCHED_TIMER             HAL_TIMER_5
+#define     SCHED_PERIPHS           HAL_PERIPH_TIMER(SCHED_TIMER)
+
+// Type Definitions
+struct tSchedTask;
+typedef void (*tSchedFn)(struct tSchedTask *task, uint64_t now);
+
+typedef struct tSchedTask {
+
+    uint64_t deadline;      // Absolute TimeBaseMicros() deadline
+    tSchedFn fn;            // Called once the deadline has passed
+    void *arg;              // Caller data
+    uint32_t heapIndex;     // Position in the heap, SCHED_NOT_QUEUED if idle
+
+} tSchedTask;
+
+#define     SCHED_NOT_QUEUED        0xFFFFFFFF
+
+typedef struct {
+
+    uint32_t dispatched;    // Tasks run
+    uint64_t lateSumUs;     // Sum of (dispatch time - deadline)
+    uint32_t lateMaxUs;     // Worst dispatch lateness
+    uint64_t idleCycles;    // Cycles spent asleep in SchedulerPoll()
+    uint64_t startCycles;   // TimeBaseCycles() at SchedulerInit()
+
+} tSchedStats;
+
+extern tSchedStats g_schedStats;
+
+// Function Prototypes
+//
+// Portable core (Scheduler.c)
+//
+extern void SchedulerInit(void);
+extern void SchedulerTaskInit(tSchedTask *task, tSchedFn fn, void *arg);
+extern bool SchedulerAdd(tSchedTask *task, uint64_t deadline);
+extern bool SchedulerDefer(tSchedTask *task, uint32_t delayUs);
+extern void SchedulerRemove(tSchedTask *task);
+extern uint64_t SchedulerNextDeadline(void);
+extern void SchedulerPoll(void);
+extern uint32_t SchedulerIdlePercent(void);
+
+//
+// Port layer (SchedulerPort.c, on the HAL)
+//
+extern void SchedulerPortInit(uint32_t sysClkHz);
+extern void SchedulerPortSleepUntil(uint64_t deadline);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,130 @@
+//************************************************************************************
+//
+// Title:               Tickless Event Scheduler - Port
+// Author:              Jacob Putz
+// Filename:            SchedulerPort.c
+//
+// Description:     One-shot wake timer and sleep for Scheduler.c, written against
+//                      Hal.h (Timer 5A and WFI on target).  The timer interrupt
+//                      exists only to wake the core; all work happens in
+//                      SchedulerPoll().
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Take SCHED_TIMER from Scheduler.h.
+//
+// 0.2.1    -       Let the power manager choose between WFI and deep sleep.
+//
+// 0.2.0    -       Move from SchedulerTiva.c onto the HAL.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Power.h"
+#include "Scheduler.h"
+#include "TimeBase.h"
+
+//************************************************************************************
+//
+// Wake-up interrupt.  The HAL has already cleared the flag, and returning from the
+// handler is all it takes to bring the core out of WFI.
+//
+//************************************************************************************
+static void SchedulerTimerHandler(void) {
+
+}
+
+void SchedulerPortInit(uint32_t sysClkHz) {
+
+    (void)sysClkHz;
+
+    HalTimerInit(SCHED_TIMER, SchedulerTimerHandler);
+
+}
+
+//************************************************************************************
+//
+// Arm the one-shot for the deadline and sleep.  Interrupts are masked around the
+// final check so a wake-up that lands between the check and WFI stays pending and
+// makes WFI return immediately instead of being lost.  The power manager picks
+// the depth.
+//
+//************************************************************************************
+void SchedulerPortSleepUntil(uint64_t deadline) {
+
+    uint64_t now;
+    uint64_t cycles;
+    uint32_t state;
+
+    HalIntMasterDisable();
+
+    now = TimeBaseMicros();
+
+    if (deadline > now) {
+
+        cycles = (deadline - now) * g_timeBase.cyclesPerUs;
+
+        if (cycles > 0xFFFFFFFFULL) {
+
+            cycles = 0xFFFFFFFFULL;
+
+        }
+
+        state = PowerDecide(now, deadline);
+
+        if (state == POWER_STATE_DEEP) {
+
+            //
+            // The SysTick interrupts missed while the PLL was down are replayed
+            // here, before anything else can read the time base.
+            //
+            if (HalDeepSleep(SCHED_TIMER, (uint32_t)cycles,
+                             g_power.relockUs * g_timeBase.cyclesPerUs) != 0) {
+
+                TimeBaseCatchUp();
+
+            }
+
+        }
+
+        else {
+
+            HalTimerStart(SCHED_TIMER, (uint32_t)cycles, false);
+            HalSleep();
+
+        }
+
+        PowerWoke(state, deadline, TimeBaseMicros());
+
+    }
+
+    HalIntMasterEnable();
+
+}
@@ -0,0 +1,148 @@
+//************************************************************************************
+//
+// Title:               Software DDS Model
+// Author:              Jacob Putz
+// Filename:            SoftDDS.c
+//
+// Description:     Table construction, configuration and the scalar reference
+//                      renderer for the software DDS.  The ports' vectorised renderers
+//                      are checked against SoftDDSRenderRef().
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Build the table in place; the stack has no room for a copy.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdint.h>
+#include "DDSTuning.h"
+#include "SoftDDS.h"
+
+// Global Variables
+uint32_t g_softDDSPairs[SOFTDDS_LUT_SIZE];
+
+//************************************************************************************
+//
+// Build the packed table.  Only the first quadrant is evaluated; the rest follows
+// by symmetry so the table is exactly odd and half-wave symmetric whatever the
+// libm rounding.  Runs once at start-up (256 double-precision sines).
+//
+// The samples are built in the low halves of the table itself, then each entry
+// takes its neighbour's low half as its high half; a separate 2 KB sample array
+// would not fit on the 512 byte system stack.
+//
+//************************************************************************************
+void SoftDDSInit(void) {
+
+    uint32_t *pairs = g_softDDSPairs;
+    uint32_t quarter = SOFTDDS_LUT_SIZE / 4;
+    uint32_t i;
+
+    for (i = 0; i <= quarter; i++) {
+
+        pairs[i] = (uint16_t)(int16_t)floor(SOFTDDS_PEAK *
+                                            sin((6.283185307179586 * i) /
+                                                SOFTDDS_LUT_SIZE) + 0.5);
+
+    }
+
+    for (i = quarter + 1; i < (SOFTDDS_LUT_SIZE / 2); i++) {
+
+        pairs[i] = pairs[(SOFTDDS_LUT_SIZE / 2) - i];
+
+    }
+
+    for (i = SOFTDDS_LUT_SIZE / 2; i < SOFTDDS_LUT_SIZE; i++) {
+
+        pairs[i] = (uint16_t)-(int16_t)pairs[i - (SOFTDDS_LUT_SIZE / 2)];
+
+    }
+
+    for (i = 0; i < SOFTDDS_LUT_SIZE; i++) {
+
+        pairs[i] |= (pairs[(i + 1) & (SOFTDDS_LUT_SIZE - 1)] & 0xFFFF) << 16;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Model a part programmed with freqWord and phaseWord, in the register widths of
+// tuning.  Rendering starts at sample zero.
+//
+//************************************************************************************
+void SoftDDSConfigure(tSoftDDS *dds, const tDDSTuning *tuning, uint32_t freqWord,
+                      uint32_t phaseWord) {
+
+    dds->step = freqWord << (32 - tuning->freqBits);
+    dds->offset = phaseWord << (32 - tuning->phaseBits);
+    dds->phase = dds->offset;
+
+}
+
+//************************************************************************************
+//
+// Jump to absolute sample number sample.  The accumulator wraps, so this is exact
+// for any distance.
+//
+//************************************************************************************
+void SoftDDSSeek(tSoftDDS *dds, uint32_t sample) {
+
+    dds->phase = dds->offset + (sample * dds->step);
+
+}
+
+//************************************************************************************
+//
+// Scalar reference: the formula in the header, one sample at a time.
+//
+//************************************************************************************
+void SoftDDSRenderRef(tSoftDDS *dds, int16_t *samples, uint32_t count) {
+
+    uint32_t phase = dds->phase;
+    uint32_t pair, weights;
+    int32_t acc;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+
+        pair = g_softDDSPairs[phase >> SOFTDDS_INDEX_SHIFT];
+        weights = SoftDDSWeights(phase);
+        acc = (int32_t)(int16_t)pair * (int32_t)(weights & 0xFFFF) +
+              (int32_t)(int16_t)(pair >> 16) * (int32_t)(weights >> 16) +
+              (int32_t)(SOFTDDS_ONE / 2);
+        samples[i] = (int16_t)(acc >> SOFTDDS_FRAC_BITS);
+        phase += dds->step;
+
+    }
+
+    dds->phase = phase;
+
+}
@@ -0,0 +1,129 @@
+//************************************************************************************
+//
+// Title:               Software DDS Model
+// Author:              Jacob Putz
+// Filename:            SoftDDS.h
+//
+// Description:     Phase accumulator and interpolated sine lookup that computes the
+//                      ideal output samples for a tuning word and phase offset, for
+//                      verification, spur prediction and amplitude calibration before
+//                      the hardware is programmed.  The portable core holds the table
+//                      and the scalar reference; each port supplies a vectorised
+//                      renderer that must match the reference bit for bit.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Point to the host check.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef SOFTDDS_H_
+#define SOFTDDS_H_
+
+#include <stdint.h>
+#include "DDSTuning.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Every part is modelled with a 32-bit accumulator; narrower tuning and phase
+//  words are left-justified into it, which is exact.  For each sample
+//
+//      index   = phase >> 22                   top SOFTDDS_LUT_BITS bits
+//      frac    = (phase >> 8) & 0x3FFF         next SOFTDDS_FRAC_BITS bits
+//      sample  = (lut[index] * (2^14 - frac) + lut[index + 1] * frac + 2^13) >> 14
+//
+//  The table stores lut[index] and lut[index + 1] packed into one word (low and
+//  high halfword), and the weights pack the same way, so a sample is one load
+//  and a single dual 16x16 multiply-accumulate: SMLAD on the Cortex-M4 and
+//  PMADDWD on x86.  Every intermediate fits in 32 bits, so the vector and scalar
+//  paths agree exactly.  Samples are Q15 with a peak of SOFTDDS_PEAK.
+//
+//  The model is the ideal waveform (interpolated, no phase truncation or DAC
+//  quantisation), which is what spur and calibration work compares against.
+//
+//  Host/Tools/SoftDDSTool.c checks the port's SoftDDSRender() sample for sample
+//  against SoftDDSRenderRef(), and both against a double precision sine.
+//
+//************************************************************************************
+
+// Defines
+#define     SOFTDDS_LUT_BITS        10
+#define     SOFTDDS_LUT_SIZE        (1 << SOFTDDS_LUT_BITS)
+#define     SOFTDDS_FRAC_BITS       14
+#define     SOFTDDS_INDEX_SHIFT     (32 - SOFTDDS_LUT_BITS)
+#define     SOFTDDS_FRAC_SHIFT      (SOFTDDS_INDEX_SHIFT - SOFTDDS_FRAC_BITS)
+#define     SOFTDDS_FRAC_MASK       ((1UL << SOFTDDS_FRAC_BITS) - 1)
+#define     SOFTDDS_ONE             (1UL << SOFTDDS_FRAC_BITS)
+#define     SOFTDDS_PEAK            32767
+
+// Type Definitions
+typedef struct {
+
+    uint32_t step;                  // Tuning word, left-justified to 32 bits
+    uint32_t offset;                // Phase offset, left-justified to 32 bits
+    uint32_t phase;                 // Accumulator for the next sample
+
+} tSoftDDS;
+
+// Global Variables
+//
+// lut[i] in the low halfword, lut[(i + 1) % SOFTDDS_LUT_SIZE] in the high halfword.
+// Built by SoftDDSInit().
+//
+extern uint32_t g_softDDSPairs[SOFTDDS_LUT_SIZE];
+
+//************************************************************************************
+//
+// Packed (2^14 - frac, frac) weights for an accumulator value.
+//
+//************************************************************************************
+static inline uint32_t SoftDDSWeights(uint32_t phase) {
+
+    uint32_t frac = (phase >> SOFTDDS_FRAC_SHIFT) & SOFTDDS_FRAC_MASK;
+
+    return (frac << 16) | (SOFTDDS_ONE - frac);
+
+}
+
+// Function Prototypes
+//
+// Portable core (SoftDDS.c)
+//
+extern void SoftDDSInit(void);
+extern void SoftDDSConfigure(tSoftDDS *dds, const tDDSTuning *tuning, uint32_t freqWord,
+                             uint32_t phaseWord);
+extern void SoftDDSSeek(tSoftDDS *dds, uint32_t sample);
+extern void SoftDDSRenderRef(tSoftDDS *dds, int16_t *samples, uint32_t count);
+
+//
+// Port layer (SoftDDSTiva.c on target, Host/SoftDDSHost.c on a host build)
+//
+extern void SoftDDSRender(tSoftDDS *dds, int16_t *samples, uint32_t count);
+
+#endif /* SOFTDDS_H_ */
@@ -0,0 +1,100 @@
+//************************************************************************************
+//
+// Title:               Software DDS Model - Cortex-M4 Port
+// Author:              Jacob Putz
+// Filename:            SoftDDSTiva.c
+//
+// Description:     SMLAD renderer for the software DDS.  Each sample is one table
+//                      load and one dual 16x16 multiply-accumulate; pairs of samples
+//                      are stored with a single PKHBT and word store.
+//
+// Current Revision:    0.1.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdint.h>
+#include "SoftDDS.h"
+
+//************************************************************************************
+//
+// TI ARM compiler intrinsics for the M4 DSP extension.  Other compilers (Clang or
+// GCC with ACLE) spell them differently; fall back to plain C so the file still
+// builds, at the cost of the speed-up.
+//
+//************************************************************************************
+#if defined(__TI_ARM__)
+#define     SOFTDDS_SMLAD(x, y, acc)    _smlad((int)(x), (int)(y), (int)(acc))
+#define     SOFTDDS_PKHBT(lo, hi)       ((uint32_t)_pkhbt((int)(lo), (int)(hi), 16))
+#elif defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#define     SOFTDDS_SMLAD(x, y, acc)    __smlad((x), (y), (acc))
+#define     SOFTDDS_PKHBT(lo, hi)       (((uint32_t)(lo) & 0xFFFF) | ((uint32_t)(hi) << 16))
+#else
+#define     SOFTDDS_SMLAD(x, y, acc)                                                \
+                ((int32_t)(int16_t)(x) * (int32_t)(int16_t)(y) +                    \
+                 (int32_t)(int16_t)((x) >> 16) * (int32_t)(int16_t)((y) >> 16) +    \
+                 (int32_t)(acc))
+#define     SOFTDDS_PKHBT(lo, hi)       (((uint32_t)(lo) & 0xFFFF) | ((uint32_t)(hi) << 16))
+#endif
+
+//************************************************************************************
+//
+// Two samples per iteration so the output goes out as whole words.  The sample
+// buffer must be 4-byte aligned; an odd count finishes with the reference.
+//
+//************************************************************************************
+void SoftDDSRender(tSoftDDS *dds, int16_t *samples, uint32_t count) {
+
+    const uint32_t *pairs = g_softDDSPairs;
+    uint32_t *out = (uint32_t *)samples;
+    uint32_t phase = dds->phase;
+    uint32_t step = dds->step;
+    int32_t s0, s1;
+    uint32_t i;
+
+    for (i = 0; i < (count / 2); i++) {
+
+        s0 = SOFTDDS_SMLAD(pairs[phase >> SOFTDDS_INDEX_SHIFT], SoftDDSWeights(phase),
+                           SOFTDDS_ONE / 2) >> SOFTDDS_FRAC_BITS;
+        phase += step;
+        s1 = SOFTDDS_SMLAD(pairs[phase >> SOFTDDS_INDEX_SHIFT], SoftDDSWeights(phase),
+                           SOFTDDS_ONE / 2) >> SOFTDDS_FRAC_BITS;
+        phase += step;
+        out[i] = SOFTDDS_PKHBT(s0, s1);
+
+    }
+
+    dds->phase = phase;
+
+    if (count & 1) {
+
+        SoftDDSRenderRef(dds, &samples[count - 1], 1);
+
+    }
+
+}
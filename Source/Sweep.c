@@ -0,0 +1,572 @@
+//************************************************************************************
+//
+// Title:               Frequency Sweep Engine
+// Author:              Jacob Putz
+// Filename:            Sweep.c
+//
+// Description:     Block generator and buffer bookkeeping for the sweep engine.
+//                      Linear sweeps step a Q32.32 word by a constant increment;
+//                      logarithmic sweeps multiply it by a Q2.62 ratio.  Both only need
+//                      integer adds and multiplies per step.  Nothing in this file
+//                      touches hardware; see SweepTiva.c for the timer and uDMA port.
+//
+// Current Revision:    0.1.8
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.8    -       Pack AD9952 steps with the shadow's phase rather than zero.
+//
+// 0.1.7    -       Build blocks SWEEP_PACK_STEPS words at a time.
+//
+// 0.1.6    -       Give the log accumulator extra fraction bits while the word is
+//                  small, so rounding at the bottom of a wide sweep is not
+//                  multiplied up by the rest of it.
+//
+// 0.1.5    -       Refuse steps shorter than the SSI can send a record in, and
+//                  form the linear increment without overflowing.
+//
+// 0.1.4    -       Pack records and size steps through the DDSChip front end.
+//
+// 0.1.3    -       Split record packing out as SweepPackRecords() for the hop engine.
+//
+// 0.1.2    -       Invalidate the shadowed tuning registers when a sweep starts.
+//
+// 0.1.1    -       Play step records in place from flash (execute-in-place presets).
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Profile.h"
+#include "Scheduler.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "TimeBase.h"
+
+// Global Variables
+tSweep g_sweep;
+
+//************************************************************************************
+//
+// (a * b) >> 62 for a Q32.32 word and a Q2.62 ratio, from four 32x32->64
+// multiplies.  The result always fits 64 bits because the word is below 2^32 and
+// the ratio below 4.
+//
+//************************************************************************************
+static uint64_t SweepMulQ62(uint64_t a, uint64_t b) {
+
+    uint32_t al = (uint32_t)a, ah = (uint32_t)(a >> 32);
+    uint32_t bl = (uint32_t)b, bh = (uint32_t)(b >> 32);
+    uint64_t lo = (uint64_t)al * bl;
+    uint64_t mid1 = (uint64_t)ah * bl;
+    uint64_t mid2 = (uint64_t)al * bh;
+    uint64_t hi = (uint64_t)ah * bh;
+    uint64_t mid = (lo >> 32) + (uint32_t)mid1 + (uint32_t)mid2;
+
+    hi += (mid1 >> 32) + (mid2 >> 32) + (mid >> 32);
+
+    return (hi << 2) | ((uint32_t)mid >> 30);
+
+}
+
+//************************************************************************************
+//
+// Keep a log sweep's accumulator between 2^61 and 2^62 by moving its binary point.
+// A Q32.32 word that starts small would otherwise lose most of its significant
+// bits to each multiply's truncation, and a wide sweep multiplies that error up
+// by its whole ratio: from a word of 11 to the AD9952's top it ends hundreds of
+// LSBs low.  Above 2^30 the point stays at 32 fraction bits, where the word does
+// not overflow; the ratio is below 4, so the product fits before the shift.
+//
+//************************************************************************************
+static void SweepNormalize(tSweep *sweep) {
+
+    while ((sweep->accShift > 0) && (sweep->acc >= (1ULL << 62))) {
+
+        sweep->acc >>= 1;
+        sweep->accShift--;
+
+    }
+
+    while ((sweep->accShift < 31) && (sweep->acc < (1ULL << 61))) {
+
+        sweep->acc <<= 1;
+        sweep->accShift++;
+
+    }
+
+}
+
+//************************************************************************************
+//
+// The step records write the tuning registers behind the shadow's back.
+//
+//************************************************************************************
+static void SweepForgetShadow(uint32_t instance) {
+
+    if (instance == SSISTREAM_AD9834) {
+
+        DDSShadowAD9834Forget(&g_ad9834Shadow, DDSSHADOW_AD9834_FREQ0);
+
+    }
+
+    else {
+
+        DDSShadowAD9952Forget(&g_ad9952Shadow, DDSSHADOW_AD9952_REG(AD9952_REG_FTW0) |
+                                               DDSSHADOW_AD9952_REG(AD9952_REG_POW0));
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Configure a sweep of steps points from startQ32 to stopQ32 (either direction).
+// The only floating point is the logarithmic ratio, computed once here in double
+// precision.  Returns false for a configuration the generator cannot represent:
+// fewer than two steps, a step longer than the timer can count or shorter than
+// the SSI can send it in, a zero start word on a log sweep, or a log ratio of four
+// or more per step.
+//
+//************************************************************************************
+bool SweepConfigure(tSweep *sweep, uint32_t instance, const tDDSTuning *tuning,
+                    uint32_t shape, uint64_t startQ32, uint64_t stopQ32,
+                    uint32_t steps, uint32_t stepCycles, bool repeat) {
+
+    uint32_t startWord = DDSTuningFreqWord(tuning, startQ32);
+    uint32_t stopWord = DDSTuningFreqWord(tuning, stopQ32);
+
+    if (!DDSChipBuilt(instance) || (steps < 2) || (stepCycles == 0) ||
+        (stepCycles < SweepMinStepCycles(instance)) ||
+        (stepCycles > SWEEP_STEP_CYCLES_MAX) || (sweep->running)) {
+
+        return false;
+
+    }
+
+    if (shape == SWEEP_SHAPE_LOG) {
+
+        double ratio;
+
+        if ((startWord == 0) || (stopWord == 0)) {
+
+            return false;
+
+        }
+
+        ratio = exp(log((double)stopWord / (double)startWord) / (double)(steps - 1));
+
+        if (ratio >= 4.0) {
+
+            return false;
+
+        }
+
+        sweep->ratio = (uint64_t)(ratio * 4611686018427387904.0 + 0.5);   // 2^62
+        sweep->inc = 0;
+
+    }
+
+    //
+    // The span in Q32.32 needs all 64 bits, so it is divided as a magnitude and
+    // negated afterwards for a downward sweep.
+    //
+    else if (stopWord >= startWord) {
+
+        sweep->inc = ((uint64_t)(stopWord - startWord) << 32) / (steps - 1);
+        sweep->ratio = 0;
+
+    }
+
+    else {
+
+        sweep->inc = 0 - (((uint64_t)(startWord - stopWord) << 32) / (steps - 1));
+        sweep->ratio = 0;
+
+    }
+
+    sweep->instance = instance;
+    sweep->shape = shape;
+    sweep->startWord = startWord;
+    sweep->stopWord = stopWord;
+    sweep->steps = steps;
+    sweep->stepCycles = stepCycles;
+    sweep->repeat = repeat;
+    sweep->elemsPerStep = DDSChipStepElems(instance);
+
+    sweep->xipRecords = 0;
+    sweep->xipBlocks = 0;
+    sweep->underruns = 0;
+    sweep->genCycles = 0;
+    sweep->blocksGenerated = 0;
+
+    SweepRewind(sweep);
+
+    return true;
+
+}
+
+void SweepRewind(tSweep *sweep) {
+
+    sweep->index = 0;
+    sweep->acc = (uint64_t)sweep->startWord << 32;
+    sweep->accShift = 0;
+
+    if (sweep->shape == SWEEP_SHAPE_LOG) {
+
+        SweepNormalize(sweep);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Produce the next count tuning words.  A one-shot sweep holds its last word once
+// finished; a repeating sweep jumps back to the start.  Returns count.
+//
+//************************************************************************************
+uint32_t SweepGenerateWords(tSweep *sweep, uint32_t *words, uint32_t count) {
+
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+
+        if (sweep->index >= sweep->steps) {
+
+            if (!sweep->repeat) {
+
+                words[i] = sweep->stopWord;
+                continue;
+
+            }
+
+            SweepRewind(sweep);
+
+        }
+
+        //
+        // The end point is written exactly rather than accumulated so rounding in
+        // the increment or ratio never shows up as a missed stop frequency.
+        //
+        if (sweep->index == (sweep->steps - 1)) {
+
+            words[i] = sweep->stopWord;
+
+        }
+
+        else {
+
+            words[i] = (uint32_t)((sweep->acc + (0x80000000ULL << sweep->accShift)) >>
+                                  (32 + sweep->accShift));
+
+        }
+
+        if (sweep->shape == SWEEP_SHAPE_LOG) {
+
+            sweep->acc = SweepMulQ62(sweep->acc, sweep->ratio);
+            SweepNormalize(sweep);
+
+        }
+
+        else {
+
+            sweep->acc += sweep->inc;
+
+        }
+
+        sweep->index++;
+
+    }
+
+    return count;
+
+}
+
+//************************************************************************************
+//
+// Pack count tuning words into step records for instance, each AD9952 record
+// with phase as its POW0.  Shared by the sweep generator, the hop engine and the
+// preset builder so all three emit identical records.
+//
+//************************************************************************************
+void SweepPackRecords(uint32_t instance, const uint32_t *words, uint16_t *record,
+                      uint32_t count, uint32_t phase) {
+
+    DDSChipPackRecords(instance, words, record, count, phase);
+
+}
+
+//************************************************************************************
+//
+// Generate one block and pack it into step records, SWEEP_PACK_STEPS at a time.
+//
+//************************************************************************************
+void SweepFillBlock(tSweep *sweep, uint16_t *record) {
+
+    uint32_t words[SWEEP_PACK_STEPS];
+    uint32_t elems = DDSChipStepElems(sweep->instance);
+    uint32_t i;
+
+    for (i = 0; i < SWEEP_BLOCK_STEPS; i += SWEEP_PACK_STEPS) {
+
+        SweepGenerateWords(sweep, words, SWEEP_PACK_STEPS);
+        SweepPackRecords(sweep->instance, words, &record[i * elems],
+                         SWEEP_PACK_STEPS, sweep->phaseWord);
+
+    }
+
+    sweep->blocksGenerated++;
+
+}
+
+//************************************************************************************
+//
+// Highest step rate the SSI can sustain at bitRate.
+//
+//************************************************************************************
+uint32_t SweepMaxStepRate(uint32_t instance, uint32_t bitRate) {
+
+    return DDSChipMaxStepRate(instance, bitRate);
+
+}
+
+//************************************************************************************
+//
+// Shortest step, in system clock cycles, that instance's SSI can send a whole
+// record in at the rate its port was brought up with.  Zero before
+// SSIStreamPortInit(), so an offline build (the preset tool) is not limited.
+//
+//************************************************************************************
+uint32_t SweepMinStepCycles(uint32_t instance) {
+
+    return DDSChipStepBits(instance) * g_ssiStreams[instance].bitCycles;
+
+}
+
+//************************************************************************************
+//
+// Refill task.  Runs twice per block period so a freshly consumed buffer is always
+// regenerated well before the uDMA comes back to it.
+//
+//************************************************************************************
+static void SweepRefillTask(tSchedTask *task, uint64_t now) {
+
+    tSweep *sweep = (tSweep *)task->arg;
+    uint32_t halfBlockUs;
+    PROFILE_BEGIN(PROFILE_ID_SWEEP_REFILL);
+
+    (void)now;
+
+    if (!sweep->running) {
+
+        return;
+
+    }
+
+    SweepRefill(sweep);
+    PROFILE_END(PROFILE_ID_SWEEP_REFILL);
+
+    halfBlockUs = (uint32_t)(((uint64_t)sweep->stepCycles * (SWEEP_BLOCK_STEPS / 2)) /
+                             g_timeBase.cyclesPerUs);
+    SchedulerDefer(task, halfBlockUs ? halfBlockUs : 1);
+
+}
+
+//************************************************************************************
+//
+// Prime both buffers and start the timer.  The SSI stream for the same part must
+// be idle because the sweep writes to the SSI data register directly.  The step
+// is checked against SweepMinStepCycles() again here in case the sweep was
+// configured before the SSI was brought up.
+//
+//************************************************************************************
+bool SweepStart(tSweep *sweep) {
+
+    uint64_t start;
+
+    if (sweep->running || !SSIStreamIdle(&g_ssiStreams[sweep->instance]) ||
+        (sweep->stepCycles < SweepMinStepCycles(sweep->instance))) {
+
+        return false;
+
+    }
+
+    sweep->xipRecords = 0;
+    sweep->phaseWord = g_ad9952Shadow.reg[AD9952_REG_POW0];
+
+    start = TimeBaseCycles();
+    SweepRewind(sweep);
+    SweepFillBlock(sweep, sweep->table[0]);
+    SweepFillBlock(sweep, sweep->table[1]);
+    sweep->genCycles += TimeBaseCycles() - start;
+
+    sweep->blocksFilled = 2;
+    sweep->blocksDone = 0;
+    sweep->running = true;
+
+    SchedulerTaskInit(&sweep->refillTask, SweepRefillTask, sweep);
+    SchedulerAdd(&sweep->refillTask, TimeBaseMicros());
+
+    SweepForgetShadow(sweep->instance);
+    SweepPortStart(sweep);
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Play pre-packed step records in place.  records must hold blocks whole blocks
+// (SWEEP_BLOCK_STEPS records each) and stay valid until the sweep stops; nothing
+// is copied and no refill task runs, so the time to the first step is just the
+// port start-up.  A one-shot table holds its last block once finished.  Presets
+// and hops start here, so this is where their step is held to the SSI's rate.
+//
+//************************************************************************************
+bool SweepStartXip(tSweep *sweep, uint32_t instance, const uint16_t *records,
+                   uint32_t blocks, uint32_t stepCycles, bool repeat) {
+
+    if (sweep->running || !DDSChipBuilt(instance) || (records == 0) || (blocks == 0) ||
+        (stepCycles == 0) || (stepCycles < SweepMinStepCycles(instance)) ||
+        (stepCycles > SWEEP_STEP_CYCLES_MAX) || !SSIStreamIdle(&g_ssiStreams[instance])) {
+
+        return false;
+
+    }
+
+    sweep->instance = instance;
+    sweep->stepCycles = stepCycles;
+    sweep->repeat = repeat;
+    sweep->elemsPerStep = DDSChipStepElems(instance);
+    sweep->xipRecords = records;
+    sweep->xipBlocks = blocks;
+    sweep->underruns = 0;
+
+    sweep->blocksFilled = 2;
+    sweep->blocksDone = 0;
+    sweep->running = true;
+
+    //
+    // Never queued, but SweepStop() removes it unconditionally.
+    //
+    SchedulerTaskInit(&sweep->refillTask, SweepRefillTask, sweep);
+
+    SweepForgetShadow(instance);
+    SweepPortStart(sweep);
+
+    return true;
+
+}
+
+void SweepStop(tSweep *sweep) {
+
+    if (!sweep->running) {
+
+        return;
+
+    }
+
+    SweepPortStop(sweep);
+    SchedulerRemove(&sweep->refillTask);
+    sweep->running = false;
+
+}
+
+//************************************************************************************
+//
+// Regenerate every buffer the uDMA has finished since the last call.  Buffers are
+// consumed strictly alternately, so block n always lives in table[n & 1].  If both
+// buffers were consumed before this ran, the uDMA has already replayed a stale
+// block and an underrun is recorded.
+//
+//************************************************************************************
+void SweepRefill(tSweep *sweep) {
+
+    uint32_t consumed = sweep->blocksDone + 2 - sweep->blocksFilled;
+    uint64_t start;
+
+    if (consumed >= 2) {
+
+        sweep->underruns++;
+
+    }
+
+    start = TimeBaseCycles();
+
+    while (consumed--) {
+
+        SweepFillBlock(sweep, sweep->table[sweep->blocksFilled & 1]);
+        sweep->blocksFilled++;
+
+    }
+
+    sweep->genCycles += TimeBaseCycles() - start;
+
+}
+
+//************************************************************************************
+//
+// Called by the port from the block-complete interrupt, after it has re-armed the
+// finished control structure.
+//
+//************************************************************************************
+void SweepBlockDone(tSweep *sweep) {
+
+    sweep->blocksDone++;
+
+}
+
+//************************************************************************************
+//
+// Where the uDMA should read block number block from.  The port calls this with
+// blocksDone + 2 when it re-arms a finished control structure, just before
+// SweepBlockDone().
+//
+//************************************************************************************
+const uint16_t *SweepBlockSource(const tSweep *sweep, uint32_t block) {
+
+    if (sweep->xipRecords == 0) {
+
+        return sweep->table[block & 1];
+
+    }
+
+    if (block >= sweep->xipBlocks) {
+
+        block = sweep->repeat ? (block % sweep->xipBlocks) : (sweep->xipBlocks - 1);
+
+    }
+
+    return sweep->xipRecords + (block * SWEEP_BLOCK_STEPS * sweep->elemsPerStep);
+
+}
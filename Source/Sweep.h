@@ -0,0 +1,218 @@
+//************************************************************************************
+//
+// Title:               Frequency Sweep Engine
+// Author:              Jacob Putz
+// Filename:            Sweep.h
+//
+// Description:     Linear and logarithmic sweeps for the AD9834 and AD9952.  Tuning
+//                      words are generated a block at a time and packed into ready-to-
+//                      send SSI records in a double-buffered SRAM table.  A GPTM
+//                      timeout then moves one record per step straight to the SSI with
+//                      the uDMA, so the only interrupt is a per-block buffer swap and
+//                      no arithmetic happens per step.
+//
+// Current Revision:    0.1.9
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.9    -       Carry the phase in AD9952 step records (phaseWord).
+//
+// 0.1.8    -       Add SweepPortIOUpdate().
+//
+// 0.1.7    -       Add SWEEP_PACK_STEPS.
+//
+// 0.1.6    -       Keep the log sweep accumulator's precision at small words, and
+//                  point to the host check.
+//
+// 0.1.5    -       Add SweepMinStepCycles().
+//
+// 0.1.4    -       Add SWEEP_PERIPHS.
+//
+// 0.1.3    -       Take the step record sizes from the part headers.
+//
+// 0.1.2    -       Add SweepPackRecords().
+//
+// 0.1.1    -       Play step records in place from flash (execute-in-place presets).
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "Hal.h"
+#include "DDSTuning.h"
+#include "Scheduler.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  A step record is the exact sequence of SSI elements for one frequency:
+//
+//      AD9834  (16-bit frames)     FREQ0 LSB, FREQ0 MSB                (B28 mode)
+//      AD9952  (8-bit frames)      FTW0 instr + 4 bytes, POW0 instr + 2 bytes
+//
+//  The AD9952 record carries a POW0 write so it is exactly 8 elements, which is a
+//  uDMA arbitration size.  It writes the phase the shadow holds when the records
+//  are packed (phaseWord, taken by SweepStart(); the hop engine takes it when it
+//  loads a sequence), so a sweep keeps a phase set before it.  Preset images are
+//  packed off the board with phase 0.  On the AD9834 the new frequency takes effect
+//  when the MSB frame completes; on the AD9952 it takes effect on IO_UPDATE, which
+//  the same timer drives from its PWM output one step after the data is shifted.
+//  Either way the latch edge is derived from the timer, not from software.
+//
+//  AD9952 registers written outside a sweep sit in the I/O buffer as well.
+//  SweepPortIOUpdate() gives them a single IO_UPDATE pulse on PL4; it must not be
+//  called while a sweep or hop runs, as the timer owns the line and pulses it
+//  every step anyway.
+//
+//  Host/Tools/SweepTool.c checks the words of both shapes against a double
+//  precision reference to within one LSB, and that a played sweep puts every step
+//  on the SSI at its cycle; its bench gives the generation cost per step beside
+//  the fastest step the SSI can send.
+//
+//************************************************************************************
+
+// Defines
+//
+// Steps per table block.  One block must fit a single uDMA control structure
+// (1024 elements at the AD9952's 8 elements per step).
+//
+#define     SWEEP_BLOCK_STEPS       128
+#define     SWEEP_ELEMS_MAX         8
+#define     SWEEP_ELEMS_AD9834      AD9834_STEP_ELEMS
+#define     SWEEP_ELEMS_AD9952      AD9952_STEP_ELEMS
+
+//
+// Tuning words generated and packed at a time when a block is built.  A whole
+// block of words (512 bytes) would fill the system stack.
+//
+#define     SWEEP_PACK_STEPS        16
+
+// Peripherals SweepPortInit() brings up: Timer 0 paces the steps, IO_UPDATE is on
+// PL4, the uDMA moves the records
+#define     SWEEP_PERIPHS           (HAL_PERIPH_TIMER(HAL_TIMER_0) |                      \
+                                     HAL_PERIPH_GPIO(HAL_PORT_L) | HAL_PERIPH_UDMA)
+
+// Longest step the 24-bit GPTM (16-bit count plus 8-bit prescale) can time
+#define     SWEEP_STEP_CYCLES_MAX   0x01000000
+
+// Sweep shapes
+#define     SWEEP_SHAPE_LINEAR      0
+#define     SWEEP_SHAPE_LOG         1
+
+// Type Definitions
+typedef struct {
+
+    //
+    // Configuration
+    //
+    uint32_t instance;              // SSISTREAM_AD9834 or SSISTREAM_AD9952
+    uint32_t shape;
+    uint32_t startWord;
+    uint32_t stopWord;
+    uint32_t steps;                 // Steps per sweep, including both end points
+    uint32_t stepCycles;            // Step period in system clock cycles
+    bool repeat;                    // Restart from startWord after stopWord
+    uint32_t elemsPerStep;
+    uint32_t phaseWord;             // AD9952 POW0 every generated step carries
+
+    //
+    // Generator state (thread)
+    //
+    uint32_t index;                 // Next step to generate
+    uint64_t acc;                   // Current word, Q32.32 with accShift more
+                                    // fraction bits
+    uint32_t accShift;              // Log sweeps only, 0 while the word is large
+    uint64_t inc;                   // Linear increment, Q32.32 two's complement
+    uint64_t ratio;                 // Logarithmic ratio, Q2.62
+    uint32_t blocksFilled;
+
+    //
+    // Execute-in-place source.  When xipRecords is set the uDMA reads whole blocks
+    // of step records straight from it (normally a flash preset) and the tables
+    // below are unused.
+    //
+    const uint16_t *xipRecords;
+    uint32_t xipBlocks;
+
+    //
+    // Output state
+    //
+    uint16_t table[2][SWEEP_BLOCK_STEPS * SWEEP_ELEMS_MAX];
+    volatile uint32_t blocksDone;   // Written by the block interrupt only
+    volatile bool running;
+    tSchedTask refillTask;
+
+    //
+    // Statistics
+    //
+    uint32_t underruns;
+    uint64_t genCycles;             // Cycles spent generating blocks
+    uint32_t blocksGenerated;
+
+} tSweep;
+
+// Global Variables
+//
+// The sweep owns Timer 0A, so there is a single engine.
+//
+extern tSweep g_sweep;
+
+// Function Prototypes
+//
+// Portable core (Sweep.c)
+//
+extern bool SweepConfigure(tSweep *sweep, uint32_t instance, const tDDSTuning *tuning,
+                           uint32_t shape, uint64_t startQ32, uint64_t stopQ32,
+                           uint32_t steps, uint32_t stepCycles, bool repeat);
+extern void SweepRewind(tSweep *sweep);
+extern uint32_t SweepGenerateWords(tSweep *sweep, uint32_t *words, uint32_t count);
+extern void SweepPackRecords(uint32_t instance, const uint32_t *words, uint16_t *record,
+                             uint32_t count, uint32_t phase);
+extern void SweepFillBlock(tSweep *sweep, uint16_t *record);
+extern uint32_t SweepMaxStepRate(uint32_t instance, uint32_t bitRate);
+extern uint32_t SweepMinStepCycles(uint32_t instance);
+extern bool SweepStart(tSweep *sweep);
+extern bool SweepStartXip(tSweep *sweep, uint32_t instance, const uint16_t *records,
+                         uint32_t blocks, uint32_t stepCycles, bool repeat);
+extern const uint16_t *SweepBlockSource(const tSweep *sweep, uint32_t block);
+extern void SweepStop(tSweep *sweep);
+extern void SweepRefill(tSweep *sweep);
+extern void SweepBlockDone(tSweep *sweep);
+
+//
+// Port layer (SweepTiva.c on target, Host/SweepHost.c on a host build)
+//
+extern void SweepPortInit(uint32_t sysClkHz);
+extern void SweepPortStart(tSweep *sweep);
+extern void SweepPortStop(tSweep *sweep);
+extern void SweepPortIOUpdate(void);
+
+#endif /* SWEEP_H_ */
@@ -0,0 +1,248 @@
+//************************************************************************************
+//
+// Title:               Frequency Sweep Engine - TM4C1294 Port
+// Author:              Jacob Putz
+// Filename:            SweepTiva.c
+//
+// Description:     Timer 0A and uDMA port for Sweep.c.  Timer 0A runs in PWM mode
+//                      at the step period; each timeout raises a uDMA burst request
+//                      that moves one step record from the table to the SSI data
+//                      register, and its PWM output on PL4 (T0CCP0) drives the AD9952
+//                      IO_UPDATE line.  The uDMA works through the two table buffers in
+//                      ping-pong mode; the timer's DMA-done interrupt only re-arms the
+//                      finished structure.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Add SweepPortIOUpdate().
+//
+// 0.1.3    -       Close the profile entry when the timer fires with no sweep.
+//
+// 0.1.2    -       Wait only for the peripherals to be ready; their clocks are
+//                  enabled at boot.
+//
+// 0.1.1    -       Play step records in place from flash (execute-in-place presets).
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_types.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+#include "DMAControl.h"
+#include "Hal.h"
+#include "Profile.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+
+// Defines
+#define     SWEEP_TIMER_BASE        TIMER0_BASE
+#define     SWEEP_TIMER_INT         INT_TIMER0A
+#define     SWEEP_DMA_CHANNEL       18
+#define     SWEEP_DMA_ASSIGN        UDMA_CH18_TIMER0A
+
+// IO_UPDATE pulse width in system clock cycles (AD9952 needs > 1 SYNC_CLK)
+#define     SWEEP_IOUPDATE_CYCLES   16
+
+// Global Variables
+static tSweep *g_sweepActive = 0;
+
+//************************************************************************************
+//
+// Return the SSI data register the records are written to.
+//
+//************************************************************************************
+static uint32_t SweepPortDest(const tSweep *sweep) {
+
+    return ((sweep->instance == SSISTREAM_AD9834) ? SSI0_BASE : SSI3_BASE) + SSI_O_DR;
+
+}
+
+//************************************************************************************
+//
+// Block-complete interrupt.  Re-arm whichever structure finished with the block two
+// ahead so the uDMA never stalls; SweepRefill() regenerates generated tables from
+// thread context before the controller comes back to them.  Block n always runs in
+// the primary structure when n is even, so the structures are checked in that order
+// in case both finished.  The timer has already reloaded and is counting down
+// again, so (load - value) is the entry latency.
+//
+//************************************************************************************
+static void SweepTimerHandler(void) {
+
+    tSweep *sweep = g_sweepActive;
+    uint32_t count;
+    uint32_t select;
+    PROFILE_ISR_ENTER(PROFILE_ID_SWEEP_BLOCK);
+
+    TimerIntClear(SWEEP_TIMER_BASE, TIMER_TIMA_DMA);
+
+    //
+    // A request left over from SweepPortStop() has nothing to re-arm, but its
+    // profile entry still has to be closed.
+    //
+    if (sweep == 0) {
+
+        PROFILE_ISR_EXIT(PROFILE_ID_SWEEP_BLOCK, 0);
+        return;
+
+    }
+
+    count = SWEEP_BLOCK_STEPS * sweep->elemsPerStep;
+
+    select = (sweep->blocksDone & 1) ? UDMA_ALT_SELECT : UDMA_PRI_SELECT;
+
+    while (uDMAChannelModeGet(SWEEP_DMA_CHANNEL | select) == UDMA_MODE_STOP) {
+
+        uDMAChannelTransferSet(SWEEP_DMA_CHANNEL | select, UDMA_MODE_PINGPONG,
+                               (void *)SweepBlockSource(sweep, sweep->blocksDone + 2),
+                               (void *)SweepPortDest(sweep), count);
+        SweepBlockDone(sweep);
+        select ^= UDMA_ALT_SELECT;
+
+    }
+
+    PROFILE_ISR_EXIT(PROFILE_ID_SWEEP_BLOCK, (sweep->stepCycles - 1) -
+                     (TimerValueGet(SWEEP_TIMER_BASE, TIMER_A) & 0x00FFFFFF));
+
+}
+
+void SweepPortInit(uint32_t sysClkHz) {
+
+    (void)sysClkHz;
+
+    DMAControlInit();
+
+    //
+    // Enabled at boot (Boot.h); wait until they can be accessed
+    //
+    HalPeriphReady(SWEEP_PERIPHS);
+
+    //
+    // IO_UPDATE on PL4
+    //
+    GPIOPinConfigure(GPIO_PL4_T0CCP0);
+    GPIOPinTypeTimer(GPIO_PORTL_BASE, GPIO_PIN_4);
+    GPIOPadConfigSet(GPIO_PORTL_BASE, GPIO_PIN_4, GPIO_STRENGTH_8MA, GPIO_PIN_TYPE_STD);
+
+    //
+    // Timer 0A as a 24-bit PWM that raises a uDMA request on every timeout
+    //
+    TimerConfigure(SWEEP_TIMER_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_PWM);
+    TimerDMAEventSet(SWEEP_TIMER_BASE, TIMER_DMA_TIMEOUT_A);
+    TimerIntRegister(SWEEP_TIMER_BASE, TIMER_A, SweepTimerHandler);
+    IntEnable(SWEEP_TIMER_INT);
+
+    uDMAChannelAssign(SWEEP_DMA_ASSIGN);
+    uDMAChannelAttributeDisable(SWEEP_DMA_CHANNEL, UDMA_ATTR_ALL);
+    uDMAChannelAttributeEnable(SWEEP_DMA_CHANNEL, UDMA_ATTR_USEBURST);
+
+}
+
+//************************************************************************************
+//
+// Load both structures and start the timer.  The arbitration size equals the record
+// length, so each timer request moves exactly one step.
+//
+//************************************************************************************
+void SweepPortStart(tSweep *sweep) {
+
+    uint32_t arb = (sweep->elemsPerStep == SWEEP_ELEMS_AD9834) ? UDMA_ARB_2 : UDMA_ARB_8;
+    uint32_t count = SWEEP_BLOCK_STEPS * sweep->elemsPerStep;
+    uint32_t load = sweep->stepCycles - 1;
+
+    g_sweepActive = sweep;
+
+    //
+    // SweepPortIOUpdate() may have left PL4 as a GPIO; hand it back to the timer
+    //
+    GPIOPinTypeTimer(GPIO_PORTL_BASE, GPIO_PIN_4);
+    GPIOPadConfigSet(GPIO_PORTL_BASE, GPIO_PIN_4, GPIO_STRENGTH_8MA, GPIO_PIN_TYPE_STD);
+
+    uDMAChannelControlSet(SWEEP_DMA_CHANNEL | UDMA_PRI_SELECT,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_16 | UDMA_DST_INC_NONE | arb);
+    uDMAChannelControlSet(SWEEP_DMA_CHANNEL | UDMA_ALT_SELECT,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_16 | UDMA_DST_INC_NONE | arb);
+    uDMAChannelTransferSet(SWEEP_DMA_CHANNEL | UDMA_PRI_SELECT, UDMA_MODE_PINGPONG,
+                           (void *)SweepBlockSource(sweep, 0), (void *)SweepPortDest(sweep),
+                           count);
+    uDMAChannelTransferSet(SWEEP_DMA_CHANNEL | UDMA_ALT_SELECT, UDMA_MODE_PINGPONG,
+                           (void *)SweepBlockSource(sweep, 1), (void *)SweepPortDest(sweep),
+                           count);
+    uDMAChannelEnable(SWEEP_DMA_CHANNEL);
+
+    //
+    // In PWM mode the prescaler extends the count to 24 bits.  The output is high
+    // from reload down to the match value, so IO_UPDATE rises at the start of each
+    // step and latches the record shifted during the previous one.
+    //
+    TimerPrescaleSet(SWEEP_TIMER_BASE, TIMER_A, load >> 16);
+    TimerLoadSet(SWEEP_TIMER_BASE, TIMER_A, load & 0xFFFF);
+    TimerPrescaleMatchSet(SWEEP_TIMER_BASE, TIMER_A,
+                          (load - SWEEP_IOUPDATE_CYCLES) >> 16);
+    TimerMatchSet(SWEEP_TIMER_BASE, TIMER_A, (load - SWEEP_IOUPDATE_CYCLES) & 0xFFFF);
+    TimerIntClear(SWEEP_TIMER_BASE, TIMER_TIMA_DMA);
+    TimerIntEnable(SWEEP_TIMER_BASE, TIMER_TIMA_DMA);
+    TimerEnable(SWEEP_TIMER_BASE, TIMER_A);
+
+}
+
+void SweepPortStop(tSweep *sweep) {
+
+    (void)sweep;
+
+    TimerDisable(SWEEP_TIMER_BASE, TIMER_A);
+    TimerIntDisable(SWEEP_TIMER_BASE, TIMER_TIMA_DMA);
+    uDMAChannelDisable(SWEEP_DMA_CHANNEL);
+    g_sweepActive = 0;
+
+}
+
+//************************************************************************************
+//
+// One IO_UPDATE pulse by hand, with the timer stopped.  PL4 stays a GPIO driven low
+// until the next SweepPortStart().
+//
+//************************************************************************************
+void SweepPortIOUpdate(void) {
+
+    GPIOPinTypeGPIOOutput(GPIO_PORTL_BASE, GPIO_PIN_4);
+    GPIOPadConfigSet(GPIO_PORTL_BASE, GPIO_PIN_4, GPIO_STRENGTH_8MA, GPIO_PIN_TYPE_STD);
+    GPIOPinWrite(GPIO_PORTL_BASE, GPIO_PIN_4, GPIO_PIN_4);
+    HalDelayCycles(SWEEP_IOUPDATE_CYCLES);
+    GPIOPinWrite(GPIO_PORTL_BASE, GPIO_PIN_4, 0);
+
+}
@@ -0,0 +1,690 @@
+//************************************************************************************
+//
+// Title:               Multi-Channel Synchronized Update
+// Author:              Jacob Putz
+// Filename:            Sync.c
+//
+// Description:     Channel table, staging over the SSI streams and the single-write
+//                      commit.  Portable; every pin goes through the HAL, and
+//                      HalGpioWrite() is one masked store to the port's DATA register
+//                      on the target.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       Refuse select and latch lines other subsystems own.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "AD9834.h"
+#include "AD9952.h"
+#include "DDSChip.h"
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+#include "Hal.h"
+#include "Modulation.h"
+#include "Record.h"
+#include "Remote.h"
+#include "SSIStream.h"
+#include "Sweep.h"
+#include "Sync.h"
+
+// Defines
+#define     SYNC_NONE               0xFFFFFFFF
+
+// Type Definitions
+typedef struct {
+
+    uint32_t port;
+    uint8_t mask;
+    uint8_t value;
+    uint8_t pulse;                  // IO_UPDATE lines, dropped after the pulse
+
+} tSyncLatch;
+
+typedef struct {
+
+    uint32_t port;
+    uint8_t pins;
+
+} tSyncPins;
+
+// Global Variables
+tSync g_sync;
+
+// Global Constants
+//
+// Lines driven by other subsystems, refused as select or latch lines.  FSELECT and
+// PSELECT (PK0/PK1) are the modulator's and the remote link's as well, but are
+// also an AD9834 channel's latch lines, so SyncPinsFree() deals with them.
+//
+static const tSyncPins g_syncOwnedPins[] = {
+
+    { HAL_PORT_A, HAL_PIN_0 | HAL_PIN_1 },              // UART0, the remote link
+    { HAL_PORT_A, HAL_PIN_2 | HAL_PIN_3 | HAL_PIN_4 },  // SSI0, the AD9834 bus
+    { HAL_PORT_Q, HAL_PIN_0 | HAL_PIN_1 | HAL_PIN_2 },  // SSI3, the AD9952 bus
+    { HAL_PORT_L, HAL_PIN_4 },                          // T0CCP0, sweep IO_UPDATE
+    { HAL_PORT_M, HAL_PIN_0 },                          // T2CCP0, calibration input
+    { HAL_PORT_N, HAL_PIN_0 | HAL_PIN_1 },              // LEDs (DDSExperiment.c)
+    { HAL_PORT_F, HAL_PIN_0 | HAL_PIN_4 }
+
+};
+
+void SyncInit(tSync *sync) {
+
+    sync->count = 0;
+    sync->commits = 0;
+    sync->refused = 0;
+    sync->stagedFrames = 0;
+    sync->stageCycles = 0;
+    sync->spreadCycles = 0;
+    sync->skewCycles = 0;
+    sync->maxSkewCycles = 0;
+    sync->latchWrites = 0;
+
+}
+
+//************************************************************************************
+//
+// The FSELECT/PSELECT level an AD9834 channel's shadow says its lines are at.
+//
+//************************************************************************************
+static uint8_t SyncBankLevel(const tSyncChannel *channel) {
+
+    return ((channel->ad9834->pins & AD9834_CTRL_FSEL) != 0) ? channel->latchPins : 0;
+
+}
+
+//************************************************************************************
+//
+// True if none of pins on port belongs to another subsystem.  FSELECT/PSELECT may
+// be taken only as the latch lines of an AD9834 channel.
+//
+//************************************************************************************
+static bool SyncPinsFree(uint32_t port, uint8_t pins, bool ad9834Latch) {
+
+    uint32_t i;
+
+    for (i = 0; i < (sizeof(g_syncOwnedPins) / sizeof(g_syncOwnedPins[0])); i++) {
+
+        if ((g_syncOwnedPins[i].port == port) &&
+            ((g_syncOwnedPins[i].pins & pins) != 0)) {
+
+            return false;
+
+        }
+
+    }
+
+    return ad9834Latch || (port != HAL_PORT_K) ||
+           ((pins & (MOD_FSELECT | MOD_PSELECT)) == 0);
+
+}
+
+//************************************************************************************
+//
+// Add a part on the bus of instance.  Returns false if the table is full, the part
+// is not built, a line belongs to another subsystem (the link, the SSI buses, the
+// sweep's IO_UPDATE, ...), or its latch lines clash with a channel of the other
+// kind (an IO_UPDATE pulse would move an FSELECT).  The first AD9834 is the one the
+// remote link and the modulator already switch on PK0/PK1, so its latch lines must
+// be those.
+//
+//************************************************************************************
+bool SyncAdd(tSync *sync, uint32_t instance, uint32_t selectPort, uint8_t selectPins,
+             uint32_t latchPort, uint8_t latchPins) {
+
+    tSyncChannel *channel;
+    bool first = true;
+    uint32_t level, i;
+
+    if ((sync->count == SYNC_CHANNELS_MAX) || !DDSChipBuilt(instance) ||
+        (latchPort >= HAL_PORT_COUNT) || (latchPins == 0) ||
+        ((selectPins != 0) && (selectPort >= HAL_PORT_COUNT)) ||
+        !SyncPinsFree(latchPort, latchPins, instance == SSISTREAM_AD9834) ||
+        !SyncPinsFree(selectPort, selectPins, false)) {
+
+        return false;
+
+    }
+
+    for (i = 0; i < sync->count; i++) {
+
+        if (sync->channels[i].instance != instance) {
+
+            if ((sync->channels[i].latchPort == latchPort) &&
+                ((sync->channels[i].latchPins & latchPins) != 0)) {
+
+                return false;
+
+            }
+
+        }
+
+        else {
+
+            first = false;
+
+        }
+
+    }
+
+    if (first && (instance == SSISTREAM_AD9834) &&
+        ((latchPort != HAL_PORT_K) ||
+         ((latchPins & (MOD_FSELECT | MOD_PSELECT)) != (MOD_FSELECT | MOD_PSELECT)))) {
+
+        return false;
+
+    }
+
+    channel = &sync->channels[sync->count];
+    channel->instance = instance;
+    channel->selectPort = selectPort;
+    channel->selectPins = selectPins;
+    channel->latchPort = latchPort;
+    channel->latchPins = latchPins;
+    channel->staged = false;
+    channel->doneCycles = 0;
+    channel->ad9834 = 0;
+    channel->ad9952 = 0;
+
+    if (first) {
+
+        channel->tuning = &g_remote.tuning[instance];
+
+    }
+
+    else {
+
+        DDSChipTuningInit(instance, &channel->ownTuning);
+        channel->tuning = &channel->ownTuning;
+
+    }
+
+    if (instance == SSISTREAM_AD9834) {
+
+        //
+        // The first part keeps the frequency bank it is on now, with the phase bank
+        // brought into line; a new part follows the level already on a shared line.
+        //
+        if (first) {
+
+            channel->ad9834 = &g_ad9834Shadow;
+            level = ((channel->ad9834->ctrl & AD9834_CTRL_PIN_SW) != 0) ?
+                    channel->ad9834->pins :
+                    ((channel->ad9834->known & DDSSHADOW_AD9834_CTRL) != 0) ?
+                    channel->ad9834->devCtrl : channel->ad9834->ctrl;
+
+        }
+
+        else {
+
+            channel->ad9834 = &channel->own.ad9834;
+            DDSShadowAD9834Init(channel->ad9834);
+            level = (HalGpioRead(latchPort, latchPins) != 0) ? AD9834_CTRL_FSEL : 0;
+
+        }
+
+        channel->ad9834->pins = ((level & AD9834_CTRL_FSEL) != 0) ?
+                                (AD9834_CTRL_FSEL | AD9834_CTRL_PSEL) : 0;
+        DDSShadowAD9834SetCtrl(channel->ad9834,
+                               AD9834_CTRL_PIN_SW | channel->ad9834->pins,
+                               AD9834_CTRL_PIN_SW | AD9834_CTRL_FSEL | AD9834_CTRL_PSEL);
+        HalGpioOutputInit(latchPort, latchPins, 8);
+        HalGpioWrite(latchPort, latchPins, SyncBankLevel(channel));
+
+    }
+
+    else {
+
+        if (first) {
+
+            channel->ad9952 = &g_ad9952Shadow;
+
+        }
+
+        else {
+
+            channel->ad9952 = &channel->own.ad9952;
+            DDSShadowAD9952Init(channel->ad9952);
+
+        }
+
+        HalGpioOutputInit(latchPort, latchPins, 8);
+
+    }
+
+    if (selectPins != 0) {
+
+        HalGpioOutputInit(selectPort, selectPins, 8);
+        HalGpioWrite(selectPort, selectPins, first ? 0 : selectPins);
+
+    }
+
+    sync->count++;
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Stage the next frequency and phase of a channel.  Nothing is sent until
+// SyncCommit().
+//
+//************************************************************************************
+bool SyncSet(tSync *sync, uint32_t channel, uint64_t freqQ32, uint32_t phaseCentiDeg) {
+
+    tSyncChannel *entry;
+
+    if (channel >= sync->count) {
+
+        return false;
+
+    }
+
+    entry = &sync->channels[channel];
+    entry->freqWord = DDSTuningFreqWord(entry->tuning, freqQ32);
+    entry->phaseWord = DDSTuningPhaseWordCentiDeg(entry->tuning, phaseCentiDeg);
+    entry->staged = true;
+
+    return true;
+
+}
+
+//************************************************************************************
+//
+// Assert the select line of one channel on a bus and release the others.
+//
+//************************************************************************************
+static void SyncSelect(tSync *sync, uint32_t instance, uint32_t channel) {
+
+    const tSyncChannel *entry;
+    uint32_t i;
+
+    for (i = 0; i < sync->count; i++) {
+
+        entry = &sync->channels[i];
+
+        if ((entry->instance == instance) && (i != channel) && (entry->selectPins != 0)) {
+
+            HalGpioWrite(entry->selectPort, entry->selectPins, entry->selectPins);
+
+        }
+
+    }
+
+    entry = &sync->channels[channel];
+
+    if (entry->selectPins != 0) {
+
+        HalGpioWrite(entry->selectPort, entry->selectPins, 0);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Put every channel's next state in its shadow.  AD9834s always move to the other
+// bank, so one not staged takes its current values with it.
+//
+//************************************************************************************
+static void SyncPrepare(tSync *sync) {
+
+    tSyncChannel *channel;
+    uint32_t active, i;
+
+    for (i = 0; i < sync->count; i++) {
+
+        channel = &sync->channels[i];
+
+        if (channel->instance == SSISTREAM_AD9834) {
+
+            if (!channel->staged) {
+
+                active = ((channel->ad9834->pins & AD9834_CTRL_FSEL) != 0) ? 1 : 0;
+                channel->freqWord = channel->ad9834->freq[active];
+                channel->phaseWord = channel->ad9834->phase[active];
+
+            }
+
+            DDSShadowAD9834Retune(channel->ad9834, channel->freqWord);
+            DDSShadowAD9834Rephase(channel->ad9834, channel->phaseWord);
+
+        }
+
+        else if (channel->staged) {
+
+            DDSShadowAD9952Set(channel->ad9952, AD9952_REG_FTW0, channel->freqWord);
+            DDSShadowAD9952Set(channel->ad9952, AD9952_REG_POW0, channel->phaseWord);
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Send each channel's staged registers, a round at a time: one channel per bus,
+// both buses together, then wait for both to drain before moving the selects.
+// The streams are idle on entry, so a queue cannot be refused.
+//
+//************************************************************************************
+static void SyncStage(tSync *sync) {
+
+    uint32_t next[SSISTREAM_COUNT] = { 0, 0 };
+    uint32_t busy[SSISTREAM_COUNT];
+    uint32_t bus, i, sent;
+    bool any;
+
+    for (;;) {
+
+        any = false;
+
+        for (bus = 0; bus < SSISTREAM_COUNT; bus++) {
+
+            busy[bus] = SYNC_NONE;
+
+            for (i = next[bus]; i < sync->count; i++) {
+
+                if (sync->channels[i].instance == bus) {
+
+                    break;
+
+                }
+
+            }
+
+            if (i == sync->count) {
+
+                next[bus] = i;
+                continue;
+
+            }
+
+            next[bus] = i + 1;
+            busy[bus] = i;
+            any = true;
+
+            SyncSelect(sync, bus, i);
+
+            if (bus == SSISTREAM_AD9834) {
+
+                sent = sync->channels[i].ad9834->sentFrames;
+                DDSShadowAD9834Queue(sync->channels[i].ad9834, &g_ssiStreams[bus]);
+                sync->stagedFrames += sync->channels[i].ad9834->sentFrames - sent;
+
+            }
+
+            else {
+
+                sent = sync->channels[i].ad9952->sentFrames;
+                DDSShadowAD9952Queue(sync->channels[i].ad9952, &g_ssiStreams[bus]);
+                sync->stagedFrames += sync->channels[i].ad9952->sentFrames - sent;
+
+            }
+
+        }
+
+        if (!any) {
+
+            break;
+
+        }
+
+        while ((busy[SSISTREAM_AD9834] != SYNC_NONE) ||
+               (busy[SSISTREAM_AD9952] != SYNC_NONE)) {
+
+            for (bus = 0; bus < SSISTREAM_COUNT; bus++) {
+
+                if ((busy[bus] != SYNC_NONE) && SSIStreamIdle(&g_ssiStreams[bus])) {
+
+                    sync->channels[busy[bus]].doneCycles = HalCycles32();
+                    busy[bus] = SYNC_NONE;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    //
+    // Hand each bus back to its first channel.
+    //
+    for (bus = 0; bus < SSISTREAM_COUNT; bus++) {
+
+        for (i = 0; i < sync->count; i++) {
+
+            if (sync->channels[i].instance == bus) {
+
+                SyncSelect(sync, bus, i);
+                break;
+
+            }
+
+        }
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Stage every channel, then change all the outputs with one write per latch port.
+// Returns false, with nothing sent, if the parts are busy or a shared bus has a
+// part without a select line.
+//
+//************************************************************************************
+bool SyncCommit(tSync *sync) {
+
+    tSyncLatch latches[SYNC_PORTS_MAX];
+    uint32_t writeCycles[SYNC_PORTS_MAX];
+    uint32_t onBus[SSISTREAM_COUNT] = { 0, 0 };
+    uint32_t unselected[SSISTREAM_COUNT] = { 0, 0 };
+    uint32_t origin, start, first, last, ports, i, p;
+    tSyncChannel *channel;
+
+    if (sync->count == 0) {
+
+        return false;
+
+    }
+
+    ports = 0;
+
+    for (i = 0; i < sync->count; i++) {
+
+        channel = &sync->channels[i];
+        onBus[channel->instance]++;
+        unselected[channel->instance] += (channel->selectPins == 0) ? 1 : 0;
+
+        for (p = 0; p < ports; p++) {
+
+            if (latches[p].port == channel->latchPort) {
+
+                break;
+
+            }
+
+        }
+
+        if (p == ports) {
+
+            if (ports == SYNC_PORTS_MAX) {
+
+                return false;
+
+            }
+
+            latches[p].port = channel->latchPort;
+            latches[p].mask = 0;
+            latches[p].value = 0;
+            latches[p].pulse = 0;
+            ports++;
+
+        }
+
+        if ((channel->ad9834 != 0) && channel->ad9834->pinSwitch) {
+
+            //
+            // A remote glitch-free write is still waiting for its switch.
+            //
+            sync->refused++;
+            return false;
+
+        }
+
+    }
+
+    for (i = 0; i < SSISTREAM_COUNT; i++) {
+
+        if ((onBus[i] > 1) && (unselected[i] != 0)) {
+
+            return false;
+
+        }
+
+    }
+
+    if (g_sweep.running || g_modulator.running ||
+        !SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9834]) ||
+        !SSIStreamIdle(&g_ssiStreams[SSISTREAM_AD9952])) {
+
+        sync->refused++;
+        return false;
+
+    }
+
+    origin = RecordOrigin(&g_record, RECORD_ORIGIN_SYNC);
+    start = HalCycles32();
+    sync->stagedFrames = 0;
+
+    SyncPrepare(sync);
+    SyncStage(sync);
+
+    //
+    // The shadows now say which bank each AD9834 moves to.
+    //
+    for (i = 0; i < sync->count; i++) {
+
+        channel = &sync->channels[i];
+
+        for (p = 0; latches[p].port != channel->latchPort; p++) {
+
+            // Find the channel's port.
+
+        }
+
+        latches[p].mask |= channel->latchPins;
+
+        if (channel->instance == SSISTREAM_AD9834) {
+
+            latches[p].value |= ((channel->ad9834->ctrl & AD9834_CTRL_FSEL) != 0) ?
+                                channel->latchPins : 0;
+
+        }
+
+        else {
+
+            latches[p].value |= channel->latchPins;
+            latches[p].pulse |= channel->latchPins;
+
+        }
+
+    }
+
+    for (p = 0; p < ports; p++) {
+
+        writeCycles[p] = HalCycles32();
+        HalGpioWrite(latches[p].port, latches[p].mask, latches[p].value);
+
+    }
+
+    HalDelayCycles(SYNC_IOUPDATE_CYCLES);
+
+    for (p = 0; p < ports; p++) {
+
+        if (latches[p].pulse != 0) {
+
+            HalGpioWrite(latches[p].port, latches[p].pulse, 0);
+
+        }
+
+    }
+
+    first = SYNC_NONE;
+    last = 0;
+
+    for (i = 0; i < sync->count; i++) {
+
+        channel = &sync->channels[i];
+
+        if (channel->instance == SSISTREAM_AD9834) {
+
+            DDSShadowAD9834PinsSwitched(channel->ad9834);
+
+        }
+
+        channel->staged = false;
+
+        if ((channel->doneCycles - start) < first) {
+
+            first = channel->doneCycles - start;
+
+        }
+
+        if ((channel->doneCycles - start) > last) {
+
+            last = channel->doneCycles - start;
+
+        }
+
+    }
+
+    RecordOrigin(&g_record, origin);
+
+    sync->stageCycles = last;
+    sync->spreadCycles = last - first;
+    sync->skewCycles = writeCycles[ports - 1] - writeCycles[0];
+    sync->latchWrites = ports;
+    sync->commits++;
+
+    if (sync->skewCycles > sync->maxSkewCycles) {
+
+        sync->maxSkewCycles = sync->skewCycles;
+
+    }
+
+    return true;
+
+}
@@ -0,0 +1,176 @@
+//************************************************************************************
+//
+// Title:               Multi-Channel Synchronized Update
+// Author:              Jacob Putz
+// Filename:            Sync.h
+//
+// Description:     Several DDS parts treated as one instrument.  New frequencies and
+//                      phases are staged into every channel's registers over the SSI
+//                      buses without touching the outputs, then committed together
+//                      by a single GPIO port write that raises the shared IO_UPDATE
+//                      and moves the shared FSELECT/PSELECT lines, so every channel
+//                      changes on the same edge.
+//
+// Current Revision:    0.1.1
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.1    -       SyncAdd() refuses lines other subsystems own.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef SYNC_H_
+#define SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "DDSShadow.h"
+#include "DDSTuning.h"
+
+//************************************************************************************
+//
+// Notes
+//
+//  Wiring.  A channel is one part on the SSI bus of its kind: AD9834s share SSI0
+//  and AD9952s share SSI3, since the two buses run different frame widths and
+//  SPI modes.  The first channel added on a bus is the part the rest of the
+//  firmware already drives, with the global shadow and the remote link's tuning
+//  context; later channels get shadows and tuning of their own.  On a bus with
+//  more than one channel every part needs a select line (active low) gating its
+//  FSYNC or CS, and the first channel is left selected whenever the manager is
+//  not staging, so remote writes, sweeps and presets keep reaching it.
+//
+//  SyncAdd() configures the select and latch lines as outputs, and the channel
+//  table can be filled over the remote link, so lines owned elsewhere are refused:
+//  UART0 (PA0/PA1), the SSI0 and SSI3 pins, IO_UPDATE on PL4 (Timer 0), the
+//  calibration input PM0 and the LEDs.  FSELECT/PSELECT (PK0/PK1) may only be an
+//  AD9834 channel's latch lines.
+//
+//  The latch lines are what make the update simultaneous:
+//
+//      AD9952      IO_UPDATE.  Staged registers sit in the I/O buffer until it
+//                  rises.
+//      AD9834      FSELECT and PSELECT, tied together or both in latchPins, with
+//                  PIN_SW set.  Staged values go into the bank that is not on the
+//                  output (the shadow's Retune()/Rephase() pin-switch path) and
+//                  the lines then select it.
+//
+//  Channels can share latch lines (one IO_UPDATE net fanned out to every AD9952)
+//  or have their own.  SyncCommit() builds one port value from every channel's
+//  lines and writes each latch port once, so channels whose lines are on the same
+//  port change on the same store.  With the lines spread over several ports the
+//  writes follow each other back to back and skewCycles measures the spread.
+//  IO_UPDATE is then held for SYNC_IOUPDATE_CYCLES and dropped with a second
+//  write; the parts latch on the rising edge.
+//
+//  Every AD9834 channel changes bank on every commit; one that was not staged has
+//  its current values copied into the bank it moves to, so channels sharing an
+//  FSELECT line stay consistent.
+//
+//  Staging is done a round at a time: each bus sends its next channel's frames,
+//  with that channel's select asserted, and the round waits for both buses to go
+//  idle before the selects move.  The two buses therefore run in parallel and a
+//  shared bus in series.  stageCycles is the time from the start of staging to
+//  the last frame out, and spreadCycles the time between the first channel's
+//  frames finishing and the last's -- the skew the outputs would have shown had
+//  each part been written and latched on its own.
+//
+//  What is aligned is the register update.  The outputs stay aligned in phase if
+//  the parts share a reference clock (and, for several AD9952s, SYNC_CLK through
+//  their SYNC_IN/SYNC_OUT chain); that is board wiring, not something the
+//  manager can check.  An AD9834 samples FSELECT on MCLK and an AD9952 latches on
+//  SYNC_CLK, so a commit lands within one of those clocks on each part, plus the
+//  part's fixed pipeline delay.
+//
+//  Commits are refused while a sweep, hop or the modulator owns the parts.
+//
+//************************************************************************************
+
+// Defines
+#define     SYNC_CHANNELS_MAX       8
+#define     SYNC_PORTS_MAX          4           // Distinct latch ports
+#define     SYNC_IOUPDATE_CYCLES    16          // IO_UPDATE width (> 1 SYNC_CLK)
+
+// Type Definitions
+typedef struct {
+
+    uint32_t instance;              // SSISTREAM_AD9834 or SSISTREAM_AD9952 (its bus)
+    uint32_t selectPort;            // Select line, selectPins zero if none
+    uint8_t selectPins;
+    uint32_t latchPort;             // IO_UPDATE or FSELECT/PSELECT
+    uint8_t latchPins;
+
+    tDDSTuning *tuning;             // The remote link's for the first on a bus
+    tDDSTuning ownTuning;
+    tAD9834Shadow *ad9834;          // Shadow for the part, one of these two
+    tAD9952Shadow *ad9952;
+    union {
+
+        tAD9834Shadow ad9834;
+        tAD9952Shadow ad9952;
+
+    } own;
+
+    //
+    // Next state, converted
+    //
+    bool staged;
+    uint32_t freqWord;
+    uint32_t phaseWord;
+    uint32_t doneCycles;            // HalCycles32() when its frames were out
+
+} tSyncChannel;
+
+typedef struct {
+
+    tSyncChannel channels[SYNC_CHANNELS_MAX];
+    uint32_t count;
+
+    //
+    // Statistics
+    //
+    uint32_t commits;
+    uint32_t refused;               // Commits refused (busy)
+    uint32_t stagedFrames;          // Frames sent by the last commit
+    uint32_t stageCycles;           // Last commit: staging start to last frame out
+    uint32_t spreadCycles;          // Last commit: first to last channel staged
+    uint32_t skewCycles;            // Last commit: first to last latch write
+    uint32_t maxSkewCycles;
+    uint32_t latchWrites;           // Latch port writes in the last commit
+
+} tSync;
+
+// Global Variables
+extern tSync g_sync;
+
+// Function Prototypes
+extern void SyncInit(tSync *sync);
+extern bool SyncAdd(tSync *sync, uint32_t instance, uint32_t selectPort,
+                    uint8_t selectPins, uint32_t latchPort, uint8_t latchPins);
+extern bool SyncSet(tSync *sync, uint32_t channel, uint64_t freqQ32,
+                    uint32_t phaseCentiDeg);
+extern bool SyncCommit(tSync *sync);
+
+#endif /* SYNC_H_ */
@@ -0,0 +1,225 @@
+//************************************************************************************
+//
+// Title:               64-bit Timebase
+// Author:              Jacob Putz
+// Filename:            TimeBase.c
+//
+// Description:     Sequence-locked tick and cycle counters.  Replaces the bare
+//                      volatile uint64_t COUNT that could be read torn on the 32-bit
+//                      core.  Nothing in this file touches hardware; see TimeBasePort.c
+//                      for the SysTick/DWT port.
+//
+// Current Revision:    0.1.3
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.3    -       Correct the note on the tick rate and counter range.
+//
+// 0.1.2    -       Add TimeBaseCatchUp() for ticks missed in deep sleep.
+//
+// 0.1.1    -       Derive milliseconds from microseconds so a slow tick keeps 1 ms
+//                  resolution.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdint.h>
+#include "TimeBase.h"
+
+// Defines
+//
+// The TI compiler never reorders volatile accesses and the target is single core,
+// so ordering the volatile fields is enough there.  Other compilers get a full
+// fence so the same code is correct against a writer on another host thread.
+//
+#if defined(__TI_ARM__)
+#define     TIMEBASE_BARRIER()
+#else
+#define     TIMEBASE_BARRIER()      __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// Global Variables
+tTimeBase g_timeBase;
+
+//************************************************************************************
+//
+// Reset the counters.  cycleNow is the free-running cycle counter at the moment
+// the first tick period starts.
+//
+//************************************************************************************
+void TimeBaseSetup(uint32_t sysClkHz, uint32_t tickHz, uint32_t cycleNow) {
+
+    g_timeBase.seq = 0;
+    g_timeBase.ticks = 0;
+    g_timeBase.tickCycles = 0;
+    g_timeBase.tickCycles32 = cycleNow;
+
+    g_timeBase.cyclesPerTick = sysClkHz / tickHz;
+    g_timeBase.cyclesPerUs = sysClkHz / 1000000;
+    g_timeBase.usPerTick = 1000000 / tickHz;
+
+}
+
+//************************************************************************************
+//
+// Called once per tick by the only writer.  tickCycle is the cycle counter value
+// at the tick boundary (not at ISR entry), so interrupt latency does not leak into
+// the timebase.
+//
+// The tick only extends the DWT counter to 64 bits, so it is slow (BOOT_TICK_HZ,
+// 10 Hz).  The 64-bit cycle count fills first, after about 4,871 years at 120 MHz
+// (2^64/(120e6*60*60*24*365.25)); microseconds last 584,542 years.
+//
+//************************************************************************************
+void TimeBaseAdvance(uint32_t tickCycle) {
+
+    g_timeBase.seq++;
+    TIMEBASE_BARRIER();
+
+    g_timeBase.tickCycles += (uint32_t)(tickCycle - g_timeBase.tickCycles32);
+    g_timeBase.tickCycles32 = tickCycle;
+    g_timeBase.ticks++;
+
+    TIMEBASE_BARRIER();
+    g_timeBase.seq++;
+
+}
+
+//************************************************************************************
+//
+// Replay the tick boundaries missed while the tick was stopped (deep sleep).  The
+// port has already moved the cycle counter on and put the tick back on its grid,
+// so each whole period between the last recorded boundary and now is one missed
+// tick.  Called with interrupts masked, standing in for the ISR as the writer.
+//
+//************************************************************************************
+void TimeBaseCatchUp(void) {
+
+    uint32_t now = TimeBasePortCycles32();
+
+    while ((now - g_timeBase.tickCycles32) >= g_timeBase.cyclesPerTick) {
+
+        TimeBaseAdvance(g_timeBase.tickCycles32 + g_timeBase.cyclesPerTick);
+
+    }
+
+}
+
+//************************************************************************************
+//
+// Tick count.  Two 32-bit loads on the M4, so it goes through the sequence lock.
+//
+//************************************************************************************
+uint64_t TimeBaseTicks(void) {
+
+    uint32_t seq;
+    uint64_t ticks;
+
+    do {
+
+        seq = g_timeBase.seq;
+        TIMEBASE_BARRIER();
+        ticks = g_timeBase.ticks;
+        TIMEBASE_BARRIER();
+
+    } while ((seq & 1) || (seq != g_timeBase.seq));
+
+    return ticks;
+
+}
+
+//************************************************************************************
+//
+// Milliseconds, derived from TimeBaseMicros() so the resolution does not depend on
+// the tick rate.
+//
+//************************************************************************************
+uint64_t TimeBaseMillis(void) {
+
+    return TimeBaseMicros() / 1000;
+
+}
+
+//************************************************************************************
+//
+// Microseconds.  The sub-tick part is a 32-bit divide (single UDIV on the M4) and is
+// clamped to the tick period so a tick that is pending but not yet serviced can
+// never make time run backwards.
+//
+//************************************************************************************
+uint64_t TimeBaseMicros(void) {
+
+    uint32_t seq;
+    uint64_t ticks;
+    uint32_t delta;
+    uint32_t us;
+
+    do {
+
+        seq = g_timeBase.seq;
+        TIMEBASE_BARRIER();
+        ticks = g_timeBase.ticks;
+        delta = TimeBasePortCycles32() - g_timeBase.tickCycles32;
+        TIMEBASE_BARRIER();
+
+    } while ((seq & 1) || (seq != g_timeBase.seq));
+
+    us = delta / g_timeBase.cyclesPerUs;
+
+    if (us >= g_timeBase.usPerTick) {
+
+        us = g_timeBase.usPerTick - 1;
+
+    }
+
+    return (ticks * g_timeBase.usPerTick) + us;
+
+}
+
+//************************************************************************************
+//
+// 64-bit cycle count.  Valid as long as the tick keeps running; the 32-bit counter
+// only has to cover one tick period, not its full 2^32 range.
+//
+//************************************************************************************
+uint64_t TimeBaseCycles(void) {
+
+    uint32_t seq;
+    uint64_t base;
+    uint32_t delta;
+
+    do {
+
+        seq = g_timeBase.seq;
+        TIMEBASE_BARRIER();
+        base = g_timeBase.tickCycles;
+        delta = TimeBasePortCycles32() - g_timeBase.tickCycles32;
+        TIMEBASE_BARRIER();
+
+    } while ((seq & 1) || (seq != g_timeBase.seq));
+
+    return base + delta;
+
+}
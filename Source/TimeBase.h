@@ -0,0 +1,119 @@
+//************************************************************************************
+//
+// Title:               64-bit Timebase
+// Author:              Jacob Putz
+// Filename:            TimeBase.h
+//
+// Description:     Tear-free 64-bit tick, microsecond and cycle counters.  The
+//                      SysTick interrupt is the only writer and publishes through a
+//                      sequence lock, so readers never mask interrupts and never see a
+//                      half-updated value at a 2^32 rollover.  Sub-tick resolution
+//                      comes from the DWT cycle counter.
+//
+// Current Revision:    0.1.4
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.1.4    -       Readers must not preempt SysTick.
+//
+// 0.1.3    -       Point at the host stress test.
+//
+// 0.1.2    -       Add TimeBaseCatchUp().
+//
+// 0.1.1    -       Derive milliseconds from microseconds so a slow tick keeps 1 ms
+//                  resolution.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+
+//************************************************************************************
+//
+// Notes
+//
+//  Writer (SysTick ISR):       seq++  ->  update fields  ->  seq++
+//  Reader (any context below   s1 = seq  ->  copy fields  ->  s2 = seq
+//  SysTick priority):          retry while s1 != s2 or s1 is odd
+//
+//  A reader that is interrupted by the tick simply loops once more; it never
+//  blocks the ISR.  A reader must not preempt SysTick: if it ran between the
+//  writer's two increments it would find seq odd and spin forever, as the writer
+//  cannot resume until it returns.  Every interrupt the firmware enables is left at
+//  the reset priority, the same as SysTick, so none of them can; the fault handlers
+//  do preempt it and do not read the timebase.  Raising an interrupt above SysTick
+//  means it may not call these functions either.
+//
+//  Host/Tools/TimeBaseTool.c runs the SysTick path on one thread against readers
+//  on others and checks that no read combines fields from two ticks.
+//
+//************************************************************************************
+
+// Defines
+//
+// DWT cycle counter registers (not covered by TivaWare)
+#define     DWT_DEMCR               0xE000EDFC
+#define     DWT_DEMCR_TRCENA        0x01000000
+#define     DWT_CTRL                0xE0001000
+#define     DWT_CTRL_CYCCNTENA      0x00000001
+#define     DWT_CYCCNT              0xE0001004
+
+// Type Definitions
+typedef struct {
+
+    volatile uint32_t seq;          // Odd while the ISR is updating
+    volatile uint64_t ticks;        // SysTick periods since TimeBaseInit()
+    volatile uint64_t tickCycles;   // 64-bit cycle count at the last tick boundary
+    volatile uint32_t tickCycles32; // Low word of the same, for delta reads
+
+    uint32_t cyclesPerTick;
+    uint32_t cyclesPerUs;
+    uint32_t usPerTick;
+
+} tTimeBase;
+
+extern tTimeBase g_timeBase;
+
+// Function Prototypes
+//
+// Portable core (TimeBase.c)
+//
+extern void TimeBaseSetup(uint32_t sysClkHz, uint32_t tickHz, uint32_t cycleNow);
+extern void TimeBaseAdvance(uint32_t tickCycle);
+extern void TimeBaseCatchUp(void);
+extern uint64_t TimeBaseTicks(void);
+extern uint64_t TimeBaseMillis(void);
+extern uint64_t TimeBaseMicros(void);
+extern uint64_t TimeBaseCycles(void);
+
+//
+// Port layer (TimeBasePort.c, on the HAL)
+//
+extern void TimeBaseInit(uint32_t sysClkHz, uint32_t tickHz);
+extern uint32_t TimeBasePortCycles32(void);
+
+#endif /* TIMEBASE_H_ */
@@ -0,0 +1,84 @@
+//************************************************************************************
+//
+// Title:               64-bit Timebase - Port
+// Author:              Jacob Putz
+// Filename:            TimeBasePort.c
+//
+// Description:     SysTick and cycle counter port layer for TimeBase.c, written
+//                      against Hal.h.  SysTick provides the tick interrupt; the
+//                      DWT cycle counter (or the simulated clock on a host)
+//                      provides sub-tick resolution.
+//
+// Current Revision:    0.2.0
+//
+// MIT License
+// Copyright (c)    2017    Integrated Microsystem Electronics, LLC
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in the
+// Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+// Revision History:
+//
+// 0.2.0    -       Move from TimeBaseTiva.c onto the HAL.
+//
+// 0.1.0    -       Initial implementation.
+//
+//************************************************************************************
+
+// Includes
+#include <stdbool.h>
+#include <stdint.h>
+#include "Hal.h"
+#include "Profile.h"
+#include "TimeBase.h"
+
+//************************************************************************************
+//
+// SysTick interrupt.  SysTick counts down from LOAD at the system clock, so the
+// cycles elapsed since the reload are (LOAD - VAL); subtracting them from the cycle
+// count recovers the cycle at which the tick actually occurred.
+//
+//************************************************************************************
+static void TimeBaseTickHandler(void) {
+
+    uint32_t cycle = HalCycles32();
+    uint32_t sinceReload = HalTickElapsed();
+    PROFILE_ISR_ENTER(PROFILE_ID_SYSTICK);
+
+    TimeBaseAdvance(cycle - sinceReload);
+
+    PROFILE_ISR_EXIT(PROFILE_ID_SYSTICK, sinceReload);
+
+}
+
+//************************************************************************************
+//
+// Start SysTick at tickHz.  The cycle counter is already running (HalClockInit()).
+//
+//************************************************************************************
+void TimeBaseInit(uint32_t sysClkHz, uint32_t tickHz) {
+
+    TimeBaseSetup(sysClkHz, tickHz, HalCycles32());
+    HalTickInit(sysClkHz / tickHz, TimeBaseTickHandler);
+
+}
+
+uint32_t TimeBasePortCycles32(void) {
+
+    return HalCycles32();
+
+}
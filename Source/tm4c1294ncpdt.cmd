@@ -10,8 +10,12 @@
 
 MEMORY
 {
-    FLASH (RX) : origin = 0x00000000, length = 0x00100000
-    SRAM (RWX) : origin = 0x20000000, length = 0x00040000
+    FLASH (RX) : origin = 0x00000000, length = 0x000C0000
+    /* Preset image (Preset.h), programmed separately from the firmware */
+    PRESETS (R) : origin = 0x000C0000, length = 0x00040000
+    SRAM (RWX) : origin = 0x20000000, length = 0x00030000
+    /* Runtime memory arena (Mem.h), carved up by MemArenaAlloc() after reset */
+    ARENA (RW) : origin = 0x20030000, length = 0x00010000
 }
 
 /* The following command line options are set as part of the CCS project.    */
@@ -40,6 +44,14 @@ SECTIONS
     .bss    :   > SRAM
     .sysmem :   > SRAM
     .stack  :   > SRAM
+
+    /* Fault snapshot (Fault.h): left alone by the C start-up, so it survives a */
+    /* restart or reset                                                         */
+    .noinit :   > SRAM, type = NOINIT
 }
 
 __STACK_TOP = __stack + 512;
+
+/* Arena bounds for MemPortArena(); keep in step with ARENA above */
+__ARENA_START = 0x20030000;
+__ARENA_END = 0x20040000;
@@ -31,8 +31,15 @@
 //*****************************************************************************
 void ResetISR(void);
 static void NmiSR(void);
-static void FaultISR(void);
-static void IntDefaultHandler(void);
+
+//*****************************************************************************
+//
+// The fault and unexpected interrupt handlers, assembly stubs that enter
+// FaultEntry() (FaultVectors.asm).
+//
+//*****************************************************************************
+extern void FaultISR(void);
+extern void IntDefaultHandler(void);
 
 //*****************************************************************************
 //
@@ -237,39 +244,3 @@ NmiSR(void)
     {
     }
 }
-
-//*****************************************************************************
-//
-// This is the code that gets called when the processor receives a fault
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
-//
-//*****************************************************************************
-static void
-FaultISR(void)
-{
-    //
-    // Enter an infinite loop.
-    //
-    while(1)
-    {
-    }
-}
-
-//*****************************************************************************
-//
-// This is the code that gets called when the processor receives an unexpected
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
-//
-//*****************************************************************************
-static void
-IntDefaultHandler(void)
-{
-    //
-    // Go into an infinite loop.
-    //
-    while(1)
-    {
-    }
-}